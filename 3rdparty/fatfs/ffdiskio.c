@@ -90,6 +90,35 @@ DSTATUS disk_register (
 
 }
 
+/*-----------------------------------------------------------------------*/
+/* Registers synchronization function for a device                       */
+/*-----------------------------------------------------------------------*/
+
+DSTATUS disk_register_sync (
+	BYTE pdrv,				/* Physical drive index. */
+	FF_SYNC *psync			/* Function to be called to synchronize the device */
+)
+{
+	FF_DEVICE *device = disk_search(pdrv);
+	DSTATUS status = RES_OK;
+
+	/* If the given device was resolved. */
+	if (device != NULL)
+	{
+		/* Device will now be accessed randomly. */
+		device->sync = psync;
+	}
+	else
+	{
+		/* Invalid device was given. */
+		status = RES_PARERR;
+	}
+
+	/* Return status to the caller. */
+	return (status);
+
+}
+
 /*-----------------------------------------------------------------------*/
 /* Get Drive Status                                                      */
 /*-----------------------------------------------------------------------*/
@@ -174,7 +203,7 @@ DRESULT disk_read (
 	if (device != NULL)
 	{
 		/* If we need to terminate an old request, */
-		if ((device->state != FDEV_READING) || (device->current_sector != sector))
+		if ((device->sync == NULL) && ((device->state != FDEV_READING) || (device->current_sector != sector)))
 		{
 			/* Synchronize updates on the device. */
 			disk_ioctl(pdrv, CTRL_SYNC, NULL);
@@ -225,7 +254,7 @@ DRESULT disk_write (
 	if (device != NULL)
 	{
 		/* If we need to terminate an old request, */
-		if ((device->state != FDEV_WRITING) || (device->current_sector != sector))
+		if ((device->sync == NULL) && ((device->state != FDEV_WRITING) || (device->current_sector != sector)))
 		{
 			/* Synchronize updates on the device. */
 			disk_ioctl(pdrv, CTRL_SYNC, NULL);
@@ -276,31 +305,41 @@ DRESULT disk_ioctl (
 	{
 	case CTRL_SYNC:
 
-		/* Process the device state. */
-		switch (device->state)
+		/* If device can synchronize itself. */
+		if (device->sync != NULL)
 		{
-		/* If we were writing data. */
-		case FDEV_WRITING:
+			/* Write all the pending data. */
+			res = ((device->sync(device->phy_device) == SUCCESS) ? RES_OK : RES_ERROR);
+		}
+		else
+		{
+			/* Process the device state. */
+			switch (device->state)
+			{
+			/* If we were writing data. */
+			case FDEV_WRITING:
 
-			/* Terminate the old write. */
-			device->write(device->phy_device, 0, &device->offset, NULL, 0);
-			break;
+				/* Terminate the old write. */
+				device->write(device->phy_device, 0, &device->offset, NULL, 0);
+				break;
 
-		/* If we were reading data. */
-		case FDEV_READING:
+			/* If we were reading data. */
+			case FDEV_READING:
 
-			/* Terminate the old read. */
-			device->read(device->phy_device, 0, &device->offset, NULL, 0);
-			break;
+				/* Terminate the old read. */
+				device->read(device->phy_device, 0, &device->offset, NULL, 0);
+				break;
 
-		default:
-			break;
+			default:
+				break;
+			}
+
+			res = RES_OK;
 		}
 
 		/* Update the device state. */
 		device->state = FDEV_IDLE;
 		device->offset = FDEV_STRAT_OFFSET;
-		res = RES_OK;
 
 		break;
 	}
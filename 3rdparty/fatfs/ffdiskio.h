@@ -82,6 +82,7 @@ typedef enum {
 typedef int32_t FF_INIT(void *);
 typedef int32_t FF_READ(void *, uint32_t, uint64_t *, uint8_t *, int32_t);
 typedef int32_t FF_WRITE(void *, uint32_t, uint64_t *, uint8_t *, int32_t);
+typedef int32_t FF_SYNC(void *);
 
 /* FatFile system device definition. */
 typedef struct _ff_device
@@ -91,6 +92,10 @@ typedef struct _ff_device
 	FF_READ		*read;
 	FF_WRITE	*write;
 
+	/* If set device provides random access and this will be called to
+	 * synchronize pending writes. */
+	FF_SYNC		*sync;
+
 	/* Physical device to be used. */
 	void		*phy_device;
 
@@ -119,6 +124,7 @@ typedef struct _ff_device
 /* Prototypes for disk control functions */
 
 DSTATUS disk_register (void *pdevice, FF_INIT *pinit, FF_READ *pread, FF_WRITE *pwrite, uint32_t psector_size, BYTE pdrv);
+DSTATUS disk_register_sync (BYTE pdrv, FF_SYNC *psync);
 FF_DEVICE *disk_search (BYTE pdrv);
 DSTATUS disk_status (BYTE pdrv);
 DSTATUS disk_initialize (BYTE pdrv);
@@ -0,0 +1,28 @@
+/*
+ * assert.h
+ *
+ * Copyright (c) 2015 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#ifndef _ASSERT_H_
+#define _ASSERT_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Abort the replay if memory manager detects a corruption. */
+#define ASSERT(raise)               {                                                       \
+                                        if (raise)                                          \
+                                        {                                                   \
+                                            fprintf(stderr, "%s:%d: Assert\n", __FILE__, __LINE__); \
+                                            abort();                                        \
+                                        }                                                   \
+                                    }
+
+#endif /* _ASSERT_H_ */
@@ -0,0 +1,49 @@
+/*
+ * kernel.h
+ *
+ * Copyright (c) 2015 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#ifndef _KERNEL_H_
+#define _KERNEL_H_
+
+/* This header replaces the kernel definitions needed to run the dynamic
+ * and slab memory managers on the host. */
+#include <stdint.h>
+#include <stddef.h>
+#include <assert.h>
+
+/* Memory manager is always enabled on the host. */
+#define CONFIG_MEMGR
+
+/* Some return codes. */
+#define SUCCESS                     (0)
+#define FALSE                       (0)
+#define TRUE                        (1)
+#define MAX_WAIT                    (uint32_t)(-1)
+
+/* Some useful macros. */
+#define OFFSETOF(type, field)       ((int)offsetof(type, field))
+
+/* Alignment manipulation macros. */
+#define ALLIGN_SIZE                 (uint32_t)(0x8)
+#define ALLIGN_FLOOR(n)             (uint32_t)(((n) % ALLIGN_SIZE) ? ((n) & (uint32_t)~(ALLIGN_SIZE - 1)) : (n))
+#define ALLIGN_CEIL(n)              (uint32_t)(((n) % ALLIGN_SIZE) ? ((n) & (uint32_t)~(ALLIGN_SIZE - 1)) + ALLIGN_SIZE : (n))
+
+/* There is no scheduler on the host. */
+#define scheduler_lock()
+#define scheduler_unlock()
+
+/* There are no interrupts on the host. */
+typedef uint32_t                    INT_LVL;
+#define GET_INTERRUPT_LEVEL()       (0)
+#define SET_INTERRUPT_LEVEL(n)      ((void)(n))
+#define DISABLE_INTERRUPTS()
+
+#endif /* _KERNEL_H_ */
@@ -0,0 +1,20 @@
+/*
+ * mem_config.h
+ *
+ * Copyright (c) 2015 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#ifndef _MEM_CONFIG_H_
+#define _MEM_CONFIG_H_
+
+/* Dynamic and slab memory managers are compared on the host. */
+#define MEMGR_DYNAMIC
+#define MEMGR_SLAB
+
+#endif /* _MEM_CONFIG_H_ */
@@ -0,0 +1,19 @@
+/*
+ * mem_dynamic_config.h
+ *
+ * Copyright (c) 2015 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#ifndef _MEM_DYNAMIC_CONFIG_H_
+#define _MEM_DYNAMIC_CONFIG_H_
+
+/* Dynamic memory checks are configured from the command line, so the replay
+ * can use the same memory descriptors as the target. */
+
+#endif /* _MEM_DYNAMIC_CONFIG_H_ */
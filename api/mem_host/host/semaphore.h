@@ -0,0 +1,18 @@
+/*
+ * semaphore.h
+ *
+ * Copyright (c) 2015 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#ifndef _SEMAPHORE_H_
+#define _SEMAPHORE_H_
+
+/* Semaphores are not used on the host. */
+
+#endif /* _SEMAPHORE_H_ */
@@ -0,0 +1,18 @@
+/*
+ * sll_config.h
+ *
+ * Copyright (c) 2015 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#ifndef _SLL_CONFIG_H_
+#define _SLL_CONFIG_H_
+
+/* SLL routines are not inlined on the host. */
+
+#endif /* _SLL_CONFIG_H_ */
@@ -0,0 +1,547 @@
+/*
+ * mem_replay.c
+ *
+ * Copyright (c) 2015 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ * This tool replays a dynamic memory allocation trace captured by
+ * mem_dynamic_trace_dump against mem_dynamic_alloc_region and
+ * mem_slab_alloc_region on the host, so different page and size class
+ * configurations can be compared. Dynamic memory checks must
+ * be same as the target and it should be built for 32-bit so memory
+ * descriptors have the same size, e.g. for the default configuration build it
+ * from repository root as:
+ *  gcc -m32 -O2 -Iapi/mem_host/host -Irtos/mem -Irtos/utils
+ *      -DMEM_BNDRY_CHECK -DMEM_FREE_CHECK -DMEM_ID_CHECK
+ *      api/mem_host/mem_replay.c rtos/mem/mem_dynamic.c rtos/mem/mem_slab.c
+ *      rtos/utils/sll.c -o mem_replay
+ *
+ * Usage:
+ *  mem_replay <trace dump> [page configuration file]...
+ *
+ * Trace is first replayed with the page configuration in the dump and then
+ * with each of the given configuration files. A configuration file has one
+ * page on each line as "<max alloc> <size> <flags>", a size of 0 will evenly
+ * divide the remaining memory as in mem_dynamic_init_region, flags can be
+ * 0, 1 (MEM_PAGE_DEC) or 2 (MEM_PAGE_ASC). A line "slab <size> <num>" adds
+ * a slab size class, classes must be sorted on size. Slab region is carved at
+ * the start of the memory as in mem_init, if a configuration has both the
+ * pages and the classes an allocation that cannot be served by the slab
+ * region is served by the dynamic memory, if it only has the classes the
+ * trace is replayed against the slab region alone. A line "strict" sets
+ * MEM_STRICT_ALLOC and MEM_SLAB_STRICT_ALLOC for the regions and lines
+ * starting with '#' are ignored.
+ *
+ * As trace buffer only has the latest events, memories allocated before the
+ * first event are not known and their deallocations are skipped.
+ */
+#include <kernel.h>
+#include <mem.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Trace dump definitions, must match mem_dynamic.h. */
+#define REPLAY_MAGIC        (0x4D444D57)
+#define REPLAY_EVENT_ALLOC  1
+#define REPLAY_EVENT_FREE   2
+#define REPLAY_EVENT_FAIL   3
+#define REPLAY_MAX_PAGES    64
+#define REPLAY_MAX_CLASSES  64
+
+/* Trace dump header. */
+typedef struct _replay_header
+{
+    uint32_t    magic;
+    uint32_t    freq;
+    uint32_t    region_size;
+    uint32_t    flags;
+    uint16_t    num_pages;
+    uint16_t    num_sites;
+    uint16_t    num_events;
+    uint8_t     version;
+    uint8_t     pad[1];
+} REPLAY_HEADER;
+
+/* Trace dump page entry. */
+typedef struct _replay_page
+{
+    uint32_t    max_alloc;
+    uint32_t    size;
+    uint32_t    flags;
+    uint32_t    free;
+    uint32_t    largest;
+    uint32_t    min_largest;
+} REPLAY_PAGE;
+
+/* Trace dump site entry. */
+typedef struct _replay_site
+{
+    uint32_t    site;
+    uint32_t    num_alloc;
+    uint32_t    num_free;
+    uint32_t    num_fail;
+    uint32_t    bytes;
+    uint32_t    max_bytes;
+    uint32_t    max_alloc_time;
+    uint32_t    max_free_time;
+} REPLAY_SITE;
+
+/* Trace dump event. */
+typedef struct _replay_event
+{
+    uint32_t    time;
+    uint32_t    mem;
+    uint32_t    size;
+    uint16_t    site;
+    uint8_t     type;
+    uint8_t     pad[1];
+} REPLAY_EVENT;
+
+/* Page configuration being replayed. */
+typedef struct _replay_cfg
+{
+    MEM_DYN_CFG cfg[REPLAY_MAX_PAGES];
+    MEM_SLAB_CFG    slab_cfg[REPLAY_MAX_CLASSES];
+    uint32_t    num_pages;
+    uint32_t    num_classes;
+    uint32_t    flags;
+    uint32_t    slab_flags;
+} REPLAY_CFG;
+
+/*
+ * replay_time_ns
+ * @return: Current monotonic time in nano seconds.
+ * This function returns the current time.
+ */
+static uint64_t replay_time_ns(void)
+{
+    struct timespec ts;
+
+    /* Get the current time. */
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    /* Return time in nano seconds. */
+    return (((uint64_t)ts.tv_sec * 1000000000) + (uint64_t)ts.tv_nsec);
+
+} /* replay_time_ns */
+
+/*
+ * replay_load_cfg
+ * @file: Configuration file.
+ * @replay_cfg: Configuration will be returned here.
+ * @return: SUCCESS if configuration was loaded, otherwise -1 will be returned.
+ * This function will load a page configuration from a file.
+ */
+static int32_t replay_load_cfg(const char *file, REPLAY_CFG *replay_cfg)
+{
+    FILE *cfg_file = fopen(file, "r");
+    char line[128];
+    long max_alloc, size, flags, num;
+    int32_t status = SUCCESS;
+
+    /* If configuration file was opened. */
+    if (cfg_file != NULL)
+    {
+        memset(replay_cfg, 0, sizeof(REPLAY_CFG));
+
+        /* Read all the lines in the file. */
+        while ((status == SUCCESS) && (fgets(line, sizeof(line), cfg_file) != NULL))
+        {
+            /* Skip comments and empty lines. */
+            if ((line[0] == '#') || (line[0] == '\n') || (line[0] == '\r'))
+            {
+                continue;
+            }
+
+            /* If this is a strict region. */
+            if (strncmp(line, "strict", 6) == 0)
+            {
+                replay_cfg->flags |= MEM_STRICT_ALLOC;
+                replay_cfg->slab_flags |= MEM_SLAB_STRICT_ALLOC;
+            }
+
+            /* If this is a valid slab class configuration. */
+            else if ((replay_cfg->num_classes < REPLAY_MAX_CLASSES) && (sscanf(line, "slab %li %li", &size, &num) == 2) &&
+                     ((replay_cfg->num_classes == 0) || ((uint32_t)size >= replay_cfg->slab_cfg[replay_cfg->num_classes - 1].size)))
+            {
+                replay_cfg->slab_cfg[replay_cfg->num_classes].size = (uint32_t)size;
+                replay_cfg->slab_cfg[replay_cfg->num_classes].num = (uint32_t)num;
+                replay_cfg->num_classes ++;
+            }
+
+            /* If this is a valid page configuration. */
+            else if ((replay_cfg->num_pages < REPLAY_MAX_PAGES) && (sscanf(line, "%li %li %li", &max_alloc, &size, &flags) == 3))
+            {
+                replay_cfg->cfg[replay_cfg->num_pages].max_alloc = (uint32_t)max_alloc;
+                replay_cfg->cfg[replay_cfg->num_pages].size = (uint32_t)size;
+                replay_cfg->cfg[replay_cfg->num_pages].flags = (uint32_t)flags;
+                replay_cfg->num_pages ++;
+            }
+            else
+            {
+                fprintf(stderr, "%s: invalid line: %s", file, line);
+                status = -1;
+            }
+        }
+
+        fclose(cfg_file);
+
+        /* We must have some memory to replay with. */
+        if ((status == SUCCESS) && (replay_cfg->num_pages == 0) && (replay_cfg->num_classes == 0))
+        {
+            fprintf(stderr, "%s: no pages or classes\n", file);
+            status = -1;
+        }
+    }
+    else
+    {
+        perror(file);
+        status = -1;
+    }
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* replay_load_cfg */
+
+/*
+ * replay_fragmentation
+ * @mem_dynamic: Memory region.
+ * @free_size: Total free memory will be returned here.
+ * @largest: Largest free memory will be returned here.
+ * This function will calculate the total and largest free memory in a
+ * region.
+ */
+static void replay_fragmentation(MEM_DYNAMIC *mem_dynamic, uint32_t *free_size, uint32_t *largest)
+{
+    uint32_t i, page_largest;
+
+    *free_size = *largest = 0;
+
+    /* Go through all the pages. */
+    for (i = 0; i < mem_dynamic->num_pages; i++)
+    {
+        *free_size += mem_dynamic_page_free(&mem_dynamic->pages[i], &page_largest);
+        if (page_largest > *largest)
+        {
+            *largest = page_largest;
+        }
+    }
+
+} /* replay_fragmentation */
+
+/*
+ * replay_slab_size
+ * @replay_cfg: Configuration for which slab region size is needed.
+ * @return: Size of memory required by the slab region.
+ * This function will calculate the memory required by the slab region as in
+ * mem_slab_init_region.
+ */
+static uint32_t replay_slab_size(REPLAY_CFG *replay_cfg)
+{
+    uint32_t i, size, slab_size = ALLIGN_CEIL(sizeof(MEM_SLAB_CLASS) * replay_cfg->num_classes);
+
+    /* Add the memory for items in all the classes. */
+    for (i = 0; i < replay_cfg->num_classes; i++)
+    {
+        size = (replay_cfg->slab_cfg[i].size > MEM_SLAB_MIN_SIZE) ? replay_cfg->slab_cfg[i].size : MEM_SLAB_MIN_SIZE;
+        slab_size += ALLIGN_CEIL(size + MEM_SLAB_DESC_SIZE) * replay_cfg->slab_cfg[i].num;
+    }
+
+    /* Return the slab region size. */
+    return (slab_size);
+
+} /* replay_slab_size */
+
+/*
+ * replay_run
+ * @name: Name of this configuration.
+ * @header: Trace header.
+ * @events: Trace events.
+ * @replay_cfg: Page configuration to be used.
+ * This function will replay the trace events with the given page and size
+ * class configuration and print the results.
+ */
+static void replay_run(const char *name, REPLAY_HEADER *header, REPLAY_EVENT *events, REPLAY_CFG *replay_cfg)
+{
+    MEM_DYNAMIC mem_dynamic;
+    MEM_SLAB mem_slab;
+    uint8_t *region, **mem, *slab_end;
+    uint32_t i, j, free_size = 0, largest = 0, frag = 0, max_frag = 0, min_largest = header->region_size;
+    uint32_t num_alloc = 0, num_free = 0, num_fail = 0, num_skip = 0;
+    uint32_t slab_used = 0, slab_held = 0, waste = 0, max_waste = 0;
+    uint64_t start, time, alloc_time = 0, max_alloc_time = 0, free_time = 0, max_free_time = 0;
+
+    /* Slab region must fit in the memory. */
+    if (replay_slab_size(replay_cfg) > header->region_size)
+    {
+        fprintf(stderr, "%s: slab classes need %u bytes, region has %u\n", name, replay_slab_size(replay_cfg), header->region_size);
+        return;
+    }
+
+    region = malloc(header->region_size);
+    mem = calloc(header->num_events, sizeof(uint8_t *));
+    memset(&mem_dynamic, 0, sizeof(MEM_DYNAMIC));
+    slab_end = region;
+
+    /* Initialize the slab region at the start of the memory. */
+    if (replay_cfg->num_classes > 0)
+    {
+        slab_end = mem_slab_init_region(&mem_slab, region, region + header->region_size, replay_cfg->num_classes, replay_cfg->slab_cfg, replay_cfg->slab_flags);
+    }
+
+    /* Initialize the dynamic memory region with the remaining memory. */
+    if (replay_cfg->num_pages > 0)
+    {
+        mem_dynamic_init_region(&mem_dynamic, slab_end, region + header->region_size, replay_cfg->num_pages, replay_cfg->cfg, replay_cfg->flags);
+    }
+
+    /* Replay all the events. */
+    for (i = 0; i < header->num_events; i++)
+    {
+        /* If this is an allocation. */
+        if ((events[i].type == REPLAY_EVENT_ALLOC) || (events[i].type == REPLAY_EVENT_FAIL))
+        {
+            start = replay_time_ns();
+
+            /* Try the slab region first and then the dynamic memory. */
+            mem[i] = (replay_cfg->num_classes > 0) ? mem_slab_alloc_region(&mem_slab, events[i].size) : NULL;
+            if ((mem[i] == NULL) && (replay_cfg->num_pages > 0))
+            {
+                mem[i] = mem_dynamic_alloc_region(&mem_dynamic, events[i].size);
+            }
+
+            time = replay_time_ns() - start;
+
+            /* If memory was allocated from the slab region. */
+            if ((mem[i] != NULL) && (mem[i] < slab_end))
+            {
+                /* Update the bytes requested and held by the slab items. */
+                slab_used += events[i].size;
+                slab_held += ((MEM_SLAB_ALOC *)(mem[i] - MEM_SLAB_DESC_SIZE))->slab_class->max_alloc;
+            }
+
+            /* Update allocation statistics. */
+            alloc_time += time;
+            max_alloc_time = (time > max_alloc_time) ? time : max_alloc_time;
+            num_alloc ++;
+
+            /* If allocation failed. */
+            if (mem[i] == NULL)
+            {
+                num_fail ++;
+            }
+
+            /* A failed allocation on target will never be freed. */
+            else if (events[i].type == REPLAY_EVENT_FAIL)
+            {
+                mem[i] = NULL;
+            }
+        }
+
+        /* If this is a deallocation. */
+        else if (events[i].type == REPLAY_EVENT_FREE)
+        {
+            /* Find the allocation for this memory. */
+            for (j = i; j > 0; j--)
+            {
+                if ((events[j - 1].type == REPLAY_EVENT_ALLOC) && (events[j - 1].mem == events[i].mem))
+                {
+                    break;
+                }
+            }
+
+            /* If allocation was replayed. */
+            if ((j > 0) && (mem[j - 1] != NULL))
+            {
+                /* If this memory was allocated from the slab region. */
+                if (mem[j - 1] < slab_end)
+                {
+                    /* Update the bytes requested and held by the slab items. */
+                    slab_used -= events[j - 1].size;
+                    slab_held -= ((MEM_SLAB_ALOC *)(mem[j - 1] - MEM_SLAB_DESC_SIZE))->slab_class->max_alloc;
+
+                    start = replay_time_ns();
+                    mem_slab_dealloc_region(mem[j - 1]);
+                    time = replay_time_ns() - start;
+                }
+                else
+                {
+                    start = replay_time_ns();
+                    mem_dynamic_dealloc_region(mem[j - 1]);
+                    time = replay_time_ns() - start;
+                }
+
+                /* Update deallocation statistics. */
+                free_time += time;
+                max_free_time = (time > max_free_time) ? time : max_free_time;
+                num_free ++;
+                mem[j - 1] = NULL;
+            }
+            else
+            {
+                /* This memory was not allocated by the replay. */
+                num_skip ++;
+            }
+        }
+
+        /* Update the fragmentation statistics of dynamic memory. */
+        if (replay_cfg->num_pages > 0)
+        {
+            replay_fragmentation(&mem_dynamic, &free_size, &largest);
+            frag = (free_size > 0) ? (((free_size - largest) * 100) / free_size) : 0;
+            max_frag = (frag > max_frag) ? frag : max_frag;
+            min_largest = (largest < min_largest) ? largest : min_largest;
+        }
+
+        /* Slab region has no external fragmentation, update the memory
+         * wasted in the items instead. */
+        waste = (slab_held > 0) ? (((slab_held - slab_used) * 100) / slab_held) : 0;
+        max_waste = (waste > max_waste) ? waste : max_waste;
+    }
+
+    /* Print the results. */
+    printf("%s: pages %u classes %u%s\n", name, replay_cfg->num_pages, replay_cfg->num_classes, (replay_cfg->flags & MEM_STRICT_ALLOC) ? " strict" : "");
+    printf("  alloc %u fail %u free %u skipped %u\n", num_alloc, num_fail, num_free, num_skip);
+    printf("  alloc time avg %.0fns max %lluns, free time avg %.0fns max %lluns\n",
+           (num_alloc > 0) ? ((double)alloc_time / num_alloc) : 0.0, (unsigned long long)max_alloc_time,
+           (num_free > 0) ? ((double)free_time / num_free) : 0.0, (unsigned long long)max_free_time);
+    if (replay_cfg->num_pages > 0)
+    {
+        printf("  fragmentation final %u%% max %u%%, min largest free %u\n", frag, max_frag, min_largest);
+        printf("  P[n]\tFree\tLargest\tFrag(%%)\n");
+        for (i = 0; i < mem_dynamic.num_pages; i++)
+        {
+            free_size = mem_dynamic_page_free(&mem_dynamic.pages[i], &largest);
+            printf("  [%u]\t%u\t%u\t%u\n", i, free_size, largest, (free_size > 0) ? (((free_size - largest) * 100) / free_size) : 0);
+        }
+    }
+    if (replay_cfg->num_classes > 0)
+    {
+        printf("  slab waste final %u%% max %u%%\n", waste, max_waste);
+        printf("  C[n]\tSize\tItems\tFree\n");
+        for (i = 0; i < mem_slab.num_classes; i++)
+        {
+            printf("  [%u]\t%u\t%u\t%u\n", i, mem_slab.classes[i].max_alloc, mem_slab.classes[i].num_items, mem_slab.classes[i].num_free);
+        }
+    }
+
+    free(mem);
+    free(region);
+
+} /* replay_run */
+
+/*
+ * main
+ * This is main entry function for the replay tool.
+ */
+int main(int argc, char *argv[])
+{
+    FILE *trace_file;
+    REPLAY_HEADER header;
+    REPLAY_PAGE page;
+    REPLAY_SITE site;
+    REPLAY_EVENT *events;
+    REPLAY_CFG replay_cfg;
+    uint32_t i;
+    int status = 0;
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <trace dump> [page configuration file]...\n", argv[0]);
+        return (1);
+    }
+
+    /* Open the trace dump. */
+    trace_file = fopen(argv[1], "rb");
+    if (trace_file == NULL)
+    {
+        perror(argv[1]);
+        return (1);
+    }
+
+    /* Read and verify the trace header. */
+    if ((fread(&header, sizeof(header), 1, trace_file) != 1) || (header.magic != REPLAY_MAGIC) || (header.num_pages > REPLAY_MAX_PAGES))
+    {
+        fprintf(stderr, "%s: invalid trace dump\n", argv[1]);
+        fclose(trace_file);
+        return (1);
+    }
+
+    /* Load the page configuration from the trace. */
+    memset(&replay_cfg, 0, sizeof(REPLAY_CFG));
+    replay_cfg.num_pages = header.num_pages;
+    replay_cfg.flags = header.flags;
+    printf("Trace: region %u bytes, %u events\n", header.region_size, header.num_events);
+    printf("  P[n]\tMax\tSize\tFlags\tFree\tLargest\tMin\n");
+    for (i = 0; (status == 0) && (i < header.num_pages); i++)
+    {
+        if (fread(&page, sizeof(page), 1, trace_file) != 1)
+        {
+            status = 1;
+            break;
+        }
+        replay_cfg.cfg[i].max_alloc = page.max_alloc;
+        replay_cfg.cfg[i].size = page.size;
+        replay_cfg.cfg[i].flags = page.flags;
+        printf("  [%u]\t%u\t%u\t%u\t%u\t%u\t%u\n", i, page.max_alloc, page.size, page.flags, page.free, page.largest, page.min_largest);
+    }
+
+    /* Print the call sites. */
+    printf("  Site\t\tAlloc\tFree\tFail\tBytes\tMax\tT(A)\tT(F)\n");
+    for (i = 0; (status == 0) && (i < header.num_sites); i++)
+    {
+        if (fread(&site, sizeof(site), 1, trace_file) != 1)
+        {
+            status = 1;
+            break;
+        }
+        if ((site.num_alloc > 0) || (site.num_fail > 0))
+        {
+            printf("  0x%08X\t%u\t%u\t%u\t%u\t%u\t%u\t%u\n", site.site, site.num_alloc, site.num_free, site.num_fail, site.bytes, site.max_bytes, site.max_alloc_time, site.max_free_time);
+        }
+    }
+
+    /* Read the events. */
+    events = calloc(header.num_events + 1, sizeof(REPLAY_EVENT));
+    if ((status == 0) && (fread(events, sizeof(REPLAY_EVENT), header.num_events, trace_file) != header.num_events))
+    {
+        status = 1;
+    }
+    fclose(trace_file);
+
+    if (status != 0)
+    {
+        fprintf(stderr, "%s: truncated trace dump\n", argv[1]);
+    }
+    else
+    {
+        /* Replay with the configuration in the trace. */
+        replay_run(argv[1], &header, events, &replay_cfg);
+
+        /* Replay with the given configurations. */
+        for (i = 2; i < (uint32_t)argc; i++)
+        {
+            if (replay_load_cfg(argv[i], &replay_cfg) == SUCCESS)
+            {
+                replay_run(argv[i], &header, events, &replay_cfg);
+            }
+            else
+            {
+                status = 1;
+            }
+        }
+    }
+
+    free(events);
+
+    return (status);
+
+} /* main */
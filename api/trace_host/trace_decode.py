@@ -0,0 +1,200 @@
+"""
+This file implements decoder for the kernel trace dump.
+"""
+import sys
+import argparse
+from struct import unpack_from, calcsize
+from socket import socket, AF_INET, SOCK_DGRAM, SOL_SOCKET, SO_REUSEADDR, timeout
+
+# Trace dump definitions, must match trace.h.
+TRACE_MAGIC         = 0x43525457
+TRACE_HEADER        = "<IIHHBB2x"
+TRACE_TASK          = "<IB15s"
+TRACE_RECORD        = "<IIBB2x"
+
+# Trace record types.
+TRACE_TASK_SWITCH   = 1
+TRACE_TASK_READY    = 2
+TRACE_ISR_ENTER     = 3
+TRACE_ISR_EXIT      = 4
+TRACE_SUSPEND       = 5
+TRACE_RESUME        = 6
+TRACE_SEM_WAIT      = 7
+TRACE_SEM_OBTAIN    = 8
+TRACE_SEM_RELEASE   = 9
+
+# Task state in which a task is preempted.
+TASK_RUNNING        = 2
+
+# Seconds after which we will stop waiting for more trace data on UDP.
+UDP_TIMEOUT         = 2
+
+"""
+This class holds time statistics and a log2 histogram of collected samples.
+"""
+class Histogram:
+
+    """
+    Histogram initializer.
+    """
+    def __init__(self):
+        self.buckets = {}
+        self.count = 0
+        self.total = 0.0
+        self.max = 0.0
+
+    """
+    This function adds a sample in microseconds to this histogram.
+    """
+    def add(self, sample):
+        bucket = 0
+        while (1 << bucket) < sample:
+            bucket += 1
+        self.buckets[bucket] = self.buckets.get(bucket, 0) + 1
+        self.count += 1
+        self.total += sample
+        self.max = max(self.max, sample)
+
+    """
+    This function prints this histogram.
+    """
+    def show(self, title):
+        if self.count == 0:
+            return
+        print("  %s: n=%d avg=%.1fus max=%.1fus" % (title, self.count, self.total / self.count, self.max))
+        for bucket in sorted(self.buckets):
+            low = 0 if bucket == 0 else (1 << (bucket - 1))
+            print("    %8d - %-8d us: %d" % (low, 1 << bucket, self.buckets[bucket]))
+
+"""
+This function parses a trace dump and returns the frequency, task names and
+the records.
+"""
+def parse(data):
+    magic, freq, num_tasks, num_records, version, record_size = unpack_from(TRACE_HEADER, data, 0)
+    if magic != TRACE_MAGIC:
+        raise ValueError("Invalid trace magic 0x%08x." % magic)
+
+    # Parse the task entries.
+    offset = calcsize(TRACE_HEADER)
+    tasks = {}
+    for _ in range(num_tasks):
+        tcb, priority, name = unpack_from(TRACE_TASK, data, offset)
+        tasks[tcb] = "%s(%d)" % (name.split(b"\0")[0].decode(errors = "replace"), priority)
+        offset += calcsize(TRACE_TASK)
+
+    # Parse the records.
+    records = []
+    for _ in range(num_records):
+        if (offset + record_size) > len(data):
+            break
+        records.append(unpack_from(TRACE_RECORD, data, offset))
+        offset += record_size
+
+    return freq, tasks, records
+
+"""
+This function processes the trace records and prints per task run time and
+wake to run latency histograms along with ISR run time.
+"""
+def decode(freq, tasks, records, verbose):
+    run_time = {}
+    latency = {}
+    isr_time = {}
+    ready = {}
+    isr_enter = []
+    current = None
+    switch_time = None
+    isr_total = 0
+
+    # Converts a timestamp delta to microseconds.
+    to_us = lambda delta: ((delta & 0xFFFFFFFF) * 1000000.0) / freq
+    name = lambda tcb: tasks.get(tcb, "0x%08x" % tcb)
+
+    for time, obj, rtype, arg in records:
+        if verbose:
+            print("%10u %-12s 0x%08x %d" % (time, rtype, obj, arg))
+
+        if rtype == TRACE_TASK_SWITCH:
+
+            # Account the run time of the last task.
+            if current is not None:
+                run_time.setdefault(current, Histogram()).add(to_us(time - switch_time) - isr_total)
+
+            # If this task was woken up, account the wake to run latency.
+            if obj in ready:
+                latency.setdefault(obj, Histogram()).add(to_us(time - ready.pop(obj)))
+
+            current = obj
+            switch_time = time
+            isr_total = 0
+
+        elif rtype == TRACE_TASK_READY:
+
+            # Only account latency for the tasks that were not preempted.
+            if arg != TASK_RUNNING:
+                ready[obj] = time
+
+        elif rtype == TRACE_ISR_ENTER:
+            isr_enter.append((obj, time))
+
+        elif (rtype == TRACE_ISR_EXIT) and isr_enter:
+            isr, enter = isr_enter.pop()
+            delta = to_us(time - enter)
+            isr_time.setdefault(isr, Histogram()).add(delta)
+
+            # ISR time is not accounted for the interrupted task.
+            if not isr_enter:
+                isr_total += delta
+
+    for tcb in sorted(set(run_time) | set(latency), key = name):
+        print("Task %s" % name(tcb))
+        if tcb in run_time:
+            run_time[tcb].show("Run time")
+        if tcb in latency:
+            latency[tcb].show("Wake to run latency")
+
+    for isr in sorted(isr_time):
+        print("ISR %d" % isr)
+        isr_time[isr].show("Run time")
+
+"""
+This function receives trace dump on a UDP port.
+"""
+def receive_udp(port):
+    udp_socket = socket(AF_INET, SOCK_DGRAM)
+    udp_socket.setsockopt(SOL_SOCKET, SO_REUSEADDR, 1)
+    udp_socket.bind(("", port))
+    data = b""
+
+    # Wait for the first datagram indefinitely.
+    data += udp_socket.recv(65536)
+    udp_socket.settimeout(UDP_TIMEOUT)
+
+    # Receive till device stops sending.
+    try:
+        while True:
+            data += udp_socket.recv(65536)
+    except timeout:
+        pass
+
+    udp_socket.close()
+    return data
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description = "Decode kernel trace dump.")
+    parser.add_argument("file", nargs = "?", help = "Trace dump file, standard input is used if not given.")
+    parser.add_argument("--udp", type = int, help = "Receive trace dump on the given UDP port.")
+    parser.add_argument("--verbose", action = "store_true", help = "Print all the records.")
+    args = parser.parse_args()
+
+    if args.udp:
+        data = receive_udp(args.udp)
+    elif args.file:
+        with open(args.file, "rb") as trace_file:
+            data = trace_file.read()
+    else:
+        data = sys.stdin.buffer.read()
+
+    freq, tasks, records = parse(data)
+    decode(freq, tasks, records, args.verbose)
@@ -0,0 +1,41 @@
+# Load default configurations.
+set(TGT_PLATFORM linux CACHE STRING "Target platform.")
+set_property(CACHE TGT_PLATFORM PROPERTY STRINGS "linux")
+set(TGT_TOOL "gcc-host" CACHE STRING "Target Tools.")
+
+# Find required tool-sets.
+find_program(HOST_CC gcc)
+
+# Set default compiler.
+set(CMAKE_C_COMPILER ${HOST_CC})
+
+# Load default flags.
+set(HOST_C_FLAGS "-O2 -fmessage-length=0 -std=gnu99 -fsigned-char -fno-omit-frame-pointer -Wunused -Wuninitialized -Wall -Wextra -Wmissing-declarations -Wpointer-arith -Wshadow -Wlogical-op -Waggregate-return -Wfloat-equal -g3" CACHE STRING "C flags.")
+set(HOST_LINK_FLAGS "" CACHE STRING "LD flags.")
+
+# Select the target CPU.
+# If this is a linux host.
+if (${TGT_PLATFORM} STREQUAL "linux")
+    # We have a POSIX process.
+    set(TGT_CPU "posix" CACHE STRING "Target CPU." FORCE)
+
+# Must be not supported.
+else()
+    message(FATAL_ERROR "Unsupported device ${TGT_PLATFORM}.")
+endif ()
+
+# Define minimum IDLE task stack size.
+set(kernel_idle_stack_min 128 CACHE INTERNAL "" FORCE)
+
+# Set c and link flags.
+set(CMAKE_C_FLAGS "${HOST_C_FLAGS}" CACHE STRING "" FORCE)
+set(CMAKE_EXE_LINKER_FLAGS "${HOST_LINK_FLAGS}" CACHE STRING "" FORCE)
+
+# This function will setup a target for host.
+function (setup_target target_name sources)
+    # Add an executable target.
+    add_executable(${target_name} ${RTOS_LINK_SOURCES} ${${sources}})
+    target_link_libraries(${target_name} ${RTOS_LIB})
+    target_include_directories(${target_name} PUBLIC ${RTOS_INCLUDES})
+    set_target_properties(${target_name} PROPERTIES LINK_FLAGS "-Wl,-Map,${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/${target_name}.map")
+endfunction ()
\ No newline at end of file
@@ -0,0 +1,264 @@
+/*
+ * event_bench.c
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+#include <stdio.h>
+#include <string.h>
+#include <fs.h>
+#include <serial.h>
+#include <event.h>
+
+/* This demo will measure the wake latency of a task waiting on 4, 16 and 32
+ * sources, once with a condition for each source passed to suspend_condition
+ * and once with a bit for each source in an event group. A higher priority
+ * task waits on all the sources, while the benchmark task signals a random
+ * source and the time from signaling till the waiting task is running again
+ * is averaged. */
+
+/* Demo configurations. */
+#define DEMO_STACK_SIZE     1024
+#define BENCH_ITERATIONS    1000
+#define BENCH_MAX_SOURCES   32
+
+/* Waiting modes. */
+#define BENCH_MODE_CONDITION    (0)
+#define BENCH_MODE_EVENT        (1)
+
+/* Use the hardware tick if we don't have a cycle counter. */
+#ifdef CPU_CYCLE_COUNT
+#define BENCH_TIMESTAMP()   (uint32_t)CPU_CYCLE_COUNT()
+#else
+#define BENCH_TIMESTAMP()   (uint32_t)current_hardware_tick()
+#endif /* CPU_CYCLE_COUNT */
+
+/* Function prototypes. */
+void event_bench_task(void *);
+void event_bench_waiter_task(void *);
+static uint32_t event_bench_random(void);
+static uint8_t event_bench_do_suspend(void *, void *);
+static void event_bench_signal(uint32_t);
+static uint32_t event_bench_run(uint8_t, uint32_t);
+
+/* Benchmark task stacks. */
+TASK event_bench_cb;
+uint8_t event_bench_stack[DEMO_STACK_SIZE];
+TASK event_bench_waiter_cb;
+uint8_t event_bench_waiter_stack[DEMO_STACK_SIZE];
+
+/* Benchmark data. */
+static EVENT_GROUP bench_group;
+static CONDITION bench_conditions[BENCH_MAX_SOURCES];
+static volatile uint8_t bench_flags[BENCH_MAX_SOURCES];
+static volatile uint8_t bench_mode = BENCH_MODE_CONDITION;
+static volatile uint32_t bench_num_sources = BENCH_MAX_SOURCES;
+static volatile uint8_t bench_wait_mode;
+static uint32_t bench_start, bench_total, bench_count;
+static uint32_t bench_seed = 0x1234567;
+
+/*
+ * event_bench_random
+ * @return: Returns a pseudo random number.
+ * This function will return a pseudo random number.
+ */
+static uint32_t event_bench_random(void)
+{
+    /* Update the seed. */
+    bench_seed = (bench_seed * 1103515245) + 12345;
+
+    /* Return the random number. */
+    return ((bench_seed >> 16) | (bench_seed << 16));
+
+} /* event_bench_random */
+
+/*
+ * event_bench_do_suspend
+ * @data: Flag for the source.
+ * @suspend_data: Suspend data, unused.
+ * @return: Returns TRUE if source is not yet signaled and we need to suspend.
+ * This function will check if a source is signaled.
+ */
+static uint8_t event_bench_do_suspend(void *data, void *suspend_data)
+{
+    /* Suspend data is unused. */
+    UNUSED_PARAM(suspend_data);
+
+    /* Return if this source is not yet signaled. */
+    return ((*(volatile uint8_t *)data == FALSE) ? TRUE : FALSE);
+
+} /* event_bench_do_suspend */
+
+/*
+ * event_bench_signal
+ * @source: Source needed to be signaled.
+ * This function will signal a source in the mode the waiting task is using.
+ */
+static void event_bench_signal(uint32_t source)
+{
+    /* Save the time at which we signaled the source. */
+    bench_start = BENCH_TIMESTAMP();
+
+    /* If waiting task is waiting on an event group. */
+    if (bench_wait_mode == BENCH_MODE_EVENT)
+    {
+        /* Set the event for this source. */
+        event_group_set(&bench_group, ((uint32_t)1 << source));
+    }
+    else
+    {
+        /* Signal the condition for this source. */
+        bench_flags[source] = TRUE;
+        resume_condition(&bench_conditions[source], NULL, FALSE);
+    }
+
+} /* event_bench_signal */
+
+/*
+ * event_bench_run
+ * @mode: Mode in which waiting task will wait.
+ * @num_sources: Number of sources on which waiting task will wait.
+ * @return: Returns the average wake latency.
+ * This function will signal random sources and will return the average time
+ * taken by the waiting task to run.
+ */
+static uint32_t event_bench_run(uint8_t mode, uint32_t num_sources)
+{
+    uint32_t i;
+
+    /* Update the wait mode and wake up the waiting task so it can start
+     * waiting in this mode. */
+    bench_mode = mode;
+    bench_num_sources = num_sources;
+    event_bench_signal(0);
+
+    /* Signal random sources. */
+    bench_total = bench_count = 0;
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        event_bench_signal(event_bench_random() % num_sources);
+    }
+
+    /* Return the average wake latency. */
+    return (bench_total / bench_count);
+
+} /* event_bench_run */
+
+void event_bench_waiter_task(void *argv)
+{
+    CONDITION *condition[BENCH_MAX_SOURCES];
+    SUSPEND suspend[BENCH_MAX_SOURCES], *suspend_ptr[BENCH_MAX_SOURCES];
+    uint32_t i, num_sources, mask;
+    uint8_t num;
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(argv);
+
+    for (;;)
+    {
+        /* Pick the mode in which we need to wait. */
+        num_sources = bench_num_sources;
+        bench_wait_mode = bench_mode;
+
+        /* If we need to wait on event group. */
+        if (bench_wait_mode == BENCH_MODE_EVENT)
+        {
+            /* Wait for any of the events for the sources. */
+            mask = (num_sources == 32) ? 0xFFFFFFFF : (((uint32_t)1 << num_sources) - 1);
+            ASSERT(event_group_wait(&bench_group, mask, (EVENT_WAIT_ANY | EVENT_AUTO_CLEAR), NULL, MAX_WAIT) != SUCCESS);
+        }
+        else
+        {
+            /* Initialize a condition and suspend for each source. */
+            for (i = 0; i < num_sources; i++)
+            {
+                memset(&suspend[i], 0, sizeof(SUSPEND));
+                suspend[i].priority = SUSPEND_MIN_PRIORITY;
+                suspend[i].status = SUCCESS;
+                suspend_ptr[i] = &suspend[i];
+                condition[i] = &bench_conditions[i];
+            }
+
+            /* Wait on all the conditions. */
+            num = (uint8_t)num_sources;
+            ASSERT(suspend_condition(condition, suspend_ptr, &num, FALSE) != SUCCESS);
+
+            /* Clear the source that resumed us. */
+            bench_flags[num] = FALSE;
+        }
+
+        /* Add the time it took to run this task. */
+        bench_total += (BENCH_TIMESTAMP() - bench_start);
+        bench_count ++;
+    }
+}
+
+void event_bench_task(void *argv)
+{
+    static const uint32_t num_sources[] = {4, 16, BENCH_MAX_SOURCES};
+    uint32_t i, condition, event;
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(argv);
+
+    for (;;)
+    {
+        for (i = 0; i < (sizeof(num_sources) / sizeof(uint32_t)); i++)
+        {
+            /* Run the benchmark and print the results. */
+            condition = event_bench_run(BENCH_MODE_CONDITION, num_sources[i]);
+            event = event_bench_run(BENCH_MODE_EVENT, num_sources[i]);
+            printf("%lu sources: conditions %lu, event group %lu\r\n", (unsigned long)num_sources[i], (unsigned long)condition, (unsigned long)event);
+        }
+
+        /* Wait before running the benchmark again. */
+        sleep_ticks(SOFT_TICKS_PER_SEC);
+    }
+}
+
+int main(void)
+{
+    uint32_t i;
+
+    memset(&event_bench_cb, 0, sizeof(TASK));
+    memset(&event_bench_waiter_cb, 0, sizeof(TASK));
+
+    /* Initialize the event group and a condition for each source. */
+    event_group_create(&bench_group);
+    memset(bench_conditions, 0, sizeof(bench_conditions));
+    for (i = 0; i < BENCH_MAX_SOURCES; i++)
+    {
+        bench_conditions[i].data = (void *)&bench_flags[i];
+        bench_conditions[i].do_suspend = &event_bench_do_suspend;
+    }
+
+    /* Initialize scheduler. */
+    scheduler_init();
+
+    /* Initialize file system. */
+    fs_init();
+
+    /* Initialize serial. */
+    serial_init();
+
+    /* Create a task for event benchmark. */
+    task_create(&event_bench_cb, P_STR("BENCH"), event_bench_stack, DEMO_STACK_SIZE, &event_bench_task, (void *)(NULL), 0);
+    scheduler_task_add(&event_bench_cb, 5);
+
+    /* Create the waiting task with a higher priority. */
+    task_create(&event_bench_waiter_cb, P_STR("WAITER"), event_bench_waiter_stack, DEMO_STACK_SIZE, &event_bench_waiter_task, (void *)(NULL), 0);
+    scheduler_task_add(&event_bench_waiter_cb, 4);
+
+    /* Run scheduler. */
+    kernel_run();
+
+    return (0);
+
+}
@@ -0,0 +1,22 @@
+# Include helpers.
+include(${RTOS_ROOT}/cmake/modules/helper.cmake)
+
+# Setup target configuration.
+setup_option(TGT_PLATFORM linux)
+
+# Initialize RTOS configurations.
+setup_option(CONFIG_FS ON)
+setup_option(IO_SERIAL ON)
+setup_option(CONFIG_EVENT ON)
+setup_option(CONFIG_QUEUE ON)
+setup_option(FS_PIPE ON)
+
+# Update the number of ticks per second to 1000.
+setup_option(SOFT_TICKS_PER_SEC 1000)
+
+# Priority inheritance also exercises moving tasks on the ready list.
+setup_option(SEMAPHORE_PRIORITY_INHERIT ON)
+
+# Suppress the system tick while idle, POSIX_SIM_CLOCK can be enabled to
+# build the tickless test.
+setup_option(CONFIG_TICKLESS ON)
\ No newline at end of file
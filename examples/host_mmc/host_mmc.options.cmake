@@ -0,0 +1,21 @@
+# Include helpers.
+include(${RTOS_ROOT}/cmake/modules/helper.cmake)
+
+# Setup target configuration.
+setup_option(TGT_PLATFORM linux)
+
+# Initialize RTOS configurations.
+setup_option(CONFIG_FS ON)
+setup_option(IO_SERIAL ON)
+
+# MMC is attached to a SPI card emulator and accessed through FAT disk
+# interface.
+setup_option(IO_SPI ON)
+setup_option(IO_MMC ON)
+setup_option(FS_FAT ON)
+
+# Suppress the system tick while idle.
+setup_option(CONFIG_TICKLESS ON)
+
+# Update the number of ticks per second to 1000.
+setup_option(SOFT_TICKS_PER_SEC 1000)
@@ -0,0 +1,43 @@
+# Include helpers.
+include(${RTOS_ROOT}/cmake/modules/helper.cmake)
+
+# Setup target configuration.
+setup_option(TGT_PLATFORM linux)
+
+# Initialize RTOS configurations.
+setup_option(CONFIG_FS ON)
+setup_option(CONFIG_MEMGR ON)
+setup_option(CONFIG_NET ON)
+setup_option(IO_SERIAL ON)
+setup_option(IO_ETHERNET ON)
+
+# Suppress the system tick while idle.
+setup_option(CONFIG_TICKLESS ON)
+
+# Update the number of ticks per second to 1000.
+setup_option(SOFT_TICKS_PER_SEC 1000)
+
+# Setup ethernet configurations, TAP interface is used on host.
+setup_option(ETHERNET_ENC28J60 OFF)
+
+# Setup static IP configuration.
+setup_option(NET_DHCP OFF)
+setup_option(ETHERNET_TAP_DEFAULT_IP 0xC0A80001)
+
+# Setup networking stack configurations, short frames are padded.
+setup_option(IPV4_ALLOW_SIZE_MISMATCH ON)
+setup_option(UDP_ALLOW_SIZE_MISMATCH ON)
+
+# Setup route database for the route lookup benchmark.
+setup_option(NET_NUM_ROUTES 512)
+setup_option(NET_ROUTE_HASH_SIZE 256)
+
+# Setup socket demux tables for the demux benchmark.
+setup_option(NET_DEMUX_HASH_SIZE 256)
+setup_option(NET_DEMUX_LISTEN_SIZE 16)
+
+# Setup TCP options exercised by the goodput benchmarks.
+setup_option(TCP_SACK ON)
+setup_option(TCP_TIME_STAMP ON)
+setup_option(TCP_DELAYED_ACK 100)
+setup_option(TCP_NAGLE ON)
\ No newline at end of file
@@ -0,0 +1,26 @@
+# Include helpers.
+include(${RTOS_ROOT}/cmake/modules/helper.cmake)
+
+# Setup target configuration.
+setup_option(TGT_PLATFORM linux)
+
+# Initialize RTOS configurations.
+setup_option(CONFIG_FS ON)
+setup_option(CONFIG_MEMGR ON)
+setup_option(CONFIG_NET ON)
+setup_option(IO_SERIAL ON)
+setup_option(IO_PPP ON)
+
+# PPP assigns the addresses and does not need ARP.
+setup_option(NET_DHCP OFF)
+setup_option(NET_ARP OFF)
+
+# Suppress the system tick while idle.
+setup_option(CONFIG_TICKLESS ON)
+
+# Update the number of ticks per second to 1000.
+setup_option(SOFT_TICKS_PER_SEC 1000)
+
+# Setup PPP options exercised by the benchmarks.
+setup_option(PPP_FCS32 ON)
+setup_option(PPP_VJ ON)
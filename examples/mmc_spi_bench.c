@@ -0,0 +1,739 @@
+/*
+ * mmc_spi_bench.c
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+#include <stdio.h>
+#include <string.h>
+#include <fs.h>
+#include <mmc_spi.h>
+#include <ffdiskio.h>
+#include <serial.h>
+
+#ifndef FS_FAT
+#error "This demo requires FS_FAT."
+#endif
+
+/* This demo will run the MMC SPI driver against a RAM backed SD card emulator
+ * attached as the SPI device. The emulator takes some time to send the data
+ * token for each sector, longer for the first sector of a read, and stays busy
+ * for some time after each sector is written, longer at the end of a write,
+ * like a real card, and each byte takes as long as it would take on a
+ * BENCH_SPI_MHZ SPI bus. Sector access patterns a FAT file system would
+ * generate are issued through the disk interface and time taken, number of
+ * commands and bytes exchanged on the SPI bus are printed for each pattern.
+ * All the data written is verified in the emulator and read back. */
+
+/* Demo configurations. */
+#define DEMO_STACK_SIZE         2048
+#define BENCH_SPI_MHZ           21
+#define BENCH_SEQ_SECTORS       128
+#define BENCH_RANDOM_READS      64
+#define BENCH_FAT_WRITES        32
+#define BENCH_DATA_START        256
+#define BENCH_FAT_START         32
+#define BENCH_CLUSTER_SECTORS   4
+
+/* Card emulator configurations. */
+#define BENCH_CARD_SECTORS      1024
+#define BENCH_READ_LATENCY      500
+#define BENCH_STREAM_LATENCY    20
+#define BENCH_WRITE_LATENCY     150
+#define BENCH_COMMIT_LATENCY    1000
+#define BENCH_OUT_SIZE          32
+
+/* Card emulator states. */
+#define BENCH_CARD_IDLE         0
+#define BENCH_CARD_READ         1
+#define BENCH_CARD_WRITE        2
+
+/* Data transfer phases. */
+#define BENCH_PHASE_TOKEN       0
+#define BENCH_PHASE_DATA        1
+#define BENCH_PHASE_CRC         2
+
+/* RAM backed SD card emulator. */
+typedef struct _bench_card
+{
+    /* Card data. */
+    uint8_t     data[BENCH_CARD_SECTORS][MMC_SPI_SECTOR_SIZE];
+
+    /* Time at which next data token will be sent and till which card will
+     * remain busy. */
+    uint64_t    ready;
+    uint64_t    busy;
+
+    /* Number of commands and bytes exchanged. */
+    uint32_t    num_cmds;
+    uint32_t    num_bytes;
+
+    /* Sector being transferred and byte index in current phase. */
+    uint32_t    sector;
+    uint32_t    index;
+
+    /* Bytes queued to be sent to the host. */
+    uint32_t    out_head;
+    uint32_t    out_tail;
+    uint8_t     out[BENCH_OUT_SIZE];
+
+    /* Command being received. */
+    uint8_t     cmd[MMC_SPI_CMD_LEN];
+    uint8_t     cmd_len;
+
+    /* Card state. */
+    uint8_t     state;
+    uint8_t     phase;
+    uint8_t     selected;
+    uint8_t     app;
+    uint8_t     idle;
+
+    /* Structure padding. */
+    uint8_t     pad[2];
+} BENCH_CARD;
+
+/* Function prototypes. */
+void mmc_spi_bench_task(void *);
+static void bench_card_push(uint8_t);
+static void bench_card_execute(void);
+static uint8_t bench_card_xfer(uint8_t);
+static void bench_spi_init(SPI_DEVICE *);
+static void bench_spi_select(SPI_DEVICE *);
+static void bench_spi_unselect(SPI_DEVICE *);
+static int32_t bench_spi_msg(SPI_DEVICE *, SPI_MSG *);
+static void bench_fill(uint8_t *, uint32_t, uint32_t);
+static void bench_read(uint32_t);
+static void bench_write(uint32_t, uint32_t);
+static void bench_sync(void);
+static void bench_start(void);
+static void bench_print(char *, uint32_t);
+static void mmc_spi_bench_run(void);
+
+/* Benchmark task stack. */
+TASK mmc_spi_bench_cb;
+uint8_t mmc_spi_bench_stack[DEMO_STACK_SIZE];
+
+/* Emulated card and the MMC device attached to it. */
+static BENCH_CARD bench_card;
+static MMC_SPI bench_mmc;
+
+/* CSD of a 512KB SDv2 card. */
+static const uint8_t bench_csd[MMC_SPI_CSD_LEN] = { 0x40, 0x0E, 0x00, 0x32, 0x5B, 0x59, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x80, 0x0A, 0x40, 0x00, 0x01 };
+
+/* Generation of data last written on each sector. */
+static uint32_t bench_generation[BENCH_CARD_SECTORS];
+
+/* Time till which SPI bus is busy in nanoseconds. */
+static uint64_t bench_bus_ns;
+
+/* Benchmark statistics. */
+static uint64_t bench_tick;
+static uint32_t bench_cmds, bench_bytes;
+
+/* Sector buffers. */
+static uint8_t bench_buffer[MMC_SPI_SECTOR_SIZE];
+static uint8_t bench_expected[MMC_SPI_SECTOR_SIZE];
+
+/*
+ * bench_card_push
+ * @byte: Byte needed to be sent to the host.
+ * This function will queue a byte to be sent to the host.
+ */
+static void bench_card_push(uint8_t byte)
+{
+    /* Queue this byte. */
+    ASSERT((bench_card.out_tail - bench_card.out_head) >= BENCH_OUT_SIZE);
+    bench_card.out[(bench_card.out_tail++) % BENCH_OUT_SIZE] = byte;
+
+} /* bench_card_push */
+
+/*
+ * bench_card_execute
+ * This function will execute a command received by the card.
+ */
+static void bench_card_execute(void)
+{
+    uint32_t argv = ((uint32_t)bench_card.cmd[1] << 24) | ((uint32_t)bench_card.cmd[2] << 16) | ((uint32_t)bench_card.cmd[3] << 8) | bench_card.cmd[4];
+    uint8_t cmd = (bench_card.cmd[0] & 0x3F), app = bench_card.app, i;
+
+    bench_card.num_cmds ++;
+    bench_card.app = FALSE;
+
+    /* Any command terminates the current transfer. */
+    bench_card.state = BENCH_CARD_IDLE;
+    bench_card.out_head = bench_card.out_tail;
+
+    /* Response comes after a byte. */
+    bench_card_push(0xFF);
+
+    switch (cmd)
+    {
+    case MMC_SPI_CMD0:
+
+        /* Move to idle state. */
+        bench_card.idle = MMC_SPI_R1_IDLE;
+        bench_card_push(bench_card.idle);
+
+        break;
+
+    case MMC_SPI_CMD8:
+
+        /* Echo back the check pattern. */
+        bench_card_push(bench_card.idle);
+        bench_card_push(0x00);
+        bench_card_push(0x00);
+        bench_card_push((uint8_t)(argv >> 8));
+        bench_card_push((uint8_t)argv);
+
+        break;
+
+    case MMC_SPI_CMD55:
+
+        /* Next command is an application command. */
+        bench_card.app = TRUE;
+        bench_card_push(bench_card.idle);
+
+        break;
+
+    case MMC_SPI_CMD58:
+
+        /* Send OCR with CCS set. */
+        bench_card_push(bench_card.idle);
+        bench_card_push(0xC0);
+        bench_card_push(0xFF);
+        bench_card_push(0x80);
+        bench_card_push(0x00);
+
+        break;
+
+    case MMC_SPI_CMD9:
+
+        /* Send the CSD in a data block. */
+        bench_card_push(0x00);
+        bench_card_push(MMC_SPI_DATA_RX_TKN);
+        for (i = 0; i < MMC_SPI_CSD_LEN; i++)
+        {
+            bench_card_push(bench_csd[i]);
+        }
+        bench_card_push(0xFF);
+        bench_card_push(0xFF);
+
+        break;
+
+    case MMC_SPI_CMD12:
+    case MMC_SPI_CMD16:
+
+        /* Nothing to do here. */
+        bench_card_push(0x00);
+
+        break;
+
+    case MMC_SPI_CMD18:
+    case MMC_SPI_CMD25:
+
+        /* If this is a valid sector. */
+        if (argv < BENCH_CARD_SECTORS)
+        {
+            /* Start the transfer. */
+            bench_card_push(0x00);
+            bench_card.state = (uint8_t)((cmd == MMC_SPI_CMD18) ? BENCH_CARD_READ : BENCH_CARD_WRITE);
+            bench_card.phase = BENCH_PHASE_TOKEN;
+            bench_card.sector = argv;
+            bench_card.ready = current_hardware_tick() + US_TO_HW_TICK(BENCH_READ_LATENCY);
+        }
+        else
+        {
+            /* Parameter error. */
+            bench_card_push(0x40);
+        }
+
+        break;
+
+    default:
+
+        /* If this is ACMD41. */
+        if ((app == TRUE) && (cmd == MMC_SPI_ACMD41))
+        {
+            /* Card is now out of idle. */
+            bench_card.idle = 0;
+            bench_card_push(bench_card.idle);
+        }
+        else
+        {
+            /* Illegal command. */
+            bench_card_push(0x04);
+        }
+
+        break;
+    }
+
+} /* bench_card_execute */
+
+/*
+ * bench_card_xfer
+ * @mosi: Byte sent by the host.
+ * @return: Byte sent by the card.
+ * This function will exchange a byte with the emulated card.
+ */
+static uint8_t bench_card_xfer(uint8_t mosi)
+{
+    uint64_t now = current_hardware_tick();
+    uint8_t miso = 0xFF;
+
+    /* If card is selected. */
+    if (bench_card.selected == TRUE)
+    {
+        bench_card.num_bytes ++;
+
+        /* If we are receiving a data block. */
+        if ((bench_card.state == BENCH_CARD_WRITE) && (bench_card.phase != BENCH_PHASE_TOKEN))
+        {
+            if (bench_card.phase == BENCH_PHASE_DATA)
+            {
+                /* Save this byte. */
+                bench_card.data[bench_card.sector][bench_card.index++] = mosi;
+                if (bench_card.index == MMC_SPI_SECTOR_SIZE)
+                {
+                    bench_card.phase = BENCH_PHASE_CRC;
+                    bench_card.index = 0;
+                }
+            }
+            else if ((++bench_card.index) == 2)
+            {
+                /* Data accepted, program this sector. */
+                bench_card_push(0x05);
+                bench_card.busy = now + US_TO_HW_TICK(BENCH_WRITE_LATENCY);
+                bench_card.phase = BENCH_PHASE_TOKEN;
+                bench_card.sector ++;
+                if (bench_card.sector == BENCH_CARD_SECTORS)
+                {
+                    bench_card.state = BENCH_CARD_IDLE;
+                }
+            }
+        }
+
+        /* If we are receiving a command. */
+        else if ((bench_card.cmd_len > 0) || ((mosi & 0xC0) == 0x40))
+        {
+            bench_card.cmd[bench_card.cmd_len++] = mosi;
+            if (bench_card.cmd_len == MMC_SPI_CMD_LEN)
+            {
+                bench_card.cmd_len = 0;
+                bench_card_execute();
+            }
+        }
+
+        else
+        {
+            /* If host has sent a token for write. */
+            if ((bench_card.state == BENCH_CARD_WRITE) && (mosi == MMC_SPI_DATA_TX_TKN))
+            {
+                bench_card.phase = BENCH_PHASE_DATA;
+                bench_card.index = 0;
+            }
+            else if ((bench_card.state == BENCH_CARD_WRITE) && (mosi == MMC_SPI_DATA_ST_TKN))
+            {
+                bench_card.state = BENCH_CARD_IDLE;
+                bench_card.busy = now + US_TO_HW_TICK(BENCH_COMMIT_LATENCY);
+            }
+
+            /* If we have something queued. */
+            if (bench_card.out_head != bench_card.out_tail)
+            {
+                miso = bench_card.out[(bench_card.out_head++) % BENCH_OUT_SIZE];
+            }
+
+            /* If we are sending a data block. */
+            else if (bench_card.state == BENCH_CARD_READ)
+            {
+                if (bench_card.phase == BENCH_PHASE_TOKEN)
+                {
+                    /* If data is now ready. */
+                    if (now >= bench_card.ready)
+                    {
+                        miso = MMC_SPI_DATA_RX_TKN;
+                        bench_card.phase = BENCH_PHASE_DATA;
+                        bench_card.index = 0;
+                    }
+                }
+                else if (bench_card.phase == BENCH_PHASE_DATA)
+                {
+                    miso = bench_card.data[bench_card.sector][bench_card.index++];
+                    if (bench_card.index == MMC_SPI_SECTOR_SIZE)
+                    {
+                        bench_card.phase = BENCH_PHASE_CRC;
+                        bench_card.index = 0;
+                    }
+                }
+                else if ((++bench_card.index) == 2)
+                {
+                    /* Move to the next sector. */
+                    bench_card.phase = BENCH_PHASE_TOKEN;
+                    bench_card.ready = now + US_TO_HW_TICK(BENCH_STREAM_LATENCY);
+                    bench_card.sector ++;
+                    if (bench_card.sector == BENCH_CARD_SECTORS)
+                    {
+                        bench_card.state = BENCH_CARD_IDLE;
+                    }
+                }
+            }
+
+            /* If card is still programming. */
+            else if (now < bench_card.busy)
+            {
+                miso = 0x00;
+            }
+        }
+    }
+
+    /* Return the byte sent by the card. */
+    return (miso);
+
+} /* bench_card_xfer */
+
+/*
+ * bench_spi_init
+ * @device: SPI device.
+ * This function will initialize the SPI device.
+ */
+static void bench_spi_init(SPI_DEVICE *device)
+{
+    /* Some compiler warnings. */
+    UNUSED_PARAM(device);
+
+} /* bench_spi_init */
+
+/*
+ * bench_spi_select
+ * @device: SPI device.
+ * This function will select the emulated card.
+ */
+static void bench_spi_select(SPI_DEVICE *device)
+{
+    /* Some compiler warnings. */
+    UNUSED_PARAM(device);
+
+    bench_card.selected = TRUE;
+
+} /* bench_spi_select */
+
+/*
+ * bench_spi_unselect
+ * @device: SPI device.
+ * This function will unselect the emulated card.
+ */
+static void bench_spi_unselect(SPI_DEVICE *device)
+{
+    /* Some compiler warnings. */
+    UNUSED_PARAM(device);
+
+    /* Card will drop anything it was going to send. */
+    bench_card.selected = FALSE;
+    bench_card.cmd_len = 0;
+    bench_card.out_head = bench_card.out_tail;
+
+} /* bench_spi_unselect */
+
+/*
+ * bench_spi_msg
+ * @device: SPI device.
+ * @msg: SPI message needed to be exchanged.
+ * @return: Always returns success.
+ * This function will exchange a message with the emulated card, this will
+ * take as long as it would take on a real SPI bus.
+ */
+static int32_t bench_spi_msg(SPI_DEVICE *device, SPI_MSG *msg)
+{
+    uint64_t now = (HW_TICK_TO_US(current_hardware_tick()) * 1000);
+    int32_t i;
+    uint8_t miso;
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(device);
+
+    for (i = 0; i < msg->length; i++)
+    {
+        /* Exchange a byte. */
+        miso = bench_card_xfer((msg->flags & SPI_MSG_WRITE) ? msg->buffer[i] : 0xFF);
+        if (msg->flags & SPI_MSG_READ)
+        {
+            msg->buffer[i] = miso;
+        }
+    }
+
+    /* Wait for these bytes to be clocked on the bus. */
+    if (bench_bus_ns < now)
+    {
+        bench_bus_ns = now;
+    }
+    bench_bus_ns += (((uint64_t)msg->length * 8000) / BENCH_SPI_MHZ);
+    while ((HW_TICK_TO_US(current_hardware_tick()) * 1000) < bench_bus_ns)
+    {
+        ;
+    }
+
+    /* Return success. */
+    return (SUCCESS);
+
+} /* bench_spi_msg */
+
+/*
+ * bench_fill
+ * @buffer: Sector buffer needed to be filled.
+ * @sector: Sector number.
+ * @generation: Generation of data written on this sector.
+ * This function will fill a sector buffer with the data expected on a sector.
+ */
+static void bench_fill(uint8_t *buffer, uint32_t sector, uint32_t generation)
+{
+    uint32_t i;
+
+    for (i = 0; i < MMC_SPI_SECTOR_SIZE; i++)
+    {
+        buffer[i] = (uint8_t)((sector * 7) + (generation * 13) + i);
+    }
+
+} /* bench_fill */
+
+/*
+ * bench_read
+ * @sector: Sector needed to be read.
+ * This function will read a sector and verify it's data.
+ */
+static void bench_read(uint32_t sector)
+{
+    /* Read this sector and verify it. */
+    ASSERT(disk_read(0, bench_buffer, sector, 1) != RES_OK);
+    bench_fill(bench_expected, sector, bench_generation[sector]);
+    ASSERT(memcmp(bench_buffer, bench_expected, MMC_SPI_SECTOR_SIZE) != 0);
+
+} /* bench_read */
+
+/*
+ * bench_write
+ * @sector: Sector needed to be written.
+ * @count: Number of sectors.
+ * This function will write new data on a number of sectors.
+ */
+static void bench_write(uint32_t sector, uint32_t count)
+{
+    uint8_t buffer[MMC_SPI_SECTOR_SIZE * 2];
+    uint32_t i;
+
+    ASSERT(count > 2);
+
+    for (i = 0; i < count; i++)
+    {
+        /* Update the data for this sector. */
+        bench_generation[sector + i] ++;
+        bench_fill(&buffer[i * MMC_SPI_SECTOR_SIZE], (sector + i), bench_generation[sector + i]);
+    }
+
+    /* Write these sectors. */
+    ASSERT(disk_write(0, buffer, sector, count) != RES_OK);
+
+} /* bench_write */
+
+/*
+ * bench_sync
+ * This function will synchronize the disk and verify the data on the card.
+ */
+static void bench_sync(void)
+{
+    uint32_t sector;
+
+    /* Synchronize the disk. */
+    ASSERT(disk_ioctl(0, CTRL_SYNC, NULL) != RES_OK);
+
+    /* Verify all the data on the card. */
+    for (sector = 0; sector < BENCH_CARD_SECTORS; sector++)
+    {
+        bench_fill(bench_expected, sector, bench_generation[sector]);
+        ASSERT(memcmp(bench_card.data[sector], bench_expected, MMC_SPI_SECTOR_SIZE) != 0);
+    }
+
+} /* bench_sync */
+
+/*
+ * bench_start
+ * This function will start a test.
+ */
+static void bench_start(void)
+{
+    /* Save the start time and card statistics. */
+    bench_cmds = bench_card.num_cmds;
+    bench_bytes = bench_card.num_bytes;
+    bench_tick = current_hardware_tick();
+
+} /* bench_start */
+
+/*
+ * bench_print
+ * @name: Name of this test.
+ * @num_sectors: Number of sectors transferred.
+ * This function will print the results of a test.
+ */
+static void bench_print(char *name, uint32_t num_sectors)
+{
+    uint64_t time = HW_TICK_TO_US(current_hardware_tick() - bench_tick);
+    uint32_t bytes = (bench_card.num_bytes - bench_bytes);
+
+    /* Print the results. */
+    printf("%s: %lu sectors in %lu us (%lu us/sector, %lu KB/s), %lu commands, %lu bus bytes\r\n", name,
+           (unsigned long)num_sectors, (unsigned long)time, (unsigned long)(time / num_sectors),
+           (unsigned long)((time > 0) ? (((uint64_t)num_sectors * MMC_SPI_SECTOR_SIZE * 1000000) / (time * 1024)) : 0),
+           (unsigned long)(bench_card.num_cmds - bench_cmds), (unsigned long)bytes);
+
+} /* bench_print */
+
+/*
+ * mmc_spi_bench_run
+ * This function will run all the tests.
+ */
+static void mmc_spi_bench_run(void)
+{
+    uint32_t i, seed = 0x1234567;
+
+    /* Read sectors one by one as a file is read. */
+    bench_start();
+    for (i = 0; i < BENCH_SEQ_SECTORS; i++)
+    {
+        bench_read(BENCH_DATA_START + i);
+    }
+    bench_print("sequential read", BENCH_SEQ_SECTORS);
+
+    /* Read a file, FAT is read at the start of each cluster. */
+    bench_start();
+    for (i = 0; i < BENCH_SEQ_SECTORS; i++)
+    {
+        if ((i % BENCH_CLUSTER_SECTORS) == 0)
+        {
+            bench_read(BENCH_FAT_START);
+        }
+        bench_read(BENCH_DATA_START + BENCH_SEQ_SECTORS + i);
+    }
+    bench_print("file read", (BENCH_SEQ_SECTORS + (BENCH_SEQ_SECTORS / BENCH_CLUSTER_SECTORS)));
+
+    /* Read random sectors. */
+    bench_start();
+    for (i = 0; i < BENCH_RANDOM_READS; i++)
+    {
+        seed = (seed * 1103515245) + 12345;
+        bench_read((seed >> 16) % BENCH_CARD_SECTORS);
+    }
+    bench_print("random read", BENCH_RANDOM_READS);
+
+    /* Write sectors one by one as a file is written. */
+    bench_start();
+    for (i = 0; i < BENCH_SEQ_SECTORS; i++)
+    {
+        bench_write((BENCH_DATA_START + i), 1);
+    }
+    bench_sync();
+    bench_print("sequential write", BENCH_SEQ_SECTORS);
+
+    /* Append to a file, each data sector also updates the FAT and the
+     * directory entry. */
+    bench_start();
+    for (i = 0; i < BENCH_FAT_WRITES; i++)
+    {
+        bench_write((BENCH_DATA_START + BENCH_SEQ_SECTORS + i), 1);
+        bench_read(BENCH_FAT_START);
+        bench_write(BENCH_FAT_START, 1);
+        bench_write((BENCH_FAT_START + 64), 1);
+    }
+    bench_sync();
+    bench_print("file append", (BENCH_FAT_WRITES * 4));
+
+    /* Write and read back a number of sectors at once. */
+    bench_start();
+    for (i = 0; i < BENCH_SEQ_SECTORS; i += 2)
+    {
+        bench_write((BENCH_DATA_START + i), 2);
+    }
+    bench_sync();
+    for (i = 0; i < BENCH_SEQ_SECTORS; i++)
+    {
+        bench_read(BENCH_DATA_START + i);
+    }
+    bench_print("write and read back", (BENCH_SEQ_SECTORS * 2));
+
+} /* mmc_spi_bench_run */
+
+void mmc_spi_bench_task(void *argv)
+{
+    uint32_t sector;
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(argv);
+
+    /* Initialize the card data. */
+    for (sector = 0; sector < BENCH_CARD_SECTORS; sector++)
+    {
+        bench_fill(bench_card.data[sector], sector, 0);
+    }
+
+    /* Attach the MMC device with the emulated card. */
+    bench_mmc.spi.init = &bench_spi_init;
+    bench_mmc.spi.slave_select = &bench_spi_select;
+    bench_mmc.spi.slave_unselect = &bench_spi_unselect;
+    bench_mmc.spi.msg = &bench_spi_msg;
+
+#ifdef MMC_SPI_FS
+    /* Register MMC device with file system. */
+    mmc_spi_fsregister(&bench_mmc, "\\mmc0");
+#endif /* MMC_SPI_FS */
+
+#ifdef MMC_SPI_CACHE
+    /* Register cached MMC device with disk interface. */
+    disk_register(&bench_mmc, &mmc_spi_init, &mmc_spi_cache_read, &mmc_spi_cache_write, MMC_SPI_SECTOR_SIZE, 0);
+    disk_register_sync(0, &mmc_spi_cache_sync);
+#else
+    /* Register MMC device with disk interface. */
+    disk_register(&bench_mmc, &mmc_spi_init, &mmc_spi_read, &mmc_spi_write, MMC_SPI_SECTOR_SIZE, 0);
+#endif /* MMC_SPI_CACHE */
+
+    /* Initialize the card. */
+    ASSERT(disk_initialize(0) != RES_OK);
+
+    /* Run the benchmark. */
+    mmc_spi_bench_run();
+    printf("done\r\n");
+
+    for (;;)
+    {
+        /* Nothing more to do. */
+        sleep_ticks(SOFT_TICKS_PER_SEC);
+    }
+}
+
+int main(void)
+{
+    memset(&mmc_spi_bench_cb, 0, sizeof(TASK));
+
+    /* Initialize scheduler. */
+    scheduler_init();
+
+    /* Initialize file system. */
+    fs_init();
+
+    /* Initialize serial. */
+    serial_init();
+
+    /* Create a task for MMC benchmark. */
+    task_create(&mmc_spi_bench_cb, P_STR("BENCH"), mmc_spi_bench_stack, DEMO_STACK_SIZE, &mmc_spi_bench_task, (void *)(NULL), 0);
+    scheduler_task_add(&mmc_spi_bench_cb, 5);
+
+    /* Run scheduler. */
+    kernel_run();
+
+    return (0);
+
+}
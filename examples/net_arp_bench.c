@@ -0,0 +1,242 @@
+/*
+ * net_arp_bench.c
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+#include <stdio.h>
+#include <string.h>
+#include <fs.h>
+#include <net.h>
+#include <ethernet.h>
+#include <net_arp.h>
+#include <serial.h>
+
+/* This demo will populate the ARP entries of a dummy ethernet device with a
+ * number of neighbours and will resolve a set of neighbours, once with a
+ * linear scan over the neighbours and once with arp_resolve, and will print
+ * the per packet cost. Cost of resolving the same neighbour again, that will
+ * be served from the last resolved entry, is also printed. */
+
+/* Demo configurations. */
+#define DEMO_STACK_SIZE     1024
+#define BENCH_ITERATIONS    16
+#define BENCH_NUM_DST       256
+#define BENCH_NUM_ENTRIES   256
+
+/* Use the hardware tick if we don't have a cycle counter. */
+#ifdef CPU_CYCLE_COUNT
+#define BENCH_TIMESTAMP()   (uint32_t)CPU_CYCLE_COUNT()
+#else
+#define BENCH_TIMESTAMP()   (uint32_t)current_hardware_tick()
+#endif /* CPU_CYCLE_COUNT */
+
+/* Function prototypes. */
+void net_arp_bench_task(void *);
+static void net_arp_bench_setup(uint32_t);
+static uint32_t net_arp_bench_linear(uint32_t, uint8_t *);
+static uint32_t net_arp_bench_resolve(uint32_t, uint8_t *);
+static uint32_t net_arp_bench_run(uint32_t (*)(uint32_t, uint8_t *), uint8_t);
+
+/* Benchmark task stack. */
+TASK net_arp_bench_cb;
+uint8_t net_arp_bench_stack[DEMO_STACK_SIZE];
+
+/* Benchmark data. */
+static ETH_DEVICE bench_device;
+static FS_BUFFER_LIST bench_buffer;
+static ARP_ENTRY bench_entries[BENCH_NUM_ENTRIES];
+static ARP_ENTRY bench_linear_entries[BENCH_NUM_ENTRIES];
+static uint32_t bench_num_neighbours;
+static uint32_t bench_dst[BENCH_NUM_DST];
+static uint32_t bench_seed = 0x1234567;
+
+/*
+ * net_arp_bench_setup
+ * @num_neighbours: Number of neighbours to be added.
+ * This function will populate the ARP entries and the reference entries and
+ * will pick the neighbours to resolve.
+ */
+static void net_arp_bench_setup(uint32_t num_neighbours)
+{
+    uint32_t i;
+    uint8_t mac[ETH_ADDR_LEN] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+    /* Clear the ARP entries. */
+    memset(bench_entries, 0, sizeof(bench_entries));
+    memset(bench_linear_entries, 0, sizeof(bench_linear_entries));
+    bench_device.arp.entries = bench_entries;
+    bench_device.arp.num_entries = BENCH_NUM_ENTRIES;
+    bench_device.arp.last = 0;
+
+    /* Add the neighbours in 10.0.0.0/16. */
+    for (i = 0; i < num_neighbours; i++)
+    {
+        mac[4] = (uint8_t)(i >> 8);
+        mac[5] = (uint8_t)i;
+        ASSERT(arp_add_static((FD)&bench_device, (0x0A000001 + i), mac) != SUCCESS);
+
+        bench_linear_entries[i].ip = (0x0A000001 + i);
+        bench_linear_entries[i].flags = (ARP_FLAG_VALID | ARP_FLAG_UP | ARP_FLAG_STATIC);
+        memcpy(bench_linear_entries[i].mac, mac, ETH_ADDR_LEN);
+    }
+    bench_num_neighbours = num_neighbours;
+
+    /* Pick the neighbours to resolve. */
+    for (i = 0; i < BENCH_NUM_DST; i++)
+    {
+        bench_seed = (bench_seed * 1103515245) + 12345;
+        bench_dst[i] = (0x0A000001 + ((bench_seed >> 16) % num_neighbours));
+    }
+
+} /* net_arp_bench_setup */
+
+/*
+ * net_arp_bench_linear
+ * @dst_ip: Destination IP needed to be resolved.
+ * @dst_addr: Destination MAC address will be copied in here.
+ * @return: A success status will be returned if destination was resolved.
+ * This function will resolve a destination by scanning all the reference
+ * entries.
+ */
+static uint32_t net_arp_bench_linear(uint32_t dst_ip, uint8_t *dst_addr)
+{
+    int32_t status = NET_DST_UNREACHABLE;
+    uint32_t i;
+
+    /* Go though all the ARP entries. */
+    for (i = 0; i < bench_num_neighbours; i++)
+    {
+        /* If this required entry. */
+        if ((bench_linear_entries[i].ip == dst_ip) && (bench_linear_entries[i].flags & ARP_FLAG_UP))
+        {
+            /* Return the destination MAC address to be used. */
+            memcpy(dst_addr, bench_linear_entries[i].mac, ETH_ADDR_LEN);
+            status = SUCCESS;
+
+            /* Break out of this loop. */
+            break;
+        }
+    }
+
+    /* Return status to the caller. */
+    return ((uint32_t)status);
+
+} /* net_arp_bench_linear */
+
+/*
+ * net_arp_bench_resolve
+ * @dst_ip: Destination IP needed to be resolved.
+ * @dst_addr: Destination MAC address will be copied in here.
+ * @return: A success status will be returned if destination was resolved.
+ * This function will resolve a destination using the ARP entries.
+ */
+static uint32_t net_arp_bench_resolve(uint32_t dst_ip, uint8_t *dst_addr)
+{
+    /* Resolve this destination. */
+    return ((uint32_t)arp_resolve(&bench_buffer, dst_ip, dst_addr));
+
+} /* net_arp_bench_resolve */
+
+/*
+ * net_arp_bench_run
+ * @resolve: Resolve function to be used.
+ * @repeat: If we need to resolve the same neighbour again.
+ * @return: Returns the average cost of resolving a neighbour.
+ * This function will resolve the neighbours using the given function.
+ */
+static uint32_t net_arp_bench_run(uint32_t (*resolve)(uint32_t, uint8_t *), uint8_t repeat)
+{
+    uint32_t i, j, start;
+    volatile uint8_t last_byte;
+    uint8_t mac[ETH_ADDR_LEN];
+
+    /* Clear the resolved address. */
+    memset(mac, 0, ETH_ADDR_LEN);
+
+    start = BENCH_TIMESTAMP();
+
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        for (j = 0; j < BENCH_NUM_DST; j++)
+        {
+            /* Resolve this neighbour. */
+            ASSERT(resolve(bench_dst[(repeat == TRUE) ? 0 : j], mac) != SUCCESS);
+            last_byte = mac[ETH_ADDR_LEN - 1];
+        }
+    }
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(last_byte);
+
+    /* Return the per packet cost. */
+    return ((BENCH_TIMESTAMP() - start) / (BENCH_ITERATIONS * BENCH_NUM_DST));
+
+} /* net_arp_bench_run */
+
+void net_arp_bench_task(void *argv)
+{
+    static const uint32_t num_neighbours[] = {1, 16, 128, 200};
+    uint32_t i, j;
+    uint8_t linear_mac[ETH_ADDR_LEN], resolve_mac[ETH_ADDR_LEN];
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(argv);
+
+    /* Resolve on the dummy ethernet device. */
+    bench_buffer.fd = (FD)&bench_device;
+
+    for (;;)
+    {
+        for (i = 0; i < (sizeof(num_neighbours) / sizeof(uint32_t)); i++)
+        {
+            /* Populate the ARP entries. */
+            net_arp_bench_setup(num_neighbours[i]);
+
+            /* Verify the ARP resolution. */
+            for (j = 0; j < BENCH_NUM_DST; j++)
+            {
+                ASSERT(net_arp_bench_linear(bench_dst[j], linear_mac) != SUCCESS);
+                ASSERT(net_arp_bench_resolve(bench_dst[j], resolve_mac) != SUCCESS);
+                ASSERT(memcmp(linear_mac, resolve_mac, ETH_ADDR_LEN) != 0);
+            }
+
+            /* Run the benchmark and print the results. */
+            printf("%lu neighbours: linear %lu, hashed %lu, last hit %lu\r\n", (unsigned long)num_neighbours[i], (unsigned long)net_arp_bench_run(&net_arp_bench_linear, FALSE), (unsigned long)net_arp_bench_run(&net_arp_bench_resolve, FALSE), (unsigned long)net_arp_bench_run(&net_arp_bench_resolve, TRUE));
+        }
+
+        /* Wait before running the benchmark again. */
+        sleep_ticks(SOFT_TICKS_PER_SEC);
+    }
+}
+
+int main(void)
+{
+    memset(&net_arp_bench_cb, 0, sizeof(TASK));
+
+    /* Initialize scheduler. */
+    scheduler_init();
+
+    /* Initialize file system. */
+    fs_init();
+
+    /* Initialize serial. */
+    serial_init();
+
+    /* Create a task for ARP resolution benchmark. */
+    task_create(&net_arp_bench_cb, P_STR("BENCH"), net_arp_bench_stack, DEMO_STACK_SIZE, &net_arp_bench_task, (void *)(NULL), 0);
+    scheduler_task_add(&net_arp_bench_cb, 5);
+
+    /* Run scheduler. */
+    kernel_run();
+
+    return (0);
+
+}
@@ -0,0 +1,371 @@
+/*
+ * net_csum_bench.c
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+#include <stdio.h>
+#include <string.h>
+#include <fs.h>
+#include <net.h>
+#include <net_csum.h>
+#include <serial.h>
+
+/* This demo will calculate checksum of a synthesized payload pushed on
+ * different buffer chain shapes, once with the half word at a time reference
+ * implementation and once with the word at a time checksum engine, and will
+ * print the per packet cost. Results of both the implementations are verified
+ * for a number of offsets and lengths before running the benchmark. */
+
+/* Demo configurations. */
+#define DEMO_STACK_SIZE     1024
+#define BENCH_ITERATIONS    1000
+#define BENCH_PAYLOAD_SIZE  1500
+#define BENCH_SINGLE_SIZE   1536
+#define BENCH_SINGLE_NUM    1
+#define BENCH_MEDIUM_SIZE   512
+#define BENCH_MEDIUM_NUM    3
+#define BENCH_SMALL_SIZE    32
+#define BENCH_SMALL_NUM     48
+
+/* Use the hardware tick if we don't have a cycle counter. */
+#ifdef CPU_CYCLE_COUNT
+#define BENCH_TIMESTAMP()   (uint32_t)CPU_CYCLE_COUNT()
+#else
+#define BENCH_TIMESTAMP()   (uint32_t)current_hardware_tick()
+#endif /* CPU_CYCLE_COUNT */
+
+/* Buffer file descriptor used for the benchmark. */
+typedef struct _bench_fd
+{
+    FS              fs;
+    FS_BUFFER_DATA  buffer_data;
+    FS_BUFFER_LIST  list;
+} BENCH_FD;
+
+/* Function prototypes. */
+void net_csum_bench_task(void *);
+static FS_BUFFER_LIST *net_csum_bench_setup(BENCH_FD *, FS_BUFFER *, uint8_t *, uint32_t, uint32_t);
+static uint16_t net_csum_bench_reference(FS_BUFFER_LIST *, int32_t, uint32_t);
+static void net_csum_bench_verify(FS_BUFFER_LIST *);
+static uint32_t net_csum_bench_run(FS_BUFFER_LIST *, uint16_t (*)(FS_BUFFER_LIST *, int32_t, uint32_t));
+
+/* Benchmark task stack. */
+TASK net_csum_bench_cb;
+uint8_t net_csum_bench_stack[DEMO_STACK_SIZE];
+
+/* Benchmark buffer data. */
+BENCH_FD bench_single_fd, bench_medium_fd, bench_small_fd;
+FS_BUFFER bench_single_buffers[BENCH_SINGLE_NUM];
+FS_BUFFER bench_medium_buffers[BENCH_MEDIUM_NUM];
+FS_BUFFER bench_small_buffers[BENCH_SMALL_NUM];
+uint8_t bench_single_space[BENCH_SINGLE_SIZE * BENCH_SINGLE_NUM];
+uint8_t bench_medium_space[BENCH_MEDIUM_SIZE * BENCH_MEDIUM_NUM];
+uint8_t bench_small_space[BENCH_SMALL_SIZE * BENCH_SMALL_NUM];
+
+/* Synthesized payload. */
+static uint32_t bench_payload[BENCH_PAYLOAD_SIZE / 4];
+
+/*
+ * net_csum_bench_setup
+ * @bench_fd: Benchmark file descriptor needed to be initialized.
+ * @buffers: Buffers to be used.
+ * @space: Buffer space to be used.
+ * @size: Size of each buffer.
+ * @num: Number of buffers.
+ * @return: Returns the buffer list with the synthesized payload.
+ * This function will initialize a buffer file descriptor and push the
+ * synthesized payload on a buffer list.
+ */
+static FS_BUFFER_LIST *net_csum_bench_setup(BENCH_FD *bench_fd, FS_BUFFER *buffers, uint8_t *space, uint32_t size, uint32_t num)
+{
+    FD fd = (FD)&bench_fd->fs;
+    FS_BUFFER_LIST *buffer;
+
+    /* Clear the file descriptor. */
+    memset(bench_fd, 0, sizeof(BENCH_FD));
+
+    /* Set buffer data for our file descriptor. */
+    bench_fd->buffer_data.buffer_space = space;
+    bench_fd->buffer_data.buffer_size = size;
+    bench_fd->buffer_data.buffers = buffers;
+    bench_fd->buffer_data.num_buffers = num;
+    bench_fd->buffer_data.buffer_lists = &bench_fd->list;
+    bench_fd->buffer_data.num_buffer_lists = 1;
+    fs_buffer_dataset(fd, &bench_fd->buffer_data);
+
+    /* Pull a buffer list and push the payload on it. */
+    buffer = fs_buffer_get(fd, FS_LIST_FREE, 0);
+    ASSERT(buffer == NULL);
+    ASSERT(fs_buffer_list_push(buffer, (uint8_t *)bench_payload, BENCH_PAYLOAD_SIZE, 0) != SUCCESS);
+
+    /* Return the buffer list. */
+    return (buffer);
+
+} /* net_csum_bench_setup */
+
+/*
+ * net_csum_bench_reference
+ * @buffer: File system buffer for which checksum is needed to be calculated.
+ * @num_bytes: Number of bytes for which the checksum is needed to be calculated.
+ * @offset: Number of bytes we need to skip.
+ * This function is the half word at a time checksum implementation used as the
+ * reference for the checksum engine.
+ */
+static uint16_t net_csum_bench_reference(FS_BUFFER_LIST *buffer, int32_t num_bytes, uint32_t offset)
+{
+    FS_BUFFER *one = buffer->list.head;
+    uint32_t csum = 0, left = 0;
+    uint16_t *bytes = (uint16_t *)one->buffer;
+    uint8_t last_left = FALSE;
+
+    /* If we have negative number of bytes. */
+    if (num_bytes < 0)
+    {
+        /* Should never happen. */
+        ASSERT(offset > buffer->total_length);
+
+        /* Return the checksum for all the data in the buffer. */
+        num_bytes = (int32_t)(buffer->total_length - offset);
+    }
+    else
+    {
+        /* Should never happen. */
+        ASSERT((offset + (uint32_t)num_bytes) > buffer->total_length);
+    }
+
+    /* Move over the offset. */
+    while ((one) && (offset > 0))
+    {
+        /* If this buffer has more data to process. */
+        if (one->length > offset)
+        {
+            /* Pick the number of bytes we have in this buffer. */
+            left = (one->length - offset);
+
+            /* Pick the pointer to the data for which checksum is needed. */
+            bytes = (uint16_t *)&one->buffer[offset];
+
+            /* Break out of this loop. */
+            break;
+        }
+        else
+        {
+            /* Update the remaining offset. */
+            offset -= one->length;
+        }
+
+        /* Pick the next buffer. */
+        one = one->next;
+    }
+
+    while ((one) && (num_bytes > 0))
+    {
+        /* If we need to get this buffer information. */
+        if (left == 0)
+        {
+            /* Pick the number of bytes we have in this buffer. */
+            left = one->length;
+            bytes = (uint16_t *)one->buffer;
+        }
+
+        /* If this buffer has more data than required. */
+        if ((int32_t)left > num_bytes)
+        {
+            /* Only process required number of bytes. */
+            left = (uint32_t)num_bytes;
+            num_bytes = 0;
+        }
+        else
+        {
+            /* Decrement the number of bytes we will process from this buffer. */
+            num_bytes -= (int32_t)left;
+        }
+
+        /* If we have a byte left from the last buffer. */
+        if (last_left == TRUE)
+        {
+            /* If we have at-least a byte in this buffer. */
+            if (left > 0)
+            {
+                /* Add first byte in checksum. */
+#ifdef LITTLE_ENDIAN
+                csum += (uint16_t)(*((uint8_t *)bytes) << 8);
+#else
+                csum += *((uint8_t *)bytes);
+#endif
+                bytes = (uint16_t *)((uint8_t *)bytes + 1);
+
+                /* Reset the last left flag. */
+                last_left = FALSE;
+
+                /* Remove the last byte. */
+                left -= 1;
+            }
+        }
+
+        /* While we have data in this buffer. */
+        while (left >= 2)
+        {
+            /* Add data from this buffer. */
+            csum += *bytes;
+            bytes++;
+
+            /* Decrement number of bytes left to process. */
+            left = (uint32_t)(left - 2);
+        }
+
+        /* If we still have a byte left on this buffer. */
+        if (left == 1)
+        {
+            /* Add last byte in checksum. */
+#ifdef LITTLE_ENDIAN
+            csum += *((uint8_t *)bytes);
+#else
+            csum += (uint16_t)(*((uint8_t *)bytes) << 8);
+#endif
+
+            /* We we still need to process next byte. */
+            if (one ->next != NULL)
+            {
+                /* We need to add first byte from the next buffer as it is. */
+                last_left = TRUE;
+            }
+
+            /* Remove the last byte. */
+            left -= 1;
+        }
+
+        /* Pick the next buffer. */
+        one = one->next;
+    }
+
+    /* Add back the carry to the checksum. */
+    csum = (csum & 0xFFFF) + (csum >> 16);
+    csum = (csum & 0xFFFF) + (csum >> 16);
+
+    /* Take one's complement of the checksum. */
+    return (~(csum) & 0xFFFF);
+
+} /* net_csum_bench_reference */
+
+/*
+ * net_csum_bench_verify
+ * @buffer: Buffer list to be verified.
+ * This function will verify the checksum engine against the reference
+ * implementation for different offsets and lengths.
+ */
+static void net_csum_bench_verify(FS_BUFFER_LIST *buffer)
+{
+    uint32_t offset, length;
+
+    /* Verify all the offsets across the first few buffers. */
+    for (offset = 0; offset < 70; offset++)
+    {
+        /* Verify checksum for the remaining data. */
+        ASSERT(net_csum_calculate(buffer, -1, offset) != net_csum_bench_reference(buffer, -1, offset));
+
+        /* Verify some odd and even lengths. */
+        for (length = 1; length < (BENCH_PAYLOAD_SIZE - offset); length += 37)
+        {
+            ASSERT(net_csum_calculate(buffer, (int32_t)length, offset) != net_csum_bench_reference(buffer, (int32_t)length, offset));
+        }
+    }
+
+} /* net_csum_bench_verify */
+
+/*
+ * net_csum_bench_run
+ * @buffer: Buffer list for which checksum is needed.
+ * @csum: Checksum function to be used.
+ * @return: Returns the average cost of calculating checksum of a packet.
+ * This function will run a checksum function on the given buffer list.
+ */
+static uint32_t net_csum_bench_run(FS_BUFFER_LIST *buffer, uint16_t (*csum)(FS_BUFFER_LIST *, int32_t, uint32_t))
+{
+    uint32_t i, start;
+    volatile uint16_t result;
+
+    start = BENCH_TIMESTAMP();
+
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        /* Calculate checksum of the payload. */
+        result = csum(buffer, -1, 0);
+    }
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(result);
+
+    /* Return the per packet cost. */
+    return ((BENCH_TIMESTAMP() - start) / BENCH_ITERATIONS);
+
+} /* net_csum_bench_run */
+
+void net_csum_bench_task(void *argv)
+{
+    FS_BUFFER_LIST *single, *medium, *small;
+    uint32_t i, seed = 0x1234567;
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(argv);
+
+    /* Synthesize the payload. */
+    for (i = 0; i < (BENCH_PAYLOAD_SIZE / 4); i++)
+    {
+        seed = (seed * 1103515245) + 12345;
+        bench_payload[i] = seed;
+    }
+
+    /* Setup the buffer lists. */
+    single = net_csum_bench_setup(&bench_single_fd, bench_single_buffers, bench_single_space, BENCH_SINGLE_SIZE, BENCH_SINGLE_NUM);
+    medium = net_csum_bench_setup(&bench_medium_fd, bench_medium_buffers, bench_medium_space, BENCH_MEDIUM_SIZE, BENCH_MEDIUM_NUM);
+    small = net_csum_bench_setup(&bench_small_fd, bench_small_buffers, bench_small_space, BENCH_SMALL_SIZE, BENCH_SMALL_NUM);
+
+    /* Verify the checksum engine. */
+    net_csum_bench_verify(single);
+    net_csum_bench_verify(medium);
+    net_csum_bench_verify(small);
+
+    for (;;)
+    {
+        /* Run the benchmark for all the buffer lists and print the results. */
+        printf("1x%lu byte buffer: reference %lu, engine %lu\r\n", (unsigned long)BENCH_SINGLE_SIZE, (unsigned long)net_csum_bench_run(single, &net_csum_bench_reference), (unsigned long)net_csum_bench_run(single, &net_csum_calculate));
+        printf("%lux%lu byte buffers: reference %lu, engine %lu\r\n", (unsigned long)BENCH_MEDIUM_NUM, (unsigned long)BENCH_MEDIUM_SIZE, (unsigned long)net_csum_bench_run(medium, &net_csum_bench_reference), (unsigned long)net_csum_bench_run(medium, &net_csum_calculate));
+        printf("%lux%lu byte buffers: reference %lu, engine %lu\r\n", (unsigned long)BENCH_SMALL_NUM, (unsigned long)BENCH_SMALL_SIZE, (unsigned long)net_csum_bench_run(small, &net_csum_bench_reference), (unsigned long)net_csum_bench_run(small, &net_csum_calculate));
+
+        /* Wait before running the benchmark again. */
+        sleep_ticks(SOFT_TICKS_PER_SEC);
+    }
+}
+
+int main(void)
+{
+    memset(&net_csum_bench_cb, 0, sizeof(TASK));
+
+    /* Initialize scheduler. */
+    scheduler_init();
+
+    /* Initialize file system. */
+    fs_init();
+
+    /* Initialize serial. */
+    serial_init();
+
+    /* Create a task for checksum benchmark. */
+    task_create(&net_csum_bench_cb, P_STR("BENCH"), net_csum_bench_stack, DEMO_STACK_SIZE, &net_csum_bench_task, (void *)(NULL), 0);
+    scheduler_task_add(&net_csum_bench_cb, 5);
+
+    /* Run scheduler. */
+    kernel_run();
+
+    return (0);
+
+}
@@ -0,0 +1,295 @@
+/*
+ * net_demux_bench.c
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+#include <stdio.h>
+#include <string.h>
+#include <fs.h>
+#include <net.h>
+#include <net_demux.h>
+#include <sll.h>
+#include <serial.h>
+
+/* This demo will populate a socket demux table with a listening socket and a
+ * number of connected sockets, as a TCP server will have, and will resolve a
+ * set of segments, once with a linear scan over the socket list and once with
+ * the socket demux table, and will print the per segment cost. Cost of
+ * resolving a segment for the same socket again, that will be served from
+ * the last resolved socket, is also printed. */
+
+/* Demo configurations. */
+#define DEMO_STACK_SIZE     1024
+#define BENCH_ITERATIONS    16
+#define BENCH_NUM_SEGMENTS  256
+#define BENCH_MAX_SOCKETS   256
+#define BENCH_SERVER_IP     0xC0A80001
+#define BENCH_SERVER_PORT   11002
+
+/* Use the hardware tick if we don't have a cycle counter. */
+#ifdef CPU_CYCLE_COUNT
+#define BENCH_TIMESTAMP()   (uint32_t)CPU_CYCLE_COUNT()
+#else
+#define BENCH_TIMESTAMP()   (uint32_t)current_hardware_tick()
+#endif /* CPU_CYCLE_COUNT */
+
+/* A benchmark socket. */
+typedef struct _bench_port BENCH_PORT;
+struct _bench_port
+{
+    /* Socket list member. */
+    BENCH_PORT      *next;
+
+    /* Socket demux node. */
+    NET_DEMUX_NODE  demux;
+
+    /* Socket address. */
+    SOCKET_ADDRESS  socket_address;
+};
+
+/* Socket search parameter. */
+typedef struct _bench_port_param
+{
+    /* Resolved socket. */
+    BENCH_PORT      *port;
+
+    /* Socket search data. */
+    SOCKET_ADDRESS  socket_address;
+} BENCH_PORT_PARAM;
+
+/* Function prototypes. */
+void net_demux_bench_task(void *);
+static void net_demux_bench_setup(uint32_t);
+static uint8_t net_demux_bench_search(void *, void *);
+static BENCH_PORT *net_demux_bench_linear(SOCKET_ADDRESS *);
+static BENCH_PORT *net_demux_bench_lookup(SOCKET_ADDRESS *);
+static uint32_t net_demux_bench_run(BENCH_PORT *(*)(SOCKET_ADDRESS *), uint8_t);
+
+/* Benchmark task stack. */
+TASK net_demux_bench_cb;
+uint8_t net_demux_bench_stack[DEMO_STACK_SIZE];
+
+/* Benchmark data. */
+static NET_DEMUX bench_demux;
+static struct _bench_port_list
+{
+    BENCH_PORT  *head;
+    BENCH_PORT  *tail;
+} bench_port_list;
+static BENCH_PORT bench_ports[BENCH_MAX_SOCKETS + 1];
+static SOCKET_ADDRESS bench_segments[BENCH_NUM_SEGMENTS];
+static uint32_t bench_seed = 0x1234567;
+
+/*
+ * net_demux_bench_setup
+ * @num_sockets: Number of connected sockets to be added.
+ * This function will populate the socket list and the socket demux table and
+ * will pick the segments to resolve.
+ */
+static void net_demux_bench_setup(uint32_t num_sockets)
+{
+    uint32_t i;
+
+    /* Clear the sockets. */
+    memset(&bench_demux, 0, sizeof(bench_demux));
+    memset(&bench_port_list, 0, sizeof(bench_port_list));
+    memset(bench_ports, 0, sizeof(bench_ports));
+
+    /* Add the listening socket. */
+    bench_ports[0].socket_address.local_port = BENCH_SERVER_PORT;
+
+    /* Add the connected sockets for clients in 192.168.0.0/16. */
+    for (i = 1; i <= num_sockets; i++)
+    {
+        bench_seed = (bench_seed * 1103515245) + 12345;
+        bench_ports[i].socket_address.local_ip = BENCH_SERVER_IP;
+        bench_ports[i].socket_address.foreign_ip = (BENCH_SERVER_IP + 1 + (i & 0xFF));
+        bench_ports[i].socket_address.local_port = BENCH_SERVER_PORT;
+        bench_ports[i].socket_address.foreign_port = (uint16_t)(49152 + ((bench_seed >> 16) & 0x3FFF));
+    }
+
+    /* Register all the sockets. */
+    for (i = 0; i <= num_sockets; i++)
+    {
+        sll_append(&bench_port_list, &bench_ports[i], OFFSETOF(BENCH_PORT, next));
+        net_demux_add(&bench_demux, &bench_ports[i].demux, &bench_ports[i], &bench_ports[i].socket_address);
+    }
+
+    /* Pick the segments, one in sixteen is a new connection request. */
+    for (i = 0; i < BENCH_NUM_SEGMENTS; i++)
+    {
+        bench_seed = (bench_seed * 1103515245) + 12345;
+        memcpy(&bench_segments[i], &bench_ports[1 + ((bench_seed >> 16) % num_sockets)].socket_address, sizeof(SOCKET_ADDRESS));
+
+        /* If this is a new connection request. */
+        if ((i & 0xF) == 0xF)
+        {
+            bench_segments[i].foreign_port = 1024;
+        }
+    }
+
+} /* net_demux_bench_setup */
+
+/*
+ * net_demux_bench_search
+ * @node: A socket in the list.
+ * @param: Socket search parameter.
+ * @return: Will return true if we matched an exact socket.
+ * This function is a search callback to find a socket, this is same as the
+ * one used by the protocols before the socket demux table.
+ */
+static uint8_t net_demux_bench_search(void *node, void *param)
+{
+    BENCH_PORT_PARAM *port_param = (BENCH_PORT_PARAM *)param;
+    BENCH_PORT *port = (BENCH_PORT *)node;
+    uint8_t match;
+
+    /* Match two socket addresses. */
+    match = net_socket_address_match(&port->socket_address, &port_param->socket_address);
+
+    /* If we did not fail completely. */
+    if (match != FALSE)
+    {
+        /* Save this port. */
+        port_param->port = port;
+    }
+
+    /* If this was a partial match. */
+    if (match == PARTIAL)
+    {
+        /* SLL don't understand partial yet. */
+        match = FALSE;
+    }
+
+    /* Return if this is required port. */
+    return (match);
+
+} /* net_demux_bench_search */
+
+/*
+ * net_demux_bench_linear
+ * @socket_address: Socket address of the segment.
+ * @return: Returns the socket for this segment.
+ * This function will resolve a segment by scanning the socket list.
+ */
+static BENCH_PORT *net_demux_bench_linear(SOCKET_ADDRESS *socket_address)
+{
+    BENCH_PORT_PARAM port_param;
+
+    /* Initialize search parameter. */
+    memcpy(&port_param.socket_address, socket_address, sizeof(SOCKET_ADDRESS));
+    port_param.port = NULL;
+
+    /* Search for a socket that can be used to receive this segment. */
+    sll_search(&bench_port_list, NULL, &net_demux_bench_search, &port_param, OFFSETOF(BENCH_PORT, next));
+
+    /* Return the resolved socket. */
+    return (port_param.port);
+
+} /* net_demux_bench_linear */
+
+/*
+ * net_demux_bench_lookup
+ * @socket_address: Socket address of the segment.
+ * @return: Returns the socket for this segment.
+ * This function will resolve a segment using the socket demux table.
+ */
+static BENCH_PORT *net_demux_bench_lookup(SOCKET_ADDRESS *socket_address)
+{
+    /* Search the socket demux table. */
+    return ((BENCH_PORT *)net_demux_search(&bench_demux, socket_address));
+
+} /* net_demux_bench_lookup */
+
+/*
+ * net_demux_bench_run
+ * @lookup: Lookup function to be used.
+ * @repeat: If we need to resolve the same segment again.
+ * @return: Returns the average cost of resolving a segment.
+ * This function will resolve the segments using the given function.
+ */
+static uint32_t net_demux_bench_run(BENCH_PORT *(*lookup)(SOCKET_ADDRESS *), uint8_t repeat)
+{
+    uint32_t i, j, start;
+    BENCH_PORT * volatile port;
+
+    start = BENCH_TIMESTAMP();
+
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        for (j = 0; j < BENCH_NUM_SEGMENTS; j++)
+        {
+            /* Resolve this segment. */
+            port = lookup(&bench_segments[(repeat == TRUE) ? 0 : j]);
+        }
+    }
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(port);
+
+    /* Return the per segment cost. */
+    return ((BENCH_TIMESTAMP() - start) / (BENCH_ITERATIONS * BENCH_NUM_SEGMENTS));
+
+} /* net_demux_bench_run */
+
+void net_demux_bench_task(void *argv)
+{
+    static const uint32_t num_sockets[] = {1, 16, 64, BENCH_MAX_SOCKETS};
+    uint32_t i, j;
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(argv);
+
+    for (;;)
+    {
+        for (i = 0; i < (sizeof(num_sockets) / sizeof(uint32_t)); i++)
+        {
+            /* Populate the sockets. */
+            net_demux_bench_setup(num_sockets[i]);
+
+            /* Verify the socket demux. */
+            for (j = 0; j < BENCH_NUM_SEGMENTS; j++)
+            {
+                ASSERT(net_demux_bench_lookup(&bench_segments[j]) != net_demux_bench_linear(&bench_segments[j]));
+            }
+
+            /* Run the benchmark and print the results. */
+            printf("%lu sockets: linear %lu, hashed %lu, last hit %lu\r\n", (unsigned long)num_sockets[i], (unsigned long)net_demux_bench_run(&net_demux_bench_linear, FALSE), (unsigned long)net_demux_bench_run(&net_demux_bench_lookup, FALSE), (unsigned long)net_demux_bench_run(&net_demux_bench_lookup, TRUE));
+        }
+
+        /* Wait before running the benchmark again. */
+        sleep_ticks(SOFT_TICKS_PER_SEC);
+    }
+}
+
+int main(void)
+{
+    memset(&net_demux_bench_cb, 0, sizeof(TASK));
+
+    /* Initialize scheduler. */
+    scheduler_init();
+
+    /* Initialize file system. */
+    fs_init();
+
+    /* Initialize serial. */
+    serial_init();
+
+    /* Create a task for socket demux benchmark. */
+    task_create(&net_demux_bench_cb, P_STR("BENCH"), net_demux_bench_stack, DEMO_STACK_SIZE, &net_demux_bench_task, (void *)(NULL), 0);
+    scheduler_task_add(&net_demux_bench_cb, 5);
+
+    /* Run scheduler. */
+    kernel_run();
+
+    return (0);
+
+}
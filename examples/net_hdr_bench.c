@@ -0,0 +1,298 @@
+/*
+ * net_hdr_bench.c
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+#include <stdio.h>
+#include <string.h>
+#include <fs.h>
+#include <net.h>
+#include <ethernet.h>
+#include <net_ipv4.h>
+#include <net_tcp.h>
+#include <serial.h>
+
+/* This demo will parse the Ethernet, IPv4 and TCP headers of a synthesized
+ * frame, once by pulling each field from the buffer list and once by peeking
+ * the contiguous headers, and will print the per packet cost. Frame is parsed
+ * both from a chain of small buffers, where the headers will straddle buffer
+ * boundaries, and from a single large buffer. */
+
+/* Demo configurations. */
+#define DEMO_STACK_SIZE     1024
+#define BENCH_ITERATIONS    1000
+#define BENCH_SMALL_SIZE    16
+#define BENCH_SMALL_NUM     8
+#define BENCH_LARGE_SIZE    128
+#define BENCH_LARGE_NUM     1
+#define BENCH_FRAME_SIZE    (ETH_HRD_SIZE + IPV4_HDR_SIZE + TCP_HRD_SIZE)
+
+/* Use the hardware tick if we don't have a cycle counter. */
+#ifdef CPU_CYCLE_COUNT
+#define BENCH_TIMESTAMP()   (uint32_t)CPU_CYCLE_COUNT()
+#else
+#define BENCH_TIMESTAMP()   (uint32_t)current_hardware_tick()
+#endif /* CPU_CYCLE_COUNT */
+
+/* Parsed header fields. */
+typedef struct _bench_hdr
+{
+    uint32_t    ip_src;
+    uint32_t    ip_dst;
+    uint32_t    seq;
+    uint32_t    ack;
+    uint16_t    eth_type;
+    uint16_t    ip_length;
+    uint16_t    ip_flag_frag;
+    uint16_t    src_port;
+    uint16_t    dst_port;
+    uint16_t    tcp_flags;
+    uint16_t    wnd;
+    uint8_t     eth_dst[ETH_ADDR_LEN];
+    uint8_t     ver_ihl;
+    uint8_t     proto;
+} BENCH_HDR;
+
+/* Buffer file descriptor used for the benchmark. */
+typedef struct _bench_fd
+{
+    FS              fs;
+    FS_BUFFER_DATA  buffer_data;
+    FS_BUFFER_LIST  list;
+} BENCH_FD;
+
+/* Function prototypes. */
+void net_hdr_bench_task(void *);
+static FS_BUFFER_LIST *net_hdr_bench_setup(BENCH_FD *, FS_BUFFER *, uint8_t *, uint32_t, uint32_t);
+static void net_hdr_bench_pull(FS_BUFFER_LIST *, BENCH_HDR *);
+static void net_hdr_bench_peek(FS_BUFFER_LIST *, BENCH_HDR *);
+static uint32_t net_hdr_bench_run(FS_BUFFER_LIST *, void (*)(FS_BUFFER_LIST *, BENCH_HDR *), BENCH_HDR *);
+
+/* Benchmark task stack. */
+TASK net_hdr_bench_cb;
+uint8_t net_hdr_bench_stack[DEMO_STACK_SIZE];
+
+/* Benchmark buffer data. */
+BENCH_FD bench_small_fd, bench_large_fd;
+FS_BUFFER bench_small_buffers[BENCH_SMALL_NUM];
+FS_BUFFER bench_large_buffers[BENCH_LARGE_NUM];
+uint8_t bench_small_space[BENCH_SMALL_SIZE * BENCH_SMALL_NUM];
+uint8_t bench_large_space[BENCH_LARGE_SIZE * BENCH_LARGE_NUM];
+
+/* Synthesized TCP SYN frame. */
+static const uint8_t bench_frame[BENCH_FRAME_SIZE] =
+{
+    /* Ethernet header. */
+    0x02, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x00, 0x00, 0x00, 0x00, 0x02, 0x08, 0x00,
+
+    /* IPv4 header. */
+    0x45, 0x00, 0x00, 0x28, 0x12, 0x34, 0x40, 0x00, 0x40, 0x06, 0x00, 0x00,
+    0xC0, 0xA8, 0x00, 0x02, 0xC0, 0xA8, 0x00, 0x01,
+
+    /* TCP header. */
+    0xD4, 0x31, 0x2A, 0xFA, 0x01, 0x02, 0x03, 0x04, 0x00, 0x00, 0x00, 0x00,
+    0x50, 0x02, 0x72, 0x10, 0x00, 0x00, 0x00, 0x00,
+};
+
+/*
+ * net_hdr_bench_setup
+ * @bench_fd: Benchmark file descriptor needed to be initialized.
+ * @buffers: Buffers to be used.
+ * @space: Buffer space to be used.
+ * @size: Size of each buffer.
+ * @num: Number of buffers.
+ * @return: Returns the buffer list with the synthesized frame.
+ * This function will initialize a buffer file descriptor and push the
+ * synthesized frame on a buffer list.
+ */
+static FS_BUFFER_LIST *net_hdr_bench_setup(BENCH_FD *bench_fd, FS_BUFFER *buffers, uint8_t *space, uint32_t size, uint32_t num)
+{
+    FD fd = (FD)&bench_fd->fs;
+    FS_BUFFER_LIST *buffer;
+
+    /* Clear the file descriptor. */
+    memset(bench_fd, 0, sizeof(BENCH_FD));
+
+    /* Set buffer data for our file descriptor. */
+    bench_fd->buffer_data.buffer_space = space;
+    bench_fd->buffer_data.buffer_size = size;
+    bench_fd->buffer_data.buffers = buffers;
+    bench_fd->buffer_data.num_buffers = num;
+    bench_fd->buffer_data.buffer_lists = &bench_fd->list;
+    bench_fd->buffer_data.num_buffer_lists = 1;
+    fs_buffer_dataset(fd, &bench_fd->buffer_data);
+
+    /* Pull a buffer list and push the frame on it. */
+    buffer = fs_buffer_get(fd, FS_LIST_FREE, 0);
+    ASSERT(buffer == NULL);
+    ASSERT(fs_buffer_list_push(buffer, (uint8_t *)bench_frame, BENCH_FRAME_SIZE, 0) != SUCCESS);
+
+    /* Return the buffer list. */
+    return (buffer);
+
+} /* net_hdr_bench_setup */
+
+/*
+ * net_hdr_bench_pull
+ * @buffer: Buffer list to be parsed.
+ * @hdr: Parsed header fields will be returned here.
+ * This function will parse the headers by pulling each field in place.
+ */
+static void net_hdr_bench_pull(FS_BUFFER_LIST *buffer, BENCH_HDR *hdr)
+{
+    uint32_t ihl;
+
+    /* Pull the ethernet header fields. */
+    ASSERT(fs_buffer_list_pull_offset(buffer, hdr->eth_dst, ETH_ADDR_LEN, ETH_HDR_DST_OFFSET, FS_BUFFER_INPLACE) != SUCCESS);
+    ASSERT(fs_buffer_list_pull_offset(buffer, &hdr->eth_type, 2, ETH_HDR_TYPE_OFFSET, (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
+
+    /* Pull the IPv4 header fields. */
+    ASSERT(fs_buffer_list_pull_offset(buffer, &hdr->ver_ihl, 1, (ETH_HRD_SIZE + IPV4_HDR_VER_IHL_OFFSET), FS_BUFFER_INPLACE) != SUCCESS);
+    ASSERT(fs_buffer_list_pull_offset(buffer, &hdr->ip_flag_frag, 2, (ETH_HRD_SIZE + IPV4_HDR_FLAG_FRAG_OFFSET), (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
+    ASSERT(fs_buffer_list_pull_offset(buffer, &hdr->ip_dst, 4, (ETH_HRD_SIZE + IPV4_HDR_DST_OFFSET), (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
+    ASSERT(fs_buffer_list_pull_offset(buffer, &hdr->ip_length, 2, (ETH_HRD_SIZE + IPV4_HDR_LENGTH_OFFSET), (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
+    ASSERT(fs_buffer_list_pull_offset(buffer, &hdr->proto, 1, (ETH_HRD_SIZE + IPV4_HDR_PROTO_OFFSET), FS_BUFFER_INPLACE) != SUCCESS);
+    ASSERT(fs_buffer_list_pull_offset(buffer, &hdr->ip_src, 4, (ETH_HRD_SIZE + IPV4_HDR_SRC_OFFSET), (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
+    ihl = (uint32_t)(ETH_HRD_SIZE + ((hdr->ver_ihl & IPV4_HDR_IHL_MASK) << 2));
+
+    /* Pull the TCP header fields. */
+    ASSERT(fs_buffer_list_pull_offset(buffer, &hdr->src_port, 2, (ihl + TCP_HRD_SRC_PORT_OFFSET), (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
+    ASSERT(fs_buffer_list_pull_offset(buffer, &hdr->dst_port, 2, (ihl + TCP_HRD_DST_PORT_OFFSET), (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
+    ASSERT(fs_buffer_list_pull_offset(buffer, &hdr->ack, 4, (ihl + TCP_HRD_ACK_NUM_OFFSET), (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
+    ASSERT(fs_buffer_list_pull_offset(buffer, &hdr->seq, 4, (ihl + TCP_HRD_SEQ_NUM_OFFSET), (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
+    ASSERT(fs_buffer_list_pull_offset(buffer, &hdr->tcp_flags, 2, (ihl + TCP_HRD_FLAGS_OFFSET), (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
+    ASSERT(fs_buffer_list_pull_offset(buffer, &hdr->wnd, 2, (ihl + TCP_HRD_WND_SIZE_OFFSET), (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
+
+} /* net_hdr_bench_pull */
+
+/*
+ * net_hdr_bench_peek
+ * @buffer: Buffer list to be parsed.
+ * @hdr: Parsed header fields will be returned here.
+ * This function will parse the headers by peeking the contiguous headers.
+ */
+static void net_hdr_bench_peek(FS_BUFFER_LIST *buffer, BENCH_HDR *hdr)
+{
+    uint8_t hdr_buf[TCP_HRD_SIZE], *p;
+    uint32_t ihl;
+
+    /* Peek the ethernet header. */
+    p = fs_buffer_list_peek(buffer, hdr_buf, ETH_HRD_SIZE, 0);
+    ASSERT(p == NULL);
+    memcpy(hdr->eth_dst, ETH_HDR_DST(p), ETH_ADDR_LEN);
+    hdr->eth_type = ETH_HDR_TYPE(p);
+
+    /* Peek the IPv4 header. */
+    p = fs_buffer_list_peek(buffer, hdr_buf, IPV4_HDR_SIZE, ETH_HRD_SIZE);
+    ASSERT(p == NULL);
+    hdr->ver_ihl = IPV4_HDR_VER_IHL(p);
+    hdr->ip_flag_frag = IPV4_HDR_FLAG_FRAG(p);
+    hdr->ip_dst = IPV4_HDR_DST(p);
+    hdr->ip_length = IPV4_HDR_LENGTH(p);
+    hdr->proto = IPV4_HDR_PROTO(p);
+    hdr->ip_src = IPV4_HDR_SRC(p);
+    ihl = (uint32_t)(ETH_HRD_SIZE + ((hdr->ver_ihl & IPV4_HDR_IHL_MASK) << 2));
+
+    /* Peek the TCP header. */
+    p = fs_buffer_list_peek(buffer, hdr_buf, TCP_HRD_SIZE, ihl);
+    ASSERT(p == NULL);
+    hdr->src_port = TCP_HRD_SRC_PORT(p);
+    hdr->dst_port = TCP_HRD_DST_PORT(p);
+    hdr->ack = TCP_HRD_ACK_NUM(p);
+    hdr->seq = TCP_HRD_SEQ_NUM(p);
+    hdr->tcp_flags = TCP_HRD_FLAGS(p);
+    hdr->wnd = TCP_HRD_WND_SIZE(p);
+
+} /* net_hdr_bench_peek */
+
+/*
+ * net_hdr_bench_run
+ * @buffer: Buffer list to be parsed.
+ * @parse: Parser to be used.
+ * @hdr: Parsed header fields will be returned here.
+ * @return: Returns the average cost of parsing a packet.
+ * This function will run a parser on the given buffer list.
+ */
+static uint32_t net_hdr_bench_run(FS_BUFFER_LIST *buffer, void (*parse)(FS_BUFFER_LIST *, BENCH_HDR *), BENCH_HDR *hdr)
+{
+    uint32_t i, start;
+
+    start = BENCH_TIMESTAMP();
+
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        /* Parse the headers. */
+        parse(buffer, hdr);
+    }
+
+    /* Return the per packet cost. */
+    return ((BENCH_TIMESTAMP() - start) / BENCH_ITERATIONS);
+
+} /* net_hdr_bench_run */
+
+void net_hdr_bench_task(void *argv)
+{
+    FS_BUFFER_LIST *small, *large;
+    BENCH_HDR pull_hdr, peek_hdr;
+    uint32_t small_pull, small_peek, large_pull, large_peek;
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(argv);
+
+    /* Setup the buffer lists. */
+    small = net_hdr_bench_setup(&bench_small_fd, bench_small_buffers, bench_small_space, BENCH_SMALL_SIZE, BENCH_SMALL_NUM);
+    large = net_hdr_bench_setup(&bench_large_fd, bench_large_buffers, bench_large_space, BENCH_LARGE_SIZE, BENCH_LARGE_NUM);
+
+    for (;;)
+    {
+        memset(&pull_hdr, 0, sizeof(BENCH_HDR));
+        memset(&peek_hdr, 0, sizeof(BENCH_HDR));
+
+        /* Run the benchmark for both the buffer lists. */
+        small_pull = net_hdr_bench_run(small, &net_hdr_bench_pull, &pull_hdr);
+        small_peek = net_hdr_bench_run(small, &net_hdr_bench_peek, &peek_hdr);
+        ASSERT(memcmp(&pull_hdr, &peek_hdr, sizeof(BENCH_HDR)) != 0);
+        large_pull = net_hdr_bench_run(large, &net_hdr_bench_pull, &pull_hdr);
+        large_peek = net_hdr_bench_run(large, &net_hdr_bench_peek, &peek_hdr);
+        ASSERT(memcmp(&pull_hdr, &peek_hdr, sizeof(BENCH_HDR)) != 0);
+
+        /* Print the results. */
+        printf("%lu byte buffers: pull %lu, peek %lu\r\n", (unsigned long)BENCH_SMALL_SIZE, (unsigned long)small_pull, (unsigned long)small_peek);
+        printf("%lu byte buffers: pull %lu, peek %lu\r\n", (unsigned long)BENCH_LARGE_SIZE, (unsigned long)large_pull, (unsigned long)large_peek);
+
+        /* Wait before running the benchmark again. */
+        sleep_ticks(SOFT_TICKS_PER_SEC);
+    }
+}
+
+int main(void)
+{
+    memset(&net_hdr_bench_cb, 0, sizeof(TASK));
+
+    /* Initialize scheduler. */
+    scheduler_init();
+
+    /* Initialize file system. */
+    fs_init();
+
+    /* Initialize serial. */
+    serial_init();
+
+    /* Create a task for header parsing benchmark. */
+    task_create(&net_hdr_bench_cb, P_STR("BENCH"), net_hdr_bench_stack, DEMO_STACK_SIZE, &net_hdr_bench_task, (void *)(NULL), 0);
+    scheduler_task_add(&net_hdr_bench_cb, 5);
+
+    /* Run scheduler. */
+    kernel_run();
+
+    return (0);
+
+}
@@ -0,0 +1,287 @@
+/*
+ * net_route_bench.c
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+#include <stdio.h>
+#include <string.h>
+#include <fs.h>
+#include <net.h>
+#include <net_route.h>
+#include <serial.h>
+
+/* This demo will populate the route database with a default route and a
+ * number of random prefixes and will look up a set of destinations, once with
+ * a linear scan over the routes and once with route_get, and will print the
+ * per lookup cost. Cost of looking up the same destination again, that will
+ * be served from the route cache, is also printed. Results of route_get are
+ * verified against the linear scan before running the benchmark. */
+
+/* Demo configurations. */
+#define DEMO_STACK_SIZE     1024
+#define BENCH_ITERATIONS    16
+#define BENCH_NUM_DST       256
+#define BENCH_MAX_ROUTES    512
+
+/* Use the hardware tick if we don't have a cycle counter. */
+#ifdef CPU_CYCLE_COUNT
+#define BENCH_TIMESTAMP()   (uint32_t)CPU_CYCLE_COUNT()
+#else
+#define BENCH_TIMESTAMP()   (uint32_t)current_hardware_tick()
+#endif /* CPU_CYCLE_COUNT */
+
+/* A reference route entry. */
+typedef struct _bench_route
+{
+    uint32_t    gateway;
+    uint32_t    destination;
+    uint32_t    subnet;
+} BENCH_ROUTE;
+
+/* Function prototypes. */
+void net_route_bench_task(void *);
+static uint32_t net_route_bench_random(void);
+static void net_route_bench_setup(uint32_t);
+static uint32_t net_route_bench_linear(uint32_t);
+static uint32_t net_route_bench_lookup(uint32_t);
+static uint32_t net_route_bench_run(uint32_t (*)(uint32_t), uint8_t);
+
+/* Benchmark task stack. */
+TASK net_route_bench_cb;
+uint8_t net_route_bench_stack[DEMO_STACK_SIZE];
+
+/* Benchmark data. */
+static FS bench_device;
+static BENCH_ROUTE bench_routes[BENCH_MAX_ROUTES];
+static uint32_t bench_num_routes;
+static uint32_t bench_dst[BENCH_NUM_DST];
+static uint32_t bench_seed = 0x1234567;
+
+/* Prefix lengths to be used for the routes. */
+static const uint8_t bench_prefixes[] = {24, 16, 28, 32, 20, 8};
+
+/*
+ * net_route_bench_random
+ * @return: Returns a pseudo random number.
+ * This function will return a pseudo random number.
+ */
+static uint32_t net_route_bench_random(void)
+{
+    /* Update the seed. */
+    bench_seed = (bench_seed * 1103515245) + 12345;
+
+    /* Return the random number. */
+    return ((bench_seed >> 16) | (bench_seed << 16));
+
+} /* net_route_bench_random */
+
+/*
+ * net_route_bench_setup
+ * @num_routes: Number of routes to be added.
+ * This function will populate the route database and the reference routes
+ * and will pick the destinations to look up.
+ */
+static void net_route_bench_setup(uint32_t num_routes)
+{
+    uint32_t i, subnet, destination;
+
+    /* Remove all the routes. */
+    route_remove(0x0, 0x0, 0x0);
+
+    /* Add the default route. */
+    bench_routes[0].gateway = 1;
+    bench_routes[0].destination = 0x0;
+    bench_routes[0].subnet = 0x0;
+    ASSERT(route_add((FD)&bench_device, 0xC0A80001, 1, 0x0, 0x0, 0) != SUCCESS);
+
+    /* Add the random prefixes. */
+    for (i = 1; i < num_routes; i++)
+    {
+        subnet = ROUTE_PREFIX_MASK(bench_prefixes[i % sizeof(bench_prefixes)]);
+        destination = (net_route_bench_random() & subnet);
+
+        bench_routes[i].gateway = (i + 1);
+        bench_routes[i].destination = destination;
+        bench_routes[i].subnet = subnet;
+        ASSERT(route_add((FD)&bench_device, 0xC0A80001, (i + 1), destination, subnet, 0) != SUCCESS);
+    }
+    bench_num_routes = num_routes;
+
+    /* Pick destinations, half of them lie in one of the prefixes. */
+    for (i = 0; i < BENCH_NUM_DST; i++)
+    {
+        if (i & 0x1)
+        {
+            /* Pick a random destination. */
+            bench_dst[i] = net_route_bench_random();
+        }
+        else
+        {
+            /* Pick a random host in one of the prefixes. */
+            destination = (net_route_bench_random() % num_routes);
+            bench_dst[i] = (bench_routes[destination].destination | (net_route_bench_random() & ~bench_routes[destination].subnet));
+        }
+    }
+
+} /* net_route_bench_setup */
+
+/*
+ * net_route_bench_linear
+ * @destination: Destination address for which a route is required.
+ * @return: Returns the gateway for the destination.
+ * This function will find a route by scanning all the reference routes.
+ */
+static uint32_t net_route_bench_linear(uint32_t destination)
+{
+    int32_t i, route = -1, default_route = -1;
+    uint32_t this_match, match = 0;
+
+    /* Traverse the route list. */
+    for (i = 0; i < (int32_t)bench_num_routes; i++)
+    {
+        /* If this is a default gateway. */
+        if (bench_routes[i].subnet == 0x0)
+        {
+            /* Save the default route. */
+            default_route = i;
+        }
+
+        /* If we can use this route. */
+        else if ((destination & bench_routes[i].subnet) == (bench_routes[i].destination & bench_routes[i].subnet))
+        {
+            /* Match the route. */
+            this_match = destination & bench_routes[i].subnet;
+
+            /* If this is route is more accurate. */
+            if ((this_match != 0) && ((this_match > match) || ((this_match == match) && (bench_routes[i].subnet > bench_routes[route].subnet))))
+            {
+                /* This is more accurate route. */
+                route = i;
+                match = this_match;
+            }
+        }
+    }
+
+    /* If we don't have a specific route. */
+    if (route < 0)
+    {
+        /* Use the default route. */
+        route = default_route;
+    }
+
+    /* Return the gateway. */
+    return (bench_routes[route].gateway);
+
+} /* net_route_bench_linear */
+
+/*
+ * net_route_bench_lookup
+ * @destination: Destination address for which a route is required.
+ * @return: Returns the gateway for the destination.
+ * This function will find a route using the route database.
+ */
+static uint32_t net_route_bench_lookup(uint32_t destination)
+{
+    FD fd = NULL;
+    uint32_t gateway = 0;
+
+    /* Get the route for this destination. */
+    ASSERT(route_get(&fd, destination, NULL, &gateway, NULL) != SUCCESS);
+
+    /* Return the gateway. */
+    return (gateway);
+
+} /* net_route_bench_lookup */
+
+/*
+ * net_route_bench_run
+ * @lookup: Lookup function to be used.
+ * @repeat: If we need to look up the same destination again.
+ * @return: Returns the average cost of a lookup.
+ * This function will look up the destinations using the given function.
+ */
+static uint32_t net_route_bench_run(uint32_t (*lookup)(uint32_t), uint8_t repeat)
+{
+    uint32_t i, j, start;
+    volatile uint32_t gateway;
+
+    start = BENCH_TIMESTAMP();
+
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        for (j = 0; j < BENCH_NUM_DST; j++)
+        {
+            /* Look up this destination. */
+            gateway = lookup(bench_dst[(repeat == TRUE) ? 0 : j]);
+        }
+    }
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(gateway);
+
+    /* Return the per lookup cost. */
+    return ((BENCH_TIMESTAMP() - start) / (BENCH_ITERATIONS * BENCH_NUM_DST));
+
+} /* net_route_bench_run */
+
+void net_route_bench_task(void *argv)
+{
+    static const uint32_t num_routes[] = {4, 64, BENCH_MAX_ROUTES};
+    uint32_t i, j;
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(argv);
+
+    for (;;)
+    {
+        for (i = 0; i < (sizeof(num_routes) / sizeof(uint32_t)); i++)
+        {
+            /* Populate the routes. */
+            net_route_bench_setup(num_routes[i]);
+
+            /* Verify the route lookup. */
+            for (j = 0; j < BENCH_NUM_DST; j++)
+            {
+                ASSERT(net_route_bench_lookup(bench_dst[j]) != net_route_bench_linear(bench_dst[j]));
+            }
+
+            /* Run the benchmark and print the results. */
+            printf("%lu routes: linear %lu, lookup %lu, cached %lu\r\n", (unsigned long)num_routes[i], (unsigned long)net_route_bench_run(&net_route_bench_linear, FALSE), (unsigned long)net_route_bench_run(&net_route_bench_lookup, FALSE), (unsigned long)net_route_bench_run(&net_route_bench_lookup, TRUE));
+        }
+
+        /* Wait before running the benchmark again. */
+        sleep_ticks(SOFT_TICKS_PER_SEC);
+    }
+}
+
+int main(void)
+{
+    memset(&net_route_bench_cb, 0, sizeof(TASK));
+
+    /* Initialize scheduler. */
+    scheduler_init();
+
+    /* Initialize file system. */
+    fs_init();
+
+    /* Initialize serial. */
+    serial_init();
+
+    /* Create a task for route lookup benchmark. */
+    task_create(&net_route_bench_cb, P_STR("BENCH"), net_route_bench_stack, DEMO_STACK_SIZE, &net_route_bench_task, (void *)(NULL), 0);
+    scheduler_task_add(&net_route_bench_cb, 5);
+
+    /* Run scheduler. */
+    kernel_run();
+
+    return (0);
+
+}
@@ -0,0 +1,396 @@
+/*
+ * ppp_fcs_bench.c
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+#include <stdio.h>
+#include <string.h>
+#include <fs.h>
+#include <ppp.h>
+#include <serial.h>
+
+/* This demo will calculate the FCS of a synthesized payload, once with the bit
+ * at a time reference implementation and once with the FCS engine, and will
+ * print the per frame and per byte cost of both. 16-bit FCS is calculated with
+ * the configured number of bytes in each slice (PPP_FCS16_SLICE), build with
+ * 1, 4 and 8 to see what each step of flash buys. If enabled 32-bit FCS is
+ * also calculated for a payload pushed on a buffer chain, this will use the
+ * target CRC unit if there is one. Results of both the implementations are
+ * verified for a number of offsets and lengths before running the benchmark. */
+
+/* Demo configurations. */
+#define DEMO_STACK_SIZE     1024
+#define BENCH_ITERATIONS    200
+#define BENCH_PAYLOAD_SIZE  1500
+#define BENCH_BUFFER_SIZE   128
+#define BENCH_NUM_BUFFERS   16
+
+/* Use the hardware tick if we don't have a cycle counter. */
+#ifdef CPU_CYCLE_COUNT
+#define BENCH_TIMESTAMP()   (uint32_t)CPU_CYCLE_COUNT()
+#else
+#define BENCH_TIMESTAMP()   (uint32_t)current_hardware_tick()
+#endif /* CPU_CYCLE_COUNT */
+
+/* Buffer file descriptor used for the benchmark. */
+typedef struct _bench_fd
+{
+    FS              fs;
+    FS_BUFFER_DATA  buffer_data;
+    FS_BUFFER_LIST  list;
+} BENCH_FD;
+
+/* Function prototypes. */
+void ppp_fcs_bench_task(void *);
+static uint16_t ppp_fcs_bench_reference16(uint8_t *, uint32_t, uint16_t);
+static void ppp_fcs_bench_verify16(void);
+static uint32_t ppp_fcs_bench_run16(uint8_t);
+#ifdef PPP_FCS32
+static uint32_t ppp_fcs_bench_reference32(uint8_t *, uint32_t, uint32_t);
+static FS_BUFFER_LIST *ppp_fcs_bench_list(uint32_t, uint32_t);
+static void ppp_fcs_bench_verify32(void);
+static uint32_t ppp_fcs_bench_run32(FS_BUFFER_LIST *, uint8_t);
+#endif /* PPP_FCS32 */
+static void ppp_fcs_bench_print(char *, uint32_t, uint32_t);
+
+/* Benchmark task stack. */
+TASK ppp_fcs_bench_cb;
+uint8_t ppp_fcs_bench_stack[DEMO_STACK_SIZE];
+
+#ifdef PPP_FCS32
+/* Benchmark buffer data. */
+BENCH_FD bench_fd;
+FS_BUFFER bench_buffers[BENCH_NUM_BUFFERS];
+uint8_t bench_space[BENCH_BUFFER_SIZE * BENCH_NUM_BUFFERS];
+#endif /* PPP_FCS32 */
+
+/* Synthesized payload and copy destination. */
+static uint8_t bench_payload[BENCH_PAYLOAD_SIZE];
+static uint8_t bench_copy[BENCH_PAYLOAD_SIZE];
+
+/*
+ * ppp_fcs_bench_reference16
+ * @data: Data for which 16-bit FCS is needed to be calculated.
+ * @length: Number of bytes provided in the data.
+ * @fcs: Previous FCS value.
+ * @return: Calculated FCS value.
+ * This function is the bit at a time 16-bit FCS implementation used as the
+ * reference for the FCS engine.
+ */
+static uint16_t ppp_fcs_bench_reference16(uint8_t *data, uint32_t length, uint16_t fcs)
+{
+    uint8_t bit;
+
+    /* While we have some data. */
+    while (length--)
+    {
+        fcs ^= *(data++);
+
+        /* Process all the bits in this byte. */
+        for (bit = 0; bit < 8; bit++)
+        {
+            fcs = (uint16_t)((fcs & 0x1) ? ((fcs >> 1) ^ 0x8408) : (fcs >> 1));
+        }
+    }
+
+    /* Return the calculated FCS. */
+    return (fcs);
+
+} /* ppp_fcs_bench_reference16 */
+
+/*
+ * ppp_fcs_bench_verify16
+ * This function will verify the 16-bit FCS engine against the reference
+ * implementation for different offsets and lengths.
+ */
+static void ppp_fcs_bench_verify16(void)
+{
+    uint32_t offset, length;
+
+    /* Verify all the offsets with some odd and even lengths. */
+    for (offset = 0; offset < 16; offset++)
+    {
+        for (length = 0; length < (BENCH_PAYLOAD_SIZE - offset); length += 37)
+        {
+            /* Verify the FCS. */
+            ASSERT(ppp_fcs16_calculate(&bench_payload[offset], length, PPP_FCS16_INIT) != ppp_fcs_bench_reference16(&bench_payload[offset], length, PPP_FCS16_INIT));
+
+            /* Verify the FCS with copy and the copied data. */
+            memset(bench_copy, 0, BENCH_PAYLOAD_SIZE);
+            ASSERT(ppp_fcs16_copy(bench_copy, &bench_payload[offset], length, PPP_FCS16_INIT) != ppp_fcs_bench_reference16(&bench_payload[offset], length, PPP_FCS16_INIT));
+            ASSERT(memcmp(bench_copy, &bench_payload[offset], length) != 0);
+        }
+    }
+
+} /* ppp_fcs_bench_verify16 */
+
+/*
+ * ppp_fcs_bench_run16
+ * @reference: If we need to run the reference implementation.
+ * @return: Returns the average cost of calculating FCS of a frame.
+ * This function will calculate the 16-bit FCS of the payload.
+ */
+static uint32_t ppp_fcs_bench_run16(uint8_t reference)
+{
+    uint32_t i, start;
+    volatile uint16_t result = 0;
+
+    start = BENCH_TIMESTAMP();
+
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        if (reference == TRUE)
+        {
+            /* Calculate FCS using the reference implementation. */
+            result = ppp_fcs_bench_reference16(bench_payload, BENCH_PAYLOAD_SIZE, PPP_FCS16_INIT);
+        }
+        else
+        {
+            /* Calculate FCS using the FCS engine. */
+            result = ppp_fcs16_calculate(bench_payload, BENCH_PAYLOAD_SIZE, PPP_FCS16_INIT);
+        }
+    }
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(result);
+
+    /* Return the per frame cost. */
+    return ((BENCH_TIMESTAMP() - start) / BENCH_ITERATIONS);
+
+} /* ppp_fcs_bench_run16 */
+
+#ifdef PPP_FCS32
+/*
+ * ppp_fcs_bench_reference32
+ * @data: Data for which 32-bit FCS is needed to be calculated.
+ * @length: Number of bytes provided in the data.
+ * @fcs: Previous FCS value.
+ * @return: Calculated FCS value.
+ * This function is the bit at a time 32-bit FCS implementation used as the
+ * reference for the FCS engine.
+ */
+static uint32_t ppp_fcs_bench_reference32(uint8_t *data, uint32_t length, uint32_t fcs)
+{
+    uint8_t bit;
+
+    /* While we have some data. */
+    while (length--)
+    {
+        fcs ^= *(data++);
+
+        /* Process all the bits in this byte. */
+        for (bit = 0; bit < 8; bit++)
+        {
+            fcs = (fcs & 0x1) ? ((fcs >> 1) ^ 0xedb88320) : (fcs >> 1);
+        }
+    }
+
+    /* Return the calculated FCS. */
+    return (fcs);
+
+} /* ppp_fcs_bench_reference32 */
+
+/*
+ * ppp_fcs_bench_list
+ * @offset: Offset in the payload from which data is needed to be pushed.
+ * @length: Number of bytes needed to be pushed.
+ * @return: Returns the buffer list with the given data.
+ * This function will pull a buffer list and push the given part of the
+ * payload on it, first few bytes are pushed separately so that the data does
+ * not start on a word boundary in the following buffers.
+ */
+static FS_BUFFER_LIST *ppp_fcs_bench_list(uint32_t offset, uint32_t length)
+{
+    FS_BUFFER_LIST *buffer;
+    uint32_t head = MIN(length, (offset % 4));
+
+    /* Pull a buffer list and push the data on it. */
+    buffer = fs_buffer_get(&bench_fd.fs, FS_LIST_FREE, 0);
+    ASSERT(buffer == NULL);
+    ASSERT(fs_buffer_list_push(buffer, &bench_payload[offset], head, 0) != SUCCESS);
+    ASSERT(fs_buffer_list_push(buffer, &bench_payload[offset + head], (length - head), 0) != SUCCESS);
+
+    /* Return the buffer list. */
+    return (buffer);
+
+} /* ppp_fcs_bench_list */
+
+/*
+ * ppp_fcs_bench_verify32
+ * This function will verify the 32-bit FCS engine against the reference
+ * implementation for different offsets and lengths.
+ */
+static void ppp_fcs_bench_verify32(void)
+{
+    FS_BUFFER_LIST *buffer;
+    uint32_t offset, length;
+
+    /* Verify all the offsets with some odd and even lengths. */
+    for (offset = 0; offset < 16; offset++)
+    {
+        for (length = 0; length < (BENCH_PAYLOAD_SIZE - offset); length += 37)
+        {
+            /* Verify the FCS. */
+            ASSERT(ppp_fcs32_calculate(&bench_payload[offset], length, PPP_FCS32_INIT) != ppp_fcs_bench_reference32(&bench_payload[offset], length, PPP_FCS32_INIT));
+
+            /* Verify the FCS for a buffer chain. */
+            buffer = ppp_fcs_bench_list(offset, length);
+            ASSERT(ppp_fcs32_buffer_calculate(buffer, PPP_FCS32_INIT) != ppp_fcs_bench_reference32(&bench_payload[offset], length, PPP_FCS32_INIT));
+            fs_buffer_add(buffer->fd, buffer, FS_LIST_FREE, FS_BUFFER_ACTIVE);
+        }
+    }
+
+} /* ppp_fcs_bench_verify32 */
+
+/*
+ * ppp_fcs_bench_run32
+ * @buffer: Buffer list for which FCS is needed.
+ * @reference: If we need to run the reference implementation.
+ * @return: Returns the average cost of calculating FCS of a frame.
+ * This function will calculate the 32-bit FCS of the given buffer list.
+ */
+static uint32_t ppp_fcs_bench_run32(FS_BUFFER_LIST *buffer, uint8_t reference)
+{
+    FS_BUFFER *one;
+    uint32_t i, start;
+    volatile uint32_t result = 0;
+
+    start = BENCH_TIMESTAMP();
+
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        if (reference == TRUE)
+        {
+            /* Calculate FCS using the reference implementation. */
+            result = PPP_FCS32_INIT;
+            for (one = buffer->list.head; one != NULL; one = one->next)
+            {
+                result = ppp_fcs_bench_reference32(one->buffer, one->length, result);
+            }
+        }
+        else
+        {
+            /* Calculate FCS using the FCS engine. */
+            result = ppp_fcs32_buffer_calculate(buffer, PPP_FCS32_INIT);
+        }
+    }
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(result);
+
+    /* Return the per frame cost. */
+    return ((BENCH_TIMESTAMP() - start) / BENCH_ITERATIONS);
+
+} /* ppp_fcs_bench_run32 */
+#endif /* PPP_FCS32 */
+
+/*
+ * ppp_fcs_bench_print
+ * @name: Name of this test.
+ * @reference: Per frame cost of the reference implementation.
+ * @engine: Per frame cost of the engine.
+ * This function will print the per frame and per byte cost of a test.
+ */
+static void ppp_fcs_bench_print(char *name, uint32_t reference, uint32_t engine)
+{
+    uint32_t reference_byte = ((reference * 100) / BENCH_PAYLOAD_SIZE);
+    uint32_t engine_byte = ((engine * 100) / BENCH_PAYLOAD_SIZE);
+
+    /* Print the results. */
+    printf("%s: reference %lu (%lu.%02lu/byte), engine %lu (%lu.%02lu/byte)\r\n", name,
+           (unsigned long)reference, (unsigned long)(reference_byte / 100), (unsigned long)(reference_byte % 100),
+           (unsigned long)engine, (unsigned long)(engine_byte / 100), (unsigned long)(engine_byte % 100));
+
+} /* ppp_fcs_bench_print */
+
+void ppp_fcs_bench_task(void *argv)
+{
+    uint32_t i, seed = 0x1234567;
+    char name[32];
+#ifdef PPP_FCS32
+    FS_BUFFER_LIST *buffer;
+#endif /* PPP_FCS32 */
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(argv);
+
+#ifdef CPU_CYCLE_COUNT_INIT
+    /* Start the cycle counter. */
+    CPU_CYCLE_COUNT_INIT();
+#endif /* CPU_CYCLE_COUNT_INIT */
+
+    /* Synthesize the payload. */
+    for (i = 0; i < BENCH_PAYLOAD_SIZE; i++)
+    {
+        seed = (seed * 1103515245) + 12345;
+        bench_payload[i] = (uint8_t)(seed >> 16);
+    }
+
+    /* Verify the 16-bit FCS engine. */
+    ppp_fcs_bench_verify16();
+    snprintf(name, sizeof(name), "FCS-16, slice by %d", PPP_FCS16_SLICE);
+
+#ifdef PPP_FCS32
+    /* Clear the file descriptor. */
+    memset(&bench_fd, 0, sizeof(BENCH_FD));
+
+    /* Set buffer data for our file descriptor. */
+    bench_fd.buffer_data.buffer_space = bench_space;
+    bench_fd.buffer_data.buffer_size = BENCH_BUFFER_SIZE;
+    bench_fd.buffer_data.buffers = bench_buffers;
+    bench_fd.buffer_data.num_buffers = BENCH_NUM_BUFFERS;
+    bench_fd.buffer_data.buffer_lists = &bench_fd.list;
+    bench_fd.buffer_data.num_buffer_lists = 1;
+    fs_buffer_dataset(&bench_fd.fs, &bench_fd.buffer_data);
+
+    /* Verify the 32-bit FCS engine. */
+    ppp_fcs_bench_verify32();
+
+    /* Push the payload on a buffer chain. */
+    buffer = ppp_fcs_bench_list(0, BENCH_PAYLOAD_SIZE);
+#endif /* PPP_FCS32 */
+
+    for (;;)
+    {
+        /* Run the benchmark and print the results. */
+        ppp_fcs_bench_print(name, ppp_fcs_bench_run16(TRUE), ppp_fcs_bench_run16(FALSE));
+#ifdef PPP_FCS32
+        ppp_fcs_bench_print("FCS-32", ppp_fcs_bench_run32(buffer, TRUE), ppp_fcs_bench_run32(buffer, FALSE));
+#endif /* PPP_FCS32 */
+
+        /* Wait before running the benchmark again. */
+        sleep_ticks(SOFT_TICKS_PER_SEC);
+    }
+}
+
+int main(void)
+{
+    memset(&ppp_fcs_bench_cb, 0, sizeof(TASK));
+
+    /* Initialize scheduler. */
+    scheduler_init();
+
+    /* Initialize file system. */
+    fs_init();
+
+    /* Initialize serial. */
+    serial_init();
+
+    /* Create a task for FCS benchmark. */
+    task_create(&ppp_fcs_bench_cb, P_STR("BENCH"), ppp_fcs_bench_stack, DEMO_STACK_SIZE, &ppp_fcs_bench_task, (void *)(NULL), 0);
+    scheduler_task_add(&ppp_fcs_bench_cb, 5);
+
+    /* Run scheduler. */
+    kernel_run();
+
+    return (0);
+
+}
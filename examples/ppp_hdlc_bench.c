@@ -0,0 +1,541 @@
+/*
+ * ppp_hdlc_bench.c
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+#include <stdio.h>
+#include <string.h>
+#include <fs.h>
+#include <ppp.h>
+#include <serial.h>
+
+/* This demo will frame a synthesized payload with the HDLC framing used by
+ * PPP, once with the byte at a time reference implementation and once with
+ * the span based escape engine, and will then parse the framed data back with
+ * both the implementations. Text and binary payloads are used with both the
+ * default ACCM used before LCP is negotiated and an ACCM of zero which is
+ * usually negotiated on a modem link. Frames generated by both the
+ * implementations are verified to be same and parsed payload is verified
+ * against the original payload before running the benchmark. Per frame and
+ * per byte cost for both the implementations are printed. */
+
+/* Demo configurations. */
+#define DEMO_STACK_SIZE     1024
+#define BENCH_ITERATIONS    200
+#define BENCH_PAYLOAD_SIZE  1500
+#define BENCH_FRAME_SIZE    ((BENCH_PAYLOAD_SIZE * 2) + 16)
+#define BENCH_BUFFER_SIZE   128
+#define BENCH_NUM_BUFFERS   64
+#define BENCH_NUM_LISTS     4
+
+/* Use the hardware tick if we don't have a cycle counter. */
+#ifdef CPU_CYCLE_COUNT
+#define BENCH_TIMESTAMP()   (uint32_t)CPU_CYCLE_COUNT()
+#else
+#define BENCH_TIMESTAMP()   (uint32_t)current_hardware_tick()
+#endif /* CPU_CYCLE_COUNT */
+
+/* Buffer file descriptor used for the benchmark. */
+typedef struct _bench_fd
+{
+    FS              fs;
+    FS_BUFFER_DATA  buffer_data;
+    FS_BUFFER_LIST  lists[BENCH_NUM_LISTS];
+} BENCH_FD;
+
+/* Function prototypes. */
+void ppp_hdlc_bench_task(void *);
+static FS_BUFFER_LIST *ppp_hdlc_bench_list(uint8_t *, uint32_t);
+static void ppp_hdlc_bench_free(FS_BUFFER_LIST *);
+static int32_t ppp_hdlc_bench_reference_add(FS_BUFFER_LIST *, uint32_t *, uint8_t, uint8_t);
+static int32_t ppp_hdlc_bench_reference_parse(FS_BUFFER_LIST *, uint8_t);
+static uint32_t ppp_hdlc_bench_verify(uint8_t *, uint32_t *);
+static uint32_t ppp_hdlc_bench_escape(uint8_t *, uint32_t *, uint8_t);
+static uint32_t ppp_hdlc_bench_unescape(uint32_t, uint8_t);
+static void ppp_hdlc_bench_print(char *, uint32_t, uint32_t);
+
+/* Benchmark task stack. */
+TASK ppp_hdlc_bench_cb;
+uint8_t ppp_hdlc_bench_stack[DEMO_STACK_SIZE];
+
+/* Benchmark buffer data. */
+BENCH_FD bench_fd;
+FS_BUFFER bench_buffers[BENCH_NUM_BUFFERS];
+uint8_t bench_space[BENCH_BUFFER_SIZE * BENCH_NUM_BUFFERS];
+
+/* Synthesized payloads and the framed data. */
+static uint8_t bench_text[BENCH_PAYLOAD_SIZE];
+static uint8_t bench_binary[BENCH_PAYLOAD_SIZE];
+static uint8_t bench_frame[BENCH_FRAME_SIZE];
+static uint8_t bench_check[BENCH_FRAME_SIZE];
+
+/* Default ACCM used before LCP is negotiated and a zero ACCM. */
+static uint32_t bench_accm_default[PPP_HDLC_MAP_WORDS] = { 0xFFFFFFFF, 0x0, 0x0, PPP_HDLC_MAP_FLAGS, 0x0, 0x0, 0x0, 0x0 };
+static uint32_t bench_accm_zero[PPP_HDLC_MAP_WORDS] = { 0x0, 0x0, 0x0, PPP_HDLC_MAP_FLAGS, 0x0, 0x0, 0x0, 0x0 };
+
+/*
+ * ppp_hdlc_bench_list
+ * @data: Data needed to be pushed on the buffer list.
+ * @length: Number of bytes in the data.
+ * @return: Returns the buffer list with the given data.
+ * This function will pull a buffer list and push the given data on it.
+ */
+static FS_BUFFER_LIST *ppp_hdlc_bench_list(uint8_t *data, uint32_t length)
+{
+    FS_BUFFER_LIST *buffer;
+
+    /* Pull a buffer list and push the data on it. */
+    buffer = fs_buffer_get(&bench_fd.fs, FS_LIST_FREE, 0);
+    ASSERT(buffer == NULL);
+    ASSERT(fs_buffer_list_push(buffer, data, length, 0) != SUCCESS);
+
+    /* Return the buffer list. */
+    return (buffer);
+
+} /* ppp_hdlc_bench_list */
+
+/*
+ * ppp_hdlc_bench_free
+ * @buffer: Buffer list needed to be freed.
+ * This function will free a buffer list.
+ */
+static void ppp_hdlc_bench_free(FS_BUFFER_LIST *buffer)
+{
+    /* Free this buffer list. */
+    fs_buffer_add(buffer->fd, buffer, FS_LIST_FREE, FS_BUFFER_ACTIVE);
+
+} /* ppp_hdlc_bench_free */
+
+/*
+ * ppp_hdlc_bench_reference_add
+ * @buffer: Buffer on which we need to put an HDLC header.
+ * @accm: Array of 8 words of transmit ACCM to be used to escape the data.
+ * @lcp: If we are sending a LCP request.
+ * @flags: Operation flags.
+ * @return: A success status will be returned if header was successfully added.
+ * This function is the byte at a time HDLC framing used as the reference for
+ * the escape engine, FCS is calculated in a separate pass.
+ */
+static int32_t ppp_hdlc_bench_reference_add(FS_BUFFER_LIST *buffer, uint32_t *accm, uint8_t lcp, uint8_t flags)
+{
+    FS_BUFFER_LIST *destination = fs_buffer_get(buffer->fd, FS_LIST_FREE, 0);
+    int32_t status;
+    uint16_t fcs;
+    uint8_t buf[2];
+
+    /* We should have a destination buffer. */
+    ASSERT(destination == NULL);
+
+    /* Add control and address fields. */
+    status = fs_buffer_list_push(buffer, (uint8_t []){ (uint8_t)PPP_CONTROL }, 1, (FS_BUFFER_HEAD | flags));
+    if (status == SUCCESS)
+    {
+        status = fs_buffer_list_push(buffer, (uint8_t []){ (uint8_t)PPP_ADDRESS }, 1, (FS_BUFFER_HEAD | flags));
+    }
+
+    if (status == SUCCESS)
+    {
+        /* Calculate the FCS of the data and push it at the end of buffer. */
+        fcs = ppp_fcs16_buffer_calculate(buffer, PPP_FCS16_INIT);
+        fcs ^= 0xffff;
+        buf[0] = (uint8_t)fcs;
+        buf[1] = (uint8_t)(fcs >> 8);
+        status = fs_buffer_list_push(buffer, buf, 2, flags);
+    }
+
+    /* While we have some data left in source buffer. */
+    while ((status == SUCCESS) && (buffer->total_length > 0))
+    {
+        /* Pull a byte from the source buffer chain. */
+        ASSERT(fs_buffer_list_pull(buffer, buf, 1, 0) != SUCCESS);
+
+        /* Check if we need to escape this byte. */
+        if ( ((lcp == TRUE) && (*buf < 0x20)) ||
+              (accm[*buf >> 5] & (uint32_t)(1 << (*buf & 0x1F))) )
+        {
+            /* Escape this character. */
+            buf[1] = buf[0] ^ 0x20;
+            buf[0] = PPP_ESCAPE;
+            status = fs_buffer_list_push(destination, buf, 2, flags);
+        }
+        else
+        {
+            /* Push the byte as it is. */
+            status = fs_buffer_list_push(destination, buf, 1, flags);
+        }
+    }
+
+    if (status == SUCCESS)
+    {
+        /* Move the generated buffer back to the original buffer. */
+        destination->next = buffer->next;
+        fs_buffer_list_move(buffer, destination);
+
+        /* Add start and end flags. */
+        status = fs_buffer_list_push(buffer, (uint8_t []){ PPP_FLAG }, 1, (FS_BUFFER_HEAD | flags));
+        if (status == SUCCESS)
+        {
+            status = fs_buffer_list_push(buffer, (uint8_t []){ PPP_FLAG }, 1, flags);
+        }
+    }
+
+    /* Free the destination buffer. */
+    ppp_hdlc_bench_free(destination);
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* ppp_hdlc_bench_reference_add */
+
+/*
+ * ppp_hdlc_bench_reference_parse
+ * @buffer: Buffer chain needed to be processed.
+ * @acfc: If address and control fields may be compressed.
+ * @return: A success status will be returned if header was successfully parsed,
+ *  PPP_INVALID_HEADER will be returned if an invalid header was parsed.
+ * This function is the byte at a time HDLC parser used as the reference for
+ * the un-escape engine, FCS is verified in a separate pass.
+ */
+static int32_t ppp_hdlc_bench_reference_parse(FS_BUFFER_LIST *buffer, uint8_t acfc)
+{
+    FS_BUFFER *one;
+    int32_t status = SUCCESS;
+    uint32_t converted;
+    uint8_t last_escaped = FALSE, flag = 0, acf[2];
+    uint8_t *data;
+
+    /* Un-escape all the buffers one byte at a time. */
+    buffer->total_length = 0;
+    for (one = buffer->list.head; one != NULL; one = one->next)
+    {
+        data = one->buffer;
+        converted = 0;
+
+        while (one->length > 0)
+        {
+            if (last_escaped == TRUE)
+            {
+                /* Escape the first byte. */
+                data[converted++] = (one->buffer[0] ^ 0x20);
+                last_escaped = FALSE;
+            }
+            else if (one->buffer[0] == PPP_ESCAPE)
+            {
+                /* Next byte is needed to be escaped. */
+                last_escaped = TRUE;
+            }
+            else
+            {
+                /* Put this byte as it is. */
+                data[converted++] = one->buffer[0];
+            }
+
+            /* Consume this byte. */
+            ASSERT(fs_buffer_pull(one, NULL, 1, 0) != SUCCESS);
+        }
+
+        /* Reinitialize buffer data. */
+        fs_buffer_update(one, data, converted);
+        buffer->total_length += converted;
+    }
+
+    /* Verify the start and end flags. */
+    if ((last_escaped == TRUE) || (buffer->total_length < 4))
+    {
+        status = PPP_INVALID_HEADER;
+    }
+    if (status == SUCCESS)
+    {
+        ASSERT(fs_buffer_list_pull(buffer, &flag, 1, 0) != SUCCESS);
+        status = (flag == PPP_FLAG) ? SUCCESS : PPP_INVALID_HEADER;
+    }
+    if (status == SUCCESS)
+    {
+        ASSERT(fs_buffer_list_pull(buffer, &flag, 1, FS_BUFFER_TAIL) != SUCCESS);
+        status = (flag == PPP_FLAG) ? SUCCESS : PPP_INVALID_HEADER;
+    }
+
+    /* Compute and verify the FCS. */
+    if ((status == SUCCESS) && (PPP_FCS16_IS_VALID(buffer)))
+    {
+        /* Pull the FCS from the buffer. */
+        ASSERT(fs_buffer_list_pull(buffer, NULL, 2, FS_BUFFER_TAIL) != SUCCESS);
+
+        /* Skim the address and control fields. */
+        if (buffer->total_length >= 2)
+        {
+            ASSERT(fs_buffer_list_pull(buffer, acf, 2, FS_BUFFER_INPLACE) != SUCCESS);
+            if ((acf[0] == PPP_ADDRESS) && (acf[1] == PPP_CONTROL))
+            {
+                ASSERT(fs_buffer_list_pull(buffer, NULL, 2, 0) != SUCCESS);
+            }
+            else if (acfc != TRUE)
+            {
+                status = PPP_INVALID_HEADER;
+            }
+        }
+    }
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* ppp_hdlc_bench_reference_parse */
+
+/*
+ * ppp_hdlc_bench_verify
+ * @payload: Payload to be used.
+ * @accm: Transmit ACCM to be used.
+ * @return: Returns the length of the framed payload, framed payload is saved
+ *  in the frame buffer.
+ * This function will verify the escape and un-escape engine against the
+ * reference implementation.
+ */
+static uint32_t ppp_hdlc_bench_verify(uint8_t *payload, uint32_t *accm)
+{
+    FS_BUFFER_LIST *buffer;
+    uint32_t length, lcp, offset;
+
+    /* Verify both for LCP and other frames and for a number of offsets to
+     * exercise unaligned data. */
+    for (lcp = FALSE; lcp <= TRUE; lcp++)
+    {
+        for (offset = 0; offset < 8; offset++)
+        {
+            /* Frame the payload with the reference implementation. */
+            buffer = ppp_hdlc_bench_list(payload + offset, (BENCH_PAYLOAD_SIZE - offset));
+            ASSERT(ppp_hdlc_bench_reference_add(buffer, accm, (uint8_t)lcp, 0) != SUCCESS);
+            length = buffer->total_length;
+            ASSERT(length > BENCH_FRAME_SIZE);
+            ASSERT(fs_buffer_list_pull(buffer, bench_check, length, 0) != SUCCESS);
+            ppp_hdlc_bench_free(buffer);
+
+            /* Frame the payload with the escape engine. */
+            buffer = ppp_hdlc_bench_list(payload + offset, (BENCH_PAYLOAD_SIZE - offset));
+            ASSERT(ppp_hdlc_header_add(buffer, accm, FALSE, (uint8_t)lcp, FALSE, 0) != SUCCESS);
+            ASSERT(buffer->total_length != length);
+            ASSERT(fs_buffer_list_pull(buffer, bench_frame, length, 0) != SUCCESS);
+            ppp_hdlc_bench_free(buffer);
+
+            /* Both the frames should be same. */
+            ASSERT(memcmp(bench_frame, bench_check, length) != 0);
+
+            /* Parse the frame with the un-escape engine and verify the
+             * payload. */
+            buffer = ppp_hdlc_bench_list(bench_frame, length);
+            ASSERT(ppp_hdlc_header_parse(buffer, FALSE, FALSE) != SUCCESS);
+            ASSERT(buffer->total_length != (BENCH_PAYLOAD_SIZE - offset));
+            ASSERT(fs_buffer_list_pull(buffer, bench_check, buffer->total_length, 0) != SUCCESS);
+            ASSERT(memcmp(bench_check, payload + offset, (BENCH_PAYLOAD_SIZE - offset)) != 0);
+            ppp_hdlc_bench_free(buffer);
+
+            /* A corrupted frame should not be parsed. */
+            bench_frame[length / 2] ^= 0x1;
+            buffer = ppp_hdlc_bench_list(bench_frame, length);
+            ASSERT((ppp_hdlc_header_parse(buffer, FALSE, FALSE) == SUCCESS) && (buffer->total_length == (BENCH_PAYLOAD_SIZE - offset)));
+            ppp_hdlc_bench_free(buffer);
+
+#ifdef PPP_FCS32
+            /* Frame and parse the payload with 32-bit FCS. */
+            buffer = ppp_hdlc_bench_list(payload + offset, (BENCH_PAYLOAD_SIZE - offset));
+            ASSERT(ppp_hdlc_header_add(buffer, accm, FALSE, (uint8_t)lcp, TRUE, 0) != SUCCESS);
+            ASSERT(ppp_hdlc_header_parse(buffer, FALSE, TRUE) != SUCCESS);
+            ASSERT(buffer->total_length != (BENCH_PAYLOAD_SIZE - offset));
+            ASSERT(fs_buffer_list_pull(buffer, bench_check, buffer->total_length, 0) != SUCCESS);
+            ASSERT(memcmp(bench_check, payload + offset, (BENCH_PAYLOAD_SIZE - offset)) != 0);
+            ppp_hdlc_bench_free(buffer);
+#endif /* PPP_FCS32 */
+        }
+    }
+
+    /* Frame the payload for the un-escape benchmark. */
+    buffer = ppp_hdlc_bench_list(payload, BENCH_PAYLOAD_SIZE);
+    ASSERT(ppp_hdlc_header_add(buffer, accm, FALSE, FALSE, FALSE, 0) != SUCCESS);
+    length = buffer->total_length;
+    ASSERT(fs_buffer_list_pull(buffer, bench_frame, length, 0) != SUCCESS);
+    ppp_hdlc_bench_free(buffer);
+
+    /* Return the length of the framed payload. */
+    return (length);
+
+} /* ppp_hdlc_bench_verify */
+
+/*
+ * ppp_hdlc_bench_escape
+ * @payload: Payload to be framed.
+ * @accm: Transmit ACCM to be used.
+ * @reference: If we need to run the reference implementation.
+ * @return: Returns the average cost of framing a payload.
+ * This function will frame the given payload.
+ */
+static uint32_t ppp_hdlc_bench_escape(uint8_t *payload, uint32_t *accm, uint8_t reference)
+{
+    FS_BUFFER_LIST *buffer;
+    uint32_t i, start, total = 0;
+
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        /* Push the payload on a buffer list. */
+        buffer = ppp_hdlc_bench_list(payload, BENCH_PAYLOAD_SIZE);
+
+        start = BENCH_TIMESTAMP();
+
+        /* Frame this payload. */
+        if (reference == TRUE)
+        {
+            ASSERT(ppp_hdlc_bench_reference_add(buffer, accm, FALSE, 0) != SUCCESS);
+        }
+        else
+        {
+            ASSERT(ppp_hdlc_header_add(buffer, accm, FALSE, FALSE, FALSE, 0) != SUCCESS);
+        }
+
+        total += (BENCH_TIMESTAMP() - start);
+
+        /* Free the framed data. */
+        ppp_hdlc_bench_free(buffer);
+    }
+
+    /* Return the per frame cost. */
+    return (total / BENCH_ITERATIONS);
+
+} /* ppp_hdlc_bench_escape */
+
+/*
+ * ppp_hdlc_bench_unescape
+ * @length: Length of the framed data.
+ * @reference: If we need to run the reference implementation.
+ * @return: Returns the average cost of parsing a frame.
+ * This function will parse the framed data.
+ */
+static uint32_t ppp_hdlc_bench_unescape(uint32_t length, uint8_t reference)
+{
+    FS_BUFFER_LIST *buffer;
+    uint32_t i, start, total = 0;
+
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        /* Push the framed data on a buffer list. */
+        buffer = ppp_hdlc_bench_list(bench_frame, length);
+
+        start = BENCH_TIMESTAMP();
+
+        /* Parse this frame. */
+        if (reference == TRUE)
+        {
+            ASSERT(ppp_hdlc_bench_reference_parse(buffer, FALSE) != SUCCESS);
+        }
+        else
+        {
+            ASSERT(ppp_hdlc_header_parse(buffer, FALSE, FALSE) != SUCCESS);
+        }
+
+        total += (BENCH_TIMESTAMP() - start);
+
+        /* Free the parsed data. */
+        ppp_hdlc_bench_free(buffer);
+    }
+
+    /* Return the per frame cost. */
+    return (total / BENCH_ITERATIONS);
+
+} /* ppp_hdlc_bench_unescape */
+
+/*
+ * ppp_hdlc_bench_print
+ * @name: Name of this test.
+ * @reference: Per frame cost of the reference implementation.
+ * @engine: Per frame cost of the engine.
+ * This function will print the per frame and per byte cost of a test.
+ */
+static void ppp_hdlc_bench_print(char *name, uint32_t reference, uint32_t engine)
+{
+    uint32_t reference_byte = ((reference * 100) / BENCH_PAYLOAD_SIZE);
+    uint32_t engine_byte = ((engine * 100) / BENCH_PAYLOAD_SIZE);
+
+    /* Print the results. */
+    printf("%s: reference %lu (%lu.%02lu/byte), engine %lu (%lu.%02lu/byte)\r\n", name,
+           (unsigned long)reference, (unsigned long)(reference_byte / 100), (unsigned long)(reference_byte % 100),
+           (unsigned long)engine, (unsigned long)(engine_byte / 100), (unsigned long)(engine_byte % 100));
+
+} /* ppp_hdlc_bench_print */
+
+void ppp_hdlc_bench_task(void *argv)
+{
+    uint32_t i, seed = 0x1234567;
+    uint32_t text_default, text_zero, binary_default, binary_zero;
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(argv);
+
+    /* Synthesize the payloads. */
+    for (i = 0; i < BENCH_PAYLOAD_SIZE; i++)
+    {
+        seed = (seed * 1103515245) + 12345;
+        bench_binary[i] = (uint8_t)(seed >> 16);
+        bench_text[i] = (uint8_t)('A' + (i % 26));
+    }
+
+    /* Clear the file descriptor. */
+    memset(&bench_fd, 0, sizeof(BENCH_FD));
+
+    /* Set buffer data for our file descriptor. */
+    bench_fd.buffer_data.buffer_space = bench_space;
+    bench_fd.buffer_data.buffer_size = BENCH_BUFFER_SIZE;
+    bench_fd.buffer_data.buffers = bench_buffers;
+    bench_fd.buffer_data.num_buffers = BENCH_NUM_BUFFERS;
+    bench_fd.buffer_data.buffer_lists = bench_fd.lists;
+    bench_fd.buffer_data.num_buffer_lists = BENCH_NUM_LISTS;
+    fs_buffer_dataset(&bench_fd.fs, &bench_fd.buffer_data);
+
+    for (;;)
+    {
+        /* Verify the engine and run the benchmark for all the payloads. */
+        text_default = ppp_hdlc_bench_verify(bench_text, bench_accm_default);
+        ppp_hdlc_bench_print("text escape, default ACCM", ppp_hdlc_bench_escape(bench_text, bench_accm_default, TRUE), ppp_hdlc_bench_escape(bench_text, bench_accm_default, FALSE));
+        ppp_hdlc_bench_print("text unescape, default ACCM", ppp_hdlc_bench_unescape(text_default, TRUE), ppp_hdlc_bench_unescape(text_default, FALSE));
+        text_zero = ppp_hdlc_bench_verify(bench_text, bench_accm_zero);
+        ppp_hdlc_bench_print("text escape, zero ACCM", ppp_hdlc_bench_escape(bench_text, bench_accm_zero, TRUE), ppp_hdlc_bench_escape(bench_text, bench_accm_zero, FALSE));
+        ppp_hdlc_bench_print("text unescape, zero ACCM", ppp_hdlc_bench_unescape(text_zero, TRUE), ppp_hdlc_bench_unescape(text_zero, FALSE));
+        binary_default = ppp_hdlc_bench_verify(bench_binary, bench_accm_default);
+        ppp_hdlc_bench_print("binary escape, default ACCM", ppp_hdlc_bench_escape(bench_binary, bench_accm_default, TRUE), ppp_hdlc_bench_escape(bench_binary, bench_accm_default, FALSE));
+        ppp_hdlc_bench_print("binary unescape, default ACCM", ppp_hdlc_bench_unescape(binary_default, TRUE), ppp_hdlc_bench_unescape(binary_default, FALSE));
+        binary_zero = ppp_hdlc_bench_verify(bench_binary, bench_accm_zero);
+        ppp_hdlc_bench_print("binary escape, zero ACCM", ppp_hdlc_bench_escape(bench_binary, bench_accm_zero, TRUE), ppp_hdlc_bench_escape(bench_binary, bench_accm_zero, FALSE));
+        ppp_hdlc_bench_print("binary unescape, zero ACCM", ppp_hdlc_bench_unescape(binary_zero, TRUE), ppp_hdlc_bench_unescape(binary_zero, FALSE));
+
+        /* Wait before running the benchmark again. */
+        sleep_ticks(SOFT_TICKS_PER_SEC);
+    }
+}
+
+int main(void)
+{
+    memset(&ppp_hdlc_bench_cb, 0, sizeof(TASK));
+
+    /* Initialize scheduler. */
+    scheduler_init();
+
+    /* Initialize file system. */
+    fs_init();
+
+    /* Initialize serial. */
+    serial_init();
+
+    /* Create a task for HDLC benchmark. */
+    task_create(&ppp_hdlc_bench_cb, P_STR("BENCH"), ppp_hdlc_bench_stack, DEMO_STACK_SIZE, &ppp_hdlc_bench_task, (void *)(NULL), 0);
+    scheduler_task_add(&ppp_hdlc_bench_cb, 5);
+
+    /* Run scheduler. */
+    kernel_run();
+
+    return (0);
+
+}
@@ -0,0 +1,335 @@
+/*
+ * ppp_hdr_bench.c
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+#include <stdio.h>
+#include <string.h>
+#include <fs.h>
+#include <ppp.h>
+#include <serial.h>
+
+/* This demo will frame small telemetry packets, an IPv4/UDP header with a few
+ * bytes of data, once without and once with ACFC and PFC. Each packet is
+ * framed with the generic protocol and HDLC header functions and with the
+ * per-link header template, frames are verified to be same. Number of bytes
+ * added to each frame and the per frame cost of both the header prefix alone
+ * and the complete framing are printed. */
+
+/* Demo configurations. */
+#define DEMO_STACK_SIZE     1024
+#define BENCH_ITERATIONS    2000
+#define BENCH_PAYLOAD_SIZE  40
+#define BENCH_FRAME_SIZE    ((BENCH_PAYLOAD_SIZE * 2) + 16)
+#define BENCH_BUFFER_SIZE   128
+#define BENCH_NUM_BUFFERS   16
+#define BENCH_NUM_LISTS     4
+
+/* Use the hardware tick if we don't have a cycle counter. */
+#ifdef CPU_CYCLE_COUNT
+#define BENCH_TIMESTAMP()   (uint32_t)CPU_CYCLE_COUNT()
+#else
+#define BENCH_TIMESTAMP()   (uint32_t)current_hardware_tick()
+#endif /* CPU_CYCLE_COUNT */
+
+/* Buffer file descriptor used for the benchmark. */
+typedef struct _bench_fd
+{
+    FS              fs;
+    FS_BUFFER_DATA  buffer_data;
+    FS_BUFFER_LIST  lists[BENCH_NUM_LISTS];
+} BENCH_FD;
+
+/* Function prototypes. */
+void ppp_hdr_bench_task(void *);
+static FS_BUFFER_LIST *ppp_hdr_bench_list(void);
+static void ppp_hdr_bench_free(FS_BUFFER_LIST *);
+static int32_t ppp_hdr_bench_generic(FS_BUFFER_LIST *, uint8_t);
+static int32_t ppp_hdr_bench_prefix(FS_BUFFER_LIST *, uint8_t);
+static uint32_t ppp_hdr_bench_verify(void);
+static uint32_t ppp_hdr_bench_run(uint8_t, uint8_t);
+static void ppp_hdr_bench_config(char *, uint32_t);
+
+/* Benchmark task stack. */
+TASK ppp_hdr_bench_cb;
+uint8_t ppp_hdr_bench_stack[DEMO_STACK_SIZE];
+
+/* Benchmark buffer data. */
+BENCH_FD bench_fd;
+FS_BUFFER bench_buffers[BENCH_NUM_BUFFERS];
+uint8_t bench_space[BENCH_BUFFER_SIZE * BENCH_NUM_BUFFERS];
+
+/* PPP link used to frame the packets. */
+static PPP bench_ppp;
+
+/* Synthesized telemetry packet and generated frames. */
+static uint8_t bench_payload[BENCH_PAYLOAD_SIZE];
+static uint8_t bench_frame[2][BENCH_FRAME_SIZE];
+
+/* ACCM negotiated on the link. */
+static uint32_t bench_accm[PPP_HDLC_MAP_WORDS] = { 0x0, 0x0, 0x0, PPP_HDLC_MAP_FLAGS, 0x0, 0x0, 0x0, 0x0 };
+
+/*
+ * ppp_hdr_bench_list
+ * @return: Returns a buffer list with the telemetry packet.
+ * This function will pull a buffer list and push the telemetry packet on it.
+ */
+static FS_BUFFER_LIST *ppp_hdr_bench_list(void)
+{
+    FS_BUFFER_LIST *buffer;
+
+    /* Pull a buffer list and push the packet on it. */
+    buffer = fs_buffer_get(&bench_fd.fs, FS_LIST_FREE, 0);
+    ASSERT(buffer == NULL);
+    ASSERT(fs_buffer_list_push(buffer, bench_payload, BENCH_PAYLOAD_SIZE, 0) != SUCCESS);
+
+    /* Return the buffer list. */
+    return (buffer);
+
+} /* ppp_hdr_bench_list */
+
+/*
+ * ppp_hdr_bench_free
+ * @buffer: Buffer list needed to be freed.
+ * This function will free a buffer list.
+ */
+static void ppp_hdr_bench_free(FS_BUFFER_LIST *buffer)
+{
+    /* Free this buffer list. */
+    fs_buffer_add(buffer->fd, buffer, FS_LIST_FREE, FS_BUFFER_ACTIVE);
+
+} /* ppp_hdr_bench_free */
+
+/*
+ * ppp_hdr_bench_generic
+ * @buffer: Buffer needed to be framed.
+ * @frame: If we need to generate the complete frame, otherwise only the
+ *  header prefix is added.
+ * @return: A success status will be returned if buffer was successfully
+ *  framed.
+ * This function will frame a buffer with the generic protocol and HDLC header
+ * functions.
+ */
+static int32_t ppp_hdr_bench_generic(FS_BUFFER_LIST *buffer, uint8_t frame)
+{
+    int32_t status;
+
+    /* Add PPP protocol. */
+    status = ppp_packet_protocol_add(buffer, PPP_PROTO_IPV4, PPP_IS_TX_PFC(&bench_ppp), 0);
+
+    if ((status == SUCCESS) && (frame == TRUE))
+    {
+        /* Add the HDLC header. */
+        status = ppp_hdlc_header_add(buffer, bench_ppp.tx_accm, PPP_IS_TX_ACFC(&bench_ppp), FALSE, PPP_IS_TX_FCS32(&bench_ppp), 0);
+    }
+
+    /* If we only need the prefix and address and control fields are needed. */
+    else if ((status == SUCCESS) && (!PPP_IS_TX_ACFC(&bench_ppp)))
+    {
+        /* Add control and address fields as the HDLC header would. */
+        status = fs_buffer_list_push(buffer, (uint8_t []){ (uint8_t)PPP_CONTROL }, 1, FS_BUFFER_HEAD);
+
+        if (status == SUCCESS)
+        {
+            status = fs_buffer_list_push(buffer, (uint8_t []){ (uint8_t)PPP_ADDRESS }, 1, FS_BUFFER_HEAD);
+        }
+    }
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* ppp_hdr_bench_generic */
+
+/*
+ * ppp_hdr_bench_prefix
+ * @buffer: Buffer needed to be framed.
+ * @frame: If we need to generate the complete frame, otherwise only the
+ *  header prefix is added.
+ * @return: A success status will be returned if buffer was successfully
+ *  framed.
+ * This function will frame a buffer using the header template.
+ */
+static int32_t ppp_hdr_bench_prefix(FS_BUFFER_LIST *buffer, uint8_t frame)
+{
+    int32_t status;
+
+    if (frame == TRUE)
+    {
+        /* Generate the frame. */
+        status = ppp_tx_header_add(&bench_ppp, buffer, PPP_PROTO_IPV4, 0);
+    }
+    else
+    {
+        /* Only push the header template. */
+        bench_ppp.tx_header[bench_ppp.tx_header_len - 1] = PPP_PROTO_IPV4;
+        status = fs_buffer_list_push(buffer, bench_ppp.tx_header, bench_ppp.tx_header_len, FS_BUFFER_HEAD);
+    }
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* ppp_hdr_bench_prefix */
+
+/*
+ * ppp_hdr_bench_verify
+ * @return: Returns the length of the generated frame.
+ * This function will verify that the frame generated with the header template
+ * is same as the one generated by the generic functions.
+ */
+static uint32_t ppp_hdr_bench_verify(void)
+{
+    FS_BUFFER_LIST *buffer;
+    uint32_t length[2];
+    uint8_t i;
+
+    for (i = 0; i < 2; i++)
+    {
+        /* Generate a frame. */
+        buffer = ppp_hdr_bench_list();
+        ASSERT(((i == 0) ? ppp_hdr_bench_generic(buffer, TRUE) : ppp_hdr_bench_prefix(buffer, TRUE)) != SUCCESS);
+
+        /* Save the generated frame. */
+        length[i] = buffer->total_length;
+        ASSERT(length[i] > BENCH_FRAME_SIZE);
+        ASSERT(fs_buffer_list_pull(buffer, bench_frame[i], length[i], 0) != SUCCESS);
+        ppp_hdr_bench_free(buffer);
+    }
+
+    /* Both frames should be same. */
+    ASSERT(length[0] != length[1]);
+    ASSERT(memcmp(bench_frame[0], bench_frame[1], length[0]) != 0);
+
+    /* Return the frame length. */
+    return (length[0]);
+
+} /* ppp_hdr_bench_verify */
+
+/*
+ * ppp_hdr_bench_run
+ * @template: If we need to use the header template.
+ * @frame: If we need to generate the complete frame.
+ * @return: Returns the average cost of framing a packet.
+ * This function will frame the telemetry packet a number of times.
+ */
+static uint32_t ppp_hdr_bench_run(uint8_t template, uint8_t frame)
+{
+    FS_BUFFER_LIST *buffer;
+    uint32_t i, start;
+
+    start = BENCH_TIMESTAMP();
+
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        /* Frame the packet. */
+        buffer = ppp_hdr_bench_list();
+        ASSERT(((template == TRUE) ? ppp_hdr_bench_prefix(buffer, frame) : ppp_hdr_bench_generic(buffer, frame)) != SUCCESS);
+        ppp_hdr_bench_free(buffer);
+    }
+
+    /* Return the per frame cost. */
+    return ((BENCH_TIMESTAMP() - start) / BENCH_ITERATIONS);
+
+} /* ppp_hdr_bench_run */
+
+/*
+ * ppp_hdr_bench_config
+ * @name: Name of this configuration.
+ * @flags: Negotiated PPP flags.
+ * This function will run the benchmark for given link configuration and print
+ * the results.
+ */
+static void ppp_hdr_bench_config(char *name, uint32_t flags)
+{
+    uint32_t length;
+
+    /* Update the link configuration and the header template. */
+    bench_ppp.flags = flags;
+    ppp_tx_header_update(&bench_ppp);
+
+    /* Verify the frames and print the results. */
+    length = ppp_hdr_bench_verify();
+    printf("%s: %lu byte frame, %lu bytes overhead, prefix generic %lu template %lu, frame generic %lu template %lu\r\n", name,
+           (unsigned long)length, (unsigned long)(length - BENCH_PAYLOAD_SIZE),
+           (unsigned long)ppp_hdr_bench_run(FALSE, FALSE), (unsigned long)ppp_hdr_bench_run(TRUE, FALSE),
+           (unsigned long)ppp_hdr_bench_run(FALSE, TRUE), (unsigned long)ppp_hdr_bench_run(TRUE, TRUE));
+
+} /* ppp_hdr_bench_config */
+
+void ppp_hdr_bench_task(void *argv)
+{
+    uint32_t i;
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(argv);
+
+#ifdef CPU_CYCLE_COUNT_INIT
+    /* Start the cycle counter. */
+    CPU_CYCLE_COUNT_INIT();
+#endif /* CPU_CYCLE_COUNT_INIT */
+
+    /* Synthesize an IPv4/UDP telemetry packet. */
+    for (i = 0; i < BENCH_PAYLOAD_SIZE; i++)
+    {
+        bench_payload[i] = (uint8_t)((i * 37) + 0x40);
+    }
+    bench_payload[0] = 0x45;
+
+    /* Clear the file descriptor. */
+    memset(&bench_fd, 0, sizeof(BENCH_FD));
+
+    /* Set buffer data for our file descriptor. */
+    bench_fd.buffer_data.buffer_space = bench_space;
+    bench_fd.buffer_data.buffer_size = BENCH_BUFFER_SIZE;
+    bench_fd.buffer_data.buffers = bench_buffers;
+    bench_fd.buffer_data.num_buffers = BENCH_NUM_BUFFERS;
+    bench_fd.buffer_data.buffer_lists = bench_fd.lists;
+    bench_fd.buffer_data.num_buffer_lists = BENCH_NUM_LISTS;
+    fs_buffer_dataset(&bench_fd.fs, &bench_fd.buffer_data);
+
+    /* Initialize the PPP link as if it is open. */
+    memset(&bench_ppp, 0, sizeof(PPP));
+    bench_ppp.state = PPP_STATE_NETWORK;
+    memcpy(bench_ppp.tx_accm, bench_accm, sizeof(bench_accm));
+
+    for (;;)
+    {
+        /* Run the benchmark for both link configurations. */
+        ppp_hdr_bench_config("no compression", 0);
+        ppp_hdr_bench_config("ACFC and PFC", (PPP_FLAG_TX_ACFC | PPP_FLAG_TX_PFC));
+
+        /* Wait before running the benchmark again. */
+        sleep_ticks(SOFT_TICKS_PER_SEC);
+    }
+}
+
+int main(void)
+{
+    memset(&ppp_hdr_bench_cb, 0, sizeof(TASK));
+
+    /* Initialize scheduler. */
+    scheduler_init();
+
+    /* Initialize file system. */
+    fs_init();
+
+    /* Initialize serial. */
+    serial_init();
+
+    /* Create a task for header benchmark. */
+    task_create(&ppp_hdr_bench_cb, P_STR("BENCH"), ppp_hdr_bench_stack, DEMO_STACK_SIZE, &ppp_hdr_bench_task, (void *)(NULL), 0);
+    scheduler_task_add(&ppp_hdr_bench_cb, 5);
+
+    /* Run scheduler. */
+    kernel_run();
+
+    return (0);
+
+}
@@ -0,0 +1,552 @@
+/*
+ * ppp_vj_bench.c
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+#include <stdio.h>
+#include <string.h>
+#include <fs.h>
+#include <ppp.h>
+#include <net.h>
+#include <net_csum.h>
+#include <net_ipv4.h>
+#include <net_tcp.h>
+#include <serial.h>
+
+#ifndef PPP_VJ
+#error "This demo requires PPP_VJ."
+#endif
+
+/* This demo will replay a number of TCP sessions as seen on a modem link over
+ * a PPP link with VJ header compression. An interactive session where each
+ * key stroke is echoed back, a bulk transfer, the same bulk transfer with TCP
+ * timestamps and a number of interleaved short transfers are replayed. As
+ * timestamps change the TCP options in almost every segment, those cannot be
+ * compressed by VJ and are sent uncompressed. Each packet is framed once as it is and once after
+ * compressing it's header, compressed frame is then parsed and uncompressed at
+ * the other end and verified against the original packet. Number of bytes on
+ * the wire with and without compression are printed for each session. */
+
+/* Demo configurations. */
+#define DEMO_STACK_SIZE     1024
+#define BENCH_BUFFER_SIZE   128
+#define BENCH_NUM_BUFFERS   64
+#define BENCH_NUM_LISTS     4
+#define BENCH_MSS           256
+#define BENCH_TS_SIZE       12
+#define BENCH_PACKET_SIZE   (IPV4_HDR_SIZE + TCP_HRD_SIZE + BENCH_TS_SIZE + BENCH_MSS)
+#define BENCH_KEYS          200
+#define BENCH_LINE          40
+#define BENCH_BULK_SEGMENTS 256
+#define BENCH_WEB_CONNS     4
+#define BENCH_WEB_REQUEST   200
+#define BENCH_WEB_SEGMENTS  8
+
+/* Directions of a packet. */
+#define BENCH_CLIENT        0
+#define BENCH_SERVER        1
+
+/* Buffer file descriptor used for the benchmark. */
+typedef struct _bench_fd
+{
+    FS              fs;
+    FS_BUFFER_DATA  buffer_data;
+    FS_BUFFER_LIST  lists[BENCH_NUM_LISTS];
+} BENCH_FD;
+
+/* TCP connection being replayed. */
+typedef struct _bench_conn
+{
+    uint32_t        address[2];
+    uint32_t        seq[2];
+    uint32_t        tsval[2];
+    uint16_t        port[2];
+    uint16_t        window[2];
+    uint16_t        ip_id[2];
+    uint8_t         pad[2];
+} BENCH_CONN;
+
+/* Results for a session. */
+typedef struct _bench_result
+{
+    uint32_t        packets;
+    uint32_t        plain;
+    uint32_t        vj;
+    uint32_t        comp;
+    uint32_t        uncomp;
+} BENCH_RESULT;
+
+/* Function prototypes. */
+void ppp_vj_bench_task(void *);
+static FS_BUFFER_LIST *ppp_vj_bench_list(uint8_t *, uint32_t);
+static void ppp_vj_bench_free(FS_BUFFER_LIST *);
+static void ppp_vj_bench_conn(BENCH_CONN *, uint32_t);
+static void ppp_vj_bench_send(BENCH_RESULT *, BENCH_CONN *, uint32_t, uint8_t *, uint32_t, uint8_t);
+static void ppp_vj_bench_open(BENCH_RESULT *, BENCH_CONN *, uint32_t);
+static void ppp_vj_bench_close(BENCH_RESULT *, BENCH_CONN *, uint32_t);
+static void ppp_vj_bench_interactive(BENCH_RESULT *);
+static void ppp_vj_bench_bulk(BENCH_RESULT *);
+static void ppp_vj_bench_bulk_ts(BENCH_RESULT *);
+static void ppp_vj_bench_web(BENCH_RESULT *);
+static void ppp_vj_bench_run(char *, void (*)(BENCH_RESULT *));
+
+/* Benchmark task stack. */
+TASK ppp_vj_bench_cb;
+uint8_t ppp_vj_bench_stack[DEMO_STACK_SIZE];
+
+/* Benchmark buffer data. */
+BENCH_FD bench_fd;
+FS_BUFFER bench_buffers[BENCH_NUM_BUFFERS];
+uint8_t bench_space[BENCH_BUFFER_SIZE * BENCH_NUM_BUFFERS];
+
+/* VJ state for both ends of the link. */
+static PPP_VJ_STATE bench_vj[2];
+
+/* Packet being replayed and the received packet. */
+static uint8_t bench_packet[BENCH_PACKET_SIZE];
+static uint8_t bench_check[BENCH_PACKET_SIZE];
+static uint8_t bench_data[BENCH_MSS];
+
+/* If TCP timestamps are being used. */
+static uint8_t bench_timestamps;
+
+/* ACCM negotiated on the link. */
+static uint32_t bench_accm[PPP_HDLC_MAP_WORDS] = { 0x0, 0x0, 0x0, PPP_HDLC_MAP_FLAGS, 0x0, 0x0, 0x0, 0x0 };
+
+/*
+ * ppp_vj_bench_list
+ * @data: Data needed to be pushed on the buffer list.
+ * @length: Number of bytes in the data.
+ * @return: Returns the buffer list with the given data.
+ * This function will pull a buffer list and push the given data on it.
+ */
+static FS_BUFFER_LIST *ppp_vj_bench_list(uint8_t *data, uint32_t length)
+{
+    FS_BUFFER_LIST *buffer;
+
+    /* Pull a buffer list and push the data on it. */
+    buffer = fs_buffer_get(&bench_fd.fs, FS_LIST_FREE, 0);
+    ASSERT(buffer == NULL);
+    ASSERT(fs_buffer_list_push(buffer, data, length, 0) != SUCCESS);
+
+    /* Return the buffer list. */
+    return (buffer);
+
+} /* ppp_vj_bench_list */
+
+/*
+ * ppp_vj_bench_free
+ * @buffer: Buffer list needed to be freed.
+ * This function will free a buffer list.
+ */
+static void ppp_vj_bench_free(FS_BUFFER_LIST *buffer)
+{
+    /* Free this buffer list. */
+    fs_buffer_add(buffer->fd, buffer, FS_LIST_FREE, FS_BUFFER_ACTIVE);
+
+} /* ppp_vj_bench_free */
+
+/*
+ * ppp_vj_bench_conn
+ * @conn: Connection needed to be initialized.
+ * @index: Index of this connection.
+ * This function will initialize a TCP connection between the client and
+ * server.
+ */
+static void ppp_vj_bench_conn(BENCH_CONN *conn, uint32_t index)
+{
+    /* Initialize connection parameters. */
+    conn->address[BENCH_CLIENT] = 0xC0A80002;
+    conn->address[BENCH_SERVER] = 0xC0A80001;
+    conn->port[BENCH_CLIENT] = (uint16_t)(1025 + index);
+    conn->port[BENCH_SERVER] = (uint16_t)((index == 0) ? 23 : 80);
+    conn->seq[BENCH_CLIENT] = (0x1A2B3C4D + (index * 0x01000000));
+    conn->seq[BENCH_SERVER] = (0x5E6F7081 + (index * 0x01000000));
+    conn->window[BENCH_CLIENT] = 4096;
+    conn->window[BENCH_SERVER] = 8760;
+    conn->ip_id[BENCH_CLIENT] = (uint16_t)(0x1000 + (index * 0x100));
+    conn->ip_id[BENCH_SERVER] = (uint16_t)(0x8000 + (index * 0x100));
+    conn->tsval[BENCH_CLIENT] = (0x00100000 + (index * 0x1000));
+    conn->tsval[BENCH_SERVER] = (0x00800000 + (index * 0x1000));
+
+} /* ppp_vj_bench_conn */
+
+/*
+ * ppp_vj_bench_send
+ * @result: Results for this session.
+ * @conn: Connection on which a packet is needed to be sent.
+ * @dir: Direction in which this packet is needed to be sent.
+ * @data: Data needed to be sent.
+ * @length: Number of bytes in the data.
+ * @tcp_flags: TCP flags.
+ * This function will build a TCP/IP packet and send it over the link once as
+ * it is and once with VJ compression, packet recovered at the other end is
+ * verified against the original packet.
+ */
+static void ppp_vj_bench_send(BENCH_RESULT *result, BENCH_CONN *conn, uint32_t dir, uint8_t *data, uint32_t length, uint8_t tcp_flags)
+{
+    FS_BUFFER_LIST *buffer;
+    uint8_t *ip = bench_packet, *tcp = &bench_packet[IPV4_HDR_SIZE], pseudo[12];
+    uint32_t tcp_hlen = (TCP_HRD_SIZE + ((bench_timestamps == TRUE) ? BENCH_TS_SIZE : 0));
+    uint32_t total = (IPV4_HDR_SIZE + tcp_hlen + length), csum;
+    uint16_t value, proto = PPP_PROTO_IPV4;
+
+    /* Build the IPv4 header. */
+    memset(bench_packet, 0, (IPV4_HDR_SIZE + tcp_hlen));
+    ip[IPV4_HDR_VER_IHL_OFFSET] = (IPV4_HDR_VER | (IPV4_HDR_SIZE >> 2));
+    NET_PUT_BE16(&ip[IPV4_HDR_LENGTH_OFFSET], total);
+    NET_PUT_BE16(&ip[IPV4_HDR_ID_OFFSET], conn->ip_id[dir]);
+    NET_PUT_BE16(&ip[IPV4_HDR_FLAG_FRAG_OFFSET], IPV4_HDR_FLAG_DF);
+    ip[IPV4_HDR_TOL_OFFSET] = 64;
+    ip[IPV4_HDR_PROTO_OFFSET] = IP_PROTO_TCP;
+    NET_PUT_BE32(&ip[IPV4_HDR_SRC_OFFSET], conn->address[dir]);
+    NET_PUT_BE32(&ip[IPV4_HDR_DST_OFFSET], conn->address[!dir]);
+    value = (uint16_t)~net_csum_partial(ip, IPV4_HDR_SIZE, 0);
+    memcpy(&ip[IPV4_HDR_CSUM_OFFSET], &value, 2);
+
+    /* Build the TCP header. */
+    NET_PUT_BE16(&tcp[TCP_HRD_SRC_PORT_OFFSET], conn->port[dir]);
+    NET_PUT_BE16(&tcp[TCP_HRD_DST_PORT_OFFSET], conn->port[!dir]);
+    NET_PUT_BE32(&tcp[TCP_HRD_SEQ_NUM_OFFSET], conn->seq[dir]);
+    if (tcp_flags & TCP_HDR_FLAG_ACK)
+    {
+        NET_PUT_BE32(&tcp[TCP_HRD_ACK_NUM_OFFSET], conn->seq[!dir]);
+    }
+    tcp[TCP_HRD_FLAGS_OFFSET] = (uint8_t)((tcp_hlen >> 2) << 4);
+    tcp[TCP_HRD_FLAGS_OFFSET + 1] = tcp_flags;
+    NET_PUT_BE16(&tcp[TCP_HRD_WND_SIZE_OFFSET], conn->window[dir]);
+
+    /* If we are using timestamps. */
+    if (bench_timestamps == TRUE)
+    {
+        /* Timestamp clock ticks for each segment, echo the last timestamp
+         * from the other side. */
+        conn->tsval[dir]++;
+        tcp[TCP_HRD_SIZE] = 1;
+        tcp[TCP_HRD_SIZE + 1] = 1;
+        tcp[TCP_HRD_SIZE + 2] = 8;
+        tcp[TCP_HRD_SIZE + 3] = 10;
+        NET_PUT_BE32(&tcp[TCP_HRD_SIZE + 4], conn->tsval[dir]);
+        NET_PUT_BE32(&tcp[TCP_HRD_SIZE + 8], conn->tsval[!dir]);
+    }
+
+    memcpy(&tcp[tcp_hlen], data, length);
+
+    /* Calculate the TCP checksum. */
+    memcpy(pseudo, &ip[IPV4_HDR_SRC_OFFSET], 8);
+    pseudo[8] = 0;
+    pseudo[9] = IP_PROTO_TCP;
+    NET_PUT_BE16(&pseudo[10], (tcp_hlen + length));
+    csum = net_csum_partial(pseudo, sizeof(pseudo), 0);
+    value = (uint16_t)~net_csum_partial(tcp, (tcp_hlen + length), csum);
+    memcpy(&tcp[TCP_HRD_CSUM_OFFSET], &value, 2);
+
+    /* Update the connection state. */
+    conn->ip_id[dir]++;
+    conn->seq[dir] += (length + ((tcp_flags & (TCP_HDR_FLAG_SYN | TCP_HDR_FLAG_FIN)) ? 1 : 0));
+
+    /* Frame the packet as it is. */
+    buffer = ppp_vj_bench_list(bench_packet, total);
+    ASSERT(ppp_packet_protocol_add(buffer, PPP_PROTO_IPV4, TRUE, 0) != SUCCESS);
+    ASSERT(ppp_hdlc_header_add(buffer, bench_accm, TRUE, FALSE, FALSE, 0) != SUCCESS);
+    result->plain += buffer->total_length;
+    ppp_vj_bench_free(buffer);
+
+    /* Compress the packet and frame it. */
+    buffer = ppp_vj_bench_list(bench_packet, total);
+    ASSERT(ppp_vj_compress(&bench_vj[dir], buffer, &proto, 0) != SUCCESS);
+    ASSERT(ppp_packet_protocol_add(buffer, proto, TRUE, 0) != SUCCESS);
+    ASSERT(ppp_hdlc_header_add(buffer, bench_accm, TRUE, FALSE, FALSE, 0) != SUCCESS);
+    result->vj += buffer->total_length;
+    result->packets ++;
+
+    /* Parse the frame at the other end. */
+    ASSERT(ppp_hdlc_header_parse(buffer, TRUE, FALSE) != SUCCESS);
+    ASSERT(ppp_packet_protocol_parse(buffer, &proto, TRUE) != SUCCESS);
+
+    /* If header was compressed. */
+    if (proto == PPP_PROTO_VJ_COMP)
+    {
+        result->comp ++;
+    }
+    else if (proto == PPP_PROTO_VJ_UNCOMP)
+    {
+        result->uncomp ++;
+    }
+
+    /* If we need to recover the TCP/IP header. */
+    if (proto != PPP_PROTO_IPV4)
+    {
+        ASSERT(ppp_vj_uncompress(&bench_vj[!dir], buffer, proto, 0) != SUCCESS);
+    }
+
+    /* Verify the received packet. */
+    ASSERT(buffer->total_length != total);
+    ASSERT(fs_buffer_list_pull(buffer, bench_check, total, 0) != SUCCESS);
+    ASSERT(memcmp(bench_check, bench_packet, total) != 0);
+    ppp_vj_bench_free(buffer);
+
+} /* ppp_vj_bench_send */
+
+/*
+ * ppp_vj_bench_open
+ * @result: Results for this session.
+ * @conn: Connection needed to be opened.
+ * @index: Index of this connection.
+ * This function will replay the three way handshake for a connection.
+ */
+static void ppp_vj_bench_open(BENCH_RESULT *result, BENCH_CONN *conn, uint32_t index)
+{
+    /* Initialize and open the connection. */
+    ppp_vj_bench_conn(conn, index);
+    ppp_vj_bench_send(result, conn, BENCH_CLIENT, NULL, 0, TCP_HDR_FLAG_SYN);
+    ppp_vj_bench_send(result, conn, BENCH_SERVER, NULL, 0, (TCP_HDR_FLAG_SYN | TCP_HDR_FLAG_ACK));
+    ppp_vj_bench_send(result, conn, BENCH_CLIENT, NULL, 0, TCP_HDR_FLAG_ACK);
+
+} /* ppp_vj_bench_open */
+
+/*
+ * ppp_vj_bench_close
+ * @result: Results for this session.
+ * @conn: Connection needed to be closed.
+ * @dir: Side closing the connection.
+ * This function will replay the closing of a connection.
+ */
+static void ppp_vj_bench_close(BENCH_RESULT *result, BENCH_CONN *conn, uint32_t dir)
+{
+    /* Both sides close the connection. */
+    ppp_vj_bench_send(result, conn, dir, NULL, 0, (TCP_HDR_FLAG_FIN | TCP_HDR_FLAG_ACK));
+    ppp_vj_bench_send(result, conn, !dir, NULL, 0, TCP_HDR_FLAG_ACK);
+    ppp_vj_bench_send(result, conn, !dir, NULL, 0, (TCP_HDR_FLAG_FIN | TCP_HDR_FLAG_ACK));
+    ppp_vj_bench_send(result, conn, dir, NULL, 0, TCP_HDR_FLAG_ACK);
+
+} /* ppp_vj_bench_close */
+
+/*
+ * ppp_vj_bench_interactive
+ * @result: Results for this session.
+ * This function will replay an interactive session, each key stroke is
+ * echoed back by the server and a line of output is sent after some key
+ * strokes.
+ */
+static void ppp_vj_bench_interactive(BENCH_RESULT *result)
+{
+    BENCH_CONN conn;
+    uint32_t i;
+
+    /* Open the connection. */
+    ppp_vj_bench_open(result, &conn, 0);
+
+    for (i = 0; i < BENCH_KEYS; i++)
+    {
+        /* Send a key stroke and echo it back. */
+        ppp_vj_bench_send(result, &conn, BENCH_CLIENT, &bench_data[i % BENCH_MSS], 1, (TCP_HDR_FLAG_PSH | TCP_HDR_FLAG_ACK));
+        ppp_vj_bench_send(result, &conn, BENCH_SERVER, &bench_data[i % BENCH_MSS], 1, (TCP_HDR_FLAG_PSH | TCP_HDR_FLAG_ACK));
+        ppp_vj_bench_send(result, &conn, BENCH_CLIENT, NULL, 0, TCP_HDR_FLAG_ACK);
+
+        /* After a number of key strokes send a line of output. */
+        if ((i % 16) == 15)
+        {
+            ppp_vj_bench_send(result, &conn, BENCH_SERVER, bench_data, BENCH_LINE, (TCP_HDR_FLAG_PSH | TCP_HDR_FLAG_ACK));
+            conn.window[BENCH_CLIENT] = (uint16_t)(4096 - BENCH_LINE);
+            ppp_vj_bench_send(result, &conn, BENCH_CLIENT, NULL, 0, TCP_HDR_FLAG_ACK);
+            conn.window[BENCH_CLIENT] = 4096;
+        }
+    }
+
+    /* Close the connection. */
+    ppp_vj_bench_close(result, &conn, BENCH_CLIENT);
+
+} /* ppp_vj_bench_interactive */
+
+/*
+ * ppp_vj_bench_bulk
+ * @result: Results for this session.
+ * This function will replay a bulk transfer from the server, client ACKs
+ * every other segment.
+ */
+static void ppp_vj_bench_bulk(BENCH_RESULT *result)
+{
+    BENCH_CONN conn;
+    uint32_t i;
+
+    /* Open the connection and send a request. */
+    ppp_vj_bench_open(result, &conn, 1);
+    ppp_vj_bench_send(result, &conn, BENCH_CLIENT, bench_data, 32, (TCP_HDR_FLAG_PSH | TCP_HDR_FLAG_ACK));
+
+    for (i = 0; i < BENCH_BULK_SEGMENTS; i++)
+    {
+        /* Send a segment. */
+        ppp_vj_bench_send(result, &conn, BENCH_SERVER, bench_data, BENCH_MSS, TCP_HDR_FLAG_ACK);
+
+        /* ACK every other segment, window is opened on every fourth. */
+        if (i & 0x1)
+        {
+            conn.window[BENCH_CLIENT] = (uint16_t)((i & 0x2) ? 4096 : (4096 - (BENCH_MSS * 2)));
+            ppp_vj_bench_send(result, &conn, BENCH_CLIENT, NULL, 0, TCP_HDR_FLAG_ACK);
+        }
+    }
+
+    /* Close the connection. */
+    ppp_vj_bench_close(result, &conn, BENCH_SERVER);
+
+} /* ppp_vj_bench_bulk */
+
+/*
+ * ppp_vj_bench_bulk_ts
+ * @result: Results for this session.
+ * This function will replay the bulk transfer with TCP timestamps.
+ */
+static void ppp_vj_bench_bulk_ts(BENCH_RESULT *result)
+{
+    /* Replay the bulk transfer with timestamps. */
+    bench_timestamps = TRUE;
+    ppp_vj_bench_bulk(result);
+    bench_timestamps = FALSE;
+
+} /* ppp_vj_bench_bulk_ts */
+
+/*
+ * ppp_vj_bench_web
+ * @result: Results for this session.
+ * This function will replay a number of short transfers in parallel, each
+ * with a request from the client and a response from the server.
+ */
+static void ppp_vj_bench_web(BENCH_RESULT *result)
+{
+    BENCH_CONN conn[BENCH_WEB_CONNS];
+    uint32_t i, seg;
+
+    /* Open all the connections and send requests. */
+    for (i = 0; i < BENCH_WEB_CONNS; i++)
+    {
+        ppp_vj_bench_open(result, &conn[i], (i + 2));
+    }
+    for (i = 0; i < BENCH_WEB_CONNS; i++)
+    {
+        ppp_vj_bench_send(result, &conn[i], BENCH_CLIENT, bench_data, BENCH_WEB_REQUEST, (TCP_HDR_FLAG_PSH | TCP_HDR_FLAG_ACK));
+    }
+
+    /* Send the responses, interleaved. */
+    for (seg = 0; seg < BENCH_WEB_SEGMENTS; seg++)
+    {
+        for (i = 0; i < BENCH_WEB_CONNS; i++)
+        {
+            ppp_vj_bench_send(result, &conn[i], BENCH_SERVER, bench_data, BENCH_MSS, ((seg == (BENCH_WEB_SEGMENTS - 1)) ? (TCP_HDR_FLAG_PSH | TCP_HDR_FLAG_ACK) : TCP_HDR_FLAG_ACK));
+
+            /* ACK every other segment. */
+            if (seg & 0x1)
+            {
+                ppp_vj_bench_send(result, &conn[i], BENCH_CLIENT, NULL, 0, TCP_HDR_FLAG_ACK);
+            }
+        }
+    }
+
+    /* Close all the connections. */
+    for (i = 0; i < BENCH_WEB_CONNS; i++)
+    {
+        ppp_vj_bench_close(result, &conn[i], BENCH_SERVER);
+    }
+
+} /* ppp_vj_bench_web */
+
+/*
+ * ppp_vj_bench_run
+ * @name: Name of this session.
+ * @session: Session needed to be replayed.
+ * This function will replay a session and print the results.
+ */
+static void ppp_vj_bench_run(char *name, void (*session)(BENCH_RESULT *))
+{
+    BENCH_RESULT result;
+    uint32_t saved;
+
+    /* Reset the VJ state at both ends. */
+    ppp_vj_init(&bench_vj[BENCH_CLIENT]);
+    ppp_vj_init(&bench_vj[BENCH_SERVER]);
+    ppp_vj_tx_configure(&bench_vj[BENCH_CLIENT], PPP_VJ_SLOTS, TRUE);
+    ppp_vj_tx_configure(&bench_vj[BENCH_SERVER], PPP_VJ_SLOTS, TRUE);
+
+    /* Replay this session. */
+    memset(&result, 0, sizeof(BENCH_RESULT));
+    session(&result);
+
+    /* Print the results, if most of the frames are sent uncompressed VJ can
+     * also take more bytes after escaping. */
+    saved = (uint32_t)((((uint64_t)((result.plain > result.vj) ? (result.plain - result.vj) : (result.vj - result.plain))) * 1000) / result.plain);
+    printf("%s: %lu packets (%lu compressed, %lu uncompressed), %lu bytes without VJ, %lu bytes with VJ, %lu.%lu%% %s\r\n", name,
+           (unsigned long)result.packets, (unsigned long)result.comp, (unsigned long)result.uncomp,
+           (unsigned long)result.plain, (unsigned long)result.vj, (unsigned long)(saved / 10), (unsigned long)(saved % 10),
+           ((result.plain >= result.vj) ? "saved" : "more"));
+
+} /* ppp_vj_bench_run */
+
+void ppp_vj_bench_task(void *argv)
+{
+    uint32_t i;
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(argv);
+
+    /* Synthesize the data. */
+    for (i = 0; i < BENCH_MSS; i++)
+    {
+        bench_data[i] = (uint8_t)('a' + (i % 26));
+    }
+
+    /* Clear the file descriptor. */
+    memset(&bench_fd, 0, sizeof(BENCH_FD));
+
+    /* Set buffer data for our file descriptor. */
+    bench_fd.buffer_data.buffer_space = bench_space;
+    bench_fd.buffer_data.buffer_size = BENCH_BUFFER_SIZE;
+    bench_fd.buffer_data.buffers = bench_buffers;
+    bench_fd.buffer_data.num_buffers = BENCH_NUM_BUFFERS;
+    bench_fd.buffer_data.buffer_lists = bench_fd.lists;
+    bench_fd.buffer_data.num_buffer_lists = BENCH_NUM_LISTS;
+    fs_buffer_dataset(&bench_fd.fs, &bench_fd.buffer_data);
+
+    for (;;)
+    {
+        /* Replay all the sessions. */
+        ppp_vj_bench_run("interactive", &ppp_vj_bench_interactive);
+        ppp_vj_bench_run("bulk", &ppp_vj_bench_bulk);
+        ppp_vj_bench_run("bulk with timestamps", &ppp_vj_bench_bulk_ts);
+        ppp_vj_bench_run("interleaved", &ppp_vj_bench_web);
+
+        /* Wait before running the benchmark again. */
+        sleep_ticks(SOFT_TICKS_PER_SEC);
+    }
+}
+
+int main(void)
+{
+    memset(&ppp_vj_bench_cb, 0, sizeof(TASK));
+
+    /* Initialize scheduler. */
+    scheduler_init();
+
+    /* Initialize file system. */
+    fs_init();
+
+    /* Initialize serial. */
+    serial_init();
+
+    /* Create a task for VJ benchmark. */
+    task_create(&ppp_vj_bench_cb, P_STR("BENCH"), ppp_vj_bench_stack, DEMO_STACK_SIZE, &ppp_vj_bench_task, (void *)(NULL), 0);
+    scheduler_task_add(&ppp_vj_bench_cb, 5);
+
+    /* Run scheduler. */
+    kernel_run();
+
+    return (0);
+
+}
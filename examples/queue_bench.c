@@ -0,0 +1,288 @@
+/*
+ * queue_bench.c
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+#include <stdio.h>
+#include <string.h>
+#include <fs.h>
+#include <serial.h>
+#include <queue.h>
+#include <pipe.h>
+
+/* This demo will measure the throughput of passing 4, 16 and 64 byte items
+ * from a producer task to a consumer task through a queue, once with the
+ * copying and once with the zero copy APIs, and through a pipe using file
+ * system read and write, which call pipe_read and pipe_write under the pipe
+ * lock. Both the tasks have same priority, producer yields when the queue is
+ * full and blocks when the pipe is full, while consumer blocks when there is
+ * no data. Each item carries a sequence number that is verified by the
+ * consumer and average time taken to pass an item is printed. */
+
+/* Demo configurations. */
+#define DEMO_STACK_SIZE     1024
+#define BENCH_ITEMS         100000
+#define BENCH_QUEUE_ITEMS   64
+#define BENCH_MAX_ITEM_SIZE 64
+
+/* Benchmark modes. */
+#define BENCH_MODE_COPY     (0)
+#define BENCH_MODE_ZERO     (1)
+#define BENCH_MODE_PIPE     (2)
+
+/* Use the hardware tick if we don't have a cycle counter. */
+#ifdef CPU_CYCLE_COUNT
+#define BENCH_TIMESTAMP()   (uint32_t)CPU_CYCLE_COUNT()
+#else
+#define BENCH_TIMESTAMP()   (uint32_t)current_hardware_tick()
+#endif /* CPU_CYCLE_COUNT */
+
+/* Function prototypes. */
+void queue_bench_task(void *);
+void queue_bench_consumer_task(void *);
+static void queue_bench_produce(uint32_t);
+static uint32_t queue_bench_run(uint8_t, uint32_t);
+
+/* Benchmark task stacks. */
+TASK queue_bench_cb;
+uint8_t queue_bench_stack[DEMO_STACK_SIZE];
+TASK queue_bench_consumer_cb;
+uint8_t queue_bench_consumer_stack[DEMO_STACK_SIZE];
+
+/* Benchmark data. */
+static QUEUE bench_queue;
+static uint8_t bench_queue_space[BENCH_QUEUE_ITEMS * BENCH_MAX_ITEM_SIZE];
+static PIPE bench_pipe;
+static uint8_t bench_pipe_space[BENCH_QUEUE_ITEMS * (BENCH_MAX_ITEM_SIZE + sizeof(MSG_DATA))];
+static SEMAPHORE bench_start, bench_done;
+static volatile uint8_t bench_mode;
+static volatile uint32_t bench_item_size;
+static volatile uint32_t bench_num_errors;
+
+/*
+ * queue_bench_produce
+ * @item_size: Size of an item.
+ * This function will send the benchmark items in the current mode.
+ */
+static void queue_bench_produce(uint32_t item_size)
+{
+    uint32_t i, item[BENCH_MAX_ITEM_SIZE / sizeof(uint32_t)];
+    uint32_t *slot;
+
+    /* Initialize item data. */
+    memset(item, 0, sizeof(item));
+
+    for (i = 0; i < BENCH_ITEMS; i++)
+    {
+        /* Send this item in the current mode. */
+        switch (bench_mode)
+        {
+        case BENCH_MODE_COPY:
+
+            /* Copy the item in the queue, yield while queue is full. */
+            item[0] = i;
+            while (queue_write(&bench_queue, item) != SUCCESS)
+            {
+                task_yield();
+            }
+
+            break;
+
+        case BENCH_MODE_ZERO:
+
+            /* Reserve an item in the queue, yield while queue is full. */
+            while ((slot = (uint32_t *)queue_reserve(&bench_queue)) == NULL)
+            {
+                task_yield();
+            }
+
+            /* Populate the item in place and commit it. */
+            slot[0] = i;
+            queue_commit(&bench_queue);
+
+            break;
+
+        default:
+
+            /* Write the item on the pipe, this blocks while pipe is full. */
+            item[0] = i;
+            while (fs_write((FD)&bench_pipe, (uint8_t *)item, (int32_t)item_size) != (int32_t)item_size) ;
+
+            break;
+        }
+    }
+
+} /* queue_bench_produce */
+
+/*
+ * queue_bench_run
+ * @mode: Mode in which items are needed to be sent.
+ * @item_size: Size of an item.
+ * @return: Returns the average time taken to pass an item.
+ * This function will pass the benchmark items to the consumer task and will
+ * return the average time taken to pass an item.
+ */
+static uint32_t queue_bench_run(uint8_t mode, uint32_t item_size)
+{
+    uint32_t start;
+
+    /* Initialize the queue for this item size. */
+    queue_create(&bench_queue, bench_queue_space, item_size, BENCH_QUEUE_ITEMS);
+
+    /* Start the consumer. */
+    bench_mode = mode;
+    bench_item_size = item_size;
+    semaphore_release(&bench_start);
+
+    /* Send all the items and wait for the consumer to receive them. */
+    start = BENCH_TIMESTAMP();
+    queue_bench_produce(item_size);
+    ASSERT(semaphore_obtain(&bench_done, MAX_WAIT) != SUCCESS);
+
+    /* Return the average time taken to pass an item. */
+    return ((BENCH_TIMESTAMP() - start) / BENCH_ITEMS);
+
+} /* queue_bench_run */
+
+void queue_bench_consumer_task(void *argv)
+{
+    uint32_t i, item[BENCH_MAX_ITEM_SIZE / sizeof(uint32_t)];
+    uint32_t *slot;
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(argv);
+
+    for (;;)
+    {
+        /* Wait for the producer to start a run. */
+        ASSERT(semaphore_obtain(&bench_start, MAX_WAIT) != SUCCESS);
+
+        for (i = 0; i < BENCH_ITEMS; i++)
+        {
+            /* Receive this item in the current mode. */
+            switch (bench_mode)
+            {
+            case BENCH_MODE_COPY:
+
+                /* Copy the item from the queue. */
+                ASSERT(queue_read(&bench_queue, item, MAX_WAIT) != SUCCESS);
+                slot = item;
+
+                break;
+
+            case BENCH_MODE_ZERO:
+
+                /* Wait for an item and process it in place. */
+                while ((slot = (uint32_t *)queue_peek(&bench_queue)) == NULL)
+                {
+                    ASSERT(queue_wait(&bench_queue, MAX_WAIT) != SUCCESS);
+                }
+
+                break;
+
+            default:
+
+                /* Read the item from the pipe, this blocks while pipe is
+                 * empty. */
+                while (fs_read((FD)&bench_pipe, (uint8_t *)item, (int32_t)bench_item_size) != (int32_t)bench_item_size) ;
+                slot = item;
+
+                break;
+            }
+
+            /* Verify the sequence number of this item. */
+            if (slot[0] != i)
+            {
+                bench_num_errors ++;
+            }
+
+            /* If we processed the item in place. */
+            if (bench_mode == BENCH_MODE_ZERO)
+            {
+                /* Free this item. */
+                queue_release(&bench_queue);
+            }
+        }
+
+        /* Tell the producer that all the items were received. */
+        semaphore_release(&bench_done);
+    }
+}
+
+void queue_bench_task(void *argv)
+{
+    static const uint32_t item_sizes[] = {4, 16, BENCH_MAX_ITEM_SIZE};
+    uint32_t i, copy, zero, pipe;
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(argv);
+
+    for (;;)
+    {
+        for (i = 0; i < (sizeof(item_sizes) / sizeof(uint32_t)); i++)
+        {
+            /* Run the benchmark. */
+            bench_num_errors = 0;
+            copy = queue_bench_run(BENCH_MODE_COPY, item_sizes[i]);
+            zero = queue_bench_run(BENCH_MODE_ZERO, item_sizes[i]);
+            pipe = queue_bench_run(BENCH_MODE_PIPE, item_sizes[i]);
+
+            /* Print the results. */
+            if (bench_num_errors == 0)
+            {
+                printf("%lu byte items: queue copy %lu, queue zero copy %lu, pipe %lu\r\n", (unsigned long)item_sizes[i], (unsigned long)copy, (unsigned long)zero, (unsigned long)pipe);
+            }
+            else
+            {
+                printf("%lu byte items: FAILED, %lu items out of order\r\n", (unsigned long)item_sizes[i], (unsigned long)bench_num_errors);
+            }
+        }
+
+        /* Wait before running the benchmark again. */
+        sleep_ticks(SOFT_TICKS_PER_SEC);
+    }
+}
+
+int main(void)
+{
+    memset(&queue_bench_cb, 0, sizeof(TASK));
+    memset(&queue_bench_consumer_cb, 0, sizeof(TASK));
+
+    /* Initialize the semaphores used to synchronize the runs. */
+    semaphore_create(&bench_start, 0);
+    semaphore_create(&bench_done, 0);
+
+    /* Initialize scheduler. */
+    scheduler_init();
+
+    /* Initialize file system. */
+    fs_init();
+
+    /* Initialize serial. */
+    serial_init();
+
+    /* Create the pipe. */
+    pipe_create(&bench_pipe, "\\bench", bench_pipe_space, sizeof(bench_pipe_space));
+
+    /* Create a task for queue benchmark. */
+    task_create(&queue_bench_cb, P_STR("BENCH"), queue_bench_stack, DEMO_STACK_SIZE, &queue_bench_task, (void *)(NULL), 0);
+    scheduler_task_add(&queue_bench_cb, 5);
+
+    /* Create the consumer task with same priority. */
+    task_create(&queue_bench_consumer_cb, P_STR("CONSUMER"), queue_bench_consumer_stack, DEMO_STACK_SIZE, &queue_bench_consumer_task, (void *)(NULL), 0);
+    scheduler_task_add(&queue_bench_consumer_cb, 5);
+
+    /* Run scheduler. */
+    kernel_run();
+
+    return (0);
+
+}
@@ -0,0 +1,334 @@
+/*
+ * scheduler_test.c
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+#include <stdio.h>
+#include <string.h>
+#include <fs.h>
+#include <serial.h>
+
+/* This test will drive the scheduler's ready list through a random sequence
+ * of adding, yielding and popping dummy tasks, and changing their priority if
+ * SEMAPHORE_PRIORITY_INHERIT is enabled, and will verify the order in
+ * which tasks are popped against a reference model, i.e. highest priority
+ * first and tasks with same priority in the order they were made ready. The
+ * same sequence is used for all the builds, so running this with
+ * SCHEDULER_BITMAP enabled and disabled verifies that both ready list
+ * implementations pop tasks in the same order, a checksum of the pop order is
+ * also printed so that the two runs can be compared. Dummy tasks always have
+ * a higher priority than the idle task, so the test never pops a real task. */
+
+/* Test configurations. */
+#define DEMO_STACK_SIZE     1024
+#define TEST_NUM_TASKS      64
+#define TEST_NUM_OPS        100000
+#define TEST_OPS_PER_BATCH  256
+
+/* Test operations. */
+#define TEST_OP_ADD         (0)
+#define TEST_OP_YIELD       (1)
+#define TEST_OP_POP         (2)
+#define TEST_OP_PRIORITY    (3)
+
+/* Function prototypes. */
+void scheduler_test_task(void *);
+static uint32_t scheduler_test_random(void);
+static void scheduler_test_model_add(TASK *);
+static TASK *scheduler_test_model_pop(void);
+#ifdef SEMAPHORE_PRIORITY_INHERIT
+static void scheduler_test_model_remove(TASK *);
+#endif /* SEMAPHORE_PRIORITY_INHERIT */
+static uint8_t scheduler_test_pop(uint32_t *);
+static uint8_t scheduler_test_run(uint32_t, uint32_t *);
+
+/* Test task stack. */
+TASK scheduler_test_cb;
+uint8_t scheduler_test_stack[DEMO_STACK_SIZE];
+
+/* Test data. */
+static TASK test_tasks[TEST_NUM_TASKS];
+static TASK *test_model[TEST_NUM_TASKS];
+static uint32_t test_model_num;
+static TASK *test_running;
+static uint32_t test_seed;
+
+/*
+ * scheduler_test_random
+ * @return: Returns a pseudo random number.
+ * This function will return a pseudo random number.
+ */
+static uint32_t scheduler_test_random(void)
+{
+    /* Update the seed. */
+    test_seed = (test_seed * 1103515245) + 12345;
+
+    /* Return the random number. */
+    return ((test_seed >> 16) | (test_seed << 16));
+
+} /* scheduler_test_random */
+
+/*
+ * scheduler_test_model_add
+ * @tcb: Task to be added on the reference ready list.
+ * This function will add a task on the reference ready list after all the
+ * tasks with higher or same priority.
+ */
+static void scheduler_test_model_add(TASK *tcb)
+{
+    uint32_t i = test_model_num;
+
+    /* Move the tasks with lower priority one place down. */
+    while ((i > 0) && (test_model[i - 1]->priority > tcb->priority))
+    {
+        test_model[i] = test_model[i - 1];
+        i--;
+    }
+
+    /* Add this task here. */
+    test_model[i] = tcb;
+    test_model_num++;
+
+} /* scheduler_test_model_add */
+
+/*
+ * scheduler_test_model_pop
+ * @return: Returns the task at the head of the reference ready list.
+ * This function will remove and return the task at the head of the reference
+ * ready list.
+ */
+static TASK *scheduler_test_model_pop(void)
+{
+    TASK *tcb = test_model[0];
+
+    /* Remove this task from the reference ready list. */
+    test_model_num--;
+    memmove(&test_model[0], &test_model[1], (sizeof(TASK *) * test_model_num));
+
+    /* Return the task at the head. */
+    return (tcb);
+
+} /* scheduler_test_model_pop */
+
+#ifdef SEMAPHORE_PRIORITY_INHERIT
+/*
+ * scheduler_test_model_remove
+ * @tcb: Task to be removed from the reference ready list.
+ * This function will remove a task from the reference ready list.
+ */
+static void scheduler_test_model_remove(TASK *tcb)
+{
+    uint32_t i;
+
+    /* Find this task on the reference ready list. */
+    for (i = 0; (i < test_model_num) && (test_model[i] != tcb); i++) ;
+
+    /* Remove this task from the reference ready list. */
+    test_model_num--;
+    memmove(&test_model[i], &test_model[i + 1], (sizeof(TASK *) * (test_model_num - i)));
+
+} /* scheduler_test_model_remove */
+#endif /* SEMAPHORE_PRIORITY_INHERIT */
+
+/*
+ * scheduler_test_pop
+ * @checksum: Checksum of the pop order, will be updated for the popped task.
+ * @return: Returns TRUE if the popped task was the one expected by the
+ *  reference model, otherwise FALSE will be returned.
+ * This function will pop the next task from the ready list and from the
+ * reference ready list and will verify that both are same.
+ */
+static uint8_t scheduler_test_pop(uint32_t *checksum)
+{
+    TASK *tcb, *expected;
+
+    /* Pop the next task from both the ready lists. */
+    tcb = scheduler_get_next_task();
+    expected = scheduler_test_model_pop();
+
+    /* Update the checksum of the pop order. */
+    *checksum = ((*checksum ^ (uint32_t)(tcb - test_tasks)) * 0x01000193);
+
+    /* This task is now running. */
+    test_running = tcb;
+
+    /* Return if we popped the expected task. */
+    return ((tcb == expected) ? TRUE : FALSE);
+
+} /* scheduler_test_pop */
+
+/*
+ * scheduler_test_run
+ * @num_ops: Number of operations to be performed.
+ * @checksum: Checksum of the pop order will be returned here.
+ * @return: Returns TRUE if all the tasks were popped in the order of the
+ *  reference model, otherwise FALSE will be returned.
+ * This function will perform the given number of random operations on the
+ * ready list and verify the order in which tasks are popped. Operations are
+ * performed in batches, each starting with no dummy task on the ready list
+ * and ending after all the dummy tasks are popped.
+ */
+static uint8_t scheduler_test_run(uint32_t num_ops, uint32_t *checksum)
+{
+    INT_LVL interrupt_level;
+    TASK *tcb;
+    uint32_t i, n, num_free;
+    uint8_t match = TRUE;
+
+    /* Initialize the checksum. */
+    *checksum = 0x811C9DC5;
+
+    for (i = 0; (match == TRUE) && (i < num_ops); i += TEST_OPS_PER_BATCH)
+    {
+        /* Initialize dummy tasks and the reference ready list. */
+        memset(test_tasks, 0, sizeof(test_tasks));
+        test_model_num = 0;
+        test_running = NULL;
+        num_free = TEST_NUM_TASKS;
+
+        /* Dummy tasks must not be scheduled, so disable interrupts while they
+         * are on the ready list. */
+        interrupt_level = GET_INTERRUPT_LEVEL();
+        DISABLE_INTERRUPTS();
+
+        for (n = 0; (match == TRUE) && (n < TEST_OPS_PER_BATCH); n++)
+        {
+            /* Perform a random operation. */
+            switch (scheduler_test_random() % 4)
+            {
+            case TEST_OP_ADD:
+
+                /* If we have a task that is not yet on the ready list. */
+                if (num_free > 0)
+                {
+                    /* Add a new task with a random priority. */
+                    tcb = &test_tasks[TEST_NUM_TASKS - num_free];
+                    tcb->priority = (uint8_t)(scheduler_test_random() % (SCHEDULER_MAX_PRI + 1));
+                    num_free--;
+
+                    scheduler_task_yield(tcb, YIELD_SYSTEM);
+                    scheduler_test_model_add(tcb);
+                }
+
+                break;
+
+            case TEST_OP_YIELD:
+
+                /* If a task was popped, yield it back. */
+                if (test_running != NULL)
+                {
+                    scheduler_task_yield(test_running, YIELD_SYSTEM);
+                    scheduler_test_model_add(test_running);
+                    test_running = NULL;
+                }
+
+                break;
+
+#ifdef SEMAPHORE_PRIORITY_INHERIT
+            case TEST_OP_PRIORITY:
+
+                /* If we have a task on the ready list. */
+                if (test_model_num > 0)
+                {
+                    /* Change priority of a random task on the ready list. */
+                    tcb = test_model[scheduler_test_random() % test_model_num];
+                    scheduler_test_model_remove(tcb);
+                    scheduler_task_set_priority(tcb, (uint8_t)(scheduler_test_random() % (SCHEDULER_MAX_PRI + 1)));
+                    scheduler_test_model_add(tcb);
+                }
+
+                break;
+#endif /* SEMAPHORE_PRIORITY_INHERIT */
+
+            default:
+
+                /* If we have a task on the ready list and no task is running. */
+                if ((test_model_num > 0) && (test_running == NULL))
+                {
+                    /* Pop the next task. */
+                    match = scheduler_test_pop(checksum);
+                }
+
+                break;
+            }
+        }
+
+        /* Remove all the dummy tasks from the ready list before restoring
+         * interrupts, this is also done if there was a mismatch. */
+        while (test_model_num > 0)
+        {
+            if (scheduler_test_pop(checksum) == FALSE)
+            {
+                match = FALSE;
+            }
+        }
+
+        /* Restore old interrupt level. */
+        SET_INTERRUPT_LEVEL(interrupt_level);
+    }
+
+    /* Return if pop order matched the reference model. */
+    return (match);
+
+} /* scheduler_test_run */
+
+void scheduler_test_task(void *argv)
+{
+    uint32_t round = 0, checksum;
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(argv);
+
+    for (;;)
+    {
+        /* Use a different sequence for each round. */
+        test_seed = 0x1234567 + round;
+
+        /* Run the test and print the result. */
+        if (scheduler_test_run(TEST_NUM_OPS, &checksum) == TRUE)
+        {
+            printf("round %lu: %lu operations passed, pop order checksum 0x%08lX\r\n", (unsigned long)round, (unsigned long)TEST_NUM_OPS, (unsigned long)checksum);
+        }
+        else
+        {
+            printf("round %lu: FAILED, pop order does not match the reference\r\n", (unsigned long)round);
+        }
+
+        round++;
+
+        /* Wait before running the test again. */
+        sleep_ticks(SOFT_TICKS_PER_SEC);
+    }
+}
+
+int main(void)
+{
+    memset(&scheduler_test_cb, 0, sizeof(TASK));
+
+    /* Initialize scheduler. */
+    scheduler_init();
+
+    /* Initialize file system. */
+    fs_init();
+
+    /* Initialize serial. */
+    serial_init();
+
+    /* Create a task for scheduler test. */
+    task_create(&scheduler_test_cb, P_STR("TEST"), scheduler_test_stack, DEMO_STACK_SIZE, &scheduler_test_task, (void *)(NULL), 0);
+    scheduler_task_add(&scheduler_test_cb, 5);
+
+    /* Run scheduler. */
+    kernel_run();
+
+    return (0);
+
+}
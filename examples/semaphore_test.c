@@ -0,0 +1,548 @@
+/*
+ * semaphore_test.c
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+#include <stdio.h>
+#include <string.h>
+#include <fs.h>
+#include <serial.h>
+#include <semaphore.h>
+
+/* This test will verify priority inheritance of the semaphores. A control
+ * task drives a low, a medium and two high priority worker tasks and checks
+ * the priority of the low priority task while it holds priority inheriting
+ * semaphores and a high priority task that was waiting on it:
+ *  times out,
+ *  obtains one of the two semaphores it holds, while an other task is still
+ *  waiting on the other one,
+ *  is resumed as the semaphore was deleted.
+ * It will also check that the low priority task, once raised while it is
+ * itself waiting on a priority inheriting semaphore, is resumed before a
+ * medium priority task waiting on the same semaphore.
+ * It will then measure the worst case blocking of a high priority task on a
+ * semaphore held by the low priority task for a critical section, while a
+ * medium priority task is running for much longer than the critical section.
+ * With priority inheritance the high priority task must not be blocked for
+ * longer than the critical section. */
+
+/* Test configurations. */
+#define DEMO_STACK_SIZE     1024
+#define TEST_TIMEOUT        10
+#define TEST_CRITICAL       20
+#define TEST_MEDIUM_SPIN    100
+
+/* Task priorities. */
+#define TEST_PRI_CONTROL    2
+#define TEST_PRI_HIGH       5
+#define TEST_PRI_HIGH2      7
+#define TEST_PRI_MEDIUM     10
+#define TEST_PRI_LOW        20
+
+/* Worker operations. */
+#define TEST_OP_NONE        (0)
+#define TEST_OP_OBTAIN      (1)
+#define TEST_OP_RELEASE     (2)
+#define TEST_OP_CRITICAL    (3)
+#define TEST_OP_SPIN        (4)
+
+/* A worker task. */
+typedef struct _test_worker
+{
+    /* Worker task control block. */
+    TASK        cb;
+
+    /* Semaphore on which worker waits for an operation. */
+    SEMAPHORE   go;
+
+    /* Semaphore to be used by the operation. */
+    SEMAPHORE   *semaphore;
+
+    /* Number of ticks to wait or spin. */
+    uint32_t    ticks;
+
+    /* Status and number of ticks blocked for the last obtain. */
+    int32_t     status;
+    uint32_t    blocked;
+
+    /* Operation to be performed and if it is done. */
+    volatile uint8_t    op;
+    volatile uint8_t    done;
+
+    /* Structure padding. */
+    uint8_t     pad[2];
+
+    /* Worker task stack. */
+    uint8_t     stack[DEMO_STACK_SIZE];
+
+} TEST_WORKER;
+
+/* Function prototypes. */
+void semaphore_test_task(void *);
+void semaphore_test_worker(void *);
+static void semaphore_test_worker_create(TEST_WORKER *, P_STR_T, uint8_t);
+static void semaphore_test_command(TEST_WORKER *, uint8_t, SEMAPHORE *, uint32_t);
+static void semaphore_test_wait(TEST_WORKER *);
+static void semaphore_test_spin(uint32_t);
+static uint8_t semaphore_test_timeout(void);
+static uint8_t semaphore_test_release(void);
+static uint8_t semaphore_test_delete(void);
+static uint8_t semaphore_test_order(void);
+static uint32_t semaphore_test_blocking(void);
+
+/* Test task stack. */
+TASK semaphore_test_cb;
+uint8_t semaphore_test_stack[DEMO_STACK_SIZE];
+
+/* Test data. */
+static TEST_WORKER test_high, test_high2, test_medium, test_low;
+static SEMAPHORE test_sem_a, test_sem_b;
+
+/*
+ * semaphore_test_spin
+ * @ticks: Number of ticks to spin.
+ * This function will keep the CPU busy for the given number of ticks.
+ */
+static void semaphore_test_spin(uint32_t ticks)
+{
+    uint32_t start = current_system_tick();
+
+    /* Spin till the required ticks are elapsed. */
+    while ((current_system_tick() - start) < ticks) ;
+
+} /* semaphore_test_spin */
+
+/*
+ * semaphore_test_command
+ * @worker: Worker task that will perform the operation.
+ * @op: Operation to be performed.
+ * @semaphore: Semaphore to be used by the operation.
+ * @ticks: Number of ticks to wait or spin.
+ * This function will ask a worker task to perform an operation, the worker
+ * will run when it is the highest priority task ready.
+ */
+static void semaphore_test_command(TEST_WORKER *worker, uint8_t op, SEMAPHORE *semaphore, uint32_t ticks)
+{
+    /* Setup the operation. */
+    worker->op = op;
+    worker->semaphore = semaphore;
+    worker->ticks = ticks;
+    worker->done = FALSE;
+
+    /* Resume the worker. */
+    semaphore_release(&worker->go);
+
+} /* semaphore_test_command */
+
+/*
+ * semaphore_test_wait
+ * @worker: Worker task for which we need to wait.
+ * This function will wait for a worker to complete it's operation.
+ */
+static void semaphore_test_wait(TEST_WORKER *worker)
+{
+    /* While worker has not completed the operation. */
+    while (worker->done == FALSE)
+    {
+        /* Let the worker run. */
+        sleep_ticks(1);
+    }
+
+} /* semaphore_test_wait */
+
+void semaphore_test_worker(void *argv)
+{
+    TEST_WORKER *worker = (TEST_WORKER *)argv;
+    uint32_t start;
+
+    for (;;)
+    {
+        /* Wait for an operation. */
+        ASSERT(semaphore_obtain(&worker->go, MAX_WAIT) != SUCCESS);
+
+        switch (worker->op)
+        {
+        case TEST_OP_OBTAIN:
+
+            /* Obtain the semaphore and save the time we were blocked. */
+            start = current_system_tick();
+            worker->status = semaphore_obtain(worker->semaphore, worker->ticks);
+            worker->blocked = current_system_tick() - start;
+
+            break;
+
+        case TEST_OP_RELEASE:
+
+            /* Release the semaphore. */
+            semaphore_release(worker->semaphore);
+
+            break;
+
+        case TEST_OP_CRITICAL:
+
+            /* Hold the semaphore while keeping the CPU busy. */
+            worker->status = semaphore_obtain(worker->semaphore, MAX_WAIT);
+            semaphore_test_spin(worker->ticks);
+            semaphore_release(worker->semaphore);
+
+            break;
+
+        case TEST_OP_SPIN:
+
+            /* Keep the CPU busy. */
+            semaphore_test_spin(worker->ticks);
+
+            break;
+
+        default:
+            break;
+        }
+
+        /* Operation is done. */
+        worker->done = TRUE;
+    }
+}
+
+/*
+ * semaphore_test_timeout
+ * @return: Returns TRUE if the test passed, otherwise FALSE will be returned.
+ * This function will verify that the owner of a semaphore drops the priority
+ * it inherited from a task that timed out waiting on the semaphore.
+ */
+static uint8_t semaphore_test_timeout(void)
+{
+    uint8_t passed = TRUE;
+
+    semaphore_create(&test_sem_a, 1);
+    semaphore_set_inherit(&test_sem_a);
+
+    /* Low priority task obtains the semaphore and high priority task waits
+     * on it with a timeout. */
+    semaphore_test_command(&test_low, TEST_OP_OBTAIN, &test_sem_a, MAX_WAIT);
+    semaphore_test_wait(&test_low);
+    semaphore_test_command(&test_high, TEST_OP_OBTAIN, &test_sem_a, TEST_TIMEOUT);
+    sleep_ticks(TEST_TIMEOUT / 2);
+
+    /* Owner must have inherited the priority of the waiting task. */
+    if (test_low.cb.priority != TEST_PRI_HIGH)
+    {
+        passed = FALSE;
+    }
+
+    /* Owner must be restored once the waiting task times out. */
+    semaphore_test_wait(&test_high);
+    if ((test_high.status != CONDITION_TIMEOUT) || (test_low.cb.priority != TEST_PRI_LOW))
+    {
+        passed = FALSE;
+    }
+
+    /* Release the semaphore. */
+    semaphore_test_command(&test_low, TEST_OP_RELEASE, &test_sem_a, 0);
+    semaphore_test_wait(&test_low);
+
+    /* Return if the test passed. */
+    return (passed);
+
+} /* semaphore_test_timeout */
+
+/*
+ * semaphore_test_release
+ * @return: Returns TRUE if the test passed, otherwise FALSE will be returned.
+ * This function will verify that the owner of two semaphores keeps the
+ * priority of the task waiting on the one it still holds, when it releases
+ * the other one.
+ */
+static uint8_t semaphore_test_release(void)
+{
+    uint8_t passed = TRUE;
+
+    semaphore_create(&test_sem_a, 1);
+    semaphore_set_inherit(&test_sem_a);
+    semaphore_create(&test_sem_b, 1);
+    semaphore_set_inherit(&test_sem_b);
+
+    /* Low priority task obtains both the semaphores and the high priority
+     * tasks wait on them. */
+    semaphore_test_command(&test_low, TEST_OP_OBTAIN, &test_sem_a, MAX_WAIT);
+    semaphore_test_wait(&test_low);
+    semaphore_test_command(&test_low, TEST_OP_OBTAIN, &test_sem_b, MAX_WAIT);
+    semaphore_test_wait(&test_low);
+    semaphore_test_command(&test_high, TEST_OP_OBTAIN, &test_sem_a, MAX_WAIT);
+    semaphore_test_command(&test_high2, TEST_OP_OBTAIN, &test_sem_b, MAX_WAIT);
+    sleep_ticks(1);
+
+    /* Owner must have inherited the highest priority. */
+    if (test_low.cb.priority != TEST_PRI_HIGH)
+    {
+        passed = FALSE;
+    }
+
+    /* Release the first semaphore, owner must now run at the priority of the
+     * task waiting on the second semaphore. */
+    semaphore_test_command(&test_low, TEST_OP_RELEASE, &test_sem_a, 0);
+    semaphore_test_wait(&test_low);
+    semaphore_test_wait(&test_high);
+    if ((test_high.status != SUCCESS) || (test_low.cb.priority != TEST_PRI_HIGH2))
+    {
+        passed = FALSE;
+    }
+
+    /* Release the second semaphore, owner must now run at it's own
+     * priority. */
+    semaphore_test_command(&test_low, TEST_OP_RELEASE, &test_sem_b, 0);
+    semaphore_test_wait(&test_low);
+    semaphore_test_wait(&test_high2);
+    if ((test_high2.status != SUCCESS) || (test_low.cb.priority != TEST_PRI_LOW))
+    {
+        passed = FALSE;
+    }
+
+    /* Release the semaphores. */
+    semaphore_test_command(&test_high, TEST_OP_RELEASE, &test_sem_a, 0);
+    semaphore_test_wait(&test_high);
+    semaphore_test_command(&test_high2, TEST_OP_RELEASE, &test_sem_b, 0);
+    semaphore_test_wait(&test_high2);
+
+    /* Return if the test passed. */
+    return (passed);
+
+} /* semaphore_test_release */
+
+/*
+ * semaphore_test_delete
+ * @return: Returns TRUE if the test passed, otherwise FALSE will be returned.
+ * This function will verify that the owner of a semaphore drops the priority
+ * it inherited when the semaphore is deleted.
+ */
+static uint8_t semaphore_test_delete(void)
+{
+    uint8_t passed = TRUE;
+
+    semaphore_create(&test_sem_a, 1);
+    semaphore_set_inherit(&test_sem_a);
+
+    /* Low priority task obtains the semaphore and high priority task waits
+     * on it. */
+    semaphore_test_command(&test_low, TEST_OP_OBTAIN, &test_sem_a, MAX_WAIT);
+    semaphore_test_wait(&test_low);
+    semaphore_test_command(&test_high, TEST_OP_OBTAIN, &test_sem_a, MAX_WAIT);
+    sleep_ticks(1);
+
+    /* Owner must have inherited the priority of the waiting task. */
+    if (test_low.cb.priority != TEST_PRI_HIGH)
+    {
+        passed = FALSE;
+    }
+
+    /* Owner must be restored once the semaphore is deleted. */
+    semaphore_destroy(&test_sem_a);
+    semaphore_test_wait(&test_high);
+    if ((test_high.status != SEMAPHORE_DELETED) || (test_low.cb.priority != TEST_PRI_LOW))
+    {
+        passed = FALSE;
+    }
+
+    /* Return if the test passed. */
+    return (passed);
+
+} /* semaphore_test_delete */
+
+/*
+ * semaphore_test_order
+ * @return: Returns TRUE if the test passed, otherwise FALSE will be returned.
+ * This function will verify that a task waiting on a semaphore is moved ahead
+ * of the lower priority tasks waiting on it, when it inherits a priority.
+ */
+static uint8_t semaphore_test_order(void)
+{
+    uint8_t passed = TRUE;
+
+    semaphore_create(&test_sem_a, 1);
+    semaphore_set_inherit(&test_sem_a);
+    semaphore_create(&test_sem_b, 1);
+    semaphore_set_inherit(&test_sem_b);
+
+    /* Low priority task obtains the first semaphore and the second one is
+     * obtained by a high priority task. */
+    semaphore_test_command(&test_low, TEST_OP_OBTAIN, &test_sem_a, MAX_WAIT);
+    semaphore_test_wait(&test_low);
+    semaphore_test_command(&test_high2, TEST_OP_OBTAIN, &test_sem_b, MAX_WAIT);
+    semaphore_test_wait(&test_high2);
+
+    /* Medium and then low priority task wait on the second semaphore. */
+    semaphore_test_command(&test_medium, TEST_OP_OBTAIN, &test_sem_b, MAX_WAIT);
+    sleep_ticks(1);
+    semaphore_test_command(&test_low, TEST_OP_OBTAIN, &test_sem_b, TEST_TIMEOUT);
+    sleep_ticks(1);
+
+    /* High priority task waits on the first semaphore and raises the low
+     * priority task. */
+    semaphore_test_command(&test_high, TEST_OP_OBTAIN, &test_sem_a, MAX_WAIT);
+    sleep_ticks(1);
+    if (test_low.cb.priority != TEST_PRI_HIGH)
+    {
+        passed = FALSE;
+    }
+
+    /* Release the second semaphore, the raised task must obtain it before the
+     * medium priority task. */
+    semaphore_test_command(&test_high2, TEST_OP_RELEASE, &test_sem_b, 0);
+    semaphore_test_wait(&test_high2);
+    semaphore_test_wait(&test_low);
+    if ((test_low.status != SUCCESS) || (test_medium.done == TRUE))
+    {
+        passed = FALSE;
+    }
+
+    /* If the low priority task obtained the second semaphore. */
+    if (test_low.status == SUCCESS)
+    {
+        /* Pass the second semaphore to the medium priority task. */
+        semaphore_test_command(&test_low, TEST_OP_RELEASE, &test_sem_b, 0);
+        semaphore_test_wait(&test_low);
+    }
+    semaphore_test_wait(&test_medium);
+
+    /* Pass the first semaphore to the high priority task. */
+    semaphore_test_command(&test_low, TEST_OP_RELEASE, &test_sem_a, 0);
+    semaphore_test_wait(&test_low);
+    semaphore_test_wait(&test_high);
+
+    /* Release the semaphores. */
+    semaphore_test_command(&test_high, TEST_OP_RELEASE, &test_sem_a, 0);
+    semaphore_test_wait(&test_high);
+    semaphore_test_command(&test_medium, TEST_OP_RELEASE, &test_sem_b, 0);
+    semaphore_test_wait(&test_medium);
+
+    /* Return if the test passed. */
+    return (passed);
+
+} /* semaphore_test_order */
+
+/*
+ * semaphore_test_blocking
+ * @return: Returns the number of ticks high priority task was blocked.
+ * This function will measure the time for which a high priority task is
+ * blocked on a semaphore held by a low priority task for a critical section,
+ * while a medium priority task is keeping the CPU busy.
+ */
+static uint32_t semaphore_test_blocking(void)
+{
+    semaphore_create(&test_sem_a, 1);
+    semaphore_set_inherit(&test_sem_a);
+
+    /* Low priority task enters the critical section. */
+    semaphore_test_command(&test_low, TEST_OP_CRITICAL, &test_sem_a, TEST_CRITICAL);
+    sleep_ticks(2);
+
+    /* High priority task waits on the semaphore and medium priority task
+     * starts running. */
+    semaphore_test_command(&test_high, TEST_OP_OBTAIN, &test_sem_a, MAX_WAIT);
+    semaphore_test_command(&test_medium, TEST_OP_SPIN, NULL, TEST_MEDIUM_SPIN);
+
+    /* Wait for the high priority task to obtain the semaphore and release
+     * it. */
+    semaphore_test_wait(&test_high);
+    semaphore_test_command(&test_high, TEST_OP_RELEASE, &test_sem_a, 0);
+    semaphore_test_wait(&test_high);
+    semaphore_test_wait(&test_medium);
+    semaphore_test_wait(&test_low);
+
+    /* Return the ticks for which high priority task was blocked. */
+    return (test_high.blocked);
+
+} /* semaphore_test_blocking */
+
+void semaphore_test_task(void *argv)
+{
+    uint32_t round = 0, blocked;
+    uint8_t timeout, release, delete, order;
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(argv);
+
+    /* Wait for the workers to consume the initial count of their
+     * semaphores. */
+    semaphore_test_wait(&test_high);
+    semaphore_test_wait(&test_high2);
+    semaphore_test_wait(&test_medium);
+    semaphore_test_wait(&test_low);
+
+    for (;;)
+    {
+        /* Run the tests. */
+        timeout = semaphore_test_timeout();
+        release = semaphore_test_release();
+        delete = semaphore_test_delete();
+        order = semaphore_test_order();
+        blocked = semaphore_test_blocking();
+
+        /* Print the results. */
+        printf("round %lu: timeout %s, release %s, delete %s, order %s, worst case blocking %lu ticks for %lu ticks critical section %s\r\n", (unsigned long)round,
+               (timeout == TRUE) ? "passed" : "FAILED", (release == TRUE) ? "passed" : "FAILED", (delete == TRUE) ? "passed" : "FAILED", (order == TRUE) ? "passed" : "FAILED",
+               (unsigned long)blocked, (unsigned long)TEST_CRITICAL, (blocked <= TEST_CRITICAL) ? "passed" : "FAILED");
+
+        round++;
+
+        /* Wait before running the test again. */
+        sleep_ticks(SOFT_TICKS_PER_SEC);
+    }
+}
+
+/*
+ * semaphore_test_worker_create
+ * @worker: Worker task to be created.
+ * @name: Name of the worker task.
+ * @priority: Priority of the worker task.
+ * This function will create a worker task.
+ */
+static void semaphore_test_worker_create(TEST_WORKER *worker, P_STR_T name, uint8_t priority)
+{
+    memset(worker, 0, sizeof(TEST_WORKER));
+
+    /* Worker will run once to consume the initial semaphore count. */
+    semaphore_create(&worker->go, 1);
+    worker->op = TEST_OP_NONE;
+
+    task_create(&worker->cb, name, worker->stack, DEMO_STACK_SIZE, &semaphore_test_worker, (void *)(worker), 0);
+    scheduler_task_add(&worker->cb, priority);
+
+} /* semaphore_test_worker_create */
+
+int main(void)
+{
+    memset(&semaphore_test_cb, 0, sizeof(TASK));
+
+    /* Initialize scheduler. */
+    scheduler_init();
+
+    /* Initialize file system. */
+    fs_init();
+
+    /* Initialize serial. */
+    serial_init();
+
+    /* Create a task to control the test. */
+    task_create(&semaphore_test_cb, P_STR("TEST"), semaphore_test_stack, DEMO_STACK_SIZE, &semaphore_test_task, (void *)(NULL), 0);
+    scheduler_task_add(&semaphore_test_cb, TEST_PRI_CONTROL);
+
+    /* Create the worker tasks. */
+    semaphore_test_worker_create(&test_high, P_STR("HIGH"), TEST_PRI_HIGH);
+    semaphore_test_worker_create(&test_high2, P_STR("HIGH2"), TEST_PRI_HIGH2);
+    semaphore_test_worker_create(&test_medium, P_STR("MEDIUM"), TEST_PRI_MEDIUM);
+    semaphore_test_worker_create(&test_low, P_STR("LOW"), TEST_PRI_LOW);
+
+    /* Run scheduler. */
+    kernel_run();
+
+    return (0);
+
+}
@@ -0,0 +1,220 @@
+/*
+ * sleep_wheel_bench.c
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+#include <stdio.h>
+#include <string.h>
+#include <fs.h>
+#include <serial.h>
+
+/* This demo will put 10, 100 and 1000 dummy tasks to sleep and will print the
+ * per tick cost of processing the system tick while no context switch is
+ * done, so the sleeping tasks are not processed between the ticks, as happens
+ * when a task keeps running or after the tick was suppressed. This is compared
+ * against a linear scan over the sleeping tasks. The cost of adding and
+ * removing a sleeping task is also printed. Interrupts are disabled while the
+ * dummy tasks are sleeping, and none of them becomes due, so they are never
+ * scheduled. This can be run with SLEEP_WHEEL enabled and disabled. */
+
+/* Demo configurations. */
+#define DEMO_STACK_SIZE     1024
+#define BENCH_TICKS         256
+#define BENCH_MAX_SLEEPERS  1000
+#define BENCH_MIN_SLEEP     100000
+
+/* Use the hardware tick if we don't have a cycle counter. */
+#ifdef CPU_CYCLE_COUNT
+#define BENCH_TIMESTAMP()   (uint32_t)CPU_CYCLE_COUNT()
+#else
+#define BENCH_TIMESTAMP()   (uint32_t)current_hardware_tick()
+#endif /* CPU_CYCLE_COUNT */
+
+/* Function prototypes. */
+void sleep_wheel_bench_task(void *);
+static uint32_t sleep_wheel_bench_random(void);
+static uint8_t sleep_wheel_bench_linear(void);
+static uint32_t sleep_wheel_bench_run(uint32_t, uint32_t *, uint32_t *);
+
+/* Benchmark task stack. */
+TASK sleep_wheel_bench_cb;
+uint8_t sleep_wheel_bench_stack[DEMO_STACK_SIZE];
+
+/* Benchmark data. */
+static TASK bench_tasks[BENCH_MAX_SLEEPERS];
+static uint32_t bench_ticks[BENCH_MAX_SLEEPERS];
+static uint32_t bench_num_sleepers;
+static uint32_t bench_seed = 0x1234567;
+
+/*
+ * sleep_wheel_bench_random
+ * @return: Returns a pseudo random number.
+ * This function will return a pseudo random number.
+ */
+static uint32_t sleep_wheel_bench_random(void)
+{
+    /* Update the seed. */
+    bench_seed = (bench_seed * 1103515245) + 12345;
+
+    /* Return the random number. */
+    return ((bench_seed >> 16) | (bench_seed << 16));
+
+} /* sleep_wheel_bench_random */
+
+/*
+ * sleep_wheel_bench_linear
+ * @return: Returns TRUE if a sleeping task is due, otherwise FALSE will be
+ *  returned.
+ * This function will check if a sleeping task is due by scanning all the
+ * sleeping tasks.
+ */
+static uint8_t sleep_wheel_bench_linear(void)
+{
+    uint32_t i;
+    uint8_t due = FALSE;
+
+    /* Check all the sleeping tasks. */
+    for (i = 0; i < bench_num_sleepers; i++)
+    {
+        /* If this task is due. */
+        if (INT32CMP(current_tick, bench_tasks[i].tick_sleep) >= 0)
+        {
+            due = TRUE;
+        }
+    }
+
+    /* Return if a task is due. */
+    return (due);
+
+} /* sleep_wheel_bench_linear */
+
+/*
+ * sleep_wheel_bench_run
+ * @num_sleepers: Number of tasks to put to sleep.
+ * @tick: Per tick cost of processing the system tick will be returned here.
+ * @add_remove: Cost of removing and adding a sleeping task will be returned
+ *  here.
+ * @return: Returns the per tick cost of the linear scan.
+ * This function will put the given number of dummy tasks to sleep and will
+ * measure the cost of system tick, linear scan and of adding and removing a
+ * sleeping task.
+ */
+static uint32_t sleep_wheel_bench_run(uint32_t num_sleepers, uint32_t *tick, uint32_t *add_remove)
+{
+    INT_LVL interrupt_level;
+    uint32_t i, start, linear;
+    volatile uint8_t due;
+
+    /* Initialize the dummy tasks. */
+    memset(bench_tasks, 0, sizeof(bench_tasks));
+    bench_num_sleepers = num_sleepers;
+
+    /* Dummy tasks must not be scheduled, so disable interrupts while they
+     * are sleeping. */
+    interrupt_level = GET_INTERRUPT_LEVEL();
+    DISABLE_INTERRUPTS();
+
+    /* Put the dummy tasks to sleep, none of them will become due during the
+     * benchmark. */
+    for (i = 0; i < num_sleepers; i++)
+    {
+        bench_tasks[i].state = TASK_SUSPENDED;
+        bench_ticks[i] = BENCH_MIN_SLEEP + (sleep_wheel_bench_random() % BENCH_MIN_SLEEP);
+        sleep_add_to_list(&bench_tasks[i], bench_ticks[i]);
+    }
+
+    /* Process the system tick without processing the sleeping tasks. */
+    start = BENCH_TIMESTAMP();
+    for (i = 0; i < BENCH_TICKS; i++)
+    {
+        due = process_system_tick();
+    }
+    *tick = (BENCH_TIMESTAMP() - start) / BENCH_TICKS;
+
+    /* Check the sleeping tasks with a linear scan. */
+    start = BENCH_TIMESTAMP();
+    for (i = 0; i < BENCH_TICKS; i++)
+    {
+        due = sleep_wheel_bench_linear();
+    }
+    linear = (BENCH_TIMESTAMP() - start) / BENCH_TICKS;
+
+    /* Remove and add all the sleeping tasks again. */
+    start = BENCH_TIMESTAMP();
+    for (i = 0; i < num_sleepers; i++)
+    {
+        sleep_remove_from_list(&bench_tasks[i]);
+        sleep_add_to_list(&bench_tasks[i], bench_ticks[i]);
+    }
+    *add_remove = (BENCH_TIMESTAMP() - start) / num_sleepers;
+
+    /* Remove all the dummy tasks before restoring interrupts. */
+    for (i = 0; i < num_sleepers; i++)
+    {
+        sleep_remove_from_list(&bench_tasks[i]);
+    }
+
+    /* Restore old interrupt level. */
+    SET_INTERRUPT_LEVEL(interrupt_level);
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(due);
+
+    /* Return the per tick cost of linear scan. */
+    return (linear);
+
+} /* sleep_wheel_bench_run */
+
+void sleep_wheel_bench_task(void *argv)
+{
+    static const uint32_t num_sleepers[] = {10, 100, BENCH_MAX_SLEEPERS};
+    uint32_t i, linear, tick, add_remove;
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(argv);
+
+    for (;;)
+    {
+        for (i = 0; i < (sizeof(num_sleepers) / sizeof(uint32_t)); i++)
+        {
+            /* Run the benchmark and print the results. */
+            linear = sleep_wheel_bench_run(num_sleepers[i], &tick, &add_remove);
+            printf("%lu sleepers: linear %lu, tick %lu, add and remove %lu\r\n", (unsigned long)num_sleepers[i], (unsigned long)linear, (unsigned long)tick, (unsigned long)add_remove);
+        }
+
+        /* Wait before running the benchmark again. */
+        sleep_ticks(SOFT_TICKS_PER_SEC);
+    }
+}
+
+int main(void)
+{
+    memset(&sleep_wheel_bench_cb, 0, sizeof(TASK));
+
+    /* Initialize scheduler. */
+    scheduler_init();
+
+    /* Initialize file system. */
+    fs_init();
+
+    /* Initialize serial. */
+    serial_init();
+
+    /* Create a task for sleep benchmark. */
+    task_create(&sleep_wheel_bench_cb, P_STR("BENCH"), sleep_wheel_bench_stack, DEMO_STACK_SIZE, &sleep_wheel_bench_task, (void *)(NULL), 0);
+    scheduler_task_add(&sleep_wheel_bench_cb, 5);
+
+    /* Run scheduler. */
+    kernel_run();
+
+    return (0);
+
+}
@@ -0,0 +1,138 @@
+/*
+ * tcp_goodput.c
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+#include <stdio.h>
+#include <string.h>
+#include <fs.h>
+#include <net.h>
+#include <net_tcp.h>
+#include <serial.h>
+
+/* This demo will accept a TCP connection and will send a fixed amount of data
+ * on it, when all the data is sent the goodput along with the round trip time
+ * and congestion window at the end of the transfer is printed and the
+ * connection is closed. The link can be made lossy or long with
+ * ETHERNET_TAP_LOSS and ETHERNET_TAP_DELAY to see how congestion control
+ * recovers. */
+
+/* Demo configurations. */
+#define DEMO_STACK_SIZE     1024
+#define GOODPUT_PORT        11003
+#define GOODPUT_BYTES       (1024 * 1024)
+#define GOODPUT_CHUNK       1024
+
+/* Function prototypes. */
+void tcp_goodput_task(void *);
+
+/* TCP task stack. */
+TASK tcp_goodput_cb;
+uint8_t tcp_goodput_stack[DEMO_STACK_SIZE];
+
+/* TCP port structure. */
+TCP_PORT goodput_port;
+SOCKET_ADDRESS goodput_address;
+
+/* Data to be sent. */
+static uint8_t goodput_data[GOODPUT_CHUNK];
+
+void tcp_goodput_task(void *argv)
+{
+    uint32_t sent = 0, start, elapsed, i;
+    int32_t nbytes;
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(argv);
+
+    /* Initialize the data to be sent. */
+    for (i = 0; i < GOODPUT_CHUNK; i++)
+    {
+        goodput_data[i] = (uint8_t)('A' + (i % 26));
+    }
+
+    /* Clear the TCP port structure. */
+    memset(&goodput_port, 0, sizeof(TCP_PORT));
+
+    /* Populate the socket structure. */
+    goodput_address.foreign_ip = IPV4_ADDR_UNSPEC;
+    goodput_address.foreign_port = NET_PORT_UNSPEC;
+    goodput_address.local_ip = IPV4_ADDR_UNSPEC;
+    goodput_address.local_port = GOODPUT_PORT;
+
+    /* Register this TCP port. */
+    tcp_register(&goodput_port, "goodput", &goodput_address);
+
+    /* Configure the TCP port to accept new connections. */
+    tcp_listen(&goodput_port);
+
+    /* Accept a TCP connection. */
+    tcp_accept(&goodput_port, &goodput_port);
+    printf("A TCP client has connected.\r\n");
+
+    /* Save the tick at which we started sending data. */
+    start = current_system_tick();
+
+    /* While we have some data to send. */
+    while (sent < GOODPUT_BYTES)
+    {
+        /* Send a chunk of data. */
+        nbytes = fs_write(&goodput_port, goodput_data, (int32_t)MIN(GOODPUT_CHUNK, (GOODPUT_BYTES - sent)));
+
+        /* If connection was closed. */
+        if (nbytes <= 0)
+        {
+            break;
+        }
+
+        sent += (uint32_t)nbytes;
+    }
+
+    /* Calculate the transfer time, at most a window of data is not yet
+     * ACKed. */
+    elapsed = TICK_TO_MS(current_system_tick() - start);
+    elapsed = MAX(elapsed, 1);
+
+    /* Print the results. */
+    printf("sent %lu bytes in %lu ms, goodput %lu kbit/s, srtt %lu ms, cwnd %lu, ssthresh %lu\r\n",
+           (unsigned long)sent, (unsigned long)elapsed, (unsigned long)(((uint64_t)sent * 8) / elapsed),
+           (unsigned long)TICK_TO_MS(goodput_port.srtt >> 3), (unsigned long)goodput_port.cwnd, (unsigned long)goodput_port.ssthresh);
+
+    /* Close this TCP port. */
+    tcp_close(&goodput_port);
+}
+
+int main(void)
+{
+    memset(&tcp_goodput_cb, 0, sizeof(TASK));
+
+    /* Initialize scheduler. */
+    scheduler_init();
+
+    /* Initialize file system. */
+    fs_init();
+
+    /* Initialize networking stack. */
+    net_init();
+
+    /* Initialize serial. */
+    serial_init();
+
+    /* Create a task for TCP goodput demo. */
+    task_create(&tcp_goodput_cb, P_STR("GOODPUT"), tcp_goodput_stack, DEMO_STACK_SIZE, &tcp_goodput_task, (void *)(NULL), 0);
+    scheduler_task_add(&tcp_goodput_cb, 5);
+
+    /* Run scheduler. */
+    kernel_run();
+
+    return (0);
+
+}
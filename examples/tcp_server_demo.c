@@ -11,6 +11,7 @@
  *
  */
 #include <kernel.h>
+#include <stdio.h>
 #include <string.h>
 #include <fs.h>
 #include <net.h>
@@ -0,0 +1,265 @@
+/*
+ * tcp_zero_copy_bench.c
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+#include <stdio.h>
+#include <string.h>
+#include <fs.h>
+#include <net.h>
+#include <net_tcp.h>
+#include <serial.h>
+
+/* This demo will compare the throughput of sending data on a TCP connection
+ * by copying it against handing the file system buffers to the TCP stack. It
+ * will accept a TCP connection on port 11004 and will send a fixed amount of
+ * data on it by copying it from a file buffer into a user buffer and writing
+ * it, as data is served from a file, it will then accept a TCP connection on
+ * port 11005 on a buffered port and will send same amount of data by copying
+ * it from the file buffer directly in the networking buffers and writing the
+ * buffers. Throughput is printed for both and then the connections are
+ * closed. */
+
+/* Demo configurations. */
+#define DEMO_STACK_SIZE     1024
+#define BENCH_COPY_PORT     11004
+#define BENCH_ZC_PORT       11005
+#define BENCH_BYTES         (4 * 1024 * 1024)
+#define BENCH_CHUNK         1024
+
+/* Function prototypes. */
+void tcp_zero_copy_bench_task(void *);
+static uint32_t tcp_zero_copy_bench_copy(void);
+static uint32_t tcp_zero_copy_bench_buffer(void);
+static void tcp_zero_copy_bench_listen(TCP_PORT *, char *, uint16_t, uint8_t);
+static void tcp_zero_copy_bench_print(char *, uint32_t, uint32_t);
+
+/* TCP task stack. */
+TASK tcp_zero_copy_bench_cb;
+uint8_t tcp_zero_copy_bench_stack[DEMO_STACK_SIZE];
+
+/* TCP port structures. */
+TCP_PORT bench_copy_port;
+TCP_PORT bench_zc_port;
+
+/* File data to be sent and the user buffer. */
+static uint8_t bench_file[BENCH_CHUNK];
+static uint8_t bench_user[BENCH_CHUNK];
+
+/*
+ * tcp_zero_copy_bench_listen
+ * @port: TCP port to be used.
+ * @name: Name of this port.
+ * @local_port: Local port number.
+ * @buffered: If TRUE a buffered port will be registered.
+ * This function will register a TCP port and will listen for connections on
+ * it.
+ */
+static void tcp_zero_copy_bench_listen(TCP_PORT *port, char *name, uint16_t local_port, uint8_t buffered)
+{
+    SOCKET_ADDRESS socket_address;
+
+    /* Clear the TCP port structure. */
+    memset(port, 0, sizeof(TCP_PORT));
+
+    /* If this is a buffered port. */
+    if (buffered == TRUE)
+    {
+        port->console.fs.flags = FS_BUFFERED;
+    }
+
+    /* Populate the socket structure. */
+    socket_address.foreign_ip = IPV4_ADDR_UNSPEC;
+    socket_address.foreign_port = NET_PORT_UNSPEC;
+    socket_address.local_ip = IPV4_ADDR_UNSPEC;
+    socket_address.local_port = local_port;
+
+    /* Register this TCP port. */
+    tcp_register(port, name, &socket_address);
+
+    /* Configure the TCP port to accept new connections. */
+    tcp_listen(port);
+
+} /* tcp_zero_copy_bench_listen */
+
+/*
+ * tcp_zero_copy_bench_copy
+ * @return: Returns the time taken to send the data in ms.
+ * This function will send the data by copying it in a user buffer.
+ */
+static uint32_t tcp_zero_copy_bench_copy(void)
+{
+    uint32_t sent = 0, start;
+    int32_t nbytes;
+
+    /* Accept a TCP connection. */
+    tcp_accept(&bench_copy_port, &bench_copy_port);
+
+    /* Save the tick at which we started sending data. */
+    start = current_system_tick();
+
+    /* While we have some data to send. */
+    while (sent < BENCH_BYTES)
+    {
+        /* Read data from the file in the user buffer. */
+        memcpy(bench_user, bench_file, BENCH_CHUNK);
+
+        /* Send this data, TCP will copy it in the networking buffers. */
+        nbytes = fs_write(&bench_copy_port, bench_user, BENCH_CHUNK);
+
+        /* If connection was closed. */
+        if (nbytes <= 0)
+        {
+            break;
+        }
+
+        sent += (uint32_t)nbytes;
+    }
+
+    /* Return the time taken to send the data, at most a window of data is
+     * not yet ACKed. */
+    return (TICK_TO_MS(current_system_tick() - start));
+
+} /* tcp_zero_copy_bench_copy */
+
+/*
+ * tcp_zero_copy_bench_buffer
+ * @return: Returns the time taken to send the data in ms.
+ * This function will send the data by reading it directly in the networking
+ * buffers and handing them to TCP.
+ */
+static uint32_t tcp_zero_copy_bench_buffer(void)
+{
+    uint32_t sent = 0, start;
+    int32_t nbytes = 0;
+    FS_BUFFER_LIST *buffer;
+    NET_DEV *net_device;
+    FD buffer_fd;
+
+    /* Accept a TCP connection. */
+    tcp_accept(&bench_zc_port, &bench_zc_port);
+
+    /* Get the networking device for this connection. */
+    net_device = ipv4_get_source_device(bench_zc_port.socket_address.local_ip);
+
+    /* Save the tick at which we started sending data. */
+    start = current_system_tick();
+
+    /* While we have some data to send. */
+    while ((net_device != NULL) && (sent < BENCH_BYTES))
+    {
+        /* Get a networking buffer. */
+        buffer_fd = net_device->fd;
+        ASSERT(fd_get_lock(buffer_fd) != SUCCESS);
+        buffer = fs_buffer_get(buffer_fd, FS_LIST_FREE, (FS_BUFFER_TH | FS_BUFFER_SUSPEND));
+
+        /* Read data from the file directly in the networking buffer. */
+        if ((buffer != NULL) && (fs_buffer_list_push(buffer, bench_file, BENCH_CHUNK, (FS_BUFFER_TH | FS_BUFFER_SUSPEND)) != SUCCESS))
+        {
+            /* Free this buffer. */
+            fs_buffer_add(buffer_fd, buffer, FS_LIST_FREE, FS_BUFFER_ACTIVE);
+            buffer = NULL;
+        }
+        fd_release_lock(buffer_fd);
+
+        /* If we don't have any buffers. */
+        if (buffer == NULL)
+        {
+            break;
+        }
+
+        /* Hand over this buffer to TCP. */
+        nbytes = fs_write(&bench_zc_port, (uint8_t *)buffer, BENCH_CHUNK);
+
+        /* If connection was closed. */
+        if (nbytes <= 0)
+        {
+            break;
+        }
+
+        sent += (uint32_t)nbytes;
+    }
+
+    /* Return the time taken to send the data, at most a window of data is
+     * not yet ACKed. */
+    return (TICK_TO_MS(current_system_tick() - start));
+
+} /* tcp_zero_copy_bench_buffer */
+
+/*
+ * tcp_zero_copy_bench_print
+ * @name: Name of this test.
+ * @bytes: Number of bytes sent.
+ * @elapsed: Time taken to send the data in ms.
+ * This function will print the results of a test.
+ */
+static void tcp_zero_copy_bench_print(char *name, uint32_t bytes, uint32_t elapsed)
+{
+    /* Don't divide by zero. */
+    elapsed = MAX(elapsed, 1);
+
+    /* Print the results. */
+    printf("%s: sent %lu bytes in %lu ms, throughput %lu kbit/s\r\n", name, (unsigned long)bytes, (unsigned long)elapsed, (unsigned long)(((uint64_t)bytes * 8) / elapsed));
+
+} /* tcp_zero_copy_bench_print */
+
+void tcp_zero_copy_bench_task(void *argv)
+{
+    uint32_t i;
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(argv);
+
+    /* Initialize the file data. */
+    for (i = 0; i < BENCH_CHUNK; i++)
+    {
+        bench_file[i] = (uint8_t)('A' + (i % 26));
+    }
+
+    /* Listen for connections on both the ports. */
+    tcp_zero_copy_bench_listen(&bench_copy_port, "copy", BENCH_COPY_PORT, FALSE);
+    tcp_zero_copy_bench_listen(&bench_zc_port, "zero copy", BENCH_ZC_PORT, TRUE);
+
+    /* Run the benchmark and print the results. */
+    tcp_zero_copy_bench_print("copy", BENCH_BYTES, tcp_zero_copy_bench_copy());
+    tcp_zero_copy_bench_print("zero copy", BENCH_BYTES, tcp_zero_copy_bench_buffer());
+
+    /* Close the TCP ports. */
+    tcp_close(&bench_copy_port);
+    tcp_close(&bench_zc_port);
+}
+
+int main(void)
+{
+    memset(&tcp_zero_copy_bench_cb, 0, sizeof(TASK));
+
+    /* Initialize scheduler. */
+    scheduler_init();
+
+    /* Initialize file system. */
+    fs_init();
+
+    /* Initialize networking stack. */
+    net_init();
+
+    /* Initialize serial. */
+    serial_init();
+
+    /* Create a task for TCP zero copy benchmark. */
+    task_create(&tcp_zero_copy_bench_cb, P_STR("BENCH"), tcp_zero_copy_bench_stack, DEMO_STACK_SIZE, &tcp_zero_copy_bench_task, (void *)(NULL), 0);
+    scheduler_task_add(&tcp_zero_copy_bench_cb, 5);
+
+    /* Run scheduler. */
+    kernel_run();
+
+    return (0);
+
+}
@@ -0,0 +1,219 @@
+/*
+ * tickless_test.c
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+#include <stdio.h>
+#include <string.h>
+#include <fs.h>
+#include <serial.h>
+
+/* This test will verify the tick accounting of tickless idle on the POSIX port
+ * with the simulated clock, where time only advances when idle task waits for
+ * an interrupt. A number of tasks sleep for random number of ticks, so idle
+ * task suspends the tick for different durations, while an other task
+ * schedules interrupts at random times so the tick is also resumed before it
+ * expires. After each sleep a task verifies that it slept for exactly the
+ * requested number of ticks and that the system tick matches the simulated
+ * clock, i.e. no tick was lost or counted twice while the tick was suspended. */
+
+/* Test configurations. */
+#define DEMO_STACK_SIZE     1024
+#define TEST_NUM_SLEEPERS   4
+#define TEST_MAX_SLEEP      300
+#define TEST_MAX_WAKE       50
+#define TEST_REPORT_TICKS   (SOFT_TICKS_PER_SEC * 60)
+
+/* Function prototypes. */
+void tickless_test_task(void *);
+void tickless_sleeper_task(void *);
+void tickless_wake_task(void *);
+static uint32_t tickless_test_random(void);
+static uint8_t tickless_test_check(uint32_t, uint32_t);
+
+/* Test task stacks. */
+TASK tickless_test_cb;
+uint8_t tickless_test_stack[DEMO_STACK_SIZE];
+TASK tickless_sleeper_cb[TEST_NUM_SLEEPERS];
+uint8_t tickless_sleeper_stack[TEST_NUM_SLEEPERS][DEMO_STACK_SIZE];
+TASK tickless_wake_cb;
+uint8_t tickless_wake_stack[DEMO_STACK_SIZE];
+
+/* Test data. */
+static uint32_t test_seed = 0x1234567;
+static uint32_t test_num_passed;
+static uint32_t test_num_failed;
+static uint32_t test_num_wakes;
+
+/*
+ * tickless_test_random
+ * @return: Returns a pseudo random number.
+ * This function will return a pseudo random number.
+ */
+static uint32_t tickless_test_random(void)
+{
+    /* Update the seed. */
+    test_seed = (test_seed * 1103515245) + 12345;
+
+    /* Return the random number. */
+    return ((test_seed >> 16) | (test_seed << 16));
+
+} /* tickless_test_random */
+
+/*
+ * tickless_test_check
+ * @start: System tick at which the task started sleeping.
+ * @ticks: Number of ticks for which task slept.
+ * @return: Returns TRUE if the tick accounting was correct, otherwise FALSE
+ *  will be returned.
+ * This function will verify that the system tick advanced by exactly the
+ * requested number of ticks and that it matches the simulated clock.
+ */
+static uint8_t tickless_test_check(uint32_t start, uint32_t ticks)
+{
+    INT_LVL interrupt_level = GET_INTERRUPT_LEVEL();
+    uint32_t now;
+    uint64_t clock;
+    uint8_t passed;
+
+    /* Disable global interrupts. */
+    DISABLE_INTERRUPTS();
+
+    /* Save the system tick and the simulated clock. */
+    now = current_system_tick();
+    clock = posix_sim_clock;
+
+    /* Restore old interrupt level. */
+    SET_INTERRUPT_LEVEL(interrupt_level);
+
+    /* Verify the tick accounting. */
+    passed = (((now - start) == ticks) && (now == (uint32_t)(clock / POSIX_TICK_PERIOD_US))) ? TRUE : FALSE;
+
+    /* If tick accounting was wrong. */
+    if (passed == FALSE)
+    {
+        printf("FAILED: slept %lu ticks for %lu, tick %lu at clock %llu us\r\n", (unsigned long)(now - start), (unsigned long)ticks, (unsigned long)now, (unsigned long long)clock);
+    }
+
+    /* Return if the check passed. */
+    return (passed);
+
+} /* tickless_test_check */
+
+void tickless_sleeper_task(void *argv)
+{
+    uint32_t start, ticks;
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(argv);
+
+    for (;;)
+    {
+        /* Sleep for a random number of ticks. */
+        ticks = (tickless_test_random() % TEST_MAX_SLEEP) + 1;
+        start = current_system_tick();
+        sleep_ticks(ticks);
+
+        /* Verify the tick accounting. */
+        if (tickless_test_check(start, ticks) == TRUE)
+        {
+            test_num_passed ++;
+        }
+        else
+        {
+            test_num_failed ++;
+        }
+    }
+}
+
+void tickless_wake_task(void *argv)
+{
+    /* Some compiler warnings. */
+    UNUSED_PARAM(argv);
+
+    for (;;)
+    {
+        /* Schedule an interrupt at a random time in the next few ticks, this
+         * is usually not on a tick boundary. */
+        posix_sim_clock_wake(posix_sim_clock + (tickless_test_random() % (TEST_MAX_WAKE * POSIX_TICK_PERIOD_US)) + 1);
+        test_num_wakes ++;
+
+        /* Sleep for a random number of ticks. */
+        sleep_ticks((tickless_test_random() % TEST_MAX_WAKE) + 1);
+    }
+}
+
+void tickless_test_task(void *argv)
+{
+    uint32_t start;
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(argv);
+
+    for (;;)
+    {
+        /* Wait before printing the results. */
+        start = current_system_tick();
+        sleep_ticks(TEST_REPORT_TICKS);
+
+        /* Verify our own sleep. */
+        if (tickless_test_check(start, TEST_REPORT_TICKS) == TRUE)
+        {
+            test_num_passed ++;
+        }
+        else
+        {
+            test_num_failed ++;
+        }
+
+        /* Print the results. */
+        printf("tick %lu: %lu sleeps passed, %lu failed, %lu early wakes\r\n", (unsigned long)current_system_tick(), (unsigned long)test_num_passed, (unsigned long)test_num_failed, (unsigned long)test_num_wakes);
+    }
+}
+
+int main(void)
+{
+    uint32_t i;
+
+    memset(&tickless_test_cb, 0, sizeof(TASK));
+    memset(tickless_sleeper_cb, 0, sizeof(tickless_sleeper_cb));
+    memset(&tickless_wake_cb, 0, sizeof(TASK));
+
+    /* Initialize scheduler. */
+    scheduler_init();
+
+    /* Initialize file system. */
+    fs_init();
+
+    /* Initialize serial. */
+    serial_init();
+
+    /* Create a task to print the results. */
+    task_create(&tickless_test_cb, P_STR("TEST"), tickless_test_stack, DEMO_STACK_SIZE, &tickless_test_task, (void *)(NULL), 0);
+    scheduler_task_add(&tickless_test_cb, 5);
+
+    /* Create the sleeper tasks. */
+    for (i = 0; i < TEST_NUM_SLEEPERS; i++)
+    {
+        task_create(&tickless_sleeper_cb[i], P_STR("SLEEPER"), tickless_sleeper_stack[i], DEMO_STACK_SIZE, &tickless_sleeper_task, (void *)(NULL), 0);
+        scheduler_task_add(&tickless_sleeper_cb[i], 5);
+    }
+
+    /* Create a task to schedule the early wakes. */
+    task_create(&tickless_wake_cb, P_STR("WAKE"), tickless_wake_stack, DEMO_STACK_SIZE, &tickless_wake_task, (void *)(NULL), 0);
+    scheduler_task_add(&tickless_wake_cb, 5);
+
+    /* Run scheduler. */
+    kernel_run();
+
+    return (0);
+
+}
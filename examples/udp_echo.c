@@ -15,7 +15,9 @@
 #include <mem.h>
 #include <fs.h>
 #include <net.h>
+#ifdef IO_PPP
 #include <ppp.h>
+#endif
 #include <net_udp.h>
 #include <serial.h>
 
@@ -59,8 +61,8 @@ void udp_echo_task(void *argv)
             /* If some data was received. */
             if (received > 0)
             {
-                /* Update the socket address. */
-                udp_port.socket_address = udp_port.last_datagram_address;
+                /* Reply to the sender of this datagram. */
+                udp_port.destination_address = udp_port.last_datagram_address;
 
                 /* Send this data back on the UDP port. */
                 received = fs_write(&udp_port, result, received);
@@ -85,8 +87,10 @@ int main(void)
     /* Initialize file system. */
     fs_init();
 
+#ifdef IO_PPP
     /* Initialize PPP stack. */
     ppp_init();
+#endif
 
     /* Initialize networking stack. */
     net_init();
@@ -18,9 +18,16 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <string.h>
+#include <sys/time.h>
 
 /* Configurations. */
 #define PACKET_SIZE     strlen(MSG)
+#define SERVER_ADDRESS  "192.168.0.3"
+
+/* Usage:
+ *  udp_echo_host [server address] [number of packets]
+ * If number of packets is given, that many packets are echoed without printing
+ * and throughput of the echo path is printed at the end. */
 
 /* Message that will be sent. */
 #define MSG "01234567890123456789012345678901234567890123456789"   \
@@ -68,12 +75,19 @@ int main(int argc, char **argv)
     char result[65535];
     int sockfd, socklen;
     struct sockaddr_in servaddr, saddr;
-    int n = 0, num;
+    int n = 0, num, count = 0, lost = 0;
+    struct timeval start, end, timeout;
+    double elapsed, bytes = 0;
 
     bzero(&servaddr, sizeof(servaddr));
     servaddr.sin_family = AF_INET;
     servaddr.sin_port = htons(11000);
-    servaddr.sin_addr.s_addr = inet_addr("192.168.0.3");
+    servaddr.sin_addr.s_addr = inet_addr((argc > 1) ? argv[1] : SERVER_ADDRESS);
+    if (argc > 2)
+    {
+        count = atoi(argv[2]);
+    }
+
     if((sockfd = socket(AF_INET, SOCK_DGRAM, 0)) < 0)
     {
         perror("Unable to open new socket.");
@@ -89,7 +103,16 @@ int main(int argc, char **argv)
         return (1);
     }
 
-    for(;;)
+    if (count > 0)
+    {
+        /* Don't wait forever for a lost packet. */
+        timeout.tv_sec = 1;
+        timeout.tv_usec = 0;
+        setsockopt(sockfd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        gettimeofday(&start, NULL);
+    }
+
+    while ((count == 0) || (n < count))
     {
         snprintf(result, 1472, "[%d]%.*s", n++, PACKET_SIZE, MSG);
 
@@ -102,13 +125,30 @@ int main(int argc, char **argv)
 
         memset(result, 0, 65535);
         socklen = sizeof(servaddr);
-        if ((num = recvfrom(sockfd, result, 65535, 0, (struct sockaddr*) &servaddr, &socklen)) < 0)
+        if ((num = recvfrom(sockfd, result, 65535, 0, (struct sockaddr*) &servaddr, (socklen_t *)&socklen)) < 0)
         {
+            if (count > 0)
+            {
+                lost++;
+                continue;
+            }
+
             perror("Unable to receive.");
             return (1);
         }
 
-        printf("Got[%d]-%s\n", num, result);
+        bytes += num;
+        if (count == 0)
+        {
+            printf("Got[%d]-%s\n", num, result);
+        }
+    }
+
+    if (count > 0)
+    {
+        gettimeofday(&end, NULL);
+        elapsed = (double)(end.tv_sec - start.tv_sec) + ((double)(end.tv_usec - start.tv_usec) / 1000000.0);
+        printf("%d packets, %d lost, %.3f s, %.0f packets/s, %.0f bytes/s\n", count, lost, elapsed, (count - lost) / elapsed, bytes / elapsed);
     }
 
     close(sockfd);
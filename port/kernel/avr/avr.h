@@ -70,6 +70,21 @@ typedef uint8_t INT_LVL;
         }                                                               \
     }
 
+/* Wait for an interrupt, used by tickless idle. */
+#define CPU_IDLE_WAIT()                                                 \
+    {                                                                   \
+        SMCR = (1 << SE);                                               \
+        asm volatile(   "   SEI         \r\n"                           \
+                        "   SLEEP       \r\n"                           \
+                        "   CLI         \r\n");                         \
+        SMCR = 0;                                                       \
+    }
+
+/* Compiler barrier, used to order lock-free queue index updates. Only 8-bit
+ * values can be read and written atomically. */
+#define CPU_MEMORY_BARRIER()            asm volatile ("" ::: "memory")
+#define CPU_ATOMIC_TYPE                 uint8_t
+
 /* Critical section management. */
 #define ENTRE_CRITICAL()                                                \
     asm volatile (                                                      \
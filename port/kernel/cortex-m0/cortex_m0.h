@@ -40,6 +40,19 @@ extern volatile INT_LVL sys_interrupt_level;
                                             }                           \
                                         }
 
+/* Wait for an interrupt, used by tickless idle. */
+#define CPU_IDLE_WAIT()                 {                               \
+                                            asm("   DSB         ");     \
+                                            asm("   WFI         ");     \
+                                            asm("   ISB         ");     \
+                                        }
+
+/* Active ISR number, used by kernel tracing. */
+#define CPU_ISR_NUMBER()                (SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk)
+
+/* Memory barrier, used to order lock-free queue index updates. */
+#define CPU_MEMORY_BARRIER()            asm volatile ("   DMB   " ::: "memory")
+
 /* Scheduling macros. */
 #define RESTORE_CONTEXT_FIRST()         run_first_task()
 #define PEND_SV()                       CORTEX_M0_PEND_SV_REG |= CORTEX_M0_PEND_SV_MASK;
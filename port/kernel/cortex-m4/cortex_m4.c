@@ -17,6 +17,16 @@
  * FALSE: Interrupt Disabled */
 volatile INT_LVL sys_interrupt_level = TRUE;
 
+#ifdef CONFIG_TICKLESS
+/* SysTick configuration for tickless idle. */
+#define SYSTICK_PERIOD              (SYS_FREQ / SOFT_TICKS_PER_SEC)
+#define SYSTICK_MAX_TICKS           (SysTick_LOAD_RELOAD_Msk / SYSTICK_PERIOD)
+
+/* Number of ticks and SysTick counts for which system tick is suspended. */
+static uint32_t systick_suspended_ticks;
+static uint32_t systick_suspended_count;
+#endif /* CONFIG_TICKLESS */
+
 /*
  * stack_init
  * @tcb: Task control block needed to be initialized.
@@ -166,6 +176,98 @@ ISR_FUN isr_sysclock_handle(void)
     ENABLE_INTERRUPTS();
 
 } /* isr_sysclock_handle */
+
+#ifdef CONFIG_TICKLESS
+/*
+ * system_tick_suspend
+ * @ticks: Number of ticks after which system tick is needed to expire.
+ * @return: Number of ticks for which system tick was actually suspended, zero
+ *  if it was not suspended.
+ * This function will program the SysTick to expire after the given number of
+ * ticks, counting from the last tick. This must be called with interrupts
+ * disabled.
+ */
+uint32_t system_tick_suspend(uint32_t ticks)
+{
+    /* If a tick is already pending, don't suspend. */
+    if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+    {
+        ticks = 0;
+    }
+    else
+    {
+        /* Clamp the ticks to what SysTick can count. */
+        if (ticks > SYSTICK_MAX_TICKS)
+        {
+            ticks = SYSTICK_MAX_TICKS;
+        }
+
+        /* Stop the SysTick, this will also clear the count flag. */
+        SysTick->CTRL &= (uint32_t)~SysTick_CTRL_ENABLE_Msk;
+
+        /* Count rest of the current tick and the ticks we need to skip. */
+        systick_suspended_count = SysTick->VAL + ((ticks - 1) * SYSTICK_PERIOD);
+        SysTick->LOAD = systick_suspended_count - 1;
+        SysTick->VAL = 0;
+
+        /* Restart the SysTick. */
+        SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+        systick_suspended_ticks = ticks;
+    }
+
+    /* Return the number of ticks suspended. */
+    return (ticks);
+
+} /* system_tick_suspend */
+
+/*
+ * system_tick_resume
+ * @expired: If we are resuming from SysTick interrupt.
+ * @return: Number of ticks elapsed since the SysTick was suspended, excluding
+ *  the tick that is reported by the SysTick interrupt.
+ * This function will restore the periodic SysTick, if we are resumed before
+ * the SysTick expired the current tick will expire on the original tick
+ * boundary. This must be called with interrupts disabled.
+ */
+uint32_t system_tick_resume(uint8_t expired)
+{
+    uint32_t ctrl, elapsed, counted;
+
+    /* Stop the SysTick, reading control register will clear the count
+     * flag. */
+    ctrl = SysTick->CTRL;
+    SysTick->CTRL = (ctrl & (uint32_t)~SysTick_CTRL_ENABLE_Msk);
+
+    /* If SysTick has already expired. */
+    if ((expired == TRUE) || (ctrl & SysTick_CTRL_COUNTFLAG_Msk))
+    {
+        /* All but the last tick are elapsed, last one will be reported by
+         * SysTick interrupt. */
+        elapsed = systick_suspended_ticks - 1;
+        SysTick->LOAD = SYSTICK_PERIOD - 1;
+    }
+    else
+    {
+        /* Calculate the number of complete ticks elapsed. */
+        counted = systick_suspended_count - SysTick->VAL;
+        elapsed = counted / SYSTICK_PERIOD;
+
+        /* Expire the current tick at it's original boundary. */
+        SysTick->LOAD = (SYSTICK_PERIOD - (counted % SYSTICK_PERIOD)) - 1;
+    }
+
+    /* Restart the SysTick. */
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+    /* Next reload will be for a complete tick. */
+    SysTick->LOAD = SYSTICK_PERIOD - 1;
+
+    /* Return the elapsed ticks. */
+    return (elapsed);
+
+} /* system_tick_resume */
+#endif /* CONFIG_TICKLESS */
 #endif /* CONFIG_SLEEP */
 
 /*
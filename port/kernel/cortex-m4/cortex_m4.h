@@ -40,6 +40,33 @@ extern volatile INT_LVL sys_interrupt_level;
                                             }                           \
                                         }
 
+/* Count leading zeros, used by the scheduler to pick a ready priority. */
+#define CPU_CLZ(x)                      ((uint8_t)__builtin_clz(x))
+
+/* Wait for an interrupt, used by tickless idle. */
+#define CPU_IDLE_WAIT()                 {                               \
+                                            asm("   DSB         ");     \
+                                            asm("   WFI         ");     \
+                                            asm("   ISB         ");     \
+                                        }
+
+/* Cycle counter and active ISR number, used by kernel tracing. */
+#define CORTEX_M4_DEMCR_REG             (*((volatile uint32_t *)0xE000EDFC))
+#define CORTEX_M4_DEMCR_TRCENA          (0x01000000)
+#define CORTEX_M4_DWT_CTRL_REG          (*((volatile uint32_t *)0xE0001000))
+#define CORTEX_M4_DWT_CTRL_CYCCNTENA    (0x00000001)
+#define CORTEX_M4_DWT_CYCCNT_REG        (*((volatile uint32_t *)0xE0001004))
+#define CPU_CYCLE_COUNT_INIT()          {                                                       \
+                                            CORTEX_M4_DEMCR_REG |= CORTEX_M4_DEMCR_TRCENA;      \
+                                            CORTEX_M4_DWT_CYCCNT_REG = 0;                       \
+                                            CORTEX_M4_DWT_CTRL_REG |= CORTEX_M4_DWT_CTRL_CYCCNTENA; \
+                                        }
+#define CPU_CYCLE_COUNT()               (CORTEX_M4_DWT_CYCCNT_REG)
+#define CPU_ISR_NUMBER()                (SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk)
+
+/* Memory barrier, used to order lock-free queue index updates. */
+#define CPU_MEMORY_BARRIER()            asm volatile ("   DMB   " ::: "memory")
+
 /* Scheduling macros. */
 #define RESTORE_CONTEXT_FIRST()         run_first_task()
 #define PEND_SV()                       CORTEX_M4_PEND_SV_REG |= CORTEX_M4_PEND_SV_MASK;
@@ -18,6 +18,7 @@
 #define TARGET_CORTEX_M0    0x2
 #define TARGET_CORTEX_M3    0x3
 #define TARGET_CORTEX_M4    0x4
+#define TARGET_POSIX        0x5
 
 /* Target platform definitions. */
 #define PLAT_ATMEGAXX4      0x1
@@ -25,16 +26,20 @@
 #define PLAT_STM32F103C8T6  0x3
 #define PLAT_STM32F407VGT6  0x4
 #define PLAT_STM32F411CEU6  0x5
+#define PLAT_LINUX          0x6
 
 /* Target toolset configuration. */
 #define TOOL_AVR_GCC        0x1
 #define TOOL_ARM_GCC        0x2
+#define TOOL_HOST_GCC       0x3
 
 /* Toolset includes. */
 #if (TARGET_TOOLS == TOOL_AVR_GCC)
 #include <avr_gcc.h>
 #elif (TARGET_TOOLS == TOOL_ARM_GCC)
 #include <arm_gcc.h>
+#elif (TARGET_TOOLS == TOOL_HOST_GCC)
+#include <host_gcc.h>
 #endif
 
 /* Processor includes. */
@@ -46,6 +51,8 @@
 #include <cortex_m3.h>
 #elif (TARGET_CPU == TARGET_CORTEX_M4)
 #include <cortex_m4.h>
+#elif (TARGET_CPU == TARGET_POSIX)
+#include <posix.h>
 #endif
 
 /* Platform includes. */
@@ -59,6 +66,8 @@
 #include <stm32f407.h>
 #elif (TARGET_PLATFORM == PLAT_STM32F411CEU6)
 #include <stm32f411.h>
+#elif (TARGET_PLATFORM == PLAT_LINUX)
+#include <linux_host.h>
 #endif
 
 #include <p_string.h>
@@ -67,6 +76,10 @@
 /* Following functions must be implemented by target porting layer. */
 #ifdef CONFIG_SLEEP
 void system_tick_Init(void);
+#ifdef CONFIG_TICKLESS
+uint32_t system_tick_suspend(uint32_t);
+uint32_t system_tick_resume(uint8_t);
+#endif /* CONFIG_TICKLESS */
 #endif /* CONFIG_SLEEP */
 void stack_init(TASK *, TASK_ENTRY *, void *);
 
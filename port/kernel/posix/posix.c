@@ -0,0 +1,814 @@
+/*
+ * posix.c
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+
+/* This port runs the kernel in a single host process:
+ *  Each task is given a host context and a host stack, task stack given by
+ *  the application is only used for statistics. Context switch is done with
+ *  swapcontext, either on CONTROL_TO_SYSTEM or when returning from the
+ *  interrupts if a context switch was pended.
+ *  System tick is delivered as SIGALRM and file descriptor interrupts as SIGIO.
+ *  Signal handler only marks an interrupt as pending if interrupts are
+ *  disabled, otherwise the interrupts are processed in the context of the
+ *  interrupted task.
+ *  C library is not preemption safe, a task must not be preempted while it is
+ *  using a C library function that can be used by an other task.
+ *  If POSIX_SIM_CLOCK is enabled, the interval timer is replaced by a simulated
+ *  clock that is only advanced by the idle task, so tickless idle can be
+ *  tested without depending on the host scheduling.
+ */
+#include <kernel.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <ucontext.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+/* Host context for a task. */
+typedef struct _posix_task_context
+{
+    /* Host context. */
+    ucontext_t  context;
+
+    /* Task entry and argument. */
+    TASK_ENTRY  *entry;
+    void        *argv;
+
+} POSIX_TASK_CONTEXT;
+
+/* File descriptor interrupt source. */
+typedef struct _posix_interrupt
+{
+    /* Interrupt handler and it's data. */
+    POSIX_ISR   *isr;
+    void        *data;
+
+    /* File descriptor for this interrupt source. */
+    int         fd;
+
+    /* If this source is enabled. */
+    uint8_t     enabled;
+
+    /* Structure padding. */
+    uint8_t     pad[3];
+
+} POSIX_INTERRUPT;
+
+/* Global interrupt level. */
+/* TRUE: Interrupt Enabled
+ * FALSE: Interrupt Disabled */
+volatile INT_LVL sys_interrupt_level = FALSE;
+
+/* Pending interrupts and current interrupt source. */
+volatile uint32_t posix_int_pending = 0;
+volatile uint32_t posix_isr_number = 0;
+
+/* Context switch pended by an interrupt. */
+volatile uint8_t posix_pend_sv = FALSE;
+
+/* If we are processing interrupts. */
+static volatile uint8_t posix_in_isr = FALSE;
+
+/* Memory regions. */
+uint8_t posix_static_mem[POSIX_STATIC_MEM_SIZE] __attribute__ ((aligned (16)));
+uint8_t posix_dynamic_mem[POSIX_DYNAMIC_MEM_SIZE] __attribute__ ((aligned (16)));
+
+/* File descriptor interrupt sources. */
+static POSIX_INTERRUPT posix_interrupts[POSIX_NUM_INTERRUPTS];
+static uint32_t posix_num_interrupts = 0;
+
+#ifdef CONFIG_TICKLESS
+/* Number of ticks and micro seconds for which system tick is suspended. */
+static uint32_t posix_suspended_ticks;
+static uint64_t posix_suspended_count;
+#endif /* CONFIG_TICKLESS */
+
+#ifdef POSIX_SIM_CLOCK
+/* Simulated clock in micro seconds, the time at which simulated timer will
+ * expire and the time at which an other interrupt will be raised, zero if no
+ * other interrupt is scheduled. */
+volatile uint64_t posix_sim_clock = 0;
+static uint64_t posix_sim_expiry = POSIX_TICK_PERIOD_US;
+static uint64_t posix_sim_wake = 0;
+#endif /* POSIX_SIM_CLOCK */
+
+/* Internal function prototypes. */
+static void posix_task_entry(void);
+static void posix_context_switch(void);
+static void posix_interrupt_process(void);
+static void posix_io_interrupt(void);
+static void posix_signal_handler(int);
+#ifdef CONFIG_TICKLESS
+static void posix_set_timer(uint64_t);
+static uint64_t posix_timer_remaining(void);
+static uint8_t posix_timer_expired(void);
+#endif /* CONFIG_TICKLESS */
+
+/*
+ * stack_init
+ * @tcb: Task control block needed to be initialized.
+ * @task_entry: Task entry function.
+ * @argv: Arguments to be passed to the entry function.
+ * This function is responsible for initializing host context for a task, a
+ * host stack is allocated for the task and TOS is updated to point to the
+ * host context.
+ */
+void stack_init(TASK *tcb, TASK_ENTRY *task_entry, void *argv)
+{
+    POSIX_TASK_CONTEXT *context;
+
+    /* Allocate host context and stack for this task. */
+    context = (POSIX_TASK_CONTEXT *)malloc(sizeof(POSIX_TASK_CONTEXT) + POSIX_STACK_SIZE);
+
+    /* We must have a context for this task. */
+    ASSERT(context == NULL);
+
+    /* Initialize the host context. */
+    ASSERT(getcontext(&context->context) != 0);
+    context->context.uc_stack.ss_sp = (context + 1);
+    context->context.uc_stack.ss_size = POSIX_STACK_SIZE;
+    context->context.uc_link = NULL;
+
+    /* No signal is blocked in a task. */
+    sigemptyset(&context->context.uc_sigmask);
+
+    /* Task will start from the common entry function. */
+    makecontext(&context->context, &posix_task_entry, 0);
+    context->entry = task_entry;
+    context->argv = argv;
+
+    /* On this port TOS points to the host context. */
+    tcb->tos = (uint8_t *)context;
+
+} /* stack_init */
+
+/*
+ * posix_task_entry
+ * This is common entry function for all the tasks.
+ */
+static void posix_task_entry(void)
+{
+    POSIX_TASK_CONTEXT *context = (POSIX_TASK_CONTEXT *)current_task->tos;
+
+    /* Task always start with interrupts enabled. */
+    ENABLE_INTERRUPTS();
+
+    /* Call the task entry function. */
+    context->entry(context->argv);
+
+    /* Should never get here. */
+    ASSERT(TRUE);
+
+} /* posix_task_entry */
+
+/*
+ * run_first_task
+ * This is responsible for running first task.
+ */
+void run_first_task(void)
+{
+    /* Set default interrupt level as disabled. */
+    sys_interrupt_level = FALSE;
+
+    /* Get the task needed to run. */
+    current_task = scheduler_get_next_task();
+
+    /* Mark this task as running. */
+    current_task->state = TASK_RUNNING;
+
+    /* Mark entry to a new task. */
+    MARK_ENTRY();
+
+    /* Load context for the first task. */
+    setcontext(&((POSIX_TASK_CONTEXT *)current_task->tos)->context);
+
+    /* Should never get here. */
+    ASSERT(TRUE);
+
+} /* run_first_task */
+
+/*
+ * control_to_system
+ * This function will switch to the next task, if called from an interrupt
+ * context switch will be done when returning from the interrupts.
+ */
+void control_to_system(void)
+{
+    /* If we are in an interrupt. */
+    if (posix_in_isr == TRUE)
+    {
+        /* Schedule a context switch. */
+        PEND_SV();
+    }
+    else
+    {
+        /* Interrupts must remain disabled while we switch the context,
+         * caller will restore the interrupt level. */
+        DISABLE_INTERRUPTS();
+
+        /* Switch to the next task. */
+        posix_context_switch();
+    }
+
+} /* control_to_system */
+
+/*
+ * posix_context_switch
+ * This function will save the context of current task and will load the
+ * context of the next task needed to run. This must be called with interrupts
+ * disabled.
+ */
+static void posix_context_switch(void)
+{
+    TASK *prev_task = current_task;
+
+    /* We are switching to a new task so mark an exit. */
+    MARK_EXIT();
+
+    /* If current task is in running state. */
+    if (current_task->state == TASK_RUNNING)
+    {
+        /* Return the current task. */
+        scheduler_task_yield(current_task, YIELD_SYSTEM);
+    }
+
+    /* If we are in process of suspending this task. */
+    else if (current_task->state == TASK_TO_BE_SUSPENDED)
+    {
+        /* We just suspended this task. */
+        current_task->state = TASK_SUSPENDED;
+    }
+
+    /* Get the next task needed to run. */
+    current_task = scheduler_get_next_task();
+
+    /* Set the current task as running. */
+    current_task->state = TASK_RUNNING;
+
+    /* Mark entry to a new task. */
+    MARK_ENTRY();
+
+    /* If we are switching to an other task. */
+    if (current_task != prev_task)
+    {
+        /* Save context of previous task and load context for current task. */
+        swapcontext(&((POSIX_TASK_CONTEXT *)prev_task->tos)->context, &((POSIX_TASK_CONTEXT *)current_task->tos)->context);
+    }
+
+} /* posix_context_switch */
+
+/*
+ * posix_interrupt_check
+ * This function will process any pending interrupts if interrupts are enabled
+ * and kernel is running.
+ */
+void posix_interrupt_check(void)
+{
+    /* If we are not already processing interrupts, kernel is running and we
+     * can disable the interrupts. */
+    if ((posix_in_isr == FALSE) && (current_task != NULL) &&
+        (__atomic_exchange_n(&sys_interrupt_level, FALSE, __ATOMIC_SEQ_CST) == TRUE))
+    {
+        /* Process the pending interrupts. */
+        posix_interrupt_process();
+    }
+
+} /* posix_interrupt_check */
+
+/*
+ * posix_interrupt_process
+ * This function will process all the pending interrupts and then will switch
+ * the context if it was pended by an interrupt. This must be called with
+ * interrupts disabled, interrupts will be enabled when this returns.
+ */
+static void posix_interrupt_process(void)
+{
+    uint32_t pending;
+
+    do
+    {
+        /* We are now processing interrupts. */
+        posix_in_isr = TRUE;
+
+        /* While we have an interrupt to process. */
+        while ((pending = __atomic_exchange_n(&posix_int_pending, 0, __ATOMIC_SEQ_CST)) != 0)
+        {
+#ifdef CONFIG_SLEEP
+            /* If we have a system tick. */
+            if (pending & POSIX_INT_TICK)
+            {
+                /* Process the system tick. */
+                posix_isr_number = POSIX_INT_TICK;
+                isr_sysclock_handle();
+            }
+#endif /* CONFIG_SLEEP */
+
+            /* If a file descriptor is ready. */
+            if (pending & POSIX_INT_IO)
+            {
+                /* Process file descriptor interrupts. */
+                posix_isr_number = POSIX_INT_IO;
+                posix_io_interrupt();
+            }
+        }
+
+        /* We are no longer in an interrupt. */
+        posix_isr_number = 0;
+        posix_in_isr = FALSE;
+
+        /* If a context switch was pended. */
+        if (posix_pend_sv == TRUE)
+        {
+            /* Clear the pended context switch. */
+            posix_pend_sv = FALSE;
+
+            /* Switch to the next task, we will return here when this task
+             * is scheduled again. */
+            posix_context_switch();
+        }
+
+        /* Enable interrupts. */
+        sys_interrupt_level = TRUE;
+
+    /* If an interrupt was raised while we were enabling the interrupts. */
+    } while ((posix_int_pending != 0) && (__atomic_exchange_n(&sys_interrupt_level, FALSE, __ATOMIC_SEQ_CST) == TRUE));
+
+} /* posix_interrupt_process */
+
+/*
+ * posix_signal_handler
+ * @signal: Signal number.
+ * This is signal handler for the system tick and file descriptor interrupts.
+ */
+static void posix_signal_handler(int signal)
+{
+    int saved_errno = errno;
+
+    /* Mark this interrupt as pending. */
+    __atomic_fetch_or(&posix_int_pending, ((signal == SIGALRM) ? POSIX_INT_TICK : POSIX_INT_IO), __ATOMIC_SEQ_CST);
+
+    /* Process this interrupt if interrupts are enabled. */
+    posix_interrupt_check();
+
+    /* Restore the error number for the interrupted task. */
+    errno = saved_errno;
+
+} /* posix_signal_handler */
+
+/*
+ * posix_signal_init
+ * This function will install signal handlers for the interrupts, the signals
+ * are not deferred while the handler is running as the handler may not return
+ * until the interrupted task is scheduled again.
+ */
+void posix_signal_init(void)
+{
+    struct sigaction action;
+
+    /* Initialize the signal action. */
+    memset(&action, 0, sizeof(struct sigaction));
+    action.sa_handler = &posix_signal_handler;
+    action.sa_flags = (SA_RESTART | SA_NODEFER);
+    sigemptyset(&action.sa_mask);
+
+    /* Install handler for system tick and file descriptor interrupts. */
+    ASSERT(sigaction(SIGALRM, &action, NULL) != 0);
+    ASSERT(sigaction(SIGIO, &action, NULL) != 0);
+
+} /* posix_signal_init */
+
+/*
+ * posix_idle_wait
+ * This function will wait for an interrupt, this must be called with
+ * interrupts disabled. With the simulated clock this will instead advance the
+ * clock to the next timer expiry or the next other interrupt and will raise
+ * that interrupt.
+ */
+void posix_idle_wait(void)
+{
+#ifdef POSIX_SIM_CLOCK
+    /* If we don't have an interrupt pending. */
+    if (posix_int_pending == 0)
+    {
+        /* If an other interrupt is due before the timer. */
+        if ((posix_sim_wake != 0) && (posix_sim_wake < posix_sim_expiry))
+        {
+            /* Advance the clock to the other interrupt. */
+            posix_sim_clock = posix_sim_wake;
+            posix_sim_wake = 0;
+
+            /* Raise an IO interrupt. */
+            __atomic_fetch_or(&posix_int_pending, POSIX_INT_IO, __ATOMIC_SEQ_CST);
+        }
+        else
+        {
+            /* Advance the clock to the timer expiry and reload the timer
+             * with a complete tick. */
+            posix_sim_clock = posix_sim_expiry;
+            posix_sim_expiry += POSIX_TICK_PERIOD_US;
+
+            /* Raise the tick interrupt. */
+            __atomic_fetch_or(&posix_int_pending, POSIX_INT_TICK, __ATOMIC_SEQ_CST);
+        }
+    }
+#else
+    sigset_t mask, old_mask;
+
+    /* Block the interrupt signals so we don't miss one. */
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGALRM);
+    sigaddset(&mask, SIGIO);
+    sigprocmask(SIG_BLOCK, &mask, &old_mask);
+
+    /* If we don't have an interrupt pending. */
+    if (posix_int_pending == 0)
+    {
+        /* Wait for a signal. */
+        sigsuspend(&old_mask);
+    }
+
+    /* Restore the signal mask. */
+    sigprocmask(SIG_SETMASK, &old_mask, NULL);
+#endif /* POSIX_SIM_CLOCK */
+
+} /* posix_idle_wait */
+
+#ifdef POSIX_SIM_CLOCK
+/*
+ * posix_sim_clock_wake
+ * @at_us: Simulated time in micro seconds at which an interrupt is needed.
+ * This function will schedule an IO interrupt at the given simulated time, so
+ * idle task is woken up before the tick expires. Only one interrupt is
+ * scheduled at a time, a time that is not after the current simulated time is
+ * ignored.
+ */
+void posix_sim_clock_wake(uint64_t at_us)
+{
+    INT_LVL interrupt_level = GET_INTERRUPT_LEVEL();
+
+    /* Disable global interrupts. */
+    DISABLE_INTERRUPTS();
+
+    /* If the given time is in future. */
+    if (at_us > posix_sim_clock)
+    {
+        /* Schedule the interrupt. */
+        posix_sim_wake = at_us;
+    }
+
+    /* Restore old interrupt level. */
+    SET_INTERRUPT_LEVEL(interrupt_level);
+
+} /* posix_sim_clock_wake */
+#endif /* POSIX_SIM_CLOCK */
+
+/*
+ * posix_cycle_count
+ * @return: Monotonic clock in nano seconds.
+ * This function will return lower 32-bits of monotonic clock in nano seconds.
+ */
+uint32_t posix_cycle_count(void)
+{
+    struct timespec now;
+
+    /* Get the monotonic clock. */
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    /* Return the number of nano seconds. */
+    return ((uint32_t)(((uint64_t)now.tv_sec * 1000000000) + (uint64_t)now.tv_nsec));
+
+} /* posix_cycle_count */
+
+/*
+ * posix_interrupt_register
+ * @fd: File descriptor needed to be used as an interrupt source.
+ * @isr: Interrupt handler for this file descriptor.
+ * @data: Data to be passed to the interrupt handler.
+ * @return: Interrupt source number will be returned if file descriptor was
+ *  successfully registered, POSIX_INT_NO_SPACE will be returned if there is
+ *  no free interrupt source.
+ * This function will register a file descriptor as interrupt source, a SIGIO
+ * will be raised when file descriptor has some data to read. Interrupt handler
+ * is called while file descriptor is readable, so it must either drain the
+ * file descriptor or disable it's interrupt source. Source is registered in
+ * disabled state.
+ */
+int32_t posix_interrupt_register(int fd, POSIX_ISR *isr, void *data)
+{
+    int32_t source = POSIX_INT_NO_SPACE;
+    INT_LVL interrupt_level = GET_INTERRUPT_LEVEL();
+
+    /* Disable global interrupts. */
+    DISABLE_INTERRUPTS();
+
+    /* If we have a free interrupt source. */
+    if (posix_num_interrupts < POSIX_NUM_INTERRUPTS)
+    {
+        /* Allocate an interrupt source. */
+        source = (int32_t)posix_num_interrupts;
+        posix_num_interrupts ++;
+
+        /* Initialize this interrupt source. */
+        posix_interrupts[source].isr = isr;
+        posix_interrupts[source].data = data;
+        posix_interrupts[source].fd = fd;
+        posix_interrupts[source].enabled = FALSE;
+
+        /* Send SIGIO to this process when file descriptor is ready. */
+        fcntl(fd, F_SETOWN, getpid());
+        fcntl(fd, F_SETFL, (fcntl(fd, F_GETFL) | O_NONBLOCK | O_ASYNC));
+    }
+
+    /* Restore old interrupt level. */
+    SET_INTERRUPT_LEVEL(interrupt_level);
+
+    /* Return the interrupt source. */
+    return (source);
+
+} /* posix_interrupt_register */
+
+/*
+ * posix_interrupt_enable
+ * @source: Interrupt source needed to be enabled.
+ * This function will enable an interrupt source, as file descriptor may have
+ * become ready while it's source was disabled, file descriptors are polled
+ * again.
+ */
+void posix_interrupt_enable(int32_t source)
+{
+    /* Enable this interrupt source. */
+    posix_interrupts[source].enabled = TRUE;
+
+    /* Poll the file descriptors again. */
+    __atomic_fetch_or(&posix_int_pending, POSIX_INT_IO, __ATOMIC_SEQ_CST);
+
+    /* If interrupts are enabled. */
+    if (sys_interrupt_level == TRUE)
+    {
+        /* Process the interrupt now. */
+        posix_interrupt_check();
+    }
+
+} /* posix_interrupt_enable */
+
+/*
+ * posix_interrupt_disable
+ * @source: Interrupt source needed to be disabled.
+ * This function will disable an interrupt source.
+ */
+void posix_interrupt_disable(int32_t source)
+{
+    /* Disable this interrupt source. */
+    posix_interrupts[source].enabled = FALSE;
+
+} /* posix_interrupt_disable */
+
+/*
+ * posix_io_interrupt
+ * This function will poll all the enabled file descriptors and will call the
+ * interrupt handlers for the file descriptors that are ready.
+ */
+static void posix_io_interrupt(void)
+{
+    struct pollfd fds[POSIX_NUM_INTERRUPTS];
+    uint32_t i;
+
+    ISR_ENTER();
+
+    /* Initialize the poll descriptors for the enabled sources. */
+    for (i = 0; i < posix_num_interrupts; i++)
+    {
+        fds[i].fd = (posix_interrupts[i].enabled == TRUE) ? posix_interrupts[i].fd : -1;
+        fds[i].events = POLLIN;
+        fds[i].revents = 0;
+    }
+
+    /* If we have a ready file descriptor. */
+    if ((posix_num_interrupts > 0) && (poll(fds, posix_num_interrupts, 0) > 0))
+    {
+        /* Call interrupt handlers for the ready file descriptors. */
+        for (i = 0; i < posix_num_interrupts; i++)
+        {
+            /* If this source is ready and still enabled. */
+            if ((fds[i].revents != 0) && (posix_interrupts[i].enabled == TRUE))
+            {
+                /* Call the interrupt handler. */
+                posix_interrupts[i].isr(posix_interrupts[i].data);
+            }
+        }
+    }
+
+    ISR_EXIT();
+
+} /* posix_io_interrupt */
+
+#ifdef CONFIG_SLEEP
+/*
+ * isr_sysclock_handle
+ * This is system tick interrupt handle.
+ */
+ISR_FUN isr_sysclock_handle(void)
+{
+    /* Process system tick. */
+    if (process_system_tick())
+    {
+        /* Check if we can actually preempt the current task. */
+        if (current_task->lock_count == 0)
+        {
+            /* We should never have a task here with state not running. */
+            ASSERT(current_task->state != TASK_RUNNING);
+
+            /* Schedule a context switch. */
+            PEND_SV();
+        }
+        else
+        {
+            /* Set the flag that we need to process a context switch. */
+            current_task->flags |= TASK_SCHED_DRIFT;
+        }
+    }
+
+} /* isr_sysclock_handle */
+
+#ifdef CONFIG_TICKLESS
+/*
+ * posix_set_timer
+ * @value: Number of micro seconds after which timer is needed to expire.
+ * This function will program the system timer to expire after given number of
+ * micro seconds and then after each tick.
+ */
+static void posix_set_timer(uint64_t value)
+{
+#ifdef POSIX_SIM_CLOCK
+    /* Program the simulated timer. */
+    posix_sim_expiry = posix_sim_clock + value;
+#else
+    struct itimerval timer;
+
+    /* Program the timer. */
+    timer.it_value.tv_sec = (time_t)(value / 1000000);
+    timer.it_value.tv_usec = (suseconds_t)(value % 1000000);
+    timer.it_interval.tv_sec = (time_t)(POSIX_TICK_PERIOD_US / 1000000);
+    timer.it_interval.tv_usec = (suseconds_t)(POSIX_TICK_PERIOD_US % 1000000);
+    setitimer(ITIMER_REAL, &timer, NULL);
+#endif /* POSIX_SIM_CLOCK */
+
+} /* posix_set_timer */
+
+/*
+ * posix_timer_remaining
+ * @return: Number of micro seconds after which system timer will expire.
+ * This function will return the number of micro seconds remaining before the
+ * system timer expires.
+ */
+static uint64_t posix_timer_remaining(void)
+{
+#ifdef POSIX_SIM_CLOCK
+    /* Return the time remaining on the simulated timer. */
+    return (posix_sim_expiry - posix_sim_clock);
+#else
+    struct itimerval timer;
+
+    /* Get the time remaining on the timer. */
+    getitimer(ITIMER_REAL, &timer);
+
+    /* Return the number of micro seconds. */
+    return (((uint64_t)timer.it_value.tv_sec * 1000000) + (uint64_t)timer.it_value.tv_usec);
+#endif /* POSIX_SIM_CLOCK */
+
+} /* posix_timer_remaining */
+
+/*
+ * posix_timer_expired
+ * @return: TRUE if system timer has expired and it's signal is pending,
+ *  otherwise FALSE will be returned.
+ * This function will check if the system timer signal is pending, this must
+ * be called with the timer signal blocked.
+ */
+static uint8_t posix_timer_expired(void)
+{
+#ifdef POSIX_SIM_CLOCK
+    /* Simulated timer only expires when idle task advances the clock. */
+    return (FALSE);
+#else
+    sigset_t pending;
+
+    /* Return if timer signal is pending. */
+    sigpending(&pending);
+    return ((sigismember(&pending, SIGALRM)) ? TRUE : FALSE);
+#endif /* POSIX_SIM_CLOCK */
+
+} /* posix_timer_expired */
+
+/*
+ * system_tick_suspend
+ * @ticks: Number of ticks after which system tick is needed to expire.
+ * @return: Number of ticks for which system tick was actually suspended, zero
+ *  if it was not suspended.
+ * This function will program the system timer to expire after the given
+ * number of ticks, counting from the last tick. This must be called with
+ * interrupts disabled.
+ */
+uint32_t system_tick_suspend(uint32_t ticks)
+{
+    sigset_t mask, old_mask;
+
+    /* Block the tick signal so timer does not expire behind our back. */
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGALRM);
+    sigprocmask(SIG_BLOCK, &mask, &old_mask);
+
+    /* If a tick is already pending, don't suspend. */
+    if ((posix_int_pending & POSIX_INT_TICK) || (posix_timer_expired() == TRUE))
+    {
+        ticks = 0;
+    }
+    else
+    {
+        /* Count rest of the current tick and the ticks we need to skip. */
+        posix_suspended_count = posix_timer_remaining();
+        posix_suspended_count += ((uint64_t)(ticks - 1) * POSIX_TICK_PERIOD_US);
+
+        /* Reprogram the timer. */
+        posix_set_timer(posix_suspended_count);
+        posix_suspended_ticks = ticks;
+
+        /* If timer expired while we were programming it. */
+        if (posix_timer_expired() == TRUE)
+        {
+            /* Resume the periodic tick. */
+            posix_set_timer(POSIX_TICK_PERIOD_US);
+            ticks = 0;
+        }
+    }
+
+    /* Restore the signal mask. */
+    sigprocmask(SIG_SETMASK, &old_mask, NULL);
+
+    /* Return the number of ticks suspended. */
+    return (ticks);
+
+} /* system_tick_suspend */
+
+/*
+ * system_tick_resume
+ * @expired: If we are resuming from system tick interrupt.
+ * @return: Number of ticks elapsed since the system tick was suspended,
+ *  excluding the tick that is reported by the system tick interrupt.
+ * This function will restore the periodic system tick, if we are resumed
+ * before the timer expired the current tick will expire on the original tick
+ * boundary. This must be called with interrupts disabled.
+ */
+uint32_t system_tick_resume(uint8_t expired)
+{
+    sigset_t mask, old_mask;
+    uint64_t counted, remaining;
+    uint32_t elapsed;
+
+    /* Block the tick signal so timer does not expire behind our back. */
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGALRM);
+    sigprocmask(SIG_BLOCK, &mask, &old_mask);
+    remaining = posix_timer_remaining();
+
+    /* If timer has already expired. */
+    if ((expired == TRUE) || (posix_int_pending & POSIX_INT_TICK) || (posix_timer_expired() == TRUE))
+    {
+        /* All but the last tick are elapsed, last one will be reported by
+         * system tick interrupt, timer is already reloaded with a complete
+         * tick. */
+        elapsed = posix_suspended_ticks - 1;
+    }
+    else
+    {
+        /* Calculate the number of complete ticks elapsed. */
+        counted = posix_suspended_count - remaining;
+        elapsed = (uint32_t)(counted / POSIX_TICK_PERIOD_US);
+
+        /* Expire the current tick at it's original boundary. */
+        posix_set_timer(POSIX_TICK_PERIOD_US - (counted % POSIX_TICK_PERIOD_US));
+    }
+
+    /* Restore the signal mask. */
+    sigprocmask(SIG_SETMASK, &old_mask, NULL);
+
+    /* Return the elapsed ticks. */
+    return (elapsed);
+
+} /* system_tick_resume */
+#endif /* CONFIG_TICKLESS */
+#endif /* CONFIG_SLEEP */
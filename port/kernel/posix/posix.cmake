@@ -0,0 +1,8 @@
+# Setup configuration options.
+setup_option_def(POSIX_STACK_SIZE 65536 INT "Host stack size for each task, given task stack is only used for statistics on this port." CONFIG_FILE "posix_config")
+setup_option_def(POSIX_STATIC_MEM_SIZE 65536 INT "Size of static memory region." CONFIG_FILE "posix_config")
+setup_option_def(POSIX_DYNAMIC_MEM_SIZE 65536 INT "Size of dynamic memory region." CONFIG_FILE "posix_config")
+setup_option_def(POSIX_NUM_INTERRUPTS 8 INT "Maximum number of file descriptors that can be used as interrupt sources." CONFIG_FILE "posix_config")
+if (${CONFIG_TICKLESS})
+setup_option_def(POSIX_SIM_CLOCK OFF DEFINE "Use a simulated clock that is only advanced by the idle task instead of the interval timer, used to test tickless idle." CONFIG_FILE "posix_config")
+endif ()
\ No newline at end of file
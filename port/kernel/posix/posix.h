@@ -0,0 +1,118 @@
+/*
+ * posix.h
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#ifndef _POSIX_H_
+#define _POSIX_H_
+
+#include <kernel.h>
+#include <posix_config.h>
+
+/* Error code definitions. */
+#define POSIX_INT_NO_SPACE              (-12000)
+
+/* Interrupt sources, a bit is set in the pending mask for each. */
+#define POSIX_INT_TICK                  (0x1)
+#define POSIX_INT_IO                    (0x2)
+
+/* System tick period in micro seconds. */
+#define POSIX_TICK_PERIOD_US            (1000000 / SOFT_TICKS_PER_SEC)
+
+/* Interrupts are delivered as signals, only a software interrupt level is
+ * maintained and signal handler will defer the interrupts while they are
+ * disabled. */
+typedef uint8_t INT_LVL;
+extern volatile INT_LVL sys_interrupt_level;
+extern volatile uint32_t posix_int_pending;
+#define POSIX_COMPILER_BARRIER()        asm volatile ("" ::: "memory")
+#define DISABLE_INTERRUPTS()            {                                   \
+                                            sys_interrupt_level = 0;        \
+                                            POSIX_COMPILER_BARRIER();       \
+                                        }
+#define ENABLE_INTERRUPTS()             {                                   \
+                                            POSIX_COMPILER_BARRIER();       \
+                                            sys_interrupt_level = 1;        \
+                                            if (posix_int_pending != 0)     \
+                                            {                               \
+                                                posix_interrupt_check();    \
+                                            }                               \
+                                        }
+#define GET_INTERRUPT_LEVEL()           (sys_interrupt_level)
+#define SET_INTERRUPT_LEVEL(lvl)        {                                   \
+                                            if (lvl == 0)                   \
+                                            {                               \
+                                                DISABLE_INTERRUPTS();       \
+                                            }                               \
+                                            else                            \
+                                            {                               \
+                                                ENABLE_INTERRUPTS();        \
+                                            }                               \
+                                        }
+
+/* Count leading zeros, used by the scheduler to pick a ready priority. */
+#define CPU_CLZ(x)                      ((uint8_t)__builtin_clz(x))
+
+/* Wait for a signal, used by tickless idle. */
+#define CPU_IDLE_WAIT()                 posix_idle_wait()
+
+/* Monotonic clock in nano seconds and active interrupt source, used by kernel
+ * tracing. */
+extern volatile uint32_t posix_isr_number;
+#define CPU_CYCLE_COUNT()               posix_cycle_count()
+#define CPU_ISR_NUMBER()                (posix_isr_number)
+
+/* Memory barrier, used to order lock-free queue index updates. */
+#define CPU_MEMORY_BARRIER()            __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+/* Scheduling macros. */
+#define RESTORE_CONTEXT_FIRST()         run_first_task()
+#define PEND_SV()                       posix_pend_sv = TRUE
+#define CONTROL_TO_SYSTEM()             control_to_system()
+
+/* Memory definitions. */
+#define STATIC_MEM_START                (posix_static_mem)
+#define STATIC_MEM_END                  (posix_static_mem + POSIX_STATIC_MEM_SIZE)
+#define DYNAMIC_MEM_START               (posix_dynamic_mem)
+#define DYNAMIC_MEM_END                 (posix_dynamic_mem + POSIX_DYNAMIC_MEM_SIZE)
+
+/* Stack manipulation macros, on this port TOS will point to the host context
+ * for the task. */
+#define TOS_SET(tos, sp, size)          (tos = (sp + size))
+
+/* Interrupt handler for a file descriptor. */
+typedef void POSIX_ISR (void *);
+
+/* Exported variables. */
+extern volatile uint8_t posix_pend_sv;
+extern uint8_t posix_static_mem[POSIX_STATIC_MEM_SIZE];
+extern uint8_t posix_dynamic_mem[POSIX_DYNAMIC_MEM_SIZE];
+#ifdef POSIX_SIM_CLOCK
+extern volatile uint64_t posix_sim_clock;
+#endif /* POSIX_SIM_CLOCK */
+
+/* Function prototypes. */
+void run_first_task(void);
+void control_to_system(void);
+void posix_interrupt_check(void);
+void posix_idle_wait(void);
+uint32_t posix_cycle_count(void);
+int32_t posix_interrupt_register(int, POSIX_ISR *, void *);
+void posix_interrupt_enable(int32_t);
+void posix_interrupt_disable(int32_t);
+void posix_signal_init(void);
+#ifdef POSIX_SIM_CLOCK
+void posix_sim_clock_wake(uint64_t);
+#endif /* POSIX_SIM_CLOCK */
+#ifdef CONFIG_SLEEP
+ISR_FUN isr_sysclock_handle(void);
+#endif /* CONFIG_SLEEP */
+
+#endif /* _POSIX_H_ */
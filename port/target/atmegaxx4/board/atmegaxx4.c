@@ -16,6 +16,15 @@
 #include <avr.h>
 
 #ifdef CONFIG_SLEEP
+#ifdef CONFIG_TICKLESS
+/* Timer1 configuration for tickless idle. */
+#define TIMER1_PERIOD               (SYS_FREQ / SOFT_TICKS_PER_SEC / 64)
+#define TIMER1_MAX_TICKS            (0xFFFF / TIMER1_PERIOD)
+
+/* Number of ticks for which system tick is suspended. */
+static uint32_t timer1_suspended_ticks;
+#endif /* CONFIG_TICKLESS */
+
 /*
  * system_tick_Init
  * This initializes system tick. On AVR we are using Timer1 with CCP1 module to
@@ -46,6 +55,77 @@ uint64_t current_hardware_tick(void)
     return (((uint64_t)(current_system_tick() + (uint64_t)((TIFR1 & (1 << OCF1A)) ? 1 : 0)) * (uint64_t)(SYS_FREQ / SOFT_TICKS_PER_SEC / 64)) + (uint64_t)TCNT1);
 } /* current_hardware_tick */
 
+#ifdef CONFIG_TICKLESS
+/*
+ * system_tick_suspend
+ * @ticks: Number of ticks after which system tick is needed to expire.
+ * @return: Number of ticks for which system tick was actually suspended, zero
+ *  if it was not suspended.
+ * This function will move the Timer1 compare match to expire after the given
+ * number of ticks, counting from the last tick. This must be called with
+ * interrupts disabled.
+ */
+uint32_t system_tick_suspend(uint32_t ticks)
+{
+    /* If a tick is already pending, don't suspend. */
+    if (TIFR1 & (1 << OCF1A))
+    {
+        ticks = 0;
+    }
+    else
+    {
+        /* Clamp the ticks to what Timer1 can count. */
+        if (ticks > TIMER1_MAX_TICKS)
+        {
+            ticks = TIMER1_MAX_TICKS;
+        }
+
+        /* Timer1 is counting from the last tick, move the compare match. */
+        OCR1A = (uint16_t)((ticks * TIMER1_PERIOD) - 1);
+        timer1_suspended_ticks = ticks;
+    }
+
+    /* Return the number of ticks suspended. */
+    return (ticks);
+
+} /* system_tick_suspend */
+
+/*
+ * system_tick_resume
+ * @expired: If we are resuming from Timer1 interrupt.
+ * @return: Number of ticks elapsed since the Timer1 was suspended, excluding
+ *  the tick that is reported by the Timer1 interrupt.
+ * This function will restore the periodic Timer1 compare match. This must be
+ * called with interrupts disabled.
+ */
+uint32_t system_tick_resume(uint8_t expired)
+{
+    uint32_t elapsed;
+
+    /* If Timer1 has already expired. */
+    if ((expired == TRUE) || (TIFR1 & (1 << OCF1A)))
+    {
+        /* All but the last tick are elapsed, last one will be reported by
+         * Timer1 interrupt. */
+        elapsed = timer1_suspended_ticks - 1;
+    }
+    else
+    {
+        /* Calculate the number of complete ticks elapsed and continue
+         * counting the current tick. */
+        elapsed = (uint32_t)(TCNT1 / TIMER1_PERIOD);
+        TCNT1 = (uint16_t)(TCNT1 - (elapsed * TIMER1_PERIOD));
+    }
+
+    /* Restore the periodic compare match. */
+    OCR1A = (((SYS_FREQ / SOFT_TICKS_PER_SEC / 64) - 1) & 0xFFFF);
+
+    /* Return the elapsed ticks. */
+    return (elapsed);
+
+} /* system_tick_resume */
+#endif /* CONFIG_TICKLESS */
+
 /*
  * ISR(TIMER1_COMPA_vect, ISR_NAKED)
  * This is timer interrupt that will be called at each system tick.
@@ -0,0 +1,86 @@
+/*
+ * linux_host.c
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+#include <time.h>
+#include <sys/time.h>
+
+/* Monotonic clock when the process was started. */
+static uint64_t linux_clock_base;
+
+/*
+ * system_entry
+ * This is system entry function, this will be called by the C library before
+ * the application main, so we can initialize the system before user
+ * initializer.
+ */
+__attribute__ ((constructor)) void system_entry(void)
+{
+    struct timespec now;
+
+    /* Save the monotonic clock we started at. */
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    linux_clock_base = (((uint64_t)now.tv_sec * 1000000) + ((uint64_t)now.tv_nsec / 1000));
+
+    /* We are not running any task until OS initializes. */
+    set_current_task(NULL);
+
+    /* Disable interrupts. */
+    DISABLE_INTERRUPTS();
+
+    /* Install signal handlers for the interrupts. */
+    posix_signal_init();
+
+} /* system_entry */
+
+#ifdef CONFIG_SLEEP
+/*
+ * system_tick_Init
+ * This is responsible for initializing system timer tick. Tick will only be
+ * processed once the first task enables the interrupts. Simulated clock is
+ * already running with a periodic tick.
+ */
+void system_tick_Init(void)
+{
+#ifndef POSIX_SIM_CLOCK
+    struct itimerval timer;
+
+    /* Configure a periodic timer for system tick. */
+    timer.it_value.tv_sec = timer.it_interval.tv_sec = (time_t)(POSIX_TICK_PERIOD_US / 1000000);
+    timer.it_value.tv_usec = timer.it_interval.tv_usec = (suseconds_t)(POSIX_TICK_PERIOD_US % 1000000);
+    setitimer(ITIMER_REAL, &timer, NULL);
+#endif /* POSIX_SIM_CLOCK */
+
+} /* system_tick_Init */
+#endif /* CONFIG_SLEEP */
+
+/*
+ * current_hardware_tick
+ * This returns number of micro seconds elapsed since this process was
+ * started, or the simulated clock if it is enabled.
+ */
+uint64_t current_hardware_tick(void)
+{
+#ifdef POSIX_SIM_CLOCK
+    /* Return the simulated clock. */
+    return (posix_sim_clock);
+#else
+    struct timespec now;
+
+    /* Get the monotonic clock. */
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    /* Return micro seconds since we started. */
+    return ((((uint64_t)now.tv_sec * 1000000) + ((uint64_t)now.tv_nsec / 1000)) - linux_clock_base);
+#endif /* POSIX_SIM_CLOCK */
+
+} /* current_hardware_tick */
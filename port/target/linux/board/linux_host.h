@@ -0,0 +1,29 @@
+/*
+ * linux_host.h
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#ifndef _LINUX_HOST_H_
+#define _LINUX_HOST_H_
+
+#include <kernel.h>
+
+/* Clock configuration, cycle counter runs in nano seconds and hardware tick
+ * in micro seconds. */
+#define SYS_FREQ                        (1000000000)
+#define HW_TICKS_PER_SEC                (1000000)
+
+/* Function prototypes. */
+uint64_t current_hardware_tick(void);
+
+/* Helper functions. */
+void system_entry(void);
+
+#endif /* _LINUX_HOST_H_ */
@@ -0,0 +1,592 @@
+/*
+ * ethernet_linux.c
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+
+#ifdef IO_ETHERNET
+#include <ethernet.h>
+#include <ethernet_linux.h>
+#include <net.h>
+#ifdef NET_ARP
+#include <net_arp.h>
+#endif
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/time.h>
+#include <net/if.h>
+#include <linux/if_tun.h>
+
+/* TAP device instance. */
+static ETHERNET_TAP ethernet_tap;
+
+/* Internal function prototypes. */
+static int32_t ethernet_linux_open(ETHERNET_TAP *);
+static void ethernet_linux_initialize(void *);
+static void ethernet_linux_interrupt(void *);
+static int32_t ethernet_linux_transmit(void *, FS_BUFFER_LIST *);
+static void ethernet_linux_write(ETHERNET_TAP *, uint8_t *, uint32_t);
+static void ethernet_linux_wdt(void *);
+static void ethernet_linux_isr(void *);
+#ifdef CONFIG_SEMAPHORE
+static void ethernet_linux_int_lock(void *);
+static void ethernet_linux_int_unlock(void *);
+#endif
+#ifdef ETHERNET_TAP_PCAP
+static void ethernet_linux_pcap_open(ETHERNET_TAP *);
+static void ethernet_linux_pcap_write(ETHERNET_TAP *, uint8_t *, uint32_t);
+#endif
+
+/*
+ * ethernet_linux_init
+ * This function will initialize ethernet devices for linux platform, a host
+ * TAP interface is opened and used as ethernet device.
+ */
+void ethernet_linux_init(void)
+{
+    ETHERNET_TAP *device = &ethernet_tap;
+    FD fd = (FD)&device->ethernet_device;
+
+    /* Clear the device structure. */
+    memset(device, 0, sizeof(ETHERNET_TAP));
+
+    /* Initialize name for this device. */
+    device->ethernet_device.fs.name = "\\ethernet\\tap";
+
+    /* If we are not able to open the TAP interface. */
+    if (ethernet_linux_open(device) != SUCCESS)
+    {
+        /* Don't register this device. */
+        return;
+    }
+
+    /* Set the buffer data structure for this file descriptor. */
+    device->fs_buffer_data.buffer_space = device->buffer;
+    device->fs_buffer_data.buffer_size = ETHERNET_TAP_MAX_BUFFER_SIZE;
+    device->fs_buffer_data.buffer_lists = device->fs_list_free;
+    device->fs_buffer_data.num_buffer_lists = ETHERNET_TAP_NUM_BUFFER_LISTS;
+    device->fs_buffer_data.buffers = device->fs_buffer;
+    device->fs_buffer_data.num_buffers = ETHERNET_TAP_NUM_BUFFERS;
+    device->fs_buffer_data.threshold_buffers = ETHERNET_TAP_NUM_THR_BUFFER;
+    device->fs_buffer_data.threshold_lists = ETHERNET_TAP_NUM_THR_LIST;
+    fs_buffer_dataset(&device->ethernet_device, &device->fs_buffer_data);
+
+    /* Register this ethernet device. */
+    ethernet_regsiter(&device->ethernet_device, &ethernet_linux_initialize, &ethernet_linux_transmit, &ethernet_linux_interrupt, &ethernet_linux_wdt, NULL);
+
+#ifdef CONFIG_SEMAPHORE
+    /* Rather locking the global interrupts lock only the TAP interrupt. */
+    semaphore_set_interrupt_data(&device->ethernet_device.lock, device, &ethernet_linux_int_lock, &ethernet_linux_int_unlock);
+#endif
+
+#ifdef NET_ARP
+    /* Set ARP data for this ethernet device. */
+    arp_set_data(fd, device->arp_entries, ETHERNET_TAP_NUM_ARP);
+#endif
+
+#ifdef IPV4_ENABLE_FRAG
+    /* Initialize fragment data for this device. */
+    ipv4_fragment_set_data(fd, device->ipv4_fragments, ETHERNET_TAP_NUM_IPV4_FRAGS);
+#endif
+
+#ifdef DHCP_CLIENT
+    /* Initialize the DHCP client data for this device. */
+    net_dhcp_client_initialize_device(net_device_get_fd(fd), &device->dhcp_client);
+#endif
+
+#ifdef ETHERNET_TAP_PCAP
+    /* Open the capture file. */
+    ethernet_linux_pcap_open(device);
+#endif
+
+#ifndef NET_ARP
+    /* Remove some compiler warnings. */
+    UNUSED_PARAM(fd);
+#endif
+
+} /* ethernet_linux_init */
+
+/*
+ * ethernet_linux_open
+ * @device: TAP device instance.
+ * @return: Success will be returned if TAP interface was successfully opened,
+ *  ETHERNET_TAP_OPEN_ERROR will be returned if we were not able to open the
+ *  TAP interface.
+ * This function will open the host TAP interface and register it as an
+ * interrupt source.
+ */
+static int32_t ethernet_linux_open(ETHERNET_TAP *device)
+{
+    struct ifreq ifr;
+    int32_t status = SUCCESS;
+
+    /* Open the TUN/TAP clone device. */
+    device->tap_fd = open("/dev/net/tun", O_RDWR);
+
+    /* If clone device was not opened. */
+    if (device->tap_fd < 0)
+    {
+        /* Return an error. */
+        status = ETHERNET_TAP_OPEN_ERROR;
+    }
+
+    if (status == SUCCESS)
+    {
+        /* Attach to the configured TAP interface, we don't need the packet
+         * information header. */
+        memset(&ifr, 0, sizeof(struct ifreq));
+        ifr.ifr_flags = (IFF_TAP | IFF_NO_PI);
+        strncpy(ifr.ifr_name, ETHERNET_TAP_NAME, (IFNAMSIZ - 1));
+
+        /* If we were not able to attach to the TAP interface. */
+        if (ioctl(device->tap_fd, TUNSETIFF, &ifr) < 0)
+        {
+            /* Close the clone device. */
+            close(device->tap_fd);
+
+            /* Return an error. */
+            status = ETHERNET_TAP_OPEN_ERROR;
+        }
+    }
+
+    if (status == SUCCESS)
+    {
+        /* Register TAP file descriptor as an interrupt source. */
+        device->int_source = posix_interrupt_register(device->tap_fd, &ethernet_linux_isr, device);
+
+        /* If we were not able to register the interrupt source. */
+        if (device->int_source < 0)
+        {
+            /* Close the TAP interface. */
+            close(device->tap_fd);
+
+            /* Return an error. */
+            status = ETHERNET_TAP_OPEN_ERROR;
+        }
+    }
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* ethernet_linux_open */
+
+/*
+ * ethernet_linux_initialize
+ * @data: TAP device instance needed to be initialized.
+ * This function will initialize the TAP device, a TAP interface is always
+ * up so link is also brought up here.
+ */
+static void ethernet_linux_initialize(void *data)
+{
+    ETHERNET_TAP *device = (ETHERNET_TAP *)data;
+    FD fd = (FD)&device->ethernet_device;
+
+    /* Generate a random MAC address for this device. */
+    ethernet_random_mac(&device->ethernet_device);
+
+    /* Set link-up for this device. */
+    net_device_link_up(fd);
+
+#ifndef DHCP_CLIENT
+    /* Set static IP address for this device. */
+    ipv4_set_device_address(fd, ETHERNET_TAP_DEFAULT_IP, ETHERNET_TAP_DEFAULT_SUBNET);
+#endif
+
+    /* Process any frames needed to be sent. */
+    device->ethernet_device.flags |= ETH_FLAG_TX;
+
+    /* Enable TAP interrupt, it will be actually enabled when the device lock
+     * is released. */
+    device->flags |= ETHERNET_TAP_INT_ENABLE;
+
+#ifndef CONFIG_SEMAPHORE
+    /* Enable the interrupt source. */
+    posix_interrupt_enable(device->int_source);
+#endif
+
+} /* ethernet_linux_initialize */
+
+/*
+ * ethernet_linux_isr
+ * @data: TAP device instance.
+ * This is interrupt handler for TAP file descriptor, it is called when TAP
+ * interface has some frames to read.
+ */
+static void ethernet_linux_isr(void *data)
+{
+    ETHERNET_TAP *device = (ETHERNET_TAP *)data;
+
+    /* Disable TAP interrupt until all the frames are read. */
+    device->flags &= (uint8_t)(~ETHERNET_TAP_INT_ENABLE);
+    posix_interrupt_disable(device->int_source);
+
+    /* Handle ethernet interrupt. */
+    ethernet_interrupt(&device->ethernet_device);
+
+} /* ethernet_linux_isr */
+
+/*
+ * ethernet_linux_interrupt
+ * @data: TAP device instance for which interrupt is needed to be processed.
+ * This function will read all the frames available on the TAP interface and
+ * pass them to the ethernet stack.
+ */
+static void ethernet_linux_interrupt(void *data)
+{
+    ETHERNET_TAP *device = (ETHERNET_TAP *)data;
+    FD fd = (FD)&device->ethernet_device;
+    FS_BUFFER_LIST *list;
+    FS_BUFFER *buffer;
+    ssize_t received;
+    uint32_t frame_length, copied;
+
+    /* While we have a frame to read. */
+    for (;;)
+    {
+        /* Read a frame from the TAP interface. */
+        received = read(device->tap_fd, device->frame, ETHERNET_TAP_MAX_FRAME);
+
+        /* If we don't have any more frames to read. */
+        if ((received == 0) || ((received < 0) && (errno != EINTR)))
+        {
+            break;
+        }
+
+#if (ETHERNET_TAP_LOSS > 0)
+        /* If this frame is lost on the link. */
+        if ((rand() % 100) < ETHERNET_TAP_LOSS)
+        {
+            /* Drop this frame. */
+            continue;
+        }
+#endif
+
+        /* If this is a valid frame. */
+        if (received > ETH_HRD_SIZE)
+        {
+            frame_length = (uint32_t)received;
+
+#ifdef ETHERNET_TAP_PCAP
+            /* Capture this frame. */
+            ethernet_linux_pcap_write(device, device->frame, frame_length);
+#endif
+
+            /* Host does not pad the short frames as they would have been on
+             * the wire, pad them here. */
+            if (frame_length < ETHERNET_TAP_MIN_FRAME)
+            {
+                memset(&device->frame[frame_length], 0, (ETHERNET_TAP_MIN_FRAME - frame_length));
+                frame_length = ETHERNET_TAP_MIN_FRAME;
+            }
+
+            /* Pull a buffer list from the file descriptor. */
+            list = fs_buffer_get(fd, FS_LIST_FREE, 0);
+
+            /* If we do have a receive buffer. */
+            if (list != NULL)
+            {
+                /* While we have some data to copy. */
+                for (copied = 0; copied < frame_length; copied += buffer->length)
+                {
+                    /* Pull a buffer in which we will copy the data. */
+                    buffer = fs_buffer_get(fd, FS_BUFFER_FREE, 0);
+
+                    /* If we don't have a buffer to copy data. */
+                    if (buffer == NULL)
+                    {
+                        break;
+                    }
+
+                    /* Copy as much data as we can in this buffer. */
+                    buffer->length = (frame_length - copied);
+                    if (buffer->length > buffer->max_length)
+                    {
+                        buffer->length = buffer->max_length;
+                    }
+                    memcpy(buffer->buffer, &device->frame[copied], buffer->length);
+
+                    /* Append this new buffer to the buffer chain. */
+                    fs_buffer_list_append(list, buffer, 0);
+                }
+
+                /* If we were not able to receive a complete frame due to
+                 * unavailability of buffers, or ethernet stack did not consume
+                 * this buffer. */
+                if ((copied != frame_length) || (ethernet_buffer_receive(list) != NET_BUFFER_CONSUMED))
+                {
+                    /* Free the buffers that we allocated. */
+                    fs_buffer_add(list->fd, list, FS_LIST_FREE, FS_BUFFER_ACTIVE);
+                }
+            }
+        }
+    }
+
+    /* Enable TAP interrupt, it will be actually enabled when the device lock
+     * is released. */
+    device->flags |= ETHERNET_TAP_INT_ENABLE;
+
+#ifndef CONFIG_SEMAPHORE
+    /* Enable the interrupt source. */
+    posix_interrupt_enable(device->int_source);
+#endif
+
+} /* ethernet_linux_interrupt */
+
+/*
+ * ethernet_linux_transmit
+ * @data: TAP device instance on which frame is needed to be sent.
+ * @buffer: Buffer needed to be sent.
+ * @return: Always return success, if host was not able to send this frame it
+ *  is dropped.
+ * This function will send a frame on the TAP interface, if configured the
+ * frame is randomly dropped or delayed to emulate a lossy or a long link.
+ */
+static int32_t ethernet_linux_transmit(void *data, FS_BUFFER_LIST *buffer)
+{
+    ETHERNET_TAP *device = (ETHERNET_TAP *)data;
+    FS_BUFFER *one = buffer->list.head;
+    uint32_t frame_length = 0;
+#if (ETHERNET_TAP_DELAY > 0)
+    ETHERNET_TAP_DELAYED *delayed;
+#endif
+
+    /* If this frame can be sent on the TAP interface. */
+    if (buffer->total_length <= ETHERNET_TAP_MAX_FRAME)
+    {
+#if (ETHERNET_TAP_DELAY > 0)
+        /* If we have space to delay this frame. */
+        if (device->delayed_count < ETHERNET_TAP_DELAY_FRAMES)
+        {
+            /* Queue this frame at the tail of delayed frames. */
+            delayed = &device->delayed[(device->delayed_head + device->delayed_count) % ETHERNET_TAP_DELAY_FRAMES];
+
+            /* Copy the given buffer in the delayed frame. */
+            while (one != NULL)
+            {
+                memcpy(&delayed->frame[frame_length], one->buffer, one->length);
+                frame_length += one->length;
+
+                /* Pick the next one buffer. */
+                one = one->next;
+            }
+
+            /* Save the tick at which this frame will be sent. */
+            delayed->length = frame_length;
+            delayed->tick = current_system_tick() + MS_TO_TICK(ETHERNET_TAP_DELAY);
+
+            /* If this is the only delayed frame. */
+            if (device->delayed_count++ == 0)
+            {
+                /* Enable watch dog to send this frame. */
+                ethernet_wdt_enable(&device->ethernet_device, MS_TO_TICK(ETHERNET_TAP_DELAY));
+            }
+        }
+#else
+        /* Copy the given buffer in the frame buffer. */
+        while (one != NULL)
+        {
+            memcpy(&device->frame[frame_length], one->buffer, one->length);
+            frame_length += one->length;
+
+            /* Pick the next one buffer. */
+            one = one->next;
+        }
+
+        /* Send this frame. */
+        ethernet_linux_write(device, device->frame, frame_length);
+#endif
+    }
+
+    /* Always return success, a frame that was not sent is simply dropped as
+     * it would have been on the wire. */
+    return (SUCCESS);
+
+} /* ethernet_linux_transmit */
+
+/*
+ * ethernet_linux_write
+ * @device: TAP device instance on which frame is needed to be sent.
+ * @frame: Frame needed to be sent.
+ * @length: Length of the frame.
+ * This function will write a frame on the TAP interface.
+ */
+static void ethernet_linux_write(ETHERNET_TAP *device, uint8_t *frame, uint32_t length)
+{
+    ssize_t sent;
+
+#if (ETHERNET_TAP_LOSS > 0)
+    /* If this frame is lost on the link. */
+    if ((rand() % 100) < ETHERNET_TAP_LOSS)
+    {
+        /* Drop this frame. */
+        return;
+    }
+#endif
+
+#ifdef ETHERNET_TAP_PCAP
+    /* Capture this frame. */
+    ethernet_linux_pcap_write(device, frame, length);
+#endif
+
+    /* Send this frame, TAP interface will either send whole of it or none of
+     * it. */
+    do
+    {
+        sent = write(device->tap_fd, frame, length);
+    } while ((sent < 0) && (errno == EINTR));
+
+} /* ethernet_linux_write */
+
+/*
+ * ethernet_linux_wdt
+ * @data: TAP device instance.
+ * Frames are sent synchronously on TAP interface, watch dog is only enabled
+ * when frames are being delayed and it will send the frames that are due.
+ */
+static void ethernet_linux_wdt(void *data)
+{
+#if (ETHERNET_TAP_DELAY > 0)
+    ETHERNET_TAP *device = (ETHERNET_TAP *)data;
+    ETHERNET_TAP_DELAYED *delayed;
+
+    /* While we have a delayed frame. */
+    while (device->delayed_count > 0)
+    {
+        /* Pick the oldest delayed frame. */
+        delayed = &device->delayed[device->delayed_head];
+
+        /* If this frame is not yet due. */
+        if (INT32CMP(delayed->tick, current_system_tick()) > 0)
+        {
+            /* Enable watch dog to send this frame when it is due. */
+            ethernet_wdt_enable(&device->ethernet_device, (delayed->tick - current_system_tick()));
+
+            break;
+        }
+
+        /* Send this frame. */
+        ethernet_linux_write(device, delayed->frame, delayed->length);
+
+        /* Remove this frame from the delayed frames. */
+        device->delayed_head = ((device->delayed_head + 1) % ETHERNET_TAP_DELAY_FRAMES);
+        device->delayed_count--;
+    }
+#else
+    /* Remove some compiler warnings. */
+    UNUSED_PARAM(data);
+#endif
+
+} /* ethernet_linux_wdt */
+
+#ifdef CONFIG_SEMAPHORE
+/*
+ * ethernet_linux_int_lock
+ * @data: TAP device instance.
+ * This function will disable TAP interrupt while ethernet device lock is
+ * being held.
+ */
+static void ethernet_linux_int_lock(void *data)
+{
+    ETHERNET_TAP *device = (ETHERNET_TAP *)data;
+
+    /* Disable the interrupt source. */
+    posix_interrupt_disable(device->int_source);
+
+} /* ethernet_linux_int_lock */
+
+/*
+ * ethernet_linux_int_unlock
+ * @data: TAP device instance.
+ * This function will enable TAP interrupt if it is not being processed.
+ */
+static void ethernet_linux_int_unlock(void *data)
+{
+    ETHERNET_TAP *device = (ETHERNET_TAP *)data;
+
+    /* If interrupt is enabled for this device. */
+    if (device->flags & ETHERNET_TAP_INT_ENABLE)
+    {
+        /* Enable the interrupt source. */
+        posix_interrupt_enable(device->int_source);
+    }
+
+} /* ethernet_linux_int_unlock */
+#endif /* CONFIG_SEMAPHORE */
+
+#ifdef ETHERNET_TAP_PCAP
+/*
+ * ethernet_linux_pcap_open
+ * @device: TAP device instance.
+ * This function will open the capture file and write the pcap global header,
+ * if file cannot be opened frames are not captured.
+ */
+static void ethernet_linux_pcap_open(ETHERNET_TAP *device)
+{
+    ETHERNET_TAP_PCAP_HEADER header;
+
+    /* Open the capture file. */
+    device->pcap = fopen(ETHERNET_TAP_PCAP_FILE, "wb");
+
+    /* If capture file was opened. */
+    if (device->pcap != NULL)
+    {
+        /* Initialize the global header. */
+        header.magic = ETHERNET_TAP_PCAP_MAGIC;
+        header.version_major = ETHERNET_TAP_PCAP_MAJOR;
+        header.version_minor = ETHERNET_TAP_PCAP_MINOR;
+        header.thiszone = 0;
+        header.sigfigs = 0;
+        header.snaplen = ETHERNET_TAP_PCAP_SNAPLEN;
+        header.network = ETHERNET_TAP_PCAP_ETHERNET;
+
+        /* Write the global header. */
+        fwrite(&header, sizeof(ETHERNET_TAP_PCAP_HEADER), 1, device->pcap);
+        fflush(device->pcap);
+    }
+
+} /* ethernet_linux_pcap_open */
+
+/*
+ * ethernet_linux_pcap_write
+ * @device: TAP device instance.
+ * @frame: Frame needed to be captured.
+ * @length: Length of the frame.
+ * This function will write a frame in the capture file.
+ */
+static void ethernet_linux_pcap_write(ETHERNET_TAP *device, uint8_t *frame, uint32_t length)
+{
+    ETHERNET_TAP_PCAP_RECORD record;
+    struct timeval now;
+
+    /* If capture file is open. */
+    if (device->pcap != NULL)
+    {
+        /* Initialize the record header. */
+        gettimeofday(&now, NULL);
+        record.ts_sec = (uint32_t)now.tv_sec;
+        record.ts_usec = (uint32_t)now.tv_usec;
+        record.incl_len = length;
+        record.orig_len = length;
+
+        /* Write this frame. */
+        fwrite(&record, sizeof(ETHERNET_TAP_PCAP_RECORD), 1, device->pcap);
+        fwrite(frame, length, 1, device->pcap);
+        fflush(device->pcap);
+    }
+
+} /* ethernet_linux_pcap_write */
+#endif /* ETHERNET_TAP_PCAP */
+
+#endif /* IO_ETHERNET */
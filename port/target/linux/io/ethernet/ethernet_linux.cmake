@@ -0,0 +1,16 @@
+# Setup configuration options.
+setup_option_def(ETHERNET_TAP_NAME "tap0" STRING "Name of the host TAP interface used as ethernet device." CONFIG_FILE "ethernet_linux_config")
+setup_option_def(ETHERNET_TAP_PCAP OFF DEFINE "Enables capture of all the frames sent and received on the TAP device in a pcap file." CONFIG_FILE "ethernet_linux_config")
+setup_option_def(ETHERNET_TAP_PCAP_FILE "ethernet.pcap" STRING "Name of the pcap capture file." CONFIG_FILE "ethernet_linux_config")
+setup_option_def(ETHERNET_TAP_MAX_BUFFER_SIZE 128 INT "Size of each buffer for TAP device." CONFIG_FILE "ethernet_linux_config")
+setup_option_def(ETHERNET_TAP_NUM_BUFFERS 64 INT "Number of buffers for TAP device." CONFIG_FILE "ethernet_linux_config")
+setup_option_def(ETHERNET_TAP_NUM_BUFFER_LISTS 32 INT "Number of buffer lists for TAP device." CONFIG_FILE "ethernet_linux_config")
+setup_option_def(ETHERNET_TAP_NUM_THR_BUFFER 8 INT "Number of threshold buffers for TAP device." CONFIG_FILE "ethernet_linux_config")
+setup_option_def(ETHERNET_TAP_NUM_THR_LIST 4 INT "Number of threshold buffer lists for TAP device." CONFIG_FILE "ethernet_linux_config")
+setup_option_def(ETHERNET_TAP_NUM_ARP 4 INT "Number of ARP entries for TAP device." CONFIG_FILE "ethernet_linux_config")
+setup_option_def(ETHERNET_TAP_NUM_IPV4_FRAGS 2 INT "Number of IPv4 fragments for TAP device." CONFIG_FILE "ethernet_linux_config")
+setup_option_def(ETHERNET_TAP_DEFAULT_IP 0xC0A80001 INT "Default IP address for TAP device if DHCP client is disabled." CONFIG_FILE "ethernet_linux_config")
+setup_option_def(ETHERNET_TAP_DEFAULT_SUBNET 0xFFFFFF00 INT "Default subnet mask for TAP device if DHCP client is disabled." CONFIG_FILE "ethernet_linux_config")
+setup_option_def(ETHERNET_TAP_LOSS 0 INT "Percentage of frames randomly dropped in each direction on TAP device to emulate a lossy link." CONFIG_FILE "ethernet_linux_config")
+setup_option_def(ETHERNET_TAP_DELAY 0 INT "Milliseconds by which frames sent on TAP device are delayed to emulate a long link." CONFIG_FILE "ethernet_linux_config")
+setup_option_def(ETHERNET_TAP_DELAY_FRAMES 64 INT "Number of frames that can be delayed on TAP device, frames sent when this is full are dropped." CONFIG_FILE "ethernet_linux_config")
\ No newline at end of file
@@ -0,0 +1,144 @@
+/*
+ * ethernet_linux.h
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#ifndef _ETHERNET_LINUX_H_
+#define _ETHERNET_LINUX_H_
+#include <kernel.h>
+
+#ifdef IO_ETHERNET
+#include <ethernet.h>
+#ifdef DHCP_CLIENT
+#include <net_dhcp_client.h>
+#endif
+#include <ethernet_linux_config.h>
+#ifdef ETHERNET_TAP_PCAP
+#include <stdio.h>
+#endif
+
+/* Error code definitions. */
+#define ETHERNET_TAP_OPEN_ERROR     -11100
+
+/* TAP device flag definitions. */
+#define ETHERNET_TAP_INT_ENABLE     (0x1)
+
+/* pcap file definitions. */
+#define ETHERNET_TAP_PCAP_MAGIC     (0xA1B2C3D4)
+#define ETHERNET_TAP_PCAP_MAJOR     (2)
+#define ETHERNET_TAP_PCAP_MINOR     (4)
+#define ETHERNET_TAP_PCAP_SNAPLEN   (65535)
+#define ETHERNET_TAP_PCAP_ETHERNET  (1)
+
+/* Minimum and maximum frame size we will send or receive. */
+#define ETHERNET_TAP_MIN_FRAME      (60)
+#define ETHERNET_TAP_MAX_FRAME      (ETH_MTU_SIZE + ETH_HRD_SIZE)
+
+#if (ETHERNET_TAP_DELAY > 0)
+/* A frame delayed on the TAP device. */
+typedef struct _ethernet_tap_delayed
+{
+    /* Tick at which this frame is needed to be sent. */
+    uint32_t    tick;
+
+    /* Frame length. */
+    uint32_t    length;
+
+    /* Frame data. */
+    uint8_t     frame[ETHERNET_TAP_MAX_FRAME];
+
+    /* Structure padding. */
+    uint8_t     pad[2];
+
+} ETHERNET_TAP_DELAYED;
+#endif
+
+/* TAP device structure. */
+typedef struct _ethernet_tap_device
+{
+    /* Ethernet device structure. */
+    ETH_DEVICE  ethernet_device;
+
+#ifdef DHCP_CLIENT
+    /* DHCP client data. */
+    DHCP_CLIENT_DEVICE  dhcp_client;
+#endif
+
+#ifdef IPV4_ENABLE_FRAG
+    /* IPv4 fragment list. */
+    IPV4_FRAGMENT   ipv4_fragments[ETHERNET_TAP_NUM_IPV4_FRAGS];
+#endif
+
+#ifdef NET_ARP
+    /* ARP entry list. */
+    ARP_ENTRY   arp_entries[ETHERNET_TAP_NUM_ARP];
+#endif
+
+    /* File system buffers. */
+    FS_BUFFER_DATA  fs_buffer_data;
+    uint8_t         buffer[ETHERNET_TAP_MAX_BUFFER_SIZE * ETHERNET_TAP_NUM_BUFFERS];
+    FS_BUFFER       fs_buffer[ETHERNET_TAP_NUM_BUFFERS];
+    FS_BUFFER_LIST  fs_list_free[ETHERNET_TAP_NUM_BUFFER_LISTS];
+
+    /* Frame buffer used to send and receive frames from the host. */
+    uint8_t     frame[ETHERNET_TAP_MAX_FRAME];
+
+#if (ETHERNET_TAP_DELAY > 0)
+    /* Frames delayed on this device, sent in the order they were queued. */
+    ETHERNET_TAP_DELAYED    delayed[ETHERNET_TAP_DELAY_FRAMES];
+    uint32_t    delayed_head;
+    uint32_t    delayed_count;
+#endif
+
+#ifdef ETHERNET_TAP_PCAP
+    /* pcap capture file. */
+    FILE        *pcap;
+#endif
+
+    /* TAP file descriptor. */
+    int         tap_fd;
+
+    /* Interrupt source for the TAP file descriptor. */
+    int32_t     int_source;
+
+    /* Device flags. */
+    uint8_t     flags;
+
+    /* Structure padding. */
+    uint8_t     pad[3];
+
+} ETHERNET_TAP;
+
+/* pcap global header. */
+typedef struct _ethernet_tap_pcap_header
+{
+    uint32_t    magic;
+    uint16_t    version_major;
+    uint16_t    version_minor;
+    int32_t     thiszone;
+    uint32_t    sigfigs;
+    uint32_t    snaplen;
+    uint32_t    network;
+} ETHERNET_TAP_PCAP_HEADER;
+
+/* pcap record header. */
+typedef struct _ethernet_tap_pcap_record
+{
+    uint32_t    ts_sec;
+    uint32_t    ts_usec;
+    uint32_t    incl_len;
+    uint32_t    orig_len;
+} ETHERNET_TAP_PCAP_RECORD;
+
+/* Function prototypes. */
+void ethernet_linux_init(void);
+
+#endif /* IO_ETHERNET */
+#endif /* _ETHERNET_LINUX_H_ */
@@ -0,0 +1,18 @@
+/*
+ * ppp_target.h
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#ifndef _PPP_TARGET_H_
+#define _PPP_TARGET_H_
+
+/* No PPP device is hooked-up on host, PPP is only used by the benchmarks. */
+
+#endif /* _PPP_TARGET_H_ */
@@ -0,0 +1,159 @@
+/*
+ * serial_linux.c
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+#ifdef IO_SERIAL
+#include <serial_linux.h>
+#include <errno.h>
+#include <unistd.h>
+
+/* Internal function prototypes. */
+static int32_t serial_linux_init_device(void *);
+static int32_t serial_linux_puts(void *, void *, const uint8_t *, int32_t, uint32_t);
+static int32_t serial_linux_gets(void *, void *, uint8_t *, int32_t, uint32_t);
+
+/* Host console. */
+static LINUX_SERIAL linux_console;
+
+/*
+ * serial_linux_init
+ * This will initialize serial interface(s) for this target, host standard
+ * input and output are registered as the debug console.
+ */
+void serial_linux_init(void)
+{
+    /* Use standard input and output of this process. */
+    linux_console.in_fd = STDIN_FILENO;
+    linux_console.out_fd = STDOUT_FILENO;
+
+    /* Initialize serial device data. */
+    linux_console.serial.device.init = &serial_linux_init_device;
+    linux_console.serial.device.puts = &serial_linux_puts;
+    linux_console.serial.device.gets = &serial_linux_gets;
+    linux_console.serial.device.data = &linux_console;
+
+    /* Register this console as a serial device. */
+    serial_register(&linux_console.serial, "stdio", NULL, SERIAL_DEBUG);
+
+} /* serial_linux_init */
+
+/*
+ * serial_linux_init_device
+ * @data: Linux serial device data.
+ * @return: Will always return success.
+ * This function initializes host console, nothing is needed to be done here.
+ */
+static int32_t serial_linux_init_device(void *data)
+{
+    /* Remove some compiler warnings. */
+    UNUSED_PARAM(data);
+
+    /* Always return success. */
+    return (SUCCESS);
+
+} /* serial_linux_init_device */
+
+/*
+ * serial_linux_puts
+ * @fd: Serial file descriptor.
+ * @priv_data: Linux serial device data.
+ * @buf: Data needed to be sent over the console.
+ * @nbytes: Number of bytes to be printed from the buffer.
+ * @flags: For now unused.
+ * @return: Number of bytes printed on the console.
+ * This function writes a buffer on the host console.
+ */
+static int32_t serial_linux_puts(void *fd, void *priv_data, const uint8_t *buf, int32_t nbytes, uint32_t flags)
+{
+    LINUX_SERIAL *console = (LINUX_SERIAL *)priv_data;
+    int32_t to_print = nbytes;
+    ssize_t written;
+
+    /* Remove some compiler warnings. */
+    UNUSED_PARAM(fd);
+    UNUSED_PARAM(flags);
+
+    /* While we have some data to be printed. */
+    while (nbytes > 0)
+    {
+        /* Write the remaining data. */
+        written = write(console->out_fd, buf, (size_t)nbytes);
+
+        /* If some data was written. */
+        if (written > 0)
+        {
+            /* Move forward in the buffer. */
+            nbytes -= (int32_t)written;
+            buf += written;
+        }
+
+        /* If console is no longer usable. */
+        else if ((written == 0) || ((errno != EINTR) && (errno != EAGAIN)))
+        {
+            break;
+        }
+    }
+
+    /* Return number of bytes printed. */
+    return (to_print - nbytes);
+
+} /* serial_linux_puts */
+
+/*
+ * serial_linux_gets
+ * @fd: Serial file descriptor.
+ * @priv_data: Linux serial device data.
+ * @buf: Data received will be returned in this buffer.
+ * @nbytes: Number of bytes to be read from the console.
+ * @flags: For now unused.
+ * @return: Number of bytes read from the console.
+ * This function reads data from host console, the calling task will block
+ * until data is available but other tasks will still be scheduled on the
+ * system tick.
+ */
+static int32_t serial_linux_gets(void *fd, void *priv_data, uint8_t *buf, int32_t nbytes, uint32_t flags)
+{
+    LINUX_SERIAL *console = (LINUX_SERIAL *)priv_data;
+    int32_t to_read = nbytes;
+    ssize_t received;
+
+    /* Remove some compiler warnings. */
+    UNUSED_PARAM(fd);
+    UNUSED_PARAM(flags);
+
+    /* While we have some data to be read. */
+    while (nbytes > 0)
+    {
+        /* Read the remaining data. */
+        received = read(console->in_fd, buf, (size_t)nbytes);
+
+        /* If some data was received. */
+        if (received > 0)
+        {
+            /* Move forward in the buffer. */
+            nbytes -= (int32_t)received;
+            buf += received;
+        }
+
+        /* If console is no longer usable. */
+        else if ((received == 0) || (errno != EINTR))
+        {
+            break;
+        }
+    }
+
+    /* Return number of bytes read. */
+    return (to_read - nbytes);
+
+} /* serial_linux_gets */
+
+#endif /* IO_SERIAL */
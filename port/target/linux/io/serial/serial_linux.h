@@ -0,0 +1,36 @@
+/*
+ * serial_linux.h
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#ifndef _SERIAL_LINUX_H_
+#define _SERIAL_LINUX_H_
+
+#include <kernel.h>
+#ifdef IO_SERIAL
+#include <serial.h>
+
+/* Linux console device. */
+typedef struct _linux_serial
+{
+    /* Serial device. */
+    SERIAL      serial;
+
+    /* Host file descriptors. */
+    int         in_fd;
+    int         out_fd;
+
+} LINUX_SERIAL;
+
+/* Function prototypes. */
+void serial_linux_init(void);
+
+#endif /* IO_SERIAL */
+#endif /* _SERIAL_LINUX_H_ */
@@ -0,0 +1,21 @@
+/*
+ * serial_target.h
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#ifndef _SERIAL_TARGET_H_
+#define _SERIAL_TARGET_H_
+#include <kernel.h>
+#include <serial_linux.h>
+
+/* Hook-up serial OS stack. */
+#define SERIAL_TGT_INIT  serial_linux_init
+
+#endif /* _SERIAL_TARGET_H_ */
@@ -54,8 +54,14 @@ void fs_stm32_init(void)
     mmc_spi.spi.slave_unselect = &spi_stm32f103_slave_unselect;
     mmc_spi.spi.msg = &spi_stm32f103_message;
 
+#ifdef MMC_SPI_CACHE
+    /* Register this device with FatFile system through the sector cache. */
+    disk_register(&mmc_spi, &mmc_spi_init, &mmc_spi_cache_read, &mmc_spi_cache_write, MMC_SPI_SECTOR_SIZE, 0);
+    disk_register_sync(0, &mmc_spi_cache_sync);
+#else
     /* Register this device with FatFile system. */
     disk_register(&mmc_spi, &mmc_spi_init, &mmc_spi_read, &mmc_spi_write, MMC_SPI_SECTOR_SIZE, 0);
+#endif /* MMC_SPI_CACHE */
 
     /* Mount this drive later. */
     f_mount(&fat_fs, mount_point, 0);
@@ -16,9 +16,13 @@
 
 #ifdef IO_PPP
 #include <ppp_stm32_config.h>
+#include <ppp_fcs.h>
 
 /* Function prototypes. */
 void ppp_stm32f103_init(void);
+#ifdef PPP_FCS32
+uint32_t ppp_stm32f103_fcs32(FS_BUFFER_LIST *);
+#endif
 
 #endif /* IO_PPP */
 #endif /* _PPP_STM32F103_H_ */
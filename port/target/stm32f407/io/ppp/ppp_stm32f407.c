@@ -35,4 +35,90 @@ void ppp_stm32f407_init(void)
 
 } /* ppp_stm32f407_init */
 
+#ifdef PPP_FCS32
+/*
+ * ppp_stm32f407_fcs32
+ * @buffer: File system buffer chain for which 32-bit FCS is needed to be
+ *  calculated.
+ * @return: Calculated FCS value.
+ * This function will calculate the 32-bit FCS for the given buffer using the
+ * CRC unit. CRC unit processes a word at a time most significant bit first,
+ * so each word is bit reversed before it is written and the result is bit
+ * reversed after it is read. Any trailing bytes are processed in software.
+ */
+uint32_t ppp_stm32f407_fcs32(FS_BUFFER_LIST *buffer)
+{
+    FS_BUFFER *one;
+    uint32_t word = 0, num_bytes = 0, length, fcs, i;
+    uint8_t *data, tail[4];
+
+    /* Lock the scheduler as we are using the CRC unit. */
+    scheduler_lock();
+
+    /* Enable clock for the CRC unit and reset it. */
+    RCC->AHB1ENR |= RCC_AHB1ENR_CRCEN;
+    CRC->CR = CRC_CR_RESET;
+
+    /* Process all the buffers in the buffer chain. */
+    for (one = buffer->list.head; one != NULL; one = one->next)
+    {
+        /* Pick the data for this buffer. */
+        data = one->buffer;
+        length = one->length;
+
+        /* While we have some data in this buffer. */
+        while (length > 0)
+        {
+            /* If we don't have a partial word and data is aligned. */
+            if ((num_bytes == 0) && (((uintptr_t)data & 0x3) == 0))
+            {
+                /* Write all the words in this buffer. */
+                while (length >= 4)
+                {
+                    CRC->DR = __RBIT(*((uint32_t *)data));
+                    data += 4;
+                    length -= 4;
+                }
+            }
+
+            /* If we still have a byte. */
+            if (length > 0)
+            {
+                /* Collect this byte in the word. */
+                word |= ((uint32_t)*data << (num_bytes << 3));
+                num_bytes ++;
+                data ++;
+                length --;
+
+                /* If we have collected a word. */
+                if (num_bytes == 4)
+                {
+                    /* Write this word. */
+                    CRC->DR = __RBIT(word);
+                    word = 0;
+                    num_bytes = 0;
+                }
+            }
+        }
+    }
+
+    /* Pick the FCS from the CRC unit. */
+    fcs = __RBIT(CRC->DR);
+
+    /* Enable scheduling. */
+    scheduler_unlock();
+
+    /* Process any trailing bytes. */
+    for (i = 0; i < num_bytes; i++)
+    {
+        tail[i] = (uint8_t)(word >> (i << 3));
+    }
+    fcs = ppp_fcs32_calculate(tail, num_bytes, fcs);
+
+    /* Return the calculated FCS. */
+    return (fcs);
+
+} /* ppp_stm32f407_fcs32 */
+#endif /* PPP_FCS32 */
+
 #endif /* IO_PPP */
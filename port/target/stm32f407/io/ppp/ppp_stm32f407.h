@@ -15,9 +15,13 @@
 #include <kernel.h>
 
 #ifdef IO_PPP
+#include <ppp_fcs.h>
 
 /* Function prototypes. */
 void ppp_stm32f407_init(void);
+#ifdef PPP_FCS32
+uint32_t ppp_stm32f407_fcs32(FS_BUFFER_LIST *);
+#endif
 
 #endif /* IO_PPP */
 #endif /* _PPP_STM32F407_H_ */
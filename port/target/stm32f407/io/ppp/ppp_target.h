@@ -20,5 +20,10 @@
 /* Hook-up PPP OS stack. */
 #define PPP_TGT_INIT  ppp_stm32f407_init
 
+#ifdef PPP_FCS32
+/* Hook-up CRC unit to calculate 32-bit FCS. */
+#define PPP_TGT_FCS32 ppp_stm32f407_fcs32
+#endif
+
 #endif /* IO_PPP */
 #endif /* _PPP_TARGET_H_ */
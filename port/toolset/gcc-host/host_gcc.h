@@ -0,0 +1,41 @@
+/*
+ * host_gcc.h
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+
+/* On host all the functions are normal functions, stack is always managed by
+ * the compiler and interrupts are delivered as signals. */
+
+#ifndef _HOST_GCC_H_
+#define _HOST_GCC_H_
+
+#include <endian.h>
+
+#define STACK_LESS
+#define NOINLINE            __attribute__ ((noinline))
+
+#define ISR_FUN             void
+#define NAKED_ISR_FUN       void
+#define NAKED_FUN           void
+
+#define NOOPTIMIZATION      __attribute__((optimize("O0")))
+#define SPEEDOPTIMIZATION   __attribute__((optimize("O3")))
+
+/* C library always defines both the byte orders, only keep the one used by
+ * this host. */
+#if (__BYTE_ORDER != __LITTLE_ENDIAN)
+#undef LITTLE_ENDIAN
+#endif
+
+/* If buffered IO is required. */
+#define IO_BUFFERED
+
+#endif /* _HOST_GCC_H_ */
@@ -46,6 +46,12 @@ void fs_init(void)
 #ifdef CONFIG_SEMAPHORE
     /* Create a semaphore to protect global file system data. */
     semaphore_create(&file_data.lock, 1);
+
+#ifdef SEMAPHORE_PRIORITY_INHERIT
+    /* Lower priority tasks holding this lock should not block the higher
+     * priority tasks. */
+    semaphore_set_inherit(&file_data.lock);
+#endif /* SEMAPHORE_PRIORITY_INHERIT */
 #endif
 
 #ifdef FS_CONSOLE
@@ -1103,6 +1103,66 @@ int32_t fs_buffer_list_pull_offset(FS_BUFFER_LIST *list, void *data, uint32_t si
 
 } /* fs_buffer_list_pull_offset */
 
+/*
+ * fs_buffer_list_peek
+ * @list: Buffer list from which data is needed to be peeked.
+ * @bounce: Buffer in which data will be copied if it does not lie in a single
+ *  buffer, must be at least of the given size.
+ * @size: Number of bytes needed to be peeked.
+ * @offset: Number of bytes from start at which the required data lies.
+ * @return: Pointer to the contiguous data will be returned, NULL will be
+ *  returned if there is not enough data on the list.
+ * This function will return a direct pointer to the data if it lies in a
+ * single buffer, otherwise data is copied in the given bounce buffer. Data is
+ * not removed from the list and returned pointer is only valid until the list
+ * is modified. No byte order conversion is done on the returned data.
+ */
+void *fs_buffer_list_peek(FS_BUFFER_LIST *list, void *bounce, uint32_t size, uint32_t offset)
+{
+    FS_BUFFER *buffer;
+    uint32_t this_offset = offset;
+    void *data = NULL;
+
+    /* If we do have the required data on this list. */
+    if (list->total_length >= (size + offset))
+    {
+        /* Pick the head buffer. */
+        buffer = list->list.head;
+
+        /* Skip the buffers that lie before the given offset. */
+        while ((buffer != NULL) && (this_offset >= buffer->length))
+        {
+            /* Remove this buffer from the offset. */
+            this_offset -= buffer->length;
+
+            /* Pick the next buffer. */
+            buffer = buffer->next;
+        }
+
+        /* We should have a buffer here. */
+        ASSERT(buffer == NULL);
+
+        /* If required data lies in this buffer. */
+        if ((this_offset + size) <= buffer->length)
+        {
+            /* Return pointer to the data in this buffer. */
+            data = &buffer->buffer[this_offset];
+        }
+        else
+        {
+            /* Copy the data in the bounce buffer. */
+            ASSERT(fs_buffer_list_pull_offset(list, bounce, size, offset, FS_BUFFER_INPLACE) != SUCCESS);
+
+            /* Return the bounce buffer. */
+            data = bounce;
+        }
+    }
+
+    /* Return the data pointer to the caller. */
+    return (data);
+
+} /* fs_buffer_list_peek */
+
 /*
  * fs_buffer_list_push_offset
  * @list: Buffer list on which data is needed to be pushed.
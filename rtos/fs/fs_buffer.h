@@ -82,6 +82,31 @@ struct _fs_buffer_list
     /* Private data to be passed to the user. */
     void                *free_data;
 
+#ifdef CONFIG_NET
+    /* Out of band packet meta data, maintained by the networking stack so it
+     * is not required to be pushed in the buffer data. */
+    struct _fs_buffer_list_meta
+    {
+        /* Packet flags, e.g. broadcast or verified checksums. */
+        uint32_t        flags;
+
+        /* Partial checksum of the payload at the end of the data, computed
+         * when the payload was copied. */
+        uint32_t        csum;
+        uint16_t        csum_length;
+
+        /* Offset of the transport header, network header always lies at
+         * the start of the data. */
+        uint16_t        l4_offset;
+
+        /* Network protocol for this packet. */
+        uint8_t         proto;
+
+        /* Structure padding. */
+        uint8_t         pad[3];
+    } meta;
+#endif /* CONFIG_NET */
+
 };
 
 /* File system buffer data, need by a buffered file descriptor. */
@@ -181,6 +206,7 @@ void *fs_buffer_get(FD, uint32_t, uint32_t);
 /* File system buffer list manipulation APIs. */
 #define fs_buffer_list_pull(b, d, l, f) fs_buffer_list_pull_offset((b), (d), (l), 0, (f))
 int32_t fs_buffer_list_pull_offset(FS_BUFFER_LIST *, void *, uint32_t, uint32_t, uint8_t);
+void *fs_buffer_list_peek(FS_BUFFER_LIST *, void *, uint32_t, uint32_t);
 #define fs_buffer_list_push(b, d, l, f) fs_buffer_list_push_offset((b), (d), (l), 0, (f))
 int32_t fs_buffer_list_push_offset(FS_BUFFER_LIST *, void *, uint32_t, uint8_t, uint8_t);
 int32_t fs_buffer_list_divide(FS_BUFFER_LIST *, uint32_t, uint32_t);
@@ -375,21 +375,24 @@ int32_t ethernet_buffer_receive(FS_BUFFER_LIST *buffer)
     uint32_t flags = 0;
     uint16_t proto;
     uint8_t net_proto;
-    uint8_t dst_mac[ETH_ADDR_LEN];
+    uint8_t hdr_buf[ETH_HRD_SIZE], *hdr;
 
-    /* Pull the destination and source addresses. */
-    ASSERT(fs_buffer_list_pull(buffer, dst_mac, (ETH_ADDR_LEN), 0) != SUCCESS);
-    ASSERT(fs_buffer_list_pull(buffer, NULL, (ETH_ADDR_LEN), 0) != SUCCESS);
+    /* Peek the ethernet header. */
+    hdr = fs_buffer_list_peek(buffer, hdr_buf, ETH_HRD_SIZE, 0);
+    ASSERT(hdr == NULL);
 
     /* If this was a broadcast frame. */
-    if (memcmp(dst_mac, ETH_BCAST_ADDR, ETH_ADDR_LEN) == 0)
+    if (memcmp(ETH_HDR_DST(hdr), ETH_BCAST_ADDR, ETH_ADDR_LEN) == 0)
     {
         /* Set the broadcast flag. */
         flags |= ETH_FRAME_BCAST;
     }
 
-    /* Pull the protocol. */
-    ASSERT(fs_buffer_list_pull(buffer, &proto, ETH_PROTO_LEN, FS_BUFFER_PACKED) != SUCCESS);
+    /* Pick the protocol. */
+    proto = ETH_HDR_TYPE(hdr);
+
+    /* Remove the ethernet header from the buffer. */
+    ASSERT(fs_buffer_list_pull(buffer, NULL, ETH_HRD_SIZE, 0) != SUCCESS);
 
     /* Process the protocol. */
     switch(proto)
@@ -460,7 +463,7 @@ static int32_t ethernet_buffer_transmit(FS_BUFFER_LIST *buffer, uint8_t flags)
 #ifdef NET_IPV4
     uint32_t dst_ip;
 #endif
-    uint8_t net_proto, dst_mac[ETH_ADDR_LEN];
+    uint8_t dst_mac[ETH_ADDR_LEN];
     HEADER eth_hdr[] =
     {
         {dst_mac,           ETH_ADDR_LEN,   (flags) },                      /* Destination address. */
@@ -468,10 +471,8 @@ static int32_t ethernet_buffer_transmit(FS_BUFFER_LIST *buffer, uint8_t flags)
         {(uint8_t *)&proto, 2,              (FS_BUFFER_PACKED | flags) },   /* Ethernet type. */
     };
 
-    /* Skim the protocol from the buffer. */
-    ASSERT(fs_buffer_list_pull(buffer, &net_proto, sizeof(uint8_t), 0) != SUCCESS);
-
-    switch (net_proto)
+    /* Process the protocol as saved by the networking stack. */
+    switch (buffer->meta.proto)
     {
 #ifdef NET_IPV4
     /* If an IPv4 packet is needed to be transmitted. */
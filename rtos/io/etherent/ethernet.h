@@ -37,6 +37,12 @@
 #define ETH_HDR_SRC_OFFSET  (6)
 #define ETH_HDR_TYPE_OFFSET (12)
 
+/* Ethernet header accessors, header must be contiguous, see
+ * fs_buffer_list_peek. */
+#define ETH_HDR_DST(h)      (&(h)[ETH_HDR_DST_OFFSET])
+#define ETH_HDR_SRC(h)      (&(h)[ETH_HDR_SRC_OFFSET])
+#define ETH_HDR_TYPE(h)     NET_GET_BE16(&(h)[ETH_HDR_TYPE_OFFSET])
+
 /* Ethernet definitions. */
 #define ETH_ADDR_LEN        (6)
 #define ETH_PROTO_LEN       (2)
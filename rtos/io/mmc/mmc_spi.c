@@ -14,8 +14,10 @@
 
 #ifdef IO_MMC
 #include <mmc_spi.h>
-#ifdef MMC_SPI_FS
+#if (defined(MMC_SPI_FS) || defined(MMC_SPI_CACHE))
 #include <string.h>
+#endif
+#ifdef MMC_SPI_FS
 #include <stdlib.h>
 #endif /* MMC_SPI_FS */
 
@@ -29,6 +31,16 @@ static int32_t mmc_spi_lock(void *, uint32_t);
 static void mmc_spi_unlock(void *);
 #endif /* MMC_SPI_FS */
 static int32_t mmc_spi_get_csd(MMC_SPI *, uint8_t *);
+#ifdef MMC_SPI_CACHE
+static void mmc_spi_cache_clear(MMC_SPI *);
+static MMC_SPI_CACHE_LINE *mmc_spi_cache_find(MMC_SPI *, uint32_t);
+static int32_t mmc_spi_cache_victim(MMC_SPI *, MMC_SPI_CACHE_LINE **);
+static int32_t mmc_spi_cache_fetch(MMC_SPI *, uint32_t, uint32_t);
+static int32_t mmc_spi_cache_flush(MMC_SPI *);
+static int32_t mmc_spi_cache_transfer(MMC_SPI *, uint8_t, uint32_t, uint8_t *);
+static int32_t mmc_spi_cache_end(MMC_SPI *);
+#endif /* MMC_SPI_CACHE */
+static int32_t mmc_spi_wait_line(MMC_SPI *, uint8_t *, uint8_t, uint32_t);
 static int32_t mmc_spi_rx_data(MMC_SPI *, uint8_t *, int32_t);
 static int32_t mmc_spi_cmd(MMC_SPI *, uint8_t, uint8_t, uint32_t, uint8_t *, int32_t);
 static int32_t mmc_slave_select(MMC_SPI *, uint8_t);
@@ -143,6 +155,17 @@ static void *mmc_spi_fsopen(void *priv_data, char *name, uint32_t flags)
         status = SUCCESS;
     }
 
+#ifdef MMC_SPI_CACHE
+    /* If name was successfully parsed. */
+    if (status == SUCCESS)
+    {
+        /* Write any pending sectors and drop the cache as we will be accessing
+         * the card directly. */
+        status = mmc_spi_cache_sync(mmc);
+        mmc_spi_cache_clear(mmc);
+    }
+#endif /* MMC_SPI_CACHE */
+
     /* If name was successfully parsed. */
     if (status == SUCCESS)
     {
@@ -447,9 +470,12 @@ int32_t mmc_spi_init(void *device)
     int32_t status = MMC_SPI_CMD_ERROR;
     SPI_MSG msg;
     uint8_t retries, resp[5];
-#ifdef SYS_LOG_ENABLE
+#if (defined(SYS_LOG_ENABLE) || defined(MMC_SPI_CACHE))
     uint64_t num_sector;
-#endif /* SYS_LOG_ENABLE */
+#endif
+#ifdef MMC_SPI_CACHE
+    uint8_t initialized = FALSE;
+#endif /* MMC_SPI_CACHE */
 
     SYS_LOG_FUNCTION_ENTRY(MMC);
 
@@ -653,6 +679,11 @@ int32_t mmc_spi_init(void *device)
         {
             /* Set the flag that MMC is now initialized. */
             mmc->flags |= MMC_SPI_INIT_COMPLETE;
+
+#ifdef MMC_SPI_CACHE
+            /* Cache is needed to be initialized. */
+            initialized = TRUE;
+#endif /* MMC_SPI_CACHE */
         }
     }
     else
@@ -666,6 +697,23 @@ int32_t mmc_spi_init(void *device)
     mmc_spi_unlock(mmc);
 #endif /* MMC_SPI_FS */
 
+#ifdef MMC_SPI_CACHE
+    /* If card was just initialized. */
+    if (initialized == TRUE)
+    {
+        /* Clear the cache. */
+        mmc_spi_cache_clear(mmc);
+        mmc->stream = 0;
+
+        /* Save number of sectors on the card to limit the read ahead. */
+        mmc->num_sectors = 0;
+        if ((mmc_spi_get_num_sectors(mmc, &num_sector) == SUCCESS) && (num_sector <= 0xFFFFFFFF))
+        {
+            mmc->num_sectors = (uint32_t)num_sector;
+        }
+    }
+#endif /* MMC_SPI_CACHE */
+
 #ifdef SYS_LOG_ENABLE
     if (status == SUCCESS)
     {
@@ -703,7 +751,7 @@ int32_t mmc_spi_read(void *device, uint32_t sector, uint64_t *offset, uint8_t *b
     int32_t this_size = 0, status = SUCCESS;
     uint32_t sector_offset;
     SPI_MSG msg;
-    uint8_t retries, line = 0x0;
+    uint8_t line = 0x0;
 
     SYS_LOG_FUNCTION_ENTRY(MMC);
 
@@ -748,33 +796,11 @@ int32_t mmc_spi_read(void *device, uint32_t sector, uint64_t *offset, uint8_t *b
             /* If we are at the start of a new sector. */
             if (sector_offset == 0)
             {
-                /* Initialize a dummy message. */
-                msg.buffer = &line;
-                msg.length = 1;
-                msg.flags = (SPI_MSG_READ);
-
                 /* Wait for card to start data transmission. */
-                for (retries = 0; ((status == SUCCESS) && (retries < MMC_SPI_RX_RETRIES)); retries++)
-                {
-                    /* Send dummy bytes. */
-                    status = mmc->spi.msg(&mmc->spi, &msg);
-
-                    SYS_LOG_FUNCTION_MSG(MMC, SYS_LOG_DEBUG, "retry %ld, line 0x%02X", retries, line);
-
-                    /* If card has sent us some data. */
-                    if (line != 0xFF)
-                    {
-                        break;
-                    }
-                    else
-                    {
-                        /* Sleep before retrying. */
-                        sleep_fms(MMC_SPI_RX_DELAY);
-                    }
-                }
+                status = mmc_spi_wait_line(mmc, &line, TRUE, MMC_SPI_RX_TIMEOUT);
 
                 /* If this is not data start token. */
-                if (line != MMC_SPI_DATA_RX_TKN)
+                if ((status == SUCCESS) && (line != MMC_SPI_DATA_RX_TKN))
                 {
                     /* Return error to the caller. */
                     status = MMC_SPI_READ_ERROR;
@@ -897,7 +923,7 @@ int32_t mmc_spi_write(void *device, uint32_t sector, uint64_t *offset, uint8_t *
     int32_t this_size = 0, status = SUCCESS;
     uint32_t sector_offset;
     SPI_MSG msg;
-    uint8_t retries, line = 0x0;
+    uint8_t line = 0x0;
 
     SYS_LOG_FUNCTION_ENTRY(MMC);
 
@@ -942,38 +968,20 @@ int32_t mmc_spi_write(void *device, uint32_t sector, uint64_t *offset, uint8_t *
             /* If we are at the start of a new sector. */
             if (sector_offset == 0)
             {
-                /* Initialize a dummy message. */
-                msg.buffer = &line;
-                msg.length = 1;
-                msg.flags = (SPI_MSG_READ);
-
                 /* Wait for card to get ready. */
-                for (retries = 0; ((status == SUCCESS) && (retries < MMC_SPI_TX_RETRIES)); retries++)
-                {
-                    /* Read a byte form the SPI. */
-                    status = mmc->spi.msg(&mmc->spi, &msg);
-
-                    SYS_LOG_FUNCTION_MSG(MMC, SYS_LOG_DEBUG, "retry %ld, line 0x%02X", retries, line);
+                status = mmc_spi_wait_line(mmc, &line, FALSE, MMC_SPI_TX_TIMEOUT);
 
-                    /* If SPI line is now stable. */
-                    if (line == 0xFF)
-                    {
-                        break;
-                    }
-                    else
-                    {
-                        /* Sleep before retrying. */
-                        sleep_fms(MMC_SPI_TX_DELAY);
-                    }
-                }
-
-                /* If we are out of retries. */
-                if (retries == MMC_SPI_TX_RETRIES)
+                /* If card is still busy. */
+                if ((status == SUCCESS) && (line != 0xFF))
                 {
                     /* Return error to the caller. */
                     status = MMC_SPI_WRITE_ERROR;
                 }
 
+                /* Initialize a dummy message. */
+                msg.buffer = &line;
+                msg.length = 1;
+
                 if (status == SUCCESS)
                 {
                     /* Send a dummy byte. */
@@ -1087,38 +1095,20 @@ int32_t mmc_spi_write(void *device, uint32_t sector, uint64_t *offset, uint8_t *
             /* If we are at the start of a new sector. */
             if (sector_offset == 0)
             {
-                /* Initialize a dummy message. */
-                msg.buffer = &line;
-                msg.length = 1;
-                msg.flags = (SPI_MSG_READ);
-
                 /* Wait for card to get ready. */
-                for (retries = 0; ((status == SUCCESS) && (retries < MMC_SPI_TX_RETRIES)); retries++)
-                {
-                    /* Read a byte form the SPI. */
-                    status = mmc->spi.msg(&mmc->spi, &msg);
-
-                    SYS_LOG_FUNCTION_MSG(MMC, SYS_LOG_DEBUG, "retry %ld, line 0x%02X", retries, line);
-
-                    /* If SPI line is now stable. */
-                    if (line == 0xFF)
-                    {
-                        break;
-                    }
-                    else
-                    {
-                        /* Sleep before retrying. */
-                        sleep_fms(MMC_SPI_TX_DELAY);
-                    }
-                }
+                status = mmc_spi_wait_line(mmc, &line, FALSE, MMC_SPI_TX_TIMEOUT);
 
-                /* If we are out of retries. */
-                if (retries == MMC_SPI_TX_RETRIES)
+                /* If card is still busy. */
+                if ((status == SUCCESS) && (line != 0xFF))
                 {
                     /* Return error to the caller. */
                     status = MMC_SPI_WRITE_ERROR;
                 }
 
+                /* Initialize a dummy message. */
+                msg.buffer = &line;
+                msg.length = 1;
+
                 if (status == SUCCESS)
                 {
                     /* Send data stop token. */
@@ -1166,6 +1156,595 @@ int32_t mmc_spi_write(void *device, uint32_t sector, uint64_t *offset, uint8_t *
 
 } /* mmc_spi_write */
 
+#ifdef MMC_SPI_CACHE
+/*
+ * mmc_spi_cache_read
+ * @device: MMC SPI device from which sectors are needed to be read.
+ * @sector: Start sector needed to be read.
+ * @offset: Not used, sectors are always read from the start.
+ * @buffer: Buffer in which sectors will be read.
+ * @size: Size of buffer in bytes, must be a multiple of sector size.
+ * @return: Success will be returned if sectors were successfully read,
+ *  MMC_SPI_INVALID_PARAM will be returned if size is not a multiple of sector
+ *  size, MMC_SPI_READ_ERROR will be returned if an error occurred while
+ *  reading data.
+ * This function will read sectors through the sector cache. Sectors not in
+ * the cache are read together and if this read follows the last one some
+ * sectors are also read ahead.
+ */
+int32_t mmc_spi_cache_read(void *device, uint32_t sector, uint64_t *offset, uint8_t *buffer, int32_t size)
+{
+    MMC_SPI *mmc = (MMC_SPI *)device;
+    MMC_SPI_CACHE_LINE *line;
+    int32_t status = SUCCESS;
+    uint32_t num_sectors, this_sector, next;
+    uint8_t sequential;
+
+    SYS_LOG_FUNCTION_ENTRY(MMC);
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(offset);
+
+    /* This is a sequential read if it follows the last read or we are already
+     * reading from this sector. */
+    sequential = (uint8_t)((sector == mmc->next_sector) || ((mmc->stream == MMC_SPI_CACHE_READING) && (sector == mmc->stream_sector)));
+
+    /* If size is not a multiple of sector size. */
+    if ((size % MMC_SPI_SECTOR_SIZE) != 0)
+    {
+        /* Return error to the caller. */
+        status = MMC_SPI_INVALID_PARAM;
+    }
+
+    /* If this request will not fit in the cache. */
+    else if ((uint32_t)(size / MMC_SPI_SECTOR_SIZE) >= MMC_SPI_CACHE_SECTORS)
+    {
+        for (this_sector = sector; ((status == SUCCESS) && (size > 0)); this_sector++)
+        {
+            /* Pick this sector from the cache as it may have not been written
+             * on the card yet. */
+            line = mmc_spi_cache_find(mmc, this_sector);
+
+            if (line != NULL)
+            {
+                /* Copy this sector from the cache. */
+                memcpy(buffer, line->data, MMC_SPI_SECTOR_SIZE);
+            }
+            else
+            {
+                /* Read this sector directly from the card. */
+                status = mmc_spi_cache_transfer(mmc, MMC_SPI_CACHE_READING, this_sector, buffer);
+            }
+
+            buffer += MMC_SPI_SECTOR_SIZE;
+            size -= MMC_SPI_SECTOR_SIZE;
+        }
+    }
+    else
+    {
+        for (this_sector = sector; ((status == SUCCESS) && (size > 0)); this_sector++)
+        {
+            /* Search for this sector in the cache. */
+            line = mmc_spi_cache_find(mmc, this_sector);
+
+            /* If we don't have this sector in the cache. */
+            if (line == NULL)
+            {
+                /* Read rest of the requested sectors. */
+                num_sectors = (uint32_t)(size / MMC_SPI_SECTOR_SIZE);
+
+                /* If this is a sequential read. */
+                if (sequential == TRUE)
+                {
+                    /* Also read ahead some sectors. */
+                    num_sectors += MMC_SPI_READ_AHEAD;
+                }
+
+                /* Don't read more sectors than we can cache. */
+                if (num_sectors > MMC_SPI_CACHE_SECTORS)
+                {
+                    num_sectors = MMC_SPI_CACHE_SECTORS;
+                }
+
+                /* Don't read past the end of the card. */
+                if ((this_sector + num_sectors) > mmc->num_sectors)
+                {
+                    num_sectors = ((this_sector < mmc->num_sectors) ? (mmc->num_sectors - this_sector) : 1);
+                }
+
+                /* Don't read sectors we already have in the cache. */
+                for (next = 1; next < num_sectors; next++)
+                {
+                    if (mmc_spi_cache_find(mmc, (this_sector + next)) != NULL)
+                    {
+                        num_sectors = next;
+                    }
+                }
+
+                /* Read required sectors in the cache. */
+                status = mmc_spi_cache_fetch(mmc, this_sector, num_sectors);
+
+                if (status == SUCCESS)
+                {
+                    /* We will now have this sector in the cache. */
+                    line = mmc_spi_cache_find(mmc, this_sector);
+                }
+            }
+
+            if (status == SUCCESS)
+            {
+                /* Copy this sector from the cache. */
+                memcpy(buffer, line->data, MMC_SPI_SECTOR_SIZE);
+
+                /* Sectors read sequentially are not likely to be read again so
+                 * only update the line usage for random reads. */
+                if (sequential == FALSE)
+                {
+                    line->used = ++mmc->cache_tick;
+                }
+
+                buffer += MMC_SPI_SECTOR_SIZE;
+                size -= MMC_SPI_SECTOR_SIZE;
+            }
+        }
+    }
+
+    if (status == SUCCESS)
+    {
+        /* Save the sector we expect to be read next. */
+        mmc->next_sector = this_sector;
+    }
+
+    SYS_LOG_FUNCTION_EXIT_STATUS(MMC, status);
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* mmc_spi_cache_read */
+
+/*
+ * mmc_spi_cache_write
+ * @device: MMC SPI device on which sectors are needed to be written.
+ * @sector: Start sector needed to be written.
+ * @offset: Not used, sectors are always written from the start.
+ * @buffer: Buffer needed to be written.
+ * @size: Size of buffer in bytes, must be a multiple of sector size.
+ * @return: Success will be returned if sectors were successfully written,
+ *  MMC_SPI_INVALID_PARAM will be returned if size is not a multiple of sector
+ *  size, MMC_SPI_WRITE_ERROR will be returned if an error was detected.
+ * This function will write sectors in the sector cache, these will only be
+ * written on the card when cache is synchronized or when we run out of cache
+ * lines.
+ */
+int32_t mmc_spi_cache_write(void *device, uint32_t sector, uint64_t *offset, uint8_t *buffer, int32_t size)
+{
+    MMC_SPI *mmc = (MMC_SPI *)device;
+    MMC_SPI_CACHE_LINE *line;
+    int32_t status = SUCCESS;
+    uint32_t this_sector;
+
+    SYS_LOG_FUNCTION_ENTRY(MMC);
+
+    /* Some compiler warnings. */
+    UNUSED_PARAM(offset);
+
+    /* If size is not a multiple of sector size. */
+    if ((size % MMC_SPI_SECTOR_SIZE) != 0)
+    {
+        /* Return error to the caller. */
+        status = MMC_SPI_INVALID_PARAM;
+    }
+
+    /* If this request will not fit in the cache. */
+    else if ((uint32_t)(size / MMC_SPI_SECTOR_SIZE) >= MMC_SPI_CACHE_SECTORS)
+    {
+        for (this_sector = sector; ((status == SUCCESS) && (size > 0)); this_sector++)
+        {
+            /* If we have this sector in the cache. */
+            line = mmc_spi_cache_find(mmc, this_sector);
+            if (line != NULL)
+            {
+                /* Drop this sector as it is being overwritten. */
+                line->flags = 0;
+            }
+
+            /* Write this sector directly on the card. */
+            status = mmc_spi_cache_transfer(mmc, MMC_SPI_CACHE_WRITING, this_sector, buffer);
+
+            buffer += MMC_SPI_SECTOR_SIZE;
+            size -= MMC_SPI_SECTOR_SIZE;
+        }
+    }
+    else
+    {
+        for (this_sector = sector; ((status == SUCCESS) && (size > 0)); this_sector++)
+        {
+            /* Search for this sector in the cache. */
+            line = mmc_spi_cache_find(mmc, this_sector);
+
+            /* If we don't have this sector in the cache. */
+            if (line == NULL)
+            {
+                /* Get a line for this sector. */
+                status = mmc_spi_cache_victim(mmc, &line);
+            }
+
+            if (status == SUCCESS)
+            {
+                /* Update this sector in the cache. */
+                memcpy(line->data, buffer, MMC_SPI_SECTOR_SIZE);
+                line->sector = this_sector;
+                line->flags = (MMC_SPI_CACHE_VALID | MMC_SPI_CACHE_DIRTY);
+                line->used = ++mmc->cache_tick;
+
+                buffer += MMC_SPI_SECTOR_SIZE;
+                size -= MMC_SPI_SECTOR_SIZE;
+            }
+        }
+    }
+
+    SYS_LOG_FUNCTION_EXIT_STATUS(MMC, status);
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* mmc_spi_cache_write */
+
+/*
+ * mmc_spi_cache_sync
+ * @device: MMC SPI device needed to be synchronized.
+ * @return: Success will be returned if all the pending sectors were
+ *  successfully written, MMC_SPI_WRITE_ERROR will be returned if an error was
+ *  detected.
+ * This function will write all the pending sectors from the cache on the card
+ * and terminate any transaction we have on the card.
+ */
+int32_t mmc_spi_cache_sync(void *device)
+{
+    MMC_SPI *mmc = (MMC_SPI *)device;
+    int32_t status;
+
+    SYS_LOG_FUNCTION_ENTRY(MMC);
+
+    /* Write all the pending sectors. */
+    status = mmc_spi_cache_flush(mmc);
+
+    if (status == SUCCESS)
+    {
+        /* Terminate the current transaction. */
+        status = mmc_spi_cache_end(mmc);
+    }
+
+    SYS_LOG_FUNCTION_EXIT_STATUS(MMC, status);
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* mmc_spi_cache_sync */
+
+/*
+ * mmc_spi_cache_clear
+ * @mmc: MMC SPI device for which cache is needed to be cleared.
+ * This function will drop all the sectors from the cache.
+ */
+static void mmc_spi_cache_clear(MMC_SPI *mmc)
+{
+    uint32_t i;
+
+    /* Invalidate all the cache lines. */
+    for (i = 0; i < MMC_SPI_CACHE_SECTORS; i++)
+    {
+        mmc->cache[i].flags = 0;
+    }
+
+    /* Next read will not be sequential. */
+    mmc->next_sector = 0;
+
+} /* mmc_spi_cache_clear */
+
+/*
+ * mmc_spi_cache_find
+ * @mmc: MMC SPI device in which cache a sector is needed to be searched.
+ * @sector: Sector needed to be searched.
+ * @return: Cache line having the required sector will be returned if found
+ *  otherwise NULL will be returned.
+ * This function will search for a sector in the cache.
+ */
+static MMC_SPI_CACHE_LINE *mmc_spi_cache_find(MMC_SPI *mmc, uint32_t sector)
+{
+    MMC_SPI_CACHE_LINE *line = NULL;
+    uint32_t i;
+
+    /* Search all the cache lines. */
+    for (i = 0; i < MMC_SPI_CACHE_SECTORS; i++)
+    {
+        /* If this line has the required sector. */
+        if ((mmc->cache[i].flags & MMC_SPI_CACHE_VALID) && (mmc->cache[i].sector == sector))
+        {
+            line = &mmc->cache[i];
+            break;
+        }
+    }
+
+    /* Return the cache line. */
+    return (line);
+
+} /* mmc_spi_cache_find */
+
+/*
+ * mmc_spi_cache_victim
+ * @mmc: MMC SPI device in which cache a line is needed.
+ * @victim: A line that can be used for a new sector will be returned here.
+ * @return: Success will be returned if a line was returned,
+ *  MMC_SPI_WRITE_ERROR will be returned if an error was detected while
+ *  writing the pending sectors.
+ * This function will return an unused line or least recently used line not
+ * having a pending sector, if all lines have pending sectors, all of them will
+ * be written first.
+ */
+static int32_t mmc_spi_cache_victim(MMC_SPI *mmc, MMC_SPI_CACHE_LINE **victim)
+{
+    MMC_SPI_CACHE_LINE *line = NULL;
+    int32_t status = SUCCESS;
+    uint32_t i;
+
+    while ((status == SUCCESS) && (line == NULL))
+    {
+        for (i = 0; i < MMC_SPI_CACHE_SECTORS; i++)
+        {
+            /* If this line is not being used. */
+            if ((mmc->cache[i].flags & MMC_SPI_CACHE_VALID) == 0)
+            {
+                line = &mmc->cache[i];
+                break;
+            }
+
+            /* If this line was used before the selected line. */
+            if (((mmc->cache[i].flags & MMC_SPI_CACHE_DIRTY) == 0) &&
+                ((line == NULL) || ((uint16_t)(mmc->cache_tick - mmc->cache[i].used) > (uint16_t)(mmc->cache_tick - line->used))))
+            {
+                line = &mmc->cache[i];
+            }
+        }
+
+        /* If all the lines have pending sectors. */
+        if (line == NULL)
+        {
+            /* Write all the pending sectors. */
+            status = mmc_spi_cache_flush(mmc);
+        }
+    }
+
+    /* Return the selected line. */
+    *victim = line;
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* mmc_spi_cache_victim */
+
+/*
+ * mmc_spi_cache_fetch
+ * @mmc: MMC SPI device from which sectors are needed to be read.
+ * @sector: Start sector needed to be read.
+ * @num_sectors: Number of sectors to read, must not be more than the number
+ *  of cache lines.
+ * @return: Success will be returned if sectors were successfully read in the
+ *  cache, MMC_SPI_READ_ERROR will be returned if an error occurred while
+ *  reading data.
+ * This function will read a number of sectors in the cache.
+ */
+static int32_t mmc_spi_cache_fetch(MMC_SPI *mmc, uint32_t sector, uint32_t num_sectors)
+{
+    MMC_SPI_CACHE_LINE *line;
+    int32_t status = SUCCESS;
+    uint32_t i, num_free = 0;
+
+    SYS_LOG_FUNCTION_ENTRY(MMC);
+
+    /* Count the lines that can be replaced. */
+    for (i = 0; i < MMC_SPI_CACHE_SECTORS; i++)
+    {
+        if ((mmc->cache[i].flags & MMC_SPI_CACHE_DIRTY) == 0)
+        {
+            num_free++;
+        }
+    }
+
+    /* If we will have to replace a line with pending sector. */
+    if (num_free < num_sectors)
+    {
+        /* Write all the pending sectors first, so we don't end up replacing a
+         * sector we have just read. */
+        status = mmc_spi_cache_flush(mmc);
+    }
+
+    for (i = 0; ((status == SUCCESS) && (i < num_sectors)); i++)
+    {
+        /* Get a line for this sector. */
+        status = mmc_spi_cache_victim(mmc, &line);
+
+        if (status == SUCCESS)
+        {
+            /* Read this sector in the cache. */
+            line->flags = 0;
+            status = mmc_spi_cache_transfer(mmc, MMC_SPI_CACHE_READING, (sector + i), line->data);
+        }
+
+        if (status == SUCCESS)
+        {
+            /* This line now has a valid sector. */
+            line->sector = (sector + i);
+            line->flags = MMC_SPI_CACHE_VALID;
+            line->used = ++mmc->cache_tick;
+        }
+    }
+
+    SYS_LOG_FUNCTION_EXIT_STATUS(MMC, status);
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* mmc_spi_cache_fetch */
+
+/*
+ * mmc_spi_cache_flush
+ * @mmc: MMC SPI device for which pending sectors are needed to be written.
+ * @return: Success will be returned if all the pending sectors were
+ *  successfully written, MMC_SPI_WRITE_ERROR will be returned if an error was
+ *  detected.
+ * This function will write all the pending sectors from the cache, sectors
+ * are written in ascending order so consecutive sectors are written in a
+ * single transaction.
+ */
+static int32_t mmc_spi_cache_flush(MMC_SPI *mmc)
+{
+    MMC_SPI_CACHE_LINE *line;
+    int32_t status = SUCCESS;
+    uint32_t i;
+
+    SYS_LOG_FUNCTION_ENTRY(MMC);
+
+    while (status == SUCCESS)
+    {
+        line = NULL;
+
+        /* Find the next pending sector. */
+        for (i = 0; i < MMC_SPI_CACHE_SECTORS; i++)
+        {
+            if (mmc->cache[i].flags & MMC_SPI_CACHE_DIRTY)
+            {
+                /* If this sector continues the current write. */
+                if ((mmc->stream == MMC_SPI_CACHE_WRITING) && (mmc->cache[i].sector == mmc->stream_sector))
+                {
+                    line = &mmc->cache[i];
+                    break;
+                }
+
+                /* Pick the first sector. */
+                if ((line == NULL) || (mmc->cache[i].sector < line->sector))
+                {
+                    line = &mmc->cache[i];
+                }
+            }
+        }
+
+        /* If we have no more sectors to write. */
+        if (line == NULL)
+        {
+            break;
+        }
+
+        /* Write this sector. */
+        status = mmc_spi_cache_transfer(mmc, MMC_SPI_CACHE_WRITING, line->sector, line->data);
+
+        if (status == SUCCESS)
+        {
+            /* This sector is now written. */
+            line->flags &= (uint8_t)~(MMC_SPI_CACHE_DIRTY);
+        }
+    }
+
+    SYS_LOG_FUNCTION_EXIT_STATUS(MMC, status);
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* mmc_spi_cache_flush */
+
+/*
+ * mmc_spi_cache_transfer
+ * @mmc: MMC SPI device on which a sector is needed to be transferred.
+ * @stream: MMC_SPI_CACHE_READING if sector is needed to be read,
+ *  MMC_SPI_CACHE_WRITING if sector is needed to be written.
+ * @sector: Sector needed to be transferred.
+ * @buffer: Sector buffer.
+ * @return: Success will be returned if sector was successfully transferred,
+ *  MMC_SPI_READ_ERROR or MMC_SPI_WRITE_ERROR will be returned if an error was
+ *  detected.
+ * This function will read or write a sector on the card, if this sector
+ * follows the last one transferred in the same direction current transaction
+ * will be used otherwise a new one will be started.
+ */
+static int32_t mmc_spi_cache_transfer(MMC_SPI *mmc, uint8_t stream, uint32_t sector, uint8_t *buffer)
+{
+    int32_t status = SUCCESS;
+
+    /* If we cannot use the current transaction. */
+    if ((mmc->stream != stream) || (mmc->stream_sector != sector))
+    {
+        /* Terminate the current transaction. */
+        status = mmc_spi_cache_end(mmc);
+
+        /* Start a new transaction. */
+        mmc->stream_offset = MMC_SPI_START_OFFSET;
+    }
+
+    if (status == SUCCESS)
+    {
+        /* Transfer this sector. */
+        if (stream == MMC_SPI_CACHE_READING)
+        {
+            status = mmc_spi_read(mmc, sector, &mmc->stream_offset, buffer, MMC_SPI_SECTOR_SIZE);
+        }
+        else
+        {
+            status = mmc_spi_write(mmc, sector, &mmc->stream_offset, buffer, MMC_SPI_SECTOR_SIZE);
+        }
+    }
+
+    if (status == SUCCESS)
+    {
+        /* Save the sector that can be transferred next in this transaction. */
+        mmc->stream = stream;
+        mmc->stream_sector = (sector + 1);
+    }
+    else
+    {
+        /* Transaction has been terminated. */
+        mmc->stream = 0;
+    }
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* mmc_spi_cache_transfer */
+
+/*
+ * mmc_spi_cache_end
+ * @mmc: MMC SPI device for which current transaction is needed to be
+ *  terminated.
+ * @return: Success will be returned if transaction was successfully
+ *  terminated.
+ * This function will terminate the current transaction on the card.
+ */
+static int32_t mmc_spi_cache_end(MMC_SPI *mmc)
+{
+    int32_t status = SUCCESS;
+
+    /* If we are reading from the card. */
+    if (mmc->stream == MMC_SPI_CACHE_READING)
+    {
+        /* Terminate this read. */
+        status = mmc_spi_read(mmc, 0, &mmc->stream_offset, NULL, 0);
+    }
+
+    /* If we are writing on the card. */
+    else if (mmc->stream == MMC_SPI_CACHE_WRITING)
+    {
+        /* Terminate this write. */
+        status = mmc_spi_write(mmc, 0, &mmc->stream_offset, NULL, 0);
+    }
+
+    /* There is no transaction on the card. */
+    mmc->stream = 0;
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* mmc_spi_cache_end */
+#endif /* MMC_SPI_CACHE */
+
 /*
  * mmc_spi_get_num_sectors
  * @mmc: MMC SPI device for which number of sectors are required.
@@ -1350,49 +1929,95 @@ static int32_t mmc_spi_get_csd(MMC_SPI *mmc, uint8_t *csd)
 } /* mmc_spi_get_csd */
 
 /*
- * mmc_spi_rx_data
- * @mmc: MMC SPI device from which data blocks are needed to be read.
- * @buffer: Buffer in which data will be read.
- * @size: Number of bytes needed to be read.
- * @return: Success will be returned if data block was successfully read in
- *  the buffer, MMC_SPI_DATA_RX_TKN will be returned if we did not receive the
- *  anticipated data token.
- * This function will read data from MMC.
+ * mmc_spi_wait_line
+ * @mmc: MMC SPI device on which line is needed to be polled.
+ * @line: Last byte read from the line will be returned here.
+ * @token: If TRUE we will wait for card to send anything other than 0xFF,
+ *  otherwise we will wait for card to release the line.
+ * @timeout: Number of milliseconds to wait for the card.
+ * @return: Success will be returned if line was successfully polled,
+ *  caller is responsible to check the last byte read from the line to see
+ *  if we timed out.
+ * This function will poll the line, the card usually responds within a few
+ * hundred microseconds so line is first polled back to back for
+ * MMC_SPI_SPIN_POLLS times and after that we will sleep for a tick between
+ * polls, so that lower priority tasks can also run.
  */
-static int32_t mmc_spi_rx_data(MMC_SPI *mmc, uint8_t *buffer, int32_t size)
+static int32_t mmc_spi_wait_line(MMC_SPI *mmc, uint8_t *line, uint8_t token, uint32_t timeout)
 {
     int32_t status = SUCCESS;
+    uint32_t polls = 0, sys_tick = current_system_tick();
     SPI_MSG msg;
-    uint8_t retries, line;
 
     SYS_LOG_FUNCTION_ENTRY(MMC);
 
     /* Initialize a dummy message. */
-    msg.buffer = &line;
+    msg.buffer = line;
     msg.length = 1;
     msg.flags = (SPI_MSG_READ);
 
-    /* Wait for card to start data transmission. */
-    for (retries = 0; ((status == SUCCESS) && (retries < MMC_SPI_RX_RETRIES)); retries++)
+    while (status == SUCCESS)
     {
-        /* Send dummy bytes. */
+        /* Read a byte form the SPI. */
         status = mmc->spi.msg(&mmc->spi, &msg);
 
-        SYS_LOG_FUNCTION_MSG(MMC, SYS_LOG_DEBUG, "retry %ld, line 0x%02X", retries, line);
+        /* If line is now in the required state. */
+        if ((status != SUCCESS) || ((token == TRUE) ? (*line != 0xFF) : (*line == 0xFF)))
+        {
+            break;
+        }
+
+        /* If we are still spinning. */
+        if (polls < MMC_SPI_SPIN_POLLS)
+        {
+            polls++;
+        }
 
-        if (line != 0xFF)
+        /* If we have timed out. */
+        else if ((current_system_tick() - sys_tick) >= MS_TO_TICK(timeout))
         {
+            SYS_LOG_FUNCTION_MSG(MMC, SYS_LOG_ERROR, "timed out, line 0x%02X", *line);
+
             break;
         }
         else
         {
-            /* Sleep before retrying. */
-            sleep_fms(MMC_SPI_RX_DELAY);
+            /* Let other tasks run before polling again, yielding would
+             * only let the tasks with same priority run. */
+            sleep_ticks(1);
         }
     }
 
+    SYS_LOG_FUNCTION_EXIT_STATUS(MMC, status);
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* mmc_spi_wait_line */
+
+/*
+ * mmc_spi_rx_data
+ * @mmc: MMC SPI device from which data blocks are needed to be read.
+ * @buffer: Buffer in which data will be read.
+ * @size: Number of bytes needed to be read.
+ * @return: Success will be returned if data block was successfully read in
+ *  the buffer, MMC_SPI_DATA_RX_TKN will be returned if we did not receive the
+ *  anticipated data token.
+ * This function will read data from MMC.
+ */
+static int32_t mmc_spi_rx_data(MMC_SPI *mmc, uint8_t *buffer, int32_t size)
+{
+    int32_t status;
+    SPI_MSG msg;
+    uint8_t line = 0xFF;
+
+    SYS_LOG_FUNCTION_ENTRY(MMC);
+
+    /* Wait for card to start data transmission. */
+    status = mmc_spi_wait_line(mmc, &line, TRUE, MMC_SPI_RX_TIMEOUT);
+
     /* If we have a valid data token. */
-    if (line == MMC_SPI_DATA_RX_TKN)
+    if ((status == SUCCESS) && (line == MMC_SPI_DATA_RX_TKN))
     {
         /* Initialize SPI message. */
         msg.buffer = buffer;
@@ -1402,7 +2027,7 @@ static int32_t mmc_spi_rx_data(MMC_SPI *mmc, uint8_t *buffer, int32_t size)
         /* Receive the data block. */
         status = mmc->spi.msg(&mmc->spi, &msg);
     }
-    else
+    else if (status == SUCCESS)
     {
         /* Error while reading data. */
         status = MMC_SPI_READ_ERROR;
@@ -1573,7 +2198,7 @@ static int32_t mmc_slave_select(MMC_SPI *mmc, uint8_t test_line)
 {
     int32_t status = SUCCESS;
     SPI_MSG msg;
-    uint8_t retries, line = 0xFF;
+    uint8_t line = 0xFF;
 
     SYS_LOG_FUNCTION_ENTRY(MMC);
 
@@ -1591,28 +2216,11 @@ static int32_t mmc_slave_select(MMC_SPI *mmc, uint8_t test_line)
         /* Read a dummy byte form the SPI. */
         mmc->spi.msg(&mmc->spi, &msg);
 
-        /* While line is not stable. */
-        for (retries = 0; ((status == SUCCESS) && (retries < MMC_SPI_LINE_RETRIES)); retries ++)
-        {
-            /* Read a byte form the SPI. */
-            status = mmc->spi.msg(&mmc->spi, &msg);
-
-            SYS_LOG_FUNCTION_MSG(MMC, SYS_LOG_DEBUG, "retry %ld, line 0x%02X", retries, line);
-
-            /* If SPI line is now stable. */
-            if (line == 0xFF)
-            {
-                break;
-            }
-            else
-            {
-                /* Sleep before trying again. */
-                sleep_fms(MMC_SPI_SELECT_DELAY);
-            }
-        }
+        /* Wait for line to get stable. */
+        status = mmc_spi_wait_line(mmc, &line, FALSE, MMC_SPI_LINE_TIMEOUT);
 
         /* If slave did not respond. */
-        if (retries == MMC_SPI_LINE_RETRIES)
+        if ((status == SUCCESS) && (line != 0xFF))
         {
             /* Unable to select the device. */
             status = MMC_SPI_SELECT_ERROR;
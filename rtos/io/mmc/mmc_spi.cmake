@@ -1,2 +1,6 @@
 # Setup configuration options.
-setup_option_def(MMC_SPI_FS ON DEFINE "Enable file system interface for a MMC card." CONFIG_FILE "mmc_spi_config")
\ No newline at end of file
+setup_option_def(MMC_SPI_FS ON DEFINE "Enable file system interface for a MMC card." CONFIG_FILE "mmc_spi_config")
+setup_option_def(MMC_SPI_SPIN_POLLS 256 INT "Number of times line is polled back to back before sleeping between polls while waiting for the card." CONFIG_FILE "mmc_spi_config")
+setup_option_def(MMC_SPI_CACHE OFF DEFINE "Enable sector cache with read-ahead and write-behind for disk interface, each sector takes 520 bytes." CONFIG_FILE "mmc_spi_config")
+setup_option_def(MMC_SPI_CACHE_SECTORS 8 INT "Number of sectors in MMC sector cache." CONFIG_FILE "mmc_spi_config")
+setup_option_def(MMC_SPI_READ_AHEAD 4 INT "Number of sectors to read ahead for sequential reads, should be less than cache sectors." CONFIG_FILE "mmc_spi_config")
\ No newline at end of file
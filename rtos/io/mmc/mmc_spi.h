@@ -59,16 +59,13 @@
 #define MMC_SPI_CMD58_BM        (0x40)
 
 /* MMC SPI definitions. */
-#define MMC_SPI_LINE_RETRIES    (100)
 #define MMC_SPI_IDLE_RETRIES    (2)
 #define MMC_SPI_RESUME_RETRIES  (10)
-#define MMC_SPI_RX_RETRIES      (15)
-#define MMC_SPI_TX_RETRIES      (150)
 #define MMC_SPI_CMD_RETRIES     (15)
 #define MMC_SPI_RESUME_DELAY    (50)
-#define MMC_SPI_SELECT_DELAY    (10)
-#define MMC_SPI_RX_DELAY        (10)
-#define MMC_SPI_TX_DELAY        (10)
+#define MMC_SPI_LINE_TIMEOUT    (1000)
+#define MMC_SPI_RX_TIMEOUT      (150)
+#define MMC_SPI_TX_TIMEOUT      (1500)
 #define MMC_SPI_CMD_LEN         (0x6)
 #define MMC_SPI_CSD_LEN         (0x10)
 #define MMC_SPI_STATUS_LEN      (0x40)
@@ -95,6 +92,35 @@
 #define MMC_SPI_OPEN_READ       (0x20)
 #define MMC_SPI_OPEN_WRITE      (0x40)
 
+#ifdef MMC_SPI_CACHE
+/* MMC cache line flags. */
+#define MMC_SPI_CACHE_VALID     (0x1)
+#define MMC_SPI_CACHE_DIRTY     (0x2)
+
+/* MMC cache transaction definitions. */
+#define MMC_SPI_CACHE_READING   (0x1)
+#define MMC_SPI_CACHE_WRITING   (0x2)
+
+/* MMC cache line structure. */
+typedef struct _mmc_spi_cache_line
+{
+    /* Sector data. */
+    uint8_t     data[MMC_SPI_SECTOR_SIZE];
+
+    /* Sector cached in this line. */
+    uint32_t    sector;
+
+    /* Cache tick at which this line was last used. */
+    uint16_t    used;
+
+    /* Cache line flags. */
+    uint8_t     flags;
+
+    /* Structure padding. */
+    uint8_t     pad[1];
+} MMC_SPI_CACHE_LINE;
+#endif /* MMC_SPI_CACHE */
+
 /* MMC SPI structure. */
 typedef struct _mmc_spi
 {
@@ -115,6 +141,33 @@ typedef struct _mmc_spi
     uint64_t    num_bytes;
 #endif
 
+#ifdef MMC_SPI_CACHE
+    /* Sector cache. */
+    MMC_SPI_CACHE_LINE  cache[MMC_SPI_CACHE_SECTORS];
+
+    /* Offset in the current transaction on the card. */
+    uint64_t    stream_offset;
+
+    /* Sector that can be transferred next in the current transaction. */
+    uint32_t    stream_sector;
+
+    /* Number of sectors on the card. */
+    uint32_t    num_sectors;
+
+    /* Sector following the last sector read, used to detect sequential
+     * reads. */
+    uint32_t    next_sector;
+
+    /* Cache tick, incremented each time a line is used. */
+    uint16_t    cache_tick;
+
+    /* Current transaction on the card. */
+    uint8_t     stream;
+
+    /* Structure padding. */
+    uint8_t     pad_cache[1];
+#endif /* MMC_SPI_CACHE */
+
     /* SPI device configuration structure. */
     SPI_DEVICE  spi;
 
@@ -134,6 +187,11 @@ int32_t mmc_spi_read(void *, uint32_t, uint64_t *, uint8_t *, int32_t);
 int32_t mmc_spi_write(void *, uint32_t, uint64_t *, uint8_t *, int32_t);
 int32_t mmc_spi_get_num_sectors(MMC_SPI *, uint64_t *);
 int32_t mmc_spi_get_sectors_per_block(MMC_SPI *, uint64_t *);
+#ifdef MMC_SPI_CACHE
+int32_t mmc_spi_cache_read(void *, uint32_t, uint64_t *, uint8_t *, int32_t);
+int32_t mmc_spi_cache_write(void *, uint32_t, uint64_t *, uint8_t *, int32_t);
+int32_t mmc_spi_cache_sync(void *);
+#endif /* MMC_SPI_CACHE */
 
 #endif /* IO_MMC */
 #endif /* _MMC_SPI_H_ */
@@ -63,6 +63,9 @@ void ppp_register_fd(PPP *ppp, FD fd, uint8_t dedicated)
     ppp->state = PPP_STATE_INIT;
     ppp->state_data.lcp_id = 0;
 
+    /* Initialize the header template for the frames we send. */
+    ppp_tx_header_update(ppp);
+
     if (dedicated == TRUE)
     {
         /* Set the dedicated file descriptor flag. */
@@ -302,6 +305,34 @@ void ppp_configuration_process(PPP *ppp, FS_BUFFER_LIST *buffer, PPP_PROTO *prot
             }
         }
 
+        /* If peer has NAKed or rejected our configuration request. */
+        else if ((rx_packet.code == PPP_CONFIG_NAK) || (rx_packet.code == PPP_CONFIG_REJECT))
+        {
+            /* Parse all the options peer did not accept, no reply is sent for
+             * these and protocol will send a new configuration request. */
+            while (status == SUCCESS)
+            {
+                /* Parse next packet option. */
+                status = ppp_packet_configuration_option_parse(buffer, &option);
+
+                /* If we have successfully parsed a option we support. */
+                if ((status == SUCCESS) &&
+                    (proto->negotiable(ppp, &option) == TRUE) &&
+                    (proto->length_valid(ppp, &option) == TRUE))
+                {
+                    /* Let the protocol update our configuration. */
+                    proto->process(ppp, &option, &rx_packet);
+                }
+
+                /* If there are no more options to parse. */
+                if (status == PPP_NO_NEXT_OPTION)
+                {
+                    status = SUCCESS;
+                    break;
+                }
+            }
+        }
+
         /* If it is not a terminate request. */
         else if (rx_packet.code != PPP_TREM_REQ)
         {
@@ -515,15 +546,32 @@ void ppp_process_frame(void *fd, PPP *ppp)
     if (status == SUCCESS)
     {
         /* Verify and skim the HDLC headers. */
-        status = ppp_hdlc_header_parse(ppp->rx_buffer, PPP_IS_ACFC_VALID(ppp));
+        status = ppp_hdlc_header_parse(ppp->rx_buffer, PPP_IS_RX_ACFC(ppp), PPP_IS_RX_FCS32(ppp));
 
         /* If HDLC verification was successful. */
         if (status == SUCCESS)
         {
             /* Parse and pick the protocol field. */
-            status = ppp_packet_protocol_parse(ppp->rx_buffer, &protocol, PPP_IS_PFC_VALID(ppp));
+            status = ppp_packet_protocol_parse(ppp->rx_buffer, &protocol, PPP_IS_RX_PFC(ppp));
         }
 
+#ifdef PPP_VJ
+        /* If we have lost a frame. */
+        if (status != SUCCESS)
+        {
+            /* Compressed frames that follow cannot be uncompressed. */
+            PPP_VJ_TOSS(&ppp->vj);
+        }
+
+        /* If this is a VJ TCP/IP frame and we have negotiated VJ compression. */
+        else if (((protocol == PPP_PROTO_VJ_COMP) || (protocol == PPP_PROTO_VJ_UNCOMP)) && (ppp->flags & PPP_FLAG_RX_VJ))
+        {
+            /* Recover the TCP/IP header, this is an IPv4 frame now. */
+            status = ppp_vj_uncompress(&ppp->vj, ppp->rx_buffer, protocol, 0);
+            protocol = PPP_PROTO_IPV4;
+        }
+#endif
+
         /* If protocol was successfully parsed. */
         if (status == SUCCESS)
         {
@@ -607,7 +655,6 @@ int32_t net_ppp_transmit(FS_BUFFER_LIST *buffer, uint8_t flags)
     int32_t status = SUCCESS;
     PPP *ppp;
     uint16_t protocol = 0;
-    uint8_t net_proto;
     FS_BUFFER_LIST *buffer_copy;
 
     /* Resolve required PPP buffer instance. */
@@ -616,11 +663,8 @@ int32_t net_ppp_transmit(FS_BUFFER_LIST *buffer, uint8_t flags)
     /* If we have a PPP instance. */
     if (ppp != NULL)
     {
-        /* Skim the protocol from the buffer. */
-        ASSERT(fs_buffer_list_pull(buffer, &net_proto, sizeof(uint8_t), 0) != SUCCESS);
-
         /* Process this frame according to the protocol. */
-        switch (net_proto)
+        switch (buffer->meta.proto)
         {
         /* IPv4 protocol. */
         case NET_PROTO_IPV4:
@@ -673,6 +717,16 @@ int32_t net_ppp_transmit(FS_BUFFER_LIST *buffer, uint8_t flags)
             }
         }
 
+#ifdef PPP_VJ
+        /* If this is an IPv4 packet and peer can uncompress VJ headers. */
+        if ((status == SUCCESS) && (protocol == PPP_PROTO_IPV4) && (ppp->flags & PPP_FLAG_TX_VJ))
+        {
+            /* Try to compress the TCP/IP header, this will also update the
+             * protocol. */
+            status = ppp_vj_compress(&ppp->vj, buffer, &protocol, flags);
+        }
+#endif
+
         if (status == SUCCESS)
         {
             /* Transmit this PPP buffer. */
@@ -791,6 +845,91 @@ void net_ppp_receive(void *data, int32_t status)
 
 } /* net_ppp_receive */
 
+/*
+ * ppp_tx_header_update
+ * @ppp: PPP private data.
+ * This function will update the header template for the frames we send with
+ * a single byte protocol, must be called when negotiated ACFC or PFC is
+ * changed.
+ */
+void ppp_tx_header_update(PPP *ppp)
+{
+    uint8_t len = 0;
+
+    /* If address and control fields cannot be compressed. */
+    if (!PPP_IS_TX_ACFC(ppp))
+    {
+        /* Add address and control fields. */
+        ppp->tx_header[len++] = PPP_ADDRESS;
+        ppp->tx_header[len++] = PPP_CONTROL;
+    }
+
+    /* If protocol field cannot be compressed. */
+    if (!PPP_IS_TX_PFC(ppp))
+    {
+        /* Add the zero most significant byte of protocol. */
+        ppp->tx_header[len++] = 0;
+    }
+
+    /* Leave space for the protocol. */
+    ppp->tx_header[len++] = 0;
+
+    /* Save the template length. */
+    ppp->tx_header_len = len;
+
+} /* ppp_tx_header_update */
+
+/*
+ * ppp_tx_header_add
+ * @ppp: PPP private data.
+ * @buffer: Buffer needed to be framed.
+ * @proto: PPP protocol needed to be added in the header.
+ * @flags: Operation flags.
+ *  FS_BUFFER_TH: We need to maintain threshold while allocating a buffer.
+ * @return: A success status will be returned if frame was successfully
+ *  generated, PPP_NO_SPACE or PPP_NO_BUFFERS will be returned if we don't have
+ *  space to generate this frame.
+ * This function will add the PPP and HDLC headers on a given buffer. For
+ * single byte protocols the address, control and protocol fields are added
+ * at once from the precomputed header template.
+ */
+int32_t ppp_tx_header_add(PPP *ppp, FS_BUFFER_LIST *buffer, uint16_t proto, uint8_t flags)
+{
+    int32_t status;
+
+    /* If this protocol can use the header template. */
+    if ((proto & 0xFF00) == 0)
+    {
+        /* Put the protocol in the template and push it on the buffer. */
+        ppp->tx_header[ppp->tx_header_len - 1] = (uint8_t)proto;
+        status = fs_buffer_list_push(buffer, ppp->tx_header, ppp->tx_header_len, (FS_BUFFER_HEAD | flags));
+
+        /* If header was successfully added. */
+        if (status == SUCCESS)
+        {
+            /* Escape the frame and add the FCS, address and control fields
+             * are already on the buffer if required. */
+            status = ppp_hdlc_header_add(buffer, ppp->tx_accm, TRUE, FALSE, PPP_IS_TX_FCS32(ppp), flags);
+        }
+    }
+    else
+    {
+        /* Add PPP protocol. */
+        status = ppp_packet_protocol_add(buffer, proto, PPP_IS_TX_PFC(ppp), flags);
+
+        /* If PPP protocol was successfully added. */
+        if (status == SUCCESS)
+        {
+            /* Add the HDLC header. */
+            status = ppp_hdlc_header_add(buffer, ppp->tx_accm, PPP_IS_TX_ACFC(ppp), (proto == PPP_PROTO_LCP), PPP_IS_TX_FCS32(ppp), flags);
+        }
+    }
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* ppp_tx_header_add */
+
 /*
  * ppp_transmit_buffer_instance
  * @ppp: PPP private data.
@@ -807,15 +946,8 @@ int32_t ppp_transmit_buffer_instance(PPP *ppp, FS_BUFFER_LIST *buffer, uint16_t
     int32_t status;
     FD fd = buffer->fd;
 
-    /* Add PPP protocol. */
-    status = ppp_packet_protocol_add(buffer, proto, PPP_IS_PFC_VALID(ppp), flags);
-
-    /* If PPP protocol was successfully added. */
-    if (status == SUCCESS)
-    {
-        /* Add the HDLC header. */
-        status = ppp_hdlc_header_add(buffer, ppp->tx_accm, PPP_IS_ACFC_VALID(ppp), (proto == PPP_PROTO_LCP), flags);
-    }
+    /* Add the PPP and HDLC headers. */
+    status = ppp_tx_header_add(ppp, buffer, proto, flags);
 
     /* If HDLC header was successfully added. */
     if (status == SUCCESS)
@@ -1,2 +1,5 @@
 # Setup configuration options.
-setup_option_def(PPP_MODEM_CHAT ON DEFINE "Enable PPP modem chat." CONFIG_FILE "ppp_config")
\ No newline at end of file
+setup_option_def(PPP_MODEM_CHAT ON DEFINE "Enable PPP modem chat." CONFIG_FILE "ppp_config")
+setup_option_def(PPP_FCS16_SLICE 4 INT "Number of bytes processed in each iteration of 16-bit FCS, 1, 4 or 8, each table takes 512 bytes." CONFIG_FILE "ppp_config")
+setup_option_def(PPP_FCS32 OFF DEFINE "Enable negotiation of 32-bit FCS, 32-bit FCS will also be requested from the peer." CONFIG_FILE "ppp_config")
+setup_option_def(PPP_MAX_FAILURE 5 INT "Number of configuration requests sent again after a NAK or reject before giving up." CONFIG_FILE "ppp_config")
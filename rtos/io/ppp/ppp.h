@@ -22,6 +22,7 @@
 #include <ppp_fcs.h>
 #include <ppp_packet.h>
 #include <ppp_hdlc.h>
+#include <ppp_vj.h>
 #include <net.h>
 #include <ppp_config.h>
 
@@ -45,13 +46,32 @@
 #define PPP_STATE_NETWORK           4
 
 /* PPP configuration flags. */
-#define PPP_FLAG_ACFC               0x1
-#define PPP_FLAG_PFC                0x2
+#define PPP_FLAG_RX_ACFC            0x1
+#define PPP_FLAG_RX_PFC             0x2
 #define PPP_DEDICATED_FD            0x4
-
-/* ACFC and PFC helper macros. */
-#define PPP_IS_ACFC_VALID(ppp)      (((ppp)->flags & PPP_FLAG_ACFC) != 0)
-#define PPP_IS_PFC_VALID(ppp)       (((ppp)->flags & PPP_FLAG_PFC) != 0)
+#define PPP_FLAG_TX_FCS32           0x8
+#define PPP_FLAG_RX_FCS32           0x10
+#define PPP_FLAG_NO_FCS32           0x20
+#define PPP_FLAG_TX_VJ              0x40
+#define PPP_FLAG_RX_VJ              0x80
+#define PPP_FLAG_NO_VJ              0x100
+#define PPP_FLAG_TX_ACFC            0x200
+#define PPP_FLAG_TX_PFC             0x400
+
+/* ACFC and PFC helper macros, RX flags are set when peer ACKs our request and
+ * TX flags are set when we ACK the request from the peer. */
+#define PPP_IS_RX_ACFC(ppp)         (((ppp)->flags & PPP_FLAG_RX_ACFC) != 0)
+#define PPP_IS_RX_PFC(ppp)          (((ppp)->flags & PPP_FLAG_RX_PFC) != 0)
+#define PPP_IS_TX_ACFC(ppp)         (((ppp)->flags & PPP_FLAG_TX_ACFC) != 0)
+#define PPP_IS_TX_PFC(ppp)          (((ppp)->flags & PPP_FLAG_TX_PFC) != 0)
+
+/* Largest header we add before the payload, address, control and protocol
+ * fields. */
+#define PPP_TX_HEADER_SIZE          (4)
+
+/* 32-bit FCS helper macros, negotiated FCS is only used once LCP is opened. */
+#define PPP_IS_TX_FCS32(ppp)        ((((ppp)->flags & PPP_FLAG_TX_FCS32) != 0) && ((ppp)->state >= PPP_STATE_IPCP))
+#define PPP_IS_RX_FCS32(ppp)        ((((ppp)->flags & PPP_FLAG_RX_FCS32) != 0) && ((ppp)->state >= PPP_STATE_IPCP))
 
 /* LCP code definitions. */
 #define PPP_CONFIG_NONE             0
@@ -73,6 +93,8 @@
 
 /* PPP protocol definitions. */
 #define PPP_PROTO_IPV4              (0x21)
+#define PPP_PROTO_VJ_COMP           (0x2D)
+#define PPP_PROTO_VJ_UNCOMP         (0x2F)
 #define PPP_PROTO_IPCP              (0x8021)
 #define PPP_PROTO_LCP               (0xC021)
 #define PPP_AUTH_PAP                (0xC023)
@@ -111,6 +133,10 @@ struct _ppp
     /* Receive buffer chain. */
     FS_BUFFER_LIST  *rx_buffer;
 
+    /* Header template for the frames we send with a single byte protocol,
+     * last byte is replaced with the protocol for each frame. */
+    uint8_t         tx_header[PPP_TX_HEADER_SIZE];
+
     union _ppp_state_data
     {
         /* ID used in last LCP request. */
@@ -120,8 +146,20 @@ struct _ppp
         uint8_t         ipcp_id;
     } state_data;
 
+    /* Number of bytes in the header template. */
+    uint8_t         tx_header_len;
+
+    /* Number of our configuration requests NAKed or rejected in this
+     * phase. */
+    uint8_t         num_failure;
+
     /* Structure padding. */
-    uint8_t         pad[3];
+    uint8_t         pad[1];
+
+#ifdef PPP_VJ
+    /* VJ header compression state. */
+    PPP_VJ_STATE    vj;
+#endif
 };
 
 /* PPP global data structure. */
@@ -165,6 +203,8 @@ void ppp_configuration_process(PPP *, FS_BUFFER_LIST *, PPP_PROTO *);
 void ppp_process_frame(void *, PPP *);
 int32_t net_ppp_transmit(FS_BUFFER_LIST *, uint8_t);
 void net_ppp_receive(void *, int32_t);
+void ppp_tx_header_update(PPP *);
+int32_t ppp_tx_header_add(PPP *, FS_BUFFER_LIST *, uint16_t, uint8_t);
 int32_t ppp_transmit_buffer_instance(PPP *, FS_BUFFER_LIST *, uint16_t, uint8_t);
 
 /* Include PPP supported configuration protocol definitions. */
@@ -17,16 +17,25 @@
 
 #ifdef IO_PPP
 #include <fs.h>
+#include <ppp_config.h>
 
 /* FCS magic and initial value definitions. */
 #define PPP_FCS16_INIT      0xffff
 #define PPP_FCS16_MAGIC     0xf0b8
+#define PPP_FCS32_INIT      0xffffffff
+#define PPP_FCS32_MAGIC     0xdebb20e3
 
 #define PPP_FCS16_IS_VALID(b)    (ppp_fcs16_buffer_calculate(b, PPP_FCS16_INIT) == PPP_FCS16_MAGIC)
+#define PPP_FCS32_IS_VALID(b)    (ppp_fcs32_buffer_calculate(b, PPP_FCS32_INIT) == PPP_FCS32_MAGIC)
 
 /* Function prototypes. */
 uint16_t ppp_fcs16_calculate(uint8_t *, uint32_t, uint16_t);
+uint16_t ppp_fcs16_copy(uint8_t *, uint8_t *, uint32_t, uint16_t);
 uint16_t ppp_fcs16_buffer_calculate(FS_BUFFER_LIST *, uint16_t);
+#ifdef PPP_FCS32
+uint32_t ppp_fcs32_calculate(uint8_t *, uint32_t, uint32_t);
+uint32_t ppp_fcs32_buffer_calculate(FS_BUFFER_LIST *, uint32_t);
+#endif /* PPP_FCS32 */
 
 #endif /* IO_PPP */
 
@@ -18,24 +18,49 @@
 #include <ppp.h>
 #include <ppp_hdlc.h>
 
+/* Escape map used to find the bytes needed to be un-escaped. */
+static const uint32_t ppp_hdlc_rx_map[PPP_HDLC_MAP_WORDS] =
+{
+    0x0, 0x0, 0x0, PPP_HDLC_MAP_FLAGS, 0x0, 0x0, 0x0, 0x0
+};
+
+/* Internal function prototypes. */
+static int32_t ppp_hdlc_escape_data(FS_BUFFER_LIST *, const uint32_t *, uint8_t, uint8_t *, uint32_t, uint16_t *, uint8_t);
+
 /*
  * ppp_hdlc_header_parse
  * @buffer: Buffer chain needed to be processed.
  * @acfc: If address and control fields may be compressed.
+ * @fcs32: If 32-bit FCS is being used.
  * @return: A success status will be returned if header was successfully parsed,
  *  PPP_INVALID_HEADER will be returned if an invalid header was parsed.
  * This function will process the HDLC header. Nothing is needed to be returned
  * here other then verifying and stripping the FCS at the end of the packet and
  * verifying other constant data like flags, address and control fields.
  */
-int32_t ppp_hdlc_header_parse(FS_BUFFER_LIST *buffer, uint8_t acfc)
+int32_t ppp_hdlc_header_parse(FS_BUFFER_LIST *buffer, uint8_t acfc, uint8_t fcs32)
 {
     int32_t status = SUCCESS;
-    uint8_t flag = 0;
+    uint32_t fcs_length = 2;
+    uint16_t fcs = PPP_FCS16_INIT, *fcs16 = &fcs;
+    uint8_t flag = 0, fcs_valid;
     uint8_t acf[2];
 
-    /* First un-escape the data. */
-    status = ppp_hdlc_unescape(buffer);
+#ifdef PPP_FCS32
+    /* If 32-bit FCS is being used. */
+    if (fcs32 == TRUE)
+    {
+        /* 32-bit FCS will be calculated after un-escaping the data. */
+        fcs16 = NULL;
+        fcs_length = 4;
+    }
+#else
+    /* Remove some compiler warnings. */
+    UNUSED_PARAM(fcs32);
+#endif /* PPP_FCS32 */
+
+    /* First un-escape the data, this will also calculate the 16-bit FCS. */
+    status = ppp_hdlc_unescape(buffer, fcs16);
 
     /* RFC-1662:
      * +----------+----------+----------+----------+----------+----------+----------+
@@ -93,8 +118,22 @@ int32_t ppp_hdlc_header_parse(FS_BUFFER_LIST *buffer, uint8_t acfc)
         ASSERT(fs_buffer_list_pull(buffer, NULL, 1, 0) != SUCCESS);
         ASSERT(fs_buffer_list_pull(buffer, NULL, 1, FS_BUFFER_TAIL) != SUCCESS);
 
-        /* Compute and verify the FCS. */
-        if (PPP_FCS16_IS_VALID(buffer))
+#ifdef PPP_FCS32
+        /* If 32-bit FCS is being used. */
+        if (fcs16 == NULL)
+        {
+            /* Compute and verify the 32-bit FCS. */
+            fcs_valid = (uint8_t)((buffer->total_length >= fcs_length) && (PPP_FCS32_IS_VALID(buffer)));
+        }
+        else
+#endif /* PPP_FCS32 */
+        {
+            /* Verify the FCS calculated while un-escaping the data. */
+            fcs_valid = (uint8_t)(fcs == PPP_FCS16_MAGIC);
+        }
+
+        /* If FCS is valid. */
+        if (fcs_valid == TRUE)
         {
             /* Pull the FCS from the buffer.
              * RFC-1662: The FCS field is calculated over all bits of the
@@ -103,7 +142,7 @@ int32_t ppp_hdlc_header_parse(FS_BUFFER_LIST *buffer, uint8_t acfc)
              * bits (synchronous) or octets (asynchronous or synchronous)
              * inserted for transparency.  This also does not include the Flag
              * Sequences nor the FCS field itself.*/
-            ASSERT(fs_buffer_list_pull(buffer, NULL, 2, FS_BUFFER_TAIL) != SUCCESS);
+            ASSERT(fs_buffer_list_pull(buffer, NULL, fcs_length, FS_BUFFER_TAIL) != SUCCESS);
 
             if (buffer->total_length >= 2)
             {
@@ -145,11 +184,13 @@ int32_t ppp_hdlc_header_parse(FS_BUFFER_LIST *buffer, uint8_t acfc)
 /*
  * ppp_hdlc_unescape
  * @buffer: Buffer chain needed to be processed.
+ * @fcs: If not null, FCS of the un-escaped data will be updated in this, flags
+ *  are not included in the FCS.
  * @return: A success status will be returned if given buffer was successfully
  *  escaped. HDLC_STREAM_ERROR will be returned in a stream error was detected.
  * This function will un-escaping a HDLC packet.
  */
-int32_t ppp_hdlc_unescape(FS_BUFFER_LIST *buffer)
+int32_t ppp_hdlc_unescape(FS_BUFFER_LIST *buffer, uint16_t *fcs)
 {
     FS_BUFFER *this_buffer = buffer->list.head;
     int32_t status = SUCCESS;
@@ -162,7 +203,7 @@ int32_t ppp_hdlc_unescape(FS_BUFFER_LIST *buffer)
     while (this_buffer != NULL)
     {
         /* Un-escape this buffer. */
-        ppp_hdlc_unescape_one(this_buffer, &last_escaped);
+        ppp_hdlc_unescape_one(this_buffer, &last_escaped, fcs);
 
         /* Add the length for converted buffer. */
         buffer->total_length += this_buffer->length;
@@ -188,71 +229,123 @@ int32_t ppp_hdlc_unescape(FS_BUFFER_LIST *buffer)
  * @buffer: Buffer needed to be processed.
  * @last_escaped: If we got a escape byte at the end of a buffer, this flag
  *  will be set to true so that we can escape the first byte on next buffer.
- * This function will un-escaping a HDLC buffer.
+ * @fcs: If not null, FCS of the un-escaped data will be updated in this.
+ * This function will un-escaping a HDLC buffer. Runs of data that are not
+ * needed to be un-escaped are moved in place as a whole and FCS is calculated
+ * for them in the same pass.
  */
-void ppp_hdlc_unescape_one(FS_BUFFER *buffer, uint8_t *last_escaped)
+void ppp_hdlc_unescape_one(FS_BUFFER *buffer, uint8_t *last_escaped, uint16_t *fcs)
 {
-    uint8_t *data = buffer->buffer;
-    uint32_t converted = 0;
+    uint8_t *from = buffer->buffer, *to = buffer->buffer;
+    uint32_t length = buffer->length, run;
 
     /* If we need to escape first byte on this buffer. */
-    if ((buffer->length > 0) && (*last_escaped == TRUE))
+    if ((length > 0) && (*last_escaped == TRUE))
     {
         /* Escape the first byte. */
-        data[converted] = (buffer->buffer[0] ^ 0x20);
-        converted ++;
+        *to = (*from ^ 0x20);
 
-        /* Reset the escape flag. */
-        *last_escaped = FALSE;
+        /* If we are also calculating the FCS. */
+        if (fcs != NULL)
+        {
+            /* Update the FCS for this byte. */
+            *fcs = ppp_fcs16_calculate(to, 1, *fcs);
+        }
 
         /* Consume this byte. */
-        ASSERT(fs_buffer_pull(buffer, NULL, 1, 0) != SUCCESS);
+        to ++;
+        from ++;
+        length --;
+
+        /* Reset the escape flag. */
+        *last_escaped = FALSE;
     }
 
     /* While we have data in the source buffer. */
-    while (buffer->length > 0)
+    while (length > 0)
     {
+        /* Find the number of bytes we can move as it is. */
+        run = ppp_hdlc_scan(ppp_hdlc_rx_map, PPP_HDLC_SCAN_FLAG, from, length);
+
+        /* If we have some data to move. */
+        if (run > 0)
+        {
+            /* If we are also calculating the FCS. */
+            if (fcs != NULL)
+            {
+                /* If data is already in place. */
+                if (to == from)
+                {
+                    /* Only calculate the FCS for this data. */
+                    *fcs = ppp_fcs16_calculate(from, run, *fcs);
+                }
+                else
+                {
+                    /* Move this data and calculate FCS in the same pass. */
+                    *fcs = ppp_fcs16_copy(to, from, run, *fcs);
+                }
+            }
+            else if (to != from)
+            {
+                /* Move this data in-line with other bytes. */
+                memmove(to, from, run);
+            }
+
+            /* Consume this data. */
+            to += run;
+            from += run;
+            length -= run;
+        }
+
         /* If we have a escape sequence. */
-        if (buffer->buffer[0] == PPP_ESCAPE)
+        if ((length > 0) && (*from == PPP_ESCAPE))
         {
             /* If we have enough length on source buffer. */
-            if (buffer->length > 1)
+            if (length > 1)
             {
                 /* Escape this byte and put it back on the buffer in-line with
                  * other bytes. */
-                data[converted] = (buffer->buffer[1] ^ 0x20);
-                converted ++;
+                *to = (from[1] ^ 0x20);
+
+                /* If we are also calculating the FCS. */
+                if (fcs != NULL)
+                {
+                    /* Update the FCS for this byte. */
+                    *fcs = ppp_fcs16_calculate(to, 1, *fcs);
+                }
 
                 /* Consume 2 bytes from the given buffer. */
-                ASSERT(fs_buffer_pull(buffer, NULL, 2, 0) != SUCCESS);
+                to ++;
+                from += 2;
+                length -= 2;
             }
             else
             {
                 /* Consume this byte from the given buffer. */
-                ASSERT(fs_buffer_pull(buffer, NULL, 1, 0) != SUCCESS);
+                from ++;
+                length --;
 
                 /* First byte in the next buffer is needed to be escaped. */
                 *last_escaped = TRUE;
             }
         }
 
-        else
+        /* If we have a flag. */
+        else if (length > 0)
         {
-            /* Put this byte on the destination buffer as it is. */
-            data[converted] = buffer->buffer[0];
-            converted ++;
+            /* Put this flag back on the buffer as it is, flags are not included
+             * in the FCS. */
+            *to = *from;
 
             /* Consume this byte from the given buffer. */
-            ASSERT(fs_buffer_pull(buffer, NULL, 1, 0) != SUCCESS);
+            to ++;
+            from ++;
+            length --;
         }
     }
 
-    /* If we have processed the whole buffer. */
-    if (buffer->length == 0)
-    {
-        /* Reinitialize buffer data. */
-        fs_buffer_update(buffer, data, converted);
-    }
+    /* Reinitialize buffer data. */
+    fs_buffer_update(buffer, buffer->buffer, (uint32_t)(to - buffer->buffer));
 
 } /* ppp_hdlc_unescape_one */
 
@@ -262,6 +355,7 @@ void ppp_hdlc_unescape_one(FS_BUFFER *buffer, uint8_t *last_escaped)
  * @accm: Array of 4 bytes of transmit ACCM to be used to escape the data.
  * @acfc: If address and control fields may be compressed.
  * @lcp: If we are sending a LCP request.
+ * @fcs32: If 32-bit FCS is needed to be used.
  * @flags: Operation flags.
  *  FS_BUFFER_TH: We need to maintain threshold while allocating a buffer.
  * @return: A success status will be returned if header was successfully added,
@@ -269,13 +363,21 @@ void ppp_hdlc_unescape_one(FS_BUFFER *buffer, uint8_t *last_escaped)
  *  to add this header, PPP_NO_BUFFERS will be returned if we don't have a free
  *  buffer to process this PPP packet.
  * This function will add an HDLC header on the given buffer, also this function
- * is responsible for escaping the data after computing and appending the FCS.
+ * is responsible for escaping the data and appending the FCS.
  */
-int32_t ppp_hdlc_header_add(FS_BUFFER_LIST *buffer, uint32_t *accm, uint8_t acfc, uint8_t lcp, uint8_t flags)
+int32_t ppp_hdlc_header_add(FS_BUFFER_LIST *buffer, uint32_t *accm, uint8_t acfc, uint8_t lcp, uint8_t fcs32, uint8_t flags)
 {
     FS_BUFFER_LIST *destination = fs_buffer_get(buffer->fd, FS_LIST_FREE, 0);
     int32_t status = SUCCESS;
-    uint16_t fcs;
+    uint16_t fcs, *fcs16 = &fcs;
+#ifdef PPP_FCS32
+    uint32_t fcs_32;
+    uint8_t fcs_data[4];
+#else
+
+    /* Remove some compiler warnings. */
+    UNUSED_PARAM(fcs32);
+#endif /* PPP_FCS32 */
 
     /* If we do have a destination buffer. */
     if (destination)
@@ -295,22 +397,36 @@ int32_t ppp_hdlc_header_add(FS_BUFFER_LIST *buffer, uint32_t *accm, uint8_t acfc
             }
         }
 
-        /* If address and control fields were successfully added. */
-        if (status == SUCCESS)
+#ifdef PPP_FCS32
+        /* If address and control fields were successfully added and we need
+         * to use 32-bit FCS. */
+        if ((status == SUCCESS) && (fcs32 == TRUE))
         {
-            /* Calculate the FCS of the data. */
-            fcs = ppp_fcs16_buffer_calculate(buffer, PPP_FCS16_INIT);
-            fcs ^= 0xffff;
-
-            /* Push the FCS at the end of buffer. */
-            status = fs_buffer_list_push(buffer, &fcs, 2, flags);
+            /* Calculate the 32-bit FCS of the data. */
+            fcs_32 = ppp_fcs32_buffer_calculate(buffer, PPP_FCS32_INIT);
+            fcs_32 ^= 0xffffffff;
+
+            /* Push the FCS at the end of buffer least significant byte
+             * first. */
+            fcs_data[0] = (uint8_t)(fcs_32);
+            fcs_data[1] = (uint8_t)(fcs_32 >> 8);
+            fcs_data[2] = (uint8_t)(fcs_32 >> 16);
+            fcs_data[3] = (uint8_t)(fcs_32 >> 24);
+            status = fs_buffer_list_push(buffer, fcs_data, 4, flags);
+
+            /* FCS is already on the buffer. */
+            fcs16 = NULL;
         }
+#endif /* PPP_FCS32 */
 
-        /* If FCS was successfully appended. */
+        /* If address and control fields were successfully added. */
         if (status == SUCCESS)
         {
-            /* Escape the given buffer and initialize an other buffer with the result. */
-            status = ppp_hdlc_escape(buffer, destination, accm, lcp, flags);
+            /* Escape the given buffer and initialize an other buffer with the
+             * result, 16-bit FCS will be calculated and appended while
+             * escaping the data. */
+            fcs = PPP_FCS16_INIT;
+            status = ppp_hdlc_escape(buffer, destination, accm, lcp, fcs16, flags);
         }
 
         /* If data was successfully escaped. */
@@ -347,46 +463,302 @@ int32_t ppp_hdlc_header_add(FS_BUFFER_LIST *buffer, uint32_t *accm, uint8_t acfc
 
 } /* ppp_hdlc_header_add */
 
+/*
+ * ppp_hdlc_map_init
+ * @map: Escape map needed to be initialized, must have PPP_HDLC_MAP_WORDS
+ *  words.
+ * @accm: Array of 8 words of the negotiated transmit ACCM.
+ * @lcp: True if we are sending a LCP request.
+ * @return: Returns the scan mode that can be used with this escape map.
+ * This function will initialize an escape map for the given ACCM. If only the
+ * control characters, flag and escape bytes are needed to be escaped the map
+ * can be scanned a word at a time.
+ */
+uint8_t ppp_hdlc_map_init(uint32_t *map, uint32_t *accm, uint8_t lcp)
+{
+    uint32_t others;
+    uint8_t mode;
+
+    /* Initialize the escape map with the ACCM. */
+    memcpy(map, accm, (sizeof(uint32_t) * PPP_HDLC_MAP_WORDS));
+
+    /* If we are sending a LCP request. */
+    if (lcp == TRUE)
+    {
+        /* All the control characters are needed to be escaped. */
+        map[0] = 0xFFFFFFFF;
+    }
+
+    /* Flag and escape bytes are always needed to be escaped. */
+    map[3] |= PPP_HDLC_MAP_FLAGS;
+
+    /* Collect any other bytes that are needed to be escaped. */
+    others = (map[1] | map[2] | (map[3] & (uint32_t)~PPP_HDLC_MAP_FLAGS) | map[4] | map[5] | map[6] | map[7]);
+
+    /* If we have some other bytes needed to be escaped. */
+    if (others != 0)
+    {
+        /* We will need to look up each byte. */
+        mode = PPP_HDLC_SCAN_BYTE;
+    }
+
+    /* If some control characters are needed to be escaped. */
+    else if (map[0] != 0)
+    {
+        /* We will need to look for control characters, flag and escape
+         * bytes. */
+        mode = PPP_HDLC_SCAN_CTRL;
+    }
+    else
+    {
+        /* We will only need to look for the flag and escape bytes. */
+        mode = PPP_HDLC_SCAN_FLAG;
+    }
+
+    /* Return the scan mode to the caller. */
+    return (mode);
+
+} /* ppp_hdlc_map_init */
+
+/*
+ * ppp_hdlc_scan
+ * @map: Escape map to be used.
+ * @mode: Scan mode to be used for this escape map.
+ *  PPP_HDLC_SCAN_BYTE: Each byte will be looked up in the escape map.
+ *  PPP_HDLC_SCAN_FLAG: Only flag and escape bytes are set in the escape map.
+ *  PPP_HDLC_SCAN_CTRL: Only control characters, flag and escape bytes are set
+ *      in the escape map.
+ * @data: Data needed to be scanned.
+ * @length: Number of bytes in the data.
+ * @return: Returns number of bytes at the start of the data that are not set
+ *  in the escape map.
+ * This function will find the first byte in the given data that is set in the
+ * escape map. If allowed by the scan mode, aligned words that don't have a
+ * byte needing attention are skipped as a whole.
+ */
+uint32_t ppp_hdlc_scan(const uint32_t *map, uint8_t mode, uint8_t *data, uint32_t length)
+{
+    uint8_t *ptr = data, *end = (data + length);
+    uint32_t word;
+
+    /* While we have some data to scan. */
+    while (ptr < end)
+    {
+        /* If we can scan a word at a time. */
+        if (mode != PPP_HDLC_SCAN_BYTE)
+        {
+            /* While we have an aligned word to scan. */
+            while ((((uintptr_t)ptr & 0x3) == 0) && ((uint32_t)(end - ptr) >= 4))
+            {
+                /* Pick this word. */
+                word = *((uint32_t *)ptr);
+
+                /* If this word may have a byte needing attention. */
+                if ((PPP_HDLC_HAS_FLAG(word)) || ((mode == PPP_HDLC_SCAN_CTRL) && (PPP_HDLC_HAS_CTRL(word))))
+                {
+                    /* Check this word a byte at a time. */
+                    break;
+                }
+
+                /* Skip this word. */
+                ptr += 4;
+            }
+        }
+
+        /* If we still have a byte to check. */
+        if (ptr < end)
+        {
+            /* If this byte is set in the escape map. */
+            if (PPP_HDLC_MAP_TEST(map, *ptr))
+            {
+                /* Stop here. */
+                break;
+            }
+
+            /* Skip this byte. */
+            ptr ++;
+        }
+    }
+
+    /* Return number of bytes that are not set in the escape map. */
+    return ((uint32_t)(ptr - data));
+
+} /* ppp_hdlc_scan */
+
+/*
+ * ppp_hdlc_escape_data
+ * @dst: Buffer in which escaped data will be pushed.
+ * @map: Escape map to be used.
+ * @mode: Scan mode to be used for this escape map.
+ * @data: Data needed to be escaped.
+ * @length: Number of bytes in the data.
+ * @fcs: If not null, FCS of the data will be updated in this.
+ * @flags: Operation flags.
+ *  FS_BUFFER_TH: We need to maintain threshold while allocating a buffer.
+ * @return: A success status will be returned if data was successfully escaped
+ *  and pushed on the destination buffer.
+ * This function will escape the given data. Escaped bytes and short runs of
+ * data that are not needed to be escaped are collected in a chunk and FCS is
+ * calculated for them while copying, long runs are pushed on the destination
+ * as a whole.
+ */
+static int32_t ppp_hdlc_escape_data(FS_BUFFER_LIST *dst, const uint32_t *map, uint8_t mode, uint8_t *data, uint32_t length, uint16_t *fcs, uint8_t flags)
+{
+    int32_t status = SUCCESS;
+    uint32_t run, used = 0;
+    uint8_t chunk[PPP_HDLC_CHUNK_SIZE];
+
+    /* While we have some data left to escape. */
+    while ((status == SUCCESS) && (length > 0))
+    {
+        /* Find the number of bytes we can push as it is. */
+        run = ppp_hdlc_scan(map, mode, data, length);
+
+        /* If this run will not fit in the chunk. */
+        if (run > (PPP_HDLC_CHUNK_SIZE - used))
+        {
+            /* If we have some data in the chunk. */
+            if (used > 0)
+            {
+                /* Push the chunk before this run. */
+                status = fs_buffer_list_push(dst, chunk, used, flags);
+                used = 0;
+            }
+
+            if (status == SUCCESS)
+            {
+                /* Push this run as it is. */
+                status = fs_buffer_list_push(dst, data, run, flags);
+            }
+
+            /* If we are also calculating the FCS. */
+            if (fcs != NULL)
+            {
+                /* Update the FCS for this run. */
+                *fcs = ppp_fcs16_calculate(data, run, *fcs);
+            }
+        }
+
+        /* If we have a short run. */
+        else if (run > 0)
+        {
+            /* If we are also calculating the FCS. */
+            if (fcs != NULL)
+            {
+                /* Copy this run in the chunk and calculate FCS in the same
+                 * pass. */
+                *fcs = ppp_fcs16_copy(&chunk[used], data, run, *fcs);
+            }
+            else
+            {
+                /* Copy this run in the chunk. */
+                memcpy(&chunk[used], data, run);
+            }
+
+            used += run;
+        }
+
+        /* Consume this run. */
+        data += run;
+        length -= run;
+
+        /* If we have a byte to escape. */
+        if ((status == SUCCESS) && (length > 0))
+        {
+            /* If we don't have space for escaped byte in the chunk. */
+            if ((PPP_HDLC_CHUNK_SIZE - used) < 2)
+            {
+                /* Push the chunk. */
+                status = fs_buffer_list_push(dst, chunk, used, flags);
+                used = 0;
+            }
+
+            if (status == SUCCESS)
+            {
+                /* If we are also calculating the FCS. */
+                if (fcs != NULL)
+                {
+                    /* Update the FCS for this byte. */
+                    *fcs = ppp_fcs16_calculate(data, 1, *fcs);
+                }
+
+                /* Escape this character. */
+                chunk[used ++] = PPP_ESCAPE;
+                chunk[used ++] = (*data ^ 0x20);
+
+                /* Consume this byte. */
+                data ++;
+                length --;
+            }
+        }
+    }
+
+    /* If we have some data left in the chunk. */
+    if ((status == SUCCESS) && (used > 0))
+    {
+        /* Push the remaining chunk. */
+        status = fs_buffer_list_push(dst, chunk, used, flags);
+    }
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* ppp_hdlc_escape_data */
+
 /*
  * ppp_hdlc_escape
  * @src: Buffer needed to be processed.
  * @dst: Buffer in which escaped packet will be pushed.
- * @accm: Array of 4 bytes of the negotiated transmit ACCM.
+ * @accm: Array of 8 words of the negotiated transmit ACCM.
  * @lcp: True if we are sending a LCP request.
+ * @fcs: If not null, FCS of the source data will be calculated starting from
+ *  the value in this and will be appended at the end of escaped data, appended
+ *  FCS will be returned in this.
  * @flags: Operation flags.
  *  FS_BUFFER_TH: We need to maintain threshold while allocating a buffer.
  * This function will escape a HDLC buffer. The result will be larger than the
- * provided buffer so we cannot push the data in the same buffer.
+ * provided buffer so we cannot push the data in the same buffer. Each buffer
+ * in the source chain is escaped as a whole and is consumed after that.
  */
-int32_t ppp_hdlc_escape(FS_BUFFER_LIST *src, FS_BUFFER_LIST *dst, uint32_t *accm, uint8_t lcp, uint8_t flags)
+int32_t ppp_hdlc_escape(FS_BUFFER_LIST *src, FS_BUFFER_LIST *dst, uint32_t *accm, uint8_t lcp, uint16_t *fcs, uint8_t flags)
 {
+    FS_BUFFER *buffer;
     int32_t status = SUCCESS;
-    uint8_t buf[2];
+    uint32_t map[PPP_HDLC_MAP_WORDS];
+    uint8_t mode, fcs_data[2];
+
+    /* Initialize the escape map for this packet. */
+    mode = ppp_hdlc_map_init(map, accm, lcp);
 
     /* While we have some data left in source buffer. */
     while ((status == SUCCESS) && (src->total_length > 0))
     {
-        /* Pull a byte from the source buffer chain. */
-        ASSERT(fs_buffer_list_pull(src, buf, 1, 0) != SUCCESS);
+        /* Pick the head buffer. */
+        buffer = src->list.head;
 
-        /* Check if we need to escape this byte. */
-        if ( ((lcp == TRUE) && (*buf < 0x20)) ||
-              (accm[*buf >> 5] & (uint32_t)(1 << (*buf & 0x1F))) )
-        {
-            /* Escape this character. */
-            buf[1] = buf[0] ^ 0x20;
-            buf[0] = PPP_ESCAPE;
+        /* Escape data in this buffer. */
+        status = ppp_hdlc_escape_data(dst, map, mode, buffer->buffer, buffer->length, fcs, flags);
 
-            /* Push converted byte on the destination. */
-            status = fs_buffer_list_push(dst, buf, 2, flags);
-        }
-        else
+        /* If data was successfully escaped. */
+        if (status == SUCCESS)
         {
-            /* Push the byte as it is. */
-            status = fs_buffer_list_push(dst, buf, 1, flags);
+            /* Consume this buffer, this will also free it. */
+            ASSERT(fs_buffer_list_pull(src, NULL, buffer->length, 0) != SUCCESS);
         }
     }
 
+    /* If we also need to append the FCS. */
+    if ((status == SUCCESS) && (fcs != NULL))
+    {
+        /* Complement the FCS and append it least significant byte first. */
+        *fcs ^= 0xffff;
+        fcs_data[0] = (uint8_t)(*fcs);
+        fcs_data[1] = (uint8_t)(*fcs >> 8);
+
+        /* FCS is also needed to be escaped. */
+        status = ppp_hdlc_escape_data(dst, map, mode, fcs_data, 2, NULL, flags);
+    }
+
     /* Return status to the caller. */
     return (status);
 
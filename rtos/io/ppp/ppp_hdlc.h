@@ -24,12 +24,37 @@
 #define PPP_FLAG                (0x7E)
 #define PPP_ESCAPE              (0x7D)
 
+/* Escape map definitions, escape map has a bit for each byte value, flag and
+ * escape bytes are always escaped. */
+#define PPP_HDLC_MAP_WORDS      (8)
+#define PPP_HDLC_MAP_FLAGS      (0x60000000)
+#define PPP_HDLC_MAP_TEST(m, b) ((m)[(b) >> 5] & ((uint32_t)1 << ((b) & 0x1F)))
+
+/* Number of bytes collected on stack before pushing escaped data. */
+#define PPP_HDLC_CHUNK_SIZE     (64)
+
+/* Escape map scan modes. */
+#define PPP_HDLC_SCAN_BYTE      (0)
+#define PPP_HDLC_SCAN_FLAG      (1)
+#define PPP_HDLC_SCAN_CTRL      (2)
+
+/* Word at a time helpers, these tell if a word may have a byte less than n
+ * or a flag or escape byte. These can return a false positive but never a
+ * false negative. */
+#define PPP_HDLC_ONES           (0x01010101U)
+#define PPP_HDLC_HIGHS          (0x80808080U)
+#define PPP_HDLC_HAS_LESS(w, n) ((((w) - (PPP_HDLC_ONES * (n))) & ~(w)) & PPP_HDLC_HIGHS)
+#define PPP_HDLC_HAS_FLAG(w)    PPP_HDLC_HAS_LESS(((w) ^ (PPP_HDLC_ONES * 0x7C)), 3)
+#define PPP_HDLC_HAS_CTRL(w)    PPP_HDLC_HAS_LESS((w), 0x20)
+
 /* Function prototypes. */
-int32_t ppp_hdlc_header_parse(FS_BUFFER_LIST *, uint8_t);
-int32_t ppp_hdlc_unescape(FS_BUFFER_LIST *buffer);
-void ppp_hdlc_unescape_one(FS_BUFFER *, uint8_t *);
-int32_t ppp_hdlc_header_add(FS_BUFFER_LIST *, uint32_t *, uint8_t, uint8_t, uint8_t);
-int32_t ppp_hdlc_escape(FS_BUFFER_LIST *, FS_BUFFER_LIST *, uint32_t *, uint8_t, uint8_t);
+int32_t ppp_hdlc_header_parse(FS_BUFFER_LIST *, uint8_t, uint8_t);
+int32_t ppp_hdlc_unescape(FS_BUFFER_LIST *, uint16_t *);
+void ppp_hdlc_unescape_one(FS_BUFFER *, uint8_t *, uint16_t *);
+int32_t ppp_hdlc_header_add(FS_BUFFER_LIST *, uint32_t *, uint8_t, uint8_t, uint8_t, uint8_t);
+uint8_t ppp_hdlc_map_init(uint32_t *, uint32_t *, uint8_t);
+uint32_t ppp_hdlc_scan(const uint32_t *, uint8_t, uint8_t *, uint32_t);
+int32_t ppp_hdlc_escape(FS_BUFFER_LIST *, FS_BUFFER_LIST *, uint32_t *, uint8_t, uint16_t *, uint8_t);
 
 #endif /* IO_PPP */
 
@@ -31,6 +31,29 @@ PPP_PROTO ppp_proto_ipcp =
     .protocol       = PPP_PROTO_IPCP,
 };
 
+#ifdef PPP_VJ
+/* Internal function prototypes. */
+static void ppp_ipcp_vj_option(PPP_CONF_OPT *);
+
+/*
+ * ppp_ipcp_vj_option
+ * @option: Option needed to be populated.
+ * This function will populate the IP compression protocol option for VJ
+ * compression with the number of slots we have, we can always uncompress
+ * frames with compressed slot ID.
+ */
+static void ppp_ipcp_vj_option(PPP_CONF_OPT *option)
+{
+    option->type = PPP_IPCP_OPT_COMP;
+    option->length = 6;
+    option->data[0] = (uint8_t)(PPP_PROTO_VJ_COMP >> 8);
+    option->data[1] = (uint8_t)(PPP_PROTO_VJ_COMP);
+    option->data[2] = (uint8_t)(PPP_VJ_SLOTS - 1);
+    option->data[3] = TRUE;
+
+} /* ppp_ipcp_vj_option */
+#endif /* PPP_VJ */
+
 /*
  * ppp_ipcp_option_negotiable
  * @ppp: PPP private data.
@@ -47,8 +70,12 @@ uint8_t ppp_ipcp_option_negotiable(PPP *ppp, PPP_CONF_OPT *option)
     /* Remove some compiler warnings. */
     UNUSED_PARAM(ppp);
 
-    /* For now only IP address option is negotiable. */
-    if (option->type == PPP_IPCP_OPT_IP)
+    /* For now only IP address and VJ compression options are negotiable. */
+    if ((option->type == PPP_IPCP_OPT_IP)
+#ifdef PPP_VJ
+        || (option->type == PPP_IPCP_OPT_COMP)
+#endif
+       )
     {
         /* This is negotiable. */
         negotiable = TRUE;
@@ -123,7 +150,61 @@ int32_t ppp_ipcp_option_pocess(PPP *ppp, PPP_CONF_OPT *option, PPP_CONF_PKT *rx_
         }
     }
 
-    /* Always return success. */
+#ifdef PPP_VJ
+    /* If we have IP compression protocol option. */
+    if (option->type == PPP_IPCP_OPT_COMP)
+    {
+        /* If this is a configuration request. */
+        if (rx_packet->code == PPP_CONFIG_REQ)
+        {
+            /* If peer can uncompress VJ compressed headers. */
+            if ((option->length == 6) && (NET_GET_BE16(option->data) == PPP_PROTO_VJ_COMP))
+            {
+                /* Configure the compressor with the slots peer has. */
+                ppp_vj_tx_configure(&ppp->vj, (uint32_t)(option->data[2] + 1), option->data[3]);
+                ppp->flags |= PPP_FLAG_TX_VJ;
+
+                /* Return success. */
+                status = SUCCESS;
+            }
+            else
+            {
+                /* Tell the other end to use VJ compression. */
+                ppp_ipcp_vj_option(option);
+                status = PPP_VALUE_NOT_VALID;
+            }
+        }
+
+        /* If this is a ACK for our configuration. */
+        if (rx_packet->code == PPP_CONFIG_ACK)
+        {
+            /* If peer will send VJ compressed headers. */
+            if ((option->length == 6) && (NET_GET_BE16(option->data) == PPP_PROTO_VJ_COMP))
+            {
+                /* We can now receive VJ compressed frames. */
+                ppp->flags |= PPP_FLAG_RX_VJ;
+            }
+
+            /* Return success. */
+            status = SUCCESS;
+        }
+
+        /* If peer has rejected VJ compression or suggested an other
+         * protocol. */
+        if ((rx_packet->code == PPP_CONFIG_REJECT) ||
+            ((rx_packet->code == PPP_CONFIG_NAK) && (NET_GET_BE16(option->data) != PPP_PROTO_VJ_COMP)))
+        {
+            /* Don't request VJ compression again, peer will send the
+             * headers as they are. */
+            ppp->flags |= PPP_FLAG_NO_VJ;
+
+            /* Return success. */
+            status = SUCCESS;
+        }
+    }
+#endif /* PPP_VJ */
+
+    /* Return status to the caller. */
     return (status);
 
 } /* ppp_ipcp_option_pocess */
@@ -149,6 +230,16 @@ uint8_t ppp_ipcp_option_length_valid(PPP *ppp, PPP_CONF_OPT *option)
         valid = TRUE;
     }
 
+#ifdef PPP_VJ
+    /* IP compression protocol option should at least have the protocol, any
+     * other protocol will be NAKed. */
+    if ((option->type == PPP_IPCP_OPT_COMP) && (option->length >= 4))
+    {
+        /* Option length is valid. */
+        valid = TRUE;
+    }
+#endif /* PPP_VJ */
+
     /* Return if the given option is valid. */
     return (valid);
 
@@ -174,43 +265,54 @@ int32_t ppp_ipcp_update(void *fd, PPP *ppp, PPP_CONF_PKT *rx_packet, PPP_CONF_PK
     ASSERT(tx_buffer == NULL);
 
     /* If we are sending an NAK it means we have the required configuration
-     * options and we can now send our configuration in reply. */
-    if (tx_packet->code == PPP_CONFIG_NAK)
+     * options and we can now send our configuration in reply, if peer has
+     * NAKed or rejected our configuration send it again. */
+    if (((tx_packet->code == PPP_CONFIG_NAK) && (ppp->local_ip_address == 0)) ||
+        (((rx_packet->code == PPP_CONFIG_NAK) ||
+          (rx_packet->code == PPP_CONFIG_REJECT)) &&
+         (++(ppp->num_failure) <= PPP_MAX_FAILURE)))
     {
-        /* If we have not received an ACK for our configuration. */
-        if (ppp->local_ip_address == 0)
+        /* Clear the transmit packet and buffer chain structures. */
+        memset(tx_packet, 0, sizeof(PPP_CONF_PKT));
+
+        /* We have successfully ACKed a configuration request we will send our
+         * configuration now.. */
+        tx_packet->code = PPP_CONFIG_REQ;
+        tx_packet->id = ++(ppp->state_data.ipcp_id);
+
+        /* Add IP configuration option in the transmit buffer. */
+        memcpy(option.data, (uint8_t [])PPP_LOCAL_IP_ADDRESS, 4);
+        option.type = PPP_IPCP_OPT_IP;
+        option.length = 6;
+        status = ppp_packet_configuration_option_add(tx_buffer, &option);
+
+#ifdef PPP_VJ
+        /* If IP option was successfully added and peer has not rejected
+         * VJ compression. */
+        if ((status == SUCCESS) && ((ppp->flags & PPP_FLAG_NO_VJ) == 0))
         {
-            /* Clear the transmit packet and buffer chain structures. */
-            memset(tx_packet, 0, sizeof(PPP_CONF_PKT));
-
-            /* We have successfully ACKed a configuration request we will send our
-             * configuration now.. */
-            tx_packet->code = PPP_CONFIG_REQ;
-            tx_packet->id = ++(ppp->state_data.ipcp_id);
-
-            /* Add IP configuration option in the transmit buffer. */
-            memcpy(option.data, (uint8_t [])PPP_LOCAL_IP_ADDRESS, 4);
-            option.type = PPP_IPCP_OPT_IP;
-            option.length = 6;
+            /* Request VJ compression for the frames we receive. */
+            ppp_ipcp_vj_option(&option);
             status = ppp_packet_configuration_option_add(tx_buffer, &option);
+        }
+#endif /* PPP_VJ */
+
+        /* If configuration option was successfully added. */
+        if (status == SUCCESS)
+        {
+            /* Push the PPP header on the buffer. */
+            status = ppp_packet_configuration_header_add(tx_buffer, tx_packet);
 
-            /* If configuration option was successfully added. */
+            /* If configuration header was successfully added. */
             if (status == SUCCESS)
             {
-                /* Push the PPP header on the buffer. */
-                status = ppp_packet_configuration_header_add(tx_buffer, tx_packet);
+                /* Send this buffer. */
+                status = ppp_transmit_buffer_instance(ppp, tx_buffer, PPP_PROTO_IPCP, 0);
 
-                /* If configuration header was successfully added. */
                 if (status == SUCCESS)
                 {
-                    /* Send this buffer. */
-                    status = ppp_transmit_buffer_instance(ppp, tx_buffer, PPP_PROTO_IPCP, 0);
-
-                    if (status == SUCCESS)
-                    {
-                        /* Clear the TX buffer. */
-                        tx_buffer = NULL;
-                    }
+                    /* Clear the TX buffer. */
+                    tx_buffer = NULL;
                 }
             }
         }
@@ -1,3 +1,6 @@
 # Setup configuration options.
 setup_option_def(PPP_LOCAL_IP_ADDRESS "{192, 168, 0, 1}" MACRO_OPEN "PPP local IP address in the form of {A, B, C, D}." CONFIG_FILE "ppp_ipcp_config")
-setup_option_def(PPP_REMOTE_IP_ADDRESS "{192, 168, 0, 2}" MACRO_OPEN "PPP remote IP address in the form of {A, B, C, D}." CONFIG_FILE "ppp_ipcp_config")
\ No newline at end of file
+setup_option_def(PPP_REMOTE_IP_ADDRESS "{192, 168, 0, 2}" MACRO_OPEN "PPP remote IP address in the form of {A, B, C, D}." CONFIG_FILE "ppp_ipcp_config")
+setup_option_def(PPP_VJ OFF DEFINE "Enable Van Jacobson TCP/IP header compression, compression will also be requested from the peer." CONFIG_FILE "ppp_ipcp_config")
+setup_option_def(PPP_VJ_SLOTS 8 INT "Number of VJ compression slots in each direction, each slot takes PPP_VJ_HEADER_SIZE + 1 bytes." CONFIG_FILE "ppp_ipcp_config")
+setup_option_def(PPP_VJ_HEADER_SIZE 64 INT "Largest TCP/IP header that can be compressed with VJ compression, 40 to 128 bytes." CONFIG_FILE "ppp_ipcp_config")
\ No newline at end of file
@@ -32,6 +32,9 @@ PPP_PROTO ppp_proto_lcp =
 /* To be negotiated ACCM value. */
 const uint32_t ppp_lcp_accm = 0x0;
 
+/* To be negotiated FCS. */
+const uint8_t ppp_lcp_fcs = PPP_LCP_FCS_32;
+
 /* PPP option index look-up table. */
 const int8_t ppp_lcp_opt_index[LCP_OPT_DB_NUM_OPTIONS] =
 {
@@ -44,6 +47,7 @@ const int8_t ppp_lcp_opt_index[LCP_OPT_DB_NUM_OPTIONS] =
     -1,     /* 6: Invalid option. */
     3,      /* 8: ACFC. */
     4,      /* 7: PFC. */
+    5,      /* 9: FCS alternatives. */
 };
 
 /* Option valid value look-up table. */
@@ -54,6 +58,7 @@ const uint8_t *ppp_lcp_option_values[LCP_OPT_DB_NUM_OPTIONS_VALID] =
     (uint8_t *)LCP_OPT_RANDOM,      /* 5: MAGIC. */
     (uint8_t *)LCP_OPT_NO_VALUE,    /* 8: ACFC. */
     (uint8_t *)LCP_OPT_NO_VALUE,    /* 7: PFC. */
+    (uint8_t *)&ppp_lcp_fcs,        /* 9: FCS alternatives. */
 };
 
 /* Option valid length look-up table. */
@@ -64,6 +69,7 @@ const uint8_t ppp_lcp_option_valid_lengths[LCP_OPT_DB_NUM_OPTIONS_VALID] =
     0x6,    /* 5: MAGIC. */
     0x2,    /* 8: ACFC. */
     0x2,    /* 7: PFC. */
+    0x3,    /* 9: FCS alternatives. */
 };
 
 /*
@@ -74,18 +80,28 @@ const uint8_t ppp_lcp_option_valid_lengths[LCP_OPT_DB_NUM_OPTIONS_VALID] =
 void ppp_lcp_state_initialize(PPP *ppp)
 {
     /* Initialize PPP connection state. */
-    ppp->flags &= (uint32_t)~(PPP_FLAG_ACFC | PPP_FLAG_PFC);
+    ppp->flags &= (uint32_t)~(PPP_FLAG_RX_ACFC | PPP_FLAG_RX_PFC | PPP_FLAG_TX_ACFC | PPP_FLAG_TX_PFC | PPP_FLAG_TX_FCS32 | PPP_FLAG_RX_FCS32 | PPP_FLAG_NO_FCS32 | PPP_FLAG_TX_VJ | PPP_FLAG_RX_VJ | PPP_FLAG_NO_VJ);
     ppp->rx_accm = (0xFFFFFFFF);
     ppp->tx_accm[0] = (0xFFFFFFFF);
     ppp->tx_accm[1] = (0x0);
     ppp->tx_accm[2] = (0x0);
     ppp->tx_accm[3] = (0x60000000);
     ppp->mru = 1500;
+    ppp->num_failure = 0;
+
+    /* Reset the header template for the frames we send. */
+    ppp_tx_header_update(ppp);
+
+#ifdef PPP_VJ
+    /* Reset the header compression state. */
+    ppp_vj_init(&ppp->vj);
+#endif
 
 } /* ppp_lcp_state_initialize */
 
 /*
  * ppp_lcp_configuration_add
+ * @ppp: PPP private data.
  * @buffer: Buffer needed to process.
  * @return: A success status will be returned if all required options were
  *  added in the buffer. PPP_INTERNAL_ERROR will be returned if an internal
@@ -93,18 +109,26 @@ void ppp_lcp_state_initialize(PPP *ppp)
  * This function will add our LCP configuration options so that a configuration
  * request can be sent.
  */
-int32_t ppp_lcp_configuration_add(FS_BUFFER_LIST *buffer)
+int32_t ppp_lcp_configuration_add(PPP *ppp, FS_BUFFER_LIST *buffer)
 {
     PPP_CONF_OPT option;
     int32_t random, status = SUCCESS;
+    uint32_t send_mask = PPP_LCP_OPTION_SEND_MASK;
     uint8_t opt_type, opt_len, *db_value;
 
+    /* If peer did not accept 32-bit FCS, don't request FCS alternatives so
+     * that the default 16-bit FCS is used. */
+    if (ppp->flags & PPP_FLAG_NO_FCS32)
+    {
+        send_mask &= (uint32_t)~(1 << PPP_LCP_OPT_FCS_ALT);
+    }
+
     /* Check all the possible options and see if we need to send them in our
      * configuration packet. */
     for (opt_type = 0; (status == SUCCESS) && (opt_type < LCP_OPT_DB_NUM_OPTIONS); opt_type++)
     {
         /* If we need to send this option. */
-        if (((1 << opt_type) & PPP_LCP_OPTION_SEND_MASK))
+        if (((1 << opt_type) & send_mask))
         {
             /* Pick up the option value and lengths needed to be send. */
             db_value = (uint8_t *)ppp_lcp_option_values[ppp_lcp_opt_index[opt_type]];
@@ -178,11 +202,14 @@ uint8_t ppp_lcp_option_negotiable(PPP *ppp, PPP_CONF_OPT *option)
  * @ppp: PPP private data.
  * @option: Option needed to be process.
  * @rx_packet: Parsed PPP packet.
- * @return: Always return success.
+ * @return: A success status will be returned if option was accepted,
+ *  PPP_VALUE_NOT_VALID will be returned if option value is not acceptable.
  * This function will process the data for a given option.
  */
 int32_t ppp_lcp_option_pocess(PPP *ppp, PPP_CONF_OPT *option, PPP_CONF_PKT *rx_packet)
 {
+    int32_t status = SUCCESS;
+
     /* Process the option data. */
     switch (option->type)
     {
@@ -240,12 +267,20 @@ int32_t ppp_lcp_option_pocess(PPP *ppp, PPP_CONF_OPT *option, PPP_CONF_PKT *rx_p
     /* Protocol field compression. */
     case PPP_LCP_OPT_PFC:
 
+        /* If peer can receive compressed protocol field. */
+        if (rx_packet->code == PPP_CONFIG_REQ)
+        {
+            /* Compress the protocol field in the frames we send. */
+            ppp->flags |= PPP_FLAG_TX_PFC;
+            ppp_tx_header_update(ppp);
+        }
+
         /* If we have received an ACK for this configuration. */
-        if (rx_packet->code == PPP_CONFIG_ACK)
+        else if (rx_packet->code == PPP_CONFIG_ACK)
         {
             /* Set the flag in PPP structure that we might
              * receive compressed protocol field. */
-            ppp->flags |= PPP_FLAG_PFC;
+            ppp->flags |= PPP_FLAG_RX_PFC;
         }
 
         break;
@@ -253,23 +288,84 @@ int32_t ppp_lcp_option_pocess(PPP *ppp, PPP_CONF_OPT *option, PPP_CONF_PKT *rx_p
     /* Address and control field compression. */
     case PPP_LCP_OPT_ACFC:
 
+        /* If peer can receive compressed address and control fields. */
+        if (rx_packet->code == PPP_CONFIG_REQ)
+        {
+            /* Drop address and control fields in the frames we send. */
+            ppp->flags |= PPP_FLAG_TX_ACFC;
+            ppp_tx_header_update(ppp);
+        }
+
         /* If we have received an ACK for this configuration. */
-        if (rx_packet->code == PPP_CONFIG_ACK)
+        else if (rx_packet->code == PPP_CONFIG_ACK)
         {
             /* Set the flag in PPP structure that we might
              * receive compressed address and control fields. */
-            ppp->flags |= PPP_FLAG_ACFC;
+            ppp->flags |= PPP_FLAG_RX_ACFC;
         }
 
         break;
 
+#ifdef PPP_FCS32
+    /* FCS alternatives. */
+    case PPP_LCP_OPT_FCS_ALT:
+
+        /* If peer is requesting the FCS it will receive. */
+        if (rx_packet->code == PPP_CONFIG_REQ)
+        {
+            /* If 32-bit FCS was requested. */
+            if (option->data[0] & PPP_LCP_FCS_32)
+            {
+                /* Use 32-bit FCS for the frames we send. */
+                ppp->flags |= PPP_FLAG_TX_FCS32;
+            }
+
+            /* If 16-bit FCS was requested. */
+            else if (option->data[0] & PPP_LCP_FCS_16)
+            {
+                /* Use 16-bit FCS for the frames we send. */
+                ppp->flags &= (uint32_t)~(PPP_FLAG_TX_FCS32);
+            }
+            else
+            {
+                /* We don't support null FCS, suggest the ones we support. */
+                option->data[0] = (PPP_LCP_FCS_16 | PPP_LCP_FCS_32);
+                status = PPP_VALUE_NOT_VALID;
+            }
+        }
+
+        /* If we have received an ACK for this configuration. */
+        else if (rx_packet->code == PPP_CONFIG_ACK)
+        {
+            /* If peer will be sending 32-bit FCS. */
+            if (option->data[0] & PPP_LCP_FCS_32)
+            {
+                /* Set the flag in PPP structure that we will receive 32-bit
+                 * FCS. */
+                ppp->flags |= PPP_FLAG_RX_FCS32;
+            }
+        }
+
+        /* If peer has rejected 32-bit FCS or suggested an other FCS. */
+        else if ((rx_packet->code == PPP_CONFIG_REJECT) ||
+                 ((rx_packet->code == PPP_CONFIG_NAK) && ((option->data[0] & PPP_LCP_FCS_32) == 0)))
+        {
+            /* Don't request FCS alternatives again and fall back to 16-bit
+             * FCS. */
+            ppp->flags |= PPP_FLAG_NO_FCS32;
+            ppp->flags &= (uint32_t)~(PPP_FLAG_RX_FCS32);
+        }
+
+        break;
+#endif /* PPP_FCS32 */
+
     default:
         /* Nothing to do here. */
         break;
     }
 
-    /* Always return success. */
-    return (SUCCESS);
+    /* Return status to the caller. */
+    return (status);
 
 } /* ppp_lcp_option_pocess */
 
@@ -328,9 +424,13 @@ int32_t ppp_lcp_update(void *fd, PPP *ppp, PPP_CONF_PKT *rx_packet, PPP_CONF_PKT
     ASSERT(tx_buffer == NULL);
 
     /* Check if we have received a request and we have sent an ACK in
-     * response, send our own configuration. */
-    if ( (rx_packet->code == PPP_CONFIG_REQ) &&
-         (tx_packet->code == PPP_CONFIG_ACK) )
+     * response, or peer has NAKed or rejected our configuration, send our own
+     * configuration. */
+    if (((rx_packet->code == PPP_CONFIG_REQ) &&
+         (tx_packet->code == PPP_CONFIG_ACK)) ||
+        (((rx_packet->code == PPP_CONFIG_NAK) ||
+          (rx_packet->code == PPP_CONFIG_REJECT)) &&
+         (++(ppp->num_failure) <= PPP_MAX_FAILURE)))
     {
         /* Clear the transmit packet and buffer chain structures. */
         memset(tx_packet, 0, sizeof(PPP_CONF_PKT));
@@ -341,7 +441,7 @@ int32_t ppp_lcp_update(void *fd, PPP *ppp, PPP_CONF_PKT *rx_packet, PPP_CONF_PKT
         tx_packet->id = ++(ppp->state_data.lcp_id);
 
         /* Add configuration options we need to send. */
-        status = ppp_lcp_configuration_add(tx_buffer);
+        status = ppp_lcp_configuration_add(ppp, tx_buffer);
 
         /* If LCP configuration options were successfully added. */
         if (status == SUCCESS)
@@ -364,6 +464,14 @@ int32_t ppp_lcp_update(void *fd, PPP *ppp, PPP_CONF_PKT *rx_packet, PPP_CONF_PKT
         }
     }
 
+    /* If we did not accept the configuration request. */
+    else if (rx_packet->code == PPP_CONFIG_REQ)
+    {
+        /* Don't compress the frames we send unless peer requests it again. */
+        ppp->flags &= (uint32_t)~(PPP_FLAG_TX_ACFC | PPP_FLAG_TX_PFC);
+        ppp_tx_header_update(ppp);
+    }
+
     /* Check if we have received an ACK. */
     else if (rx_packet->code == PPP_CONFIG_ACK)
     {
@@ -371,6 +479,7 @@ int32_t ppp_lcp_update(void *fd, PPP *ppp, PPP_CONF_PKT *rx_packet, PPP_CONF_PKT
         /* Now start network configuration. */
         ppp->state = PPP_STATE_IPCP;
         ppp->state_data.ipcp_id = 0;
+        ppp->num_failure = 0;
 
         /* Clear the assigned IP addresses. */
         ppp->local_ip_address = ppp->remote_ip_address = 0;
@@ -25,24 +25,35 @@
 #define PPP_LCP_OPT_MAGIC               5
 #define PPP_LCP_OPT_PFC                 7
 #define PPP_LCP_OPT_ACFC                8
+#define PPP_LCP_OPT_FCS_ALT             9
+
+/* FCS alternatives option values. */
+#define PPP_LCP_FCS_NULL                0x1
+#define PPP_LCP_FCS_16                  0x2
+#define PPP_LCP_FCS_32                  0x4
 
 /* PPP option DB configuration. */
-#define LCP_OPT_DB_NUM_OPTIONS          (9)
-#define LCP_OPT_DB_NUM_OPTIONS_VALID    (5)
+#define LCP_OPT_DB_NUM_OPTIONS          (10)
+#define LCP_OPT_DB_NUM_OPTIONS_VALID    (6)
 #define LCP_OPT_RANDOM                  (-1)
 #define LCP_OPT_NO_VALUE                (-2)
 
 /* Supported option definition. */
 /* Each bit specifies one option type starting from 0 at LSb-0. */
+#ifdef PPP_FCS32
+#define PPP_LCP_OPTION_NEG_MASK         (0x3A6)
+#define PPP_LCP_OPTION_SEND_MASK        (0x3A4)
+#else
 #define PPP_LCP_OPTION_NEG_MASK         (0x1A6)
 #define PPP_LCP_OPTION_SEND_MASK        (0x1A4)
+#endif
 
 /* Exported variables. */
 extern PPP_PROTO ppp_proto_lcp;
 
 /* Function prototypes. */
 void ppp_lcp_state_initialize(PPP *);
-int32_t ppp_lcp_configuration_add(FS_BUFFER_LIST *);
+int32_t ppp_lcp_configuration_add(PPP *, FS_BUFFER_LIST *);
 uint8_t ppp_lcp_option_negotiable(PPP *, PPP_CONF_OPT *);
 int32_t ppp_lcp_option_pocess(PPP *, PPP_CONF_OPT *, PPP_CONF_PKT *);
 uint8_t ppp_lcp_option_length_valid(PPP *, PPP_CONF_OPT *);
@@ -0,0 +1,723 @@
+/*
+ * ppp_vj.c
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+
+#ifdef IO_PPP
+#include <ppp.h>
+
+#ifdef PPP_VJ
+#include <string.h>
+#include <fs.h>
+#include <net.h>
+#include <net_csum.h>
+#include <net_ipv4.h>
+#include <net_tcp.h>
+
+/* Internal function prototypes. */
+static uint32_t ppp_vj_header_length(uint8_t *, uint32_t);
+static PPP_VJ_SLOT *ppp_vj_tx_slot(PPP_VJ_STATE *, uint8_t *, uint8_t *, uint8_t *);
+static uint32_t ppp_vj_encode(uint8_t *, uint32_t);
+static uint32_t ppp_vj_decode(uint8_t *, uint32_t *);
+
+/*
+ * ppp_vj_init
+ * @vj: VJ state needed to be initialized.
+ * This function will initialize the VJ compression state for a PPP link, no
+ * frame will be compressed until compressor is configured.
+ */
+void ppp_vj_init(PPP_VJ_STATE *vj)
+{
+    /* Clear the VJ state. */
+    memset(vj, 0, sizeof(PPP_VJ_STATE));
+
+    /* We have not yet sent or received a slot ID. */
+    vj->tx_last = 0xFF;
+    vj->rx_last = 0xFF;
+
+    /* Drop compressed frames until we receive an explicit slot ID. */
+    vj->flags = PPP_VJ_RX_TOSS;
+
+} /* ppp_vj_init */
+
+/*
+ * ppp_vj_tx_configure
+ * @vj: VJ state needed to be configured.
+ * @num_slots: Number of slots the peer can decompress.
+ * @cid: If slot ID can be omitted if it is same as the last frame.
+ * This function will configure and reset the VJ compressor.
+ */
+void ppp_vj_tx_configure(PPP_VJ_STATE *vj, uint32_t num_slots, uint8_t cid)
+{
+    uint32_t i;
+
+    /* Only use the slots we have. */
+    vj->tx_num_slots = (uint8_t)MIN(num_slots, PPP_VJ_SLOTS);
+
+    /* Reset all the slots. */
+    for (i = 0; i < vj->tx_num_slots; i++)
+    {
+        vj->tx_order[i] = (uint8_t)i;
+        vj->tx_slot[i].hlen = 0;
+    }
+    vj->tx_last = 0xFF;
+
+    /* If we can compress the slot ID. */
+    if (cid)
+    {
+        vj->flags |= PPP_VJ_TX_CID;
+    }
+    else
+    {
+        vj->flags &= (uint8_t)~(PPP_VJ_TX_CID);
+    }
+
+} /* ppp_vj_tx_configure */
+
+/*
+ * ppp_vj_header_length
+ * @header: TCP/IP header.
+ * @length: Number of valid bytes in the header.
+ * @return: Returns the length of TCP/IP header, zero will be returned if this
+ *  is not a TCP/IP header that can be handled by VJ compression.
+ * This function will validate a TCP/IP header and return it's length.
+ */
+static uint32_t ppp_vj_header_length(uint8_t *header, uint32_t length)
+{
+    uint32_t ihl, hlen = 0;
+
+    /* Pick the IPv4 header length. */
+    ihl = (uint32_t)((IPV4_HDR_VER_IHL(header) & IPV4_HDR_IHL_MASK) << 2);
+
+    /* If this is a valid IPv4 header and we have the TCP header. */
+    if (((IPV4_HDR_VER_IHL(header) & IPV4_HDR_VER_MASK) == IPV4_HDR_VER) &&
+        (ihl >= IPV4_HDR_SIZE) && ((ihl + TCP_HRD_SIZE) <= length))
+    {
+        /* Pick the TCP/IP header length. */
+        hlen = ihl + (uint32_t)((TCP_HRD_FLAGS(&header[ihl]) & TCP_HDR_HDR_LEN_MSK) >> (TCP_HDR_HDR_LEN_SHIFT - 2));
+
+        /* If we don't have complete TCP header. */
+        if ((hlen < (ihl + TCP_HRD_SIZE)) || (hlen > length))
+        {
+            /* This header cannot be handled. */
+            hlen = 0;
+        }
+    }
+
+    /* Return the TCP/IP header length. */
+    return (hlen);
+
+} /* ppp_vj_header_length */
+
+/*
+ * ppp_vj_tx_slot
+ * @vj: VJ state.
+ * @header: TCP/IP header for which a slot is needed.
+ * @id: Slot ID will be returned here.
+ * @found: Will be set to true if slot was already being used for this
+ *  connection.
+ * @return: Returns the slot for the given connection.
+ * This function will search for the slot used for a TCP connection, if not
+ * found the least recently used slot will be returned.
+ */
+static PPP_VJ_SLOT *ppp_vj_tx_slot(PPP_VJ_STATE *vj, uint8_t *header, uint8_t *id, uint8_t *found)
+{
+    PPP_VJ_SLOT *slot;
+    uint32_t i, ihl, slot_ihl;
+
+    /* Pick the IPv4 header length. */
+    ihl = (uint32_t)((IPV4_HDR_VER_IHL(header) & IPV4_HDR_IHL_MASK) << 2);
+    *found = FALSE;
+
+    /* Search the slots from the most recently used. */
+    for (i = 0; i < vj->tx_num_slots; i++)
+    {
+        slot = &vj->tx_slot[vj->tx_order[i]];
+
+        /* If this slot is being used. */
+        if (slot->hlen != 0)
+        {
+            slot_ihl = (uint32_t)((IPV4_HDR_VER_IHL(slot->header) & IPV4_HDR_IHL_MASK) << 2);
+
+            /* If addresses and ports are same. */
+            if ((memcmp(&slot->header[IPV4_HDR_SRC_OFFSET], &header[IPV4_HDR_SRC_OFFSET], 8) == 0) &&
+                (memcmp(&slot->header[slot_ihl], &header[ihl], 4) == 0))
+            {
+                /* Connection already has a slot. */
+                *found = TRUE;
+                break;
+            }
+        }
+    }
+
+    /* If connection does not have a slot. */
+    if (*found == FALSE)
+    {
+        /* Reuse the least recently used slot. */
+        i = (uint32_t)(vj->tx_num_slots - 1);
+    }
+
+    /* Move this slot to the front. */
+    *id = vj->tx_order[i];
+    memmove(&vj->tx_order[1], &vj->tx_order[0], i);
+    vj->tx_order[0] = *id;
+
+    /* Return the slot for this connection. */
+    return (&vj->tx_slot[*id]);
+
+} /* ppp_vj_tx_slot */
+
+/*
+ * ppp_vj_encode
+ * @data: Buffer in which value is needed to be encoded.
+ * @value: Value needed to be encoded.
+ * @return: Returns number of bytes used.
+ * This function will encode a delta in the compressed header, zero or a value
+ * larger than a byte is encoded as a zero byte followed by 16-bit value.
+ */
+static uint32_t ppp_vj_encode(uint8_t *data, uint32_t value)
+{
+    uint32_t length = 1;
+
+    /* If this value does not fit in a byte. */
+    if ((value == 0) || (value > 0xFF))
+    {
+        /* Encode the 16-bit value. */
+        data[0] = 0;
+        data[1] = (uint8_t)(value >> 8);
+        data[2] = (uint8_t)(value);
+        length = 3;
+    }
+    else
+    {
+        /* Encode this value in a byte. */
+        data[0] = (uint8_t)value;
+    }
+
+    /* Return number of bytes used. */
+    return (length);
+
+} /* ppp_vj_encode */
+
+/*
+ * ppp_vj_decode
+ * @data: Buffer from which value is needed to be decoded.
+ * @value: Decoded value will be returned here.
+ * @return: Returns number of bytes used.
+ * This function will decode a delta from the compressed header.
+ */
+static uint32_t ppp_vj_decode(uint8_t *data, uint32_t *value)
+{
+    uint32_t length = 1;
+
+    /* If this is a 16-bit value. */
+    if (data[0] == 0)
+    {
+        /* Decode the 16-bit value. */
+        *value = NET_GET_BE16(&data[1]);
+        length = 3;
+    }
+    else
+    {
+        /* Pick the value. */
+        *value = data[0];
+    }
+
+    /* Return number of bytes used. */
+    return (length);
+
+} /* ppp_vj_decode */
+
+/*
+ * ppp_vj_compress
+ * @vj: VJ state.
+ * @buffer: IPv4 packet needed to be sent.
+ * @proto: PPP protocol for this packet, will be updated to
+ *  PPP_PROTO_VJ_COMP or PPP_PROTO_VJ_UNCOMP if header was compressed or a
+ *  slot was assigned.
+ * @flags: Operation flags.
+ *  FS_BUFFER_TH: We need to maintain threshold while allocating a buffer.
+ * @return: A success status will be returned if packet can be sent, buffer
+ *  errors will be returned if we ran out of buffers.
+ * This function will compress the TCP/IP header of a packet being sent as
+ * specified by RFC-1144. Packets that cannot be compressed are left as they
+ * are, and packet that establish a slot are sent with slot ID in the protocol
+ * field of the IPv4 header.
+ */
+int32_t ppp_vj_compress(PPP_VJ_STATE *vj, FS_BUFFER_LIST *buffer, uint16_t *proto, uint8_t flags)
+{
+    PPP_VJ_SLOT *slot;
+    int32_t status = SUCCESS;
+    uint32_t hlen = 0, ihl = 0, length, delta_s, delta_a, delta, num_bytes = 0, comp_length = 0;
+    uint8_t header[PPP_VJ_HEADER_SIZE], deltas[PPP_VJ_COMP_SIZE], comp[PPP_VJ_COMP_SIZE];
+    uint8_t *tcp = header, *old_tcp, changes = 0, compress = FALSE, found, id;
+
+    /* If we have slots and this can be a TCP/IP packet. */
+    length = buffer->total_length;
+    if ((vj->tx_num_slots > 0) && (length >= (IPV4_HDR_SIZE + TCP_HRD_SIZE)))
+    {
+        /* Copy the TCP/IP header. */
+        ASSERT(fs_buffer_list_pull(buffer, header, MIN(length, PPP_VJ_HEADER_SIZE), FS_BUFFER_INPLACE) != SUCCESS);
+
+        /* If this is an unfragmented TCP packet. */
+        if ((IPV4_HDR_PROTO(header) == IP_PROTO_TCP) && (IPV4_HDR_LENGTH(header) == length) &&
+            ((IPV4_HDR_FLAG_FRAG(header) & (IPV4_HDR_FLAG_MF | IPV4_HDR_FRAG_MASK)) == 0))
+        {
+            /* Pick the TCP/IP header length. */
+            hlen = ppp_vj_header_length(header, MIN(length, PPP_VJ_HEADER_SIZE));
+        }
+    }
+
+    /* Only ACK segments without SYN, FIN or RST can be compressed. */
+    if (hlen > 0)
+    {
+        ihl = (uint32_t)((IPV4_HDR_VER_IHL(header) & IPV4_HDR_IHL_MASK) << 2);
+        tcp = &header[ihl];
+
+        if ((TCP_HRD_FLAGS(tcp) & (TCP_HDR_FLAG_SYN | TCP_HDR_FLAG_FIN | TCP_HDR_FLAG_RST | TCP_HDR_FLAG_ACK)) != TCP_HDR_FLAG_ACK)
+        {
+            /* Send this packet as it is. */
+            hlen = 0;
+        }
+    }
+
+    /* If this packet can be sent on a slot. */
+    if (hlen > 0)
+    {
+        /* Pick a slot for this connection. */
+        slot = ppp_vj_tx_slot(vj, header, &id, &found);
+        old_tcp = &slot->header[ihl];
+
+        /* If nothing is changed that we cannot encode, version, header lengths,
+         * TOS, fragment fields, TTL, protocol, options and flags other than
+         * PSH and URG should be same as the last packet. RFC-1144 has no
+         * encoding for changed TCP options, so with TCP timestamps most
+         * segments carry a new TSval or TSecr and are sent uncompressed. The
+         * timestamp delta is not compressed here as the peer would not be
+         * able to decode it, so TCP_TIME_STAMP should be disabled on links
+         * relying on VJ compression. */
+        if ((found == TRUE) && (slot->hlen == hlen) &&
+            (memcmp(&header[IPV4_HDR_VER_IHL_OFFSET], &slot->header[IPV4_HDR_VER_IHL_OFFSET], 2) == 0) &&
+            (memcmp(&header[IPV4_HDR_FLAG_FRAG_OFFSET], &slot->header[IPV4_HDR_FLAG_FRAG_OFFSET], 4) == 0) &&
+            (memcmp(&header[IPV4_HDR_OPT_OFFSET], &slot->header[IPV4_HDR_OPT_OFFSET], (ihl - IPV4_HDR_SIZE)) == 0) &&
+            (memcmp(&tcp[TCP_HRD_SIZE], &old_tcp[TCP_HRD_SIZE], (hlen - ihl - TCP_HRD_SIZE)) == 0) &&
+            (((TCP_HRD_FLAGS(tcp) ^ TCP_HRD_FLAGS(old_tcp)) & (uint16_t)~(TCP_HDR_FLAG_PSH | TCP_HDR_FLAG_URG)) == 0))
+        {
+            /* We can try to compress this header. */
+            compress = TRUE;
+
+            /* If urgent flag is set. */
+            if (TCP_HRD_FLAGS(tcp) & TCP_HDR_FLAG_URG)
+            {
+                /* Send the urgent pointer. */
+                num_bytes += ppp_vj_encode(&deltas[num_bytes], TCP_HRD_URG(tcp));
+                changes |= PPP_VJ_NEW_U;
+            }
+
+            /* If urgent pointer has changed without urgent flag. */
+            else if (TCP_HRD_URG(tcp) != TCP_HRD_URG(old_tcp))
+            {
+                /* This cannot be encoded. */
+                compress = FALSE;
+            }
+
+            /* If window has changed. */
+            delta = (uint16_t)(TCP_HRD_WND_SIZE(tcp) - TCP_HRD_WND_SIZE(old_tcp));
+            if (delta != 0)
+            {
+                num_bytes += ppp_vj_encode(&deltas[num_bytes], delta);
+                changes |= PPP_VJ_NEW_W;
+            }
+
+            /* If ACK number has changed. */
+            delta_a = TCP_HRD_ACK_NUM(tcp) - TCP_HRD_ACK_NUM(old_tcp);
+            if (delta_a != 0)
+            {
+                /* Only a 16-bit delta can be encoded. */
+                if (delta_a > 0xFFFF)
+                {
+                    compress = FALSE;
+                }
+
+                num_bytes += ppp_vj_encode(&deltas[num_bytes], (delta_a & 0xFFFF));
+                changes |= PPP_VJ_NEW_A;
+            }
+
+            /* If sequence number has changed. */
+            delta_s = TCP_HRD_SEQ_NUM(tcp) - TCP_HRD_SEQ_NUM(old_tcp);
+            if (delta_s != 0)
+            {
+                /* Only a 16-bit delta can be encoded. */
+                if (delta_s > 0xFFFF)
+                {
+                    compress = FALSE;
+                }
+
+                num_bytes += ppp_vj_encode(&deltas[num_bytes], (delta_s & 0xFFFF));
+                changes |= PPP_VJ_NEW_S;
+            }
+
+            /* Check for the special cases. */
+            switch (changes)
+            {
+            case 0:
+
+                /* If this packet has data and the last one did not this is
+                 * data following an ACK, otherwise this is a retransmission
+                 * or a window probe so send it uncompressed in case peer has
+                 * lost the last one. */
+                if ((IPV4_HDR_LENGTH(header) == IPV4_HDR_LENGTH(slot->header)) || (IPV4_HDR_LENGTH(slot->header) != hlen))
+                {
+                    compress = FALSE;
+                }
+
+                break;
+
+            case PPP_VJ_SPECIAL_I:
+            case PPP_VJ_SPECIAL_D:
+
+                /* Actual changes match a special case, send it uncompressed. */
+                compress = FALSE;
+
+                break;
+
+            case (PPP_VJ_NEW_S | PPP_VJ_NEW_A):
+
+                /* If this is echoed interactive traffic. */
+                if ((delta_s == delta_a) && (delta_s == (uint32_t)(IPV4_HDR_LENGTH(slot->header) - hlen)))
+                {
+                    changes = PPP_VJ_SPECIAL_I;
+                    num_bytes = 0;
+                }
+
+                break;
+
+            case PPP_VJ_NEW_S:
+
+                /* If this is unidirectional data transfer. */
+                if (delta_s == (uint32_t)(IPV4_HDR_LENGTH(slot->header) - hlen))
+                {
+                    changes = PPP_VJ_SPECIAL_D;
+                    num_bytes = 0;
+                }
+
+                break;
+
+            default:
+                break;
+            }
+
+            /* If IP ID did not increment by one. */
+            delta = (uint16_t)(IPV4_HDR_ID(header) - IPV4_HDR_ID(slot->header));
+            if (delta != 1)
+            {
+                num_bytes += ppp_vj_encode(&deltas[num_bytes], delta);
+                changes |= PPP_VJ_NEW_I;
+            }
+
+            /* If push flag is set. */
+            if (TCP_HRD_FLAGS(tcp) & TCP_HDR_FLAG_PSH)
+            {
+                changes |= PPP_VJ_PUSH;
+            }
+        }
+
+        /* Save this header in the slot. */
+        memcpy(slot->header, header, hlen);
+        slot->hlen = (uint8_t)hlen;
+
+        /* If we can compress this header. */
+        if (compress == TRUE)
+        {
+            /* If we cannot omit the slot ID. */
+            if (((vj->flags & PPP_VJ_TX_CID) == 0) || (vj->tx_last != id))
+            {
+                comp[comp_length++] = (changes | PPP_VJ_NEW_C);
+                comp[comp_length++] = id;
+            }
+            else
+            {
+                comp[comp_length++] = changes;
+            }
+
+            /* Add TCP checksum as it is and then the deltas. */
+            comp[comp_length++] = tcp[TCP_HRD_CSUM_OFFSET];
+            comp[comp_length++] = tcp[TCP_HRD_CSUM_OFFSET + 1];
+            memcpy(&comp[comp_length], deltas, num_bytes);
+            comp_length += num_bytes;
+
+            /* Replace the TCP/IP header with the compressed header. */
+            ASSERT(fs_buffer_list_pull(buffer, NULL, hlen, 0) != SUCCESS);
+            status = fs_buffer_list_push(buffer, comp, comp_length, (FS_BUFFER_HEAD | flags));
+
+            /* Send a compressed TCP/IP packet. */
+            *proto = PPP_PROTO_VJ_COMP;
+        }
+        else
+        {
+            /* Send the slot ID in place of the IPv4 protocol. */
+            status = fs_buffer_list_push_offset(buffer, &id, 1, IPV4_HDR_PROTO_OFFSET, (FS_BUFFER_HEAD | FS_BUFFER_UPDATE));
+
+            /* Send an uncompressed TCP/IP packet. */
+            *proto = PPP_PROTO_VJ_UNCOMP;
+        }
+
+        /* Save the slot ID we have sent. */
+        vj->tx_last = id;
+    }
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* ppp_vj_compress */
+
+/*
+ * ppp_vj_uncompress
+ * @vj: VJ state.
+ * @buffer: Received packet, IPv4 packet will be returned in it.
+ * @proto: PPP protocol of the received packet, PPP_PROTO_VJ_COMP or
+ *  PPP_PROTO_VJ_UNCOMP.
+ * @flags: Operation flags.
+ *  FS_BUFFER_TH: We need to maintain threshold while allocating a buffer.
+ * @return: A success status will be returned if an IPv4 packet was
+ *  successfully recovered, PPP_INVALID_HEADER will be returned if packet
+ *  cannot be uncompressed and is needed to be dropped.
+ * This function will recover the TCP/IP header of a received packet as
+ * specified by RFC-1144.
+ */
+int32_t ppp_vj_uncompress(PPP_VJ_STATE *vj, FS_BUFFER_LIST *buffer, uint16_t proto, uint8_t flags)
+{
+    PPP_VJ_SLOT *slot = NULL;
+    int32_t status = SUCCESS;
+    uint32_t hlen = 0, ihl = 0, length, num_bytes, delta;
+    uint16_t csum;
+    uint8_t header[PPP_VJ_HEADER_SIZE], comp[PPP_VJ_COMP_SIZE + 2];
+    uint8_t *tcp, changes, id;
+
+    length = buffer->total_length;
+
+    /* If this is an uncompressed TCP/IP packet. */
+    if (proto == PPP_PROTO_VJ_UNCOMP)
+    {
+        /* If we have the TCP/IP header. */
+        if (length >= (IPV4_HDR_SIZE + TCP_HRD_SIZE))
+        {
+            /* Copy the TCP/IP header. */
+            ASSERT(fs_buffer_list_pull(buffer, header, MIN(length, PPP_VJ_HEADER_SIZE), FS_BUFFER_INPLACE) != SUCCESS);
+            hlen = ppp_vj_header_length(header, MIN(length, PPP_VJ_HEADER_SIZE));
+        }
+
+        /* If we have a valid header and slot ID sent in the IPv4 protocol. */
+        if ((hlen > 0) && (IPV4_HDR_PROTO(header) < PPP_VJ_SLOTS))
+        {
+            id = IPV4_HDR_PROTO(header);
+
+            /* Restore the IPv4 protocol. */
+            header[IPV4_HDR_PROTO_OFFSET] = IP_PROTO_TCP;
+            status = fs_buffer_list_push_offset(buffer, &header[IPV4_HDR_PROTO_OFFSET], 1, IPV4_HDR_PROTO_OFFSET, (FS_BUFFER_HEAD | FS_BUFFER_UPDATE));
+
+            /* Save this header in the slot. */
+            slot = &vj->rx_slot[id];
+            memcpy(slot->header, header, hlen);
+            slot->hlen = (uint8_t)hlen;
+
+            /* We can now receive compressed frames for this slot. */
+            vj->rx_last = id;
+            vj->flags &= (uint8_t)~(PPP_VJ_RX_TOSS);
+        }
+        else
+        {
+            /* Drop this packet. */
+            status = PPP_INVALID_HEADER;
+        }
+    }
+
+    /* This is a compressed TCP/IP packet. */
+    else
+    {
+        /* Copy the compressed header, unused bytes are left zero, we have two
+         * extra bytes in case a delta is truncated at the end. */
+        memset(comp, 0, sizeof(comp));
+        ASSERT(fs_buffer_list_pull(buffer, comp, MIN(length, PPP_VJ_COMP_SIZE), FS_BUFFER_INPLACE) != SUCCESS);
+        changes = comp[0];
+        num_bytes = 1;
+
+        /* If slot ID is given. */
+        if (changes & PPP_VJ_NEW_C)
+        {
+            /* If this is a valid slot. */
+            if (comp[num_bytes] < PPP_VJ_SLOTS)
+            {
+                /* Use this slot from now on. */
+                vj->rx_last = comp[num_bytes];
+                vj->flags &= (uint8_t)~(PPP_VJ_RX_TOSS);
+            }
+            else
+            {
+                /* Drop this packet. */
+                status = PPP_INVALID_HEADER;
+            }
+
+            num_bytes++;
+        }
+
+        /* If we have lost sync with the compressor. */
+        if (vj->flags & PPP_VJ_RX_TOSS)
+        {
+            /* Drop this packet. */
+            status = PPP_INVALID_HEADER;
+        }
+
+        if (status == SUCCESS)
+        {
+            /* Pick the slot for this packet. */
+            slot = &vj->rx_slot[vj->rx_last];
+            hlen = slot->hlen;
+
+            /* If this slot is not yet used. */
+            if (hlen == 0)
+            {
+                /* Drop this packet. */
+                status = PPP_INVALID_HEADER;
+            }
+        }
+
+        if (status == SUCCESS)
+        {
+            /* Work on a copy of the last header so the slot is only updated
+             * if this packet is valid. */
+            memcpy(header, slot->header, hlen);
+            ihl = (uint32_t)((IPV4_HDR_VER_IHL(header) & IPV4_HDR_IHL_MASK) << 2);
+            tcp = &header[ihl];
+
+            /* Update the TCP checksum. */
+            tcp[TCP_HRD_CSUM_OFFSET] = comp[num_bytes++];
+            tcp[TCP_HRD_CSUM_OFFSET + 1] = comp[num_bytes++];
+
+            /* Update the push flag. */
+            if (changes & PPP_VJ_PUSH)
+            {
+                tcp[TCP_HRD_FLAGS_OFFSET + 1] |= TCP_HDR_FLAG_PSH;
+            }
+            else
+            {
+                tcp[TCP_HRD_FLAGS_OFFSET + 1] &= (uint8_t)~(TCP_HDR_FLAG_PSH);
+            }
+
+            /* Process the changes. */
+            switch (changes & PPP_VJ_SPECIAL_MASK)
+            {
+            case PPP_VJ_SPECIAL_I:
+
+                /* Both sequence and ACK number are incremented by the
+                 * amount of data in the last packet. */
+                delta = (uint32_t)(IPV4_HDR_LENGTH(header) - hlen);
+                NET_PUT_BE32(&tcp[TCP_HRD_ACK_NUM_OFFSET], (TCP_HRD_ACK_NUM(tcp) + delta));
+                NET_PUT_BE32(&tcp[TCP_HRD_SEQ_NUM_OFFSET], (TCP_HRD_SEQ_NUM(tcp) + delta));
+
+                break;
+
+            case PPP_VJ_SPECIAL_D:
+
+                /* Sequence number is incremented by the amount of data in the
+                 * last packet. */
+                delta = (uint32_t)(IPV4_HDR_LENGTH(header) - hlen);
+                NET_PUT_BE32(&tcp[TCP_HRD_SEQ_NUM_OFFSET], (TCP_HRD_SEQ_NUM(tcp) + delta));
+
+                break;
+
+            default:
+
+                /* If urgent pointer is given. */
+                if (changes & PPP_VJ_NEW_U)
+                {
+                    tcp[TCP_HRD_FLAGS_OFFSET + 1] |= TCP_HDR_FLAG_URG;
+                    num_bytes += ppp_vj_decode(&comp[num_bytes], &delta);
+                    NET_PUT_BE16(&tcp[TCP_HRD_URG_OFFSET], delta);
+                }
+                else
+                {
+                    tcp[TCP_HRD_FLAGS_OFFSET + 1] &= (uint8_t)~(TCP_HDR_FLAG_URG);
+                }
+
+                /* If window has changed. */
+                if (changes & PPP_VJ_NEW_W)
+                {
+                    num_bytes += ppp_vj_decode(&comp[num_bytes], &delta);
+                    NET_PUT_BE16(&tcp[TCP_HRD_WND_SIZE_OFFSET], (TCP_HRD_WND_SIZE(tcp) + delta));
+                }
+
+                /* If ACK number has changed. */
+                if (changes & PPP_VJ_NEW_A)
+                {
+                    num_bytes += ppp_vj_decode(&comp[num_bytes], &delta);
+                    NET_PUT_BE32(&tcp[TCP_HRD_ACK_NUM_OFFSET], (TCP_HRD_ACK_NUM(tcp) + delta));
+                }
+
+                /* If sequence number has changed. */
+                if (changes & PPP_VJ_NEW_S)
+                {
+                    num_bytes += ppp_vj_decode(&comp[num_bytes], &delta);
+                    NET_PUT_BE32(&tcp[TCP_HRD_SEQ_NUM_OFFSET], (TCP_HRD_SEQ_NUM(tcp) + delta));
+                }
+
+                break;
+            }
+
+            /* Update the IP ID. */
+            delta = 1;
+            if (changes & PPP_VJ_NEW_I)
+            {
+                num_bytes += ppp_vj_decode(&comp[num_bytes], &delta);
+            }
+            NET_PUT_BE16(&header[IPV4_HDR_ID_OFFSET], (IPV4_HDR_ID(header) + delta));
+
+            /* If the compressed header was not complete. */
+            if (num_bytes > length)
+            {
+                /* Drop this packet. */
+                status = PPP_INVALID_HEADER;
+            }
+        }
+
+        if (status == SUCCESS)
+        {
+            /* Update the IPv4 length and checksum. */
+            NET_PUT_BE16(&header[IPV4_HDR_LENGTH_OFFSET], ((length - num_bytes) + hlen));
+            header[IPV4_HDR_CSUM_OFFSET] = 0;
+            header[IPV4_HDR_CSUM_OFFSET + 1] = 0;
+            csum = (uint16_t)~net_csum_partial(header, ihl, 0);
+            memcpy(&header[IPV4_HDR_CSUM_OFFSET], &csum, 2);
+
+            /* Save this header in the slot. */
+            memcpy(slot->header, header, hlen);
+
+            /* Replace the compressed header with the TCP/IP header. */
+            ASSERT(fs_buffer_list_pull(buffer, NULL, num_bytes, 0) != SUCCESS);
+            status = fs_buffer_list_push(buffer, header, hlen, (FS_BUFFER_HEAD | flags));
+        }
+    }
+
+    /* If this packet cannot be processed. */
+    if (status == PPP_INVALID_HEADER)
+    {
+        /* Drop compressed frames until we receive a slot ID. */
+        PPP_VJ_TOSS(vj);
+    }
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* ppp_vj_uncompress */
+
+#endif /* PPP_VJ */
+#endif /* IO_PPP */
@@ -0,0 +1,99 @@
+/*
+ * ppp_vj.h
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#ifndef _PPP_VJ_H_
+#define _PPP_VJ_H_
+
+#include <kernel.h>
+
+#ifdef IO_PPP
+#include <ppp_ipcp_config.h>
+
+#ifdef PPP_VJ
+#include <fs.h>
+
+#if ((PPP_VJ_SLOTS < 1) || (PPP_VJ_SLOTS > 256))
+#error "PPP VJ slots must be between 1 and 256."
+#endif
+
+#if ((PPP_VJ_HEADER_SIZE < 40) || (PPP_VJ_HEADER_SIZE > 128))
+#error "PPP VJ header size must be between 40 and 128."
+#endif
+
+/* RFC-1144 change mask definitions. */
+#define PPP_VJ_NEW_U            (0x01)
+#define PPP_VJ_NEW_W            (0x02)
+#define PPP_VJ_NEW_A            (0x04)
+#define PPP_VJ_NEW_S            (0x08)
+#define PPP_VJ_PUSH             (0x10)
+#define PPP_VJ_NEW_I            (0x20)
+#define PPP_VJ_NEW_C            (0x40)
+
+/* Special change masks for echoed interactive traffic and unidirectional
+ * data transfer, these can never occur as a normal change mask. */
+#define PPP_VJ_SPECIAL_I        (PPP_VJ_NEW_S | PPP_VJ_NEW_W | PPP_VJ_NEW_U)
+#define PPP_VJ_SPECIAL_D        (PPP_VJ_NEW_S | PPP_VJ_NEW_A | PPP_VJ_NEW_W | PPP_VJ_NEW_U)
+#define PPP_VJ_SPECIAL_MASK     (0x0F)
+
+/* Largest compressed header, change mask, slot ID, TCP checksum and 5
+ * deltas of 3 bytes each. */
+#define PPP_VJ_COMP_SIZE        (19)
+
+/* VJ state flags. */
+#define PPP_VJ_TX_CID           (0x1)
+#define PPP_VJ_RX_TOSS          (0x2)
+
+/* Marks the state so that compressed frames are dropped until a frame with an
+ * explicit slot ID is received, must be called if a frame was lost. */
+#define PPP_VJ_TOSS(vj)         ((vj)->flags |= PPP_VJ_RX_TOSS)
+
+/* VJ slot definition. */
+typedef struct _ppp_vj_slot
+{
+    /* Last TCP/IP header sent or received on this slot. */
+    uint8_t     header[PPP_VJ_HEADER_SIZE];
+
+    /* Length of the saved header, zero if this slot is not used. */
+    uint8_t     hlen;
+} PPP_VJ_SLOT;
+
+/* VJ compression state for a PPP link. */
+typedef struct _ppp_vj
+{
+    /* Compressor and decompressor slots. */
+    PPP_VJ_SLOT tx_slot[PPP_VJ_SLOTS];
+    PPP_VJ_SLOT rx_slot[PPP_VJ_SLOTS];
+
+    /* Compressor slot IDs in the order they were used, most recent first. */
+    uint8_t     tx_order[PPP_VJ_SLOTS];
+
+    /* Number of slots the peer can decompress. */
+    uint8_t     tx_num_slots;
+
+    /* Slot IDs used in the last frames sent and received. */
+    uint8_t     tx_last;
+    uint8_t     rx_last;
+
+    /* VJ state flags. */
+    uint8_t     flags;
+} PPP_VJ_STATE;
+
+/* Function prototypes. */
+void ppp_vj_init(PPP_VJ_STATE *);
+void ppp_vj_tx_configure(PPP_VJ_STATE *, uint32_t, uint8_t);
+int32_t ppp_vj_compress(PPP_VJ_STATE *, FS_BUFFER_LIST *, uint16_t *, uint8_t);
+int32_t ppp_vj_uncompress(PPP_VJ_STATE *, FS_BUFFER_LIST *, uint16_t, uint8_t);
+
+#endif /* PPP_VJ */
+#endif /* IO_PPP */
+
+#endif /* _PPP_VJ_H_ */
@@ -16,6 +16,7 @@
 #include <stdlib.h>
 #ifdef IO_SERIAL
 #include <serial.h>
+#include <rtl.h>
 #endif /* IO_SERIAL */
 
 /*
@@ -55,7 +56,7 @@ void system_assert(int32_t code, char *file, uint32_t line, TASK *task)
     serial_assert_puts((uint8_t *)":", 0);
 
     /* Print line number. */
-    itoa((int)line, (char *)line_buf, 10);
+    rtl_ultoa_b10(line, line_buf);
     serial_assert_puts(line_buf, 0);
 
     /* Put line terminator. */
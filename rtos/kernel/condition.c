@@ -23,6 +23,10 @@ static uint8_t suspend_sreach(void *, void *);
 static void suspend_lock_condition(CONDITION **, SUSPEND **, uint8_t);
 static void suspend_unlock_condition(CONDITION **, SUSPEND **, uint8_t);
 static void suspend_condition_add_task(CONDITION **, SUSPEND **, uint8_t, TASK *);
+#ifdef SEMAPHORE_PRIORITY_INHERIT
+static uint8_t suspend_priority_sort(void *, void *);
+static uint8_t suspend_task_search(void *, void *);
+#endif /* SEMAPHORE_PRIORITY_INHERIT */
 #ifdef CONFIG_SLEEP
 static void suspend_condition_remove_all(CONDITION **, SUSPEND **, uint8_t);
 #endif /* CONFIG_SLEEP */
@@ -56,6 +60,78 @@ static uint8_t suspend_sreach(void *node, void *param)
 
 } /* suspend_sreach */
 
+#ifdef SEMAPHORE_PRIORITY_INHERIT
+/*
+ * suspend_priority_sort
+ * @node: An existing suspend in the list.
+ * @suspend: New suspend that is needed to be added in the list.
+ * @return: TRUE if the new suspend is needed to be added before the existing
+ *  node, otherwise FALSE will be returned.
+ * This is sorting function used to keep the suspend list of a condition in
+ * the order of task priority, tasks with same priority are kept in the order
+ * they were added.
+ */
+static uint8_t suspend_priority_sort(void *node, void *suspend)
+{
+    uint8_t sort = FALSE;
+
+    /* If node has lower priority than the given suspend. */
+    if (((SUSPEND *)node)->task->priority > ((SUSPEND *)suspend)->task->priority)
+    {
+        /* Add the given suspend before this node. */
+        sort = TRUE;
+    }
+
+    /* Return if we need to add this suspend before the given node. */
+    return (sort);
+
+} /* suspend_priority_sort */
+
+/*
+ * suspend_task_search
+ * @node: A suspend on this condition.
+ * @param: Task for which suspend is needed.
+ * @return: TRUE if this suspend belongs to the given task, otherwise FALSE
+ *  will be returned.
+ * This is a search function to find the suspend of a task on a condition.
+ */
+static uint8_t suspend_task_search(void *node, void *param)
+{
+    /* Return if this suspend belongs to the given task. */
+    return (((SUSPEND *)node)->task == (TASK *)param);
+
+} /* suspend_task_search */
+
+/*
+ * suspend_priority_update
+ * @condition: Condition on which given task might be waiting.
+ * @tcb: Task for which priority was updated.
+ * This routine will move the suspend of a task waiting on a priority sorted
+ * condition to the position for it's new priority. Nothing is done if the
+ * task is no longer waiting on this condition. Scheduler must be locked by
+ * the caller.
+ */
+void suspend_priority_update(CONDITION *condition, TASK *tcb)
+{
+    SUSPEND *suspend;
+
+    /* If this condition is sorted on the task priority. */
+    if (condition->flags & CONDITION_PRIORITY)
+    {
+        /* Remove the suspend for this task. */
+        suspend = (SUSPEND *)sll_search_pop(&condition->suspend_list, &suspend_task_search, tcb, OFFSETOF(SUSPEND, next));
+
+        /* If this task is still waiting on this condition. */
+        if (suspend != NULL)
+        {
+            /* Add this suspend back for the new priority. */
+            sll_insert(&condition->suspend_list, suspend, &suspend_priority_sort, OFFSETOF(SUSPEND, next));
+        }
+    }
+
+} /* suspend_priority_update */
+#endif /* SEMAPHORE_PRIORITY_INHERIT */
+
 /*
  * suspend_unlock_condition
  * @condition: Condition list that we need to unlock.
@@ -128,8 +204,19 @@ static void suspend_condition_add_task(CONDITION **condition, SUSPEND **suspend,
         /* Add this task on the suspend data. */
         (*suspend)->task = tcb;
 
-        /* Add suspend to the suspend list. */
-        sll_append(&(*condition)->suspend_list, *suspend, OFFSETOF(SUSPEND, next));
+#ifdef SEMAPHORE_PRIORITY_INHERIT
+        /* If this condition is sorted on the task priority. */
+        if ((*condition)->flags & CONDITION_PRIORITY)
+        {
+            /* Add suspend to the suspend list for the task priority. */
+            sll_insert(&(*condition)->suspend_list, *suspend, &suspend_priority_sort, OFFSETOF(SUSPEND, next));
+        }
+        else
+#endif /* SEMAPHORE_PRIORITY_INHERIT */
+        {
+            /* Add suspend to the suspend list. */
+            sll_append(&(*condition)->suspend_list, *suspend, OFFSETOF(SUSPEND, next));
+        }
 
         /* Pick next condition. */
         condition++;
@@ -435,6 +522,9 @@ int32_t suspend_condition(CONDITION **condition, SUSPEND **suspend, uint8_t *num
         tcb->num_conditions = num_conditions;
         tcb->suspend_data = (void *)condition;
 
+        /* Trace this task being suspended. */
+        TRACE_LOG(TRACE_SUSPEND, *condition, num_conditions);
+
         /* Wait for either being resumed by some data or timeout. */
         CONTROL_TO_SYSTEM();
 
@@ -535,7 +625,7 @@ int32_t suspend_condition(CONDITION **condition, SUSPEND **suspend, uint8_t *num
     }
 
     /* If we need to return the condition from which we resumed. */
-    if (*num != NULL)
+    if (num != NULL)
     {
         /* Return the required condition. */
         *num = return_num;
@@ -621,6 +711,9 @@ void resume_condition(CONDITION *condition, RESUME *resume, uint8_t locked)
                     /* Save the condition for which this task is being resumed. */
                     suspend->task->suspend_data = condition;
 
+                    /* Trace this task being resumed. */
+                    TRACE_LOG(TRACE_RESUME, suspend->task, 0);
+
                     /* Try to reschedule this task. */
                     scheduler_task_yield(suspend->task, YIELD_SYSTEM);
 
@@ -664,9 +757,20 @@ void resume_condition(CONDITION *condition, RESUME *resume, uint8_t locked)
             /* If we do have a task. */
             if (suspend != NULL)
             {
-                /* Push this task back on the suspend list we will remove it when
-                 * we will resume. */
-                sll_push(&condition->suspend_list, suspend, OFFSETOF(SUSPEND, next));
+#ifdef SEMAPHORE_PRIORITY_INHERIT
+                /* If this condition is sorted on the task priority. */
+                if (condition->flags & CONDITION_PRIORITY)
+                {
+                    /* Put this task back for it's priority. */
+                    sll_insert(&condition->suspend_list, suspend, &suspend_priority_sort, OFFSETOF(SUSPEND, next));
+                }
+                else
+#endif /* SEMAPHORE_PRIORITY_INHERIT */
+                {
+                    /* Push this task back on the suspend list we will remove it when
+                     * we will resume. */
+                    sll_push(&condition->suspend_list, suspend, OFFSETOF(SUSPEND, next));
+                }
             }
 
         } while (suspend != NULL);
@@ -18,6 +18,7 @@
 
 /* Condition flags. */
 #define CONDITION_PING              0x1
+#define CONDITION_PRIORITY          0x2
 
 /* Suspend definitions. */
 #define SUSPEND_INVALID_PRIORITY    (255)
@@ -120,5 +121,8 @@ typedef struct _condition
 /* Function prototypes. */
 int32_t suspend_condition(CONDITION **, SUSPEND **, uint8_t *, uint8_t);
 void resume_condition(CONDITION *, RESUME *, uint8_t);
+#ifdef SEMAPHORE_PRIORITY_INHERIT
+void suspend_priority_update(CONDITION *, TASK *);
+#endif /* SEMAPHORE_PRIORITY_INHERIT */
 
 #endif /* _CONDITION_H_ */
@@ -0,0 +1,355 @@
+/*
+ * event.c
+ *
+ * Copyright (c) 2014 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+
+#ifdef CONFIG_EVENT
+#include <sleep.h>
+#include <string.h>
+#include <event.h>
+
+/* Internal function prototypes. */
+static uint8_t event_group_is_set(uint32_t, EVENT_PARAM *);
+static uint8_t event_group_do_suspend(void *, void *);
+static uint8_t event_group_do_resume(void *, void *);
+
+/*
+ * event_group_create
+ * @group: Event group control block to be initialized.
+ * This routine initializes an event group control block. All the events are
+ * initially cleared.
+ */
+void event_group_create(EVENT_GROUP *group)
+{
+    /* Clear event group memory. */
+    memset(group, 0, sizeof(EVENT_GROUP));
+
+    /* Initialize condition structure. */
+    group->condition.data = group;
+    group->condition.do_suspend = &event_group_do_suspend;
+
+} /* event_group_create */
+
+/*
+ * event_group_destroy
+ * @group: Event group control block to be destroyed.
+ * This routine destroy an event group. If any of the tasks are waiting on
+ * this event group they will be resumed with an error code.
+ */
+void event_group_destroy(EVENT_GROUP *group)
+{
+    RESUME resume;
+    INT_LVL interrupt_level = GET_INTERRUPT_LEVEL();
+
+    /* Disable global interrupts. */
+    DISABLE_INTERRUPTS();
+
+    /* Resume any tasks waiting on this event group. */
+    memset(&resume, 0, sizeof(RESUME));
+    resume.status = EVENT_DELETED;
+
+    /* Resume tasks waiting on this event group. */
+    resume_condition(&group->condition, &resume, TRUE);
+
+    /* Clear the event group memory. */
+    memset(group, 0, sizeof(EVENT_GROUP));
+
+    /* Restore old interrupt level. */
+    SET_INTERRUPT_LEVEL(interrupt_level);
+
+} /* event_group_destroy */
+
+/*
+ * event_group_set
+ * @group: Event group on which events are needed to be set.
+ * @events: Events needed to be set.
+ * This function will set the given events and resume all the tasks for which
+ * wait criteria is now satisfied. This can also be called from an ISR.
+ */
+void event_group_set(EVENT_GROUP *group, uint32_t events)
+{
+    RESUME resume;
+    INT_LVL interrupt_level = GET_INTERRUPT_LEVEL();
+
+    /* Disable global interrupts. */
+    DISABLE_INTERRUPTS();
+
+    /* Set the given events. */
+    group->events |= events;
+
+    /* Initialize resume parameters. */
+    resume.do_resume = &event_group_do_resume;
+    resume.param = group;
+    resume.status = SUCCESS;
+
+    /* Resume tasks for which the wait criteria is now satisfied. */
+    resume_condition(&group->condition, &resume, TRUE);
+
+    /* Restore old interrupt level. */
+    SET_INTERRUPT_LEVEL(interrupt_level);
+
+} /* event_group_set */
+
+/*
+ * event_group_clear
+ * @group: Event group on which events are needed to be cleared.
+ * @events: Events needed to be cleared.
+ * This function will clear the given events.
+ */
+void event_group_clear(EVENT_GROUP *group, uint32_t events)
+{
+    INT_LVL interrupt_level = GET_INTERRUPT_LEVEL();
+
+    /* Disable global interrupts. */
+    DISABLE_INTERRUPTS();
+
+    /* Clear the given events. */
+    group->events &= ~(events);
+
+    /* Restore old interrupt level. */
+    SET_INTERRUPT_LEVEL(interrupt_level);
+
+} /* event_group_clear */
+
+/*
+ * event_group_get
+ * @group: Event group for which events are needed.
+ * @return: Events that are currently set.
+ * This function will return the events that are currently set.
+ */
+uint32_t event_group_get(EVENT_GROUP *group)
+{
+    /* Return the current events. */
+    return (group->events);
+
+} /* event_group_get */
+
+/*
+ * event_group_condition_get
+ * @group: Event group for which condition is needed.
+ * @condition: Pointer where condition will be returned.
+ * @suspend: Suspend needed to be populated.
+ * @param: Event parameter needed to be populated, this must remain valid
+ *  while we are waiting on this condition.
+ * @timeout: Time to wait on this event group.
+ * This function will return condition for the event group, the parameter
+ * should be populated with the events and the wait flags for which we need to
+ * wait.
+ */
+void event_group_condition_get(EVENT_GROUP *group, CONDITION **condition, SUSPEND *suspend, EVENT_PARAM *param, uint32_t timeout)
+{
+    /* Initialize suspend criteria. */
+    suspend->param = (void *)param;
+    suspend->priority = SUSPEND_MIN_PRIORITY;
+    suspend->status = SUCCESS;
+
+#ifdef CONFIG_SLEEP
+    /* If we don't want to wait indefinitely. */
+    if (timeout != MAX_WAIT)
+    {
+        /* Calculate the tick at which we would want to be resumed. */
+        suspend->timeout = current_system_tick() + timeout;
+        suspend->timeout_enabled = TRUE;
+    }
+    else
+    {
+        /* Wait indefinitely. */
+        suspend->timeout_enabled = FALSE;
+    }
+#else
+    /* Remove compiler warning. */
+    UNUSED_PARAM(timeout);
+#endif /* CONFIG_SLEEP */
+
+    /* Return the condition for this event group. */
+    *condition = &group->condition;
+
+} /* event_group_condition_get */
+
+/*
+ * event_group_consume
+ * @group: Event group from which events are needed to be consumed.
+ * @param: Event parameter for which we were resumed.
+ * @return: Events that matched the given parameter.
+ * This function will return the events that matched the given parameter, if
+ * auto clear was requested the matched events will also be cleared. This
+ * should be called once resumed on the event group condition.
+ */
+uint32_t event_group_consume(EVENT_GROUP *group, EVENT_PARAM *param)
+{
+    uint32_t events;
+    INT_LVL interrupt_level = GET_INTERRUPT_LEVEL();
+
+    /* Disable global interrupts. */
+    DISABLE_INTERRUPTS();
+
+    /* Pick the events that matched. */
+    events = (group->events & param->mask);
+
+    /* If we need to clear the matched events. */
+    if (param->flags & EVENT_AUTO_CLEAR)
+    {
+        /* Clear the matched events. */
+        group->events &= ~(events);
+    }
+
+    /* Restore old interrupt level. */
+    SET_INTERRUPT_LEVEL(interrupt_level);
+
+    /* Return the matched events. */
+    return (events);
+
+} /* event_group_consume */
+
+/*
+ * event_group_wait
+ * @group: Event group on which we need to wait.
+ * @mask: Events for which we need to wait.
+ * @flags: Wait flags,
+ *  EVENT_WAIT_ALL if all the given events are needed to be set,
+ *  EVENT_AUTO_CLEAR if matched events are needed to be cleared.
+ * @events: If not null the events that matched will be returned here.
+ * @wait: The number of ticks to wait for the events, MAX_WAIT should be used
+ *  if user wants to wait for infinite time.
+ * @return: SUCCESS if the required events were set,
+ *  CONDITION_TIMEOUT will be returned if system has exhausted the given
+ *      timeout,
+ *  EVENT_DELETED will be returned if the given event group is now deleted.
+ * This function is called to wait for events on an event group. Only a single
+ * condition is used for all the events in the group.
+ */
+int32_t event_group_wait(EVENT_GROUP *group, uint32_t mask, uint8_t flags, uint32_t *events, uint32_t wait)
+{
+    int32_t status = SUCCESS;
+    SUSPEND suspend, *suspend_ptr = (&suspend);
+    CONDITION *condition;
+    EVENT_PARAM param;
+    INT_LVL interrupt_level = GET_INTERRUPT_LEVEL();
+
+    /* Initialize the wait parameter. */
+    param.mask = mask;
+    param.flags = flags;
+
+    /* Disable global interrupts, events can be set from an ISR. */
+    DISABLE_INTERRUPTS();
+
+    /* Initialize suspend condition for this event group, the timeout is
+     * calculated once so it is not extended if we need to wait again. */
+    event_group_condition_get(group, &condition, suspend_ptr, &param, wait);
+
+    /* While the required events are not set, all the waiters matching the
+     * events are resumed so an other waiter may have already cleared them. */
+    while ((status == SUCCESS) && (event_group_is_set(group->events, &param) == FALSE))
+    {
+        /* Check if we need to wait for the events. */
+        if ((wait > 0) && (get_current_task() != NULL))
+        {
+            /* Start waiting on this event group. */
+            status = suspend_condition(&condition, &suspend_ptr, NULL, TRUE);
+        }
+
+        /* We are not waiting for the events. */
+        else
+        {
+            /* Return timeout to the caller. */
+            status = CONDITION_TIMEOUT;
+        }
+    }
+
+    /* If the required events were set. */
+    if (status == SUCCESS)
+    {
+        /* Consume the matched events. */
+        mask = event_group_consume(group, &param);
+
+        /* If caller needs the matched events. */
+        if (events != NULL)
+        {
+            /* Return the matched events. */
+            *events = mask;
+        }
+    }
+
+    /* Restore old interrupt level. */
+    SET_INTERRUPT_LEVEL(interrupt_level);
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* event_group_wait */
+
+/*
+ * event_group_is_set
+ * @events: Events that are currently set.
+ * @param: Event parameter needed to be checked.
+ * @return: TRUE if the wait criteria is satisfied, otherwise FALSE will be
+ *  returned.
+ * This function will check if the given events satisfy the wait criteria.
+ */
+static uint8_t event_group_is_set(uint32_t events, EVENT_PARAM *param)
+{
+    uint8_t is_set = FALSE;
+
+    /* If we need all the events. */
+    if (param->flags & EVENT_WAIT_ALL)
+    {
+        /* Check if all the required events are set. */
+        if ((events & param->mask) == param->mask)
+        {
+            /* Criteria is satisfied. */
+            is_set = TRUE;
+        }
+    }
+
+    /* If any of the required events is set. */
+    else if (events & param->mask)
+    {
+        /* Criteria is satisfied. */
+        is_set = TRUE;
+    }
+
+    /* Return if the criteria is satisfied. */
+    return (is_set);
+
+} /* event_group_is_set */
+
+/*
+ * event_group_do_suspend
+ * @data: Condition data that will be used to access the event group.
+ * @suspend_data: Event parameter for which we are waiting.
+ * @return: TRUE if we need to suspend, FALSE if the required events are
+ *  already set.
+ * This function will called to see if we do need to suspend on an event group.
+ */
+static uint8_t event_group_do_suspend(void *data, void *suspend_data)
+{
+    /* Suspend only if the wait criteria is not satisfied. */
+    return ((event_group_is_set(((EVENT_GROUP *)data)->events, (EVENT_PARAM *)suspend_data) == TRUE) ? FALSE : TRUE);
+
+} /* event_group_do_suspend */
+
+/*
+ * event_group_do_resume
+ * @param_resume: Event group on which events were set.
+ * @param_suspend: Event parameter for which a task is waiting.
+ * @return: TRUE if we need to resume this task, FALSE if we cannot resume
+ *  this task.
+ * This is callback to see if we can resume a task waiting on an event group.
+ */
+static uint8_t event_group_do_resume(void *param_resume, void *param_suspend)
+{
+    /* Resume this task if the wait criteria is now satisfied. */
+    return (event_group_is_set(((EVENT_GROUP *)param_resume)->events, (EVENT_PARAM *)param_suspend));
+
+} /* event_group_do_resume */
+
+#endif /* CONFIG_EVENT */
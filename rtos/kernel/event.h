@@ -0,0 +1,67 @@
+/*
+ * event.h
+ *
+ * Copyright (c) 2014 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#ifndef _EVENT_H_
+#define _EVENT_H_
+
+#include <kernel.h>
+
+#ifdef CONFIG_EVENT
+#include <condition.h>
+
+/* Some status definitions. */
+#define EVENT_DELETED           -2500
+
+/* Event wait flags. */
+#define EVENT_WAIT_ANY          0x0     /* Resume if any of the given events is set. */
+#define EVENT_WAIT_ALL          0x1     /* Resume only if all the given events are set. */
+#define EVENT_AUTO_CLEAR        0x2     /* Clear the matched events when resumed. */
+
+/* Event group wait parameter. */
+typedef struct _event_param
+{
+    /* Events for which we are waiting. */
+    uint32_t    mask;
+
+    /* Wait flags. */
+    uint8_t     flags;
+
+    /* Structure padding. */
+    uint8_t     pad[3];
+
+} EVENT_PARAM;
+
+/* Event group data structure. */
+typedef struct _event_group
+{
+    /* Event group condition structure. */
+    CONDITION   condition;
+
+    /* Events that are currently set. */
+    uint32_t    events;
+
+} EVENT_GROUP;
+
+/* Function prototypes. */
+void event_group_create(EVENT_GROUP *);
+void event_group_destroy(EVENT_GROUP *);
+void event_group_set(EVENT_GROUP *, uint32_t);
+void event_group_clear(EVENT_GROUP *, uint32_t);
+uint32_t event_group_get(EVENT_GROUP *);
+int32_t event_group_wait(EVENT_GROUP *, uint32_t, uint8_t, uint32_t *, uint32_t);
+
+/* Event group condition APIs. */
+void event_group_condition_get(EVENT_GROUP *, CONDITION **, SUSPEND *, EVENT_PARAM *, uint32_t);
+uint32_t event_group_consume(EVENT_GROUP *, EVENT_PARAM *);
+
+#endif /* CONFIG_EVENT */
+#endif /* _EVENT_H_ */
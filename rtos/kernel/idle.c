@@ -267,6 +267,11 @@ static void idle_task_entry(void *argv)
             }
         }
 #endif /* (IDLE_WORK_MAX >  0) */
+
+#ifdef CONFIG_TICKLESS
+        /* Suppress the system tick until the next task is due. */
+        sleep_tickless_idle();
+#endif /* CONFIG_TICKLESS */
     }
 
 } /* idle_task_entry */
@@ -94,6 +94,11 @@ void kernel_run(void)
     system_tick_Init();
 #endif /* CONFIG_SLEEP */
 
+#ifdef CONFIG_TRACE
+    /* Start kernel tracing. */
+    trace_init();
+#endif /* CONFIG_TRACE */
+
     /* Load/restore task's context. */
     RESTORE_CONTEXT_FIRST();
 
@@ -1,8 +1,18 @@
 # Setup kernel configurations.
 setup_option_def(CONFIG_SLEEP ON DEFINE "Enable sleep functionality.")
 setup_option_def(CONFIG_SEMAPHORE ON DEFINE "Enable semaphore functionality.")
+setup_option_def(CONFIG_EVENT OFF DEFINE "Enable event group functionality.")
+setup_option_def(CONFIG_QUEUE OFF DEFINE "Enable single producer single consumer queue functionality.")
+if (${CONFIG_SEMAPHORE})
+setup_option_def(SEMAPHORE_PRIORITY_INHERIT OFF DEFINE "Enable priority inheritance for semaphores used as mutex.")
+endif ()
 
 # Setup kernel configuration options.
 if (${CONFIG_SLEEP})
 setup_option_def(SOFT_TICKS_PER_SEC 100 UINT32 "Configure the number of ticks per second." CONFIG_FILE "kernel_config")
+setup_option_def(CONFIG_TICKLESS OFF DEFINE "Suppress the system tick while idle task is running.")
+setup_option_def(SLEEP_WHEEL OFF DEFINE "Use a timing wheel to manage sleeping tasks.")
+if (${SLEEP_WHEEL})
+setup_option_def(SLEEP_WHEEL_SLOTS 16 INT "Number of slots in sleep timing wheel, must be a power of 2." CONFIG_FILE "kernel_config")
+endif ()
 endif ()
\ No newline at end of file
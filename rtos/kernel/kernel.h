@@ -42,7 +42,7 @@
 #define HW_TICK_TO_US(a)            ((uint64_t)(((uint64_t)(a) * 1000000) / (HW_TICKS_PER_SEC)))
 
 /* Some useful macros. */
-#define OFFSETOF(type, field)       ((int) &(((type *) 0)->field))
+#define OFFSETOF(type, field)       ((int) (uintptr_t) &(((type *) 0)->field))
 #define UNUSED_PARAM(x)             (void)(x)
 #define MASK_N_BITS(x)              ((uint32_t)((1 << x) - 1))
 #define READ_REG32(x)               (*(uint32_t *)x)
@@ -87,6 +87,7 @@ extern uint32_t current_tick;
 #endif /*  (defined(TASK_STATS) && defined(TASK_USAGE)) */
 
 #define ISR_ENTER()                 CPU_ISR_ENTER();                            \
+                                    TRACE_LOG(TRACE_ISR_ENTER, TRACE_ISR_NUMBER(), 0); \
                                     return_task = get_current_task();           \
                                     MARK_EXIT();                                \
                                     set_current_task(NULL)
@@ -94,6 +95,7 @@ extern uint32_t current_tick;
 #define ISR_EXIT()                  set_current_task(return_task);              \
                                     MARK_ENTRY();                               \
                                     return_task = NULL;                         \
+                                    TRACE_LOG(TRACE_ISR_EXIT, TRACE_ISR_NUMBER(), 0); \
                                     CPU_ISR_EXIT()
 
 #define ISR_RETURN()                CPU_ISR_RETURN()
@@ -113,4 +115,7 @@ void mark_task_entry(void);
 void mark_task_exit(void);
 #endif /*  (defined(TASK_STATS) && defined(TASK_USAGE)) */
 
+/* Include kernel tracing. */
+#include <trace.h>
+
 #endif /* _KERNEL_H_ */
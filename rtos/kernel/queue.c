@@ -0,0 +1,390 @@
+/*
+ * queue.c
+ *
+ * Copyright (c) 2014 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+
+#ifdef CONFIG_QUEUE
+#include <sleep.h>
+#include <string.h>
+#include <queue.h>
+
+/* Internal function prototypes. */
+static uint8_t queue_do_suspend(void *, void *);
+
+/*
+ * queue_create
+ * @queue: Queue control block to be initialized.
+ * @data: Item space for this queue, must be able to hold the given number of
+ *  items.
+ * @item_size: Size of an item.
+ * @num_items: Number of items in the queue, must be a power of 2.
+ * This routine initializes a single producer single consumer queue. Producer
+ * and consumer can be a task or an ISR and don't need to lock interrupts to
+ * access the queue.
+ */
+void queue_create(QUEUE *queue, uint8_t *data, uint32_t item_size, uint32_t num_items)
+{
+    /* Number of items must be a power of 2. */
+    ASSERT((num_items == 0) || ((num_items & (num_items - 1)) != 0));
+
+    /* Number of items must be at most half of the queue index range, so a
+     * full queue can be distinguished from an empty one. */
+    ASSERT(num_items > (uint32_t)(((QUEUE_INDEX)(~0) >> 1) + 1));
+
+    /* Clear queue memory. */
+    memset(queue, 0, sizeof(QUEUE));
+
+    /* Initialize the queue. */
+    queue->data = data;
+    queue->item_size = item_size;
+    queue->mask = (QUEUE_INDEX)(num_items - 1);
+
+    /* Initialize condition structure. */
+    queue->condition.data = queue;
+    queue->condition.do_suspend = &queue_do_suspend;
+
+} /* queue_create */
+
+/*
+ * queue_destroy
+ * @queue: Queue control block to be destroyed.
+ * This routine destroy a queue. If consumer is waiting on this queue it will
+ * be resumed with an error code.
+ */
+void queue_destroy(QUEUE *queue)
+{
+    RESUME resume;
+    INT_LVL interrupt_level = GET_INTERRUPT_LEVEL();
+
+    /* Disable global interrupts. */
+    DISABLE_INTERRUPTS();
+
+    /* Resume any tasks waiting on this queue. */
+    memset(&resume, 0, sizeof(RESUME));
+    resume.status = QUEUE_DELETED;
+
+    /* Resume tasks waiting on this queue. */
+    resume_condition(&queue->condition, &resume, TRUE);
+
+    /* Clear the queue memory. */
+    memset(queue, 0, sizeof(QUEUE));
+
+    /* Restore old interrupt level. */
+    SET_INTERRUPT_LEVEL(interrupt_level);
+
+} /* queue_destroy */
+
+/*
+ * queue_reserve
+ * @queue: Queue in which an item is needed to be reserved.
+ * @return: Pointer to the item space, NULL will be returned if queue is full.
+ * This function will return the space for the next item in the queue, producer
+ * can directly populate it and then call queue_commit to make it available to
+ * the consumer. This must only be called by the producer.
+ */
+void *queue_reserve(QUEUE *queue)
+{
+    void *item = NULL;
+    QUEUE_INDEX head = queue->head;
+
+    /* If we have space in the queue. */
+    if ((QUEUE_INDEX)(head - queue->tail) <= queue->mask)
+    {
+        /* Return the item at the head. */
+        item = &queue->data[(head & queue->mask) * queue->item_size];
+    }
+
+    /* Return the reserved item. */
+    return (item);
+
+} /* queue_reserve */
+
+/*
+ * queue_commit
+ * @queue: Queue in which reserved item is needed to be committed.
+ * This function will make the last reserved item available to the consumer
+ * and resume the consumer if it is waiting for it. This must only be called
+ * by the producer after a successful queue_reserve.
+ */
+void queue_commit(QUEUE *queue)
+{
+    INT_LVL interrupt_level;
+
+    /* Make sure item data is written before it is published. */
+    QUEUE_BARRIER();
+
+    /* Publish this item. */
+    queue->head = (QUEUE_INDEX)(queue->head + 1);
+
+    /* If consumer is waiting on this queue. */
+    if (queue->condition.suspend_list.head != NULL)
+    {
+        /* Disable global interrupts. */
+        interrupt_level = GET_INTERRUPT_LEVEL();
+        DISABLE_INTERRUPTS();
+
+        /* Resume the consumer. */
+        resume_condition(&queue->condition, NULL, TRUE);
+
+        /* Restore old interrupt level. */
+        SET_INTERRUPT_LEVEL(interrupt_level);
+    }
+
+} /* queue_commit */
+
+/*
+ * queue_peek
+ * @queue: Queue from which an item is needed.
+ * @return: Pointer to the oldest item in the queue, NULL will be returned if
+ *  queue is empty.
+ * This function will return the oldest item in the queue without removing it,
+ * consumer can directly process it and then call queue_release to free it.
+ * This must only be called by the consumer.
+ */
+void *queue_peek(QUEUE *queue)
+{
+    void *item = NULL;
+    QUEUE_INDEX tail = queue->tail;
+
+    /* If we have an item in the queue. */
+    if (queue->head != tail)
+    {
+        /* Make sure item data is read after the index. */
+        QUEUE_BARRIER();
+
+        /* Return the item at the tail. */
+        item = &queue->data[(tail & queue->mask) * queue->item_size];
+    }
+
+    /* Return the oldest item. */
+    return (item);
+
+} /* queue_peek */
+
+/*
+ * queue_release
+ * @queue: Queue from which oldest item is needed to be removed.
+ * This function will free the oldest item in the queue so it can be reused by
+ * the producer. This must only be called by the consumer after a successful
+ * queue_peek.
+ */
+void queue_release(QUEUE *queue)
+{
+    /* Make sure we are done with the item before it is freed. */
+    QUEUE_BARRIER();
+
+    /* Free this item. */
+    queue->tail = (QUEUE_INDEX)(queue->tail + 1);
+
+} /* queue_release */
+
+/*
+ * queue_write
+ * @queue: Queue in which an item is needed to be added.
+ * @item: Item needed to be copied in the queue.
+ * @return: SUCCESS if item was added, QUEUE_FULL will be returned if there is
+ *  no space in the queue.
+ * This function will copy an item in the queue. This must only be called by
+ * the producer.
+ */
+int32_t queue_write(QUEUE *queue, const void *item)
+{
+    int32_t status = SUCCESS;
+    void *slot = queue_reserve(queue);
+
+    /* If we have space in the queue. */
+    if (slot != NULL)
+    {
+        /* Copy the item and publish it. */
+        memcpy(slot, item, queue->item_size);
+        queue_commit(queue);
+    }
+    else
+    {
+        /* Queue is full. */
+        status = QUEUE_FULL;
+    }
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* queue_write */
+
+/*
+ * queue_read
+ * @queue: Queue from which an item is needed to be removed.
+ * @item: Buffer in which item will be copied.
+ * @wait: The number of ticks to wait for an item, MAX_WAIT should be used if
+ *  user wants to wait for infinite time.
+ * @return: SUCCESS if an item was read,
+ *  QUEUE_EMPTY will be returned if there is no item in the queue,
+ *  CONDITION_TIMEOUT will be returned if system has exhausted the given
+ *      timeout.
+ * This function will copy the oldest item from the queue. This must only be
+ * called by the consumer.
+ */
+int32_t queue_read(QUEUE *queue, void *item, uint32_t wait)
+{
+    int32_t status = SUCCESS;
+    void *slot = queue_peek(queue);
+
+    /* If we don't have an item and we can wait for it. */
+    if ((slot == NULL) && (wait > 0))
+    {
+        /* Wait for an item. */
+        status = queue_wait(queue, wait);
+
+        /* If we have an item now. */
+        if (status == SUCCESS)
+        {
+            /* Pick the oldest item. */
+            slot = queue_peek(queue);
+        }
+    }
+
+    /* If we have an item. */
+    if (slot != NULL)
+    {
+        /* Copy the item and free it. */
+        memcpy(item, slot, queue->item_size);
+        queue_release(queue);
+    }
+    else if (status == SUCCESS)
+    {
+        /* Queue is empty. */
+        status = QUEUE_EMPTY;
+    }
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* queue_read */
+
+/*
+ * queue_wait
+ * @queue: Queue on which we need to wait for an item.
+ * @wait: The number of ticks to wait for an item, MAX_WAIT should be used if
+ *  user wants to wait for infinite time.
+ * @return: SUCCESS if an item is now available,
+ *  CONDITION_TIMEOUT will be returned if system has exhausted the given
+ *      timeout,
+ *  QUEUE_DELETED will be returned if the queue was deleted.
+ * This function will suspend the consumer task till an item is available in
+ * the queue.
+ */
+int32_t queue_wait(QUEUE *queue, uint32_t wait)
+{
+    int32_t status = SUCCESS;
+    SUSPEND suspend, *suspend_ptr = (&suspend);
+    CONDITION *condition;
+    INT_LVL interrupt_level = GET_INTERRUPT_LEVEL();
+
+    /* Disable global interrupts, producer can be an ISR. */
+    DISABLE_INTERRUPTS();
+
+    /* If queue is empty. */
+    if (queue->head == queue->tail)
+    {
+        /* Check if we need to wait for an item. */
+        if ((wait > 0) && (get_current_task() != NULL))
+        {
+            /* Initialize suspend condition for this queue. */
+            queue_condition_get(queue, &condition, suspend_ptr, wait);
+
+            /* Start waiting on this queue. */
+            status = suspend_condition(&condition, &suspend_ptr, NULL, TRUE);
+        }
+
+        /* We are not waiting for an item. */
+        else
+        {
+            /* Return timeout to the caller. */
+            status = CONDITION_TIMEOUT;
+        }
+    }
+
+    /* Restore old interrupt level. */
+    SET_INTERRUPT_LEVEL(interrupt_level);
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* queue_wait */
+
+/*
+ * queue_condition_get
+ * @queue: Queue for which data condition is needed.
+ * @condition: Pointer where condition will be returned.
+ * @suspend: Suspend needed to be populated.
+ * @timeout: Time to wait on this queue.
+ * This function will return condition for availability of an item in this
+ * queue.
+ */
+void queue_condition_get(QUEUE *queue, CONDITION **condition, SUSPEND *suspend, uint32_t timeout)
+{
+    /* Initialize suspend criteria. */
+    suspend->param = (void *)queue;
+    suspend->priority = SUSPEND_MIN_PRIORITY;
+    suspend->status = SUCCESS;
+
+#ifdef CONFIG_SLEEP
+    /* If we don't want to wait indefinitely. */
+    if (timeout != MAX_WAIT)
+    {
+        /* Calculate the tick at which we would want to be resumed. */
+        suspend->timeout = current_system_tick() + timeout;
+        suspend->timeout_enabled = TRUE;
+    }
+    else
+    {
+        /* Wait indefinitely. */
+        suspend->timeout_enabled = FALSE;
+    }
+#else
+    /* Remove compiler warning. */
+    UNUSED_PARAM(timeout);
+#endif /* CONFIG_SLEEP */
+
+    /* Return the condition for this queue. */
+    *condition = &queue->condition;
+
+} /* queue_condition_get */
+
+/*
+ * queue_do_suspend
+ * @data: Condition data that will be used to access the queue.
+ * @suspend_data: Suspend data, for now it is unused.
+ * @return: TRUE if queue is empty and we need to suspend, otherwise FALSE
+ *  will be returned.
+ * This function will called to see if we do need to suspend on a queue.
+ */
+static uint8_t queue_do_suspend(void *data, void *suspend_data)
+{
+    QUEUE *queue = (QUEUE *)data;
+    uint8_t do_suspend = TRUE;
+
+    /* For now unused. */
+    UNUSED_PARAM(suspend_data);
+
+    /* Check if we have an item in the queue. */
+    if (queue->head != queue->tail)
+    {
+        /* Don't need to suspend. */
+        do_suspend = FALSE;
+    }
+
+    /* Return if we need to suspend or not. */
+    return (do_suspend);
+
+} /* queue_do_suspend */
+
+#endif /* CONFIG_QUEUE */
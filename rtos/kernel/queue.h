@@ -0,0 +1,82 @@
+/*
+ * queue.h
+ *
+ * Copyright (c) 2014 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#ifndef _QUEUE_H_
+#define _QUEUE_H_
+
+#include <kernel.h>
+
+#ifdef CONFIG_QUEUE
+#include <condition.h>
+
+/* Some status definitions. */
+#define QUEUE_FULL              -2600
+#define QUEUE_EMPTY             -2601
+#define QUEUE_DELETED           -2602
+
+/* Queue index type, this must be read and written atomically by the CPU. */
+#ifdef CPU_ATOMIC_TYPE
+typedef CPU_ATOMIC_TYPE QUEUE_INDEX;
+#else
+typedef uint32_t QUEUE_INDEX;
+#endif /* CPU_ATOMIC_TYPE */
+
+/* Memory barrier to order queue data and index updates. */
+#ifdef CPU_MEMORY_BARRIER
+#define QUEUE_BARRIER()         CPU_MEMORY_BARRIER()
+#else
+#define QUEUE_BARRIER()         asm volatile ("" ::: "memory")
+#endif /* CPU_MEMORY_BARRIER */
+
+/* Single producer single consumer queue. */
+typedef struct _queue
+{
+    /* Queue condition structure, consumer waits on this for data. */
+    CONDITION   condition;
+
+    /* Item space for this queue. */
+    uint8_t     *data;
+
+    /* Size of an item. */
+    uint32_t    item_size;
+
+    /* Index at which next item will be added, only updated by producer. */
+    volatile QUEUE_INDEX    head;
+
+    /* Index from which next item will be removed, only updated by
+     * consumer. */
+    volatile QUEUE_INDEX    tail;
+
+    /* Number of items in the queue minus one. */
+    QUEUE_INDEX mask;
+
+} QUEUE;
+
+/* Function prototypes. */
+void queue_create(QUEUE *, uint8_t *, uint32_t, uint32_t);
+void queue_destroy(QUEUE *);
+void *queue_reserve(QUEUE *);
+void queue_commit(QUEUE *);
+void *queue_peek(QUEUE *);
+void queue_release(QUEUE *);
+int32_t queue_write(QUEUE *, const void *);
+int32_t queue_read(QUEUE *, void *, uint32_t);
+int32_t queue_wait(QUEUE *, uint32_t);
+
+/* Queue condition APIs. */
+void queue_condition_get(QUEUE *, CONDITION **, SUSPEND *, uint32_t);
+
+/* Returns the number of items in the queue. */
+#define QUEUE_NUM_ITEMS(queue)  ((QUEUE_INDEX)((queue)->head - (queue)->tail))
+
+#endif /* CONFIG_QUEUE */
+#endif /* _QUEUE_H_ */
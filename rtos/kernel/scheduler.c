@@ -20,10 +20,33 @@
 #ifdef TASK_STATS
 TASK_LIST sch_task_list;
 #endif
+#ifdef SCHEDULER_BITMAP
+/* Per-priority ready lists, with a two level bitmap to find the highest
+ * priority ready list. A set bit at (31 - n) means that list n in the
+ * respective word has at least one task on it. */
+static TASK_LIST sch_ready_task_list[SCHEDULER_NUM_LEVELS];
+static uint32_t sch_ready_bitmap[SCHEDULER_BITMAP_WORDS];
+static uint32_t sch_ready_group;
+#else
 TASK_LIST sch_ready_task_list;
+#endif /* SCHEDULER_BITMAP */
 
 /* Internal function prototypes. */
+#ifdef SCHEDULER_BITMAP
+static void scheduler_ready_enqueue(TASK *);
+static TASK *scheduler_ready_dequeue(void);
+#ifdef SEMAPHORE_PRIORITY_INHERIT
+static void scheduler_ready_remove(TASK *);
+#endif /* SEMAPHORE_PRIORITY_INHERIT */
+#ifdef CPU_CLZ
+#define SCHEDULER_CLZ(x)            CPU_CLZ(x)
+#else
+static uint8_t scheduler_clz(uint32_t);
+#define SCHEDULER_CLZ(x)            scheduler_clz(x)
+#endif /* CPU_CLZ */
+#else
 static uint8_t scheduler_task_sort(void *, void *);
+#endif /* SCHEDULER_BITMAP */
 
 /*
  * scheduler_init
@@ -36,7 +59,13 @@ void scheduler_init(void)
 #ifdef TASK_STATS
     memset(&sch_task_list, 0, sizeof(TASK_LIST));
 #endif
+#ifdef SCHEDULER_BITMAP
+    memset(sch_ready_task_list, 0, sizeof(sch_ready_task_list));
+    memset(sch_ready_bitmap, 0, sizeof(sch_ready_bitmap));
+    sch_ready_group = 0;
+#else
     memset(&sch_ready_task_list, 0, sizeof(TASK_LIST));
+#endif /* SCHEDULER_BITMAP */
 
     /* Initialize idle task. */
     idle_task_init();
@@ -60,6 +89,10 @@ void scheduler_task_add(TASK *tcb, uint8_t priority)
 
     /* Update the task control block. */
     tcb->priority = priority;
+#ifdef SEMAPHORE_PRIORITY_INHERIT
+    tcb->base_priority = priority;
+    tcb->inherit_held = NULL;
+#endif /* SEMAPHORE_PRIORITY_INHERIT */
 
 #ifdef ASSERT_ENABLE
     /* If this is not the idle task. */
@@ -171,16 +204,28 @@ TASK *scheduler_get_next_task(void)
     TASK *tcb = NULL;
 
 #ifdef CONFIG_SLEEP
+#ifdef CONFIG_TICKLESS
+    /* If we were woken up from tickless idle, account for skipped ticks. */
+    sleep_tickless_resume();
+#endif /* CONFIG_TICKLESS */
+
     /* Resume any of the sleeping tasks. */
     sleep_process_system_tick();
 #endif /* CONFIG_SLEEP */
 
     /* Get the task we need to run */
+#ifdef SCHEDULER_BITMAP
+    tcb = scheduler_ready_dequeue();
+#else
     tcb = (TASK *)sll_pop(&sch_ready_task_list, OFFSETOF(TASK, next));
+#endif /* SCHEDULER_BITMAP */
 
     /* We should always have a task to execute. */
     ASSERT(tcb == NULL);
 
+    /* Trace this task switch. */
+    TRACE_LOG(TRACE_TASK_SWITCH, tcb, tcb->priority);
+
 #ifdef TASK_STATS
     /* Increment the number of times this task was scheduled. */
     tcb->scheduled ++;
@@ -201,6 +246,9 @@ TASK *scheduler_get_next_task(void)
  */
 void scheduler_task_yield(TASK *tcb, uint8_t from)
 {
+    /* Trace this task being made ready. */
+    TRACE_LOG(TRACE_TASK_READY, tcb, tcb->state);
+
     /* Adjust the task control block as required. */
     switch (from)
     {
@@ -225,10 +273,196 @@ void scheduler_task_yield(TASK *tcb, uint8_t from)
     }
 
     /* Schedule the task being yielded/re-enqueued. */
+#ifdef SCHEDULER_BITMAP
+    scheduler_ready_enqueue(tcb);
+#else
     sll_insert(&sch_ready_task_list, tcb, &scheduler_task_sort, OFFSETOF(TASK, next));
+#endif /* SCHEDULER_BITMAP */
 
 } /* scheduler_task_yield */
 
+#ifdef SEMAPHORE_PRIORITY_INHERIT
+/*
+ * scheduler_task_set_priority
+ * @tcb: Task for which priority is needed to be updated.
+ * @priority: New priority for this task.
+ * This function will update the effective priority of a task. If the task is
+ * on the ready list it will be moved to the position for it's new priority.
+ */
+void scheduler_task_set_priority(TASK *tcb, uint8_t priority)
+{
+    INT_LVL interrupt_level = GET_INTERRUPT_LEVEL();
+
+    /* Disable global interrupts as ready list can be accessed from
+     * interrupts. */
+    DISABLE_INTERRUPTS();
+
+    /* If this task is on the ready list. */
+    if ((tcb->state == TASK_RESUME) || (tcb->state == TASK_SLEEP_RESUME))
+    {
+        /* Remove this task from the ready list. */
+#ifdef SCHEDULER_BITMAP
+        scheduler_ready_remove(tcb);
+#else
+        ASSERT(sll_remove(&sch_ready_task_list, tcb, OFFSETOF(TASK, next)) != tcb);
+#endif /* SCHEDULER_BITMAP */
+
+        /* Update task priority. */
+        tcb->priority = priority;
+
+        /* Add this task back on the ready list with new priority. */
+#ifdef SCHEDULER_BITMAP
+        scheduler_ready_enqueue(tcb);
+#else
+        sll_insert(&sch_ready_task_list, tcb, &scheduler_task_sort, OFFSETOF(TASK, next));
+#endif /* SCHEDULER_BITMAP */
+    }
+    else
+    {
+        /* Just update the task priority, it will be used when this task is
+         * added on the ready list. */
+        tcb->priority = priority;
+    }
+
+    /* Restore old interrupt level. */
+    SET_INTERRUPT_LEVEL(interrupt_level);
+
+} /* scheduler_task_set_priority */
+#endif /* SEMAPHORE_PRIORITY_INHERIT */
+
+#ifdef SCHEDULER_BITMAP
+/*
+ * scheduler_ready_enqueue
+ * @tcb: Task needed to be added on the ready list.
+ * This function appends a task at the tail of the ready list for it's
+ * priority and marks that list as non-empty in the ready bitmap. Tasks with
+ * same priority are scheduled in the order they were made ready.
+ */
+static void scheduler_ready_enqueue(TASK *tcb)
+{
+    uint8_t word = (uint8_t)(tcb->priority >> 5);
+
+    /* Priority must be in the range of configured priority levels. */
+    ASSERT(tcb->priority >= SCHEDULER_NUM_LEVELS);
+
+    /* Append this task on the list for it's priority. */
+    sll_append(&sch_ready_task_list[tcb->priority], tcb, OFFSETOF(TASK, next));
+
+    /* Mark this priority level and it's group as ready. */
+    sch_ready_bitmap[word] |= ((uint32_t)0x80000000 >> (tcb->priority & 0x1F));
+    sch_ready_group |= ((uint32_t)0x80000000 >> word);
+
+} /* scheduler_ready_enqueue */
+
+/*
+ * scheduler_ready_dequeue
+ * @return: Highest priority ready task, NULL if no task is ready.
+ * This function removes and returns the oldest task from the highest priority
+ * non-empty ready list.
+ */
+static TASK *scheduler_ready_dequeue(void)
+{
+    TASK *tcb = NULL;
+    uint8_t word, priority;
+
+    /* If we do have a ready task. */
+    if (sch_ready_group != 0)
+    {
+        /* Pick the highest priority level that has a ready task. */
+        word = SCHEDULER_CLZ(sch_ready_group);
+        priority = (uint8_t)((word << 5) + SCHEDULER_CLZ(sch_ready_bitmap[word]));
+
+        /* Pop the oldest task at this priority. */
+        tcb = (TASK *)sll_pop(&sch_ready_task_list[priority], OFFSETOF(TASK, next));
+
+        /* If there are no more tasks at this priority. */
+        if (sch_ready_task_list[priority].head == NULL)
+        {
+            /* Clear this priority level. */
+            sch_ready_bitmap[word] &= ~((uint32_t)0x80000000 >> (priority & 0x1F));
+
+            /* If this group is now empty. */
+            if (sch_ready_bitmap[word] == 0)
+            {
+                /* Clear this group. */
+                sch_ready_group &= ~((uint32_t)0x80000000 >> word);
+            }
+        }
+    }
+
+    /* Return the task to run. */
+    return (tcb);
+
+} /* scheduler_ready_dequeue */
+
+#ifdef SEMAPHORE_PRIORITY_INHERIT
+/*
+ * scheduler_ready_remove
+ * @tcb: Task needed to be removed from the ready list.
+ * This function removes a task from the ready list for it's priority and
+ * updates the ready bitmap if that list is now empty.
+ */
+static void scheduler_ready_remove(TASK *tcb)
+{
+    uint8_t word = (uint8_t)(tcb->priority >> 5);
+
+    /* Remove this task from the list for it's priority. */
+    ASSERT(sll_remove(&sch_ready_task_list[tcb->priority], tcb, OFFSETOF(TASK, next)) != tcb);
+
+    /* If there are no more tasks at this priority. */
+    if (sch_ready_task_list[tcb->priority].head == NULL)
+    {
+        /* Clear this priority level. */
+        sch_ready_bitmap[word] &= ~((uint32_t)0x80000000 >> (tcb->priority & 0x1F));
+
+        /* If this group is now empty. */
+        if (sch_ready_bitmap[word] == 0)
+        {
+            /* Clear this group. */
+            sch_ready_group &= ~((uint32_t)0x80000000 >> word);
+        }
+    }
+
+} /* scheduler_ready_remove */
+#endif /* SEMAPHORE_PRIORITY_INHERIT */
+
+#ifndef CPU_CLZ
+/*
+ * scheduler_clz
+ * @value: Non-zero value for which leading zeros are needed to be counted.
+ * @return: Number of leading zero bits in the given value.
+ * This is a table based count leading zeros for the targets that don't
+ * provide a CLZ instruction.
+ */
+static uint8_t scheduler_clz(uint32_t value)
+{
+    static const uint8_t clz_table[16] = {4, 3, 2, 2, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0};
+    uint8_t num = 0;
+
+    /* Narrow down to the first non-zero nibble. */
+    if ((value & 0xFFFF0000) == 0)
+    {
+        num = (uint8_t)(num + 16);
+        value <<= 16;
+    }
+    if ((value & 0xFF000000) == 0)
+    {
+        num = (uint8_t)(num + 8);
+        value <<= 8;
+    }
+    if ((value & 0xF0000000) == 0)
+    {
+        num = (uint8_t)(num + 4);
+        value <<= 4;
+    }
+
+    /* Look up the leading zeros in the remaining nibble. */
+    return ((uint8_t)(num + clz_table[value >> 28]));
+
+} /* scheduler_clz */
+#endif /* CPU_CLZ */
+
+#else
 /*
  * scheduler_task_sort
  * @node: An existing node in the list.
@@ -254,3 +488,4 @@ static uint8_t scheduler_task_sort(void *node, void *task)
     return (schedule);
 
 } /* scheduler_task_sort */
+#endif /* SCHEDULER_BITMAP */
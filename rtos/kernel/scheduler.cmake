@@ -1,3 +1,4 @@
 # Setup scheduler configuration options.
 setup_option_def(SCHEDULER_MAX_LOCK 5 INT "Maximum number of scheduler locks a task can acquire." CONFIG_FILE "scheduler_config")
 setup_option_def(SCHEDULER_MAX_PRI 254 INT "Maximum priority level." CONFIG_FILE "scheduler_config")
+setup_option_def(SCHEDULER_BITMAP OFF DEFINE "Use per-priority ready lists with a priority bitmap for constant time scheduling." CONFIG_FILE "scheduler_config")
@@ -20,6 +20,12 @@
 #define YIELD_SYSTEM    (0x0)
 #define YIELD_SLEEP     (0x1)
 
+#ifdef SCHEDULER_BITMAP
+/* Number of priority levels including the idle task. */
+#define SCHEDULER_NUM_LEVELS        (SCHEDULER_MAX_PRI + 2)
+#define SCHEDULER_BITMAP_WORDS      (CEIL_DIV(SCHEDULER_NUM_LEVELS, 32))
+#endif /* SCHEDULER_BITMAP */
+
 /* Global task list. */
 #ifdef TASK_STATS
 extern TASK_LIST sch_task_list;
@@ -33,5 +39,8 @@ void scheduler_lock(void);
 void scheduler_unlock(void);
 TASK *scheduler_get_next_task(void);
 void scheduler_task_yield(TASK *, uint8_t);
+#ifdef SEMAPHORE_PRIORITY_INHERIT
+void scheduler_task_set_priority(TASK *, uint8_t);
+#endif /* SEMAPHORE_PRIORITY_INHERIT */
 
 #endif /* _SCHEDULER_H_ */
@@ -21,6 +21,11 @@
 /* Internal function prototypes. */
 static uint8_t semaphore_do_suspend(void *, void *);
 static uint8_t semaphore_do_resume(void *, void *);
+#ifdef SEMAPHORE_PRIORITY_INHERIT
+static void semaphore_inherit_priority(SEMAPHORE *, uint8_t);
+static void semaphore_update_priority(TASK *);
+static void semaphore_held_remove(SEMAPHORE *);
+#endif /* SEMAPHORE_PRIORITY_INHERIT */
 
 /*
  * semaphore_create
@@ -77,6 +82,170 @@ void semaphore_set_interrupt_data(SEMAPHORE *semaphore, void *data, SEM_INT_LOCK
 
 } /* semaphore_set_interrupt_data */
 
+#ifdef SEMAPHORE_PRIORITY_INHERIT
+/*
+ * semaphore_set_inherit
+ * @semaphore: Semaphore that is needed to be used as a priority inheriting
+ *  mutex.
+ * This routine will enable priority inheritance for a binary semaphore. When
+ * a task waits on this semaphore the owner and any task on which the owner is
+ * itself waiting will run at the priority of the waiting task till the
+ * semaphore is released. This operation cannot be reverted.
+ */
+void semaphore_set_inherit(SEMAPHORE *semaphore)
+{
+    /* Lock the scheduler. */
+    scheduler_lock();
+
+    /* Semaphore must not have been obtained. */
+    ASSERT(semaphore->count != semaphore->max_count);
+
+    /* Only a binary semaphore can have an owner to inherit priority. */
+    ASSERT(semaphore->max_count != 1);
+
+    /* An interrupt protected semaphore cannot be used as mutex. */
+    ASSERT(semaphore->interrupt_protected == TRUE);
+
+    /* Enable priority inheritance for this semaphore. */
+    semaphore->inherit = TRUE;
+
+    /* Waiting tasks will be resumed in the order of their priority. */
+    semaphore->condition.flags |= CONDITION_PRIORITY;
+
+    /* Enable scheduling. */
+    scheduler_unlock();
+
+} /* semaphore_set_inherit */
+
+/*
+ * semaphore_inherit_priority
+ * @semaphore: Semaphore on which a task is going to wait.
+ * @priority: Priority of the task going to wait on this semaphore.
+ * This function will raise the priority of the owner of given semaphore to
+ * the given priority. If the owner is itself waiting on a priority inheriting
+ * semaphore, the owner of that semaphore is also raised and so on.
+ */
+static void semaphore_inherit_priority(SEMAPHORE *semaphore, uint8_t priority)
+{
+    TASK *owner = semaphore->owner;
+
+    /* While we have an owner with lower priority than the given priority. */
+    while ((owner != NULL) && (owner->priority > priority))
+    {
+        /* Lend the given priority to this owner. */
+        scheduler_task_set_priority(owner, priority);
+
+        /* If this owner is itself waiting on an inheriting semaphore. */
+        if (owner->inherit_semaphore != NULL)
+        {
+            /* Move this owner for it's new priority on the semaphore it is
+             * waiting on. */
+            suspend_priority_update(&((SEMAPHORE *)owner->inherit_semaphore)->condition, owner);
+
+            /* Pick the owner of that semaphore. */
+            owner = ((SEMAPHORE *)owner->inherit_semaphore)->owner;
+        }
+        else
+        {
+            /* Nothing more to process. */
+            owner = NULL;
+        }
+    }
+
+} /* semaphore_inherit_priority */
+
+/*
+ * semaphore_update_priority
+ * @owner: Task for which effective priority is needed to be updated.
+ * This function will recompute the effective priority of a task, that is the
+ * highest of it's base priority and the priorities of the tasks waiting on
+ * the priority inheriting semaphores it still holds. If the priority is
+ * changed and the task is itself waiting on a priority inheriting semaphore,
+ * the owner of that semaphore is also updated and so on. This is called when
+ * a task stops waiting on, releases or obtains such a semaphore.
+ */
+static void semaphore_update_priority(TASK *owner)
+{
+    SEMAPHORE *semaphore;
+    SUSPEND *suspend;
+    uint8_t priority;
+
+    /* While we have an owner to update. */
+    while (owner != NULL)
+    {
+        /* Start from the base priority of this owner. */
+        priority = owner->base_priority;
+
+        /* Walk all the inheriting semaphores held by this owner. */
+        for (semaphore = (SEMAPHORE *)owner->inherit_held; semaphore != NULL; semaphore = semaphore->next_held)
+        {
+            /* Walk all the tasks waiting on this semaphore. */
+            for (suspend = semaphore->condition.suspend_list.head; suspend != NULL; suspend = suspend->next)
+            {
+                /* If this task has a higher priority. */
+                if (suspend->task->priority < priority)
+                {
+                    /* Inherit the priority of this task. */
+                    priority = suspend->task->priority;
+                }
+            }
+        }
+
+        /* If priority of this owner is not changed. */
+        if (owner->priority == priority)
+        {
+            /* The owners it is waiting on are not affected. */
+            break;
+        }
+
+        /* Update the priority of this owner. */
+        scheduler_task_set_priority(owner, priority);
+
+        /* If this owner is itself waiting on an inheriting semaphore. */
+        if (owner->inherit_semaphore != NULL)
+        {
+            /* Move this owner for it's new priority on the semaphore it is
+             * waiting on. */
+            suspend_priority_update(&((SEMAPHORE *)owner->inherit_semaphore)->condition, owner);
+
+            /* Pick the owner of that semaphore. */
+            owner = ((SEMAPHORE *)owner->inherit_semaphore)->owner;
+        }
+        else
+        {
+            /* Nothing more to process. */
+            owner = NULL;
+        }
+    }
+
+} /* semaphore_update_priority */
+
+/*
+ * semaphore_held_remove
+ * @semaphore: Priority inheriting semaphore being released.
+ * This function will remove a semaphore from the list of priority inheriting
+ * semaphores held by it's owner.
+ */
+static void semaphore_held_remove(SEMAPHORE *semaphore)
+{
+    SEMAPHORE **held = (SEMAPHORE **)&semaphore->owner->inherit_held;
+
+    /* Find this semaphore on the owner's list. */
+    while ((*held != NULL) && (*held != semaphore))
+    {
+        held = &(*held)->next_held;
+    }
+
+    /* Should never happen. */
+    ASSERT(*held == NULL);
+
+    /* Remove this semaphore from the list. */
+    *held = semaphore->next_held;
+    semaphore->next_held = NULL;
+
+} /* semaphore_held_remove */
+#endif /* SEMAPHORE_PRIORITY_INHERIT */
+
 /*
  * semaphore_destroy
  * @semaphore: Semaphore control block to be destroyed.
@@ -98,6 +267,17 @@ void semaphore_destroy(SEMAPHORE *semaphore)
     /* Resume tasks waiting on this semaphore. */
     resume_condition(&semaphore->condition, &resume, TRUE);
 
+#ifdef SEMAPHORE_PRIORITY_INHERIT
+    /* If this is a priority inheriting mutex and we have an owner. */
+    if ((semaphore->inherit == TRUE) && (semaphore->owner != NULL))
+    {
+        /* Owner is no longer holding this semaphore, drop any priority it
+         * inherited from the tasks waiting on it. */
+        semaphore_held_remove(semaphore);
+        semaphore_update_priority(semaphore->owner);
+    }
+#endif /* SEMAPHORE_PRIORITY_INHERIT */
+
     /* Clear the semaphore memory. */
     memset(semaphore, 0,  sizeof(SEMAPHORE));
 
@@ -248,8 +428,38 @@ int32_t semaphore_obtain(SEMAPHORE *semaphore, uint32_t wait)
             /* Initialize suspend condition for this semaphore. */
             semaphore_condition_get(semaphore, &condition, suspend_ptr, wait);
 
+#ifdef SEMAPHORE_PRIORITY_INHERIT
+            /* If this semaphore is a priority inheriting mutex. */
+            if (semaphore->inherit == TRUE)
+            {
+                /* Lend our priority to the owner of this semaphore. */
+                semaphore_inherit_priority(semaphore, tcb->priority);
+
+                /* Save the semaphore on which we are waiting, so the owner
+                 * of this semaphore can be raised if required. */
+                tcb->inherit_semaphore = semaphore;
+            }
+#endif /* SEMAPHORE_PRIORITY_INHERIT */
+
+            /* Trace this task waiting on the semaphore. */
+            TRACE_LOG(TRACE_SEM_WAIT, semaphore, 0);
+
             /* Start waiting on this semaphore. */
             status = suspend_condition(&condition, &suspend_ptr, NULL, TRUE);
+
+#ifdef SEMAPHORE_PRIORITY_INHERIT
+            /* We are no longer waiting on this semaphore. */
+            tcb->inherit_semaphore = NULL;
+
+            /* If we timed out waiting on a priority inheriting mutex, that
+             * is not yet deleted. */
+            if ((status != SUCCESS) && (semaphore->inherit == TRUE))
+            {
+                /* Owner might have inherited our priority, recompute it's
+                 * priority without us. */
+                semaphore_update_priority(semaphore->owner);
+            }
+#endif /* SEMAPHORE_PRIORITY_INHERIT */
         }
 
         /* We are not waiting for this semaphore to be free. */
@@ -275,10 +485,28 @@ int32_t semaphore_obtain(SEMAPHORE *semaphore, uint32_t wait)
         /* Save the owner for this semaphore. */
         semaphore->owner = tcb;
 
+#ifdef SEMAPHORE_PRIORITY_INHERIT
+        /* If this is a priority inheriting mutex and we have an owner. */
+        if ((semaphore->inherit == TRUE) && (tcb != NULL))
+        {
+            /* Add this semaphore to the list of inheriting semaphores held by
+             * this task. */
+            semaphore->next_held = (SEMAPHORE *)tcb->inherit_held;
+            tcb->inherit_held = semaphore;
+
+            /* Inherit the priority of the tasks still waiting on this
+             * semaphore. */
+            semaphore_update_priority(tcb);
+        }
+#endif /* SEMAPHORE_PRIORITY_INHERIT */
+
         /* Decrease the semaphore count. */
         semaphore->count --;
     }
 
+    /* Trace the semaphore obtain. */
+    TRACE_LOG(TRACE_SEM_OBTAIN, semaphore, (status == SUCCESS));
+
     /* If this is interrupt accessible lock. */
     if (semaphore->interrupt_protected == TRUE)
     {
@@ -310,9 +538,25 @@ void semaphore_release(SEMAPHORE *semaphore)
     /* Lock the scheduler. */
     scheduler_lock();
 
+    /* Trace the semaphore release. */
+    TRACE_LOG(TRACE_SEM_RELEASE, semaphore, 0);
+
     /* Increment the semaphore count. */
     semaphore->count ++;
 
+#ifdef SEMAPHORE_PRIORITY_INHERIT
+    /* If this is a priority inheriting mutex and we have an owner. */
+    if ((semaphore->inherit == TRUE) && (semaphore->owner != NULL))
+    {
+        /* Owner is no longer holding this semaphore. */
+        semaphore_held_remove(semaphore);
+
+        /* Recompute the priority of the owner, it keeps any priority it has
+         * inherited from the other semaphores it still holds. */
+        semaphore_update_priority(semaphore->owner);
+    }
+#endif /* SEMAPHORE_PRIORITY_INHERIT */
+
     /* Clear the owner task. */
     semaphore->owner = NULL;
 
@@ -83,6 +83,11 @@ typedef struct _semaphore
     /* Current owner of this semaphore if any. */
     TASK        *owner;
 
+#ifdef SEMAPHORE_PRIORITY_INHERIT
+    /* Next priority inheriting semaphore held by the owner. */
+    struct _semaphore   *next_held;
+#endif /* SEMAPHORE_PRIORITY_INHERIT */
+
     /* Interrupt manipulation APIs. */
     SEM_INT_LOCK    *interrupt_lock;
     SEM_INT_UNLOCK  *interrupt_unlock;
@@ -98,14 +103,23 @@ typedef struct _semaphore
      * protected lock. */
     uint8_t     interrupt_protected;
 
+#ifdef SEMAPHORE_PRIORITY_INHERIT
+    /* Flag to specify if owner of this semaphore will inherit priority of
+     * the tasks waiting on it. */
+    uint8_t     inherit;
+#else
     /* Structure padding. */
     uint8_t     pad[1];
+#endif /* SEMAPHORE_PRIORITY_INHERIT */
 
 } SEMAPHORE;
 
 /* Function prototypes. */
 void semaphore_create(SEMAPHORE *, uint8_t);
 void semaphore_set_interrupt_data(SEMAPHORE *, void *, SEM_INT_LOCK *, SEM_INT_UNLOCK *);
+#ifdef SEMAPHORE_PRIORITY_INHERIT
+void semaphore_set_inherit(SEMAPHORE *);
+#endif /* SEMAPHORE_PRIORITY_INHERIT */
 void semaphore_destroy(SEMAPHORE *);
 int32_t semaphore_obtain(SEMAPHORE *, uint32_t);
 void semaphore_release(SEMAPHORE *);
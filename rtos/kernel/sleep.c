@@ -17,14 +17,358 @@
 #ifdef CONFIG_SLEEP
 
 /* Global variable definitions. */
+#ifdef SLEEP_WHEEL
+/* Timing wheel for the sleeping tasks, a task is hashed on the tick at
+ * which it is needed to be resumed. */
+static TASK_LIST sleep_wheel[SLEEP_WHEEL_SLOTS];
+
+/* Tasks that are due but are not yet suspended. */
+static TASK_LIST sleep_expired_list = {NULL, NULL};
+
+/* Next tick that is needed to be processed on the timing wheel. */
+static uint32_t sleep_wheel_tick = 1;
+
+/* Number of tasks on the timing wheel. */
+static uint32_t sleep_wheel_num = 0;
+
+/* Tick at which the next task on the timing wheel is due, this is never after
+ * the actual tick as it is not updated when a task is removed. */
+static uint32_t sleep_wheel_next = 0;
+
+/* Returns the slot for the given tick. */
+#define SLEEP_WHEEL_SLOT(tick)      (&sleep_wheel[(tick) & (SLEEP_WHEEL_SLOTS - 1)])
+#else
 static TASK_LIST sleep_task_list = {NULL, NULL};
+#endif /* SLEEP_WHEEL */
 
 /* This is used for time keeping in the system. */
 uint32_t current_tick = 0;
 
+#ifdef CONFIG_TICKLESS
+/* Number of ticks for which tick source is programmed while suppressed,
+ * zero if we are running a periodic tick. */
+static uint32_t sleep_ticks_suppressed = 0;
+#endif /* CONFIG_TICKLESS */
+
 /* Local function definitions. */
+#ifdef SLEEP_WHEEL
+static void sleep_list_append(TASK_LIST *, TASK *);
+static void sleep_list_remove(TASK_LIST *, TASK *);
+static uint8_t sleep_wheel_is_due(void);
+static uint32_t sleep_wheel_find_next(void);
+#else
 static uint8_t sleep_walk(void *node, void *param);
+#endif /* SLEEP_WHEEL */
+#ifdef CONFIG_TICKLESS
+static uint32_t sleep_ticks_to_next(void);
+#endif /* CONFIG_TICKLESS */
+
+#ifdef SLEEP_WHEEL
+/*
+ * sleep_list_append
+ * @list: Sleep list in which a task is needed to be added.
+ * @tcb: Task needed to be added.
+ * This function will append a task at the end of a sleep list.
+ */
+static void sleep_list_append(TASK_LIST *list, TASK *tcb)
+{
+    /* Link this task at the tail of the list. */
+    tcb->next_sleep = NULL;
+    tcb->prev_sleep = list->tail;
+
+    /* If list is not empty. */
+    if (list->tail != NULL)
+    {
+        /* Add this task after the tail. */
+        list->tail->next_sleep = tcb;
+    }
+    else
+    {
+        /* This is the only task on the list. */
+        list->head = tcb;
+    }
+
+    /* Update the list tail. */
+    list->tail = tcb;
+
+} /* sleep_list_append */
+
+/*
+ * sleep_list_remove
+ * @list: Sleep list from which a task is needed to be removed.
+ * @tcb: Task needed to be removed.
+ * This function will remove a task from a sleep list.
+ */
+static void sleep_list_remove(TASK_LIST *list, TASK *tcb)
+{
+    /* If this is not the head of the list. */
+    if (tcb->prev_sleep != NULL)
+    {
+        /* Unlink this task from the previous task. */
+        tcb->prev_sleep->next_sleep = tcb->next_sleep;
+    }
+    else
+    {
+        /* Should never happen. */
+        ASSERT(list->head != tcb);
+
+        /* Update the list head. */
+        list->head = tcb->next_sleep;
+    }
+
+    /* If this is not the tail of the list. */
+    if (tcb->next_sleep != NULL)
+    {
+        /* Unlink this task from the next task. */
+        tcb->next_sleep->prev_sleep = tcb->prev_sleep;
+    }
+    else
+    {
+        /* Update the list tail. */
+        list->tail = tcb->prev_sleep;
+    }
+
+    /* Clear the links. */
+    tcb->next_sleep = tcb->prev_sleep = NULL;
+
+} /* sleep_list_remove */
+
+/*
+ * sleep_wheel_is_due
+ * @return: TRUE if a task on the timing wheel is due, otherwise FALSE will be
+ *  returned.
+ * This function will check if the next task on the timing wheel is due, as
+ * the next due tick is cached this does not depend on the number of sleeping
+ * tasks or on the number of ticks since the wheel was last processed.
+ */
+static uint8_t sleep_wheel_is_due(void)
+{
+    /* Return if the next task on the timing wheel is due. */
+    return (((sleep_wheel_num > 0) && (INT32CMP(current_tick, sleep_wheel_next) >= 0)) ? TRUE : FALSE);
+
+} /* sleep_wheel_is_due */
+
+/*
+ * sleep_wheel_find_next
+ * @return: Tick at which the next task on the timing wheel is due.
+ * This function will find the tick at which the next task on the timing wheel
+ * is due. The slots are searched in the order of the ticks following the
+ * current tick, a task in a slot is due in this rotation only if its resume
+ * tick is the tick for that slot, so the search stops at the first such task.
+ * If all the tasks are due in later rotations, the task that is due first is
+ * returned. All the due tasks must already be processed and there must be a
+ * task on the timing wheel.
+ */
+static uint32_t sleep_wheel_find_next(void)
+{
+    TASK *tcb;
+    uint32_t tick = current_tick + 1, ticks = MAX_WAIT;
+    int32_t num_slots = SLEEP_WHEEL_SLOTS;
+    uint8_t found = FALSE;
+
+    /* Search all the slots starting from the next tick. */
+    while ((num_slots > 0) && (found == FALSE))
+    {
+        /* Walk the tasks in this slot. */
+        for (tcb = SLEEP_WHEEL_SLOT(tick)->head; tcb != NULL; tcb = tcb->next_sleep)
+        {
+            /* If this task is due before the others seen till now. */
+            if ((tcb->tick_sleep - current_tick) < ticks)
+            {
+                /* Save the number of ticks till this task is due. */
+                ticks = (tcb->tick_sleep - current_tick);
+
+                /* If this task is due at this tick, no other task can be
+                 * due before this task. */
+                if (tcb->tick_sleep == tick)
+                {
+                    found = TRUE;
+
+                    break;
+                }
+            }
+        }
+
+        /* Search the next slot. */
+        tick ++;
+        num_slots --;
+    }
+
+    /* Return the tick at which next task is due. */
+    return (current_tick + ticks);
+
+} /* sleep_wheel_find_next */
+
+/*
+ * sleep_process_system_tick
+ * This function is will be called at each system tick to see if we need to
+ * resume any of the sleeping tasks. All the wheel slots from last processed
+ * tick to the current tick are processed, tasks at a slot are kept in the
+ * order they were added and scheduler ready list keeps the priority order of
+ * the tasks resumed at the same tick. If the cached next due tick has passed
+ * it is searched again.
+ */
+void sleep_process_system_tick(void)
+{
+    TASK *tcb, *next_tcb;
+    TASK_LIST *slot;
+    int32_t num_slots;
+
+    /* Resume any of the expired tasks that are now suspended. */
+    for (tcb = sleep_expired_list.head; tcb != NULL; tcb = next_tcb)
+    {
+        /* Save the next task. */
+        next_tcb = tcb->next_sleep;
+
+        /* If task is now suspended. */
+        if (tcb->state == TASK_SUSPENDED)
+        {
+            /* Remove this task from the expired list. */
+            sleep_list_remove(&sleep_expired_list, tcb);
+            tcb->flags &= (uint8_t)~(TASK_SLEEP_EXPIRED);
+
+            /* Yield this task. */
+            scheduler_task_yield(tcb, YIELD_SLEEP);
+        }
+    }
+
+    /* If we don't have any task on the timing wheel. */
+    if (sleep_wheel_num == 0)
+    {
+        /* Nothing to process. */
+        num_slots = 0;
+    }
+    else
+    {
+        /* Calculate the number of slots we need to process, each slot is
+         * needed to be processed only once. */
+        num_slots = INT32CMP(current_tick, sleep_wheel_tick) + 1;
+        if (num_slots > SLEEP_WHEEL_SLOTS)
+        {
+            num_slots = SLEEP_WHEEL_SLOTS;
+        }
+    }
+
+    /* Process the required slots. */
+    while (num_slots > 0)
+    {
+        /* Pick the slot for the tick being processed. */
+        slot = SLEEP_WHEEL_SLOT(sleep_wheel_tick);
+
+        /* Walk all the tasks on this slot. */
+        for (tcb = slot->head; tcb != NULL; tcb = next_tcb)
+        {
+            /* Save the next task. */
+            next_tcb = tcb->next_sleep;
+
+            /* If this task is due. */
+            if (INT32CMP(current_tick, tcb->tick_sleep) >= 0)
+            {
+                /* Remove this task from the timing wheel. */
+                sleep_list_remove(slot, tcb);
+                sleep_wheel_num --;
+
+                /* If task is in suspended state. */
+                if (tcb->state == TASK_SUSPENDED)
+                {
+                    /* Yield this task. */
+                    scheduler_task_yield(tcb, YIELD_SLEEP);
+                }
+                else
+                {
+                    /* Move this task to the expired list, we will resume it
+                     * once it is actually suspended. */
+                    tcb->flags |= TASK_SLEEP_EXPIRED;
+                    sleep_list_append(&sleep_expired_list, tcb);
+                }
+            }
+        }
+
+        /* Process next slot. */
+        sleep_wheel_tick ++;
+        num_slots --;
+    }
+
+    /* All the ticks till now are processed. */
+    sleep_wheel_tick = current_tick + 1;
 
+    /* If the cached next due tick has passed, find the next task that is
+     * due. */
+    if (sleep_wheel_is_due() == TRUE)
+    {
+        sleep_wheel_next = sleep_wheel_find_next();
+    }
+
+} /* sleep_process_system_tick */
+
+/*
+ * sleep_add_to_list
+ * @tcb: Task's control block that is needed to be added in the sleeping task's
+ *  list.
+ * @ticks: Number of ticks for which this task is needed to sleep.
+ * This function is called when a task is needed to sleep for a particular
+ * number of system ticks. This function adds the given task in the timing
+ * wheel slot for the tick at which it is needed to be resumed. Interrupts
+ * must be locked by caller as sleep list can be modified in the context of
+ * interrupts.
+ */
+void sleep_add_to_list(TASK *tcb, uint32_t ticks)
+{
+    /* Calculate system tick at which task will be invoked. */
+    tcb->tick_sleep = current_system_tick() + ticks;
+
+    /* If the required tick is already processed. */
+    if (INT32CMP(tcb->tick_sleep, sleep_wheel_tick) < 0)
+    {
+        /* This task is already due, add it to the expired list. */
+        tcb->flags |= TASK_SLEEP_EXPIRED;
+        sleep_list_append(&sleep_expired_list, tcb);
+    }
+    else
+    {
+        /* If this task is due before the tasks already on the timing
+         * wheel. */
+        if ((sleep_wheel_num == 0) || (INT32CMP(tcb->tick_sleep, sleep_wheel_next) < 0))
+        {
+            /* Update the next due tick. */
+            sleep_wheel_next = tcb->tick_sleep;
+        }
+
+        /* Put this task on the required slot. */
+        sleep_list_append(SLEEP_WHEEL_SLOT(tcb->tick_sleep), tcb);
+        sleep_wheel_num ++;
+    }
+
+} /* sleep_add_to_list */
+
+/*
+ * sleep_remove_from_list
+ * @tcb: Task's control block that is needed to be removed from the sleeping
+ *  tasks list.
+ * This function is called when a task is needed to be removed from the sleeping
+ * tasks list.
+ */
+void sleep_remove_from_list(TASK *tcb)
+{
+    /* If this task has already expired. */
+    if (tcb->flags & TASK_SLEEP_EXPIRED)
+    {
+        /* Remove this task from the expired list. */
+        sleep_list_remove(&sleep_expired_list, tcb);
+        tcb->flags &= (uint8_t)~(TASK_SLEEP_EXPIRED);
+    }
+    else
+    {
+        /* Remove this task from the timing wheel. */
+        sleep_list_remove(SLEEP_WHEEL_SLOT(tcb->tick_sleep), tcb);
+        sleep_wheel_num --;
+    }
+
+    /* Clear the sleep tick as we are just removed from the sleeping task list. */
+    tcb->tick_sleep = 0;
+
+} /* sleep_remove_from_list */
+#else
 /*
  * sleep_task_sort
  * @node: Existing task in the sleeping task list.
@@ -132,6 +476,7 @@ void sleep_remove_from_list(TASK *tcb)
     tcb->tick_sleep = 0;
 
 } /* sleep_remove_from_list */
+#endif /* SLEEP_WHEEL */
 
 /*
  * sleep_ticks
@@ -224,12 +569,27 @@ uint8_t process_system_tick(void)
 {
     uint8_t trigger_scheduler = FALSE;
 
+#ifdef CONFIG_TICKLESS
+    /* If the system tick was suppressed, the tick source has now expired. */
+    if (sleep_ticks_suppressed != 0)
+    {
+        /* Make up the ticks we skipped and restore the periodic tick. */
+        current_tick += system_tick_resume(TRUE);
+        sleep_ticks_suppressed = 0;
+    }
+#endif /* CONFIG_TICKLESS */
+
     /* Increment current tick. */
     current_tick++;
 
     /* If we need to schedule a context switch. */
+#ifdef SLEEP_WHEEL
+    if ( (sleep_expired_list.head != NULL) ||
+         (sleep_wheel_is_due() == TRUE) )
+#else
     if ( (sleep_task_list.head != NULL) &&
          (INT32CMP(current_tick, sleep_task_list.head->tick_sleep) >= 0) )
+#endif /* SLEEP_WHEEL */
     {
         /* Trigger scheduler. */
         trigger_scheduler = TRUE;
@@ -239,6 +599,112 @@ uint8_t process_system_tick(void)
 
 } /* process_system_tick */
 
+#ifdef CONFIG_TICKLESS
+/*
+ * sleep_tickless_idle
+ * This function is called by the idle task to suppress the system tick until
+ * the next sleeping task is due. The tick source is programmed to expire at
+ * the next deadline and the CPU waits for an interrupt, once resumed any
+ * skipped ticks are added to the system tick. If the tick cannot be
+ * suppressed CPU still waits for the next periodic tick.
+ */
+void sleep_tickless_idle(void)
+{
+    uint32_t ticks;
+    INT_LVL interrupt_level = GET_INTERRUPT_LEVEL();
+
+    /* Disable global interrupts. */
+    DISABLE_INTERRUPTS();
+
+    /* Calculate number of ticks till the next task is due. */
+    ticks = sleep_ticks_to_next();
+
+    /* Only suppress the tick if we have more than one tick to wait. */
+    if (ticks > 1)
+    {
+        /* Program the tick source to expire at the next deadline, port may
+         * clamp this to what the hardware can count. */
+        sleep_ticks_suppressed = system_tick_suspend(ticks);
+    }
+
+    /* If no task is already due. */
+    if (ticks > 0)
+    {
+        /* Wait for either the tick source or an other interrupt, if the tick
+         * was not suppressed this will wait for the next periodic tick. */
+        CPU_IDLE_WAIT();
+
+        /* Restore the periodic tick and make up the skipped ticks. */
+        sleep_tickless_resume();
+    }
+
+    /* Restore old interrupt level. */
+    SET_INTERRUPT_LEVEL(interrupt_level);
+
+} /* sleep_tickless_idle */
+
+/*
+ * sleep_tickless_resume
+ * This function will restore the periodic system tick if it was suppressed,
+ * and add the number of ticks elapsed since it was suppressed to the system
+ * tick. Interrupts must be disabled by the caller.
+ */
+void sleep_tickless_resume(void)
+{
+    /* If system tick is suppressed. */
+    if (sleep_ticks_suppressed != 0)
+    {
+        /* Restore the periodic tick and add the elapsed ticks. */
+        current_tick += system_tick_resume(FALSE);
+        sleep_ticks_suppressed = 0;
+    }
+
+} /* sleep_tickless_resume */
+
+/*
+ * sleep_ticks_to_next
+ * @return: Number of ticks till the next sleeping task is due, MAX_WAIT will
+ *  be returned if no task is sleeping.
+ * This function will return the number of ticks after which the next
+ * sleeping task is due. Interrupts must be disabled by the caller.
+ */
+static uint32_t sleep_ticks_to_next(void)
+{
+    uint32_t ticks = MAX_WAIT;
+
+#ifdef SLEEP_WHEEL
+    /* If we have an expired task. */
+    if (sleep_expired_list.head != NULL)
+    {
+        /* A task is already due. */
+        ticks = 0;
+    }
+
+    /* If we have tasks on the timing wheel. */
+    else if (sleep_wheel_num > 0)
+    {
+        /* Calculate number of ticks till the next task is due, if the task
+         * that was due first was removed we will wake up early and the next
+         * due tick will be updated. */
+        ticks = (INT32CMP(sleep_wheel_next, current_tick) > 0) ? (uint32_t)INT32CMP(sleep_wheel_next, current_tick) : 0;
+    }
+#else
+
+    /* If we have a task sleeping. */
+    if (sleep_task_list.head != NULL)
+    {
+        /* Calculate number of ticks till this task is due. */
+        ticks = (INT32CMP(sleep_task_list.head->tick_sleep, current_tick) > 0) ? (uint32_t)INT32CMP(sleep_task_list.head->tick_sleep, current_tick) : 0;
+    }
+#endif /* SLEEP_WHEEL */
+
+    /* Return number of ticks till next task is due. */
+    return (ticks);
+
+} /* sleep_ticks_to_next */
+#endif /* CONFIG_TICKLESS */
+
+#ifndef SLEEP_WHEEL
 /*
  * sleep_walk
  * @node: A task in the sleep list.
@@ -274,5 +740,6 @@ static uint8_t sleep_walk(void *node, void *do_break)
     return (matched);
 
 } /* sleep_walk */
+#endif /* SLEEP_WHEEL */
 
 #endif /* CONFIG_SLEEP */
@@ -23,6 +23,7 @@
 #include <string.h>
 #include <rtl.h>
 #include <io.h>
+#include <mem.h>
 
 /* String definitions. */
 static const char __sys_info_sys_tick[] PROGMEM = "System tick: ";
@@ -777,6 +778,14 @@ int32_t util_print_sys_info_buffer(FS_BUFFER_LIST *buffer)
     }
 #endif
 
+#if (defined(MEMGR_DYNAMIC) && defined(MEMGR_STATS))
+    if (status == SUCCESS)
+    {
+        /* Add dynamic memory usage and fragmentation information. */
+        status = mem_dynamic_print_usage_buffer(&mem_dynamic_pool, buffer);
+    }
+#endif /* (defined(MEMGR_DYNAMIC) && defined(MEMGR_STATS)) */
+
     /* Return status to the caller. */
     return (status);
 
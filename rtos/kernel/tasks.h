@@ -20,6 +20,7 @@
 /* These defines different task flags. */
 #define TASK_NO_RETURN              0x1     /* This task will never return. */
 #define TASK_SCHED_DRIFT            0x2     /* This task has caused scheduler to miss a tick. */
+#define TASK_SLEEP_EXPIRED          0x4     /* This task is due on sleep but is not yet suspended. */
 
 /* Some task resume status. */
 #define TASK_TO_BE_SUSPENDED        (0)     /* Task is being suspended indefinitely. */
@@ -87,10 +88,23 @@ struct _task
     /* If suspended this will hold task suspension data. */
     void        *suspend_data;
 
+#ifdef SEMAPHORE_PRIORITY_INHERIT
+    /* Priority inheriting semaphore on which this task is waiting. */
+    void        *inherit_semaphore;
+
+    /* List of priority inheriting semaphores held by this task. */
+    void        *inherit_held;
+#endif /* SEMAPHORE_PRIORITY_INHERIT */
+
 #ifdef CONFIG_SLEEP
     /* Link list member for sleeping tasks. */
     TASK        *next_sleep;
 
+#ifdef SLEEP_WHEEL
+    /* Previous task on the sleeping task's list. */
+    TASK        *prev_sleep;
+#endif /* SLEEP_WHEEL */
+
     /* The system tick at which this task is needed to be rescheduled. */
     uint32_t    tick_sleep;
 #endif /* CONFIG_SLEEP */
@@ -113,8 +127,16 @@ struct _task
     /* Holds the reference from where it was resumed. */
     uint8_t     resume_from;
 
+#ifdef SEMAPHORE_PRIORITY_INHERIT
+    /* Priority assigned to this task, without any inherited priority. */
+    uint8_t     base_priority;
+
+    /* Structure padding. */
+    uint8_t     pad[1];
+#else
     /* Structure padding. */
     uint8_t     pad[2];
+#endif /* SEMAPHORE_PRIORITY_INHERIT */
 };
 
 /* This defines a task list. */
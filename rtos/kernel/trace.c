@@ -0,0 +1,239 @@
+/*
+ * trace.c
+ *
+ * Copyright (c) 2014 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+
+#ifdef CONFIG_TRACE
+#include <string.h>
+#include <trace.h>
+#ifdef CONFIG_FS
+#include <fs.h>
+#endif /* CONFIG_FS */
+
+/* Trace ring buffer. */
+static TRACE_RECORD trace_buffer[TRACE_BUFFER_SIZE];
+
+/* Index at which next record will be added. */
+static uint32_t trace_index;
+
+/* Number of valid records in the trace buffer. */
+static uint32_t trace_count;
+
+/* Flag to specify if tracing is enabled. */
+static uint8_t trace_enabled;
+
+/*
+ * trace_init
+ * This function will initialize the trace buffer and start tracing.
+ */
+void trace_init(void)
+{
+    /* Number of records must be a power of 2. */
+    ASSERT((TRACE_BUFFER_SIZE & (TRACE_BUFFER_SIZE - 1)) != 0);
+
+    /* Number of records must fit in the trace dump header. */
+    ASSERT(TRACE_BUFFER_SIZE > 0xFFFF);
+
+#ifdef CPU_CYCLE_COUNT_INIT
+    /* Start the CPU cycle counter. */
+    CPU_CYCLE_COUNT_INIT();
+#endif /* CPU_CYCLE_COUNT_INIT */
+
+    /* Clear the trace buffer. */
+    trace_reset();
+
+    /* Start tracing. */
+    trace_enabled = TRUE;
+
+} /* trace_init */
+
+/*
+ * trace_log
+ * @type: Record type.
+ * @object: Object for which this record is being added.
+ * @arg: Record argument.
+ * This function will add a record in the trace buffer, if the buffer is full
+ * the oldest record will be overwritten. This can be called from an ISR.
+ */
+void trace_log(uint8_t type, uint32_t object, uint8_t arg)
+{
+    TRACE_RECORD *record;
+    INT_LVL interrupt_level;
+
+    /* If tracing is enabled. */
+    if (trace_enabled == TRUE)
+    {
+        /* Disable global interrupts. */
+        interrupt_level = GET_INTERRUPT_LEVEL();
+        DISABLE_INTERRUPTS();
+
+        /* Pick the next record. */
+        record = &trace_buffer[trace_index];
+        trace_index = (trace_index + 1) & (TRACE_BUFFER_SIZE - 1);
+
+        /* Once buffer is full, each record overwrites the oldest one. */
+        if (trace_count < TRACE_BUFFER_SIZE)
+        {
+            trace_count ++;
+        }
+
+        /* Populate this record. */
+        record->time = TRACE_TIMESTAMP();
+        record->object = object;
+        record->type = type;
+        record->arg = arg;
+
+        /* Restore old interrupt level. */
+        SET_INTERRUPT_LEVEL(interrupt_level);
+    }
+
+} /* trace_log */
+
+/*
+ * trace_enable
+ * @enable: TRUE if tracing is needed to be enabled, FALSE if tracing is needed
+ *  to be paused.
+ * This function will enable or pause the tracing.
+ */
+void trace_enable(uint8_t enable)
+{
+    /* Update the trace flag. */
+    trace_enabled = enable;
+
+} /* trace_enable */
+
+/*
+ * trace_reset
+ * This function will discard all the records in the trace buffer.
+ */
+void trace_reset(void)
+{
+    INT_LVL interrupt_level = GET_INTERRUPT_LEVEL();
+
+    /* Disable global interrupts. */
+    DISABLE_INTERRUPTS();
+
+    /* Clear the trace buffer. */
+    memset(trace_buffer, 0, sizeof(trace_buffer));
+    trace_index = trace_count = 0;
+
+    /* Restore old interrupt level. */
+    SET_INTERRUPT_LEVEL(interrupt_level);
+
+} /* trace_reset */
+
+#ifdef CONFIG_FS
+/*
+ * trace_dump
+ * @fd: File descriptor on which trace is needed to be dumped.
+ * @return: Number of bytes written will be returned, if an error occurred it
+ *  will be returned.
+ * This function will dump the trace buffer in binary on the given file
+ * descriptor, this can be a serial port or a socket. The dump has a header
+ * followed by the task entries and then the records from oldest to newest.
+ * Tracing is paused while dumping and is resumed after it if it was enabled.
+ */
+int32_t trace_dump(void *fd)
+{
+    TRACE_HEADER header;
+#ifdef TASK_STATS
+    TRACE_TASK task;
+    TASK *tcb;
+#endif /* TASK_STATS */
+    uint32_t start, num_records, num_first;
+    int32_t status, written = 0;
+    uint8_t was_enabled = trace_enabled;
+
+    /* Pause the tracing, so records are not added while we dump them. */
+    trace_enabled = FALSE;
+
+    /* Calculate the number of valid records and the oldest record. */
+    num_records = trace_count;
+    start = (trace_index - num_records) & (TRACE_BUFFER_SIZE - 1);
+
+    /* Initialize the trace header. */
+    memset(&header, 0, sizeof(TRACE_HEADER));
+    header.magic = TRACE_MAGIC;
+    header.freq = (uint32_t)TRACE_TIMESTAMP_FREQ;
+    header.num_records = (uint16_t)num_records;
+    header.version = TRACE_VERSION;
+    header.record_size = sizeof(TRACE_RECORD);
+
+#ifdef TASK_STATS
+    /* Count the number of tasks in the system. */
+    for (tcb = sch_task_list.head; tcb != NULL; tcb = tcb->next_global)
+    {
+        header.num_tasks ++;
+    }
+#endif /* TASK_STATS */
+
+    /* Write the trace header. */
+    status = fs_write(fd, (const uint8_t *)&header, sizeof(TRACE_HEADER));
+
+#ifdef TASK_STATS
+    /* Write the task entries. */
+    for (tcb = sch_task_list.head; (status > 0) && (tcb != NULL); tcb = tcb->next_global)
+    {
+        /* Update the number of bytes written. */
+        written += status;
+
+        /* Populate task entry. */
+        memset(&task, 0, sizeof(TRACE_TASK));
+        task.object = (uint32_t)(uintptr_t)tcb;
+        task.priority = tcb->priority;
+        P_STR_NCPY(task.name, tcb->name, (P_STR_LEN(tcb->name) >= TRACE_NAME_SIZE) ? (TRACE_NAME_SIZE - 1) : P_STR_LEN(tcb->name));
+
+        /* Write this task entry. */
+        status = fs_write(fd, (const uint8_t *)&task, sizeof(TRACE_TASK));
+    }
+#endif /* TASK_STATS */
+
+    /* If we have records till the end of the buffer. */
+    num_first = ((start + num_records) > TRACE_BUFFER_SIZE) ? (TRACE_BUFFER_SIZE - start) : num_records;
+
+    /* If we have some records to write. */
+    if ((status > 0) && (num_first > 0))
+    {
+        /* Update the number of bytes written. */
+        written += status;
+
+        /* Write the records till the end of the buffer. */
+        status = fs_write(fd, (const uint8_t *)&trace_buffer[start], (int32_t)(num_first * sizeof(TRACE_RECORD)));
+    }
+
+    /* If buffer is wrapped. */
+    if ((status > 0) && (num_records > num_first))
+    {
+        /* Update the number of bytes written. */
+        written += status;
+
+        /* Write remaining records from the start of the buffer. */
+        status = fs_write(fd, (const uint8_t *)&trace_buffer[0], (int32_t)((num_records - num_first) * sizeof(TRACE_RECORD)));
+    }
+
+    /* If last write was successful. */
+    if (status > 0)
+    {
+        /* Return number of bytes written. */
+        status += written;
+    }
+
+    /* Resume the tracing if it was enabled. */
+    trace_enabled = was_enabled;
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* trace_dump */
+#endif /* CONFIG_FS */
+
+#endif /* CONFIG_TRACE */
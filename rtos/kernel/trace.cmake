@@ -0,0 +1,3 @@
+# Setup trace configuration options.
+setup_option_def(CONFIG_TRACE OFF DEFINE "Enable kernel event tracing." CONFIG_FILE "trace_config")
+setup_option_def(TRACE_BUFFER_SIZE 256 INT "Number of records in the trace buffer, must be a power of 2." CONFIG_FILE "trace_config")
\ No newline at end of file
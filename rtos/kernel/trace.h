@@ -0,0 +1,131 @@
+/*
+ * trace.h
+ *
+ * Copyright (c) 2014 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include <kernel.h>
+#include <trace_config.h>
+
+/* Trace timestamp, this is also used by other traces when tracing is
+ * disabled. */
+#ifdef CPU_CYCLE_COUNT
+#define TRACE_TIMESTAMP()       (uint32_t)CPU_CYCLE_COUNT()
+#define TRACE_TIMESTAMP_FREQ    (SYS_FREQ)
+#else
+#define TRACE_TIMESTAMP()       (uint32_t)current_hardware_tick()
+#define TRACE_TIMESTAMP_FREQ    (HW_TICKS_PER_SEC)
+#endif /* CPU_CYCLE_COUNT */
+
+#ifdef CONFIG_TRACE
+
+/* Trace record types. */
+#define TRACE_TASK_SWITCH       (1)     /* Object: Task switched in, Argument: Task priority. */
+#define TRACE_TASK_READY        (2)     /* Object: Task made ready, Argument: Previous task state. */
+#define TRACE_ISR_ENTER         (3)     /* Object: ISR number, Argument: None. */
+#define TRACE_ISR_EXIT          (4)     /* Object: ISR number, Argument: None. */
+#define TRACE_SUSPEND           (5)     /* Object: First condition, Argument: Number of conditions. */
+#define TRACE_RESUME            (6)     /* Object: Task resumed, Argument: None. */
+#define TRACE_SEM_WAIT          (7)     /* Object: Semaphore, Argument: None. */
+#define TRACE_SEM_OBTAIN        (8)     /* Object: Semaphore, Argument: TRUE if obtained. */
+#define TRACE_SEM_RELEASE       (9)     /* Object: Semaphore, Argument: None. */
+
+/* Trace dump definitions. */
+#define TRACE_MAGIC             (0x43525457)    /* "WTRC" */
+#define TRACE_VERSION           (1)
+#define TRACE_NAME_SIZE         (15)
+
+/* ISR number being traced. */
+#ifdef CPU_ISR_NUMBER
+#define TRACE_ISR_NUMBER()      CPU_ISR_NUMBER()
+#else
+#define TRACE_ISR_NUMBER()      (0)
+#endif /* CPU_ISR_NUMBER */
+
+/* Trace record. */
+typedef struct _trace_record
+{
+    /* Time at which this record was added. */
+    uint32_t    time;
+
+    /* Object for which this record was added. */
+    uint32_t    object;
+
+    /* Record type. */
+    uint8_t     type;
+
+    /* Record argument. */
+    uint8_t     arg;
+
+    /* Structure padding. */
+    uint8_t     pad[2];
+
+} TRACE_RECORD;
+
+/* Trace dump header. */
+typedef struct _trace_header
+{
+    /* Trace magic. */
+    uint32_t    magic;
+
+    /* Frequency of the record timestamp. */
+    uint32_t    freq;
+
+    /* Number of task entries following this header. */
+    uint16_t    num_tasks;
+
+    /* Number of records following the task entries. */
+    uint16_t    num_records;
+
+    /* Trace version. */
+    uint8_t     version;
+
+    /* Size of a record. */
+    uint8_t     record_size;
+
+    /* Structure padding. */
+    uint8_t     pad[2];
+
+} TRACE_HEADER;
+
+/* Trace dump task entry. */
+typedef struct _trace_task
+{
+    /* Task control block. */
+    uint32_t    object;
+
+    /* Task priority. */
+    uint8_t     priority;
+
+    /* Task name. */
+    char        name[TRACE_NAME_SIZE];
+
+} TRACE_TASK;
+
+/* Trace logging macros. */
+#define TRACE_LOG(type, object, arg)    trace_log((type), (uint32_t)(uintptr_t)(object), (uint8_t)(arg))
+
+/* Function prototypes. */
+void trace_init(void);
+void trace_log(uint8_t, uint32_t, uint8_t);
+void trace_enable(uint8_t);
+void trace_reset(void);
+#ifdef CONFIG_FS
+/* This header is included by kernel.h so file descriptor is passed as a
+ * void pointer rather than FD. */
+int32_t trace_dump(void *);
+#endif /* CONFIG_FS */
+
+#else
+#define TRACE_LOG(type, object, arg)
+#endif /* CONFIG_TRACE */
+#endif /* _TRACE_H_ */
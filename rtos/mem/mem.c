@@ -42,21 +42,51 @@ MEM_DYN_CFG mem_dyn_cfg [NUM_PAGES] =
 };
 #endif
 
+#ifdef MEMGR_SLAB
+MEM_SLAB mem_slab_pool;
+
+/* Total number of size classes in slab memory. */
+#define NUM_SLAB_CLASSES    4
+#define MEM_SLAB_FLAGS      0
+
+/* Slab memory size class configuration, must be sorted on item size. */
+MEM_SLAB_CFG mem_slab_cfg [NUM_SLAB_CLASSES] =
+{
+        { 0x10,     16 },
+        { 0x40,     8 },
+        { 0x100,    4 },
+        { 0x240,    2 },
+};
+#endif
+
 /*
  * mem_init
  * This function initializes memory managers.
  */
 void mem_init(void)
 {
+#ifdef MEMGR_SLAB
+    uint8_t *mem_start = DYNAMIC_MEM_START;
+#endif
 
 #ifdef MEMGR_STATIC
     /* Initialize global static memory region. */
     mem_static_init_region(&mem_static_pool, STATIC_MEM_START, STATIC_MEM_END);
 #endif
 
+#ifdef MEMGR_SLAB
+    /* Initialize slab memory region at the start of dynamic memory, rest of
+     * the memory will be given to the dynamic memory manager. */
+    mem_start = mem_slab_init_region(&mem_slab_pool, mem_start, DYNAMIC_MEM_END, NUM_SLAB_CLASSES, mem_slab_cfg, MEM_SLAB_FLAGS);
+#endif
+
 #ifdef MEMGR_DYNAMIC
     /* Initialize global static memory region. */
+#ifdef MEMGR_SLAB
+    mem_dynamic_init_region(&mem_dynamic_pool, mem_start, DYNAMIC_MEM_END, NUM_PAGES, mem_dyn_cfg, MEM_FLAGS);
+#else
     mem_dynamic_init_region(&mem_dynamic_pool, DYNAMIC_MEM_START, DYNAMIC_MEM_END, NUM_PAGES, mem_dyn_cfg, MEM_FLAGS);
+#endif /* MEMGR_SLAB */
 #endif
 
 } /* mem_init */
@@ -1,4 +1,5 @@
 # Setup configuration options.
 setup_option_def(MEMGR_STATIC ON DEFINE "Enable static memory manager." CONFIG_FILE "mem_config")
 setup_option_def(MEMGR_DYNAMIC ON DEFINE "Enable dynamic memory manager." CONFIG_FILE "mem_config")
+setup_option_def(MEMGR_SLAB OFF DEFINE "Enable slab memory manager." CONFIG_FILE "mem_config")
 setup_option_def(MEMGR_STATS ON DEFINE "Enable memory statistics." CONFIG_FILE "mem_config")
\ No newline at end of file
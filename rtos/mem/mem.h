@@ -26,6 +26,10 @@
 #include <mem_dynamic.h>
 #endif
 
+#ifdef MEMGR_SLAB
+#include <mem_slab.h>
+#endif
+
 #ifdef MEMGR_STATS
 #include <mem_stats.h>
 #endif
@@ -39,6 +43,10 @@ extern MEM_STATIC mem_static_pool;
 extern MEM_DYNAMIC mem_dynamic_pool;
 #endif
 
+#ifdef MEMGR_SLAB
+extern MEM_SLAB mem_slab_pool;
+#endif
+
 /* Function prototypes. */
 void mem_init(void);
 
@@ -52,6 +60,11 @@ void mem_init(void);
 #define mem_dynamic_dealloc(mem)    mem_dynamic_dealloc_region((uint8_t *)mem)
 #endif
 
+#ifdef MEMGR_SLAB
+#define mem_slab_alloc(size)        mem_slab_alloc_region(&mem_slab_pool, size)
+#define mem_slab_dealloc(mem)       mem_slab_dealloc_region((uint8_t *)mem)
+#endif
+
 #endif /* CONFIG_MEMGR */
 
 #endif /* MEM_H */
@@ -78,6 +78,11 @@ void mem_dynamic_init_region(MEM_DYNAMIC *mem_dynamic, uint8_t *start, uint8_t *
     /* Clear memory region identifier. */
     memset(mem_dynamic, 0, sizeof(MEM_DYNAMIC));
 
+#ifdef MEM_DYNAMIC_TRACE
+    /* Initialize allocation trace for this region. */
+    mem_dynamic_trace_init(mem_dynamic, start, end, mem_cfg);
+#endif /* MEM_DYNAMIC_TRACE */
+
     /* Initialize memory region. */
     /* We will have page definitions on the start of the memory region. */
     mem_dynamic->pages = (MEM_PAGE *)start;
@@ -163,6 +168,11 @@ void mem_dynamic_init_region(MEM_DYNAMIC *mem_dynamic, uint8_t *start, uint8_t *
         mem_dynamic->pages[i].free_list.head =
         mem_dynamic->pages[i].free_list.tail = mem_free;
 
+#ifdef MEM_DYNAMIC_TRACE
+        /* Initialize the largest free memory low water mark. */
+        mem_dynamic->pages[i].min_largest = page_size;
+#endif /* MEM_DYNAMIC_TRACE */
+
 #ifdef MEM_FREE_CHECK
         /* Fill in the pattern that is expected if this is a free memory. */
         memset((mem_free + 1), MEM_FREE_PATTERN, page_size - sizeof(MEM_FREE));
@@ -346,6 +356,10 @@ uint8_t *mem_dynamic_alloc_region(MEM_DYNAMIC *mem_dynamic, uint32_t size)
 #ifdef MEM_FREE_CHECK
     uint8_t *mem_loc, *mem_end;
 #endif /* CONFIG_SEMAPHORE */
+#ifdef MEM_DYNAMIC_TRACE
+    uint32_t site, req_size = size, start_time;
+    MEM_ALOC *mem_aloc = NULL;
+#endif /* MEM_DYNAMIC_TRACE */
 
     /* We will always allocate aligned memory. */
     size = ALLIGN_CEIL(size + sizeof(MEM_ALOC));
@@ -363,6 +377,14 @@ uint8_t *mem_dynamic_alloc_region(MEM_DYNAMIC *mem_dynamic, uint32_t size)
     scheduler_lock();
 #endif /* CONFIG_SEMAPHORE */
 
+#ifdef MEM_DYNAMIC_TRACE
+    /* Get the call site index for the caller. */
+    site = mem_dynamic_trace_site(mem_dynamic, MEM_DYN_CALL_SITE());
+
+    /* Save the time at which we started the allocation. */
+    start_time = TRACE_TIMESTAMP();
+#endif /* MEM_DYNAMIC_TRACE */
+
     /* First find a suitable memory page for this size. */
     mem_page = mem_dynamic_search_region(mem_dynamic, size, !(mem_dynamic->flags & MEM_STRICT_ALLOC));
 
@@ -412,6 +434,10 @@ uint8_t *mem_dynamic_alloc_region(MEM_DYNAMIC *mem_dynamic, uint32_t size)
 
             /* Initialize a new memory descriptor. */
             ((MEM_ALOC *)mem_free)->page = mem_page;
+#ifdef MEM_DYNAMIC_TRACE
+            ((MEM_ALOC *)mem_free)->site = site;
+            mem_aloc = (MEM_ALOC *)mem_free;
+#endif /* MEM_DYNAMIC_TRACE */
 #ifdef MEM_ID_CHECK
             ((MEM_ALOC *)mem_free)->descriptor.id = MEM_ALLOCATED_ID;
 #endif
@@ -427,7 +453,7 @@ uint8_t *mem_dynamic_alloc_region(MEM_DYNAMIC *mem_dynamic, uint32_t size)
 
                 /* Create a new free memory at the end of the allocated memory. */
                 mem_free = (MEM_FREE *)((uint8_t *)mem_free + size);
-                mem_free->descriptor.phy_prev = (MEM_DESC *)mem_free;
+                mem_free->descriptor.phy_prev = (MEM_DESC *)mem_ptr;
                 mem_free->descriptor.size = remaining_size;
 #ifdef MEM_ID_CHECK
                 /* Set free memory ID for this memory. */
@@ -438,7 +464,7 @@ uint8_t *mem_dynamic_alloc_region(MEM_DYNAMIC *mem_dynamic, uint32_t size)
                 if (((uint8_t *)mem_free + remaining_size) < mem_page->base_end)
                 {
                     /* Update physical previous for next memory node. */
-                    ((MEM_DESC *)(mem_free + remaining_size))->phy_prev = (MEM_DESC *)mem_free;
+                    ((MEM_DESC *)((uint8_t *)mem_free + remaining_size))->phy_prev = (MEM_DESC *)mem_free;
                 }
 
                 /* Check if we need to maintain a descending list. */
@@ -508,9 +534,23 @@ uint8_t *mem_dynamic_alloc_region(MEM_DYNAMIC *mem_dynamic, uint32_t size)
                     sll_search_pop(&mem_page->free_list, mem_dynamic_get_max, &(mem_page->free), OFFSETOF(MEM_FREE, next));
                 }
             }
+
+#ifdef MEM_DYNAMIC_TRACE
+            /* Update the largest free memory low water mark for this page. */
+            remaining_size = (mem_page->free != NULL) ? mem_page->free->descriptor.size : 0;
+            if (remaining_size < mem_page->min_largest)
+            {
+                mem_page->min_largest = remaining_size;
+            }
+#endif /* MEM_DYNAMIC_TRACE */
         }
     }
 
+#ifdef MEM_DYNAMIC_TRACE
+    /* Record this allocation. */
+    mem_dynamic_trace_event(mem_dynamic, ((mem_aloc != NULL) ? MEM_DYN_EVENT_ALLOC : MEM_DYN_EVENT_FAIL), site, mem_aloc, req_size, (TRACE_TIMESTAMP() - start_time));
+#endif /* MEM_DYNAMIC_TRACE */
+
 #ifdef CONFIG_SEMAPHORE
     /* Release the memory lock. */
     semaphore_release(&mem_dynamic->lock);
@@ -524,6 +564,39 @@ uint8_t *mem_dynamic_alloc_region(MEM_DYNAMIC *mem_dynamic, uint32_t size)
 
 } /* mem_dynamic_alloc_region */
 
+/*
+ * mem_dynamic_page_free
+ * @mem_page: Memory page for which free memory is needed.
+ * @largest: If not null largest free memory on this page will be returned
+ *  here.
+ * @return: Total free memory on this page.
+ * This function will calculate the free memory on a page, caller must have
+ * the memory region locked.
+ */
+uint32_t mem_dynamic_page_free(MEM_PAGE *mem_page, uint32_t *largest)
+{
+    MEM_FREE *mem_free = mem_page->free_list.head;
+    uint32_t free = 0;
+
+    /* Go through free memory list. */
+    while (mem_free)
+    {
+        free += mem_free->descriptor.size;
+        mem_free = mem_free->next;
+    }
+
+    /* If largest free memory was requested. */
+    if (largest != NULL)
+    {
+        /* Return the largest free memory on this page. */
+        *largest = (mem_page->free != NULL) ? mem_page->free->descriptor.size : 0;
+    }
+
+    /* Return total free memory on this page. */
+    return (free);
+
+} /* mem_dynamic_page_free */
+
 /*
  * mem_dynamic_dealloc_region
  * @mem_ptr: Memory needed to be deallocated.
@@ -535,6 +608,10 @@ uint8_t *mem_dynamic_dealloc_region(uint8_t *mem_ptr)
 {
     MEM_PAGE *mem_page;
     MEM_FREE *mem_free, *neighbor;
+#ifdef MEM_DYNAMIC_TRACE
+    uint32_t site, size, start_time;
+    MEM_ALOC *mem_aloc;
+#endif /* MEM_DYNAMIC_TRACE */
 
     /* Lock the scheduler. */
     scheduler_lock();
@@ -566,6 +643,16 @@ uint8_t *mem_dynamic_dealloc_region(uint8_t *mem_ptr)
         /* Get memory page information from free memory descriptor. */
         mem_page  = ((MEM_ALOC *)mem_free)->page;
 
+#ifdef MEM_DYNAMIC_TRACE
+        /* Save the time at which we started the deallocation. */
+        start_time = TRACE_TIMESTAMP();
+
+        /* Save the trace information before this memory is merged. */
+        mem_aloc = (MEM_ALOC *)mem_free;
+        site = mem_aloc->site;
+        size = mem_free->descriptor.size;
+#endif /* MEM_DYNAMIC_TRACE */
+
 #ifdef MEM_BNDRY_CHECK
         /* Verify that memory boundary patterns are intact. */
         ASSERT(memcmp(mem_ptr, MEM_BNDRY_PATTERN, MEM_BNDRY_LENGTH));
@@ -684,6 +771,11 @@ uint8_t *mem_dynamic_dealloc_region(uint8_t *mem_ptr)
             mem_page->free = mem_free;
         }
 
+#ifdef MEM_DYNAMIC_TRACE
+        /* Record this deallocation. */
+        mem_dynamic_trace_event(mem_page->mem_region, MEM_DYN_EVENT_FREE, site, mem_aloc, size, (TRACE_TIMESTAMP() - start_time));
+#endif /* MEM_DYNAMIC_TRACE */
+
 #ifdef CONFIG_SEMAPHORE
         /* Release the memory lock. */
         semaphore_release(&mem_page->mem_region->lock);
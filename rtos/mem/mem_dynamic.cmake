@@ -1,4 +1,9 @@
 # Setup configuration options.
 setup_option_def(MEM_BNDRY_CHECK ON DEFINE "Enable boundary checks for dynamic memory." CONFIG_FILE "mem_dynamic_config")
 setup_option_def(MEM_FREE_CHECK ON DEFINE "Enable free memory check for dynamic memory." CONFIG_FILE "mem_dynamic_config")
-setup_option_def(MEM_ID_CHECK ON DEFINE "Enable ID check for dynamic memory." CONFIG_FILE "mem_dynamic_config")
\ No newline at end of file
+setup_option_def(MEM_ID_CHECK ON DEFINE "Enable ID check for dynamic memory." CONFIG_FILE "mem_dynamic_config")
+setup_option_def(MEM_DYNAMIC_TRACE OFF DEFINE "Enable allocation tracing for dynamic memory." CONFIG_FILE "mem_dynamic_config")
+if (${MEM_DYNAMIC_TRACE})
+    setup_option_def(MEM_DYNAMIC_TRACE_SITES 16 INT "Number of call sites for which allocation statistics are maintained." CONFIG_FILE "mem_dynamic_config")
+    setup_option_def(MEM_DYNAMIC_TRACE_SIZE 128 INT "Number of allocation events in the trace buffer, must be a power of 2." CONFIG_FILE "mem_dynamic_config")
+endif ()
\ No newline at end of file
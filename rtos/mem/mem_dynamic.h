@@ -19,6 +19,9 @@
 #ifdef MEMGR_DYNAMIC
 #include <semaphore.h>
 #include <mem_dynamic_config.h>
+#if (defined(MEM_DYNAMIC_TRACE) && defined(CONFIG_FS))
+#include <fs.h>
+#endif /* (defined(MEM_DYNAMIC_TRACE) && defined(CONFIG_FS)) */
 
 /* Memory page configuration flags. */
 #define MEM_PAGE_DEC        0x1
@@ -41,6 +44,20 @@
 #define MEM_ALLOCATED_ID    0x99884433
 #endif
 
+#ifdef MEM_DYNAMIC_TRACE
+/* Allocation trace event types. */
+#define MEM_DYN_EVENT_ALLOC     1
+#define MEM_DYN_EVENT_FREE      2
+#define MEM_DYN_EVENT_FAIL      3
+
+/* Allocation trace dump definitions. */
+#define MEM_DYN_TRACE_MAGIC     (0x4D444D57)    /* "WMDM" */
+#define MEM_DYN_TRACE_VERSION   (1)
+
+/* Returns the call site of the function using it. */
+#define MEM_DYN_CALL_SITE()     (uint32_t)(uintptr_t)__builtin_return_address(0)
+#endif /* MEM_DYNAMIC_TRACE */
+
 #ifndef MEM_BNDRY_CHECK
 #define MEM_DYN_MIN_MEM     (sizeof(MEM_ALOC))
 #else
@@ -89,6 +106,11 @@ typedef struct _mem_allocated
 
     /* Memory page to which this memory will be returned. */
     MEM_PAGE    *page;
+
+#ifdef MEM_DYNAMIC_TRACE
+    /* Call site index that allocated this memory. */
+    uint32_t    site;
+#endif /* MEM_DYNAMIC_TRACE */
 } MEM_ALOC;
 
 /* Free memory descriptor. */
@@ -126,8 +148,121 @@ struct _mem_page
 
     /* Configuration flags for this page. */
     uint32_t    flags;
+
+#ifdef MEM_DYNAMIC_TRACE
+    /* Smallest largest free memory ever on this page. */
+    uint32_t    min_largest;
+#endif /* MEM_DYNAMIC_TRACE */
 };
 
+#ifdef MEM_DYNAMIC_TRACE
+/* Per call site allocation statistics. */
+typedef struct _mem_dyn_site
+{
+    /* Call site address, 0 is used for the call sites that did not fit in
+     * the site table. */
+    uint32_t    site;
+
+    /* Number of allocations, deallocations and failed allocations. */
+    uint32_t    num_alloc;
+    uint32_t    num_free;
+    uint32_t    num_fail;
+
+    /* Number of bytes currently allocated and the high water mark. */
+    uint32_t    bytes;
+    uint32_t    max_bytes;
+
+    /* Maximum time taken by an allocation and deallocation. */
+    uint32_t    max_alloc_time;
+    uint32_t    max_free_time;
+} MEM_DYN_SITE;
+
+/* Allocation trace event. */
+typedef struct _mem_dyn_event
+{
+    /* Time at which this event was recorded. */
+    uint32_t    time;
+
+    /* Memory for this event. */
+    uint32_t    mem;
+
+    /* Requested size for an allocation. */
+    uint32_t    size;
+
+    /* Call site index. */
+    uint16_t    site;
+
+    /* Event type. */
+    uint8_t     type;
+
+    /* Structure padding. */
+    uint8_t     pad[1];
+} MEM_DYN_EVENT;
+
+/* Allocation trace dump header. */
+typedef struct _mem_dyn_trace_header
+{
+    /* Trace magic. */
+    uint32_t    magic;
+
+    /* Frequency of the event timestamp. */
+    uint32_t    freq;
+
+    /* Size of the memory region. */
+    uint32_t    region_size;
+
+    /* Memory region configuration flags. */
+    uint32_t    flags;
+
+    /* Number of page, site and event entries following this header. */
+    uint16_t    num_pages;
+    uint16_t    num_sites;
+    uint16_t    num_events;
+
+    /* Trace version. */
+    uint8_t     version;
+
+    /* Structure padding. */
+    uint8_t     pad[1];
+} MEM_DYN_TRACE_HEADER;
+
+/* Allocation trace dump page entry. */
+typedef struct _mem_dyn_trace_page
+{
+    /* Page configuration. */
+    MEM_DYN_CFG cfg;
+
+    /* Total free memory and the largest free memory on this page. */
+    uint32_t    free;
+    uint32_t    largest;
+
+    /* Smallest largest free memory ever on this page. */
+    uint32_t    min_largest;
+} MEM_DYN_TRACE_PAGE;
+
+/* Allocation trace data for a region. */
+typedef struct _mem_dyn_trace
+{
+    /* Per call site statistics. */
+    MEM_DYN_SITE    sites[MEM_DYNAMIC_TRACE_SITES];
+
+    /* Trace event ring buffer. */
+    MEM_DYN_EVENT   events[MEM_DYNAMIC_TRACE_SIZE];
+
+    /* Page configuration used to initialize this region. */
+    MEM_DYN_CFG     *cfg;
+
+    /* Size of this memory region. */
+    uint32_t        region_size;
+
+    /* Index at which next event will be added. */
+    uint32_t        event_index;
+
+    /* Number of valid entries in the site table. */
+    uint32_t        num_sites;
+} MEM_DYN_TRACE;
+#endif /* MEM_DYNAMIC_TRACE */
+
 /* Region descriptor. */
 struct _mem_dynamic
 {
@@ -145,12 +280,26 @@ struct _mem_dynamic
     /* Pages in this memory table. */
     MEM_PAGE    *pages;
 
+#ifdef MEM_DYNAMIC_TRACE
+    /* Allocation trace data. */
+    MEM_DYN_TRACE   trace;
+#endif /* MEM_DYNAMIC_TRACE */
+
 };
 
 /* FUnction prototypes. */
 void mem_dynamic_init_region(MEM_DYNAMIC *, uint8_t *, uint8_t *, uint32_t, MEM_DYN_CFG *, uint32_t);
 uint8_t *mem_dynamic_alloc_region(MEM_DYNAMIC *, uint32_t);
 uint8_t *mem_dynamic_dealloc_region(uint8_t *);
+uint32_t mem_dynamic_page_free(MEM_PAGE *, uint32_t *);
+#ifdef MEM_DYNAMIC_TRACE
+void mem_dynamic_trace_init(MEM_DYNAMIC *, uint8_t *, uint8_t *, MEM_DYN_CFG *);
+uint32_t mem_dynamic_trace_site(MEM_DYNAMIC *, uint32_t);
+void mem_dynamic_trace_event(MEM_DYNAMIC *, uint8_t, uint32_t, MEM_ALOC *, uint32_t, uint32_t);
+#ifdef CONFIG_FS
+int32_t mem_dynamic_trace_dump(MEM_DYNAMIC *, FD);
+#endif /* CONFIG_FS */
+#endif /* MEM_DYNAMIC_TRACE */
 
 #endif /* MEMGR_DYNAMIC */
 #endif /* MEM_DYNAMIC_H */
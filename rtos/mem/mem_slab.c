@@ -0,0 +1,317 @@
+/*
+ * mem_slab.c
+ *
+ * Copyright (c) 2014 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+
+/* Proof-Of-Concept:
+ *  This memory manager works on fixed size classes. Each class is initialized
+ *  with an item size and number of items, all the items in a class are
+ *  carved out at initialization and are kept in a free list.
+ *  A memory is allocated from the smallest class that can hold it, if that
+ *  class has no free item next larger class is used unless
+ *  MEM_SLAB_STRICT_ALLOC is set.
+ *
+ * Locking:
+ *  By default a region is protected by a semaphore like dynamic memory. If
+ *  MEM_SLAB_INT_LOCK is set interrupts are locked instead, as allocation and
+ *  deallocation only push or pop a free list this is only a few instructions
+ *  and allocation can also be done from an ISR. This is not lock free, the
+ *  free lists are still accessed under a lock, but it is a short interrupt
+ *  lock rather than a semaphore that can suspend the caller.
+ *
+ * Per memory overhead:
+ *  For each allocated memory a MEM_SLAB_ALOC structure will be used, that is
+ *  one pointer rounded up to alignment.
+ *
+ * Cons:
+ *  Memory is wasted if the size classes don't match the allocation sizes
+ *  being used and a class cannot borrow items from other classes.
+ *
+ * Pros:
+ *  Allocation and deallocation takes constant time and there is no external
+ *  fragmentation no matter how long the system is running.
+ */
+#include <kernel.h>
+#include <mem.h>
+
+#ifdef MEMGR_SLAB
+#include <string.h>
+#include <semaphore.h>
+
+/* Local function prototypes. */
+static void mem_slab_lock(MEM_SLAB *, INT_LVL *);
+static void mem_slab_unlock(MEM_SLAB *, INT_LVL);
+
+/*
+ * mem_slab_init_region
+ * @mem_slab: The slab memory region descriptor to be populated.
+ * @start: Start of the memory.
+ * @end: End of the memory.
+ * @num_classes: Number of size classes to maintain for this region.
+ * @slab_cfg: Per class configuration, must be sorted on item size.
+ * @flags: Slab region configuration flags.
+ *  MEM_SLAB_STRICT_ALLOC: A memory will not be allocated from a larger class
+ *      if the best fitting class is empty.
+ *  MEM_SLAB_INT_LOCK: Region will be protected by locking interrupts rather
+ *      than a semaphore.
+ * @return: Memory after the slab region that is not used, this can be given
+ *  to other memory managers.
+ * This function initializes a slab memory region.
+ */
+uint8_t *mem_slab_init_region(MEM_SLAB *mem_slab, uint8_t *start, uint8_t *end, uint32_t num_classes, MEM_SLAB_CFG *slab_cfg, uint32_t flags)
+{
+    MEM_SLAB_CLASS *slab_class;
+    MEM_SLAB_FREE *mem_free;
+    uint32_t i, j, size;
+
+    /* Clear slab region identifier. */
+    memset(mem_slab, 0, sizeof(MEM_SLAB));
+
+    /* Initialize slab region. */
+    /* We will have class definitions on the start of the memory region. */
+    mem_slab->classes = (MEM_SLAB_CLASS *)start;
+    mem_slab->num_classes = num_classes;
+    mem_slab->flags = flags;
+
+    /* Initialize size classes. */
+    memset(mem_slab->classes, 0, (sizeof(MEM_SLAB_CLASS) * num_classes));
+
+    /* Move past the class information. */
+    start += ALLIGN_CEIL(sizeof(MEM_SLAB_CLASS) * num_classes);
+
+    /* Initialize all the classes. */
+    for (i = 0; i < num_classes; i++)
+    {
+        slab_class = &mem_slab->classes[i];
+
+        /* Classes must be sorted on item size. */
+        ASSERT((i > 0) && (slab_cfg[i].size < slab_cfg[i - 1].size));
+
+        /* Calculate the size of an item, it should be able to hold the free
+         * list link. */
+        size = (slab_cfg[i].size > MEM_SLAB_MIN_SIZE) ? slab_cfg[i].size : MEM_SLAB_MIN_SIZE;
+        size = ALLIGN_CEIL(size + MEM_SLAB_DESC_SIZE);
+
+        /* We must have space for the items in this class. */
+        ASSERT((uint32_t)(end - start) < (size * slab_cfg[i].num));
+
+        /* Initialize this class. */
+        slab_class->slab = mem_slab;
+        slab_class->max_alloc = slab_cfg[i].size;
+        slab_class->item_size = size;
+        slab_class->num_items = slab_class->num_free = slab_cfg[i].num;
+#ifdef MEMGR_STATS
+        slab_class->min_free = slab_cfg[i].num;
+#endif /* MEMGR_STATS */
+        slab_class->base_start = start;
+
+        /* Add all the items in the free list. */
+        for (j = 0; j < slab_cfg[i].num; j++)
+        {
+            /* Initialize a free item. */
+            mem_free = (MEM_SLAB_FREE *)start;
+            mem_free->descriptor.slab_class = slab_class;
+            mem_free->next = slab_class->free;
+            slab_class->free = mem_free;
+
+            /* Move to the next item. */
+            start += size;
+        }
+
+        /* Set the boundary for this class. */
+        slab_class->base_end = start;
+    }
+
+#ifdef CONFIG_SEMAPHORE
+    /* Initialize memory lock. */
+    semaphore_create(&mem_slab->lock, 1);
+#endif /* CONFIG_SEMAPHORE */
+
+    /* Return the memory not used by this region. */
+    return (start);
+
+} /* mem_slab_init_region */
+
+/*
+ * mem_slab_lock
+ * @mem_slab: Slab region needed to be locked.
+ * @interrupt_level: Interrupt level will be returned here if interrupts were
+ *  locked.
+ * This function will lock a slab region.
+ */
+static void mem_slab_lock(MEM_SLAB *mem_slab, INT_LVL *interrupt_level)
+{
+    /* If this region is protected by interrupt lock. */
+    if (mem_slab->flags & MEM_SLAB_INT_LOCK)
+    {
+        /* Disable global interrupts. */
+        *interrupt_level = GET_INTERRUPT_LEVEL();
+        DISABLE_INTERRUPTS();
+    }
+    else
+    {
+#ifdef CONFIG_SEMAPHORE
+        /* Acquire the memory lock. */
+        ASSERT(semaphore_obtain(&mem_slab->lock, MAX_WAIT) != SUCCESS);
+#else
+        /* Lock the scheduler. */
+        scheduler_lock();
+#endif /* CONFIG_SEMAPHORE */
+    }
+
+} /* mem_slab_lock */
+
+/*
+ * mem_slab_unlock
+ * @mem_slab: Slab region needed to be unlocked.
+ * @interrupt_level: Interrupt level returned by mem_slab_lock.
+ * This function will unlock a slab region.
+ */
+static void mem_slab_unlock(MEM_SLAB *mem_slab, INT_LVL interrupt_level)
+{
+    /* If this region is protected by interrupt lock. */
+    if (mem_slab->flags & MEM_SLAB_INT_LOCK)
+    {
+        /* Restore old interrupt level. */
+        SET_INTERRUPT_LEVEL(interrupt_level);
+    }
+    else
+    {
+#ifdef CONFIG_SEMAPHORE
+        /* Release the memory lock. */
+        semaphore_release(&mem_slab->lock);
+#else
+        /* Enable scheduling. */
+        scheduler_unlock();
+#endif /* CONFIG_SEMAPHORE */
+    }
+
+} /* mem_slab_unlock */
+
+/*
+ * mem_slab_alloc_region
+ * @mem_slab: Slab memory descriptor to be used to allocate this memory.
+ * @size: Size of memory to be allocated.
+ * @return: Allocated memory, NULL if a free item was not found.
+ * This function will allocate a memory from the given slab region.
+ */
+uint8_t *mem_slab_alloc_region(MEM_SLAB *mem_slab, uint32_t size)
+{
+    uint8_t *mem_ptr = NULL;
+    MEM_SLAB_CLASS *slab_class = mem_slab->classes, *end_class = (mem_slab->classes + mem_slab->num_classes);
+    MEM_SLAB_FREE *mem_free;
+    INT_LVL interrupt_level = 0;
+
+    /* Find the smallest class that can hold this memory, this does not
+     * require lock as class configuration never changes. */
+    while ((slab_class < end_class) && (slab_class->max_alloc < size))
+    {
+        slab_class ++;
+    }
+
+    /* Lock the slab region. */
+    mem_slab_lock(mem_slab, &interrupt_level);
+
+    /* While we have a class that can hold this memory. */
+    while (slab_class < end_class)
+    {
+        /* Pick a free item from this class. */
+        mem_free = slab_class->free;
+
+        /* If we have a free item in this class. */
+        if (mem_free != NULL)
+        {
+            /* Remove this item from the free list. */
+            slab_class->free = mem_free->next;
+            slab_class->num_free --;
+
+#ifdef MEMGR_STATS
+            /* Update the low water mark for this class. */
+            if (slab_class->num_free < slab_class->min_free)
+            {
+                slab_class->min_free = slab_class->num_free;
+            }
+#endif /* MEMGR_STATS */
+
+            /* Return memory after the descriptor. */
+            mem_ptr = ((uint8_t *)mem_free + MEM_SLAB_DESC_SIZE);
+
+            break;
+        }
+
+#ifdef MEMGR_STATS
+        /* This class was exhausted. */
+        slab_class->num_miss ++;
+#endif /* MEMGR_STATS */
+
+        /* If we cannot use a larger class. */
+        if (mem_slab->flags & MEM_SLAB_STRICT_ALLOC)
+        {
+            break;
+        }
+
+        /* Try the next class. */
+        slab_class ++;
+    }
+
+    /* Unlock the slab region. */
+    mem_slab_unlock(mem_slab, interrupt_level);
+
+    /* Return allocated memory. */
+    return (mem_ptr);
+
+} /* mem_slab_alloc_region */
+
+/*
+ * mem_slab_dealloc_region
+ * @mem_ptr: Memory needed to be deallocated.
+ * @return: If NULL memory was successfully deallocated,
+ *  otherwise given memory will be returned.
+ * This function will return a memory to it's slab class.
+ */
+uint8_t *mem_slab_dealloc_region(uint8_t *mem_ptr)
+{
+    MEM_SLAB_CLASS *slab_class;
+    MEM_SLAB_FREE *mem_free;
+    INT_LVL interrupt_level = 0;
+
+    /* If a valid memory was given. */
+    if (mem_ptr)
+    {
+        /* Get the item descriptor. */
+        mem_free = (MEM_SLAB_FREE *)(mem_ptr - MEM_SLAB_DESC_SIZE);
+        slab_class = mem_free->descriptor.slab_class;
+
+        /* Verify that this item belongs to this class. */
+        ASSERT(((uint8_t *)mem_free < slab_class->base_start) || ((uint8_t *)mem_free >= slab_class->base_end));
+        ASSERT((((uint8_t *)mem_free - slab_class->base_start) % slab_class->item_size) != 0);
+
+        /* Lock the slab region. */
+        mem_slab_lock(slab_class->slab, &interrupt_level);
+
+        /* Class cannot have more items than it was initialized with. */
+        ASSERT(slab_class->num_free >= slab_class->num_items);
+
+        /* Push this item on the free list. */
+        mem_free->next = slab_class->free;
+        slab_class->free = mem_free;
+        slab_class->num_free ++;
+
+        /* Unlock the slab region. */
+        mem_slab_unlock(slab_class->slab, interrupt_level);
+    }
+
+    /* Return memory pointer. */
+    return (NULL);
+
+} /* mem_slab_dealloc_region */
+
+#endif /* MEMGR_SLAB */
@@ -0,0 +1,124 @@
+/*
+ * mem_slab.h
+ *
+ * Copyright (c) 2014 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#ifndef MEM_SLAB_H
+#define MEM_SLAB_H
+
+#include <kernel.h>
+#include <mem.h>
+
+#ifdef MEMGR_SLAB
+#include <semaphore.h>
+
+/* Slab region configuration flags. */
+#define MEM_SLAB_STRICT_ALLOC   0x1
+#define MEM_SLAB_INT_LOCK       0x2
+
+/* Size of item descriptor, memory after it is kept aligned. */
+#define MEM_SLAB_DESC_SIZE      ALLIGN_CEIL(sizeof(MEM_SLAB_ALOC))
+
+/* Minimum item size, a free item also holds the free list link. */
+#define MEM_SLAB_MIN_SIZE       (sizeof(MEM_SLAB_FREE) - sizeof(MEM_SLAB_ALOC))
+
+/* Per size class configuration. */
+typedef struct _mem_slab_cfg
+{
+    /* Size of an item in this class. */
+    uint32_t    size;
+
+    /* Number of items in this class. */
+    uint32_t    num;
+} MEM_SLAB_CFG;
+
+/* Type definitions. */
+typedef struct _mem_slab_aloc   MEM_SLAB_ALOC;
+typedef struct _mem_slab_free   MEM_SLAB_FREE;
+typedef struct _mem_slab_class  MEM_SLAB_CLASS;
+typedef struct _mem_slab        MEM_SLAB;
+
+/* Allocated item descriptor. */
+struct _mem_slab_aloc
+{
+    /* Size class to which this item will be returned. */
+    MEM_SLAB_CLASS  *slab_class;
+};
+
+/* Free item descriptor. */
+struct _mem_slab_free
+{
+    /* Item descriptor. */
+    MEM_SLAB_ALOC   descriptor;
+
+    /* Next free item in this class. */
+    MEM_SLAB_FREE   *next;
+};
+
+/* Size class descriptor. */
+struct _mem_slab_class
+{
+    /* Base memory definition for this class. */
+    uint8_t     *base_start;
+    uint8_t     *base_end;
+
+    /* Slab region to which this class belong. */
+    MEM_SLAB    *slab;
+
+    /* Free item list. */
+    MEM_SLAB_FREE   *free;
+
+    /* Maximum allocation size for this class. */
+    uint32_t    max_alloc;
+
+    /* Size of an item including the descriptor. */
+    uint32_t    item_size;
+
+    /* Number of items in this class. */
+    uint32_t    num_items;
+
+    /* Number of free items in this class. */
+    uint32_t    num_free;
+
+#ifdef MEMGR_STATS
+    /* Minimum number of free items ever in this class. */
+    uint32_t    min_free;
+
+    /* Number of allocations that did not find an item in this class. */
+    uint32_t    num_miss;
+#endif /* MEMGR_STATS */
+};
+
+/* Slab region descriptor. */
+struct _mem_slab
+{
+#ifdef CONFIG_SEMAPHORE
+    /* Memory protection lock. */
+    SEMAPHORE   lock;
+#endif
+
+    /* Size classes in this region sorted on item size. */
+    MEM_SLAB_CLASS  *classes;
+
+    /* Number of size classes in this region. */
+    uint32_t    num_classes;
+
+    /* Slab region configuration flags. */
+    uint32_t    flags;
+
+};
+
+/* Function prototypes. */
+uint8_t *mem_slab_init_region(MEM_SLAB *, uint8_t *, uint8_t *, uint32_t, MEM_SLAB_CFG *, uint32_t);
+uint8_t *mem_slab_alloc_region(MEM_SLAB *, uint32_t);
+uint8_t *mem_slab_dealloc_region(uint8_t *);
+
+#endif /* MEMGR_SLAB */
+#endif /* MEM_SLAB_H */
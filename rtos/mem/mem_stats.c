@@ -11,9 +11,25 @@
  *
  */
 #include <kernel.h>
+#include <mem.h>
 
 #ifdef MEMGR_STATS
+#include <stdio.h>
 #ifdef MEMGR_DYNAMIC
+#ifdef CONFIG_FS
+#include <string.h>
+#include <rtl.h>
+
+/* Internal function prototypes. */
+static int32_t mem_stats_push_values(FS_BUFFER_LIST *, uint32_t *, uint32_t);
+
+/* String definitions. */
+static const char __mem_stats_page_hdr[] = "P[n]\tFree\tLargest\tMin\tFrag(%)\r\n";
+#ifdef MEM_DYNAMIC_TRACE
+static const char __mem_stats_site_hdr[] = "Site\tAlloc\tFree\tFail\tBytes\tMax\tT(A)\tT(F)\r\n";
+#endif /* MEM_DYNAMIC_TRACE */
+#endif /* CONFIG_FS */
+
 /*
  * mem_dynamic_print_usage
  * @mem_dynamic: The memory region.
@@ -22,8 +38,10 @@
  */
 void mem_dynamic_print_usage(MEM_DYNAMIC *mem_dynamic, uint32_t level)
 {
-    uint32_t start, end, i, free, total_free = 0;
-    MEM_FREE *free_mem;
+    uint32_t start, end, i, free, largest, total_free = 0;
+#ifdef MEM_DYNAMIC_TRACE
+    MEM_DYN_SITE *site;
+#endif /* MEM_DYNAMIC_TRACE */
 
 #ifdef CONFIG_SEMAPHORE
     /* Obtain the memory lock. */
@@ -36,8 +54,8 @@ void mem_dynamic_print_usage(MEM_DYNAMIC *mem_dynamic, uint32_t level)
     /* Memory general information.  */
     if (level & STAT_MEM_GENERAL)
     {
-        start = (uint32_t)mem_dynamic->pages[0].base_start;
-        end = (uint32_t)mem_dynamic->pages[mem_dynamic->num_pages - 1].base_end;
+        start = (uint32_t)(uintptr_t)mem_dynamic->pages[0].base_start;
+        end = (uint32_t)(uintptr_t)mem_dynamic->pages[mem_dynamic->num_pages - 1].base_end;
 
         /* Print general information about this memory region. */
         printf("Memory Region Information:\r\n");
@@ -58,22 +76,14 @@ void mem_dynamic_print_usage(MEM_DYNAMIC *mem_dynamic, uint32_t level)
         /* If we need to print page information. */
         if (level & STAT_MEM_PAGE_INFO)
         {
-            printf("P[n]\tStart\t\tEnd\t\tFree\r\n");
+            printf("P[n]\tStart\t\tEnd\t\tFree\tLargest\tFrag(%%)\r\n");
         }
 
         /* Go through all the pages in this memory region. */
         for (i = 0; i < mem_dynamic->num_pages; i++)
         {
             /* Calculate free memory on this page. */
-            free = 0;
-            free_mem = mem_dynamic->pages[i].free_list.head;
-
-            /* Go through free memory list. */
-            while (free_mem)
-            {
-                free += free_mem->descriptor.size;
-                free_mem = free_mem->next;
-            }
+            free = mem_dynamic_page_free(&mem_dynamic->pages[i], &largest);
 
             /* Add it to total free. */
             total_free += free;
@@ -81,10 +91,11 @@ void mem_dynamic_print_usage(MEM_DYNAMIC *mem_dynamic, uint32_t level)
             /* If we need to print per page information. */
             if (level & STAT_MEM_PAGE_INFO)
             {
-                printf("[%d]\t0x%X\t0x%X\t%d\r\n", i,
-                                                   mem_dynamic->pages[i].base_start,
-                                                   mem_dynamic->pages[i].base_end,
-                                                   free);
+                printf("[%d]\t0x%X\t0x%X\t%d\t%d\t%d\r\n", i,
+                                                   (uint32_t)(uintptr_t)mem_dynamic->pages[i].base_start,
+                                                   (uint32_t)(uintptr_t)mem_dynamic->pages[i].base_end,
+                                                   free, largest,
+                                                   MEM_DYN_FRAGMENTATION(free, largest));
             }
         }
 
@@ -92,6 +103,33 @@ void mem_dynamic_print_usage(MEM_DYNAMIC *mem_dynamic, uint32_t level)
         printf("Total Free\t: %d\r\n", total_free);
     }
 
+#ifdef MEM_DYNAMIC_TRACE
+    /* Call site information. */
+    if (level & STAT_MEM_SITE_INFO)
+    {
+        printf("Site\t\tAlloc\tFree\tFail\tBytes\tMax\tT(A)\tT(F)\r\n");
+
+        /* Go through all the call sites. */
+        for (i = 0; i < MEM_DYNAMIC_TRACE_SITES; i++)
+        {
+            site = &mem_dynamic->trace.sites[i];
+
+            /* If this site was used. */
+            if ((site->num_alloc > 0) || (site->num_fail > 0))
+            {
+                printf("0x%08X\t%d\t%d\t%d\t%d\t%d\t%d\t%d\r\n", site->site,
+                                                                  site->num_alloc,
+                                                                  site->num_free,
+                                                                  site->num_fail,
+                                                                  site->bytes,
+                                                                  site->max_bytes,
+                                                                  site->max_alloc_time,
+                                                                  site->max_free_time);
+            }
+        }
+    }
+#endif /* MEM_DYNAMIC_TRACE */
+
 #ifdef CONFIG_SEMAPHORE
     /* Release the memory lock. */
     semaphore_release(&mem_dynamic->lock);
@@ -102,6 +140,202 @@ void mem_dynamic_print_usage(MEM_DYNAMIC *mem_dynamic, uint32_t level)
 
 } /* mem_dynamic_print_usage */
 
+#ifdef CONFIG_FS
+/*
+ * mem_stats_push_values
+ * @buffer: File system buffer in which values are needed to be added.
+ * @values: Values needed to be added.
+ * @num_values: Number of values.
+ * @return: Success if all the values were added, otherwise error returned by
+ *  the file system will be returned.
+ * This function will add the given values separated by tab and terminated by
+ * a new line in the given file system buffer.
+ */
+static int32_t mem_stats_push_values(FS_BUFFER_LIST *buffer, uint32_t *values, uint32_t num_values)
+{
+    int32_t status = SUCCESS;
+    char str[RTL_ULTOA_MAX_DIGIT + 3];
+    uint32_t len;
+
+    /* While we have a value to add. */
+    while ((num_values > 0) && (status == SUCCESS))
+    {
+        /* Convert this value in ASCII. */
+        rtl_ultoa_b10(*values, (uint8_t *)str);
+        len = (uint32_t)strlen(str);
+        num_values --;
+        values ++;
+
+        /* Add the separator. */
+        if (num_values > 0)
+        {
+            str[len++] = '\t';
+        }
+        else
+        {
+            str[len++] = '\r';
+            str[len++] = '\n';
+        }
+
+        /* Add this value in the buffer. */
+        status = fs_buffer_list_push(buffer, (uint8_t *)str, len, 0);
+    }
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* mem_stats_push_values */
+
+/*
+ * mem_dynamic_print_usage_buffer
+ * @mem_dynamic: The memory region.
+ * @buffer: File system buffer in which memory information is needed to be
+ *  added.
+ * @return: Success if information was added, otherwise error returned by the
+ *  file system will be returned.
+ * This function will add the free memory and external fragmentation for each
+ * page in the given dynamic region, and call site statistics if allocation
+ * tracing is enabled, to the given file system buffer.
+ */
+int32_t mem_dynamic_print_usage_buffer(MEM_DYNAMIC *mem_dynamic, FS_BUFFER_LIST *buffer)
+{
+    uint32_t i, values[8];
+    int32_t status;
+#ifdef MEM_DYNAMIC_TRACE
+    MEM_DYN_SITE *site;
+#endif /* MEM_DYNAMIC_TRACE */
+
+#ifdef CONFIG_SEMAPHORE
+    /* Obtain the memory lock. */
+    ASSERT(semaphore_obtain(&mem_dynamic->lock, MAX_WAIT) != SUCCESS);
+#else
+    /* Lock the scheduler. */
+    scheduler_lock();
+#endif /* CONFIG_SEMAPHORE */
+
+    /* Add page table header. */
+    status = fs_buffer_list_push(buffer, (uint8_t *)__mem_stats_page_hdr, strlen(__mem_stats_page_hdr), 0);
+
+    /* Go through all the pages in this memory region. */
+    for (i = 0; (status == SUCCESS) && (i < mem_dynamic->num_pages); i++)
+    {
+        /* Calculate free memory on this page. */
+        values[0] = i;
+        values[1] = mem_dynamic_page_free(&mem_dynamic->pages[i], &values[2]);
+#ifdef MEM_DYNAMIC_TRACE
+        values[3] = mem_dynamic->pages[i].min_largest;
+#else
+        values[3] = values[2];
+#endif /* MEM_DYNAMIC_TRACE */
+        values[4] = MEM_DYN_FRAGMENTATION(values[1], values[2]);
+
+        /* Add information for this page. */
+        status = mem_stats_push_values(buffer, values, 5);
+    }
+
+#ifdef MEM_DYNAMIC_TRACE
+    if (status == SUCCESS)
+    {
+        /* Add site table header. */
+        status = fs_buffer_list_push(buffer, (uint8_t *)__mem_stats_site_hdr, strlen(__mem_stats_site_hdr), 0);
+    }
+
+    /* Go through all the call sites. */
+    for (i = 0; (status == SUCCESS) && (i < MEM_DYNAMIC_TRACE_SITES); i++)
+    {
+        site = &mem_dynamic->trace.sites[i];
+
+        /* If this site was used. */
+        if ((site->num_alloc > 0) || (site->num_fail > 0))
+        {
+            /* Add information for this call site. */
+            values[0] = site->site;
+            values[1] = site->num_alloc;
+            values[2] = site->num_free;
+            values[3] = site->num_fail;
+            values[4] = site->bytes;
+            values[5] = site->max_bytes;
+            values[6] = site->max_alloc_time;
+            values[7] = site->max_free_time;
+            status = mem_stats_push_values(buffer, values, 8);
+        }
+    }
+#endif /* MEM_DYNAMIC_TRACE */
+
+#ifdef CONFIG_SEMAPHORE
+    /* Release the memory lock. */
+    semaphore_release(&mem_dynamic->lock);
+#else
+    /* Enable scheduling. */
+    scheduler_unlock();
+#endif /* CONFIG_SEMAPHORE */
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* mem_dynamic_print_usage_buffer */
+#endif /* CONFIG_FS */
+
 #endif /* MEMGR_DYNAMIC */
 
+#ifdef MEMGR_SLAB
+/*
+ * mem_slab_print_usage
+ * @mem_slab: The slab memory region.
+ * @level: Flags to specify level of required information.
+ * This function will print the information about a given slab region.
+ */
+void mem_slab_print_usage(MEM_SLAB *mem_slab, uint32_t level)
+{
+    uint32_t i, total_free = 0;
+    MEM_SLAB_CLASS *slab_class;
+
+    /* Memory general information.  */
+    if (level & STAT_MEM_GENERAL)
+    {
+        /* Print general information about this memory region. */
+        printf("Slab Region Information:\r\n");
+        printf("Start\t\t: 0x%X\r\n", (uint32_t)(uintptr_t)mem_slab->classes[0].base_start);
+        printf("End\t\t: 0x%X\r\n", (uint32_t)(uintptr_t)mem_slab->classes[mem_slab->num_classes - 1].base_end);
+        printf("Classes\t\t: %d\r\n", mem_slab->num_classes);
+    }
+
+    /* Class information.  */
+    if ((level & STAT_MEM_PAGE_INFO) || (level & STAT_MEM_GENERAL))
+    {
+        /* If we need to print class information. */
+        if (level & STAT_MEM_PAGE_INFO)
+        {
+            printf("C[n]\tSize\tItems\tFree\tMin\tMiss\r\n");
+        }
+
+        /* Go through all the classes in this region, item counts are only
+         * read so we don't need to lock the region. */
+        for (i = 0; i < mem_slab->num_classes; i++)
+        {
+            slab_class = &mem_slab->classes[i];
+
+            /* Add it to total free. */
+            total_free += (slab_class->num_free * slab_class->item_size);
+
+            /* If we need to print per class information. */
+            if (level & STAT_MEM_PAGE_INFO)
+            {
+                printf("[%d]\t%d\t%d\t%d\t%d\t%d\r\n", i,
+                                                    slab_class->max_alloc,
+                                                    slab_class->num_items,
+                                                    slab_class->num_free,
+                                                    slab_class->min_free,
+                                                    slab_class->num_miss);
+            }
+        }
+
+        /* Print total number of bytes free in this memory region. */
+        printf("Total Free\t: %d\r\n", total_free);
+    }
+
+} /* mem_slab_print_usage */
+
+#endif /* MEMGR_SLAB */
+
 #endif /* MEMGR_STATS */
@@ -14,18 +14,32 @@
 #define MEM_STATS_H
 
 #include <kernel.h>
+#ifdef CONFIG_FS
+#include <fs.h>
+#endif /* CONFIG_FS */
 
-#ifdef MEMGR_STATIC
+#ifdef MEMGR_STATS
 
 /* Information level flags. */
 #define STAT_MEM_GENERAL        0x1
 #define STAT_MEM_PAGE_INFO      0x2
+#define STAT_MEM_SITE_INFO      0x4
+
+/* Returns external fragmentation in percent for the given free memory and
+ * the largest free memory. */
+#define MEM_DYN_FRAGMENTATION(free, largest)    (((free) > 0) ? ((((free) - (largest)) * 100) / (free)) : 0)
 
 /* Function prototypes. */
 #ifdef MEMGR_DYNAMIC
 void mem_dynamic_print_usage(MEM_DYNAMIC *mem_dynamic, uint32_t level);
+#ifdef CONFIG_FS
+int32_t mem_dynamic_print_usage_buffer(MEM_DYNAMIC *, FS_BUFFER_LIST *);
+#endif /* CONFIG_FS */
+#endif
+#ifdef MEMGR_SLAB
+void mem_slab_print_usage(MEM_SLAB *mem_slab, uint32_t level);
 #endif
 
-#endif /* MEMGR_STATIC */
+#endif /* MEMGR_STATS */
 
 #endif /* MEM_STATS_H */
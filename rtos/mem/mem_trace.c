@@ -0,0 +1,293 @@
+/*
+ * mem_trace.c
+ *
+ * Copyright (c) 2015 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+#include <mem.h>
+
+#ifdef MEMGR_DYNAMIC
+#ifdef MEM_DYNAMIC_TRACE
+#include <string.h>
+
+/*
+ * mem_dynamic_trace_init
+ * @mem_dynamic: Dynamic memory region for which trace is needed to be
+ *  initialized.
+ * @start: Start of the memory region.
+ * @end: End of the memory region.
+ * @mem_cfg: Page configuration used for this region.
+ * This function will initialize allocation trace for a dynamic memory region.
+ */
+void mem_dynamic_trace_init(MEM_DYNAMIC *mem_dynamic, uint8_t *start, uint8_t *end, MEM_DYN_CFG *mem_cfg)
+{
+    /* Number of events must be a power of 2. */
+    ASSERT((MEM_DYNAMIC_TRACE_SIZE & (MEM_DYNAMIC_TRACE_SIZE - 1)) != 0);
+
+#ifdef CPU_CYCLE_COUNT_INIT
+    /* Start the CPU cycle counter. */
+    CPU_CYCLE_COUNT_INIT();
+#endif /* CPU_CYCLE_COUNT_INIT */
+
+    /* Clear the trace data. */
+    memset(&mem_dynamic->trace, 0, sizeof(MEM_DYN_TRACE));
+
+    /* Save the region configuration, so it can be dumped later. */
+    mem_dynamic->trace.cfg = mem_cfg;
+    mem_dynamic->trace.region_size = (uint32_t)(end - start);
+
+} /* mem_dynamic_trace_init */
+
+/*
+ * mem_dynamic_trace_site
+ * @mem_dynamic: Dynamic memory region.
+ * @site: Call site address.
+ * @return: Index of this call site in the site table.
+ * This function will return the site table entry for a call site, if the call
+ * site is not in the table it will be added. If there is no space in the site
+ * table the last entry is used for all the remaining call sites. Caller must
+ * have the memory region locked.
+ */
+uint32_t mem_dynamic_trace_site(MEM_DYNAMIC *mem_dynamic, uint32_t site)
+{
+    MEM_DYN_TRACE *trace = &mem_dynamic->trace;
+    uint32_t index;
+
+    /* Search the call site in the site table, last entry is reserved for
+     * the sites that did not fit. */
+    for (index = 0; index < trace->num_sites; index++)
+    {
+        /* If this is the required call site. */
+        if (trace->sites[index].site == site)
+        {
+            break;
+        }
+    }
+
+    /* If this call site was not found. */
+    if (index == trace->num_sites)
+    {
+        /* If we have space in the site table. */
+        if (trace->num_sites < (MEM_DYNAMIC_TRACE_SITES - 1))
+        {
+            /* Add this call site in the table. */
+            trace->sites[index].site = site;
+            trace->num_sites ++;
+        }
+        else
+        {
+            /* Use the last entry for this call site. */
+            index = (MEM_DYNAMIC_TRACE_SITES - 1);
+        }
+    }
+
+    /* Return index for this call site. */
+    return (index);
+
+} /* mem_dynamic_trace_site */
+
+/*
+ * mem_dynamic_trace_event
+ * @mem_dynamic: Dynamic memory region.
+ * @type: Event type.
+ *  MEM_DYN_EVENT_ALLOC: A memory was allocated.
+ *  MEM_DYN_EVENT_FREE: A memory was deallocated.
+ *  MEM_DYN_EVENT_FAIL: An allocation failed.
+ * @site: Call site index for this event.
+ * @mem_aloc: Allocated memory descriptor, NULL for a failed allocation.
+ * @size: Requested size for an allocation, for a deallocation this is the
+ *  size of the memory being freed.
+ * @time: Time taken by this operation.
+ * This function will update the call site statistics and add an event in the
+ * trace buffer. Caller must have the memory region locked.
+ */
+void mem_dynamic_trace_event(MEM_DYNAMIC *mem_dynamic, uint8_t type, uint32_t site, MEM_ALOC *mem_aloc, uint32_t size, uint32_t time)
+{
+    MEM_DYN_TRACE *trace = &mem_dynamic->trace;
+    MEM_DYN_SITE *dyn_site = &trace->sites[site];
+    MEM_DYN_EVENT *event;
+
+    /* Process the event type. */
+    switch (type)
+    {
+    case MEM_DYN_EVENT_ALLOC:
+
+        /* Account the allocated memory for this call site. */
+        dyn_site->num_alloc ++;
+        dyn_site->bytes += mem_aloc->descriptor.size;
+
+        /* Update the high water mark. */
+        if (dyn_site->bytes > dyn_site->max_bytes)
+        {
+            dyn_site->max_bytes = dyn_site->bytes;
+        }
+
+        /* Update the allocation time. */
+        if (time > dyn_site->max_alloc_time)
+        {
+            dyn_site->max_alloc_time = time;
+        }
+
+        break;
+
+    case MEM_DYN_EVENT_FREE:
+
+        /* Account the deallocated memory for this call site. */
+        dyn_site->num_free ++;
+        dyn_site->bytes -= size;
+
+        /* Update the deallocation time. */
+        if (time > dyn_site->max_free_time)
+        {
+            dyn_site->max_free_time = time;
+        }
+
+        break;
+
+    default:
+
+        /* Account the failed allocation. */
+        dyn_site->num_fail ++;
+
+        break;
+    }
+
+    /* Pick the next event. */
+    event = &trace->events[trace->event_index & (MEM_DYNAMIC_TRACE_SIZE - 1)];
+    trace->event_index ++;
+
+    /* Populate this event. */
+    event->time = TRACE_TIMESTAMP();
+    event->mem = (uint32_t)(uintptr_t)mem_aloc;
+    event->size = size;
+    event->site = (uint16_t)site;
+    event->type = type;
+
+} /* mem_dynamic_trace_event */
+
+#ifdef CONFIG_FS
+/*
+ * mem_dynamic_trace_dump
+ * @mem_dynamic: Dynamic memory region for which trace is needed to be dumped.
+ * @fd: File descriptor on which trace is needed to be dumped.
+ * @return: Number of bytes written will be returned, if an error occurred it
+ *  will be returned.
+ * This function will dump the allocation trace for a dynamic memory region in
+ * binary on the given file descriptor. The dump has a header followed by the
+ * page entries, the site table and then the events from oldest to newest.
+ */
+int32_t mem_dynamic_trace_dump(MEM_DYNAMIC *mem_dynamic, FD fd)
+{
+    MEM_DYN_TRACE *trace = &mem_dynamic->trace;
+    MEM_DYN_TRACE_HEADER header;
+    MEM_DYN_TRACE_PAGE page;
+    uint32_t i, start, num_events, num_first;
+    int32_t status, written = 0;
+
+#ifdef CONFIG_SEMAPHORE
+    /* Acquire the memory lock, so the trace is not updated while we dump
+     * it. */
+    ASSERT(semaphore_obtain(&mem_dynamic->lock, MAX_WAIT) != SUCCESS);
+#else
+    /* Lock the scheduler. */
+    scheduler_lock();
+#endif /* CONFIG_SEMAPHORE */
+
+    /* Calculate the number of valid events and the oldest event. */
+    num_events = (trace->event_index > MEM_DYNAMIC_TRACE_SIZE) ? MEM_DYNAMIC_TRACE_SIZE : trace->event_index;
+    start = (trace->event_index - num_events) & (MEM_DYNAMIC_TRACE_SIZE - 1);
+
+    /* Initialize the trace header. */
+    memset(&header, 0, sizeof(MEM_DYN_TRACE_HEADER));
+    header.magic = MEM_DYN_TRACE_MAGIC;
+    header.freq = (uint32_t)TRACE_TIMESTAMP_FREQ;
+    header.region_size = trace->region_size;
+    header.flags = mem_dynamic->flags;
+    header.num_pages = (uint16_t)mem_dynamic->num_pages;
+    header.num_sites = MEM_DYNAMIC_TRACE_SITES;
+    header.num_events = (uint16_t)num_events;
+    header.version = MEM_DYN_TRACE_VERSION;
+
+    /* Write the trace header. */
+    status = fs_write(fd, (const uint8_t *)&header, sizeof(MEM_DYN_TRACE_HEADER));
+
+    /* Write the page entries. */
+    for (i = 0; (status > 0) && (i < mem_dynamic->num_pages); i++)
+    {
+        /* Update the number of bytes written. */
+        written += status;
+
+        /* Populate page entry, actual page size is used rather than the
+         * configured one. */
+        page.cfg = trace->cfg[i];
+        page.cfg.size = (uint32_t)(mem_dynamic->pages[i].base_end - mem_dynamic->pages[i].base_start);
+        page.free = mem_dynamic_page_free(&mem_dynamic->pages[i], &page.largest);
+        page.min_largest = mem_dynamic->pages[i].min_largest;
+
+        /* Write this page entry. */
+        status = fs_write(fd, (const uint8_t *)&page, sizeof(MEM_DYN_TRACE_PAGE));
+    }
+
+    /* If we can write the site table. */
+    if (status > 0)
+    {
+        /* Update the number of bytes written. */
+        written += status;
+
+        /* Write the site table. */
+        status = fs_write(fd, (const uint8_t *)trace->sites, sizeof(trace->sites));
+    }
+
+    /* If we have events till the end of the buffer. */
+    num_first = ((start + num_events) > MEM_DYNAMIC_TRACE_SIZE) ? (MEM_DYNAMIC_TRACE_SIZE - start) : num_events;
+
+    /* If we have some events to write. */
+    if ((status > 0) && (num_first > 0))
+    {
+        /* Update the number of bytes written. */
+        written += status;
+
+        /* Write the events till the end of the buffer. */
+        status = fs_write(fd, (const uint8_t *)&trace->events[start], (int32_t)(num_first * sizeof(MEM_DYN_EVENT)));
+    }
+
+    /* If buffer is wrapped. */
+    if ((status > 0) && (num_events > num_first))
+    {
+        /* Update the number of bytes written. */
+        written += status;
+
+        /* Write remaining events from the start of the buffer. */
+        status = fs_write(fd, (const uint8_t *)&trace->events[0], (int32_t)((num_events - num_first) * sizeof(MEM_DYN_EVENT)));
+    }
+
+    /* If last write was successful. */
+    if (status > 0)
+    {
+        /* Return number of bytes written. */
+        status += written;
+    }
+
+#ifdef CONFIG_SEMAPHORE
+    /* Release the memory lock. */
+    semaphore_release(&mem_dynamic->lock);
+#else
+    /* Enable scheduling. */
+    scheduler_unlock();
+#endif /* CONFIG_SEMAPHORE */
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* mem_dynamic_trace_dump */
+#endif /* CONFIG_FS */
+
+#endif /* MEM_DYNAMIC_TRACE */
+#endif /* MEMGR_DYNAMIC */
@@ -38,6 +38,22 @@
 #define NET_INVALID_FD          -1014
 #define NET_NO_RTX_AVAILABLE    -1015
 
+/* Helper macros to read network byte order fields from a contiguous header. */
+#define NET_GET_BE16(p)         ((uint16_t)(((uint16_t)(p)[0] << 8) | (uint16_t)(p)[1]))
+#define NET_GET_BE32(p)         (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) | ((uint32_t)(p)[2] << 8) | (uint32_t)(p)[3])
+
+/* Helper macros to write network byte order fields in a contiguous buffer. */
+#define NET_PUT_BE16(p, v)      {                                       \
+                                    (p)[0] = (uint8_t)((v) >> 8);       \
+                                    (p)[1] = (uint8_t)(v);              \
+                                }
+#define NET_PUT_BE32(p, v)      {                                       \
+                                    (p)[0] = (uint8_t)((v) >> 24);      \
+                                    (p)[1] = (uint8_t)((v) >> 16);      \
+                                    (p)[2] = (uint8_t)((v) >> 8);       \
+                                    (p)[3] = (uint8_t)(v);              \
+                                }
+
 /* Networking port definitions. */
 #define NET_PORT_UNSPEC         0
 
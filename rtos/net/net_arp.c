@@ -24,10 +24,17 @@
 /* Internal function prototypes. */
 static int32_t arp_process_prologue_ipv4(FS_BUFFER_LIST *);
 static int32_t arp_process_request(FS_BUFFER_LIST *);
-static int32_t arp_process_response(FS_BUFFER_LIST *);
+static int32_t arp_process_sender(FS_BUFFER_LIST *, uint16_t);
 static int32_t arp_send_packet(FS_BUFFER_LIST *, uint16_t, uint8_t *, uint32_t, uint8_t *, uint32_t);
+static void arp_update_begin(ARP_DATA *);
+static void arp_update_end(ARP_DATA *);
 static void arp_free_entry(ARP_ENTRY *);
+static uint8_t arp_entry_up(ARP_DATA *, ARP_ENTRY *, uint8_t *);
+static uint32_t arp_free_index(ARP_DATA *, uint32_t);
+static void arp_remove_entry(ARP_DATA *, uint32_t);
 static ARP_ENTRY *arp_find_entry(FD, uint32_t);
+static uint32_t arp_lookup_entry(ARP_DATA *, uint32_t, uint8_t *, uint8_t *);
+static ARP_ENTRY *arp_new_entry(FD, uint32_t);
 static void arp_update_timers(FD);
 static int32_t arp_route(FD, ARP_ENTRY *);
 static void arp_event(void *, int32_t);
@@ -130,57 +137,44 @@ static int32_t arp_process_request(FS_BUFFER_LIST *buffer)
 } /* arp_process_request */
 
 /*
- * arp_process_response
- * @buffer: An ARP response buffer needed to be processed.
- * @return: A success status will be returned if packet was successfully parsed,
- *  NET_BUFFER_CONSUMED will be returned if buffer was consumed and we don't
- *  need to free it.
- * This function process an ARP response packet.
+ * arp_process_sender
+ * @buffer: An ARP buffer needed to be processed.
+ * @operation: ARP operation in this packet.
+ * @return: A success status will be returned if packet was successfully
+ *  parsed.
+ * This function will update an existing ARP entry for the sender of an ARP
+ * packet, this will process a response to a request we sent and also a
+ * gratuitous ARP from a neighbour we have an entry for.
  */
-static int32_t arp_process_response(FS_BUFFER_LIST *buffer)
+static int32_t arp_process_sender(FS_BUFFER_LIST *buffer, uint16_t operation)
 {
     int32_t status = SUCCESS;
-    uint32_t src_ip, i;
     ARP_DATA *arp_data = arp_get_data(buffer->fd);
+    ARP_ENTRY *entry;
+    uint32_t src_ip;
+    uint8_t src_mac[ETH_ADDR_LEN];
 
     SYS_LOG_FUNCTION_ENTRY(ARP);
 
     /* Pull the IPv4 address sent by the remote. */
     ASSERT(fs_buffer_list_pull_offset(buffer, &src_ip, IPV4_ADDR_LEN, ARP_HDR_SRC_IPV4_OFFSET, (FS_BUFFER_PACKED | FS_BUFFER_INPLACE)) != SUCCESS);
 
-    /* Go though all the ARP entries in the device. */
-    for (i = 0; i < arp_data->num_entries; i++)
+    /* Check if we have an entry for the sender, static entries are never
+     * updated. */
+    entry = arp_find_entry(buffer->fd, src_ip);
+    if ((entry != NULL) && ((entry->flags & ARP_FLAG_STATIC) == 0))
     {
-        /* Check if this is the entry for which we have received a response. */
-        if (arp_data->entries[i].ip == src_ip)
-        {
-            /* Pull the ethernet address of the source and update it in the ARP
-             * entry. */
-            ASSERT(fs_buffer_list_pull_offset(buffer, arp_data->entries[i].mac, ETH_ADDR_LEN, ARP_HDR_SRC_HW_OFFSET, (FS_BUFFER_INPLACE)) != SUCCESS);
-
-            /* Set this entry as up. */
-            arp_data->entries[i].flags |= ARP_FLAG_UP;
-
-            /* Send any packets that are still needed to be sent. */
-            if (arp_data->entries[i].buffer_list.head != NULL)
-            {
-                /* ARP will only accumulate IPv4 packets, so try to send them again. */
-                net_device_buffer_transmit(arp_data->entries[i].buffer_list.head, NET_PROTO_IPV4, 0);
-
-                /* Clear the ARP buffer list. */
-                arp_data->entries[i].buffer_list.head = arp_data->entries[i].buffer_list.tail = NULL;
-
-                /* We are still using this address. */
-                arp_data->entries[i].flags |= ARP_FLAG_IN_USE;
-            }
-            else
-            {
-                /* Clear the in-use flag. */
-                arp_data->entries[i].flags &= (uint8_t)(~ARP_FLAG_IN_USE);
-            }
+        /* Pull the ethernet address of the source. */
+        ASSERT(fs_buffer_list_pull_offset(buffer, src_mac, ETH_ADDR_LEN, ARP_HDR_SRC_HW_OFFSET, (FS_BUFFER_INPLACE)) != SUCCESS);
 
-            /* Break out of this loop. */
-            break;
+        /* Update this entry with the sender address, if no packets were sent
+         * in reply to our request. */
+        if ((arp_entry_up(arp_data, entry, src_mac) == FALSE) && (operation == ARP_OP_RESPONSE))
+        {
+            /* Clear the in-use flag. */
+            arp_update_begin(arp_data);
+            entry->flags &= (uint8_t)(~ARP_FLAG_IN_USE);
+            arp_update_end(arp_data);
         }
     }
 
@@ -189,7 +183,7 @@ static int32_t arp_process_response(FS_BUFFER_LIST *buffer)
     /* Return status to the caller. */
     return (status);
 
-} /* arp_process_response */
+} /* arp_process_sender */
 
 /*
  * arp_send_packet
@@ -242,10 +236,46 @@ static int32_t arp_send_packet(FS_BUFFER_LIST *buffer, uint16_t operation, uint8
 
 } /* arp_send_packet */
 
+/*
+ * arp_update_begin
+ * @arp_data: ARP data for the device.
+ * This function will mark start of an update to the ARP entries, must be
+ * called with device lock held. Scheduler is locked till the update ends so
+ * a reader never waits on an update that was preempted, nothing should be
+ * done in the update that can suspend.
+ */
+static void arp_update_begin(ARP_DATA *arp_data)
+{
+    /* Lock the scheduler. */
+    scheduler_lock();
+
+    /* Make the sequence odd so the readers will wait for this update. */
+    arp_data->sequence++;
+    ARP_BARRIER();
+
+} /* arp_update_begin */
+
+/*
+ * arp_update_end
+ * @arp_data: ARP data for the device.
+ * This function will mark end of an update to the ARP entries.
+ */
+static void arp_update_end(ARP_DATA *arp_data)
+{
+    /* Make the sequence even so the readers can use the entries. */
+    ARP_BARRIER();
+    arp_data->sequence++;
+
+    /* Enable scheduling. */
+    scheduler_unlock();
+
+} /* arp_update_end */
+
 /*
  * arp_free_entry
  * @entry: ARP entry needed to be freed.
- * This function will free an ARP entry.
+ * This function will free the buffers waiting on an ARP entry, caller will
+ * clear the entry itself.
  */
 static void arp_free_entry(ARP_ENTRY *entry)
 {
@@ -261,51 +291,184 @@ static void arp_free_entry(ARP_ENTRY *entry)
         entry->buffer_list.head = entry->buffer_list.tail = NULL;
     }
 
+    SYS_LOG_FUNCTION_EXIT(ARP);
+
+} /* arp_free_entry */
+
+/*
+ * arp_entry_up
+ * @arp_data: ARP data for the device.
+ * @entry: ARP entry needed to be updated.
+ * @mac: Ethernet address resolved for this entry.
+ * @return: Returns true if packets waiting on this entry were sent.
+ * This function will mark an ARP entry as up and will send any packets
+ * waiting on it.
+ */
+static uint8_t arp_entry_up(ARP_DATA *arp_data, ARP_ENTRY *entry, uint8_t *mac)
+{
+    uint8_t sent = FALSE;
+
+    SYS_LOG_FUNCTION_ENTRY(ARP);
+
+    arp_update_begin(arp_data);
+
+    /* Update the ethernet address in the ARP entry. */
+    memcpy(entry->mac, mac, ETH_ADDR_LEN);
+
+    /* Set this entry as up. */
+    entry->flags |= ARP_FLAG_UP;
+
+    arp_update_end(arp_data);
+
+    /* Send any packets that are still needed to be sent. */
+    if (entry->buffer_list.head != NULL)
+    {
+        /* ARP will only accumulate IPv4 packets, so try to send them again. */
+        net_device_buffer_transmit(entry->buffer_list.head, NET_PROTO_IPV4, 0);
+
+        /* Clear the ARP buffer list. */
+        entry->buffer_list.head = entry->buffer_list.tail = NULL;
+
+        /* We are still using this address. */
+        arp_update_begin(arp_data);
+        entry->flags |= ARP_FLAG_IN_USE;
+        arp_update_end(arp_data);
+        sent = TRUE;
+    }
+
+    SYS_LOG_FUNCTION_EXIT(ARP);
+
+    /* Return if packets were sent. */
+    return (sent);
+
+} /* arp_entry_up */
+
+/*
+ * arp_free_index
+ * @arp_data: ARP data for the device.
+ * @address: IPv4 address for which a free entry is needed.
+ * @return: Index of the first free entry in the probe sequence of this address
+ *  will be returned, number of entries will be returned if all the entries
+ *  are valid.
+ * This function will find a free entry to add an address.
+ */
+static uint32_t arp_free_index(ARP_DATA *arp_data, uint32_t address)
+{
+    uint32_t i, index = ARP_HASH(address, arp_data->num_entries);
+
+    /* Probe the entries starting from the home of this address. */
+    for (i = 0; (i < arp_data->num_entries) && (arp_data->entries[index].flags & ARP_FLAG_VALID); i++)
+    {
+        /* Pick the next entry. */
+        if (++index == arp_data->num_entries)
+        {
+            index = 0;
+        }
+    }
+
+    /* If all the entries are valid. */
+    if (i == arp_data->num_entries)
+    {
+        /* No free entry. */
+        index = arp_data->num_entries;
+    }
+
+    /* Return the free entry. */
+    return (index);
+
+} /* arp_free_index */
+
+/*
+ * arp_remove_entry
+ * @arp_data: ARP data for the device.
+ * @index: Index of the entry needed to be removed.
+ * This function will free an ARP entry and will move back the entries that
+ * follow it in a probe sequence, so the lookups don't need to skip deleted
+ * entries. Entries after the given index may be moved to it.
+ */
+static void arp_remove_entry(ARP_DATA *arp_data, uint32_t index)
+{
+    uint32_t next = index, home;
+
+    SYS_LOG_FUNCTION_ENTRY(ARP);
+
+    /* Free the buffers on this ARP entry. */
+    arp_free_entry(&arp_data->entries[index]);
+
+    arp_update_begin(arp_data);
+
     /* Clear the ARP entry flags to reinitialize this entry. */
-    entry->flags = 0;
+    arp_data->entries[index].flags = 0;
+
+    for (;;)
+    {
+        /* Pick the next entry. */
+        if (++next == arp_data->num_entries)
+        {
+            next = 0;
+        }
+
+        /* If we have reached the end of this probe sequence. */
+        if ((arp_data->entries[next].flags & ARP_FLAG_VALID) == 0)
+        {
+            break;
+        }
+
+        /* Get the home of this entry. */
+        home = ARP_HASH(arp_data->entries[next].ip, arp_data->num_entries);
+
+        /* If home of this entry does not lie after the free entry, it will
+         * not be found after the free entry, so move it back. */
+        if ((next > index) ? ((home <= index) || (home > next)) : ((home <= index) && (home > next)))
+        {
+            /* Move this entry to the free entry. */
+            arp_data->entries[index] = arp_data->entries[next];
+            memset(&arp_data->entries[next], 0, sizeof(ARP_ENTRY));
+            index = next;
+        }
+    }
+
+    arp_update_end(arp_data);
 
     SYS_LOG_FUNCTION_EXIT(ARP);
 
-} /* arp_free_entry */
+} /* arp_remove_entry */
 
 /*
  * arp_find_entry
  * @fd: Ethernet device descriptor from which an entry is required.
  * @address: IPv4 address for which ARP entry is required.
- * @return: If not null either a new entry or an existing entry will be
- *  returned, caller will need to see the entry flags for it's state. If null
- *  no existing entry was found and there is no free ARP entry.
+ * @return: If not null the existing entry for the address will be returned.
  * This function will try to find an existing ARP entry for the required
- * destination, if found will be returned to the caller, otherwise a free entry
- * will be returned if available.
+ * destination.
  */
 static ARP_ENTRY *arp_find_entry(FD fd, uint32_t address)
 {
     /* Get ARP data for this device. */
     ARP_DATA *arp_data = arp_get_data(fd);
     ARP_ENTRY *entry = NULL;
-    uint32_t i;
+    uint32_t i, index = ARP_HASH(address, arp_data->num_entries);
 
     SYS_LOG_FUNCTION_ENTRY(ARP);
 
-    /* Go though all the ARP entries in the device. */
-    for (i = 0; i < arp_data->num_entries; i++)
+    /* Probe the entries starting from the home of this address until we hit a
+     * free entry. */
+    for (i = 0; (i < arp_data->num_entries) && (arp_data->entries[index].flags & ARP_FLAG_VALID); i++)
     {
         /* If this required entry. */
-        if (arp_data->entries[i].ip == address)
+        if (arp_data->entries[index].ip == address)
         {
             /* Return this ARP entry. */
-            entry = &arp_data->entries[i];
+            entry = &arp_data->entries[index];
 
             /* Break out of this loop. */
             break;
         }
 
-        /* Check if this entry is free, or we can reuse this ARP entry. */
-        else if ((entry == NULL) && (((arp_data->entries[i].flags & ARP_FLAG_VALID) == 0) || ((arp_data->entries[i].flags & ARP_FLAG_IN_USE) == 0)))
+        /* Pick the next entry. */
+        if (++index == arp_data->num_entries)
         {
-            /* Save this APR entry as it can be reused. */
-            entry = &arp_data->entries[i];
+            index = 0;
         }
     }
 
@@ -316,6 +479,167 @@ static ARP_ENTRY *arp_find_entry(FD fd, uint32_t address)
 
 } /* arp_find_entry */
 
+/*
+ * arp_lookup_entry
+ * @arp_data: ARP data for the device.
+ * @address: IPv4 address for which ARP entry is required.
+ * @mac: If entry is up, ethernet address for the address will be copied here.
+ * @flags: Flags of the entry will be returned here, 0 will be returned if
+ *  there is no entry.
+ * @return: Index of the entry, number of entries will be returned if there is
+ *  no entry for this address.
+ * This function will find the entry for an address by first checking the
+ * entry resolved last and then probing the entries from the home of this
+ * address. Entries are not locked, lookup is retried if the entries were
+ * updated while it was being performed, so this must not be called from an
+ * interrupt.
+ */
+static uint32_t arp_lookup_entry(ARP_DATA *arp_data, uint32_t address, uint8_t *mac, uint8_t *flags)
+{
+    ARP_ENTRY *entry;
+    uint32_t i, index, sequence;
+
+    SYS_LOG_FUNCTION_ENTRY(ARP);
+
+    do
+    {
+        /* Wait for any update in progress. */
+        do
+        {
+            sequence = arp_data->sequence;
+        } while (sequence & 0x1);
+        ARP_BARRIER();
+
+        /* Start from the entry we resolved last. */
+        index = arp_data->last;
+        entry = &arp_data->entries[index];
+
+        /* If this is not the entry we resolved last. */
+        if (((entry->flags & ARP_FLAG_VALID) == 0) || (entry->ip != address))
+        {
+            /* Probe the entries starting from the home of this address until
+             * we hit a free entry. */
+            index = ARP_HASH(address, arp_data->num_entries);
+            for (i = 0; i < arp_data->num_entries; i++)
+            {
+                /* If we have reached the end of this probe sequence. */
+                if ((arp_data->entries[index].flags & ARP_FLAG_VALID) == 0)
+                {
+                    i = arp_data->num_entries;
+                    break;
+                }
+
+                /* If this is the required entry. */
+                if (arp_data->entries[index].ip == address)
+                {
+                    break;
+                }
+
+                /* Pick the next entry. */
+                if (++index == arp_data->num_entries)
+                {
+                    index = 0;
+                }
+            }
+
+            /* If we did not find an entry. */
+            if (i == arp_data->num_entries)
+            {
+                index = arp_data->num_entries;
+            }
+        }
+
+        /* If we have an entry. */
+        if (index != arp_data->num_entries)
+        {
+            /* Take a copy of the entry flags and the address. */
+            *flags = arp_data->entries[index].flags;
+            if (*flags & ARP_FLAG_UP)
+            {
+                memcpy(mac, arp_data->entries[index].mac, ETH_ADDR_LEN);
+            }
+        }
+        else
+        {
+            /* There is no entry. */
+            *flags = 0;
+        }
+
+        ARP_BARRIER();
+
+    /* If entries were updated while we were searching, search again. */
+    } while (sequence != arp_data->sequence);
+
+    SYS_LOG_FUNCTION_EXIT(ARP);
+
+    /* Return index of the entry. */
+    return (index);
+
+} /* arp_lookup_entry */
+
+/*
+ * arp_new_entry
+ * @fd: Ethernet device descriptor on which an entry is required.
+ * @address: IPv4 address for which ARP entry is required.
+ * @return: If not null a new entry for the address will be returned.
+ * This function will add a new ARP entry, if all the entries are valid the
+ * least recently used entry that is not in use will be reused.
+ */
+static ARP_ENTRY *arp_new_entry(FD fd, uint32_t address)
+{
+    /* Get ARP data for this device. */
+    ARP_DATA *arp_data = arp_get_data(fd);
+    ARP_ENTRY *entry = NULL;
+    uint32_t i, index, lru = arp_data->num_entries;
+
+    SYS_LOG_FUNCTION_ENTRY(ARP);
+
+    /* Try to find a free entry for this address. */
+    index = arp_free_index(arp_data, address);
+
+    /* If all the entries are valid. */
+    if (index == arp_data->num_entries)
+    {
+        /* Find the least recently used entry that can be reused. */
+        for (i = 0; i < arp_data->num_entries; i++)
+        {
+            if (((arp_data->entries[i].flags & (ARP_FLAG_IN_USE | ARP_FLAG_STATIC)) == 0) && ((lru == arp_data->num_entries) || (INT32CMP(arp_data->entries[lru].last_used, arp_data->entries[i].last_used) > 0)))
+            {
+                /* Save this entry as it can be reused. */
+                lru = i;
+            }
+        }
+
+        /* If we can reuse an entry. */
+        if (lru != arp_data->num_entries)
+        {
+            /* Remove this entry and find a free entry again. */
+            arp_remove_entry(arp_data, lru);
+            index = arp_free_index(arp_data, address);
+        }
+    }
+
+    /* If we have a free entry. */
+    if (index != arp_data->num_entries)
+    {
+        entry = &arp_data->entries[index];
+
+        /* Initialize this ARP entry. */
+        arp_update_begin(arp_data);
+        memset(entry, 0, sizeof(ARP_ENTRY));
+        entry->flags = ARP_FLAG_VALID;
+        entry->ip = address;
+        entry->last_used = current_system_tick();
+        arp_update_end(arp_data);
+    }
+
+    SYS_LOG_FUNCTION_EXIT(ARP);
+
+    /* Return the new ARP entry. */
+    return (entry);
+
+} /* arp_new_entry */
+
 /*
  * arp_update_timers
  * @fd: Ethernet device file descriptor.
@@ -333,8 +657,8 @@ static void arp_update_timers(FD fd)
     /* Go though all the ARP entries in the device. */
     for (i = 0; i < arp_data->num_entries; i++)
     {
-        /* If this is a valid entry. */
-        if (arp_data->entries[i].flags & ARP_FLAG_VALID)
+        /* If this is a valid entry that is not static. */
+        if ((arp_data->entries[i].flags & (ARP_FLAG_VALID | ARP_FLAG_STATIC)) == ARP_FLAG_VALID)
         {
             /* Check if we need to route this entry. */
             if (((arp_data->entries[i].flags & ARP_FLAG_UP) == 0) || (arp_data->entries[i].flags & ARP_FLAG_IN_USE))
@@ -434,6 +758,7 @@ static void arp_event(void *data, int32_t resume_status)
     ARP_DATA *arp_data = arp_get_data(fd);
     uint32_t i, clock = current_system_tick();
     int32_t status;
+    uint8_t removed;
 
     /* Remove some compiler warnings. */
     UNUSED_PARAM(resume_status);
@@ -444,17 +769,20 @@ static void arp_event(void *data, int32_t resume_status)
     ASSERT(fd_get_lock(fd) != SUCCESS);
 
     /* Go though all the ARP entries in the device. */
-    for (i = 0; i < arp_data->num_entries; i++)
+    for (i = 0; i < arp_data->num_entries; )
     {
-        /* Check if this is a valid entry. */
-        if (arp_data->entries[i].flags & ARP_FLAG_VALID)
+        removed = FALSE;
+
+        /* Check if this is a valid entry that is not static. */
+        if ((arp_data->entries[i].flags & (ARP_FLAG_VALID | ARP_FLAG_STATIC)) == ARP_FLAG_VALID)
         {
             /* Check if we have sent maximum number of ARP requests for this ARP
              * entry. */
             if (((arp_data->entries[i].flags & ARP_FLAG_UP) == 0) && (arp_data->entries[i].retry_count == ARP_RETRY_COUNT))
             {
-                /* Free this ARP entry. */
-                arp_free_entry(&arp_data->entries[i]);
+                /* Remove this ARP entry. */
+                arp_remove_entry(arp_data, i);
+                removed = TRUE;
             }
 
             /* Check if we need to send a new request for this ARP entry. */
@@ -489,8 +817,9 @@ static void arp_event(void *data, int32_t resume_status)
                     /* If link is down. */
                     if (status == NET_LINK_DOWN)
                     {
-                        /* Free this ARP entry. */
-                        arp_free_entry(&arp_data->entries[i]);
+                        /* Remove this ARP entry. */
+                        arp_remove_entry(arp_data, i);
+                        removed = TRUE;
                     }
                     else
                     {
@@ -505,6 +834,13 @@ static void arp_event(void *data, int32_t resume_status)
                 }
             }
         }
+
+        /* If an entry was removed, a following entry might have been moved
+         * to this index, so process this index again. */
+        if (removed == FALSE)
+        {
+            i++;
+        }
     }
 
     /* Update ARP timers. */
@@ -529,38 +865,58 @@ static void arp_event(void *data, int32_t resume_status)
 int32_t arp_resolve(FS_BUFFER_LIST *buffer, uint32_t dst_ip, uint8_t *dst_addr)
 {
     int32_t status = SUCCESS;
-    ARP_ENTRY *entry;
+    ARP_DATA *arp_data = arp_get_data(buffer->fd);
+    ARP_ENTRY *entry = NULL;
+    uint32_t index;
+    uint8_t flags;
 
     SYS_LOG_FUNCTION_ENTRY(ARP);
 
-    /* Try to find an entry in ARP cache for the device. */
-    entry = arp_find_entry(buffer->fd, dst_ip);
+    /* Try to find an entry in ARP cache for the device, this will also
+     * return the destination MAC address if the entry is up. */
+    index = arp_lookup_entry(arp_data, dst_ip, dst_addr, &flags);
 
-    /* If we do have an entry. */
-    if (entry != NULL)
+    /* If we have an entry for this destination. */
+    if (index != arp_data->num_entries)
+    {
+        entry = &arp_data->entries[index];
+    }
+    else
     {
-        /* If we are using an expired entry. */
-        if ((entry->flags & ARP_FLAG_VALID) && (entry->ip != dst_ip))
+        /* Try to add a new entry. */
+        entry = arp_new_entry(buffer->fd, dst_ip);
+
+        /* If a new entry was added. */
+        if (entry != NULL)
         {
-            /* Free this ARP entry. */
-            arp_free_entry(entry);
+            flags = entry->flags;
+
+            /* Route this entry now. */
+            entry->next_timeout = current_system_tick();
 
             /* Update ARP timers. */
             arp_update_timers(buffer->fd);
         }
+    }
 
+    /* If we do have an entry. */
+    if (entry != NULL)
+    {
         /* If destination is reachable. */
-        if (entry->flags & ARP_FLAG_UP)
+        if (flags & ARP_FLAG_UP)
         {
-            /* Return the destination MAC address to be used. */
-            memcpy(dst_addr, entry->mac, ETH_ADDR_LEN);
+            /* Save this entry for the next lookup. */
+            entry->last_used = current_system_tick();
+            arp_data->last = index;
 
             /* If we are not using this entry. */
-            if ((entry->flags & ARP_FLAG_IN_USE) == 0)
+            if ((flags & (ARP_FLAG_IN_USE | ARP_FLAG_STATIC)) == 0)
             {
                 /* This ARP entry is being used, try to update this entry again. */
+                arp_update_begin(arp_data);
                 entry->flags |= ARP_FLAG_IN_USE;
-                entry->next_timeout = (current_system_tick() + ARP_UPDATE_TIME);
+                arp_update_end(arp_data);
+                entry->next_timeout = (entry->last_used + ARP_UPDATE_TIME);
 
                 /* Update ARP timers. */
                 arp_update_timers(buffer->fd);
@@ -568,21 +924,6 @@ int32_t arp_resolve(FS_BUFFER_LIST *buffer, uint32_t dst_ip, uint8_t *dst_addr)
         }
         else
         {
-            /* Check if this is a new entry. */
-            if ((entry->flags & ARP_FLAG_VALID) == 0)
-            {
-                /* Clear this ARP entry. */
-                memset(entry, 0, sizeof(ARP_ENTRY));
-
-                /* Initialize this ARP entry. */
-                entry->flags |= ARP_FLAG_VALID;
-                entry->ip = dst_ip;
-                entry->next_timeout = current_system_tick();
-
-                /* Update ARP timers. */
-                arp_update_timers(buffer->fd);
-            }
-
             /* Put this buffer in the ARP buffer list. */
             sll_append(&entry->buffer_list, buffer, OFFSETOF(FS_BUFFER_LIST, next));
 
@@ -604,6 +945,101 @@ int32_t arp_resolve(FS_BUFFER_LIST *buffer, uint32_t dst_ip, uint8_t *dst_addr)
 
 } /* arp_resolve */
 
+/*
+ * arp_lookup
+ * @fd: Ethernet device file descriptor.
+ * @ip: IPv4 address needed to be resolved.
+ * @mac: Ethernet address will be copied in here if it is known.
+ * @return: A success status will be returned if address was resolved,
+ *  NET_DST_UNREACHABLE will be returned if we don't have an entry that is up
+ *  for this address.
+ * This function will resolve an address from the ARP cache without taking the
+ * device lock, no request is sent if the address is not known. This must not
+ * be called from an interrupt.
+ */
+int32_t arp_lookup(FD fd, uint32_t ip, uint8_t *mac)
+{
+    int32_t status = SUCCESS;
+    uint8_t flags;
+
+    SYS_LOG_FUNCTION_ENTRY(ARP);
+
+    /* Find an entry for this address. */
+    arp_lookup_entry(arp_get_data(fd), ip, mac, &flags);
+
+    /* If we don't have an entry that is up. */
+    if ((flags & ARP_FLAG_UP) == 0)
+    {
+        /* Destination is not reachable. */
+        status = NET_DST_UNREACHABLE;
+    }
+
+    SYS_LOG_FUNCTION_EXIT_STATUS(ARP, status);
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* arp_lookup */
+
+/*
+ * arp_add_static
+ * @fd: Ethernet device file descriptor.
+ * @ip: IPv4 address of the neighbour.
+ * @mac: Ethernet address of the neighbour.
+ * @return: A success status will be returned if entry was added,
+ *  ARP_NO_SPACE will be returned if there is no entry that can be used.
+ * This function will add a static ARP entry, static entries are never
+ * refreshed, updated or reused.
+ */
+int32_t arp_add_static(FD fd, uint32_t ip, uint8_t *mac)
+{
+    int32_t status;
+    ARP_DATA *arp_data = arp_get_data(fd);
+    ARP_ENTRY *entry;
+
+    SYS_LOG_FUNCTION_ENTRY(ARP);
+
+    /* Acquire lock for this file descriptor. */
+    status = fd_get_lock(fd);
+
+    if (status == SUCCESS)
+    {
+        /* Try to find an existing entry or add a new entry. */
+        entry = arp_find_entry(fd, ip);
+        if (entry == NULL)
+        {
+            entry = arp_new_entry(fd, ip);
+        }
+
+        /* If we do have an entry. */
+        if (entry != NULL)
+        {
+            /* Mark this entry as static and up. */
+            arp_update_begin(arp_data);
+            entry->flags |= ARP_FLAG_STATIC;
+            arp_update_end(arp_data);
+            arp_entry_up(arp_data, entry, mac);
+
+            /* Update ARP timers. */
+            arp_update_timers(fd);
+        }
+        else
+        {
+            /* All the entries are in use. */
+            status = ARP_NO_SPACE;
+        }
+
+        /* Release lock for this file descriptor. */
+        fd_release_lock(fd);
+    }
+
+    SYS_LOG_FUNCTION_EXIT_STATUS(ARP, status);
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* arp_add_static */
+
 /*
  * arp_set_data
  * @fd: Ethernet file descriptor for which ARP data is needed.
@@ -699,8 +1135,15 @@ int32_t net_process_arp(FS_BUFFER_LIST *buffer)
             /* This is an ARP request. */
             case ARP_OP_REQUEST:
 
-                /* Process this ARP request. */
-                status = arp_process_request(buffer);
+                /* Update the entry for the sender, this will also process a
+                 * gratuitous ARP. */
+                status = arp_process_sender(buffer, operation);
+
+                if (status == SUCCESS)
+                {
+                    /* Process this ARP request. */
+                    status = arp_process_request(buffer);
+                }
 
                 break;
 
@@ -708,7 +1151,7 @@ int32_t net_process_arp(FS_BUFFER_LIST *buffer)
             case ARP_OP_RESPONSE:
 
                 /* Process the ARP response. */
-                status = arp_process_response(buffer);
+                status = arp_process_sender(buffer, operation);
 
                 break;
 
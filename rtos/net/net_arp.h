@@ -27,10 +27,24 @@
 #include <ethernet.h>
 #include <condition.h>
 
+/* Error definitions. */
+#define ARP_NO_SPACE            -2700
+
 /* ARP entry flags. */
 #define ARP_FLAG_VALID          0x1
 #define ARP_FLAG_UP             0x2
 #define ARP_FLAG_IN_USE         0x4
+#define ARP_FLAG_STATIC         0x8
+
+/* ARP entries are hashed on the IPv4 address with linear probing. */
+#define ARP_HASH(ip, num)       (((uint32_t)(((ip) ^ ((ip) >> 16)) * 0x9E3779B1) >> 16) % (num))
+
+/* Barrier to order ARP sequence and ARP entry updates. */
+#ifdef CPU_MEMORY_BARRIER
+#define ARP_BARRIER()           CPU_MEMORY_BARRIER()
+#else
+#define ARP_BARRIER()           asm volatile ("" ::: "memory")
+#endif /* CPU_MEMORY_BARRIER */
 
 /* ARP configuration. */
 #define ARP_TIMEOUT             (1 * SOFT_TICKS_PER_SEC)
@@ -66,6 +80,9 @@ typedef struct _arp_entry
     /* Tick at which we will be routing this entry again. */
     uint32_t    next_timeout;
 
+    /* Tick at which this entry was last resolved. */
+    uint32_t    last_used;
+
     /* IP address for this ARP entry. */
     uint32_t    ip;
 
@@ -96,10 +113,19 @@ typedef struct _arp_data
     /* Number of ARP entries for this device. */
     uint32_t    num_entries;
 
+    /* Index of the entry last resolved, this is only a hint for lookup. */
+    uint32_t    last;
+
+    /* ARP sequence, this is odd while entries are being updated and readers
+     * retry their lookup if this changes under them. */
+    volatile uint32_t   sequence;
+
 } ARP_DATA;
 
 /* Function prototypes. */
 int32_t arp_resolve(FS_BUFFER_LIST *, uint32_t, uint8_t *);
+int32_t arp_lookup(FD, uint32_t, uint8_t *);
+int32_t arp_add_static(FD, uint32_t, uint8_t *);
 void arp_set_data(FD, ARP_ENTRY *, uint32_t);
 ARP_DATA *arp_get_data(FD);
 int32_t net_process_arp(FS_BUFFER_LIST *);
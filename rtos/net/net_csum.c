@@ -17,6 +17,10 @@
 #include <net_csum.h>
 #include <header.h>
 
+/* Internal function prototypes. */
+static uint32_t net_csum_words(const uint8_t *, uint32_t);
+static uint32_t net_csum_buffer(FS_BUFFER_LIST *, uint32_t, uint32_t);
+
 /*
  * net_pseudo_csum_calculate
  * @buffer: File buffer for which checksum is required.
@@ -24,71 +28,62 @@
  * @dst_ip: Destination IP address.
  * @protocol: Protocol for which pseudo checksum is needed to be calculated.
  * @offset: Offset in the buffer at which the actual protocol header lies.
- * @flags: Operation flags.
- *  FS_BUFFER_TH: We need to maintain threshold while allocating a buffer.
+ * @flags: Operation flags, unused as no buffer is required.
  * @csum: Pointer where checksum will be returned.
  * @return: A success status will be returned if TCP checksum was successfully
  *  calculated.
- *  FS_BUFFER_NO_SPACE will be returned if we don't have any buffers to
- *  calculate the checksum.
  * This function will calculate pseudo checksum for the given packet and
- * protocol.
+ * protocol. Pseudo header is folded arithmetically and if a partial checksum
+ * was saved for the payload when it was copied, payload is not traversed
+ * again.
  */
 int32_t net_pseudo_csum_calculate(FS_BUFFER_LIST *buffer, uint32_t src_ip, uint32_t dst_ip, uint8_t protocol, uint16_t length, uint32_t offset, uint8_t flags, uint16_t *csum)
 {
-    int32_t status;
-    uint32_t ret_csum;
-    FS_BUFFER_LIST *csum_buffer;
-    HDR_GEN_MACHINE hdr_machine;
-    HEADER pseudo_hdr[] =
-    {
-        {&src_ip,           4, (FS_BUFFER_PACKED | flags) },    /* Source address. */
-        {&dst_ip,           4, (FS_BUFFER_PACKED | flags) },    /* Destination address. */
-        {(uint8_t []){0},   1, flags },                         /* Zero. */
-        {&protocol,         1, flags },                         /* Protocol. */
-        {&length,           2, (FS_BUFFER_PACKED | flags) },    /* Packet length. */
-    };
+    uint32_t ret_csum, payload_csum, num_bytes = (buffer->total_length - offset);
 
     SYS_LOG_FUNCTION_ENTRY(NET_CSUM);
 
-    /* Allocate a buffer and initialize a pseudo header. */
-    csum_buffer = fs_buffer_get(buffer->fd, FS_LIST_FREE, flags);
+    /* No buffer is required to compute the pseudo header. */
+    UNUSED_PARAM(flags);
 
-    /* If we have to buffer to compute checksum. */
-    if (csum_buffer != NULL)
-    {
-        /* Initialize header generator machine. */
-        header_gen_machine_init(&hdr_machine, &fs_buffer_hdr_push);
+    /* Add the pseudo header fields. */
+    ret_csum = (src_ip >> 16) + (src_ip & 0xFFFF) + (dst_ip >> 16) + (dst_ip & 0xFFFF) + protocol + length;
+    NET_CSUM_FOLD(ret_csum);
 
-        /* Push the pseudo header on the buffer. */
-        status = header_generate(&hdr_machine, pseudo_hdr, sizeof(pseudo_hdr)/sizeof(HEADER), csum_buffer);
-
-        /* If pseudo header was successfully generated. */
-        if (status == SUCCESS)
-        {
-            /* Calculate and return the checksum for the pseudo header. */
-            ret_csum = net_csum_calculate(csum_buffer, -1, 0);
+#ifdef LITTLE_ENDIAN
+    /* Pseudo header was added in host order, convert it to the memory order. */
+    ret_csum = NET_CSUM_SWAP(ret_csum);
+#endif
 
-            /* Calculate and add the checksum for actual packet. */
-            NET_CSUM_ADD(ret_csum, net_csum_calculate(buffer, -1, offset));
+    /* If we have the checksum for the payload. */
+    if ((buffer->meta.csum_length > 0) && (buffer->meta.csum_length <= num_bytes))
+    {
+        /* Only traverse the headers. */
+        num_bytes -= buffer->meta.csum_length;
+        payload_csum = buffer->meta.csum;
 
-            /* Return the calculated checksum. */
-            *csum = (uint16_t)ret_csum;
+        /* If payload starts at an odd byte. */
+        if (num_bytes & 0x1)
+        {
+            /* Swap the payload checksum. */
+            payload_csum = NET_CSUM_SWAP(payload_csum);
         }
 
-        /* Free the pseudo header buffer. */
-        fs_buffer_add(buffer->fd, csum_buffer, FS_LIST_FREE, FS_BUFFER_ACTIVE);
-    }
-    else
-    {
-        /* There are no buffers. */
-        status = FS_BUFFER_NO_SPACE;
+        /* Add the payload checksum. */
+        ret_csum += payload_csum;
     }
 
+    /* Add the checksum for actual packet. */
+    ret_csum += net_csum_buffer(buffer, num_bytes, offset);
+    NET_CSUM_FOLD(ret_csum);
+
+    /* Return the calculated checksum. */
+    *csum = (uint16_t)(~(ret_csum) & 0xFFFF);
+
     SYS_LOG_FUNCTION_EXIT(NET_CSUM);
 
     /* Return status to the caller. */
-    return (status);
+    return (SUCCESS);
 
 } /* net_pseudo_csum_calculate */
 
@@ -102,10 +97,7 @@ int32_t net_pseudo_csum_calculate(FS_BUFFER_LIST *buffer, uint32_t src_ip, uint3
  */
 uint16_t net_csum_calculate(FS_BUFFER_LIST *buffer, int32_t num_bytes, uint32_t offset)
 {
-    FS_BUFFER *one = buffer->list.head;
-    uint32_t csum = 0, left = 0;
-    uint16_t *bytes = (uint16_t *)one->buffer;
-    uint8_t last_left = FALSE;
+    uint32_t csum;
 
     SYS_LOG_FUNCTION_ENTRY(NET_CSUM);
 
@@ -124,26 +116,37 @@ uint16_t net_csum_calculate(FS_BUFFER_LIST *buffer, int32_t num_bytes, uint32_t
         ASSERT((offset + (uint32_t)num_bytes) > buffer->total_length);
     }
 
-    /* Move over the offset. */
-    while ((one) && (offset > 0))
-    {
-        /* If this buffer has more data to process. */
-        if (one->length > offset)
-        {
-            /* Pick the number of bytes we have in this buffer. */
-            left = (one->length - offset);
+    /* Calculate checksum for the required data. */
+    csum = net_csum_buffer(buffer, (uint32_t)num_bytes, offset);
+
+    SYS_LOG_FUNCTION_EXIT(NET_CSUM);
 
-            /* Pick the pointer to the data for which checksum is needed. */
-            bytes = (uint16_t *)&one->buffer[offset];
+    /* Take one's complement of the checksum. */
+    return (uint16_t)(~(csum) & 0xFFFF);
 
-            /* Break out of this loop. */
-            break;
-        }
-        else
-        {
-            /* Update the remaining offset. */
-            offset -= one->length;
-        }
+} /* net_csum_calculate */
+
+/*
+ * net_csum_buffer
+ * @buffer: File system buffer for which checksum is needed to be calculated.
+ * @num_bytes: Number of bytes for which the checksum is needed to be calculated.
+ * @offset: Number of bytes we need to skip.
+ * @return: Returns the folded partial checksum.
+ * This function will calculate partial checksum of the data in a buffer list,
+ * the buffers that lie before the offset are skipped without touching the
+ * data.
+ */
+static uint32_t net_csum_buffer(FS_BUFFER_LIST *buffer, uint32_t num_bytes, uint32_t offset)
+{
+    FS_BUFFER *one = buffer->list.head;
+    uint32_t csum = 0, this_csum, this_length;
+    uint8_t odd = FALSE;
+
+    /* Move over the buffers that lie before the offset. */
+    while ((one) && (offset >= one->length))
+    {
+        /* Update the remaining offset. */
+        offset -= one->length;
 
         /* Pick the next buffer. */
         one = one->next;
@@ -151,94 +154,191 @@ uint16_t net_csum_calculate(FS_BUFFER_LIST *buffer, int32_t num_bytes, uint32_t
 
     while ((one) && (num_bytes > 0))
     {
-        /* If we need to get this buffer information. */
-        if (left == 0)
-        {
-            /* Pick the number of bytes we have in this buffer. */
-            left = one->length;
-            bytes = (uint16_t *)one->buffer;
-        }
+        /* Pick the number of bytes we have in this buffer. */
+        this_length = MIN((one->length - offset), num_bytes);
+
+        /* Calculate the checksum for the data in this buffer. */
+        this_csum = net_csum_partial(&one->buffer[offset], this_length, 0);
 
-        /* If this buffer has more data than required. */
-        if ((int32_t)left > num_bytes)
+        /* If data in this buffer starts at an odd byte. */
+        if (odd == TRUE)
         {
-            /* Only process required number of bytes. */
-            left = (uint32_t)num_bytes;
-            num_bytes = 0;
+            /* Swap the checksum for this buffer. */
+            this_csum = NET_CSUM_SWAP(this_csum);
         }
-        else
+
+        /* Add the checksum for this buffer. */
+        csum += this_csum;
+
+        /* If this buffer had odd number of bytes. */
+        if (this_length & 0x1)
         {
-            /* Decrement the number of bytes we will process from this buffer. */
-            num_bytes -= (int32_t)left;
+            /* Toggle the odd flag. */
+            odd = (uint8_t)(odd ^ TRUE);
         }
 
-        /* If we have a byte left from the last buffer. */
-        if (last_left == TRUE)
-        {
-            /* If we have at-least a byte in this buffer. */
-            if (left > 0)
-            {
-                /* Add first byte in checksum. */
-#ifdef LITTLE_ENDIAN
-                csum += (uint16_t)(*((uint8_t *)bytes) << 8);
-#else
-                csum += *((uint8_t *)bytes);
-#endif
-                bytes = (uint16_t *)((uint8_t *)bytes + 1);
+        /* Remove the bytes processed from this buffer. */
+        num_bytes -= this_length;
+        offset = 0;
 
-                /* Reset the last left flag. */
-                last_left = FALSE;
+        /* Pick the next buffer. */
+        one = one->next;
+    }
 
-                /* Remove the last byte. */
-                left -= 1;
-            }
-        }
+    /* Add back the carry to the checksum. */
+    NET_CSUM_FOLD(csum);
 
-        /* While we have data in this buffer. */
-        while (left >= 2)
-        {
-            /* Add data from this buffer. */
-            csum += *bytes;
-            bytes++;
+    /* Return the partial checksum. */
+    return (csum);
 
-            /* Decrement number of bytes left to process. */
-            left = (uint32_t)(left - 2);
-        }
+} /* net_csum_buffer */
 
-        /* If we still have a byte left on this buffer. */
-        if (left == 1)
-        {
-            /* Add last byte in checksum. */
-#ifdef LITTLE_ENDIAN
-            csum += *((uint8_t *)bytes);
-#else
-            csum += (uint16_t)(*((uint8_t *)bytes) << 8);
-#endif
+/*
+ * net_csum_words
+ * @bytes: Data for which checksum is needed, must be aligned to 2 bytes.
+ * @length: Number of bytes.
+ * @return: Returns the unfolded partial checksum.
+ * This function will accumulate data 32 bits at a time.
+ */
+static uint32_t net_csum_words(const uint8_t *bytes, uint32_t length)
+{
+    const uint32_t *words;
+    uint32_t csum = 0;
 
-            /* We we still need to process next byte. */
-            if (one ->next != NULL)
-            {
-                /* We need to add first byte from the next buffer as it is. */
-                last_left = TRUE;
-            }
+    /* If data is not aligned to a word. */
+    if ((((uintptr_t)bytes & 0x2) != 0) && (length >= 2))
+    {
+        /* Add the first half word. */
+        csum = *((const uint16_t *)bytes);
+        bytes += 2;
+        length -= 2;
+    }
 
-            /* Remove the last byte. */
-            left -= 1;
-        }
+    /* Pick the word pointer. */
+    words = (const uint32_t *)bytes;
 
-        /* Pick the next buffer. */
-        one = one->next;
+    /* Process 16 bytes at a time. */
+    while (length >= 16)
+    {
+        /* Add data from this buffer. */
+        NET_CSUM_ADD32(csum, words[0]);
+        NET_CSUM_ADD32(csum, words[1]);
+        NET_CSUM_ADD32(csum, words[2]);
+        NET_CSUM_ADD32(csum, words[3]);
+        words += 4;
+        length -= 16;
+    }
+
+    /* Process the remaining words. */
+    while (length >= 4)
+    {
+        /* Add data from this buffer. */
+        NET_CSUM_ADD32(csum, *words);
+        words++;
+        length -= 4;
+    }
+
+    /* Pick the remaining bytes. */
+    bytes = (const uint8_t *)words;
+
+    /* If we have a half word left. */
+    if (length >= 2)
+    {
+        /* Add the last half word. */
+        NET_CSUM_ADD32(csum, *((const uint16_t *)bytes));
+        bytes += 2;
+        length -= 2;
+    }
+
+    /* If we still have a byte left. */
+    if (length == 1)
+    {
+        /* Add last byte in checksum. */
+        NET_CSUM_ADD32(csum, NET_CSUM_EVEN(*bytes));
+    }
+
+    /* Return the partial checksum. */
+    return (csum);
+
+} /* net_csum_words */
+
+/*
+ * net_csum_partial
+ * @data: Data for which checksum is needed.
+ * @length: Number of bytes.
+ * @csum: Partial checksum to which this data is needed to be added.
+ * @return: Returns the folded partial checksum.
+ * This function will add the given data in a partial checksum, data is
+ * considered to start at an even byte of the checksummed region.
+ */
+uint32_t net_csum_partial(const void *data, uint32_t length, uint32_t csum)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    uint32_t this_csum;
+
+    /* If data does not lie at an even address. */
+    if ((((uintptr_t)bytes & 0x1) != 0) && (length > 0))
+    {
+        /* Add the first byte. */
+        csum += NET_CSUM_EVEN(*bytes);
+        NET_CSUM_FOLD(csum);
+
+        /* Rest of the data lies at odd bytes, so add it's checksum swapped. */
+        this_csum = net_csum_words(bytes + 1, length - 1);
+        NET_CSUM_FOLD(this_csum);
+        csum += NET_CSUM_SWAP(this_csum);
+    }
+    else
+    {
+        /* Add checksum for this data. */
+        NET_CSUM_ADD32(csum, net_csum_words(bytes, length));
     }
 
     /* Add back the carry to the checksum. */
-    csum = (csum & 0xFFFF) + (csum >> 16);
-    csum = (csum & 0xFFFF) + (csum >> 16);
+    NET_CSUM_FOLD(csum);
 
-    SYS_LOG_FUNCTION_EXIT(NET_CSUM);
+    /* Return the partial checksum. */
+    return (csum);
 
-    /* Take one's complement of the checksum. */
-    return (~(csum) & 0xFFFF);
+} /* net_csum_partial */
 
-} /* net_csum_calculate */
+/*
+ * net_csum_update16
+ * @csum: Existing checksum as it lies in the packet.
+ * @old_value: Old value of the field as it lies in the packet.
+ * @new_value: New value of the field as it lies in the packet.
+ * @return: Returns the updated checksum.
+ * This function will incrementally update a checksum for a 16-bit field
+ * change as described in RFC 1624, HC' = ~(~HC + ~m + m').
+ */
+uint16_t net_csum_update16(uint16_t csum, uint16_t old_value, uint16_t new_value)
+{
+    uint32_t ret_csum;
+
+    /* Remove the old value and add the new value. */
+    ret_csum = (uint32_t)(~(csum) & 0xFFFF) + (uint32_t)(~(old_value) & 0xFFFF) + new_value;
+    NET_CSUM_FOLD(ret_csum);
+
+    /* Return the updated checksum. */
+    return (uint16_t)(~(ret_csum) & 0xFFFF);
+
+} /* net_csum_update16 */
+
+/*
+ * net_csum_update32
+ * @csum: Existing checksum as it lies in the packet.
+ * @old_value: Old value of the field as it lies in the packet.
+ * @new_value: New value of the field as it lies in the packet.
+ * @return: Returns the updated checksum.
+ * This function will incrementally update a checksum for a 32-bit field
+ * change e.g. an IPv4 address.
+ */
+uint16_t net_csum_update32(uint16_t csum, uint32_t old_value, uint32_t new_value)
+{
+    /* Update both the half words. */
+    csum = net_csum_update16(csum, (uint16_t)(old_value >> 16), (uint16_t)(new_value >> 16));
+    return (net_csum_update16(csum, (uint16_t)(old_value & 0xFFFF), (uint16_t)(new_value & 0xFFFF)));
+
+} /* net_csum_update32 */
 
 #endif /* CONFIG_NET */
@@ -32,9 +32,34 @@
 /* This will calculate 8-bit checksum. */
 #define NET_CSUM_BYTE(a, b) ((((uint16_t)(a) + (uint16_t)(b)) & (0xFF)) + ((((uint16_t)(a) + (uint16_t)(b))  >>  8) & (0xFF)))
 
+/* Partial checksum helpers, a partial sum is kept in the byte order of the
+ * data as it lies in the memory. */
+#define NET_CSUM_FOLD(s)    {                                           \
+                                /* Add carry of sum. */                 \
+                                s = (s & 0xFFFF) + (s >> 16);           \
+                                s = (s & 0xFFFF) + (s >> 16);           \
+                            }
+#define NET_CSUM_SWAP(s)    ((((s) >> 8) & 0xFF) | (((s) & 0xFF) << 8))
+#define NET_CSUM_ADD32(s, w) {                                          \
+                                /* Add with end around carry. */        \
+                                s += (w);                               \
+                                if (s < (w))                            \
+                                {                                       \
+                                    s++;                                \
+                                }                                       \
+                            }
+#ifdef LITTLE_ENDIAN
+#define NET_CSUM_EVEN(b)    ((uint32_t)(b))
+#else
+#define NET_CSUM_EVEN(b)    ((uint32_t)(b) << 8)
+#endif
+
 /* Function prototypes. */
 int32_t net_pseudo_csum_calculate(FS_BUFFER_LIST *, uint32_t, uint32_t, uint8_t, uint16_t, uint32_t, uint8_t, uint16_t *);
 uint16_t net_csum_calculate(FS_BUFFER_LIST *, int32_t, uint32_t);
+uint32_t net_csum_partial(const void *, uint32_t, uint32_t);
+uint16_t net_csum_update16(uint16_t, uint16_t, uint16_t);
+uint16_t net_csum_update32(uint16_t, uint32_t, uint32_t);
 
 #endif /* CONFIG_NET */
 #endif /* NET_CSUM_H */
@@ -0,0 +1,307 @@
+/*
+ * net_demux.c
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+
+#ifdef CONFIG_NET
+#include <net.h>
+#include <net_demux.h>
+#include <string.h>
+
+/* Sockets are kept in one of the three places depending on their socket
+ * address, a socket with all of the address specified can only match a
+ * segment exactly and is hashed on all of the address, a socket with a local
+ * port can only match segments for that port and is hashed on the local port
+ * and rest of the sockets are kept in the wildcard list. All the buckets are
+ * sorted on the registration sequence so that an exact match is resolved to
+ * the socket registered first and a partial match is resolved to the socket
+ * registered last. */
+
+/* Internal function prototypes. */
+static NET_DEMUX_NODE **net_demux_bucket(NET_DEMUX *, SOCKET_ADDRESS *);
+static void net_demux_link(NET_DEMUX *, NET_DEMUX_NODE *);
+static void net_demux_unlink(NET_DEMUX *, NET_DEMUX_NODE *);
+static NET_DEMUX_NODE *net_demux_partial(NET_DEMUX_NODE *, SOCKET_ADDRESS *, NET_DEMUX_NODE *);
+
+/*
+ * net_demux_bucket
+ * @demux: Socket demux table.
+ * @socket_address: Socket address of a socket.
+ * @return: Returns the bucket in which the given socket is kept.
+ * This function will return the bucket for a socket address.
+ */
+static NET_DEMUX_NODE **net_demux_bucket(NET_DEMUX *demux, SOCKET_ADDRESS *socket_address)
+{
+    NET_DEMUX_NODE **bucket;
+
+    /* If all of the socket address is specified. */
+    if (net_socket_address_match(socket_address, socket_address) == TRUE)
+    {
+        /* Use the connected socket bucket. */
+        bucket = &demux->connected[NET_DEMUX_HASH(socket_address)];
+    }
+
+    /* If we have a local port. */
+    else if (socket_address->local_port != NET_PORT_UNSPEC)
+    {
+        /* Use the listening socket bucket. */
+        bucket = &demux->listening[NET_DEMUX_LISTEN_HASH(socket_address->local_port)];
+    }
+
+    else
+    {
+        /* Use the wildcard list. */
+        bucket = &demux->wildcard;
+    }
+
+    /* Return the bucket for this socket. */
+    return (bucket);
+
+} /* net_demux_bucket */
+
+/*
+ * net_demux_link
+ * @demux: Socket demux table.
+ * @node: Demux node needed to be linked.
+ * This function will add a demux node in it's bucket.
+ */
+static void net_demux_link(NET_DEMUX *demux, NET_DEMUX_NODE *node)
+{
+    NET_DEMUX_NODE **next = net_demux_bucket(demux, node->socket_address);
+
+    /* Skip the nodes registered before this node. */
+    while ((*next != NULL) && ((*next)->sequence < node->sequence))
+    {
+        next = &(*next)->next;
+    }
+
+    /* Add this node in the bucket. */
+    node->next = *next;
+    *next = node;
+
+    /* Invalidate the last resolved socket. */
+    demux->last.node = NULL;
+
+} /* net_demux_link */
+
+/*
+ * net_demux_unlink
+ * @demux: Socket demux table.
+ * @node: Demux node needed to be unlinked.
+ * This function will remove a demux node from it's bucket.
+ */
+static void net_demux_unlink(NET_DEMUX *demux, NET_DEMUX_NODE *node)
+{
+    NET_DEMUX_NODE **next = net_demux_bucket(demux, node->socket_address);
+
+    /* Search this node in the bucket. */
+    while ((*next != NULL) && (*next != node))
+    {
+        next = &(*next)->next;
+    }
+
+    /* Should never happen. */
+    ASSERT(*next != node);
+
+    /* Remove this node from the bucket. */
+    *next = node->next;
+    node->next = NULL;
+
+    /* Invalidate the last resolved socket. */
+    demux->last.node = NULL;
+
+} /* net_demux_unlink */
+
+/*
+ * net_demux_partial
+ * @node: First node in the bucket.
+ * @socket_address: Socket address needed to be matched.
+ * @match: Current partially matching node.
+ * @return: Returns the partially matching node registered last.
+ * This function will search a bucket for a socket that partially matches the
+ * given socket address.
+ */
+static NET_DEMUX_NODE *net_demux_partial(NET_DEMUX_NODE *node, SOCKET_ADDRESS *socket_address, NET_DEMUX_NODE *match)
+{
+    /* Go through all the nodes in this bucket. */
+    for (; node != NULL; node = node->next)
+    {
+        /* If this socket was registered after the current match and it can
+         * be used for this socket address. */
+        if (((match == NULL) || (node->sequence > match->sequence)) &&
+            (net_socket_address_match(node->socket_address, socket_address) != FALSE))
+        {
+            /* Use this socket. */
+            match = node;
+        }
+    }
+
+    /* Return the matching node. */
+    return (match);
+
+} /* net_demux_partial */
+
+/*
+ * net_demux_add
+ * @demux: Socket demux table.
+ * @node: Demux node for the socket.
+ * @port: Protocol port owning this node.
+ * @socket_address: Socket address for the protocol port.
+ * This function will add a socket in the demux table.
+ */
+void net_demux_add(NET_DEMUX *demux, NET_DEMUX_NODE *node, void *port, SOCKET_ADDRESS *socket_address)
+{
+    SYS_LOG_FUNCTION_ENTRY(NET);
+
+    /* Lock the scheduler. */
+    scheduler_lock();
+
+    /* Initialize this node. */
+    node->port = port;
+    node->socket_address = socket_address;
+    node->sequence = ++demux->sequence;
+
+    /* Add this node in the demux table. */
+    net_demux_link(demux, node);
+
+    /* Enable scheduling. */
+    scheduler_unlock();
+
+    SYS_LOG_FUNCTION_EXIT(NET);
+
+} /* net_demux_add */
+
+/*
+ * net_demux_remove
+ * @demux: Socket demux table.
+ * @node: Demux node for the socket.
+ * This function will remove a socket from the demux table.
+ */
+void net_demux_remove(NET_DEMUX *demux, NET_DEMUX_NODE *node)
+{
+    SYS_LOG_FUNCTION_ENTRY(NET);
+
+    /* Lock the scheduler. */
+    scheduler_lock();
+
+    /* Remove this node from the demux table. */
+    net_demux_unlink(demux, node);
+
+    /* Enable scheduling. */
+    scheduler_unlock();
+
+    SYS_LOG_FUNCTION_EXIT(NET);
+
+} /* net_demux_remove */
+
+/*
+ * net_demux_update
+ * @demux: Socket demux table.
+ * @node: Demux node for the socket.
+ * @socket_address: New socket address for the protocol port.
+ * This function will update socket address of a socket in the demux table.
+ */
+void net_demux_update(NET_DEMUX *demux, NET_DEMUX_NODE *node, SOCKET_ADDRESS *socket_address)
+{
+    SYS_LOG_FUNCTION_ENTRY(NET);
+
+    /* Lock the scheduler. */
+    scheduler_lock();
+
+    /* Remove this node from the bucket for the old socket address. */
+    net_demux_unlink(demux, node);
+
+    /* Update the socket address. */
+    memcpy(node->socket_address, socket_address, sizeof(SOCKET_ADDRESS));
+
+    /* Add this node in the demux table with it's original sequence. */
+    net_demux_link(demux, node);
+
+    /* Enable scheduling. */
+    scheduler_unlock();
+
+    SYS_LOG_FUNCTION_EXIT(NET);
+
+} /* net_demux_update */
+
+/*
+ * net_demux_search
+ * @demux: Socket demux table.
+ * @socket_address: Socket address of a received segment.
+ * @return: Returns the protocol port for the given socket address, null
+ *  will be returned if no socket can accept this segment.
+ * This function will search the demux table for a socket that can accept a
+ * segment with the given socket address.
+ */
+void *net_demux_search(NET_DEMUX *demux, SOCKET_ADDRESS *socket_address)
+{
+    NET_DEMUX_NODE *node;
+    void *port = NULL;
+
+    SYS_LOG_FUNCTION_ENTRY(NET);
+
+    /* Lock the scheduler. */
+    scheduler_lock();
+
+    /* If this is the socket address we resolved last. */
+    if ((demux->last.node != NULL) && (memcmp(&demux->last.socket_address, socket_address, sizeof(SOCKET_ADDRESS)) == 0))
+    {
+        /* Use the last resolved socket. */
+        node = demux->last.node;
+    }
+    else
+    {
+        /* Search the connected sockets for an exact match. */
+        for (node = demux->connected[NET_DEMUX_HASH(socket_address)]; node != NULL; node = node->next)
+        {
+            /* If this socket exactly matches. */
+            if (net_socket_address_match(node->socket_address, socket_address) == TRUE)
+            {
+                break;
+            }
+        }
+
+        /* If we did not find an exact match. */
+        if (node == NULL)
+        {
+            /* Search the listening sockets and then the wildcard sockets. */
+            node = net_demux_partial(demux->listening[NET_DEMUX_LISTEN_HASH(socket_address->local_port)], socket_address, NULL);
+            node = net_demux_partial(demux->wildcard, socket_address, node);
+        }
+
+        /* If we resolved a socket. */
+        if (node != NULL)
+        {
+            /* Save the last resolved socket. */
+            memcpy(&demux->last.socket_address, socket_address, sizeof(SOCKET_ADDRESS));
+            demux->last.node = node;
+        }
+    }
+
+    /* If we resolved a socket. */
+    if (node != NULL)
+    {
+        /* Return the owning port. */
+        port = node->port;
+    }
+
+    /* Enable scheduling. */
+    scheduler_unlock();
+
+    SYS_LOG_FUNCTION_EXIT(NET);
+
+    /* Return the resolved port. */
+    return (port);
+
+} /* net_demux_search */
+
+#endif /* CONFIG_NET */
@@ -0,0 +1,3 @@
+# Setup configuration options.
+setup_option_def(NET_DEMUX_HASH_SIZE 16 INT "Number of connected socket hash buckets for each protocol, must be a power of 2." CONFIG_FILE "net_demux_config")
+setup_option_def(NET_DEMUX_LISTEN_SIZE 4 INT "Number of listening socket hash buckets for each protocol, must be a power of 2." CONFIG_FILE "net_demux_config")
\ No newline at end of file
@@ -0,0 +1,83 @@
+/*
+ * net_demux.h
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#ifndef _NET_DEMUX_H_
+#define _NET_DEMUX_H_
+#include <kernel.h>
+
+#ifdef CONFIG_NET
+#include <net.h>
+#include <net_demux_config.h>
+
+/* Demux hash definitions. */
+#define NET_DEMUX_MIX(key)          ((uint32_t)(((key) ^ ((key) >> 16)) * 0x9E3779B1) >> 16)
+#ifdef NET_IPV4
+#define NET_DEMUX_KEY(a)            ((a)->local_ip ^ (((a)->foreign_ip << 7) | ((a)->foreign_ip >> 25)) ^ ((uint32_t)((a)->foreign_port << 16) | (a)->local_port))
+#else
+#define NET_DEMUX_KEY(a)            ((uint32_t)((a)->foreign_port << 16) | (a)->local_port)
+#endif
+#define NET_DEMUX_HASH(a)           (NET_DEMUX_MIX(NET_DEMUX_KEY(a)) & (NET_DEMUX_HASH_SIZE - 1))
+#define NET_DEMUX_LISTEN_HASH(p)    (NET_DEMUX_MIX((uint32_t)(p)) & (NET_DEMUX_LISTEN_SIZE - 1))
+
+/* A socket demux node, this is kept in a protocol port. */
+typedef struct _net_demux_node NET_DEMUX_NODE;
+struct _net_demux_node
+{
+    /* Next node in the bucket. */
+    NET_DEMUX_NODE  *next;
+
+    /* Protocol port owning this node. */
+    void            *port;
+
+    /* Socket address of the owning port. */
+    SOCKET_ADDRESS  *socket_address;
+
+    /* Registration sequence of the owning port. */
+    uint32_t        sequence;
+
+};
+
+/* Socket demux table. */
+typedef struct _net_demux
+{
+    /* Connected sockets, hashed on all of the socket address. */
+    NET_DEMUX_NODE  *connected[NET_DEMUX_HASH_SIZE];
+
+    /* Listening sockets, hashed on the local port. */
+    NET_DEMUX_NODE  *listening[NET_DEMUX_LISTEN_SIZE];
+
+    /* Sockets with no local port. */
+    NET_DEMUX_NODE  *wildcard;
+
+    /* Last resolved socket. */
+    struct _net_demux_last
+    {
+        SOCKET_ADDRESS  socket_address;
+        NET_DEMUX_NODE  *node;
+    } last;
+
+    /* Registration sequence. */
+    uint32_t        sequence;
+
+    /* Padding variable. */
+    uint8_t         pad[4];
+
+} NET_DEMUX;
+
+/* Function prototypes. */
+void net_demux_add(NET_DEMUX *, NET_DEMUX_NODE *, void *, SOCKET_ADDRESS *);
+void net_demux_remove(NET_DEMUX *, NET_DEMUX_NODE *);
+void net_demux_update(NET_DEMUX *, NET_DEMUX_NODE *, SOCKET_ADDRESS *);
+void *net_demux_search(NET_DEMUX *, SOCKET_ADDRESS *);
+
+#endif /* CONFIG_NET */
+#endif /* _NET_DEMUX_H_ */
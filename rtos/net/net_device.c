@@ -183,30 +183,23 @@ uint32_t net_device_get_mtu(FD fd)
  */
 int32_t net_device_buffer_receive(FS_BUFFER_LIST *buffer, uint8_t protocol, uint32_t flags)
 {
-    int32_t status;
+    int32_t status = SUCCESS;
 
     SYS_LOG_FUNCTION_ENTRY(NET_DEVICE);
 
-    /* Push the protocol on the buffer. */
-    status = fs_buffer_list_push(buffer, &protocol, sizeof(uint8_t), FS_BUFFER_HEAD);
-
-    if (status == SUCCESS)
-    {
-        /* Push the flag on the buffer. */
-        status = fs_buffer_list_push(buffer, &flags, sizeof(uint32_t), FS_BUFFER_HEAD);
-    }
+    /* Save the protocol and flags in the buffer meta data. */
+    buffer->meta.proto = protocol;
+    buffer->meta.flags = flags;
+    buffer->meta.l4_offset = 0;
 
-    if (status == SUCCESS)
-    {
-        /* Release lock for buffer file descriptor. */
-        fd_release_lock(buffer->fd);
+    /* Release lock for buffer file descriptor. */
+    fd_release_lock(buffer->fd);
 
-        /* Write this buffer to the networking buffer file descriptor. */
-        ASSERT(fs_write(net_buff_fd, (uint8_t *)buffer, sizeof(FS_BUFFER_LIST *)) != sizeof(FS_BUFFER_LIST *));
+    /* Write this buffer to the networking buffer file descriptor. */
+    ASSERT(fs_write(net_buff_fd, (uint8_t *)buffer, sizeof(FS_BUFFER_LIST *)) != sizeof(FS_BUFFER_LIST *));
 
-        /* Again obtain lock for buffer file descriptor. */
-        ASSERT(fd_get_lock(buffer->fd) != SUCCESS);
-    }
+    /* Again obtain lock for buffer file descriptor. */
+    ASSERT(fd_get_lock(buffer->fd) != SUCCESS);
 
     SYS_LOG_FUNCTION_EXIT_STATUS(NET_DEVICE, status);
 
@@ -252,14 +245,11 @@ int32_t net_device_buffer_transmit(FS_BUFFER_LIST *buffer, uint8_t protocol, uin
                 /* Save the next buffer pointer. */
                 tmp_buffer = buffer->next;
 
-                /* Push the protocol on this buffer. */
-                status = fs_buffer_list_push(buffer, &protocol, sizeof(uint8_t), (FS_BUFFER_HEAD | flags));
+                /* Save the protocol in the buffer meta data. */
+                buffer->meta.proto = protocol;
 
-                if (status == SUCCESS)
-                {
-                    /* Transmit this buffer on the networking device. */
-                    status = net_device->tx(buffer, flags);
-                }
+                /* Transmit this buffer on the networking device. */
+                status = net_device->tx(buffer, flags);
 
                 /* If driver consumed the buffer. */
                 if (status == NET_BUFFER_CONSUMED)
@@ -30,8 +30,10 @@ typedef struct _net_dev NET_DEV;
 /* Networking device flags. */
 #define NET_DEVICE_UP       0x1
 
-/* Buffer flags. */
+/* Buffer meta data flags. */
 #define ETH_FRAME_BCAST     (0x1)
+#define NET_BUFFER_L3_CSUM  (0x2)   /* Network header checksum is verified. */
+#define NET_BUFFER_L4_CSUM  (0x4)   /* Transport checksum is verified. */
 
 /* Networking device transmit/receive functions. */
 typedef int32_t NET_TX (FS_BUFFER_LIST *, uint8_t);
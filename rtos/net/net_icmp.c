@@ -42,7 +42,7 @@
 int32_t net_process_icmp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_addr, uint32_t src_addr, uint32_t dst_addr)
 {
     int32_t status = SUCCESS;
-    uint32_t id_seq;
+    uint16_t type_code, csum;
     uint8_t type;
 
     SYS_LOG_FUNCTION_ENTRY(ICMP);
@@ -62,14 +62,19 @@ int32_t net_process_icmp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_ad
             /* If we are intended destination. */
             if (iface_addr == dst_addr)
             {
-                /* Pull the ID and sequence number. */
-                ASSERT(fs_buffer_list_pull_offset(buffer, &id_seq, 4, ihl + ICMP_HDR_TRAIL_OFFSET, FS_BUFFER_INPLACE) != SUCCESS);
-
-                /* Pull the IP and ICMP packet header header. */
-                ASSERT(fs_buffer_list_pull_offset(buffer, NULL, ihl + ICMP_HDR_PAYLOAD_OFFSET, 0, 0) != SUCCESS);
-
-                /* Initialize an ICMP Echo reply. */
-                status = icmp_header_add(buffer, ICMP_ECHO_REPLY, 0, id_seq);
+                /* Pull the IP header, ICMP header is reused for the reply. */
+                ASSERT(fs_buffer_list_pull_offset(buffer, NULL, ihl, 0, 0) != SUCCESS);
+
+                /* Peek the type, code and checksum as they lie in the packet. */
+                ASSERT(fs_buffer_list_pull_offset(buffer, &type_code, 2, ICMP_HDR_TYPE_OFFSET, FS_BUFFER_INPLACE) != SUCCESS);
+                ASSERT(fs_buffer_list_pull_offset(buffer, &csum, 2, ICMP_HDR_CSUM_OFFSET, FS_BUFFER_INPLACE) != SUCCESS);
+
+                /* Update the type to echo reply and incrementally update the
+                 * checksum, so the payload is not traversed again. */
+                type = ICMP_ECHO_REPLY;
+                ASSERT(fs_buffer_list_push_offset(buffer, &type, 1, ICMP_HDR_TYPE_OFFSET, (FS_BUFFER_HEAD | FS_BUFFER_UPDATE)) != SUCCESS);
+                csum = net_csum_update16(csum, type_code, (uint16_t)(type_code & ~NET_CSUM_EVEN(0xFF)));
+                status = fs_buffer_list_push_offset(buffer, &csum, 2, ICMP_HDR_CSUM_OFFSET, (FS_BUFFER_HEAD | FS_BUFFER_UPDATE));
 
                 if (status == SUCCESS)
                 {
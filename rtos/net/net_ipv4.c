@@ -240,7 +240,6 @@ NET_DEV *ipv4_get_source_device(uint32_t address)
 /*
  * net_process_ipv4
  * @buffer: Received networking buffer needed to be processed.
- * @flags: Associated flags for this buffer.
  * @return: A success status will be returned if IPv4 packet was successfully
  *  processed.
  *  NET_BUFFER_CONSUMED will be returned if buffer was consumed and
@@ -251,23 +250,34 @@ NET_DEV *ipv4_get_source_device(uint32_t address)
  *  drop it silently.
  * This function will process an incoming IPv4 packet.
  */
-int32_t net_process_ipv4(FS_BUFFER_LIST *buffer, uint32_t flags)
+int32_t net_process_ipv4(FS_BUFFER_LIST *buffer)
 {
     int32_t status = SUCCESS;
+    uint32_t flags = buffer->meta.flags;
     uint32_t ip_dst, ip_src, subnet, ip_iface = 0;
     uint8_t proto, ver_ihl;
     uint16_t flag_offset, ip_length;
+    uint8_t hdr_buf[IPV4_HDR_SIZE], *hdr;
 #ifdef NET_ICMP
     uint8_t keep, icmp_rep;
 #endif
 
     SYS_LOG_FUNCTION_ENTRY(IPV4);
 
-    /* We must have at least one byte to verify an IPv4 packet. */
-    if (buffer->total_length >= 1)
+    /* We must have at least the fixed header to verify an IPv4 packet. */
+    if (buffer->total_length >= IPV4_HDR_SIZE)
     {
-        /* Peek the version and IHL. */
-        ASSERT(fs_buffer_list_pull_offset(buffer, &ver_ihl, 1, IPV4_HDR_VER_IHL_OFFSET, FS_BUFFER_INPLACE) != SUCCESS);
+        /* Peek the fixed IPv4 header, all the required fields are picked
+         * here as the header might not remain valid once we update the
+         * buffer. */
+        hdr = fs_buffer_list_peek(buffer, hdr_buf, IPV4_HDR_SIZE, 0);
+        ASSERT(hdr == NULL);
+        ver_ihl = IPV4_HDR_VER_IHL(hdr);
+        flag_offset = IPV4_HDR_FLAG_FRAG(hdr);
+        ip_length = IPV4_HDR_LENGTH(hdr);
+        proto = IPV4_HDR_PROTO(hdr);
+        ip_src = IPV4_HDR_SRC(hdr);
+        ip_dst = IPV4_HDR_DST(hdr);
 
         /* Check if we have a valid IPv4 version. */
         if ((ver_ihl & IPV4_HDR_VER_MASK) == IPV4_HDR_VER)
@@ -297,7 +307,8 @@ int32_t net_process_ipv4(FS_BUFFER_LIST *buffer, uint32_t flags)
         status = NET_INVALID_HDR;
     }
 
-    if (status == SUCCESS)
+    /* If header checksum is not already verified. */
+    if ((status == SUCCESS) && ((flags & NET_BUFFER_L3_CSUM) == 0))
     {
         /* With a valid checksum the recalculation of checksum should return 0. */
         if (net_csum_calculate(buffer, ver_ihl, 0) != 0)
@@ -305,23 +316,25 @@ int32_t net_process_ipv4(FS_BUFFER_LIST *buffer, uint32_t flags)
             /* Return an error. */
             status = NET_INVALID_CSUM;
         }
+        else
+        {
+            /* Header checksum is now verified. */
+            buffer->meta.flags |= NET_BUFFER_L3_CSUM;
+        }
     }
 
     if (status == SUCCESS)
     {
-        /* Pull the flag and offset data from the buffer. */
-        ASSERT(fs_buffer_list_pull_offset(buffer, &flag_offset, 2, IPV4_HDR_FLAG_FRAG_OFFSET, (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
-
-        /* Pick the IPv4 address to which this packet was addressed to. */
-        ASSERT(fs_buffer_list_pull_offset(buffer, &ip_dst, 4, IPV4_HDR_DST_OFFSET, (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
+        /* Save the transport header offset for the upper layers. */
+        buffer->meta.l4_offset = ver_ihl;
+    }
 
+    if (status == SUCCESS)
+    {
         /* Get IPv4 address assigned to this device. */
         ip_iface = ip_dst;
         ASSERT(ipv4_get_device_address(buffer->fd, &ip_iface, &subnet) != SUCCESS);
 
-        /* Pull the IPv4 length for this packet. */
-        ASSERT(fs_buffer_list_pull_offset(buffer, &ip_length, 2, IPV4_HDR_LENGTH_OFFSET, (FS_BUFFER_PACKED | FS_BUFFER_INPLACE)));
-
         /* Check if we need to remove buffer padding. */
         if (ip_length < buffer->total_length)
         {
@@ -370,12 +383,6 @@ int32_t net_process_ipv4(FS_BUFFER_LIST *buffer, uint32_t flags)
 
     if (status == SUCCESS)
     {
-        /* Peek the IPv4 protocol. */
-        ASSERT(fs_buffer_list_pull_offset(buffer, &proto, 1, IPV4_HDR_PROTO_OFFSET, FS_BUFFER_INPLACE) != SUCCESS);
-
-        /* Pick the IPv4 address from which this packet came. */
-        ASSERT(fs_buffer_list_pull_offset(buffer, &ip_src, 4, IPV4_HDR_SRC_OFFSET, (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
-
         /* Try to resolve the protocol to which this packet is needed to be
          * forwarded. */
         switch(proto)
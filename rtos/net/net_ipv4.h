@@ -56,6 +56,17 @@ typedef struct _dhcp_client_device DHCP_CLIENT_DEVICE;
 #define IPV4_HDR_DST_OFFSET         16
 #define IPV4_HDR_OPT_OFFSET         20
 
+/* IPv4 header accessors, header must be contiguous, see
+ * fs_buffer_list_peek. */
+#define IPV4_HDR_VER_IHL(h)         ((h)[IPV4_HDR_VER_IHL_OFFSET])
+#define IPV4_HDR_LENGTH(h)          NET_GET_BE16(&(h)[IPV4_HDR_LENGTH_OFFSET])
+#define IPV4_HDR_ID(h)              NET_GET_BE16(&(h)[IPV4_HDR_ID_OFFSET])
+#define IPV4_HDR_FLAG_FRAG(h)       NET_GET_BE16(&(h)[IPV4_HDR_FLAG_FRAG_OFFSET])
+#define IPV4_HDR_TOL(h)             ((h)[IPV4_HDR_TOL_OFFSET])
+#define IPV4_HDR_PROTO(h)           ((h)[IPV4_HDR_PROTO_OFFSET])
+#define IPV4_HDR_SRC(h)             NET_GET_BE32(&(h)[IPV4_HDR_SRC_OFFSET])
+#define IPV4_HDR_DST(h)             NET_GET_BE32(&(h)[IPV4_HDR_DST_OFFSET])
+
 /* IPv4 fragment flag definitions. */
 #define IPV4_FRAG_IN_USE            0x1
 #define IPV4_FRAG_HAVE_FIRST        0x2
@@ -135,7 +146,7 @@ uint8_t ipv4_compare_address(uint32_t, uint32_t, uint8_t);
 int32_t ipv4_get_device_address(FD, uint32_t *, uint32_t *);
 int32_t ipv4_set_device_address(FD, uint32_t, uint32_t);
 NET_DEV *ipv4_get_source_device(uint32_t);
-int32_t net_process_ipv4(FS_BUFFER_LIST *, uint32_t);
+int32_t net_process_ipv4(FS_BUFFER_LIST *);
 int32_t ipv4_header_add(FS_BUFFER_LIST *, uint8_t, uint32_t, uint32_t, uint8_t);
 #ifdef IPV4_ENABLE_FRAG
 void ipv4_fragment_set_data(FD, IPV4_FRAGMENT *, uint32_t);
@@ -33,25 +33,19 @@
 int32_t net_buffer_process(FS_BUFFER_LIST *buffer)
 {
     int32_t status = SUCCESS;
-    uint32_t flags;
-    uint8_t protocol;
 
     SYS_LOG_FUNCTION_ENTRY(NET_PROCESS);
 
-    /* Skim the protocol and flags from the buffer. */
-    ASSERT(fs_buffer_list_pull(buffer, &flags, sizeof(uint32_t), 0) != SUCCESS);
-    ASSERT(fs_buffer_list_pull(buffer, &protocol, sizeof(uint8_t), 0) != SUCCESS);
-
-    /* Interpret the protocol. */
+    /* Interpret the protocol as saved by the device. */
     /* [TODO] In future this might be controlled by some sort of protocol plugin. */
-    switch (protocol)
+    switch (buffer->meta.proto)
     {
 #ifdef NET_IPV4
     /* IPv4 protocol. */
     case NET_PROTO_IPV4:
 
         /* Process this IPv4 buffer. */
-        status = net_process_ipv4(buffer, flags);
+        status = net_process_ipv4(buffer);
 
         break;
 #endif
@@ -17,12 +17,35 @@
 #ifdef NET_IPV4
 #include <net_route.h>
 
-/* Routes database. */
+/* Routes database, routes are hashed on their prefix and prefix length and
+ * a sorted list of prefix lengths in use is maintained for longest prefix
+ * match. */
 static NET_ROUTE routes[NET_NUM_ROUTES];
+static uint16_t route_hash[NET_ROUTE_HASH_SIZE];
+static uint16_t route_prefix_count[ROUTE_PREFIX_MAX + 1];
+static uint8_t route_prefixes[ROUTE_PREFIX_MAX + 1];
+static uint8_t route_num_prefixes;
+
+/* Route sequence, this is odd while routes are being updated and readers
+ * retry their lookup if this changes under them. */
+static volatile uint32_t route_sequence;
+
+#if (NET_ROUTE_CACHE_SIZE > 0)
+/* Destination route cache, an entry is only valid for the route sequence at
+ * which it was resolved. */
+static NET_ROUTE_CACHE route_cache[NET_ROUTE_CACHE_SIZE];
+#endif /* (NET_ROUTE_CACHE_SIZE > 0) */
 
 /* Internal function prototypes. */
 static int32_t route_lock(void);
 static void route_unlock(void);
+static void route_update_begin(void);
+static void route_update_end(void);
+static uint8_t route_prefix_length(uint32_t);
+static void route_link(uint16_t);
+static void route_unlink(uint16_t);
+static uint16_t route_match(FD, uint32_t, uint32_t);
+static uint16_t route_broadcast(FD, uint32_t);
 
 /*
  * route_lock
@@ -57,13 +80,253 @@ static void route_unlock(void)
 
 } /* route_unlock */
 
+/*
+ * route_update_begin
+ * This function will mark start of an update to the route database, must be
+ * called with route lock held.
+ */
+static void route_update_begin(void)
+{
+    /* Make the sequence odd so the readers will wait for this update. */
+    route_sequence++;
+    ROUTE_BARRIER();
+
+} /* route_update_begin */
+
+/*
+ * route_update_end
+ * This function will mark end of an update to the route database, this will
+ * also invalidate the route cache.
+ */
+static void route_update_end(void)
+{
+    /* Make the sequence even so the readers can use the routes. */
+    ROUTE_BARRIER();
+    route_sequence++;
+
+} /* route_update_end */
+
+/*
+ * route_prefix_length
+ * @subnet: Subnet mask.
+ * @return: Returns the number of leading one bits in the subnet mask.
+ * This function will return prefix length for a subnet mask, subnet mask is
+ * expected to be contiguous.
+ */
+static uint8_t route_prefix_length(uint32_t subnet)
+{
+    uint8_t prefix = 0;
+
+    /* While we have a leading one bit. */
+    while ((prefix < ROUTE_PREFIX_MAX) && (subnet & 0x80000000))
+    {
+        /* Count this bit. */
+        prefix++;
+        subnet <<= 1;
+    }
+
+    /* Return the prefix length. */
+    return (prefix);
+
+} /* route_prefix_length */
+
+/*
+ * route_link
+ * @index: Index of route to be linked.
+ * This function will add a route in it's hash bucket and in the prefix length
+ * list, must be called with route update in progress.
+ */
+static void route_link(uint16_t index)
+{
+    NET_ROUTE *route = &routes[index - 1];
+    uint16_t *next = &route_hash[ROUTE_HASH(route->destination & ROUTE_PREFIX_MASK(route->prefix), route->prefix)];
+    uint8_t i;
+
+    /* Add this route at the end of it's bucket so that the routes added
+     * first are preferred. */
+    while (*next != ROUTE_NONE)
+    {
+        next = &routes[*next - 1].next;
+    }
+    route->next = ROUTE_NONE;
+    *next = index;
+
+    /* If this is first route with this prefix length. */
+    if (route_prefix_count[route->prefix]++ == 0)
+    {
+        /* Insert this prefix length keeping the list sorted longest first. */
+        for (i = route_num_prefixes; (i > 0) && (route_prefixes[i - 1] < route->prefix); i--)
+        {
+            route_prefixes[i] = route_prefixes[i - 1];
+        }
+        route_prefixes[i] = route->prefix;
+        route_num_prefixes++;
+    }
+
+} /* route_link */
+
+/*
+ * route_unlink
+ * @index: Index of route to be unlinked.
+ * This function will remove a route from it's hash bucket and from the prefix
+ * length list, must be called with route update in progress.
+ */
+static void route_unlink(uint16_t index)
+{
+    NET_ROUTE *route = &routes[index - 1];
+    uint16_t *next = &route_hash[ROUTE_HASH(route->destination & ROUTE_PREFIX_MASK(route->prefix), route->prefix)];
+    uint8_t i;
+
+    /* Find this route in it's bucket. */
+    while ((*next != ROUTE_NONE) && (*next != index))
+    {
+        next = &routes[*next - 1].next;
+    }
+
+    /* Should never happen. */
+    ASSERT(*next == ROUTE_NONE);
+
+    /* Remove this route from the bucket. */
+    *next = route->next;
+    route->next = ROUTE_NONE;
+
+    /* If this was last route with this prefix length. */
+    if (--route_prefix_count[route->prefix] == 0)
+    {
+        /* Remove this prefix length from the list. */
+        for (i = 0; (i < route_num_prefixes) && (route_prefixes[i] != route->prefix); i++)
+        {
+            ;
+        }
+        route_num_prefixes--;
+        for (; i < route_num_prefixes; i++)
+        {
+            route_prefixes[i] = route_prefixes[i + 1];
+        }
+    }
+
+} /* route_unlink */
+
+/*
+ * route_match
+ * @device: If not null only the routes for this device will be matched.
+ * @destination: Destination address for which a route is required.
+ * @sequence: Route sequence at which this lookup is being performed.
+ * @return: Index of the longest prefix matching route will be returned,
+ *  ROUTE_NONE will be returned if no route matches.
+ * This function will find the route with longest prefix for a destination,
+ * the result is also saved in the route cache if no device was given.
+ */
+static uint16_t route_match(FD device, uint32_t destination, uint32_t sequence)
+{
+    NET_ROUTE *route;
+    uint16_t index = ROUTE_NONE;
+    uint8_t i, prefix;
+#if (NET_ROUTE_CACHE_SIZE > 0)
+    NET_ROUTE_CACHE *cache = &route_cache[ROUTE_CACHE_INDEX(destination)], entry;
+
+    /* Take a copy of the cache entry so that it is not updated under us. */
+    scheduler_lock();
+    entry = *cache;
+    scheduler_unlock();
+
+    /* If we have resolved this destination at the current sequence. */
+    if ((entry.route != ROUTE_NONE) && (entry.sequence == sequence) && (entry.destination == destination))
+    {
+        /* The longest match over all the routes is also the longest match
+         * for it's own device. */
+        if ((device == NULL) || (routes[entry.route - 1].device == device))
+        {
+            /* Use the cached route. */
+            index = entry.route;
+        }
+    }
+
+    if (index == ROUTE_NONE)
+#endif /* (NET_ROUTE_CACHE_SIZE > 0) */
+    {
+        /* Try the prefix lengths in use longest first. */
+        for (i = 0; (i < route_num_prefixes) && (index == ROUTE_NONE); i++)
+        {
+            prefix = route_prefixes[i];
+
+            /* Traverse the bucket for this prefix. */
+            index = route_hash[ROUTE_HASH(destination & ROUTE_PREFIX_MASK(prefix), prefix)];
+            while (index != ROUTE_NONE)
+            {
+                route = &routes[index - 1];
+
+                /* If this route matches the destination and the device. */
+                if ((route->prefix == prefix) && ((destination & route->subnet) == (route->destination & route->subnet)) && ((device == NULL) || (route->device == device)))
+                {
+                    /* Use this route. */
+                    break;
+                }
+
+                /* Pick the next route. */
+                index = route->next;
+            }
+        }
+
+#if (NET_ROUTE_CACHE_SIZE > 0)
+        /* If we can cache this route. */
+        if ((device == NULL) && (index != ROUTE_NONE))
+        {
+            /* Don't let other readers see a partial cache entry. */
+            scheduler_lock();
+
+            /* Update the cache entry. */
+            cache->destination = destination;
+            cache->sequence = sequence;
+            cache->route = index;
+
+            /* Enable scheduling. */
+            scheduler_unlock();
+        }
+#endif /* (NET_ROUTE_CACHE_SIZE > 0) */
+    }
+
+    /* Return the matched route. */
+    return (index);
+
+} /* route_match */
+
+/*
+ * route_broadcast
+ * @device: If not null only the routes for this device will be matched.
+ * @iface_addr: If not unspecified only the routes for this interface address
+ *  will be matched.
+ * @return: Index of a link local route will be returned, ROUTE_NONE will be
+ *  returned if no link local route matches.
+ * This function will find a link local route to be used for broadcast.
+ */
+static uint16_t route_broadcast(FD device, uint32_t iface_addr)
+{
+    uint16_t i, index = ROUTE_NONE;
+
+    /* Traverse the route list. */
+    for (i = 0; i < NET_NUM_ROUTES; i++)
+    {
+        /* Only use a link local route for broadcast. */
+        if ((routes[i].flags & ROUTE_VALID) && (routes[i].gateway == IPV4_GATWAY_LL) && ((device == NULL) || (routes[i].device == device)) && ((iface_addr == IPV4_ADDR_UNSPEC) || (routes[i].interface_address == iface_addr)))
+        {
+            /* Use this route. */
+            index = (uint16_t)(i + 1);
+        }
+    }
+
+    /* Return the matched route. */
+    return (index);
+
+} /* route_broadcast */
+
 /*
  * route_add
  * @device: Network interface to use for this device.
  * @iface_addr: Interface address to be used for this route.
  * @gateway: Gateway address for this route.
  * @destination: Destination address for this route.
- * @subnet: Subnet mask for this route.
+ * @subnet: Subnet mask for this route, must be contiguous.
  * @flags: Initial flags for this route.
  * @return: Success will be returned if a route was added,
  *  ROUTE_EXIST will be returned if an existing route was found,
@@ -73,7 +336,9 @@ static void route_unlock(void)
  */
 int32_t route_add(FD device, uint32_t interface_address, uint32_t gateway, uint32_t destination, uint32_t subnet, uint8_t flags)
 {
-    int32_t i, free_route = -1, status;
+    int32_t status;
+    uint16_t i, index, free_route = ROUTE_NONE;
+    uint8_t prefix = route_prefix_length(subnet);
 
     SYS_LOG_FUNCTION_ENTRY(ROUTE);
 
@@ -82,39 +347,50 @@ int32_t route_add(FD device, uint32_t interface_address, uint32_t gateway, uint3
 
     if (status == SUCCESS)
     {
-        /* Traverse the route list. */
-        for (i = 0; i < NET_NUM_ROUTES; i++)
+        /* Traverse the bucket for this route. */
+        for (index = route_hash[ROUTE_HASH(destination & ROUTE_PREFIX_MASK(prefix), prefix)]; index != ROUTE_NONE; index = routes[index - 1].next)
         {
             /* If we already have such route. */
-            if ((routes[i].flags & ROUTE_VALID) && (interface_address == routes[i].interface_address) && (gateway == routes[i].gateway) && (destination == routes[i].destination) && (subnet == routes[i].subnet))
+            if ((interface_address == routes[index - 1].interface_address) && (gateway == routes[index - 1].gateway) && (destination == routes[index - 1].destination) && (subnet == routes[index - 1].subnet))
             {
                 /* Route already exist. */
                 status = ROUTE_EXIST;
                 break;
             }
-            else if (((routes[i].flags & ROUTE_VALID) == 0) && (free_route == -1))
-            {
-                /* Save the free route index. */
-                free_route = i;
-            }
         }
 
         if (status == SUCCESS)
         {
+            /* Find a free route entry. */
+            for (i = 0; (i < NET_NUM_ROUTES) && (free_route == ROUTE_NONE); i++)
+            {
+                if ((routes[i].flags & ROUTE_VALID) == 0)
+                {
+                    /* Save the free route index. */
+                    free_route = (uint16_t)(i + 1);
+                }
+            }
+
             /* If we have a free  route entry. */
-            if (free_route >= 0)
+            if (free_route != ROUTE_NONE)
             {
+                route_update_begin();
+
                 /* Update the route entry. */
-                routes[free_route].device = device;
-                routes[free_route].gateway = gateway;
-                routes[free_route].destination = destination;
-                routes[free_route].subnet = subnet;
-                routes[free_route].interface_address = interface_address;
+                routes[free_route - 1].device = device;
+                routes[free_route - 1].gateway = gateway;
+                routes[free_route - 1].destination = destination;
+                routes[free_route - 1].subnet = subnet;
+                routes[free_route - 1].interface_address = interface_address;
+                routes[free_route - 1].prefix = prefix;
 
                 SYS_LOG_FUNCTION_MSG(ROUTE, SYS_LOG_INFO, "adding %d.%d.%d.%d/%d.%d.%d.%d through %d.%d.%d.%d at %s", SYS_LOG_IP(destination), SYS_LOG_IP(subnet), SYS_LOG_IP(gateway), ((FS *)device)->name);
 
-                /* Mark this route as valid. */
-                routes[free_route].flags = (flags | ROUTE_VALID);
+                /* Mark this route as valid and add it to the lookup. */
+                routes[free_route - 1].flags = (flags | ROUTE_VALID);
+                route_link(free_route);
+
+                route_update_end();
             }
             else
             {
@@ -144,7 +420,8 @@ int32_t route_add(FD device, uint32_t interface_address, uint32_t gateway, uint3
  */
 int32_t route_remove(FD device, uint32_t gateway, uint32_t destination)
 {
-    int32_t i, status;
+    int32_t status;
+    uint16_t i;
 
     SYS_LOG_FUNCTION_ENTRY(ROUTE);
 
@@ -153,6 +430,8 @@ int32_t route_remove(FD device, uint32_t gateway, uint32_t destination)
 
     if (status == SUCCESS)
     {
+        route_update_begin();
+
         /* Traverse the route list. */
         for (i = 0; i < NET_NUM_ROUTES; i++)
         {
@@ -165,12 +444,16 @@ int32_t route_remove(FD device, uint32_t gateway, uint32_t destination)
                     ((gateway == 0x0) || (routes[i].gateway == gateway)) &&
                     ((destination == 0x0) || (routes[i].destination == destination)))
                 {
-                    /* Mark this route as invalid. */
+                    /* Remove this route from the lookup and mark it as
+                     * invalid. */
+                    route_unlink((uint16_t)(i + 1));
                     routes[i].flags = 0;
                 }
             }
         }
 
+        route_update_end();
+
         /* Unlock the routes. */
         route_unlock();
     }
@@ -192,140 +475,108 @@ int32_t route_remove(FD device, uint32_t gateway, uint32_t destination)
  * @subnet: Subnet mask for this route will be returned here.
  * @return: Success will be returned if a valid route was found,
  *  NET_DST_UNREACHABLE will be returned if a route was not found.
- * This function will get a destination route for the given address.
+ * This function will get a destination route for the given address. Route
+ * database is not locked, lookup is retried if the routes were updated while
+ * it was being performed, so this must not be called from an interrupt.
  */
 int32_t route_get(FD *device, uint32_t destination, uint32_t *iface_addr, uint32_t *gw_addr, uint32_t *subnet)
 {
-    int32_t i, status, route = -1, default_route = -1;
-    uint32_t this_match, match = 0;
+    int32_t status = SUCCESS;
+    NET_ROUTE route;
+    FD this_device = ((device != NULL) ? *device : NULL);
+    uint32_t this_iface = ((iface_addr != NULL) ? *iface_addr : IPV4_ADDR_UNSPEC);
+    uint32_t sequence;
+    uint16_t index;
 
     SYS_LOG_FUNCTION_ENTRY(ROUTE);
 
-    /* Lock the routes. */
-    status = route_lock();
-
-    if (status == SUCCESS)
+    do
     {
-        /* Traverse the route list. */
-        for (i = 0; i < NET_NUM_ROUTES; i++)
+        /* Wait for any update in progress. */
+        do
         {
-            /* If we already have such route. */
-            if (routes[i].flags & ROUTE_VALID)
-            {
-                /* If we are trying to find route for a broadcast address,
-                 * only use a link local address for broadcast. */
-                if (((device == NULL) || (*device == NULL) || (routes[i].device == *device)) && ((iface_addr == NULL) || (*iface_addr == IPV4_ADDR_UNSPEC) || (routes[i].interface_address == *iface_addr)) && (destination == IPV4_ADDR_BCAST) && (routes[i].gateway == IPV4_GATWAY_LL))
-                {
-                    /* Return network for this address. */
-                    route = i;
-                    match = IPV4_SUBNET_LL;
-                }
+            sequence = route_sequence;
+        } while (sequence & 0x1);
+        ROUTE_BARRIER();
 
-                /* If this is a default gateway and has the same device. */
-                else if (((device == NULL) || (*device == NULL) || (routes[i].device == *device)) && ((iface_addr == NULL) || (*iface_addr == IPV4_ADDR_UNSPEC)) && (destination != IPV4_ADDR_BCAST) && (routes[i].subnet == 0x0))
-                {
-                    /* Save the default route. */
-                    default_route = i;
-                }
+        /* If we are trying to find route for a broadcast address. */
+        if (destination == IPV4_ADDR_BCAST)
+        {
+            /* Find a link local route. */
+            index = route_broadcast(this_device, this_iface);
+        }
 
-                /* If we can use this route and has the same device. */
-                else if (((device == NULL) || (*device == NULL) || (routes[i].device == *device)) && ((iface_addr == NULL) || (*iface_addr == IPV4_ADDR_UNSPEC)) && (destination & routes[i].subnet) == (routes[i].destination & routes[i].subnet))
-                {
-                    /* Match the route. */
-                    this_match = destination & routes[i].subnet;
-
-                    /* If this is route is more accurate. */
-                    if ((this_match != 0) && ((this_match > match) || ((this_match == match) && (routes[i].subnet > routes[route].subnet))))
-                    {
-                        /* This is more accurate route. */
-                        route =  i;
-                        match = this_match;
-                    }
-                }
-            }
+        /* Only the broadcast routes can be searched for an interface
+         * address. */
+        else if (this_iface == IPV4_ADDR_UNSPEC)
+        {
+            /* Find the longest prefix match for this destination. */
+            index = route_match(this_device, destination, sequence);
+        }
+
+        else
+        {
+            /* No route can be used. */
+            index = ROUTE_NONE;
         }
 
         /* If we have a route. */
-        if (route >= 0)
+        if (index != ROUTE_NONE)
         {
-            /* If we need to return the device associated for this route. */
-            if ((device != NULL) && (*device == NULL))
-            {
-                /* Return the device we need to use. */
-                *device = routes[route].device;
-            }
+            /* Take a copy of this route. */
+            route = routes[index - 1];
+        }
 
-            /* If we need to return the interface address for this route. */
-            if ((iface_addr != NULL) && (*iface_addr == IPV4_ADDR_UNSPEC))
-            {
-                /* Return the source address we need to use. */
-                *iface_addr = routes[route].interface_address;
-            }
+        ROUTE_BARRIER();
 
-            /* If we need to return the gateway address for this route. */
-            if (gw_addr != NULL)
-            {
-                /* If this is a link local route. */
-                if (routes[route].gateway == IPV4_GATWAY_LL)
-                {
-                    /* For on link route use the node as gateway. */
-                    *gw_addr = destination;
-                }
-                else
-                {
-                    /* Populate the destination address. */
-                    *gw_addr = routes[route].gateway;
-                }
-            }
+    /* If routes were updated while we were searching, search again. */
+    } while (sequence != route_sequence);
 
-            /* If need to return the subnet for this route. */
-            if (subnet != NULL)
-            {
-                /* Return associated subnet mask. */
-                *subnet = routes[route].subnet;
-            }
+    /* If we have a route. */
+    if (index != ROUTE_NONE)
+    {
+        /* If we need to return the device associated for this route. */
+        if ((device != NULL) && (*device == NULL))
+        {
+            /* Return the device we need to use. */
+            *device = route.device;
         }
 
-        /* If we found a default route. */
-        else if (default_route >= 0)
+        /* If we need to return the interface address for this route. */
+        if ((iface_addr != NULL) && (*iface_addr == IPV4_ADDR_UNSPEC))
         {
-            /* If we need to return the device associated for this route. */
-            if ((device != NULL) && (*device == NULL))
-            {
-                /* Return associated device. */
-                *device = routes[default_route].device;
-            }
-
-            /* If we need to return the interface address for this route. */
-            if ((iface_addr != NULL) && (*iface_addr == IPV4_ADDR_UNSPEC))
-            {
-                /* Return the source address we need to use. */
-                *iface_addr = routes[default_route].interface_address;
-            }
+            /* Return the source address we need to use. */
+            *iface_addr = route.interface_address;
+        }
 
-            /* If we need to return the gateway address for this route. */
-            if (gw_addr != NULL)
+        /* If we need to return the gateway address for this route. */
+        if (gw_addr != NULL)
+        {
+            /* If this is a link local route. */
+            if (route.gateway == IPV4_GATWAY_LL)
             {
-                /* Return gateway address. */
-                *gw_addr = routes[default_route].gateway;
+                /* For on link route use the node as gateway. */
+                *gw_addr = destination;
             }
-
-            /* If need to return the subnet for this route. */
-            if (subnet != NULL)
+            else
             {
-                /* Return associated subnet mask. */
-                *subnet = routes[default_route].subnet;
+                /* Populate the destination address. */
+                *gw_addr = route.gateway;
             }
         }
 
-        else
+        /* If need to return the subnet for this route. */
+        if (subnet != NULL)
         {
-            /* A route was not found for the destination. */
-            status = NET_DST_UNREACHABLE;
+            /* Return associated subnet mask. */
+            *subnet = route.subnet;
         }
+    }
 
-        /* Unlock the routes. */
-        route_unlock();
+    else
+    {
+        /* A route was not found for the destination. */
+        status = NET_DST_UNREACHABLE;
     }
 
     //SYS_LOG_FUNCTION_EXIT_STATUS(ROUTE, status);
@@ -1,2 +1,4 @@
 # Setup configuration options.
-setup_option_def(NET_NUM_ROUTES 4 INT "Maximum number of networking routes to maintain." CONFIG_FILE "net_route_config")
\ No newline at end of file
+setup_option_def(NET_NUM_ROUTES 4 INT "Maximum number of networking routes to maintain." CONFIG_FILE "net_route_config")
+setup_option_def(NET_ROUTE_HASH_SIZE 16 INT "Number of route hash buckets, must be a power of 2." CONFIG_FILE "net_route_config")
+setup_option_def(NET_ROUTE_CACHE_SIZE 4 INT "Number of destination route cache entries, must be a power of 2 or 0 to disable the cache." CONFIG_FILE "net_route_config")
\ No newline at end of file
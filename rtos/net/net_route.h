@@ -26,6 +26,24 @@
 /* Route flag definitions. */
 #define ROUTE_VALID             (0x1)
 
+/* Route lookup definitions, route indexes are kept one based so that a zero
+ * can be used to mark the end of a bucket or an empty cache entry. */
+#define ROUTE_NONE              (0)
+#define ROUTE_PREFIX_MAX        (32)
+#define ROUTE_PREFIX_MASK(len)  (((len) == 0) ? 0x0 : (uint32_t)(0xFFFFFFFF << (ROUTE_PREFIX_MAX - (len))))
+#define ROUTE_MIX(key)          ((uint32_t)(((key) ^ ((key) >> 16)) * 0x9E3779B1) >> 16)
+#define ROUTE_HASH(key, len)    (ROUTE_MIX((key) ^ (len)) & (NET_ROUTE_HASH_SIZE - 1))
+#if (NET_ROUTE_CACHE_SIZE > 0)
+#define ROUTE_CACHE_INDEX(dst)  (ROUTE_MIX(dst) & (NET_ROUTE_CACHE_SIZE - 1))
+#endif
+
+/* Barrier to order route sequence and route data updates. */
+#ifdef CPU_MEMORY_BARRIER
+#define ROUTE_BARRIER()         CPU_MEMORY_BARRIER()
+#else
+#define ROUTE_BARRIER()         asm volatile ("" ::: "memory")
+#endif /* CPU_MEMORY_BARRIER */
+
 /* A single route entry. */
 typedef struct _net_route
 {
@@ -44,13 +62,35 @@ typedef struct _net_route
     /* Interface address. */
     uint32_t    interface_address;
 
+    /* Next route in the hash bucket. */
+    uint16_t    next;
+
+    /* Prefix length of the subnet mask. */
+    uint8_t     prefix;
+
     /* Route flags. */
-    uint8_t    flags;
+    uint8_t     flags;
+
+} NET_ROUTE;
+
+#if (NET_ROUTE_CACHE_SIZE > 0)
+/* A destination route cache entry. */
+typedef struct _net_route_cache
+{
+    /* Destination address. */
+    uint32_t    destination;
+
+    /* Route sequence at which this entry was resolved. */
+    uint32_t    sequence;
+
+    /* Resolved route. */
+    uint16_t    route;
 
     /* Structure padding. */
-    uint8_t     pad[3];
+    uint8_t     pad[2];
 
-} NET_ROUTE;
+} NET_ROUTE_CACHE;
+#endif /* (NET_ROUTE_CACHE_SIZE > 0) */
 
 /* Function prototypes. */
 int32_t route_add(FD, uint32_t, uint32_t, uint32_t, uint32_t, uint8_t);
@@ -20,6 +20,7 @@
 #include <sll.h>
 #include <header.h>
 #include <net_tcp.h>
+#include <net_tcp_cong.h>
 #include <net_csum.h>
 
 /* Global TCP data. */
@@ -28,18 +29,21 @@ volatile uint32_t tcp_iss;
 
 /* Internal function prototypes. */
 static void tcp_port_initialize(TCP_PORT *);
-static uint8_t tcp_port_search(void *, void *);
 static void tcp_resume_socket(TCP_PORT *, uint8_t);
 static int32_t tcp_port_wait(TCP_PORT *, uint8_t);
-static int32_t tcp_process_options(FS_BUFFER_LIST *, TCP_PORT *, uint32_t, uint16_t);
+static int32_t tcp_process_options(FS_BUFFER_LIST *, TCP_PORT *, uint32_t, uint16_t, TCP_OPT_PARAM *);
 static int32_t tcp_add_option(FS_BUFFER_LIST *, uint8_t, uint8_t, void *, uint8_t);
-static int32_t tcp_add_options(FS_BUFFER_LIST *, uint16_t, uint8_t *, uint8_t, uint8_t *, uint8_t);
+static int32_t tcp_add_options(FS_BUFFER_LIST *, uint16_t, uint8_t *, uint8_t, uint32_t, uint8_t *, uint8_t);
+static uint8_t tcp_build_options(TCP_PORT *, uint8_t *, uint8_t);
+static uint16_t tcp_send_mss(TCP_PORT *);
 static void tcp_timer_register(TCP_PORT *);
 static void tcp_timer_unregister(TCP_PORT *);
 static void tcp_timeout_update(TCP_PORT *);
+static void tcp_rtx_segment(TCP_PORT *, TCP_RTX_DATA *);
+static void tcp_rtx_clear_flags(TCP_PORT *, uint8_t);
 static void tcp_fast_rtx(TCP_PORT *, uint32_t);
 static void tcp_timeout_callback(void *, int32_t);
-static int32_t tcp_send_segment(TCP_PORT *, SOCKET_ADDRESS *, uint32_t, uint32_t, uint16_t, uint16_t, uint8_t *, int32_t, uint8_t, uint8_t);
+static int32_t tcp_send_segment(TCP_PORT *, SOCKET_ADDRESS *, uint32_t, uint32_t, uint16_t, uint16_t, FS_BUFFER_LIST *, uint8_t, uint8_t);
 static uint8_t tcp_check_sequence(uint32_t, uint32_t, uint32_t, uint32_t);
 static void tcp_process_finbit(TCP_PORT *, uint32_t);
 static uint8_t tcp_oo_buffer_process(void *, void *);
@@ -49,10 +53,20 @@ static int32_t tcp_read_buffer(void *, uint8_t *, int32_t);
 static int32_t tcp_read_data(void *, uint8_t *, int32_t);
 static int32_t tcp_write_buffer(void *, const uint8_t *, int32_t);
 static int32_t tcp_write_data(void *, const uint8_t *, int32_t);
+static int32_t tcp_tx_buffer_add(TCP_PORT *, const uint8_t *, int32_t);
+static void tcp_tx_buffer_prepend(TCP_PORT *, FS_BUFFER_LIST *);
+static int32_t tcp_tx_buffer_send(TCP_PORT *, uint8_t, uint8_t);
+static int32_t tcp_ioctl(void *, uint32_t, void *);
+static uint32_t tcp_send_space(TCP_PORT *);
 static TCP_RTX_DATA *tcp_get_rtx_free(TCP_PORT *);
 static uint8_t tcp_rtx_return_buffer(void *, FS_BUFFER_LIST *);
 static uint8_t tcp_rtx_process_ack(TCP_PORT *, uint32_t);
 static void tcp_rtx_free_all(TCP_PORT *);
+static void tcp_rtt_sample(TCP_PORT *, uint32_t, TCP_OPT_PARAM *);
+#ifdef TCP_SACK
+static uint8_t tcp_sack_process(TCP_PORT *, TCP_OPT_PARAM *);
+static void tcp_sack_update(TCP_PORT *, uint32_t);
+#endif
 
 /*
  * tcp_initialize
@@ -65,6 +79,12 @@ void tcp_initialize(void)
 #ifdef CONFIG_SEMAPHORE
     /* Create the semaphore to protect global TCP data. */
     semaphore_create(&tcp_data.lock, 1);
+
+#ifdef SEMAPHORE_PRIORITY_INHERIT
+    /* Lower priority tasks holding this lock should not block the higher
+     * priority tasks. */
+    semaphore_set_inherit(&tcp_data.lock);
+#endif /* SEMAPHORE_PRIORITY_INHERIT */
 #endif
 
     SYS_LOG_FUNCTION_EXIT(TCP);
@@ -93,9 +113,20 @@ void tcp_register(TCP_PORT *port, char *name, SOCKET_ADDRESS *socket_address)
     /* Copy the socket address. */
     memcpy(&port->socket_address, socket_address, sizeof(SOCKET_ADDRESS));
 
+    /* Use the default congestion control algorithm. */
+    port->cong = TCP_CONG_DEFAULT;
+
+#ifndef TCP_NAGLE
+    /* Don't hold small segments on this port unless enabled. */
+    port->flags |= TCP_FLAG_NODELAY;
+#endif
+
     /* Add this port in the global port list. */
     sll_append(&tcp_data.port_list, port, OFFSETOF(TCP_PORT, next));
 
+    /* Add this port in the socket demux table. */
+    net_demux_add(&tcp_data.demux, &port->demux, port, &port->socket_address);
+
     /* Register this TCP port as a console. */
     port->console.fs.name = name;
     port->console.fs.flags |= (FS_BLOCK);
@@ -116,6 +147,9 @@ void tcp_register(TCP_PORT *port, char *name, SOCKET_ADDRESS *socket_address)
         port->console.fs.write = &tcp_write_data;
     }
 
+    /* Set the IOCTL API for this descriptor. */
+    port->console.fs.ioctl = &tcp_ioctl;
+
     /* Initialize TCP port. */
     tcp_port_initialize(port);
 
@@ -154,6 +188,9 @@ void tcp_unregister(TCP_PORT *port)
     /* Remove this port from the global port list. */
     ASSERT(sll_remove(&tcp_data.port_list, port, OFFSETOF(TCP_PORT, next)) != port);
 
+    /* Remove this port from the socket demux table. */
+    net_demux_remove(&tcp_data.demux, &port->demux);
+
 #ifndef CONFIG_SEMAPHORE
     /* Enable scheduling. */
     scheduler_unlock();
@@ -198,50 +235,26 @@ static void tcp_port_initialize(TCP_PORT *port)
     port->rcv_wnd_scale = port->snd_wnd_scale = 0;
     port->nacks = 0;
     port->event_timeout_enable = port->rtx_timeout_enable = FALSE;
+    port->flags &= (uint8_t)~(TCP_FLAG_ACK_DELAYED);
 
-    SYS_LOG_FUNCTION_EXIT(TCP);
-
-} /* tcp_port_initialize */
-
-/*
- * tcp_port_search
- * @node: A TCP port in the list.
- * @param: TCP port search parameter.
- * @return: Will return true if we matched an exact TCP port for given TCP
- *  parameter.
- * This function is a search callback to find a specific TCP port.
- */
-static uint8_t tcp_port_search(void *node, void *param)
-{
-    TCP_PORT_PARAM *tcp_param = (TCP_PORT_PARAM *)param;
-    TCP_PORT *port = (TCP_PORT *)node;
-    uint8_t match = FALSE;
-
-    SYS_LOG_FUNCTION_ENTRY(TCP);
-
-    /* Match two TCP socket addresses. */
-    match = net_socket_address_match(&port->socket_address, &tcp_param->socket_address);
+    /* Initialize round trip time estimation and congestion control. */
+    tcp_rtt_initialize(port);
+    tcp_cong_initialize(port);
 
-    /* If we did not fail completely. */
-    if (match != FALSE)
-    {
-        /* Save this port. */
-        tcp_param->port = port;
-    }
+#ifdef TCP_TIME_STAMP
+    /* Nothing is yet received to be echoed. */
+    port->ts_recent = port->last_ack_sent = 0;
+#endif
 
-    /* If this was a partial match. */
-    if (match == PARTIAL)
-    {
-        /* SLL don't understand partial yet. */
-        match = FALSE;
-    }
+#ifdef TCP_SACK
+    /* Clear the SACK state. */
+    port->num_rcv_sack = 0;
+    port->sack_high = 0;
+#endif
 
     SYS_LOG_FUNCTION_EXIT(TCP);
 
-    /* Return if this is required port. */
-    return (match);
-
-} /* tcp_port_search */
+} /* tcp_port_initialize */
 
 /*
  * tcp_resume_socket
@@ -311,18 +324,29 @@ static int32_t tcp_port_wait(TCP_PORT *port, uint8_t flags)
  * @port: TCP port for which TCP options are needed to be processed.
  * @offset: Offset at which TCP options start.
  * @total_opt_size: Total number of bytes we are expecting in the TCP options.
+ * @opt_param: Option parameter in which the timestamp and SACK blocks received
+ *  in this segment will be returned.
  * @return: A success status will be returned if TCP options were successfully
  *  parsed.
  * This function will parse and process TCP options received in a TCP packet.
  */
-static int32_t tcp_process_options(FS_BUFFER_LIST *buffer, TCP_PORT *port, uint32_t offset, uint16_t total_opt_size)
+static int32_t tcp_process_options(FS_BUFFER_LIST *buffer, TCP_PORT *port, uint32_t offset, uint16_t total_opt_size, TCP_OPT_PARAM *opt_param)
 {
     int32_t status = SUCCESS;
     uint16_t opt_index = 0, opt_value_16;
     uint8_t opt_type, opt_len;
+#ifdef TCP_SACK
+    uint8_t i;
+#endif
 
     SYS_LOG_FUNCTION_ENTRY(TCP);
 
+    /* Nothing is yet parsed. */
+    opt_param->flags = 0;
+#ifdef TCP_SACK
+    opt_param->num_sack = 0;
+#endif
+
     /* If we don't have anticipated number of bytes in the provided buffer. */
     if ((offset + total_opt_size) > buffer->total_length)
     {
@@ -429,6 +453,74 @@ static int32_t tcp_process_options(FS_BUFFER_LIST *buffer, TCP_PORT *port, uint3
 
                     break;
 
+#ifdef TCP_SACK
+                /* SACK permitted. */
+                case TCP_OPT_SACK_EN:
+
+                    /* If we do have anticipated number of bytes for this
+                     * option. */
+                    if (opt_len == 0)
+                    {
+                        /* SACK is being used. */
+                        port->flags |= TCP_FLAG_SACK;
+                    }
+                    else
+                    {
+                        /* Invalid option was parsed. */
+                        status = NET_INVALID_HDR;
+                    }
+
+                    break;
+
+                /* SACK blocks. */
+                case TCP_OPT_SACK:
+
+                    /* If we do have whole SACK blocks. */
+                    if ((opt_len > 0) && ((opt_len % TCP_OPT_SACK_BLOCK_SIZE) == 0))
+                    {
+                        /* Pull the SACK blocks we can process. */
+                        for (i = 0; (i < (opt_len / TCP_OPT_SACK_BLOCK_SIZE)) && (i < TCP_SACK_MAX_BLOCKS); i++)
+                        {
+                            ASSERT(fs_buffer_list_pull_offset(buffer, &opt_param->sack[(2 * i)], 4, (offset + opt_index + (uint32_t)(i * TCP_OPT_SACK_BLOCK_SIZE)), (FS_BUFFER_PACKED | FS_BUFFER_INPLACE)));
+                            ASSERT(fs_buffer_list_pull_offset(buffer, &opt_param->sack[(2 * i) + 1], 4, (offset + opt_index + (uint32_t)(i * TCP_OPT_SACK_BLOCK_SIZE) + 4), (FS_BUFFER_PACKED | FS_BUFFER_INPLACE)));
+                        }
+
+                        /* Save the number of SACK blocks received. */
+                        opt_param->num_sack = i;
+                    }
+                    else
+                    {
+                        /* Invalid option was parsed. */
+                        status = NET_INVALID_HDR;
+                    }
+
+                    break;
+#endif
+
+#ifdef TCP_TIME_STAMP
+                /* Timestamp. */
+                case TCP_OPT_TIME_STAMP:
+
+                    /* If we do have anticipated number of bytes for this
+                     * option. */
+                    if (opt_len == 8)
+                    {
+                        /* Pull the timestamp value and echo reply. */
+                        ASSERT(fs_buffer_list_pull_offset(buffer, &opt_param->ts_val, 4, (offset + opt_index), (FS_BUFFER_PACKED | FS_BUFFER_INPLACE)));
+                        ASSERT(fs_buffer_list_pull_offset(buffer, &opt_param->ts_ecr, 4, (offset + opt_index + 4), (FS_BUFFER_PACKED | FS_BUFFER_INPLACE)));
+
+                        /* A timestamp was received. */
+                        opt_param->flags |= TCP_OPT_FLAG_TIME_STAMP;
+                    }
+                    else
+                    {
+                        /* Invalid option was parsed. */
+                        status = NET_INVALID_HDR;
+                    }
+
+                    break;
+#endif
+
                 /* End of option list. */
                 case TCP_OPT_END:
 
@@ -504,8 +596,11 @@ static int32_t tcp_add_option(FS_BUFFER_LIST *buffer, uint8_t type, uint8_t leng
 /*
  * tcp_add_options
  * @buffer: File system buffer in which we need to add TCP options.
- * @port: TCP port for which options are needed to be added.
+ * @mss: Maximum segment size to be sent.
+ * @rcv_wnd_scale: At return this will contain the receive window scale if
+ *  window scale option was added.
  * @opt_flags: TCP option flags defining what TCP options we need to add.
+ * @ts_ecr: Timestamp to be echoed if timestamp option is added.
  * @opt_size: At return this will contain the number of bytes added as part of
  *  TCP options.
  * @flags: Operation flags.
@@ -515,10 +610,16 @@ static int32_t tcp_add_option(FS_BUFFER_LIST *buffer, uint8_t type, uint8_t leng
  * This function will add TCP configuration options for the given TCP port, as
  * defined by the option flags.
  */
-static int32_t tcp_add_options(FS_BUFFER_LIST *buffer, uint16_t mss, uint8_t *rcv_wnd_scale, uint8_t opt_flags, uint8_t *opt_size, uint8_t flags)
+static int32_t tcp_add_options(FS_BUFFER_LIST *buffer, uint16_t mss, uint8_t *rcv_wnd_scale, uint8_t opt_flags, uint32_t ts_ecr, uint8_t *opt_size, uint8_t flags)
 {
     int32_t status = SUCCESS;
     uint8_t ret_size = 0, opt_value_8;
+#ifdef TCP_TIME_STAMP
+    uint8_t ts[8];
+#else
+    /* Remove some compiler warnings. */
+    UNUSED_PARAM(ts_ecr);
+#endif
 
     SYS_LOG_FUNCTION_ENTRY(TCP);
 
@@ -552,6 +653,38 @@ static int32_t tcp_add_options(FS_BUFFER_LIST *buffer, uint16_t mss, uint8_t *rc
         }
     }
 
+#ifdef TCP_SACK
+    /* If remote also permits SACK. */
+    if ((status == SUCCESS) && (opt_flags & TCP_FLAG_SACK))
+    {
+        /* Add SACK permitted option. */
+        status = tcp_add_option(buffer, TCP_OPT_SACK_EN, 2, NULL, flags);
+
+        if (status == SUCCESS)
+        {
+            /* Add number of bytes we have added for SACK permitted option. */
+            ret_size = (uint8_t)(ret_size + 2);
+        }
+    }
+#endif
+
+#ifdef TCP_TIME_STAMP
+    /* If remote is also using timestamps. */
+    if ((status == SUCCESS) && (opt_flags & TCP_FLAG_TIME_STAMP))
+    {
+        /* Add our timestamp and echo the one received from remote. */
+        NET_PUT_BE32(&ts[0], current_system_tick());
+        NET_PUT_BE32(&ts[4], ts_ecr);
+        status = tcp_add_option(buffer, TCP_OPT_TIME_STAMP, 10, ts, flags);
+
+        if (status == SUCCESS)
+        {
+            /* Add number of bytes we have added for timestamp option. */
+            ret_size = (uint8_t)(ret_size + 10);
+        }
+    }
+#endif
+
     /* Align TCP options to a 4-byte boundary. */
     while ((status == SUCCESS) && ((ret_size % 4) != 0))
     {
@@ -573,6 +706,121 @@ static int32_t tcp_add_options(FS_BUFFER_LIST *buffer, uint16_t mss, uint8_t *rc
 
 } /* tcp_add_options */
 
+/*
+ * tcp_build_options
+ * @port: TCP port for which options are needed to be built.
+ * @opt: Buffer in which options will be built, this must have space for
+ *  max_size bytes. If null only the number of bytes of options that would be
+ *  built is returned.
+ * @max_size: Maximum number of bytes of options that can be built, SACK blocks
+ *  that don't fit are not added.
+ * @return: Returns the number of bytes of options built.
+ * This function will build the TCP options sent on segments other than a SYN,
+ * i.e. timestamp and SACK blocks for the out-of-order data we have received.
+ * Timestamp if used is always added first, a retransmitted segment keeps the
+ * timestamp it was first sent with.
+ */
+static uint8_t tcp_build_options(TCP_PORT *port, uint8_t *opt, uint8_t max_size)
+{
+    uint8_t opt_size = 0;
+#ifdef TCP_SACK
+    uint8_t i, num_sack;
+#endif
+
+    SYS_LOG_FUNCTION_ENTRY(TCP);
+
+#if (!defined(TCP_SACK) && !defined(TCP_TIME_STAMP))
+    /* Remove some compiler warnings. */
+    UNUSED_PARAM(port);
+    UNUSED_PARAM(opt);
+    UNUSED_PARAM(max_size);
+#endif
+
+#ifdef TCP_TIME_STAMP
+    /* If timestamps are being used. */
+    if (port->flags & TCP_FLAG_TIME_STAMP)
+    {
+        /* If we need to build the option. */
+        if (opt != NULL)
+        {
+            /* Add timestamp option aligned to a 4-byte boundary. */
+            opt[0] = TCP_OPT_NOP;
+            opt[1] = TCP_OPT_NOP;
+            opt[2] = TCP_OPT_TIME_STAMP;
+            opt[3] = 10;
+            NET_PUT_BE32(&opt[4], current_system_tick());
+            NET_PUT_BE32(&opt[8], port->ts_recent);
+        }
+
+        opt_size = TCP_OPT_TS_SIZE;
+    }
+#endif
+
+#ifdef TCP_SACK
+    /* If SACK is being used, we have some out-of-order data and we have
+     * space for at least one SACK block. */
+    if ((port->flags & TCP_FLAG_SACK) && (port->num_rcv_sack > 0) && (max_size >= (opt_size + 4 + TCP_OPT_SACK_BLOCK_SIZE)))
+    {
+        /* Add as many SACK blocks as we can fit in the options. */
+        num_sack = (uint8_t)MIN(port->num_rcv_sack, ((max_size - opt_size - 4) / TCP_OPT_SACK_BLOCK_SIZE));
+
+        /* If we need to build the option. */
+        if (opt != NULL)
+        {
+            /* Add SACK option aligned to a 4-byte boundary. */
+            opt[opt_size] = TCP_OPT_NOP;
+            opt[opt_size + 1] = TCP_OPT_NOP;
+            opt[opt_size + 2] = TCP_OPT_SACK;
+            opt[opt_size + 3] = (uint8_t)(2 + (num_sack * TCP_OPT_SACK_BLOCK_SIZE));
+
+            /* Add the SACK blocks. */
+            for (i = 0; i < num_sack; i++)
+            {
+                NET_PUT_BE32(&opt[opt_size + 4 + (i * TCP_OPT_SACK_BLOCK_SIZE)], port->rcv_sack[(2 * i)]);
+                NET_PUT_BE32(&opt[opt_size + 8 + (i * TCP_OPT_SACK_BLOCK_SIZE)], port->rcv_sack[(2 * i) + 1]);
+            }
+        }
+
+        opt_size = (uint8_t)(opt_size + 4 + (num_sack * TCP_OPT_SACK_BLOCK_SIZE));
+    }
+#endif
+
+    SYS_LOG_FUNCTION_EXIT(TCP);
+
+    /* Return number of bytes of options built. */
+    return (opt_size);
+
+} /* tcp_build_options */
+
+/*
+ * tcp_send_mss
+ * @port: TCP port for which the segment size is needed.
+ * @return: Returns the maximum number of data bytes that can be sent in a
+ *  segment.
+ * This function will return the maximum number of data bytes that can be sent
+ * in a segment, as the MSS does not count the TCP options (RFC 6691) the
+ * options that will be sent on a segment are subtracted from it.
+ */
+static uint16_t tcp_send_mss(TCP_PORT *port)
+{
+    uint16_t mss = port->mss;
+    uint8_t opt_size;
+
+    /* Get the number of bytes of options we will send on a segment. */
+    opt_size = tcp_build_options(port, NULL, TCP_OPT_MAX_SIZE);
+
+    /* If the options fit in a segment. */
+    if (mss > opt_size)
+    {
+        /* Data can only be sent in space left by the options. */
+        mss = (uint16_t)(mss - opt_size);
+    }
+
+    /* Return the segment size. */
+    return (mss);
+
+} /* tcp_send_mss */
+
 /*
  * tcp_timer_register
  * @port: TCP port for which timer is needed to be registered.
@@ -620,7 +868,8 @@ static void tcp_timer_unregister(TCP_PORT *port)
 /*
  * tcp_timeout_update
  * @port: TCP port for which a timeout was updated.
- * This function will schedule next retransmission on a given TCP port.
+ * This function will schedule next retransmission, delayed ACK or the data
+ * held on a corked port on a given TCP port.
  */
 static void tcp_timeout_update(TCP_PORT *port)
 {
@@ -637,6 +886,24 @@ static void tcp_timeout_update(TCP_PORT *port)
         timeout_enabled = TRUE;
     }
 
+    /* If we need to send a delayed ACK before this. */
+    if ((port->flags & TCP_FLAG_ACK_DELAYED) && ((timeout_enabled == FALSE) || (INT32CMP(timeout, port->ack_timeout) > 0)))
+    {
+        /* We need to send the ACK first. */
+        timeout = port->ack_timeout;
+        timeout_enabled = TRUE;
+    }
+
+    /* If we are holding data on a corked port that is needed to be sent
+     * before this. */
+    if ((port->flags & TCP_FLAG_CORK) && (port->tx_buffer != NULL) && (INT32CMP(port->cork_timeout, current_system_tick()) > 0) &&
+        ((timeout_enabled == FALSE) || (INT32CMP(timeout, port->cork_timeout) > 0)))
+    {
+        /* We need to send the held data first. */
+        timeout = port->cork_timeout;
+        timeout_enabled = TRUE;
+    }
+
     /* If we need to enable timeout. */
     if (timeout_enabled == TRUE)
     {
@@ -660,52 +927,129 @@ static void tcp_timeout_update(TCP_PORT *port)
 } /* tcp_timeout_update */
 
 /*
- * tcp_fast_rtx
- * @port: TCP port for which fast retransmission of a segment is required.
- * @seq_num: Segment sequence number for which fast retransmission is required.
- * This function will schedule fast retransmission of a TCP segment.
+ * tcp_rtx_segment
+ * @port: TCP port on which a segment is needed to be retransmitted.
+ * @rtx: Retransmission structure of the segment.
+ * This function will retransmit a segment if it's buffer has returned. A
+ * segment is retransmitted with the timestamp it was first sent with, so the
+ * remote never sees a timestamp newer than the one on a segment that is still
+ * being sent.
  */
-static void tcp_fast_rtx(TCP_PORT *port, uint32_t seq_num)
+static void tcp_rtx_segment(TCP_PORT *port, TCP_RTX_DATA *rtx)
 {
-    uint32_t i;
     FS_BUFFER_LIST *rtx_buffer;
 
     SYS_LOG_FUNCTION_ENTRY(TCP);
 
+    /* If the buffer we are supposed to retransmit has returned. */
+    if (rtx->flags & TCP_RTX_BUFFER_RETURNED)
+    {
+        /* Clear the buffer returned flag. */
+        rtx->flags &= (uint8_t)~(TCP_RTX_BUFFER_RETURNED);
+
+        /* This segment is now being retransmitted. */
+        rtx->flags |= TCP_RTX_RETRANSMITTED;
+
+        /* Save the RTX buffer. */
+        rtx_buffer = rtx->buffer;
+
+        /* Release the port lock. */
+        fd_release_lock(port);
+
+        /* Acquire the device lock. */
+        ASSERT(fd_get_lock(rtx_buffer->fd));
+
+        /* Retransmit a TCP buffer. */
+        net_device_buffer_transmit(rtx_buffer, NET_PROTO_IPV4, 0);
+
+        /* Release the buffer lock. */
+        fd_release_lock(rtx_buffer->fd);
+
+        /* Acquire the port lock. */
+        ASSERT(fd_get_lock(port));
+    }
+
+    SYS_LOG_FUNCTION_EXIT(TCP);
+
+} /* tcp_rtx_segment */
+
+/*
+ * tcp_rtx_clear_flags
+ * @port: TCP port for which retransmission flags are needed to be cleared.
+ * @flags: Flags needed to be cleared.
+ * This function will clear the given flags on all the segments queued for
+ * retransmission.
+ */
+static void tcp_rtx_clear_flags(TCP_PORT *port, uint8_t flags)
+{
+    uint32_t i;
+
     /* Traverse the RTX list. */
     for (i = 0; i < TCP_NUM_RTX; i++)
     {
-        /* Test if this frame has sequence equal or  greater than the required
-         * sequence number. */
-        if ((port->rtx[i].flags & TCP_RTX_IN_USE) && (port->rtx[i].seq_num == seq_num))
-        {
-            /* If the buffer we are supposed to retransmit has returned. */
-            if (port->rtx[i].flags & TCP_RTX_BUFFER_RETURNED)
-            {
-                /* Clear the buffer returned flag. */
-                port->rtx[i].flags &= (uint8_t)~(TCP_RTX_BUFFER_RETURNED);
+        /* Clear the required flags. */
+        port->rtx[i].flags &= (uint8_t)~(flags);
+    }
 
-                /* Save the RTX buffer. */
-                rtx_buffer = port->rtx[i].buffer;
+} /* tcp_rtx_clear_flags */
 
-                /* Release the port lock. */
-                fd_release_lock(port);
+/*
+ * tcp_fast_rtx
+ * @port: TCP port for which fast retransmission of a segment is required.
+ * @seq_num: Segment sequence number for which fast retransmission is required.
+ * This function will schedule fast retransmission of a TCP segment. If SACK is
+ * being used the first segment from the given sequence that is not SACKed and
+ * not already retransmitted in this recovery is sent, this can be a hole
+ * below the highest SACKed sequence.
+ */
+static void tcp_fast_rtx(TCP_PORT *port, uint32_t seq_num)
+{
+    uint32_t i, high = (seq_num + 1);
+    uint8_t skip_flags = 0;
+    TCP_RTX_DATA *rtx = NULL;
 
-                /* Acquire the device lock. */
-                ASSERT(fd_get_lock(rtx_buffer->fd));
+    SYS_LOG_FUNCTION_ENTRY(TCP);
 
-                /* Retransmit a TCP buffer. */
-                net_device_buffer_transmit(rtx_buffer, NET_PROTO_IPV4, 0);
+    /* Don't take a round trip time sample from a retransmitted segment. */
+    port->cong_flags &= (uint8_t)~(TCP_CONG_RTT);
 
-                /* Release the buffer lock. */
-                fd_release_lock(rtx_buffer->fd);
+#ifdef TCP_SACK
+    /* If SACK is being used. */
+    if (port->flags & TCP_FLAG_SACK)
+    {
+        /* Skip the segments that are SACKed or already retransmitted. */
+        skip_flags = (TCP_RTX_SACKED | TCP_RTX_RETRANSMITTED);
 
-                /* Acquire the port lock. */
-                ASSERT(fd_get_lock(port));
-            }
+        /* If remote has SACKed some data after this sequence. */
+        if (INT32CMP(port->sack_high, high) > 0)
+        {
+            /* Holes below the highest SACKed sequence are lost. */
+            high = port->sack_high;
+        }
+    }
+#endif
+
+    /* Traverse the RTX list. */
+    for (i = 0; i < TCP_NUM_RTX; i++)
+    {
+        /* Test if this segment lies in the required sequence range and is the
+         * first such segment. */
+        if ((port->rtx[i].flags & TCP_RTX_IN_USE) && ((port->rtx[i].flags & skip_flags) == 0) &&
+            (INT32CMP(port->rtx[i].seq_num, seq_num) >= 0) && (INT32CMP(port->rtx[i].seq_num, high) < 0) &&
+            ((rtx == NULL) || (INT32CMP(port->rtx[i].seq_num, rtx->seq_num) < 0)))
+        {
+            /* Save this segment. */
+            rtx = &port->rtx[i];
         }
     }
 
+    /* If we have a segment to retransmit. */
+    if (rtx != NULL)
+    {
+        /* Retransmit this segment. */
+        tcp_rtx_segment(port, rtx);
+    }
+
     /* Update timeout for this port. */
     tcp_timeout_update(port);
 
@@ -724,7 +1068,6 @@ static void tcp_timeout_callback(void *data, int32_t status)
     TCP_PORT *port = (TCP_PORT *)data;
     int32_t i, least_rtx = -1;
     uint8_t rtx_picked = FALSE;
-    FS_BUFFER_LIST *rtx_buffer;
 
     /* Remove some compiler warnings. */
     UNUSED_PARAM(status);
@@ -734,6 +1077,20 @@ static void tcp_timeout_callback(void *data, int32_t status)
     /* Get lock for this port. */
     if (fd_get_lock((FD)port) == SUCCESS)
     {
+        /* If we need to send a delayed ACK. */
+        if ((port->flags & TCP_FLAG_ACK_DELAYED) && (INT32CMP(current_system_tick(), port->ack_timeout) >= 0))
+        {
+            /* Segment (SEQ=SND.NXT, ACK=RCV.NXT, CTL=ACK) */
+            tcp_send_segment(port, &port->socket_address, port->snd_nxt, port->rcv_nxt, (TCP_HDR_FLAG_ACK), (uint16_t)(port->rcv_wnd >> port->rcv_wnd_scale), NULL, FALSE, FS_BUFFER_TH);
+        }
+
+        /* If we have held data on a corked port for too long. */
+        if ((port->state == TCP_SOCK_ESTAB) && (port->flags & TCP_FLAG_CORK) && (port->tx_buffer != NULL))
+        {
+            /* Send the held data if we can. */
+            tcp_tx_buffer_send(port, 0, FS_BUFFER_TH);
+        }
+
         switch (port->state)
         {
         /* If we are in time wait state. */
@@ -792,71 +1149,19 @@ static void tcp_timeout_callback(void *data, int32_t status)
                 /* If we have an retransmission to be invoked. */
                 if ((rtx_picked == TRUE) && (least_rtx >= 0))
                 {
-                    /* If the buffer we are supposed to retransmit has returned. */
-                    if (port->rtx[least_rtx].flags & TCP_RTX_BUFFER_RETURNED)
-                    {
-                        /* Clear the buffer returned flag. */
-                        port->rtx[least_rtx].flags &= (uint8_t)~(TCP_RTX_BUFFER_RETURNED);
-
-                        /* Save the RTX buffer. */
-                        rtx_buffer = port->rtx[least_rtx].buffer;
-
-                        /* Release the port lock. */
-                        fd_release_lock(port);
+                    /* Any segment retransmitted in the last recovery can
+                     * now be retransmitted again. */
+                    tcp_rtx_clear_flags(port, TCP_RTX_RETRANSMITTED);
 
-                        /* Acquire the device lock. */
-                        ASSERT(fd_get_lock(rtx_buffer->fd));
-
-                        /* Retransmit a TCP buffer. */
-                        net_device_buffer_transmit(rtx_buffer, NET_PROTO_IPV4, 0);
-
-                        /* Release the buffer lock. */
-                        fd_release_lock(rtx_buffer->fd);
-
-                        /* Acquire the port lock. */
-                        ASSERT(fd_get_lock(port));
-                    }
-
-                    switch (port->state)
-                    {
-                    /* If we have sent a SYN. */
-                    case TCP_SOCK_SYN_SENT:
-
-                    /* If we are in SYN received state. */
-                    case TCP_SOCK_SYN_RCVD:
-
-                    /* If we are waiting for last ACK. */
-                    case TCP_SOCK_LAST_ACK:
-
-                    /* If we are in FIN-WAIT-1 state. */
-                    case TCP_SOCK_FIN_WAIT_1:
-
-                    /* If we are in closing state. */
-                    case TCP_SOCK_CLOSING:
-
-                        /* Next time out will be at RTO. */
-                        port->rtx_timeout = current_system_tick() + MS_TO_TICK(TCP_RTO);
-
-                        break;
-
-                    /* If we are in established state. */
-                    case TCP_SOCK_ESTAB:
-
-                        /* Double the retransmission timer. */
-                        port->rtx_time = port->rtx_time * 2;
-
-                        /* If we exceeded the maximum value. */
-                        if (port->rtx_time > MS_TO_TICK(TCP_MAX_RTO))
-                        {
-                            /* Use the maximum value. */
-                            port->rtx_time = MS_TO_TICK(TCP_MAX_RTO);
-                        }
+                    /* Retransmit the first unacknowledged segment. */
+                    tcp_rtx_segment(port, &port->rtx[least_rtx]);
 
-                        /* Adjust the retransmission timer. */
-                        port->rtx_timeout = current_system_tick() + port->rtx_time;
+                    /* Update congestion state and back off the
+                     * retransmission timer. */
+                    tcp_cong_timeout(port);
 
-                        break;
-                    }
+                    /* Adjust the retransmission timer. */
+                    port->rtx_timeout = current_system_tick() + port->rtx_time;
                 }
 
             }
@@ -890,8 +1195,9 @@ static void tcp_timeout_callback(void *data, int32_t status)
  * @ack_num: Acknowledgment number to be sent.
  * @flags: TCP flags to be sent.
  * @wnd_size: TCP window size to be sent.
- * @data: TCP segment data needed to be attached to this segment.
- * @data_len: Number of bytes in the data buffer.
+ * @data: Buffer having the TCP segment data, if given the segment is built on
+ *  this buffer, if the segment is not sent the data is returned to the caller
+ *  as it was given.
  * @rtx_on: If TRUE this segment will be retransmitted until stopped, if so any
  *  members passed to this function must remain valid until the life time of
  *  retransmission. Any previous segment queued for retransmission will be
@@ -904,14 +1210,15 @@ static void tcp_timeout_callback(void *data, int32_t status)
  *  to send this frame.
  * This function will send a TCP segment on the networking interface.
  */
-static int32_t tcp_send_segment(TCP_PORT *port, SOCKET_ADDRESS *socket_address, uint32_t seq_num, uint32_t ack_num, uint16_t flags, uint16_t wnd_size, uint8_t *data, int32_t data_len, uint8_t rtx_on, uint8_t buffer_flags)
+static int32_t tcp_send_segment(TCP_PORT *port, SOCKET_ADDRESS *socket_address, uint32_t seq_num, uint32_t ack_num, uint16_t flags, uint16_t wnd_size, FS_BUFFER_LIST *data, uint8_t rtx_on, uint8_t buffer_flags)
 {
     NET_DEV *net_device;
     FS_BUFFER_LIST *buffer = NULL;
     int32_t status = SUCCESS;
     FD buffer_fd;
-    uint8_t opt_size = 0, opt_flags, rcv_wnd_scale;
+    uint8_t opt_size = 0, opt_space, opt_flags, rcv_wnd_scale, opt[TCP_OPT_MAX_SIZE];
     uint16_t csum, mss;
+    uint32_t ts_ecr = 0, data_len = ((data != NULL) ? data->total_length : 0);
     TCP_RTX_DATA *rtx = NULL;
 
     SYS_LOG_FUNCTION_ENTRY(TCP);
@@ -925,6 +1232,33 @@ static int32_t tcp_send_segment(TCP_PORT *port, SOCKET_ADDRESS *socket_address,
         tcp_iss = port->snd_nxt;
     }
 
+    /* If this is neither a SYN nor a RST. */
+    if ((flags & (TCP_HDR_FLAG_SYN | TCP_HDR_FLAG_RST)) == 0)
+    {
+        /* Options are only added in the space the data leaves in MSS. */
+        opt_space = TCP_OPT_MAX_SIZE;
+        if ((data_len > 0) && ((data_len + TCP_OPT_MAX_SIZE) > port->mss))
+        {
+            opt_space = (uint8_t)((port->mss > data_len) ? (port->mss - data_len) : 0);
+        }
+
+        /* Build the options to be sent on this segment. */
+        opt_size = tcp_build_options(port, opt, opt_space);
+    }
+
+    /* If we are sending an ACK. */
+    if (flags & TCP_HDR_FLAG_ACK)
+    {
+        /* This segment will also ACK any data for which the ACK was being
+         * delayed. */
+        port->flags &= (uint8_t)~(TCP_FLAG_ACK_DELAYED);
+
+#ifdef TCP_TIME_STAMP
+        /* Save the last ACK number we have sent. */
+        port->last_ack_sent = ack_num;
+#endif
+    }
+
     /* Get the local networking interface descriptor. */
     net_device = ipv4_get_source_device(socket_address->local_ip);
 
@@ -933,8 +1267,9 @@ static int32_t tcp_send_segment(TCP_PORT *port, SOCKET_ADDRESS *socket_address,
     {
         SYS_LOG_FUNCTION_MSG(TCP, SYS_LOG_DEBUG, "will be using %s for %d.%d.%d.%d", ((FS *)net_device->fd)->name, SYS_LOG_IP(socket_address->local_ip));
 
-        /* Save the device descriptor. */
-        buffer_fd = net_device->fd;
+        /* Save the device descriptor, if we have a data buffer it's
+         * descriptor will be used. */
+        buffer_fd = (data != NULL) ? data->fd : net_device->fd;
 
         /* Release lock for the port. */
         fd_release_lock(port);
@@ -942,8 +1277,17 @@ static int32_t tcp_send_segment(TCP_PORT *port, SOCKET_ADDRESS *socket_address,
         /* Obtain lock for buffer file descriptor. */
         ASSERT(fd_get_lock(buffer_fd) != SUCCESS);
 
-        /* Get a buffer keeping threshold buffers on the descriptor. */
-        buffer = fs_buffer_get(buffer_fd, FS_LIST_FREE, buffer_flags);
+        /* If we have a buffer with the segment data. */
+        if (data != NULL)
+        {
+            /* Build this segment on the data buffer. */
+            buffer = data;
+        }
+        else
+        {
+            /* Get a buffer keeping threshold buffers on the descriptor. */
+            buffer = fs_buffer_get(buffer_fd, FS_LIST_FREE, buffer_flags);
+        }
 
         /* If buffer was not allocated. */
         if (buffer != NULL)
@@ -973,17 +1317,18 @@ static int32_t tcp_send_segment(TCP_PORT *port, SOCKET_ADDRESS *socket_address,
                     /* Save the port for which we will do a retransmission. */
                     rtx->port = port;
 
-                    /* Save the segment length and the sequence number of this buffer. */
+                    /* Save the segment length and the sequence number of this
+                     * buffer, SYN and FIN also occupy a sequence number so
+                     * that they are retransmitted until ACKed. */
                     rtx->seq_num = seq_num;
-                    rtx->seg_len = (uint16_t)data_len;
+                    rtx->seg_len = (uint16_t)(data_len + ((flags & (TCP_HDR_FLAG_SYN | TCP_HDR_FLAG_FIN)) ? 1 : 0));
 
                     /* If retransmission timer is not already running. */
                     if (port->rtx_timeout_enable == FALSE)
                     {
                         /* Save the tick at which we want this buffer to be retransmitted. */
-                        port->rtx_timeout = (current_system_tick() + MS_TO_TICK(TCP_RTO));
+                        port->rtx_timeout = (current_system_tick() + port->rtx_time);
                         port->rtx_timeout_enable = TRUE;
-                        port->rtx_time = MS_TO_TICK(TCP_RTO);
                     }
                 }
                 else
@@ -999,14 +1344,7 @@ static int32_t tcp_send_segment(TCP_PORT *port, SOCKET_ADDRESS *socket_address,
                 ASSERT(fd_get_lock(buffer_fd) != SUCCESS);
             }
 
-            /* If we do have some data to attach on this segment. */
-            if ((status == SUCCESS) && (data != NULL))
-            {
-                /* Add given data on the buffer. */
-                status = fs_buffer_list_push(buffer, data, (uint32_t)data_len, buffer_flags);
-            }
-
-            /* If segment data was successfully added on the buffer. */
+            /* If we can now build this segment. */
             if (status == SUCCESS)
             {
                 /* If SYN is being sent. */
@@ -1023,6 +1361,12 @@ static int32_t tcp_send_segment(TCP_PORT *port, SOCKET_ADDRESS *socket_address,
                     {
                         /* Send all supported options. */
                         opt_flags = (TCP_FLAG_WND_SCALE | TCP_FLAG_MSS);
+#ifdef TCP_SACK
+                        opt_flags |= TCP_FLAG_SACK;
+#endif
+#ifdef TCP_TIME_STAMP
+                        opt_flags |= TCP_FLAG_TIME_STAMP;
+#endif
                     }
                     else
                     {
@@ -1033,6 +1377,9 @@ static int32_t tcp_send_segment(TCP_PORT *port, SOCKET_ADDRESS *socket_address,
                     /* Save the maximum segment size and port window scale. */
                     mss = port->mss;
                     rcv_wnd_scale = port->rcv_wnd_scale;
+#ifdef TCP_TIME_STAMP
+                    ts_ecr = port->ts_recent;
+#endif
 
                     /* Release lock for the port. */
                     fd_release_lock(port);
@@ -1041,7 +1388,7 @@ static int32_t tcp_send_segment(TCP_PORT *port, SOCKET_ADDRESS *socket_address,
                     ASSERT(fd_get_lock(buffer_fd) != SUCCESS);
 
                     /* Add TCP configuration options. */
-                    status = tcp_add_options(buffer, mss, &rcv_wnd_scale, opt_flags, &opt_size, (buffer_flags & (uint8_t)(~FS_BUFFER_SUSPEND)));
+                    status = tcp_add_options(buffer, mss, &rcv_wnd_scale, opt_flags, ts_ecr, &opt_size, (buffer_flags & (uint8_t)(~FS_BUFFER_SUSPEND)));
 
                     /* Release lock for buffer descriptor. */
                     fd_release_lock(buffer_fd);
@@ -1058,6 +1405,13 @@ static int32_t tcp_send_segment(TCP_PORT *port, SOCKET_ADDRESS *socket_address,
                     /* Obtain lock for buffer file descriptor. */
                     ASSERT(fd_get_lock(buffer_fd) != SUCCESS);
                 }
+
+                /* If we have built some options for this segment. */
+                else if (opt_size > 0)
+                {
+                    /* Push the options before the TCP header. */
+                    status = fs_buffer_list_push(buffer, opt, opt_size, (uint8_t)(buffer_flags | FS_BUFFER_HEAD));
+                }
             }
 
             if (status == SUCCESS)
@@ -1136,12 +1490,22 @@ static int32_t tcp_send_segment(TCP_PORT *port, SOCKET_ADDRESS *socket_address,
                 buffer->free = NULL;
                 buffer->free_data = 0;
 
-                /* Add the allocated buffer back to the descriptor. */
-                fs_buffer_add_list_list(buffer, FS_LIST_FREE, FS_BUFFER_ACTIVE);
-            }
-
-            /* If segment was not sent and we allocated a retransmission structure. */
-            if ((status != SUCCESS) && (rtx != NULL))
+                /* If segment was built on the caller's data. */
+                if (data != NULL)
+                {
+                    /* Remove the headers we have added, the data is returned
+                     * to the caller. */
+                    ASSERT(fs_buffer_list_pull(buffer, NULL, (buffer->total_length - data_len), 0) != SUCCESS);
+                }
+                else
+                {
+                    /* Add the allocated buffer back to the descriptor. */
+                    fs_buffer_add_list_list(buffer, FS_LIST_FREE, FS_BUFFER_ACTIVE);
+                }
+            }
+
+            /* If segment was not sent and we allocated a retransmission structure. */
+            if ((status != SUCCESS) && (rtx != NULL))
             {
                 /* Clear the RTX flags to free it. */
                 rtx->flags = 0;
@@ -1260,11 +1624,28 @@ static void tcp_process_finbit(TCP_PORT *port, uint32_t fin_seq)
     /* RCV.NXT = SEG.SEQ + 1. */
     port->rcv_nxt = fin_seq + 1;
 
-    /* Segment (SEQ=SND.NXT, ACK=RCV.NXT, CTL=ACK). */
-    tcp_send_segment(port, &port->socket_address, port->snd_nxt, port->rcv_nxt, (TCP_HDR_FLAG_ACK | TCP_HDR_FLAG_FIN), (uint16_t)(port->rcv_wnd >> port->rcv_wnd_scale), NULL, 0, FALSE, FS_BUFFER_TH);
+    /* If we have not yet sent our FIN. */
+    if ((port->state == TCP_SOCK_ESTAB) || (port->state == TCP_SOCK_SYN_RCVD))
+    {
+        /* Queue our FIN after the data we are holding, it will be sent once
+         * the send window allows all the held data to be sent. */
+        port->tx_flags |= TCP_TX_FLAG_FIN;
 
-    /* FIN was sent. */
-    port->snd_nxt = (port->snd_una + 1);
+        /* Send the data we can and our FIN if nothing is held. */
+        tcp_tx_buffer_send(port, TCP_TX_PUSH, FS_BUFFER_TH);
+
+        /* If our FIN is still queued. */
+        if (port->tx_flags & TCP_TX_FLAG_FIN)
+        {
+            /* Segment (SEQ=SND.NXT, ACK=RCV.NXT, CTL=ACK). */
+            tcp_send_segment(port, &port->socket_address, port->snd_nxt, port->rcv_nxt, (TCP_HDR_FLAG_ACK), (uint16_t)(port->rcv_wnd >> port->rcv_wnd_scale), NULL, FALSE, FS_BUFFER_TH);
+        }
+    }
+    else
+    {
+        /* Segment (SEQ=SND.NXT, ACK=RCV.NXT, CTL=ACK). */
+        tcp_send_segment(port, &port->socket_address, port->snd_nxt, port->rcv_nxt, (TCP_HDR_FLAG_ACK), (uint16_t)(port->rcv_wnd >> port->rcv_wnd_scale), NULL, FALSE, FS_BUFFER_TH);
+    }
 
     SYS_LOG_FUNCTION_EXIT(TCP);
 
@@ -1291,11 +1672,11 @@ static uint8_t tcp_oo_buffer_process(void *node, void *param)
     /* Pull the sequence number for these buffers. */
     ASSERT(fs_buffer_list_pull(buffer, &seg_seq, 4, (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
 
-    /* If this segment comes before the segment we need to insert. */
-    if (seg_seq > oo_param->seg_seq)
+    /* If this segment comes after the segment we need to insert. */
+    if (INT32CMP(seg_seq, oo_param->seg_seq) > 0)
     {
         /* If this segment overlaps the next segment. */
-        if ((oo_param->seg_seq + oo_param->seg_len) >= seg_seq)
+        if (INT32CMP((oo_param->seg_seq + oo_param->seg_len), seg_seq) > 0)
         {
             /* This is a conflicting segment. */
             oo_param->flags |= TCP_FLAG_SEG_CONFLICT;
@@ -1305,6 +1686,14 @@ static uint8_t tcp_oo_buffer_process(void *node, void *param)
         stop = TRUE;
     }
 
+    /* If this segment overlaps the segment we need to insert. */
+    else if (INT32CMP((seg_seq + (buffer->total_length - 4)), oo_param->seg_seq) > 0)
+    {
+        /* This is a conflicting segment, most probably a duplicate. */
+        oo_param->flags |= TCP_FLAG_SEG_CONFLICT;
+        stop = TRUE;
+    }
+
     SYS_LOG_FUNCTION_EXIT(TCP);
 
     /* Return if we need to insert this fragment here. */
@@ -1320,7 +1709,9 @@ static uint8_t tcp_oo_buffer_process(void *node, void *param)
  * @seg_seq: Received segment sequence.
  * @return: A success status will be returned if the received buffer was
  *  successfully merged.
- * This function will merge received buffers on this port.
+ * This function will merge received buffers on this port. ACK for new data
+ * received in order is delayed as per RFC 1122, ACK is sent right away for
+ * every second segment or if a segment was received out-of-order.
  */
 static int32_t tcp_rx_buffer_merge(TCP_PORT *port, FS_BUFFER_LIST *buffer, uint16_t seg_len, uint32_t seg_seq)
 {
@@ -1329,6 +1720,9 @@ static int32_t tcp_rx_buffer_merge(TCP_PORT *port, FS_BUFFER_LIST *buffer, uint1
     FS_BUFFER_LIST *prev_buffer = NULL;
     TCP_OO_PARAM oo_param;
     uint8_t new_data = FALSE;
+#if (TCP_DELAYED_ACK > 0)
+    uint8_t in_order = (port->rx_buffer.oorx_list.head == NULL);
+#endif
 
     SYS_LOG_FUNCTION_ENTRY(TCP);
 
@@ -1338,6 +1732,15 @@ static int32_t tcp_rx_buffer_merge(TCP_PORT *port, FS_BUFFER_LIST *buffer, uint1
     /* Remove all the data from the buffer except the actual TCP segment. */
     fs_buffer_list_pull(buffer, NULL, (buffer->total_length - seg_len), 0);
 
+    /* If this segment also has some data we have already received. */
+    if (INT32CMP(seg_seq, port->rcv_nxt) < 0)
+    {
+        /* Remove the data we have already received. */
+        fs_buffer_list_pull(buffer, NULL, (port->rcv_nxt - seg_seq), 0);
+        seg_len = (uint16_t)(seg_len - (port->rcv_nxt - seg_seq));
+        seg_seq = port->rcv_nxt;
+    }
+
     /* SEG.SEQ = RCV.NXT ? */
     if (seg_seq == port->rcv_nxt)
     {
@@ -1366,35 +1769,40 @@ static int32_t tcp_rx_buffer_merge(TCP_PORT *port, FS_BUFFER_LIST *buffer, uint1
         port->rcv_nxt = seg_seq + seg_len;
 
         /* Process any out-of-order buffers we have already received. */
-        for (buffer = port->rx_buffer.oorx_list.head; (buffer != NULL); buffer = buffer->next)
+        while (port->rx_buffer.oorx_list.head != NULL)
         {
-            /* Pull the sequence number for this buffer. */
-            ASSERT(fs_buffer_list_pull(buffer, &seg_seq, 4, (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
+            /* Pull the sequence number for the first buffer. */
+            ASSERT(fs_buffer_list_pull(port->rx_buffer.oorx_list.head, &seg_seq, 4, (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
+
+            /* If there is still a hole before this buffer. */
+            if (INT32CMP(seg_seq, port->rcv_nxt) > 0)
+            {
+                /* Just break as this list is already sorted, rest of the
+                 * buffers are kept until the hole is filled. */
+                break;
+            }
+
+            /* Remove this buffer from the out-of-order buffer list. */
+            buffer = sll_pop(&port->rx_buffer.oorx_list, OFFSETOF(FS_BUFFER_LIST, next));
+
+            /* Pull and remove the sequence number we added. */
+            ASSERT(fs_buffer_list_pull(buffer, NULL, 4, 0) != SUCCESS);
 
-            /* If this is the anticipated next segment. */
-            if (port->rcv_nxt == seg_seq)
+            /* If this buffer has some new data. */
+            if (INT32CMP((seg_seq + buffer->total_length), port->rcv_nxt) > 0)
             {
-                /* Pull and remove the sequence number we added. */
-                ASSERT(fs_buffer_list_pull(buffer, NULL, 4, 0) != SUCCESS);
+                /* Remove the data we have already received. */
+                fs_buffer_list_pull(buffer, NULL, (port->rcv_nxt - seg_seq), 0);
 
                 /* RCV.NXT := HSEG.SEQ + HSEG.LEN */
-                port->rcv_nxt = seg_seq + buffer->total_length;
+                port->rcv_nxt = port->rcv_nxt + buffer->total_length;
 
                 /* Move all the data from this buffer to the receive buffer. */
                 fs_buffer_list_move_data(port->rx_buffer.buffer, buffer, 0);
             }
-            else
-            {
-                /* Just break as this list is already sorted. */
-                break;
-            }
-        }
 
-        if (port->rx_buffer.oorx_list.head != NULL)
-        {
-            /* Clear any remaining buffers in the out-of-order buffer list. */
-            fs_buffer_add_list_list(port->rx_buffer.oorx_list.head, FS_LIST_FREE, FS_BUFFER_ACTIVE);
-            port->rx_buffer.oorx_list.head = port->rx_buffer.oorx_list.tail = NULL;
+            /* Free this buffer. */
+            fs_buffer_add(buffer->fd, buffer, FS_LIST_FREE, FS_BUFFER_ACTIVE);
         }
 
         /* Move receive window back to original. */
@@ -1436,6 +1844,15 @@ static int32_t tcp_rx_buffer_merge(TCP_PORT *port, FS_BUFFER_LIST *buffer, uint1
         }
     }
 
+#ifdef TCP_SACK
+    /* If SACK is being used. */
+    if (port->flags & TCP_FLAG_SACK)
+    {
+        /* Update the SACK blocks to be sent to the remote. */
+        tcp_sack_update(port, seg_seq);
+    }
+#endif
+
     /* Release semaphore for the buffer file descriptor. */
     fd_release_lock(buffer_fd);
 
@@ -1448,8 +1865,25 @@ static int32_t tcp_rx_buffer_merge(TCP_PORT *port, FS_BUFFER_LIST *buffer, uint1
             tcp_resume_socket(port, FS_BLOCK_READ);
         }
 
-        /* Segment (SEQ=SND.NXT, ACK=RCV.NXT, CTL=ACK) */
-        tcp_send_segment(port, &port->socket_address, port->snd_nxt, port->rcv_nxt, (TCP_HDR_FLAG_ACK), (uint16_t)(port->rcv_wnd >> port->rcv_wnd_scale), NULL, 0, FALSE, FS_BUFFER_TH);
+#if (TCP_DELAYED_ACK > 0)
+        /* If we have received new data in order, and we are not already
+         * delaying an ACK, ACK for every second segment is sent right away. */
+        if ((new_data == TRUE) && (in_order == TRUE) && (port->rx_buffer.oorx_list.head == NULL) &&
+            ((port->flags & TCP_FLAG_ACK_DELAYED) == 0))
+        {
+            /* Delay the ACK for this segment. */
+            port->flags |= TCP_FLAG_ACK_DELAYED;
+            port->ack_timeout = current_system_tick() + MS_TO_TICK(TCP_DELAYED_ACK);
+
+            /* Update timeout for this port. */
+            tcp_timeout_update(port);
+        }
+        else
+#endif
+        {
+            /* Segment (SEQ=SND.NXT, ACK=RCV.NXT, CTL=ACK) */
+            tcp_send_segment(port, &port->socket_address, port->snd_nxt, port->rcv_nxt, (TCP_HDR_FLAG_ACK), (uint16_t)(port->rcv_wnd >> port->rcv_wnd_scale), NULL, FALSE, FS_BUFFER_TH);
+        }
     }
 
     SYS_LOG_FUNCTION_EXIT_STATUS(TCP, status);
@@ -1471,9 +1905,8 @@ static void tcp_buffer_get_ihl_flags(FS_BUFFER_LIST *buffer, uint8_t *ihl, uint1
 {
     SYS_LOG_FUNCTION_ENTRY(TCP);
 
-    /* Peek the version and IHL. */
-    ASSERT(fs_buffer_list_pull_offset(buffer, ihl, 1, IPV4_HDR_VER_IHL_OFFSET, FS_BUFFER_INPLACE) != SUCCESS);
-    (*ihl) = (uint8_t)(((*ihl) & IPV4_HDR_IHL_MASK) << 2);
+    /* Pick the TCP header offset as saved by IPv4. */
+    (*ihl) = (uint8_t)buffer->meta.l4_offset;
 
     /* Pull the TCP flags. */
     ASSERT(fs_buffer_list_pull_offset(buffer, flags, 2, (uint32_t)((*ihl) + TCP_HRD_FLAGS_OFFSET), (FS_BUFFER_PACKED | FS_BUFFER_INPLACE)));
@@ -1623,25 +2056,118 @@ static int32_t tcp_read_data(void *fd, uint8_t *buffer, int32_t size)
  * @return: Number of bytes sent.
  *  NET_CLOSED will be returned if socket is not in established state and we
  *  cannot send any more data.
- * This function will write a buffer on the TCP socket.
+ * This function will write a file system buffer on the TCP socket without
+ * copying the data. Buffer must be allocated from the networking device for
+ * this port, it is consumed in any case. Data is sent in segments of at most
+ * MSS that are built on the given buffer, and the buffers are returned to the
+ * networking device when the data is ACKed. This will return once at most a
+ * segment worth of data is being held on the port.
  */
 static int32_t tcp_write_buffer(void *fd, const uint8_t *buffer, int32_t size)
 {
     TCP_PORT *port = (TCP_PORT *)fd;
-    int32_t nbytes = 0;
+    FS_BUFFER_LIST *fs_buffer = (FS_BUFFER_LIST *)buffer;
+    FD buffer_fd = fs_buffer->fd;
+    int32_t nbytes = (int32_t)fs_buffer->total_length, status = SUCCESS;
 
     SYS_LOG_FUNCTION_ENTRY(TCP);
 
-    /* For now unused. */
+    /* Size of buffer is used. */
     UNUSED_PARAM(size);
-    UNUSED_PARAM(port);
-    UNUSED_PARAM(nbytes);
-    UNUSED_PARAM(buffer);
 
-    /* Not supported. */
-    ASSERT(TRUE);
+    /* Obtain lock for buffer file descriptor. */
+    ASSERT(fd_get_lock(buffer_fd) != SUCCESS);
 
-    SYS_LOG_FUNCTION_EXIT(TCP);
+    /* We will only send data in established state and if we have some data
+     * to send. */
+    if ((port->state == TCP_SOCK_ESTAB) && (nbytes > 0))
+    {
+        /* We will compute checksum of this data when it is sent. */
+        fs_buffer->meta.csum = 0;
+        fs_buffer->meta.csum_length = 0;
+
+        /* If we are already holding some data. */
+        if (port->tx_buffer != NULL)
+        {
+            /* Should never happen. */
+            ASSERT(port->tx_buffer->fd != buffer_fd);
+
+            /* Move the data from this buffer at the end of existing data. */
+            fs_buffer_list_move_data(port->tx_buffer, fs_buffer, 0);
+            port->tx_buffer->meta.csum = 0;
+            port->tx_buffer->meta.csum_length = 0;
+
+            /* Add this buffer back to the descriptor. */
+            fs_buffer_add(buffer_fd, fs_buffer, FS_LIST_FREE, FS_BUFFER_ACTIVE);
+        }
+        else
+        {
+            /* Hold this buffer on the port. */
+            port->tx_buffer = fs_buffer;
+
+            /* Save the tick at which this data is sent if port is corked. */
+            port->cork_timeout = current_system_tick() + MS_TO_TICK(TCP_CORK_TIMEOUT);
+        }
+
+        /* Release lock for buffer descriptor. */
+        fd_release_lock(buffer_fd);
+
+        /* While we have more than a segment of data to send. */
+        while (status == SUCCESS)
+        {
+            /* Send the data we can. */
+            status = tcp_tx_buffer_send(port, 0, (FS_BUFFER_TH | FS_BUFFER_SUSPEND));
+
+            /* If we are now holding less than a segment of data. */
+            if ((status != SUCCESS) || (port->tx_buffer == NULL) || (port->tx_buffer->total_length < tcp_send_mss(port)))
+            {
+                break;
+            }
+
+            /* Set flag that we don't have any more space in this TCP port. */
+            fd_space_consumed(fd);
+
+            /* Wait for space to become available. */
+            status = tcp_port_wait(port, FS_BLOCK_WRITE);
+
+            /* If we can no longer send data on this socket. */
+            if ((status == SUCCESS) && (port->state != TCP_SOCK_ESTAB))
+            {
+                /* Return an error. */
+                status = NET_CLOSED;
+            }
+        }
+
+        /* If there is no space to send more data. */
+        if ((status == SUCCESS) && (tcp_send_space(port) <= ((port->tx_buffer != NULL) ? port->tx_buffer->total_length : 0)))
+        {
+            /* Space is now consumed for this fd. */
+            fd_space_consumed(fd);
+        }
+
+        if (status != SUCCESS)
+        {
+            /* Return this status to the caller. */
+            nbytes = status;
+        }
+    }
+    else
+    {
+        /* Add this buffer back to the descriptor. */
+        fs_buffer_add(buffer_fd, fs_buffer, FS_LIST_FREE, FS_BUFFER_ACTIVE);
+
+        /* Release lock for buffer descriptor. */
+        fd_release_lock(buffer_fd);
+
+        /* If we cannot write data on this socket. */
+        if (port->state != TCP_SOCK_ESTAB)
+        {
+            /* Return an error. */
+            status = nbytes = NET_CLOSED;
+        }
+    }
+
+    SYS_LOG_FUNCTION_EXIT_STATUS(TCP, status);
 
     /* Return number of bytes sent. */
     return (nbytes);
@@ -1656,13 +2182,15 @@ static int32_t tcp_write_buffer(void *fd, const uint8_t *buffer, int32_t size)
  * @return: Number of bytes sent.
  *  NET_CLOSED will be returned if socket is not in established state and we
  *  cannot send any more data.
- * This function will write a given data buffer on the TCP socket.
+ * This function will write a given data buffer on the TCP socket, data is
+ * added on the segment being built and is sent as per Nagle's algorithm.
  */
 static int32_t tcp_write_data(void *fd, const uint8_t *buffer, int32_t size)
 {
     TCP_PORT *port = (TCP_PORT *)fd;
     int32_t nbytes = 0, status = SUCCESS;
     int32_t sent = 0;
+    uint32_t pending, space;
 
     SYS_LOG_FUNCTION_ENTRY(TCP);
 
@@ -1674,101 +2202,690 @@ static int32_t tcp_write_data(void *fd, const uint8_t *buffer, int32_t size)
         /* While we have something to transmit. */
         while ((status == SUCCESS) && (size > 0))
         {
-            /* Verify that we do have space in the send window to send some data. */
-            if ((port->snd_wnd != 0) && (port->mss != 0))
+            /* Get the number of bytes already waiting to be sent. */
+            pending = (port->tx_buffer != NULL) ? port->tx_buffer->total_length : 0;
+
+            /* Get the space we have to send new data, a segment is not
+             * allowed to grow larger than MSS. */
+            space = MIN(tcp_send_space(port), tcp_send_mss(port));
+
+            /* Verify that we do have space to add some data in the segment
+             * being built. */
+            if (space > pending)
             {
-                /* If we need to send more data then we can send in a single segment. */
-                if (size > port->mss)
+                /* If we need to send more data then we can add in this
+                 * segment. */
+                if (size > (int32_t)(space - pending))
                 {
-                    /* Only send data that can be sent in a single segment. */
-                    nbytes = port->mss;
+                    /* Only add data that can be sent in this segment. */
+                    nbytes = (int32_t)(space - pending);
                 }
+                else
+                {
+                    /* Add all the data. */
+                    nbytes = size;
+                }
+
+                /* Add data on the segment being built. */
+                status = tcp_tx_buffer_add(port, buffer, nbytes);
 
-                /* If we need to send more data then we can send in send window. */
-                else if (size > (int32_t)port->snd_wnd)
+                if (status == SUCCESS)
                 {
-                    /* Only send data that can be sent in a send window. */
-                    nbytes = (int32_t)port->snd_wnd;
+                    /* Add the number of bytes sent. */
+                    sent += nbytes;
+
+                    /* Move ahead the buffer pointer. */
+                    buffer += nbytes;
+                    size -= nbytes;
+
+                    /* Send this segment if we can. */
+                    status = tcp_tx_buffer_send(port, 0, (FS_BUFFER_TH | FS_BUFFER_SUSPEND));
+
+                    if (status == SUCCESS)
+                    {
+                        /* If there is no space to send more data. */
+                        if (tcp_send_space(port) <= ((port->tx_buffer != NULL) ? port->tx_buffer->total_length : 0))
+                        {
+                            /* Space is now consumed for this fd. */
+                            fd_space_consumed(fd);
+                        }
+                    }
+                }
+
+                if (status != SUCCESS)
+                {
+                    /* Return this status to the caller. */
+                    sent = status;
+                }
+            }
+            else
+            {
+                /* Set flag that we don't have any more space in this TCP port. */
+                fd_space_consumed(fd);
+
+                /* If we have a connection, wait for space rather than
+                 * returning a partial write, as now data is sent in segments
+                 * the window can be filled in the middle of a write. */
+                if (port->mss != 0)
+                {
+                    /* Wait for space to become available again. */
+                    status = tcp_port_wait(port, FS_BLOCK_WRITE);
+
+                    /* If we can no longer send data on this socket. */
+                    if ((status == SUCCESS) && (port->state != TCP_SOCK_ESTAB))
+                    {
+                        /* Return an error. */
+                        status = NET_CLOSED;
+                    }
+
+                    if (status != SUCCESS)
+                    {
+                        /* Return this status to the caller. */
+                        sent = status;
+                    }
                 }
                 else
                 {
-                    /* Send number of bytes we can send. */
-                    nbytes = size;
+                    break;
+                }
+            }
+        }
+    }
+    else
+    {
+        /* We cannot write data on this socket, return an error. */
+        status = sent = NET_CLOSED;
+    }
+
+    SYS_LOG_FUNCTION_EXIT_STATUS(TCP, status);
+
+    /* Return number of bytes sent. */
+    return (sent);
+
+} /* tcp_write_data */
+
+/*
+ * tcp_tx_buffer_add
+ * @port: TCP port on which data is being written.
+ * @data: Data needed to be added.
+ * @size: Number of bytes to be added.
+ * @return: A success status will be returned if data was successfully added,
+ *  FS_BUFFER_NO_SPACE will be returned if we ran out of buffers,
+ *  NET_INVALID_FD will be returned if a valid device was not found to send
+ *  this data, NET_CLOSED will be returned if socket was closed while we were
+ *  adding this data.
+ * This function will add data at the end of the segment being built on a TCP
+ * port, checksum of the data is also updated so that it is not again
+ * traversed when this segment is sent.
+ */
+static int32_t tcp_tx_buffer_add(TCP_PORT *port, const uint8_t *data, int32_t size)
+{
+    FS_BUFFER_LIST *tx_buffer = port->tx_buffer, *held;
+    NET_DEV *net_device;
+    FD buffer_fd = NULL;
+    int32_t status = SUCCESS;
+    uint32_t csum;
+
+    SYS_LOG_FUNCTION_ENTRY(TCP);
+
+    /* If we are not already building a segment. */
+    if (tx_buffer == NULL)
+    {
+        /* Get the local networking interface descriptor. */
+        net_device = ipv4_get_source_device(port->socket_address.local_ip);
+
+        /* If we have a valid networking device. */
+        if (net_device != NULL)
+        {
+            /* Segment will be built on a buffer from this device. */
+            buffer_fd = net_device->fd;
+        }
+        else
+        {
+            /* Networking device was not resolved. */
+            status = NET_INVALID_FD;
+        }
+    }
+    else
+    {
+        /* Use the descriptor for existing buffer. */
+        buffer_fd = tx_buffer->fd;
+    }
+
+    if (status == SUCCESS)
+    {
+        /* Remove this buffer from the port while we add data on it, so it is
+         * not sent while the port is not locked. */
+        port->tx_buffer = NULL;
+
+        /* Release lock for the port. */
+        fd_release_lock(port);
+
+        /* Obtain lock for buffer file descriptor. */
+        ASSERT(fd_get_lock(buffer_fd) != SUCCESS);
+
+        /* If we don't have a buffer yet. */
+        if (tx_buffer == NULL)
+        {
+            /* Get a buffer keeping threshold buffers on the descriptor. */
+            tx_buffer = fs_buffer_get(buffer_fd, FS_LIST_FREE, (FS_BUFFER_TH | FS_BUFFER_SUSPEND));
+        }
+
+        /* If we do have a buffer. */
+        if (tx_buffer != NULL)
+        {
+            /* Add given data at the end of the buffer. */
+            status = fs_buffer_list_push(tx_buffer, (uint8_t *)data, (uint32_t)size, (FS_BUFFER_TH | FS_BUFFER_SUSPEND));
+
+            /* If data was added. */
+            if (status == SUCCESS)
+            {
+                /* Calculate checksum of the data while it is still
+                 * contiguous. */
+                csum = net_csum_partial(data, (uint32_t)size, 0);
+
+                /* If this data starts at an odd byte. */
+                if (tx_buffer->meta.csum_length & 0x1)
+                {
+                    /* Swap the checksum of this data. */
+                    csum = NET_CSUM_SWAP(csum);
                 }
 
-                if (nbytes > 0)
-                {
-                    /* Send a TCP segment with required data. */
-                    status = tcp_send_segment(port, &port->socket_address, port->snd_nxt, port->rcv_nxt, (TCP_HDR_FLAG_ACK), (uint16_t)(port->rcv_wnd >> port->rcv_wnd_scale), (uint8_t *)buffer, nbytes, TRUE, (FS_BUFFER_TH | FS_BUFFER_SUSPEND));
+                /* Add this data in the payload checksum. */
+                csum += tx_buffer->meta.csum;
+                NET_CSUM_FOLD(csum);
+                tx_buffer->meta.csum = csum;
+                tx_buffer->meta.csum_length = (uint16_t)(tx_buffer->meta.csum_length + size);
+            }
+
+            /* If we don't have any data on this buffer. */
+            else if (tx_buffer->total_length == 0)
+            {
+                /* Add this buffer back to the descriptor. */
+                fs_buffer_add(buffer_fd, tx_buffer, FS_LIST_FREE, FS_BUFFER_ACTIVE);
+                tx_buffer = NULL;
+            }
+        }
+        else
+        {
+            /* There are not buffers available to send data. */
+            status = FS_BUFFER_NO_SPACE;
+        }
+
+        /* Release lock for buffer descriptor. */
+        fd_release_lock(buffer_fd);
+
+        /* Lock the TCP port. */
+        ASSERT(fd_get_lock(port));
+
+        /* If socket was closed while we were adding the data, data can
+         * still be added before a FIN that is queued. */
+        if ((tx_buffer != NULL) && (port->state != TCP_SOCK_ESTAB) && ((port->state != TCP_SOCK_LAST_ACK) || ((port->tx_flags & TCP_TX_FLAG_FIN) == 0)))
+        {
+            ASSERT(fd_get_lock(buffer_fd));
+
+            /* Add this buffer back to the descriptor. */
+            fs_buffer_add(buffer_fd, tx_buffer, FS_LIST_FREE, FS_BUFFER_ACTIVE);
+            tx_buffer = NULL;
+
+            /* Release lock for buffer descriptor. */
+            fd_release_lock(buffer_fd);
+
+            /* We cannot write data on this socket, return an error. */
+            status = NET_CLOSED;
+        }
+
+        /* If this is the first data on the segment. */
+        if ((port->tx_buffer == NULL) && (tx_buffer != NULL) && (tx_buffer->total_length == (uint32_t)size))
+        {
+            /* Save the tick at which this data is sent if port is corked. */
+            port->cork_timeout = current_system_tick() + MS_TO_TICK(TCP_CORK_TIMEOUT);
+        }
+
+        /* If we still have a buffer. */
+        if (tx_buffer != NULL)
+        {
+            /* Put back the buffer on the port, any data that was put back on
+             * the port in the meantime comes before it. */
+            held = port->tx_buffer;
+            port->tx_buffer = tx_buffer;
+
+            if (held != NULL)
+            {
+                tcp_tx_buffer_prepend(port, held);
+            }
+        }
+    }
+
+    SYS_LOG_FUNCTION_EXIT_STATUS(TCP, status);
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* tcp_tx_buffer_add */
+
+/*
+ * tcp_tx_buffer_prepend
+ * @port: TCP port on which data is being held.
+ * @buffer: Data that was removed from the start of the held data.
+ * This function will put back the data that was removed from the port while
+ * the port was not locked, if some data was held on the port in the meantime
+ * given data is added before it.
+ */
+static void tcp_tx_buffer_prepend(TCP_PORT *port, FS_BUFFER_LIST *buffer)
+{
+    FD buffer_fd = buffer->fd;
+
+    /* If some data was held on the port in the meantime. */
+    if (port->tx_buffer != NULL)
+    {
+        /* Should never happen. */
+        ASSERT(port->tx_buffer->fd != buffer_fd);
+
+        /* Obtain lock for buffer file descriptor. */
+        ASSERT(fd_get_lock(buffer_fd) != SUCCESS);
+
+        /* Move the given data at the start of the held data, the payload
+         * checksum of the held data covers it's last bytes so it remains
+         * valid. */
+        fs_buffer_list_move_data(port->tx_buffer, buffer, FS_BUFFER_HEAD);
+
+        /* Add this buffer back to the descriptor. */
+        fs_buffer_add(buffer_fd, buffer, FS_LIST_FREE, FS_BUFFER_ACTIVE);
+
+        /* Release lock for buffer descriptor. */
+        fd_release_lock(buffer_fd);
+    }
+    else
+    {
+        /* Hold this data on the port. */
+        port->tx_buffer = buffer;
+    }
+
+} /* tcp_tx_buffer_prepend */
+
+/*
+ * tcp_tx_buffer_send
+ * @port: TCP port on which the data being held is needed to be sent.
+ * @tx_flags: Transmit flags.
+ *  TCP_TX_PUSH: Send the data even if it is being held by Nagle's algorithm
+ *   or cork.
+ * @buffer_flags: Buffer flags to be used.
+ * @return: A success status will be returned if the data was either sent or
+ *  is still being held, otherwise error status from tcp_send_segment will be
+ *  returned, NET_CLOSED will be returned if socket was closed while we were
+ *  sending the data.
+ * This function will send the data being held on a TCP port in segments of at
+ * most MSS. A segment smaller than MSS is held while the port is corked, or as
+ * per Nagle's algorithm while we have unacknowledged data unless TCP_NODELAY
+ * is set. Data is only sent as allowed by the send window and free
+ * retransmission structures, a segment that is not sent is put back at the
+ * start of the held data. If a FIN is queued it is sent once all the held
+ * data has been sent.
+ */
+static int32_t tcp_tx_buffer_send(TCP_PORT *port, uint8_t tx_flags, uint8_t buffer_flags)
+{
+    FS_BUFFER_LIST *tx_buffer, *remaining;
+    FD buffer_fd;
+    int32_t status = SUCCESS;
+    uint32_t seq_num, length, mss;
+    uint8_t send;
+
+    SYS_LOG_FUNCTION_ENTRY(TCP);
+
+    /* If held data is not already being sent, otherwise that will also send
+     * the data and FIN we are holding. */
+    if ((port->tx_flags & TCP_TX_FLAG_BUSY) == 0)
+    {
+        /* Segments are sent in order while the port is not locked. */
+        port->tx_flags |= TCP_TX_FLAG_BUSY;
+
+        /* While we have some data to send. */
+        while ((status == SUCCESS) && (port->tx_buffer != NULL))
+        {
+            /* Pick the data we are holding. */
+            tx_buffer = port->tx_buffer;
+            buffer_fd = tx_buffer->fd;
+            remaining = NULL;
+
+            /* Get the length of segment we can send. */
+            mss = tcp_send_mss(port);
+            length = MIN(tx_buffer->total_length, mss);
+
+            /* Check if we need to push this segment, all the data before a
+             * FIN is pushed. */
+            send = (((tx_flags & TCP_TX_PUSH) || (port->tx_flags & TCP_TX_FLAG_FIN)) ? TRUE : FALSE);
+
+            /* If we have a full sized segment. */
+            if (length >= mss)
+            {
+                /* Send this segment. */
+                send = TRUE;
+            }
+
+            /* If this port is corked. */
+            else if (port->flags & TCP_FLAG_CORK)
+            {
+                /* Send this segment only if we have held it for too long. */
+                if (INT32CMP(current_system_tick(), port->cork_timeout) >= 0)
+                {
+                    send = TRUE;
+                }
+            }
+
+            /* If Nagle's algorithm is disabled or all the data we have sent
+             * is ACKed. */
+            else if ((port->flags & TCP_FLAG_NODELAY) || (port->snd_nxt == port->snd_una))
+            {
+                /* Send this segment. */
+                send = TRUE;
+            }
+
+            /* If we don't have space to send this segment. */
+            if (tcp_send_space(port) < length)
+            {
+                /* Wait for an ACK. */
+                send = FALSE;
+            }
+
+            /* If we don't need to send this segment. */
+            if (send == FALSE)
+            {
+                break;
+            }
+
+            /* Remove this buffer from the port. */
+            port->tx_buffer = NULL;
+
+            /* If we have more data than can be sent in this segment. */
+            if (tx_buffer->total_length > length)
+            {
+                /* Release lock for the port. */
+                fd_release_lock(port);
+
+                /* Obtain lock for buffer file descriptor. */
+                ASSERT(fd_get_lock(buffer_fd) != SUCCESS);
+
+                /* Divide this buffer at the segment boundary, only the buffer
+                 * in which the boundary lies is copied. */
+                status = fs_buffer_list_divide(tx_buffer, buffer_flags, length);
+
+                /* If buffer was successfully divided. */
+                if (status == SUCCESS)
+                {
+                    /* Rest of the data will be sent in next segments. */
+                    remaining = tx_buffer->next;
+                    tx_buffer->next = NULL;
+
+                    /* Payload checksum is no longer valid. */
+                    tx_buffer->meta.csum = 0;
+                    tx_buffer->meta.csum_length = 0;
+                }
+
+                /* Release lock for buffer descriptor. */
+                fd_release_lock(buffer_fd);
+
+                /* Lock the TCP port. */
+                ASSERT(fd_get_lock(port));
+
+                /* If buffer was not divided. */
+                if (status != SUCCESS)
+                {
+                    /* Put back the data on the port, this will be sent
+                     * later. */
+                    tcp_tx_buffer_prepend(port, tx_buffer);
+
+                    break;
+                }
+
+                /* If socket was closed while we were dividing the data. */
+                if ((port->state != TCP_SOCK_ESTAB) && (port->state != TCP_SOCK_LAST_ACK))
+                {
+                    ASSERT(fd_get_lock(buffer_fd));
+
+                    /* Free all the data that was not sent. */
+                    tx_buffer->next = remaining;
+                    fs_buffer_add_list_list(tx_buffer, FS_LIST_FREE, FS_BUFFER_ACTIVE);
+
+                    /* Release lock for buffer descriptor. */
+                    fd_release_lock(buffer_fd);
+
+                    /* Return an error to the caller. */
+                    status = NET_CLOSED;
+
+                    break;
+                }
+
+                /* Put back the remaining data on the port. */
+                tcp_tx_buffer_prepend(port, remaining);
+            }
+
+            /* Save the sequence number of this segment. */
+            seq_num = port->snd_nxt;
+
+            /* SND.NXT := SND.NXT + SEG.LEN, this is updated before sending
+             * the segment as the ACK for this segment can be received before
+             * we return. */
+            port->snd_nxt = (uint32_t)(seq_num + length);
+
+            /* Time this segment if we are not already timing one. */
+            tcp_rtt_start(port, port->snd_nxt);
+
+            /* Send a TCP segment with the data we have. */
+            status = tcp_send_segment(port, &port->socket_address, seq_num, port->rcv_nxt, (TCP_HDR_FLAG_ACK), (uint16_t)(port->rcv_wnd >> port->rcv_wnd_scale), tx_buffer, TRUE, buffer_flags);
+
+            /* If this segment was not sent. */
+            if (status != SUCCESS)
+            {
+                /* As no other segment is sent in the meantime, this segment
+                 * was not sent, revert SND.NXT. */
+                port->snd_nxt = seq_num;
+
+                /* Stop timing this segment. */
+                if ((port->cong_flags & TCP_CONG_RTT) && (port->rtt_seq == (uint32_t)(seq_num + length)))
+                {
+                    port->cong_flags &= (uint8_t)~(TCP_CONG_RTT);
+                }
+
+                /* If socket is still open. */
+                if ((port->state == TCP_SOCK_ESTAB) || (port->state == TCP_SOCK_LAST_ACK))
+                {
+                    /* Data was returned to us, put it back at the start of the
+                     * held data so it is sent later. */
+                    tcp_tx_buffer_prepend(port, tx_buffer);
+                }
+                else
+                {
+                    ASSERT(fd_get_lock(buffer_fd));
+
+                    /* Free the data that was not sent. */
+                    fs_buffer_add_list_list(tx_buffer, FS_LIST_FREE, FS_BUFFER_ACTIVE);
+
+                    /* Release lock for buffer descriptor. */
+                    fd_release_lock(buffer_fd);
+                }
+
+                /* If all the retransmission structures are being used. */
+                if (status == NET_NO_RTX_AVAILABLE)
+                {
+                    /* Hold the data until an ACK frees a retransmission
+                     * structure. */
+                    status = SUCCESS;
+
+                    break;
+                }
+            }
+        }
+
+        /* If all the held data is sent and a FIN is queued after it. */
+        if ((status == SUCCESS) && (port->tx_buffer == NULL) && (port->tx_flags & TCP_TX_FLAG_FIN))
+        {
+            /* FIN is no longer queued. */
+            port->tx_flags &= (uint8_t)~(TCP_TX_FLAG_FIN);
+
+            /* Save the sequence number of the FIN. */
+            seq_num = port->snd_nxt;
+
+            /* We are sending a FIN, this is updated before sending the
+             * segment as the ACK for this segment can be received before we
+             * return. */
+            port->snd_nxt = (uint32_t)(seq_num + 1);
+
+            /* Segment (SEQ=SND.NXT, ACK=RCV.NXT, CTL=FIN,ACK). */
+            status = tcp_send_segment(port, &port->socket_address, seq_num, port->rcv_nxt, (TCP_HDR_FLAG_FIN | TCP_HDR_FLAG_ACK), (uint16_t)(port->rcv_wnd >> port->rcv_wnd_scale), NULL, TRUE, buffer_flags);
+
+            /* If FIN was not sent. */
+            if (status != SUCCESS)
+            {
+                /* Revert SND.NXT and queue the FIN again. */
+                port->snd_nxt = seq_num;
+                port->tx_flags |= TCP_TX_FLAG_FIN;
+
+                /* If all the retransmission structures are being used. */
+                if (status == NET_NO_RTX_AVAILABLE)
+                {
+                    /* FIN will be sent when an ACK frees a retransmission
+                     * structure. */
+                    status = SUCCESS;
+                }
+            }
+        }
+
+        /* Held data is no longer being sent. */
+        port->tx_flags &= (uint8_t)~(TCP_TX_FLAG_BUSY);
+
+        /* Update timeout for this port. */
+        tcp_timeout_update(port);
+    }
+
+    SYS_LOG_FUNCTION_EXIT_STATUS(TCP, status);
+
+    /* Return status to the caller. */
+    return (status);
+
+} /* tcp_tx_buffer_send */
+
+/*
+ * tcp_ioctl
+ * @fd: TCP port for which this was called.
+ * @cmd: IOCTL command needed to be processed.
+ * @param: IOCTL data, pointer to an uint8_t having TRUE or FALSE.
+ * @return: Returns success if the command was successful,
+ *  FS_INVALID_COMMAND will be returned if an unknown command was requested.
+ * This function executes a special command on a TCP port.
+ *  TCP_NODELAY: If TRUE segments smaller than MSS are sent without waiting
+ *   for the data already sent to be ACKed, this is set on new ports unless
+ *   TCP_NAGLE is enabled.
+ *  TCP_CORK: If TRUE segments smaller than MSS are held until either more
+ *   data is written or TCP_CORK_TIMEOUT has elapsed, setting it to FALSE
+ *   will send the held data.
+ */
+static int32_t tcp_ioctl(void *fd, uint32_t cmd, void *param)
+{
+    TCP_PORT *port = (TCP_PORT *)fd;
+    int32_t status = SUCCESS;
+    uint8_t flag = 0;
+
+    SYS_LOG_FUNCTION_ENTRY(TCP);
+
+    /* Process the requested command. */
+    switch (cmd)
+    {
+
+    /* Need to disable or enable Nagle's algorithm. */
+    case TCP_NODELAY:
+
+        flag = TCP_FLAG_NODELAY;
+
+        break;
+
+    /* Need to cork or uncork this port. */
+    case TCP_CORK:
+
+        flag = TCP_FLAG_CORK;
+
+        break;
+
+    default:
+
+        /* Unknown command was requested. */
+        status = FS_INVALID_COMMAND;
+
+        break;
+    }
+
+    /* If a valid command was requested. */
+    if (status == SUCCESS)
+    {
+        /* If we need to set this flag. */
+        if (*((uint8_t *)param) == TRUE)
+        {
+            port->flags |= flag;
+        }
+        else
+        {
+            port->flags &= (uint8_t)~(flag);
+        }
+
+        /* If we are in established state. */
+        if (port->state == TCP_SOCK_ESTAB)
+        {
+            /* Send the segment being built if it can now be sent. */
+            status = tcp_tx_buffer_send(port, 0, (FS_BUFFER_TH | FS_BUFFER_SUSPEND));
+        }
 
-                    if (status == SUCCESS)
-                    {
-                        /* If we are still in established state. */
-                        if (port->state == TCP_SOCK_ESTAB)
-                        {
-                            /* SND.NXT := SND.NXT + SEG.LEN */
-                            port->snd_nxt = (uint32_t)(port->snd_nxt + (uint32_t)nbytes);
+        /* Update timeout for this port. */
+        tcp_timeout_update(port);
+    }
 
-                            /* If we have space on the send window. */
-                            if (port->snd_wnd > (uint32_t)nbytes)
-                            {
-                                /* We just sent a segment adjust the send window. */
-                                port->snd_wnd -= (uint32_t)nbytes;
-                            }
-                            else
-                            {
-                                /* No space on the send window. */
-                                port->snd_wnd = 0;
-                            }
+    SYS_LOG_FUNCTION_EXIT_STATUS(TCP, status);
 
-                            /* Add the number of bytes sent. */
-                            sent += nbytes;
+    /* Return status to the caller. */
+    return (status);
 
-                            /* If there is space on the send window to send some data. */
-                            if (port->snd_wnd == 0)
-                            {
-                                /* Space is now consumed for this fd. */
-                                fd_space_consumed(fd);
-                            }
+} /* tcp_ioctl */
 
-                            /* Move ahead the buffer pointer. */
-                            buffer += nbytes;
-                            size -= nbytes;
-                        }
-                        else
-                        {
-                            /* We cannot write data on this socket, return an error. */
-                            status = sent = NET_CLOSED;
-                        }
-                    }
-                    else
-                    {
-                        /* Return this status to the caller. */
-                        sent = status;
-                    }
-                }
-            }
-            else
-            {
-                /* Set flag that we don't have any more space in this TCP port. */
-                fd_space_consumed(fd);
+/*
+ * tcp_send_space
+ * @port: TCP port for which send space is needed.
+ * @return: Returns the number of new bytes that can be sent on this port.
+ * This function will return the number of bytes we can send on a TCP port,
+ * this is limited by both the send and congestion windows and by the
+ * availability of a retransmission structure.
+ */
+static uint32_t tcp_send_space(TCP_PORT *port)
+{
+    uint32_t i, wnd, flight, space = 0;
 
-                break;
-            }
+    /* Traverse the retransmission list. */
+    for (i = 0; i < TCP_NUM_RTX; i++)
+    {
+        /* If this is a free retransmission structure. */
+        if ((port->rtx[i].flags & TCP_RTX_IN_USE) == 0)
+        {
+            break;
         }
     }
-    else
+
+    /* If we can retransmit a new segment. */
+    if (i < TCP_NUM_RTX)
     {
-        /* We cannot write data on this socket, return an error. */
-        status = sent = NET_CLOSED;
-    }
+        /* Usable window is the smaller of send and congestion window. */
+        wnd = MIN(port->snd_wnd, port->cwnd);
+        flight = (port->snd_nxt - port->snd_una);
 
-    SYS_LOG_FUNCTION_EXIT_STATUS(TCP, status);
+        /* If we have not yet filled the window. */
+        if (wnd > flight)
+        {
+            /* Return the remaining space. */
+            space = (wnd - flight);
+        }
+    }
 
-    /* Return number of bytes sent. */
-    return (sent);
+    /* Return the send space. */
+    return (space);
 
-} /* tcp_write_data */
+} /* tcp_send_space */
 
 /*
  * tcp_get_rtx_free
@@ -1900,8 +3017,7 @@ static uint8_t tcp_rtx_process_ack(TCP_PORT *port, uint32_t ack_num)
     if (do_rtx == TRUE)
     {
         /* Enable the retransmission timer. */
-        port->rtx_timeout = current_system_tick() + MS_TO_TICK(TCP_RTO);
-        port->rtx_time = (TCP_RTO);
+        port->rtx_timeout = current_system_tick() + port->rtx_time;
         port->rtx_timeout_enable = TRUE;
     }
     else
@@ -1925,8 +3041,8 @@ static uint8_t tcp_rtx_process_ack(TCP_PORT *port, uint32_t ack_num)
 /*
  * tcp_rtx_free_all
  * @port: Port for which we need to free all the retransmission buffers.
- * This function will free all the buffers on the retransmission list, and
- * disable the retransmission timer.
+ * This function will free all the buffers on the retransmission list and any
+ * data that was not yet sent, and disable the retransmission timer.
  */
 static void tcp_rtx_free_all(TCP_PORT *port)
 {
@@ -1960,6 +3076,26 @@ static void tcp_rtx_free_all(TCP_PORT *port)
         port->rtx[i].flags = 0;
     }
 
+    /* If we have some data that was not sent. */
+    if (port->tx_buffer != NULL)
+    {
+        ASSERT(fd_get_lock(port->tx_buffer->fd));
+
+        /* Free this buffer. */
+        fs_buffer_add(port->tx_buffer->fd, port->tx_buffer, FS_LIST_FREE, FS_BUFFER_ACTIVE);
+
+        /* Release buffer lock. */
+        fd_release_lock(port->tx_buffer->fd);
+
+        port->tx_buffer = NULL;
+    }
+
+    /* No need to send a FIN after the held data. */
+    port->tx_flags &= (uint8_t)~(TCP_TX_FLAG_FIN);
+
+    /* No need to send a delayed ACK. */
+    port->flags &= (uint8_t)~(TCP_FLAG_ACK_DELAYED);
+
     /* Disable the retransmission timer. */
     port->rtx_timeout_enable = FALSE;
 
@@ -1968,6 +3104,190 @@ static void tcp_rtx_free_all(TCP_PORT *port)
 
 } /* tcp_rtx_free_all */
 
+/*
+ * tcp_rtt_sample
+ * @port: TCP port on which new data was ACKed.
+ * @ack_num: Received ACK number.
+ * @opt_param: Options received with this ACK.
+ * This function will take a round trip time sample for a received ACK, if
+ * timestamps are being used the echoed timestamp is used as per RFC 7323,
+ * otherwise the segment being timed is used.
+ */
+static void tcp_rtt_sample(TCP_PORT *port, uint32_t ack_num, TCP_OPT_PARAM *opt_param)
+{
+    uint8_t ts_sample = FALSE;
+
+    SYS_LOG_FUNCTION_ENTRY(TCP);
+
+#ifdef TCP_TIME_STAMP
+    /* If remote has echoed a valid timestamp and we are not recovering from
+     * a loss, as a retransmitted segment carries it's old timestamp. */
+    if ((port->flags & TCP_FLAG_TIME_STAMP) && (opt_param->flags & TCP_OPT_FLAG_TIME_STAMP) &&
+        ((port->cong_flags & (TCP_CONG_RECOVERY | TCP_CONG_LOSS)) == 0) &&
+        (opt_param->ts_ecr != 0) && (INT32CMP(current_system_tick(), opt_param->ts_ecr) >= 0))
+    {
+        /* No need to time a segment. */
+        port->cong_flags &= (uint8_t)~(TCP_CONG_RTT);
+
+        /* Update the round trip time. */
+        tcp_rtt_update(port, (current_system_tick() - opt_param->ts_ecr));
+
+        /* A sample was taken from the timestamp. */
+        ts_sample = TRUE;
+    }
+#else
+    /* Remove some compiler warnings. */
+    UNUSED_PARAM(opt_param);
+#endif
+
+    /* If we did not take a sample from the timestamp. */
+    if (ts_sample == FALSE)
+    {
+        /* Take a sample if the segment being timed was ACKed. */
+        tcp_rtt_ack(port, ack_num);
+    }
+
+    SYS_LOG_FUNCTION_EXIT(TCP);
+
+} /* tcp_rtt_sample */
+
+#ifdef TCP_SACK
+/*
+ * tcp_sack_process
+ * @port: TCP port on which SACK blocks were received.
+ * @opt_param: Option parameter having the received SACK blocks.
+ * @return: Will return true if a segment was SACKed for the first time.
+ * This function will mark the segments SACKed by the remote in the
+ * retransmission list, these segments are skipped when retransmitting the
+ * lost segments.
+ */
+static uint8_t tcp_sack_process(TCP_PORT *port, TCP_OPT_PARAM *opt_param)
+{
+    uint32_t i, left, right;
+    uint8_t n, sacked = FALSE;
+
+    SYS_LOG_FUNCTION_ENTRY(TCP);
+
+    /* If the highest SACKed sequence is already ACKed. */
+    if (INT32CMP(port->sack_high, port->snd_una) < 0)
+    {
+        /* Move it to the first unacknowledged sequence. */
+        port->sack_high = port->snd_una;
+    }
+
+    /* Process all the received SACK blocks. */
+    for (n = 0; n < opt_param->num_sack; n++)
+    {
+        left = opt_param->sack[(2 * n)];
+        right = opt_param->sack[(2 * n) + 1];
+
+        /* Skip the blocks that are either already ACKed or invalid. */
+        if ((INT32CMP(port->snd_una, left) <= 0) && (INT32CMP(left, right) < 0) && (INT32CMP(right, port->snd_nxt) <= 0))
+        {
+            /* Traverse the RTX list. */
+            for (i = 0; i < TCP_NUM_RTX; i++)
+            {
+                /* If this segment lies in this SACK block. */
+                if (((port->rtx[i].flags & (TCP_RTX_IN_USE | TCP_RTX_SACKED)) == TCP_RTX_IN_USE) &&
+                    (INT32CMP(left, port->rtx[i].seq_num) <= 0) && (INT32CMP((port->rtx[i].seq_num + port->rtx[i].seg_len), right) <= 0))
+                {
+                    /* Remote has received this segment. */
+                    port->rtx[i].flags |= TCP_RTX_SACKED;
+                    sacked = TRUE;
+                }
+            }
+
+            /* If this is the highest SACKed sequence. */
+            if (INT32CMP(right, port->sack_high) > 0)
+            {
+                /* Save the highest SACKed sequence. */
+                port->sack_high = right;
+            }
+        }
+    }
+
+    SYS_LOG_FUNCTION_EXIT(TCP);
+
+    /* Return if a segment was SACKed. */
+    return (sacked);
+
+} /* tcp_sack_process */
+
+/*
+ * tcp_sack_update
+ * @port: TCP port for which SACK blocks are needed to be updated.
+ * @seg_seq: Sequence number of the last received segment.
+ * This function will update the SACK blocks to be sent for the out-of-order
+ * data we have received, the block having the last received segment is kept
+ * first as required by RFC 2018. Lock for the buffer file descriptor must be
+ * acquired by the caller.
+ */
+static void tcp_sack_update(TCP_PORT *port, uint32_t seg_seq)
+{
+    FS_BUFFER_LIST *buffer = port->rx_buffer.oorx_list.head;
+    uint32_t left, right, this_seq;
+    uint8_t num_sack = 1, first = FALSE;
+
+    SYS_LOG_FUNCTION_ENTRY(TCP);
+
+    /* While we have an out-of-order buffer. */
+    while (buffer != NULL)
+    {
+        /* Start a new block from this buffer. */
+        ASSERT(fs_buffer_list_pull(buffer, &left, 4, (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
+        right = left + (buffer->total_length - 4);
+
+        /* Add all the buffers that continue this block. */
+        for (buffer = buffer->next; (buffer != NULL); buffer = buffer->next)
+        {
+            /* Pull the sequence number for this buffer. */
+            ASSERT(fs_buffer_list_pull(buffer, &this_seq, 4, (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
+
+            /* If there is a hole before this buffer. */
+            if (this_seq != right)
+            {
+                break;
+            }
+
+            /* Extend this block. */
+            right = this_seq + (buffer->total_length - 4);
+        }
+
+        /* If this block has the last received segment. */
+        if ((first == FALSE) && (INT32CMP(left, seg_seq) <= 0) && (INT32CMP(seg_seq, right) < 0))
+        {
+            /* Send this block first. */
+            port->rcv_sack[0] = left;
+            port->rcv_sack[1] = right;
+            first = TRUE;
+        }
+
+        /* If we can send another block. */
+        else if (num_sack < TCP_SACK_MAX_BLOCKS)
+        {
+            /* Add this block. */
+            port->rcv_sack[(2 * num_sack)] = left;
+            port->rcv_sack[(2 * num_sack) + 1] = right;
+            num_sack++;
+        }
+    }
+
+    /* If no block has the last received segment. */
+    if (first == FALSE)
+    {
+        /* Remove the first block. */
+        memmove(&port->rcv_sack[0], &port->rcv_sack[2], ((uint32_t)(num_sack - 1) * 2 * sizeof(uint32_t)));
+        num_sack--;
+    }
+
+    /* Save the number of SACK blocks. */
+    port->num_rcv_sack = num_sack;
+
+    SYS_LOG_FUNCTION_EXIT(TCP);
+
+} /* tcp_sack_update */
+#endif /* TCP_SACK */
+
 /*
  * net_process_tcp
  * @buffer: File system buffer needed to be processed.
@@ -1993,10 +3313,13 @@ int32_t net_process_tcp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_add
     int32_t status = SUCCESS;
     uint16_t csum, flags;
     TCP_PORT_PARAM port_param;
+    TCP_OPT_PARAM opt_param;
     TCP_PORT *port;
-    uint32_t seg_ack, seg_seq;
-    uint16_t seg_wnd, seg_len;
+    uint32_t seg_ack, seg_seq, acked;
+    uint16_t seg_wnd, seg_len, hdr_len;
+    uint8_t hdr_buf[TCP_HRD_SIZE], *hdr;
     uint8_t resume_task = FALSE, resume_flags = 0, stop_timer = FALSE, invalid_ack = FALSE;
+    uint8_t new_ack = FALSE, wnd_update = FALSE, do_rtx, seq_ok;
 
     SYS_LOG_FUNCTION_ENTRY(TCP);
 
@@ -2007,7 +3330,8 @@ int32_t net_process_tcp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_add
         status = NET_INVALID_HDR;
     }
 
-    if (status == SUCCESS)
+    /* If checksum is not already verified. */
+    if ((status == SUCCESS) && ((buffer->meta.flags & NET_BUFFER_L4_CSUM) == 0))
     {
         /* Calculate checksum for this TCP packet. */
         status = net_pseudo_csum_calculate(buffer, src_ip, dst_ip, IP_PROTO_TCP, (uint16_t)(buffer->total_length - ihl), ihl, 0, &csum);
@@ -2023,22 +3347,27 @@ int32_t net_process_tcp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_add
 
     if (status == SUCCESS)
     {
-        /* Pull the source and destination ports. */
-        ASSERT(fs_buffer_list_pull_offset(buffer, &port_param.socket_address.foreign_port, 2, (ihl + TCP_HRD_SRC_PORT_OFFSET), (FS_BUFFER_PACKED | FS_BUFFER_INPLACE)));
-        ASSERT(fs_buffer_list_pull_offset(buffer, &port_param.socket_address.local_port, 2, (ihl + TCP_HRD_DST_PORT_OFFSET), (FS_BUFFER_PACKED | FS_BUFFER_INPLACE)));
+        /* Peek the TCP header. */
+        hdr = fs_buffer_list_peek(buffer, hdr_buf, TCP_HRD_SIZE, ihl);
+        ASSERT(hdr == NULL);
 
-        /* Save the ACK number. */
-        ASSERT(fs_buffer_list_pull_offset(buffer, &seg_ack, 4, (uint32_t)(ihl + TCP_HRD_ACK_NUM_OFFSET), (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
-        ASSERT(fs_buffer_list_pull_offset(buffer, &seg_seq, 4, (uint32_t)(ihl + TCP_HRD_SEQ_NUM_OFFSET), (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
+        /* Pick the source and destination ports. */
+        port_param.socket_address.foreign_port = TCP_HRD_SRC_PORT(hdr);
+        port_param.socket_address.local_port = TCP_HRD_DST_PORT(hdr);
 
-        /* Pull the TCP flags. */
-        ASSERT(fs_buffer_list_pull_offset(buffer, &flags, 2, (ihl + TCP_HRD_FLAGS_OFFSET), (FS_BUFFER_PACKED | FS_BUFFER_INPLACE)));
+        /* Save the ACK and sequence numbers. */
+        seg_ack = TCP_HRD_ACK_NUM(hdr);
+        seg_seq = TCP_HRD_SEQ_NUM(hdr);
 
-        /* Pull TCP window size. */
-        ASSERT(fs_buffer_list_pull_offset(buffer, &seg_wnd, 2, (uint32_t)(ihl + TCP_HRD_WND_SIZE_OFFSET), (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
+        /* Pick the TCP flags. */
+        flags = TCP_HRD_FLAGS(hdr);
 
-        /* Calculate segment length. */
-        seg_len = (uint16_t)(buffer->total_length - (ihl + (uint32_t)(((flags & TCP_HDR_HDR_LEN_MSK) >> TCP_HDR_HDR_LEN_SHIFT) * 4)));
+        /* Pick TCP window size. */
+        seg_wnd = TCP_HRD_WND_SIZE(hdr);
+
+        /* Calculate header and segment length. */
+        hdr_len = (uint16_t)(((flags & TCP_HDR_HDR_LEN_MSK) >> TCP_HDR_HDR_LEN_SHIFT) * 4);
+        seg_len = (uint16_t)(buffer->total_length - (ihl + hdr_len));
 
         /* Release semaphore for the buffer file descriptor. */
         fd_release_lock(buffer->fd);
@@ -2053,10 +3382,9 @@ int32_t net_process_tcp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_add
         /* Initialize search parameter for this TCP packet. */
         port_param.socket_address.local_ip = dst_ip;
         port_param.socket_address.foreign_ip = src_ip;
-        port_param.port = NULL;
 
         /* Search for a TCP port that can be used to receive this packet. */
-        sll_search(&tcp_data.port_list, NULL, &tcp_port_search, &port_param, OFFSETOF(TCP_PORT, next));
+        port_param.port = (TCP_PORT *)net_demux_search(&tcp_data.demux, &port_param.socket_address);
 
         /* Save the resolved port. */
         port = port_param.port;
@@ -2083,6 +3411,9 @@ int32_t net_process_tcp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_add
              * port. */
             if (status == SUCCESS)
             {
+                /* Check if this segment has updated the send window. */
+                wnd_update = (port->snd_wnd != ((uint32_t)seg_wnd << port->snd_wnd_scale)) ? TRUE : FALSE;
+
                 /* Save the send window size. */
                 port->snd_wnd = ((uint32_t)seg_wnd << port->snd_wnd_scale);
 
@@ -2107,7 +3438,7 @@ int32_t net_process_tcp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_add
                     {
                         /* Send a RST in response. */
                         /* Segment (SEQ=SEG.ACK, CTL=RST) */
-                        tcp_send_segment(port, &port_param.socket_address, seg_ack, 0, (TCP_HDR_FLAG_RST), (uint16_t)(port->rcv_wnd >> port->rcv_wnd_scale), NULL, 0, FALSE, FS_BUFFER_TH);
+                        tcp_send_segment(port, &port_param.socket_address, seg_ack, 0, (TCP_HDR_FLAG_RST), (uint16_t)(port->rcv_wnd >> port->rcv_wnd_scale), NULL, FALSE, FS_BUFFER_TH);
                     }
 
                     /* A connection request is identified by a SYN request. */
@@ -2168,8 +3499,8 @@ int32_t net_process_tcp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_add
                                     /* If our SYN was ACKed. */
                                     if (seg_ack == port->snd_nxt)
                                     {
-                                        /* Clear the TCP port option flag for window scale. */
-                                        port->flags &= (TCP_FLAG_WND_SCALE);
+                                        /* Clear the TCP port option flags. */
+                                        port->flags &= (uint8_t)~(TCP_FLAG_OPT_MSK);
 
                                         /* Obtain lock for buffer file descriptor. */
                                         /* Both port and buffers are locked here, it is
@@ -2177,7 +3508,7 @@ int32_t net_process_tcp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_add
                                         ASSERT(fd_get_lock(buffer->fd) != SUCCESS);
 
                                         /* Process received TCP options. */
-                                        status = tcp_process_options(buffer, port, (uint32_t)(ihl + TCP_HRD_SIZE), (uint16_t)(((flags & TCP_HDR_HDR_LEN_MSK) >> (TCP_HDR_HDR_LEN_SHIFT - 2)) - TCP_HRD_SIZE));
+                                        status = tcp_process_options(buffer, port, (uint32_t)(ihl + TCP_HRD_SIZE), (uint16_t)(hdr_len - TCP_HRD_SIZE), &opt_param);
 
                                         /* Release semaphore for the buffer file descriptor. */
                                         fd_release_lock(buffer->fd);
@@ -2192,6 +3523,17 @@ int32_t net_process_tcp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_add
                                                 port->snd_wnd_scale = port->rcv_wnd_scale = 0;
                                             }
 
+#ifdef TCP_TIME_STAMP
+                                            /* If remote has sent a timestamp. */
+                                            if (opt_param.flags & TCP_OPT_FLAG_TIME_STAMP)
+                                            {
+                                                /* Timestamps are being used, save the
+                                                 * timestamp to be echoed. */
+                                                port->flags |= TCP_FLAG_TIME_STAMP;
+                                                port->ts_recent = opt_param.ts_val;
+                                            }
+#endif
+
                                             /* RCV.NXT := SEG.SEQ + 1 */
                                             port->rcv_nxt = seg_seq + 1;
 
@@ -2201,14 +3543,20 @@ int32_t net_process_tcp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_add
                                             /* Reset the duplicate ACK counter. */
                                             port->nacks = 0;
 
+                                            /* Remove our SYN from the retransmission list. */
+                                            tcp_rtx_process_ack(port, seg_ack);
+
                                             /* Segment (SEQ=SND.NXT, ACK=RCV.NXT, CTL=ACK) */
-                                            tcp_send_segment(port, &port->socket_address, port->snd_nxt, port->rcv_nxt, (TCP_HDR_FLAG_ACK), (uint16_t)(port->rcv_wnd >> port->rcv_wnd_scale), NULL, 0, FALSE, FS_BUFFER_TH);
+                                            tcp_send_segment(port, &port->socket_address, port->snd_nxt, port->rcv_nxt, (TCP_HDR_FLAG_ACK), (uint16_t)(port->rcv_wnd >> port->rcv_wnd_scale), NULL, FALSE, FS_BUFFER_TH);
 
                                             /* Move to the established state. */
                                             port->state = TCP_SOCK_ESTAB;
 
+                                            /* Initialize congestion control for this connection. */
+                                            tcp_cong_initialize(port);
+
                                             /* If we have some space in send window. */
-                                            if (port->snd_wnd > 0)
+                                            if (tcp_send_space(port) > 0)
                                             {
                                                 /* Resume any tasks waiting to write on
                                                  * this TCP port. */
@@ -2219,7 +3567,7 @@ int32_t net_process_tcp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_add
                                         {
                                             /* Send a RST in response. */
                                             /* Segment (SEQ=SEG.ACK, CTL=RST) */
-                                            tcp_send_segment(port, &port_param.socket_address, seg_ack, 0, (TCP_HDR_FLAG_RST), (uint16_t)(port->rcv_wnd >> port->rcv_wnd_scale), NULL, 0, FALSE, FS_BUFFER_TH);
+                                            tcp_send_segment(port, &port_param.socket_address, seg_ack, 0, (TCP_HDR_FLAG_RST), (uint16_t)(port->rcv_wnd >> port->rcv_wnd_scale), NULL, FALSE, FS_BUFFER_TH);
 
                                             /* Move to the closed state. */
                                             port->state = TCP_SOCK_COLSED;
@@ -2239,7 +3587,7 @@ int32_t net_process_tcp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_add
                         {
                             /* Send a RST in response. */
                             /* Segment (SEQ=SND.NXT, CTL=RST) */
-                            tcp_send_segment(port, &port->socket_address, port->snd_nxt, 0, (TCP_HDR_FLAG_RST), (uint16_t)(port->rcv_wnd >> port->rcv_wnd_scale), NULL, 0, FALSE, FS_BUFFER_TH);
+                            tcp_send_segment(port, &port->socket_address, port->snd_nxt, 0, (TCP_HDR_FLAG_RST), (uint16_t)(port->rcv_wnd >> port->rcv_wnd_scale), NULL, FALSE, FS_BUFFER_TH);
                         }
 
                     }
@@ -2274,9 +3622,51 @@ int32_t net_process_tcp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_add
                 /* If we are in time wait state. */
                 case TCP_SOCK_TIME_WAIT:
 
+                    /* Clear the option parameter. */
+                    memset(&opt_param, 0, sizeof(TCP_OPT_PARAM));
+
+                    /* If we have some options and remote is using options sent
+                     * on every segment. */
+                    if ((hdr_len > TCP_HRD_SIZE) && (port->flags & (TCP_FLAG_SACK | TCP_FLAG_TIME_STAMP)))
+                    {
+                        /* Obtain lock for buffer file descriptor. */
+                        ASSERT(fd_get_lock(buffer->fd) != SUCCESS);
+
+                        /* Process received TCP options, any invalid option is
+                         * just ignored. */
+                        tcp_process_options(buffer, port, (uint32_t)(ihl + TCP_HRD_SIZE), (uint16_t)(hdr_len - TCP_HRD_SIZE), &opt_param);
+
+                        /* Release semaphore for the buffer file descriptor. */
+                        fd_release_lock(buffer->fd);
+                    }
+
                     /* Verify received sequence number. */
                     /* Check Segment SEQ (SEG.SEQ, SEG.LEN, RCV.NXT, RCV.WND) */
-                    if (tcp_check_sequence(seg_seq, seg_len, port->rcv_nxt, port->rcv_wnd) == TRUE)
+                    seq_ok = tcp_check_sequence(seg_seq, seg_len, port->rcv_nxt, port->rcv_wnd);
+
+#ifdef TCP_TIME_STAMP
+                    /* If timestamps are being used and we have received one
+                     * on this segment. */
+                    if ((seq_ok == TRUE) && (port->flags & TCP_FLAG_TIME_STAMP) && (opt_param.flags & TCP_OPT_FLAG_TIME_STAMP))
+                    {
+                        /* If this is not a RST and the timestamp is older than
+                         * the one we have already received. */
+                        if (((flags & TCP_HDR_FLAG_RST) == 0) && (INT32CMP(opt_param.ts_val, port->ts_recent) < 0))
+                        {
+                            /* PAWS, this is an old duplicate segment. */
+                            seq_ok = FALSE;
+                        }
+
+                        /* SEG.SEQ =< Last.ACK.sent ? */
+                        else if (INT32CMP(seg_seq, port->last_ack_sent) <= 0)
+                        {
+                            /* TS.Recent := SEG.TSval. */
+                            port->ts_recent = opt_param.ts_val;
+                        }
+                    }
+#endif
+
+                    if (seq_ok == TRUE)
                     {
                         /* If RST is set. */
                         if (flags & TCP_HDR_FLAG_RST)
@@ -2297,7 +3687,7 @@ int32_t net_process_tcp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_add
                         {
                             /* Send a RST in response. */
                             /* Segment (SEQ=SND.NXT, CTL=RST) */
-                            tcp_send_segment(port, &port->socket_address, port->snd_nxt, 0, (TCP_HDR_FLAG_RST), (uint16_t)(port->rcv_wnd >> port->rcv_wnd_scale), NULL, 0, FALSE, FS_BUFFER_TH);
+                            tcp_send_segment(port, &port->socket_address, port->snd_nxt, 0, (TCP_HDR_FLAG_RST), (uint16_t)(port->rcv_wnd >> port->rcv_wnd_scale), NULL, FALSE, FS_BUFFER_TH);
 
                             /* Move to closed state. */
                             port->state = TCP_SOCK_COLSED;
@@ -2332,6 +3722,12 @@ int32_t net_process_tcp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_add
                                     /* Reset the duplicate ACK counter. */
                                     port->nacks = 0;
 
+                                    /* Remove our SYN from the retransmission list. */
+                                    tcp_rtx_process_ack(port, seg_ack);
+
+                                    /* Initialize congestion control for this connection. */
+                                    tcp_cong_initialize(port);
+
                                     /* Upon receiving a <SYN> segment with a Window Scale
                                      * option containing shift.cnt = S, a TCP MUST set
                                      * Snd.Wind.Shift to S and MUST set Rcv.Wind.Shift
@@ -2357,7 +3753,7 @@ int32_t net_process_tcp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_add
                                     resume_flags = (FS_BLOCK_READ);
 
                                     /* If we have some space in send window. */
-                                    if (port->snd_wnd > 0)
+                                    if (tcp_send_space(port) > 0)
                                     {
                                         /* Also resume any tasks waiting to write on
                                          * this TCP port. */
@@ -2384,7 +3780,7 @@ int32_t net_process_tcp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_add
                                 {
                                     /* Send a RST in response. */
                                     /* Segment (SEQ=SND.NXT, CTL=RST). */
-                                    tcp_send_segment(port, &port->socket_address, port->snd_nxt, 0, (TCP_HDR_FLAG_RST), (uint16_t)(port->rcv_wnd >> port->rcv_wnd_scale), NULL, 0, FALSE, FS_BUFFER_TH);
+                                    tcp_send_segment(port, &port->socket_address, port->snd_nxt, 0, (TCP_HDR_FLAG_RST), (uint16_t)(port->rcv_wnd >> port->rcv_wnd_scale), NULL, FALSE, FS_BUFFER_TH);
 
                                     /* Connection was not accepted, move to closed state. */
                                     port->state = TCP_SOCK_COLSED;
@@ -2406,27 +3802,69 @@ int32_t net_process_tcp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_add
                             /* If we are in FIN-WAIT-2 state. */
                             case TCP_SOCK_FIN_WAIT_2:
 
+#ifdef TCP_SACK
+                                /* If SACK is being used and remote has sent some
+                                 * SACK blocks. */
+                                if ((port->flags & TCP_FLAG_SACK) && (opt_param.num_sack > 0))
+                                {
+                                    /* Mark the segments SACKed by the remote, as
+                                     * per RFC 6675 an ACK that SACKs new data is a
+                                     * duplicate ACK even if it updates the window. */
+                                    if (tcp_sack_process(port, &opt_param) == TRUE)
+                                    {
+                                        wnd_update = FALSE;
+                                    }
+                                }
+#endif
+
                                 /* Match the SEG.ACK number. */
                                 /* SND.UNA < SEG.ACK =< SND.NXT ? */
                                 if ((INT32CMP(port->snd_una, seg_ack) < 0) && (INT32CMP(seg_ack, port->snd_nxt) <= 0))
                                 {
+                                    /* Save the number of bytes ACKed. */
+                                    acked = (seg_ack - port->snd_una);
+
                                     /* SND.UNA := SEG.ACK. */
                                     port->snd_una = seg_ack;
 
                                     /* Reset the duplicate ACK counter. */
                                     port->nacks = 0;
 
+                                    /* This ACK has acknowledged new data. */
+                                    new_ack = TRUE;
+
+                                    /* Take a round trip time sample if possible. */
+                                    tcp_rtt_sample(port, seg_ack, &opt_param);
+
+                                    /* Update the congestion window. */
+                                    do_rtx = tcp_cong_ack(port, acked);
+
                                     /* Process and see if we have more space on this TCP socket. */
                                     if (tcp_rtx_process_ack(port, seg_ack) == TRUE)
                                     {
                                         /* If we have space on the send window. */
-                                        if (port->snd_wnd > 0)
+                                        if (tcp_send_space(port) > 0)
                                         {
                                             /* We can now send more data on this port. */
                                             resume_task = TRUE;
-                                            resume_flags = (FS_BLOCK_WRITE);
+                                            resume_flags |= (FS_BLOCK_WRITE);
                                         }
                                     }
+
+                                    /* If this was a partial ACK during loss recovery. */
+                                    if (do_rtx == TRUE)
+                                    {
+                                        /* Retransmit the next unacknowledged segment. */
+                                        /* Segment (SEQ=SEG.ACK, ACK=[?], CTL =[?]) */
+                                        tcp_fast_rtx(port, seg_ack);
+                                    }
+
+                                    /* If we are holding some data or a FIN,
+                                     * see if we can now send it. */
+                                    if ((port->tx_buffer != NULL) || (port->tx_flags & TCP_TX_FLAG_FIN))
+                                    {
+                                        tcp_tx_buffer_send(port, 0, FS_BUFFER_TH);
+                                    }
                                 }
 
                                 /* Process according to port state. */
@@ -2440,33 +3878,42 @@ int32_t net_process_tcp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_add
                                     /* SEG.ACK = SND.UNA ? */
                                     if (port->snd_una == seg_ack)
                                     {
-                                        /* If we have not received 3 ACKs. */
-                                        if (port->nacks < 3)
-                                        {
-                                            /* dACK := dACK+1. */
-                                            port->nacks = (uint8_t)(port->nacks + 1);
-                                        }
-
-                                        /* First ACK. */
-                                        if (port->nacks == 1)
+                                        /* If this is a duplicate ACK, we have outstanding data, this
+                                         * segment does not carry any data and it did not update
+                                         * the send window. */
+                                        if ((new_ack == FALSE) && (seg_len == 0) && ((flags & (TCP_HDR_FLAG_SYN | TCP_HDR_FLAG_FIN)) == 0) &&
+                                            (wnd_update == FALSE) && (port->snd_nxt != port->snd_una))
                                         {
-                                            SYS_LOG_FUNCTION_MSG(TCP, SYS_LOG_DEBUG, "First ACK", "");
-                                        }
+                                            /* Process this duplicate ACK. */
+                                            if (tcp_cong_dup_ack(port) == TRUE)
+                                            {
+                                                /* A new recovery is started, any segment
+                                                 * can now be retransmitted again. */
+                                                tcp_rtx_clear_flags(port, TCP_RTX_RETRANSMITTED);
 
-                                        /* Second ACK. */
-                                        else if (port->nacks == 2)
-                                        {
-                                            SYS_LOG_FUNCTION_MSG(TCP, SYS_LOG_DEBUG, "First duplicate ACK", "");
-                                        }
+                                                /* Fast retransmit the segment in the RTX queue. */
+                                                /* Segment (SEQ=SEG.ACK, ACK=[?], CTL =[?]) */
+                                                tcp_fast_rtx(port, seg_ack);
+                                            }
 
-                                        /* Third ACK. */
-                                        else if (port->nacks == 3)
-                                        {
-                                            SYS_LOG_FUNCTION_MSG(TCP, SYS_LOG_DEBUG, "Second duplicate ACK", "");
+#ifdef TCP_SACK
+                                            /* If SACK is being used and we are in fast
+                                             * recovery. */
+                                            else if ((port->flags & TCP_FLAG_SACK) && (port->cong_flags & TCP_CONG_RECOVERY))
+                                            {
+                                                /* Retransmit the next hole reported by the
+                                                 * remote. */
+                                                tcp_fast_rtx(port, seg_ack);
+                                            }
+#endif
 
-                                            /* Fart retransmit the segment in the RTX queue. */
-                                            /* Segment (SEQ=SEG.ACK, ACK=[?], CTL =[?]) */
-                                            tcp_fast_rtx(port, seg_ack);
+                                            /* If window was inflated during fast recovery. */
+                                            if (tcp_send_space(port) > 0)
+                                            {
+                                                /* We can now send more data on this port. */
+                                                resume_task = TRUE;
+                                                resume_flags |= (FS_BLOCK_WRITE);
+                                            }
                                         }
                                     }
                                     else
@@ -2588,8 +4035,24 @@ int32_t net_process_tcp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_add
                                 /* SND.UNA < SEG.ACK =< SND.NXT ? */
                                 if ((INT32CMP(port->snd_una, seg_ack) < 0) && (INT32CMP(seg_ack, port->snd_nxt) <= 0))
                                 {
+                                    /* If we are still sending the data held
+                                     * before our FIN. */
+                                    if ((port->state == TCP_SOCK_LAST_ACK) && ((port->tx_buffer != NULL) || (port->tx_flags & TCP_TX_FLAG_FIN)))
+                                    {
+                                        /* SND.UNA := SEG.ACK. */
+                                        port->snd_una = seg_ack;
+
+                                        /* Remove the ACKed segments from the
+                                         * retransmission list. */
+                                        tcp_rtx_process_ack(port, seg_ack);
+
+                                        /* Send the held data and FIN if we
+                                         * can. */
+                                        tcp_tx_buffer_send(port, 0, FS_BUFFER_TH);
+                                    }
+
                                     /* Our FIN has been ACKed? */
-                                    if (seg_ack == port->snd_nxt)
+                                    if ((seg_ack == port->snd_nxt) && ((port->tx_flags & TCP_TX_FLAG_FIN) == 0))
                                     {
                                         switch (port->state)
                                         {
@@ -2636,7 +4099,7 @@ int32_t net_process_tcp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_add
                         {
                             /* Send an ACK. */
                             /* Segment (SEQ=SND.NXT, ACK=RCV.NXT, CTL=ACK). */
-                            tcp_send_segment(port, &port->socket_address, port->snd_nxt, port->rcv_nxt, (TCP_HDR_FLAG_ACK), (uint16_t)(port->rcv_wnd >> port->rcv_wnd_scale), NULL, 0, FALSE, FS_BUFFER_TH);
+                            tcp_send_segment(port, &port->socket_address, port->snd_nxt, port->rcv_nxt, (TCP_HDR_FLAG_ACK), (uint16_t)(port->rcv_wnd >> port->rcv_wnd_scale), NULL, FALSE, FS_BUFFER_TH);
                         }
                     }
 
@@ -2809,7 +4272,7 @@ int32_t tcp_connect(TCP_PORT *port)
 
             /* Send SYN-ACK in response with our TCP options. */
             /* Segment (SEQ=ISS, CTL=SYN) */
-            status = tcp_send_segment(port, &port->socket_address, iss, 0, (TCP_HDR_FLAG_SYN), (uint16_t)(port->rcv_wnd >> port->rcv_wnd_scale), NULL, 0, TRUE, (FS_BUFFER_TH | FS_BUFFER_SUSPEND));
+            status = tcp_send_segment(port, &port->socket_address, iss, 0, (TCP_HDR_FLAG_SYN), (uint16_t)(port->rcv_wnd >> port->rcv_wnd_scale), NULL, TRUE, (FS_BUFFER_TH | FS_BUFFER_SUSPEND));
         }
         else
         {
@@ -2855,7 +4318,8 @@ int32_t tcp_connect(TCP_PORT *port)
  * tcp_accept
  * @server_port: Server port for which a connection is needed to be accepted.
  * @client_port: Port which will be used to accept the new connection. Caller
- *  is responsible for registering this port.
+ *  is responsible for registering this port before accepting a connection
+ *  on it.
  * @return: A success status will be returned if a TCP connection was
  *  successfully accepted.
  *  NET_NO_ACTION will be returned if we got forcefully resumed.
@@ -2868,6 +4332,8 @@ int32_t tcp_accept(TCP_PORT *server_port, TCP_PORT *client_port)
 {
     int32_t status = SUCCESS;
     FS_BUFFER_LIST *buffer;
+    SOCKET_ADDRESS socket_address;
+    TCP_OPT_PARAM opt_param;
     uint32_t irs, iss;
     uint16_t flags;
     uint8_t ihl;
@@ -2928,23 +4394,38 @@ int32_t tcp_accept(TCP_PORT *server_port, TCP_PORT *client_port)
 
                     /* Clear the TCP port flags for the option we received and
                      * will also be sent. */
-                    client_port->flags &= (TCP_FLAG_WND_SCALE | TCP_FLAG_MSS);
+                    client_port->flags &= (uint8_t)~(TCP_FLAG_OPT_MSK);
 
                     /* Process TCP options. */
-                    status = tcp_process_options(buffer, client_port, (uint32_t)(ihl + TCP_HRD_SIZE), (uint16_t)(((flags & TCP_HDR_HDR_LEN_MSK) >> (TCP_HDR_HDR_LEN_SHIFT - 2)) - TCP_HRD_SIZE));
+                    status = tcp_process_options(buffer, client_port, (uint32_t)(ihl + TCP_HRD_SIZE), (uint16_t)(((flags & TCP_HDR_HDR_LEN_MSK) >> (TCP_HDR_HDR_LEN_SHIFT - 2)) - TCP_HRD_SIZE), &opt_param);
 
                     /* If TCP options were successfully processed. */
                     if (status == SUCCESS)
                     {
+#ifdef TCP_TIME_STAMP
+                        /* If remote has sent a timestamp. */
+                        if (opt_param.flags & TCP_OPT_FLAG_TIME_STAMP)
+                        {
+                            /* Timestamps are being used, save the timestamp
+                             * to be echoed. */
+                            client_port->flags |= TCP_FLAG_TIME_STAMP;
+                            client_port->ts_recent = opt_param.ts_val;
+                        }
+#endif
+
                         /* Save the socket address for this connection request. */
 
                         /* Save the IP addresses for this socket. */
-                        ASSERT(fs_buffer_list_pull_offset(buffer, &client_port->socket_address.foreign_ip, 4, IPV4_HDR_SRC_OFFSET, (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
-                        ASSERT(fs_buffer_list_pull_offset(buffer, &client_port->socket_address.local_ip, 4, IPV4_HDR_DST_OFFSET, (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
+                        ASSERT(fs_buffer_list_pull_offset(buffer, &socket_address.foreign_ip, 4, IPV4_HDR_SRC_OFFSET, (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
+                        ASSERT(fs_buffer_list_pull_offset(buffer, &socket_address.local_ip, 4, IPV4_HDR_DST_OFFSET, (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
 
                         /* Save the port addresses for this socket. */
-                        ASSERT(fs_buffer_list_pull_offset(buffer, &client_port->socket_address.foreign_port, 2, (uint32_t)(ihl + TCP_HRD_SRC_PORT_OFFSET), (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
-                        ASSERT(fs_buffer_list_pull_offset(buffer, &client_port->socket_address.local_port, 2, (uint32_t)(ihl + TCP_HRD_DST_PORT_OFFSET), (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
+                        ASSERT(fs_buffer_list_pull_offset(buffer, &socket_address.foreign_port, 2, (uint32_t)(ihl + TCP_HRD_SRC_PORT_OFFSET), (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
+                        ASSERT(fs_buffer_list_pull_offset(buffer, &socket_address.local_port, 2, (uint32_t)(ihl + TCP_HRD_DST_PORT_OFFSET), (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
+
+                        /* Move the client socket to it's new socket address
+                         * in the socket demux table. */
+                        net_demux_update(&tcp_data.demux, &client_port->demux, &socket_address);
 
                         /* Save the remote sequence number. */
                         /* Set IRS = SEG.SEQ. */
@@ -2978,7 +4459,7 @@ int32_t tcp_accept(TCP_PORT *server_port, TCP_PORT *client_port)
 
                         /* Send SYN-ACK in response with our TCP options. */
                         /* Segment (SEQ=ISS, ACK=RCV.NXT, CTL=SYN,ACK) */
-                        tcp_send_segment(client_port, &client_port->socket_address, iss, client_port->rcv_nxt, (TCP_HDR_FLAG_ACK | TCP_HDR_FLAG_SYN), (uint16_t)(client_port->rcv_wnd >> client_port->rcv_wnd_scale), NULL, 0, TRUE, (FS_BUFFER_TH | FS_BUFFER_SUSPEND));
+                        tcp_send_segment(client_port, &client_port->socket_address, iss, client_port->rcv_nxt, (TCP_HDR_FLAG_ACK | TCP_HDR_FLAG_SYN), (uint16_t)(client_port->rcv_wnd >> client_port->rcv_wnd_scale), NULL, TRUE, (FS_BUFFER_TH | FS_BUFFER_SUSPEND));
 
                         /* Obtain lock for buffer file descriptor. */
                         ASSERT(fd_get_lock(buffer->fd));
@@ -3044,7 +4525,7 @@ int32_t tcp_accept(TCP_PORT *server_port, TCP_PORT *client_port)
                 if (client_port->state == TCP_SOCK_ESTAB)
                 {
                     /* If we have some space available to write data on this port. */
-                    if (client_port->snd_wnd > 0)
+                    if (tcp_send_space(client_port) > 0)
                     {
                         /* There is space available to write data on this port. */
                         fd_space_available((FD)client_port);
@@ -3077,6 +4558,7 @@ int32_t tcp_accept(TCP_PORT *server_port, TCP_PORT *client_port)
 void tcp_close(TCP_PORT *port)
 {
     int32_t status = SUCCESS;
+    uint8_t state;
 
     SYS_LOG_FUNCTION_ENTRY(TCP);
 
@@ -3103,23 +4585,52 @@ void tcp_close(TCP_PORT *port)
         /* If we are at established state. */
         case TCP_SOCK_ESTAB:
 
-            /* Queue this CLOSE request until all queued SENDs have been
-             * segmentized and sent and ACKed. */
-            status = tcp_port_wait(port, FS_BLOCK_WRITE);
+            /* While we are holding some data on this port. */
+            while ((status == SUCCESS) && (port->tx_buffer != NULL) && (port->state == TCP_SOCK_ESTAB))
+            {
+                /* Send the data we are holding. */
+                status = tcp_tx_buffer_send(port, TCP_TX_PUSH, (FS_BUFFER_TH | FS_BUFFER_SUSPEND));
+
+                /* If we are still holding some data. */
+                if ((status == SUCCESS) && (port->tx_buffer != NULL))
+                {
+                    /* Wait for space on this port. */
+                    fd_space_consumed(port);
+                    status = tcp_port_wait(port, FS_BLOCK_WRITE);
+                }
+            }
 
             if (status == SUCCESS)
             {
-                /* Segment (SEQ=SND.NXT, ACK=RCV.NXT, CTL=FIN,ACK) */
-                status = tcp_send_segment(port, &port->socket_address, port->snd_nxt, port->rcv_nxt, (TCP_HDR_FLAG_FIN | TCP_HDR_FLAG_ACK), (uint16_t)(port->rcv_wnd >> port->rcv_wnd_scale), NULL, 0, TRUE, (FS_BUFFER_TH | FS_BUFFER_SUSPEND));
+                /* Queue this CLOSE request until all queued SENDs have been
+                 * segmentized and sent and ACKed. */
+                status = tcp_port_wait(port, FS_BLOCK_WRITE);
             }
 
-            if (status == SUCCESS)
+            /* If we can still send a FIN. */
+            if ((status == SUCCESS) && ((port->state == TCP_SOCK_SYN_RCVD) || (port->state == TCP_SOCK_ESTAB)))
             {
-                /* We have sent a FIN. */
+                /* Save the current state. */
+                state = port->state;
+
+                /* We are sending a FIN, this is updated before sending the
+                 * segment as the ACK for this segment can be received before
+                 * we return. */
                 port->snd_nxt = port->snd_nxt + 1;
 
                 /* Move to FIN wait state. */
                 port->state = TCP_SOCK_FIN_WAIT_1;
+
+                /* Segment (SEQ=SND.NXT, ACK=RCV.NXT, CTL=FIN,ACK) */
+                status = tcp_send_segment(port, &port->socket_address, (port->snd_nxt - 1), port->rcv_nxt, (TCP_HDR_FLAG_FIN | TCP_HDR_FLAG_ACK), (uint16_t)(port->rcv_wnd >> port->rcv_wnd_scale), NULL, TRUE, (FS_BUFFER_TH | FS_BUFFER_SUSPEND));
+
+                /* If FIN was not sent. */
+                if ((status != SUCCESS) && (port->state == TCP_SOCK_FIN_WAIT_1))
+                {
+                    /* Revert the port state. */
+                    port->snd_nxt = port->snd_nxt - 1;
+                    port->state = state;
+                }
             }
 
             break;
@@ -3156,5 +4667,39 @@ void tcp_close(TCP_PORT *port)
 
 } /* tcp_close */
 
+/*
+ * tcp_congestion_control
+ * @port: TCP port for which congestion control algorithm is needed to be
+ *  updated.
+ * @cong: Congestion control algorithm to be used, tcp_cong_newreno and if
+ *  enabled tcp_cong_cubic are provided.
+ * This function will update the congestion control algorithm used by a TCP
+ * port, this should be called before a connection is established.
+ */
+void tcp_congestion_control(TCP_PORT *port, const TCP_CONG *cong)
+{
+    SYS_LOG_FUNCTION_ENTRY(TCP);
+
+    /* Obtain lock for this port. */
+    if (fd_get_lock((FD)port) == SUCCESS)
+    {
+        /* Use the given congestion control algorithm. */
+        port->cong = cong;
+
+        /* If congestion control algorithm needs to be initialized. */
+        if (cong->init != NULL)
+        {
+            /* Initialize congestion control algorithm. */
+            cong->init(port);
+        }
+
+        /* Release lock for this port. */
+        fd_release_lock((FD)port);
+    }
+
+    SYS_LOG_FUNCTION_EXIT(TCP);
+
+} /* tcp_congestion_control */
+
 #endif /* NET_TCP */
 #endif /* CONFIG_NET */
@@ -1,8 +1,15 @@
 # Setup configuration options.
 setup_option_def(TCP_WND_SIZE 1024 INT "TCP window size in bytes." CONFIG_FILE "net_tcp_config")
 setup_option_def(TCP_WND_SCALE 2 INT "TCP window scale to be used." CONFIG_FILE "net_tcp_config")
-setup_option_def(TCP_RTO 750 INT "TCP base retransmission timeout." CONFIG_FILE "net_tcp_config")
+setup_option_def(TCP_RTO 750 INT "TCP initial retransmission timeout, used until a round trip time is measured." CONFIG_FILE "net_tcp_config")
 setup_option_def(TCP_MAX_RTO 5000 INT "TCP maximum retransmission timeout." CONFIG_FILE "net_tcp_config")
 setup_option_def(TCP_MSL 60000 INT "TCP maximum segment length." CONFIG_FILE "net_tcp_config")
 setup_option_def(TCP_NUM_RTX 16 INT "TCP maximum retransmissions." CONFIG_FILE "net_tcp_config")
-setup_option_def(TCP_MAX_CONG_WINDOW 0xFFFF INT "TCP congestion window size." CONFIG_FILE "net_tcp_config")
\ No newline at end of file
+setup_option_def(TCP_MAX_CONG_WINDOW 0xFFFF INT "Maximum TCP congestion window size in bytes." CONFIG_FILE "net_tcp_config")
+setup_option_def(TCP_MIN_RTO 200 INT "TCP minimum retransmission timeout." CONFIG_FILE "net_tcp_config")
+setup_option_def(TCP_CUBIC OFF DEFINE "Enables CUBIC congestion control and use it for new TCP ports instead of NewReno." CONFIG_FILE "net_tcp_config")
+setup_option_def(TCP_SACK OFF DEFINE "Enables TCP selective acknowledgments." CONFIG_FILE "net_tcp_config")
+setup_option_def(TCP_TIME_STAMP OFF DEFINE "Enables TCP timestamps for round trip time measurement and protection against wrapped sequence numbers." CONFIG_FILE "net_tcp_config")
+setup_option_def(TCP_DELAYED_ACK 0 INT "TCP delayed ACK timeout, zero disables delayed ACKs." CONFIG_FILE "net_tcp_config")
+setup_option_def(TCP_NAGLE OFF DEFINE "Enables Nagle's algorithm on new TCP ports, otherwise TCP_NODELAY is set on them." CONFIG_FILE "net_tcp_config")
+setup_option_def(TCP_CORK_TIMEOUT 200 INT "Maximum time for which data is held on a corked TCP port." CONFIG_FILE "net_tcp_config")
\ No newline at end of file
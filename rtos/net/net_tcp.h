@@ -20,6 +20,7 @@
 
 #ifdef NET_TCP
 #include <console.h>
+#include <net_demux.h>
 #include <net_tcp_config.h>
 
 /* TCP header definitions. */
@@ -33,6 +34,17 @@
 #define TCP_HRD_CSUM_OFFSET         (16)
 #define TCP_HRD_URG_OFFSET          (18)
 
+/* TCP header accessors, header must be contiguous, see
+ * fs_buffer_list_peek. */
+#define TCP_HRD_SRC_PORT(h)         NET_GET_BE16(&(h)[TCP_HRD_SRC_PORT_OFFSET])
+#define TCP_HRD_DST_PORT(h)         NET_GET_BE16(&(h)[TCP_HRD_DST_PORT_OFFSET])
+#define TCP_HRD_SEQ_NUM(h)          NET_GET_BE32(&(h)[TCP_HRD_SEQ_NUM_OFFSET])
+#define TCP_HRD_ACK_NUM(h)          NET_GET_BE32(&(h)[TCP_HRD_ACK_NUM_OFFSET])
+#define TCP_HRD_FLAGS(h)            NET_GET_BE16(&(h)[TCP_HRD_FLAGS_OFFSET])
+#define TCP_HRD_WND_SIZE(h)         NET_GET_BE16(&(h)[TCP_HRD_WND_SIZE_OFFSET])
+#define TCP_HRD_CSUM(h)             NET_GET_BE16(&(h)[TCP_HRD_CSUM_OFFSET])
+#define TCP_HRD_URG(h)              NET_GET_BE16(&(h)[TCP_HRD_URG_OFFSET])
+
 /* TCP flag definitions. */
 #define TCP_HDR_FLAG_MSK            (0xFFF)
 #define TCP_HDR_FLAG_FIN            (0x1)
@@ -53,7 +65,14 @@
 #define TCP_OPT_MSS                 (2)
 #define TCP_OPT_WIND_SCALE          (3)
 #define TCP_OPT_SACK_EN             (4)
-#define TCP_OPT_TIME_STAMP          (5)
+#define TCP_OPT_SACK                (5)
+#define TCP_OPT_TIME_STAMP          (8)
+
+/* TCP option sizes. */
+#define TCP_OPT_MAX_SIZE            (40)
+#define TCP_OPT_TS_SIZE             (12)    /* With two NOPs for alignment. */
+#define TCP_OPT_SACK_BLOCK_SIZE     (8)
+#define TCP_SACK_MAX_BLOCKS         (4)
 
 /* TCP socket states. */
 #define TCP_SOCK_COLSED             (0)
@@ -71,13 +90,42 @@
 /* TCP socket flags. */
 #define TCP_FLAG_WND_SCALE          (0x1)
 #define TCP_FLAG_MSS                (0x2)
+#define TCP_FLAG_SACK               (0x4)
+#define TCP_FLAG_TIME_STAMP         (0x8)
+#define TCP_FLAG_OPT_MSK            (TCP_FLAG_WND_SCALE | TCP_FLAG_MSS | TCP_FLAG_SACK | TCP_FLAG_TIME_STAMP)
+#define TCP_FLAG_NODELAY            (0x10)
+#define TCP_FLAG_CORK               (0x20)
+#define TCP_FLAG_ACK_DELAYED        (0x40)
+
+/* TCP IOCTL commands, parameter is a pointer to an uint8_t having TRUE or
+ * FALSE. */
+#define TCP_NODELAY                 (1)
+#define TCP_CORK                    (2)
+
+/* TCP transmit flags. */
+#define TCP_TX_PUSH                 (0x1)
+
+/* TCP port transmit state flags. */
+#define TCP_TX_FLAG_BUSY            (0x1)
+#define TCP_TX_FLAG_FIN             (0x2)
+
+/* TCP congestion control flags. */
+#define TCP_CONG_RECOVERY           (0x1)
+#define TCP_CONG_LOSS               (0x2)
+#define TCP_CONG_RTT                (0x4)
+#define TCP_CONG_EPOCH              (0x8)
 
 /* TCP out-of-order parameter flags. */
 #define TCP_FLAG_SEG_CONFLICT       (0x1)
 
+/* TCP option parameter flags. */
+#define TCP_OPT_FLAG_TIME_STAMP     (0x1)
+
 /* TCP RTX data flags. */
 #define TCP_RTX_IN_USE              (0x1)
 #define TCP_RTX_BUFFER_RETURNED     (0x4)
+#define TCP_RTX_SACKED              (0x8)
+#define TCP_RTX_RETRANSMITTED       (0x10)
 
 /* Parameter that will be used to process the out-of-order buffer list. */
 typedef struct _tcp_oo_param
@@ -94,6 +142,35 @@ typedef struct _tcp_oo_param
 
 } TCP_OO_PARAM;
 
+/* Options parsed from a received TCP segment. */
+typedef struct _tcp_opt_param
+{
+#ifdef TCP_TIME_STAMP
+    /* Received timestamp value and the timestamp echoed by the remote. */
+    uint32_t    ts_val;
+    uint32_t    ts_ecr;
+#endif
+
+#ifdef TCP_SACK
+    /* Received SACK blocks, left and right edge of each block. */
+    uint32_t    sack[2 * TCP_SACK_MAX_BLOCKS];
+
+    /* Number of SACK blocks received. */
+    uint8_t     num_sack;
+#endif
+
+    /* Option flags. */
+    uint8_t     flags;
+
+    /* Structure padding. */
+#ifdef TCP_SACK
+    uint8_t     pad[2];
+#else
+    uint8_t     pad[3];
+#endif
+
+} TCP_OPT_PARAM;
+
 /* TCP retransmission packet structure. */
 typedef struct _tcp_timeout_suspend
 {
@@ -131,6 +208,21 @@ struct _tcp_rtx_data
 
 };
 
+/* TCP congestion control algorithm, slow start and loss recovery are handled
+ * by the TCP stack and an algorithm only controls the congestion avoidance. */
+typedef struct _tcp_cong
+{
+    /* Initializes the algorithm data when a connection is established. */
+    void        (*init) (TCP_PORT *);
+
+    /* Grows the congestion window for the number of bytes ACKed. */
+    void        (*avoid) (TCP_PORT *, uint32_t);
+
+    /* Returns the slow start threshold to be used after a loss. */
+    uint32_t    (*ssthresh) (TCP_PORT *);
+
+} TCP_CONG;
+
 /* TCP port structure. */
 struct _tcp_port
 {
@@ -158,6 +250,9 @@ struct _tcp_port
         FS_BUFFER_LIST      *buffer;
     } rx_buffer;
 
+    /* Data written on this port that is not yet sent. */
+    FS_BUFFER_LIST      *tx_buffer;
+
     /* TCP socket address. */
     SOCKET_ADDRESS      socket_address;
 
@@ -178,9 +273,75 @@ struct _tcp_port
     /* Current retransmission time. */
     uint32_t            rtx_time;
 
+    /* Tick at which a delayed ACK is needed to be sent. */
+    uint32_t            ack_timeout;
+
+    /* Tick at which the data held on a corked port is needed to be sent. */
+    uint32_t            cork_timeout;
+
+    /* Smoothed round trip time and it's variation in ticks, these are kept
+     * scaled by 8 and 4 respectively. */
+    uint32_t            srtt;
+    uint32_t            rttvar;
+
+    /* Sequence number and the tick at which the segment being timed for
+     * round trip time was sent. */
+    uint32_t            rtt_seq;
+    uint32_t            rtt_tick;
+
+    /* Congestion control algorithm for this port. */
+    const TCP_CONG      *cong;
+
+    /* Congestion window and slow start threshold in bytes. */
+    uint32_t            cwnd;
+    uint32_t            ssthresh;
+
+    /* Highest sequence number sent when loss recovery was started. */
+    uint32_t            recover;
+
+#ifdef TCP_TIME_STAMP
+    /* Timestamp to be echoed to the remote and the last ACK number sent. */
+    uint32_t            ts_recent;
+    uint32_t            last_ack_sent;
+#endif
+
+#ifdef TCP_SACK
+    /* SACK blocks for the out-of-order data we have received, block
+     * having the last received segment is kept first. */
+    uint32_t            rcv_sack[2 * TCP_SACK_MAX_BLOCKS];
+
+    /* Highest sequence number SACKed by the remote. */
+    uint32_t            sack_high;
+#endif
+
+#ifdef TCP_CUBIC
+    /* CUBIC congestion control data. */
+    struct _tcp_port_cubic
+    {
+        /* Congestion window before the last and the previous reduction. */
+        uint32_t        w_max;
+        uint32_t        w_last_max;
+
+        /* Window a standard TCP would have reached. */
+        uint32_t        w_est;
+
+        /* Window at which this epoch will have a plateau. */
+        uint32_t        origin;
+
+        /* Tick at which this congestion avoidance epoch was started. */
+        uint32_t        epoch;
+
+        /* Milliseconds required to reach the plateau. */
+        uint32_t        k;
+    } cubic;
+#endif
+
     /* TCP port list member. */
     TCP_PORT            *next;
 
+    /* TCP socket demux node. */
+    NET_DEMUX_NODE      demux;
+
     /* Receive sequence numbers. */
     uint32_t            rcv_nxt;
     uint32_t            rcv_wnd;
@@ -210,8 +371,20 @@ struct _tcp_port
     uint8_t             event_timeout_enable;
     uint8_t             rtx_timeout_enable;
 
+    /* Congestion control flags. */
+    uint8_t             cong_flags;
+
+    /* Flags to specify if held data is being sent and if a FIN is queued
+     * after it. */
+    uint8_t             tx_flags;
+
+#ifdef TCP_SACK
+    /* Number of SACK blocks to be sent. */
+    uint8_t             num_rcv_sack;
+#else
     /* Structure padding. */
-    uint8_t             pad[3];
+    uint8_t             pad[1];
+#endif
 };
 
 /* TCP global data. */
@@ -224,6 +397,9 @@ typedef struct _tcp_data
         TCP_PORT    *tail;
     } port_list;
 
+    /* Socket demux table for TCP ports. */
+    NET_DEMUX       demux;
+
 #ifdef CONFIG_SEMAPHORE
     /* Data lock to protect global TCP data. */
     SEMAPHORE       lock;
@@ -251,6 +427,7 @@ int32_t tcp_listen(TCP_PORT *);
 int32_t tcp_connect(TCP_PORT *);
 int32_t tcp_accept(TCP_PORT *, TCP_PORT *);
 void tcp_close(TCP_PORT *);
+void tcp_congestion_control(TCP_PORT *, const TCP_CONG *);
 
 #endif /* NET_TCP */
 
@@ -0,0 +1,544 @@
+/*
+ * net_tcp_cong.c
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#include <kernel.h>
+
+#ifdef CONFIG_NET
+#include <net.h>
+
+#ifdef NET_TCP
+#include <string.h>
+#include <net_tcp.h>
+#include <net_tcp_cong.h>
+
+/* Internal function prototypes. */
+static void tcp_newreno_avoid(TCP_PORT *, uint32_t);
+static uint32_t tcp_newreno_ssthresh(TCP_PORT *);
+#ifdef TCP_CUBIC
+static uint32_t tcp_cubic_root(uint64_t);
+static void tcp_cubic_init(TCP_PORT *);
+static void tcp_cubic_avoid(TCP_PORT *, uint32_t);
+static uint32_t tcp_cubic_ssthresh(TCP_PORT *);
+#endif
+
+/* NewReno congestion control as per RFC 5681. */
+const TCP_CONG tcp_cong_newreno =
+{
+    .init       = NULL,
+    .avoid      = &tcp_newreno_avoid,
+    .ssthresh   = &tcp_newreno_ssthresh,
+};
+
+#ifdef TCP_CUBIC
+/* CUBIC congestion control as per RFC 8312. */
+const TCP_CONG tcp_cong_cubic =
+{
+    .init       = &tcp_cubic_init,
+    .avoid      = &tcp_cubic_avoid,
+    .ssthresh   = &tcp_cubic_ssthresh,
+};
+#endif
+
+/*
+ * tcp_rtt_initialize
+ * @port: TCP port for which RTT estimation is needed to be initialized.
+ * This function will initialize the round trip time estimation for a TCP
+ * port, initial retransmission timeout is used until a round trip time is
+ * measured.
+ */
+void tcp_rtt_initialize(TCP_PORT *port)
+{
+    SYS_LOG_FUNCTION_ENTRY(TCP);
+
+    /* Clear the round trip time estimation. */
+    port->srtt = port->rttvar = 0;
+    port->cong_flags &= (uint8_t)~(TCP_CONG_RTT);
+
+    /* Use the initial retransmission timeout. */
+    port->rtx_time = MS_TO_TICK(TCP_RTO);
+
+    SYS_LOG_FUNCTION_EXIT(TCP);
+
+} /* tcp_rtt_initialize */
+
+/*
+ * tcp_rtt_start
+ * @port: TCP port on which a new segment was sent.
+ * @seq_num: Sequence number at the end of the segment.
+ * This function will start timing a segment for round trip time measurement
+ * if we are not already timing one.
+ */
+void tcp_rtt_start(TCP_PORT *port, uint32_t seq_num)
+{
+    SYS_LOG_FUNCTION_ENTRY(TCP);
+
+    /* If we are not already timing a segment. */
+    if ((port->cong_flags & TCP_CONG_RTT) == 0)
+    {
+        /* Start timing this segment. */
+        port->rtt_seq = seq_num;
+        port->rtt_tick = current_system_tick();
+        port->cong_flags |= TCP_CONG_RTT;
+    }
+
+    SYS_LOG_FUNCTION_EXIT(TCP);
+
+} /* tcp_rtt_start */
+
+/*
+ * tcp_rtt_ack
+ * @port: TCP port on which an ACK was received.
+ * @ack_num: Received ACK number.
+ * This function will take a round trip time sample if the segment being timed
+ * was ACKed. As per Karn's rule timing is stopped when a segment is
+ * retransmitted so an ambiguous sample is never taken.
+ */
+void tcp_rtt_ack(TCP_PORT *port, uint32_t ack_num)
+{
+    SYS_LOG_FUNCTION_ENTRY(TCP);
+
+    /* If the segment being timed was ACKed. */
+    if ((port->cong_flags & TCP_CONG_RTT) && (INT32CMP(ack_num, port->rtt_seq) >= 0))
+    {
+        /* Stop timing this segment. */
+        port->cong_flags &= (uint8_t)~(TCP_CONG_RTT);
+
+        /* Update the round trip time. */
+        tcp_rtt_update(port, (current_system_tick() - port->rtt_tick));
+    }
+
+    SYS_LOG_FUNCTION_EXIT(TCP);
+
+} /* tcp_rtt_ack */
+
+/*
+ * tcp_rtt_update
+ * @port: TCP port for which a round trip time was measured.
+ * @rtt: Measured round trip time in ticks.
+ * This function will update the smoothed round trip time and the
+ * retransmission timeout as per RFC 6298.
+ */
+void tcp_rtt_update(TCP_PORT *port, uint32_t rtt)
+{
+    int32_t delta;
+    uint32_t rto;
+
+    SYS_LOG_FUNCTION_ENTRY(TCP);
+
+    /* If this is the first measurement. */
+    if ((port->srtt == 0) && (port->rttvar == 0))
+    {
+        /* SRTT <- R, RTTVAR <- R/2. */
+        port->srtt = (rtt << TCP_RTT_SRTT_SHIFT);
+        port->rttvar = (rtt << (TCP_RTT_RTTVAR_SHIFT - 1));
+    }
+    else
+    {
+        /* SRTT <- 7/8 * SRTT + 1/8 * R. */
+        delta = (int32_t)(rtt - (port->srtt >> TCP_RTT_SRTT_SHIFT));
+        port->srtt = (uint32_t)((int32_t)port->srtt + delta);
+
+        /* RTTVAR <- 3/4 * RTTVAR + 1/4 * |SRTT - R|. */
+        if (delta < 0)
+        {
+            delta = -delta;
+        }
+        port->rttvar = (uint32_t)((int32_t)port->rttvar + delta - (int32_t)(port->rttvar >> TCP_RTT_RTTVAR_SHIFT));
+    }
+
+    /* RTO <- SRTT + max (G, 4 * RTTVAR). */
+    rto = (port->srtt >> TCP_RTT_SRTT_SHIFT) + MAX(1, port->rttvar);
+
+    /* Keep the retransmission timeout in the configured limits. */
+    port->rtx_time = MIN(MAX(rto, MS_TO_TICK(TCP_MIN_RTO)), MS_TO_TICK(TCP_MAX_RTO));
+
+    SYS_LOG_FUNCTION_MSG(TCP, SYS_LOG_DEBUG, "RTT: %ld, SRTT: %ld, RTO: %ld", rtt, (port->srtt >> TCP_RTT_SRTT_SHIFT), port->rtx_time);
+
+    SYS_LOG_FUNCTION_EXIT(TCP);
+
+} /* tcp_rtt_update */
+
+/*
+ * tcp_cong_initialize
+ * @port: TCP port for which a connection was established.
+ * This function will initialize congestion control state for a new
+ * connection.
+ */
+void tcp_cong_initialize(TCP_PORT *port)
+{
+    SYS_LOG_FUNCTION_ENTRY(TCP);
+
+    /* Initialize the congestion window and slow start threshold. */
+    port->cwnd = MIN(TCP_CONG_IW(port->mss), TCP_MAX_CONG_WINDOW);
+    port->ssthresh = TCP_MAX_CONG_WINDOW;
+    port->recover = port->snd_nxt;
+    port->cong_flags &= (uint8_t)~(TCP_CONG_RECOVERY | TCP_CONG_LOSS | TCP_CONG_EPOCH);
+
+    /* If congestion control algorithm needs to be initialized. */
+    if ((port->cong != NULL) && (port->cong->init != NULL))
+    {
+        /* Initialize congestion control algorithm. */
+        port->cong->init(port);
+    }
+
+    SYS_LOG_FUNCTION_EXIT(TCP);
+
+} /* tcp_cong_initialize */
+
+/*
+ * tcp_cong_ack
+ * @port: TCP port on which new data was ACKed, SND.UNA should already be
+ *  updated.
+ * @acked: Number of bytes ACKed.
+ * @return: TRUE will be returned if the segment at SND.UNA is needed to be
+ *  retransmitted, otherwise FALSE will be returned.
+ * This function will update the congestion window for newly ACKed data as
+ * per RFC 5681 and will process partial and full ACKs during loss recovery
+ * as per RFC 6582.
+ */
+uint8_t tcp_cong_ack(TCP_PORT *port, uint32_t acked)
+{
+    uint32_t flight = (port->snd_nxt - port->snd_una);
+    uint8_t rtx = FALSE, grow = TRUE;
+
+    SYS_LOG_FUNCTION_ENTRY(TCP);
+
+    /* If we are recovering from a loss. */
+    if (port->cong_flags & (TCP_CONG_RECOVERY | TCP_CONG_LOSS))
+    {
+        /* If all the data sent before the loss is now ACKed. */
+        if (INT32CMP(port->snd_una, port->recover) >= 0)
+        {
+            /* If we were in fast recovery. */
+            if (port->cong_flags & TCP_CONG_RECOVERY)
+            {
+                /* Deflate the congestion window. */
+                port->cwnd = MIN(port->ssthresh, (MAX(flight, port->mss) + port->mss));
+                grow = FALSE;
+            }
+
+            /* Loss recovery is complete. */
+            port->cong_flags &= (uint8_t)~(TCP_CONG_RECOVERY | TCP_CONG_LOSS);
+        }
+        else
+        {
+            /* This is a partial ACK, next segment is also lost. */
+            rtx = TRUE;
+
+            /* If we are in fast recovery. */
+            if (port->cong_flags & TCP_CONG_RECOVERY)
+            {
+                /* Deflate the congestion window by the amount of data ACKed
+                 * and add back one segment. */
+                port->cwnd = (port->cwnd > acked) ? (port->cwnd - acked) : 0;
+                if (acked >= port->mss)
+                {
+                    port->cwnd += port->mss;
+                }
+                port->cwnd = MAX(port->cwnd, port->mss);
+                grow = FALSE;
+            }
+        }
+    }
+
+    /* If we can grow the congestion window. */
+    if (grow == TRUE)
+    {
+        /* If we are in slow start. */
+        if (port->cwnd < port->ssthresh)
+        {
+            /* Grow the window by at most one segment for each ACK. */
+            port->cwnd += MIN(acked, port->mss);
+        }
+        else
+        {
+            /* Let the congestion control algorithm grow the window. */
+            port->cong->avoid(port, acked);
+        }
+    }
+
+    /* Keep the congestion window in the configured limit. */
+    port->cwnd = MIN(port->cwnd, TCP_MAX_CONG_WINDOW);
+
+    SYS_LOG_FUNCTION_MSG(TCP, SYS_LOG_DEBUG, "CWND: %ld, SSTHRESH: %ld", port->cwnd, port->ssthresh);
+
+    SYS_LOG_FUNCTION_EXIT(TCP);
+
+    /* Return if a retransmission is needed. */
+    return (rtx);
+
+} /* tcp_cong_ack */
+
+/*
+ * tcp_cong_dup_ack
+ * @port: TCP port on which a duplicate ACK was received.
+ * @return: TRUE will be returned if the segment at SND.UNA is needed to be
+ *  fast retransmitted, otherwise FALSE will be returned.
+ * This function will process a duplicate ACK, on the third duplicate ACK we
+ * will enter fast recovery and the congestion window is inflated for each
+ * subsequent duplicate ACK.
+ */
+uint8_t tcp_cong_dup_ack(TCP_PORT *port)
+{
+    uint8_t rtx = FALSE;
+
+    SYS_LOG_FUNCTION_ENTRY(TCP);
+
+    /* dACK := dACK+1. */
+    if (port->nacks < 0xFF)
+    {
+        port->nacks = (uint8_t)(port->nacks + 1);
+    }
+
+    /* If we are already in fast recovery. */
+    if (port->cong_flags & TCP_CONG_RECOVERY)
+    {
+        /* Another segment has left the network, inflate the window. */
+        port->cwnd = MIN((port->cwnd + port->mss), TCP_MAX_CONG_WINDOW);
+    }
+
+    /* If we are not recovering from a timeout and this is the third duplicate
+     * ACK. */
+    else if (((port->cong_flags & TCP_CONG_LOSS) == 0) && (port->nacks == TCP_DUP_ACK_THRESHOLD))
+    {
+        SYS_LOG_FUNCTION_MSG(TCP, SYS_LOG_DEBUG, "entering fast recovery", "");
+
+        /* Reduce the slow start threshold and enter fast recovery. */
+        port->ssthresh = port->cong->ssthresh(port);
+        port->recover = port->snd_nxt;
+        port->cwnd = MIN((port->ssthresh + (TCP_DUP_ACK_THRESHOLD * (uint32_t)port->mss)), TCP_MAX_CONG_WINDOW);
+        port->cong_flags |= TCP_CONG_RECOVERY;
+
+        /* Fast retransmit the lost segment. */
+        rtx = TRUE;
+    }
+
+    SYS_LOG_FUNCTION_EXIT(TCP);
+
+    /* Return if a fast retransmission is needed. */
+    return (rtx);
+
+} /* tcp_cong_dup_ack */
+
+/*
+ * tcp_cong_timeout
+ * @port: TCP port on which retransmission timer has expired.
+ * This function will update congestion state and back off the
+ * retransmission timer after a retransmission timeout.
+ */
+void tcp_cong_timeout(TCP_PORT *port)
+{
+    SYS_LOG_FUNCTION_ENTRY(TCP);
+
+    /* If this is not a repeated timeout for the same loss. */
+    if ((port->cong_flags & TCP_CONG_LOSS) == 0)
+    {
+        /* Reduce the slow start threshold. */
+        port->ssthresh = port->cong->ssthresh(port);
+    }
+
+    /* Use the loss window and retransmit everything sent so far. */
+    port->cwnd = port->mss;
+    port->recover = port->snd_nxt;
+    port->nacks = 0;
+    port->cong_flags = (uint8_t)((port->cong_flags & ~(TCP_CONG_RECOVERY | TCP_CONG_RTT)) | TCP_CONG_LOSS);
+
+    /* Back off the retransmission timer. */
+    port->rtx_time = MIN((port->rtx_time * 2), MS_TO_TICK(TCP_MAX_RTO));
+
+    SYS_LOG_FUNCTION_EXIT(TCP);
+
+} /* tcp_cong_timeout */
+
+/*
+ * tcp_newreno_avoid
+ * @port: TCP port for which congestion window is needed to be updated.
+ * @acked: Number of bytes ACKed.
+ * This function will grow the congestion window by one segment per round
+ * trip time.
+ */
+static void tcp_newreno_avoid(TCP_PORT *port, uint32_t acked)
+{
+    /* cwnd += SMSS * SMSS / cwnd, for the number of bytes ACKed. */
+    port->cwnd += MAX(1, ((uint32_t)port->mss * acked) / port->cwnd);
+
+} /* tcp_newreno_avoid */
+
+/*
+ * tcp_newreno_ssthresh
+ * @port: TCP port on which a loss was detected.
+ * @return: Returns the new slow start threshold.
+ * This function will return half of the data in flight as the slow start
+ * threshold.
+ */
+static uint32_t tcp_newreno_ssthresh(TCP_PORT *port)
+{
+    /* ssthresh = max (FlightSize / 2, 2 * SMSS). */
+    return (MAX(((port->snd_nxt - port->snd_una) / 2), (2 * (uint32_t)port->mss)));
+
+} /* tcp_newreno_ssthresh */
+
+#ifdef TCP_CUBIC
+/*
+ * tcp_cubic_root
+ * @value: Value for which cube root is needed.
+ * @return: Returns the integer cube root.
+ * This function will calculate the integer cube root of a given value.
+ */
+static uint32_t tcp_cubic_root(uint64_t value)
+{
+    uint64_t b;
+    uint32_t root = 0;
+    int32_t shift;
+
+    /* Calculate one bit of the root at a time. */
+    for (shift = 63; shift >= 0; shift -= 3)
+    {
+        root = (root << 1);
+        b = ((3 * (uint64_t)root * (root + 1)) + 1);
+
+        /* If this bit is set in the root. */
+        if ((value >> shift) >= b)
+        {
+            value -= (b << shift);
+            root++;
+        }
+    }
+
+    /* Return the cube root. */
+    return (root);
+
+} /* tcp_cubic_root */
+
+/*
+ * tcp_cubic_init
+ * @port: TCP port for which a connection was established.
+ * This function will initialize CUBIC data for a connection.
+ */
+static void tcp_cubic_init(TCP_PORT *port)
+{
+    /* Clear the CUBIC data. */
+    memset(&port->cubic, 0, sizeof(port->cubic));
+
+} /* tcp_cubic_init */
+
+/*
+ * tcp_cubic_avoid
+ * @port: TCP port for which congestion window is needed to be updated.
+ * @acked: Number of bytes ACKed.
+ * This function will grow the congestion window towards the cubic window
+ * function W(t) = C * (t - K)^3 + W_max, where t is the time since the last
+ * reduction, or the window of a standard TCP if that is larger.
+ */
+static void tcp_cubic_avoid(TCP_PORT *port, uint32_t acked)
+{
+    uint32_t t, target;
+    uint64_t offset;
+
+    /* If we are starting a new congestion avoidance epoch. */
+    if ((port->cong_flags & TCP_CONG_EPOCH) == 0)
+    {
+        port->cong_flags |= TCP_CONG_EPOCH;
+        port->cubic.epoch = current_system_tick();
+        port->cubic.w_est = port->cwnd;
+
+        /* If we are below the last maximum. */
+        if (port->cwnd < port->cubic.w_max)
+        {
+            /* K = cubic_root((W_max - cwnd) / C) in milliseconds. */
+            port->cubic.k = tcp_cubic_root(((uint64_t)(port->cubic.w_max - port->cwnd) * 2500000000ULL) / port->mss);
+            port->cubic.origin = port->cubic.w_max;
+        }
+        else
+        {
+            /* We are already at the plateau. */
+            port->cubic.k = 0;
+            port->cubic.origin = port->cwnd;
+        }
+    }
+
+    /* Time since the start of this epoch, one round trip time ahead. */
+    t = TICK_TO_MS((current_system_tick() - port->cubic.epoch) + (port->srtt >> TCP_RTT_SRTT_SHIFT));
+
+    /* Calculate |t - K|. */
+    t = (t > port->cubic.k) ? (t - port->cubic.k) : (port->cubic.k - t);
+    t = MIN(t, TCP_CUBIC_MAX_T);
+
+    /* C * |t - K|^3 in bytes. */
+    offset = (((uint64_t)t * t * t * port->mss * 2) / 5000000000ULL);
+
+    /* If we are past the plateau. */
+    if ((TICK_TO_MS((current_system_tick() - port->cubic.epoch) + (port->srtt >> TCP_RTT_SRTT_SHIFT))) >= port->cubic.k)
+    {
+        target = (uint32_t)MIN((port->cubic.origin + offset), TCP_MAX_CONG_WINDOW);
+    }
+    else
+    {
+        target = (offset < port->cubic.origin) ? (uint32_t)(port->cubic.origin - offset) : port->mss;
+    }
+
+    /* Grow the standard TCP window estimate. */
+    port->cubic.w_est += MAX(1, (uint32_t)(((uint64_t)TCP_CUBIC_FRIENDLY * port->mss * acked) / (1024 * (uint64_t)port->cwnd)));
+
+    /* If a standard TCP would have a larger window. */
+    if (port->cubic.w_est > target)
+    {
+        /* Use the standard TCP window. */
+        target = port->cubic.w_est;
+    }
+
+    /* If we are below the target. */
+    if (target > port->cwnd)
+    {
+        /* Grow the window to reach the target in a round trip time. */
+        port->cwnd += MAX(1, (uint32_t)(((uint64_t)(target - port->cwnd) * acked) / port->cwnd));
+    }
+    else
+    {
+        /* Grow the window very slowly. */
+        port->cwnd += MAX(1, (((uint32_t)port->mss * acked) / (100 * port->cwnd)));
+    }
+
+} /* tcp_cubic_avoid */
+
+/*
+ * tcp_cubic_ssthresh
+ * @port: TCP port on which a loss was detected.
+ * @return: Returns the new slow start threshold.
+ * This function will save the window at which loss was detected and return
+ * the multiplicatively decreased window.
+ */
+static uint32_t tcp_cubic_ssthresh(TCP_PORT *port)
+{
+    /* Start a new epoch on next congestion avoidance. */
+    port->cong_flags &= (uint8_t)~(TCP_CONG_EPOCH);
+
+    /* If we are losing before reaching the last maximum, fast convergence. */
+    if (port->cwnd < port->cubic.w_last_max)
+    {
+        /* Release some bandwidth for the new flows. */
+        port->cubic.w_last_max = port->cwnd;
+        port->cubic.w_max = (uint32_t)(((uint64_t)port->cwnd * (1024 + TCP_CUBIC_BETA)) / 2048);
+    }
+    else
+    {
+        port->cubic.w_last_max = port->cubic.w_max = port->cwnd;
+    }
+
+    /* ssthresh = max (cwnd * beta, 2 * SMSS). */
+    return (MAX((uint32_t)(((uint64_t)port->cwnd * TCP_CUBIC_BETA) / 1024), (2 * (uint32_t)port->mss)));
+
+} /* tcp_cubic_ssthresh */
+#endif /* TCP_CUBIC */
+
+#endif /* NET_TCP */
+#endif /* CONFIG_NET */
@@ -0,0 +1,67 @@
+/*
+ * net_tcp_cong.h
+ *
+ * Copyright (c) 2017 Usama Masood <mirzaon@gmail.com> All rights reserved.
+ *
+ * This file is part of a non-commercial software. For more details please
+ * refer to the license agreement that comes with this software.
+ *
+ * If you have not received a license file please contact:
+ *  Usama Masood <mirzaon@gmail.com>
+ *
+ */
+#ifndef _NET_TCP_CONG_H_
+#define _NET_TCP_CONG_H_
+#include <kernel.h>
+
+#ifdef CONFIG_NET
+#include <net.h>
+
+#ifdef NET_TCP
+#include <net_tcp.h>
+
+/* Number of duplicate ACKs after which a segment is considered lost. */
+#define TCP_DUP_ACK_THRESHOLD       (3)
+
+/* Initial congestion window as per RFC 5681. */
+#define TCP_CONG_IW(mss)            (((mss) > 2190) ? (2 * (uint32_t)(mss)) : (((mss) > 1095) ? (3 * (uint32_t)(mss)) : (4 * (uint32_t)(mss))))
+
+/* Round trip time smoothing factors as per RFC 6298, SRTT is kept scaled by
+ * 8 and RTTVAR is kept scaled by 4. */
+#define TCP_RTT_SRTT_SHIFT          (3)
+#define TCP_RTT_RTTVAR_SHIFT        (2)
+
+#ifdef TCP_CUBIC
+/* CUBIC parameters, beta is in 1/1024 units, C is 0.4 and is applied as
+ * 2/5. */
+#define TCP_CUBIC_BETA              (717)
+#define TCP_CUBIC_FRIENDLY          (542)
+#define TCP_CUBIC_MAX_T             (100000)
+#endif
+
+/* Congestion control algorithm used for new TCP ports. */
+#ifdef TCP_CUBIC
+#define TCP_CONG_DEFAULT            (&tcp_cong_cubic)
+#else
+#define TCP_CONG_DEFAULT            (&tcp_cong_newreno)
+#endif
+
+/* Exported congestion control algorithms. */
+extern const TCP_CONG tcp_cong_newreno;
+#ifdef TCP_CUBIC
+extern const TCP_CONG tcp_cong_cubic;
+#endif
+
+/* Function prototypes. */
+void tcp_rtt_initialize(TCP_PORT *);
+void tcp_rtt_start(TCP_PORT *, uint32_t);
+void tcp_rtt_ack(TCP_PORT *, uint32_t);
+void tcp_rtt_update(TCP_PORT *, uint32_t);
+void tcp_cong_initialize(TCP_PORT *);
+uint8_t tcp_cong_ack(TCP_PORT *, uint32_t);
+uint8_t tcp_cong_dup_ack(TCP_PORT *);
+void tcp_cong_timeout(TCP_PORT *);
+
+#endif /* NET_TCP */
+#endif /* CONFIG_NET */
+#endif /* _NET_TCP_CONG_H_ */
@@ -26,7 +26,6 @@
 UDP_DATA udp_data;
 
 /* Internal function prototypes. */
-static uint8_t udp_port_search(void *, void *);
 static int32_t udp_read_buffer(void *, uint8_t *, int32_t);
 static int32_t udp_read_data(void *, uint8_t *, int32_t);
 static int32_t udp_write_buffer(void *, const uint8_t *, int32_t);
@@ -77,6 +76,9 @@ void udp_register(UDP_PORT *port, char *name, SOCKET_ADDRESS *socket_address)
     /* Add this port in the global port list. */
     sll_append(&udp_data.port_list, port, OFFSETOF(UDP_PORT, next));
 
+    /* Add this port in the socket demux table. */
+    net_demux_add(&udp_data.demux, &port->demux, port, &port->socket_address);
+
     /* Register this UDP port as a console. */
     port->console.fs.name = name;
     port->console.fs.flags |= (FS_BLOCK | FS_SPACE_AVAILABLE);
@@ -132,6 +134,9 @@ void udp_unregister(UDP_PORT *port)
     /* Remove this port from the global port list. */
     ASSERT(sll_remove(&udp_data.port_list, port, OFFSETOF(UDP_PORT, next)) != port);
 
+    /* Remove this port from the socket demux table. */
+    net_demux_remove(&udp_data.demux, &port->demux);
+
     /* Free all the buffers in the UDP buffer list. */
     fs_buffer_add_list_list(port->buffer_list.head, FS_LIST_FREE, FS_BUFFER_ACTIVE);
 
@@ -150,46 +155,6 @@ void udp_unregister(UDP_PORT *port)
 
 } /* udp_unregister */
 
-/*
- * udp_port_search
- * @node: A UDP port in the list.
- * @param: UDP port search parameter.
- * @return: Will return true if we matched an exact UDP port for given UDP
- *  parameter.
- * This function is a search callback to find a specific UDP port.
- */
-static uint8_t udp_port_search(void *node, void *param)
-{
-    UDP_PORT_PARAM *udp_param = (UDP_PORT_PARAM *)param;
-    UDP_PORT *port = (UDP_PORT *)node;
-    uint8_t match = FALSE;
-
-    SYS_LOG_FUNCTION_ENTRY(UDP);
-
-    /* Match two UDP socket addresses. */
-    match = net_socket_address_match(&port->socket_address, &udp_param->socket_address);
-
-    /* If we did not fail completely. */
-    if (match != FALSE)
-    {
-        /* Save this port. */
-        udp_param->port = port;
-    }
-
-    /* If this was a partial match. */
-    if (match == PARTIAL)
-    {
-        /* SLL don't understand partial yet. */
-        match = FALSE;
-    }
-
-    SYS_LOG_FUNCTION_EXIT(UDP);
-
-    /* Return if this is required port. */
-    return (match);
-
-} /* udp_port_search */
-
 /*
  * net_process_udp
  * @buffer: File system buffer needed to be processed.
@@ -216,6 +181,7 @@ int32_t net_process_udp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_add
     uint16_t length;
     UDP_PORT *port;
     UDP_PORT_PARAM port_param;
+    uint8_t hdr_buf[UDP_HRD_LENGTH], *hdr;
 #ifdef UDP_CSUM
     uint16_t csum_hdr, csum;
 #endif
@@ -231,8 +197,16 @@ int32_t net_process_udp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_add
 
     if (status == SUCCESS)
     {
-        /* Pull the length of UDP datagram. */
-        ASSERT(fs_buffer_list_pull_offset(buffer, &length, 2, (ihl + UDP_HRD_LEN_OFFSET), (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
+        /* Peek the UDP header and pick the required fields, header might not
+         * remain valid once we update the buffer. */
+        hdr = fs_buffer_list_peek(buffer, hdr_buf, UDP_HRD_LENGTH, ihl);
+        ASSERT(hdr == NULL);
+        length = UDP_HRD_LEN(hdr);
+        port_param.socket_address.foreign_port = UDP_HRD_SRC_PORT(hdr);
+        port_param.socket_address.local_port = UDP_HRD_DST_PORT(hdr);
+#ifdef UDP_CSUM
+        csum_hdr = UDP_HRD_CSUM(hdr);
+#endif
 
 #ifndef UDP_ALLOW_SIZE_MISMATCH
         /* If UDP header length value is not correct. */
@@ -254,11 +228,9 @@ int32_t net_process_udp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_add
 #ifdef UDP_CSUM
     if (status == SUCCESS)
     {
-        /* Pull the checksum for UDP datagram. */
-        ASSERT(fs_buffer_list_pull_offset(buffer, &csum_hdr, 2, (ihl + UDP_HRD_CSUM_OFFSET), (FS_BUFFER_INPLACE)) != SUCCESS);
-
-        /* If we can verify the checksum for UDP header. */
-        if (csum_hdr != 0)
+        /* If we can verify the checksum for UDP header and it is not already
+         * verified. */
+        if ((csum_hdr != 0) && ((buffer->meta.flags & NET_BUFFER_L4_CSUM) == 0))
         {
             /* Calculate checksum for the pseudo header. */
             status = net_pseudo_csum_calculate(buffer, src_ip, dst_ip, IP_PROTO_UDP, length, ihl, 0, &csum);
@@ -276,10 +248,6 @@ int32_t net_process_udp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_add
 
     if (status == SUCCESS)
     {
-        /* Peek the UDP ports fields.. */
-        ASSERT(fs_buffer_list_pull_offset(buffer, &port_param.socket_address.foreign_port, 2, (ihl + UDP_HRD_SRC_PORT_OFFSET), (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
-        ASSERT(fs_buffer_list_pull_offset(buffer, &port_param.socket_address.local_port, 2, (ihl + UDP_HRD_DST_PORT_OFFSET), (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
-
         /* Release semaphore for the buffer file descriptor. */
         fd_release_lock(buffer->fd);
 
@@ -293,10 +261,9 @@ int32_t net_process_udp(FS_BUFFER_LIST *buffer, uint32_t ihl, uint32_t iface_add
         /* Initialize search parameter for this UDP datagram. */
         port_param.socket_address.local_ip = dst_ip;
         port_param.socket_address.foreign_ip = src_ip;
-        port_param.port = NULL;
 
         /* Search for a UDP port that can be used to receive this packet. */
-        sll_search(&udp_data.port_list, NULL, &udp_port_search, &port_param, OFFSETOF(UDP_PORT, next));
+        port_param.port = (UDP_PORT *)net_demux_search(&udp_data.demux, &port_param.socket_address);
 
         /* Save the resolved port. */
         port = port_param.port;
@@ -422,7 +389,7 @@ static int32_t udp_read_buffer(void *fd, uint8_t *buffer, int32_t size)
     UDP_PORT *port = (UDP_PORT *)fd;
     FS_BUFFER_LIST *fs_buffer;
     int32_t ret_size = 0;
-    uint8_t ihl;
+    uint32_t ihl;
 
     /* For now unused. */
     UNUSED_PARAM(size);
@@ -438,9 +405,8 @@ static int32_t udp_read_buffer(void *fd, uint8_t *buffer, int32_t size)
         /* Get lock for the buffer file descriptor. */
         ASSERT(fd_get_lock(fs_buffer->fd));
 
-        /* Peek the version and IHL. */
-        ASSERT(fs_buffer_list_pull_offset(fs_buffer, &ihl, 1, IPV4_HDR_VER_IHL_OFFSET, FS_BUFFER_INPLACE) != SUCCESS);
-        ihl = (uint8_t)((ihl & IPV4_HDR_IHL_MASK) << 2);
+        /* Pick the UDP header offset as saved by IPv4. */
+        ihl = fs_buffer->meta.l4_offset;
 
         /* Save the IP addresses for this UDP datagram. */
         ASSERT(fs_buffer_list_pull_offset(fs_buffer, &port->last_datagram_address.foreign_ip, 4, IPV4_HDR_SRC_OFFSET, (FS_BUFFER_INPLACE | FS_BUFFER_PACKED)) != SUCCESS);
@@ -693,6 +659,16 @@ static int32_t udp_write_data(void *fd, const uint8_t *buffer, int32_t size)
         {
             /* Push UDP payload on the buffer. */
             status = fs_buffer_list_push(fs_buffer, (uint8_t *)buffer, (uint32_t)size, ((port->flags & UDP_FLAG_THR_BUFFERS) ? 0 : (FS_BUFFER_TH | FS_BUFFER_SUSPEND)));
+
+#ifdef UDP_CSUM
+            if (status == SUCCESS)
+            {
+                /* Save checksum of the payload while it is still contiguous,
+                 * so it is not traversed again in the buffer list. */
+                fs_buffer->meta.csum = net_csum_partial(buffer, (uint32_t)size, 0);
+                fs_buffer->meta.csum_length = (uint16_t)size;
+            }
+#endif
         }
         else
         {
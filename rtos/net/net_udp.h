@@ -19,6 +19,7 @@
 
 #ifdef NET_UDP
 #include <console.h>
+#include <net_demux.h>
 #include <net_udp_config.h>
 
 /* UDP header definitions. */
@@ -28,6 +29,13 @@
 #define UDP_HRD_LEN_OFFSET          (4)
 #define UDP_HRD_CSUM_OFFSET         (6)
 
+/* UDP header accessors, header must be contiguous, see
+ * fs_buffer_list_peek. */
+#define UDP_HRD_SRC_PORT(h)         NET_GET_BE16(&(h)[UDP_HRD_SRC_PORT_OFFSET])
+#define UDP_HRD_DST_PORT(h)         NET_GET_BE16(&(h)[UDP_HRD_DST_PORT_OFFSET])
+#define UDP_HRD_LEN(h)              NET_GET_BE16(&(h)[UDP_HRD_LEN_OFFSET])
+#define UDP_HRD_CSUM(h)             NET_GET_BE16(&(h)[UDP_HRD_CSUM_OFFSET])
+
 /* UDP port flags. */
 #define UDP_FLAG_THR_BUFFERS        (0x1)
 
@@ -48,6 +56,9 @@ struct _udp_port
     /* UDP port list member. */
     UDP_PORT        *next;
 
+    /* UDP socket demux node. */
+    NET_DEMUX_NODE  demux;
+
     /* UDP socket address. */
     SOCKET_ADDRESS  socket_address;
 
@@ -75,6 +86,9 @@ typedef struct _udp_data
         UDP_PORT    *tail;
     } port_list;
 
+    /* Socket demux table for UDP ports. */
+    NET_DEMUX   demux;
+
 #ifdef CONFIG_SEMAPHORE
     /* Data lock to protect global UDP data. */
     SEMAPHORE   lock;
@@ -28,7 +28,7 @@
 typedef uint8_t SYS_LOG_LEVEL;
 
 /* Component ID list. */
-enum
+typedef enum
 {
     SYS_LOG_DEF = 0,
 #ifdef IO_MMC